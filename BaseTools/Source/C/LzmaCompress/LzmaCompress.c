@@ -5,7 +5,7 @@
     LzmaUtil.c -- Test application for LZMA compression
     2019-02-21 : Igor Pavlov : Public domain
 
-  Copyright (c) 2006 - 2019, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -27,6 +27,16 @@
 
 #define LZMA_HEADER_SIZE (LZMA_PROPS_SIZE + 8)
 
+//
+// Layout of the chunked LZMA format, matching LZMA_CHUNKED_HEADER and
+// LZMA_CHUNK_ENTRY in MdeModulePkg/Include/Guid/LzmaDecompress.h. All fields
+// are little endian UINT32 values.
+//
+#define LZMA_CHUNKED_SIGNATURE      0x4B435A4C  // 'L', 'Z', 'C', 'K'
+#define LZMA_CHUNKED_HEADER_SIZE    16
+#define LZMA_CHUNK_ENTRY_SIZE       8
+#define LZMA_DEFAULT_CHUNK_SIZE     (1 << 20)
+
 typedef enum {
   NoConverter,
   X86Converter,
@@ -41,9 +51,11 @@ const char *kInvalidParamValMessage = "Invalid parameter value";
 
 static BoolInt mQuietMode = False;
 static CONVERTER_TYPE mConType = NoConverter;
+static BoolInt mChunked = False;
 
 UINT64 mDictionarySize = 28;
 UINT64 mCompressionMode = 2;
+UINT64 mChunkSize = LZMA_DEFAULT_CHUNK_SIZE;
 
 #define UTILITY_NAME "LzmaCompress"
 #define UTILITY_MAJOR_VERSION 0
@@ -60,6 +72,9 @@ void PrintHelp(char *buffer)
              "  -d: decode file\n"
              "  -o FileName, --output FileName: specify the output filename\n"
              "  --f86: enable converter for x86 code\n"
+             "  --chunked: split the data into chunks that are compressed independently\n"
+             "  --chunk-size Size: set the uncompressed size of one chunk in bytes,\n"
+             "                     default: 1048576 (1MB)\n"
              "  -v, --verbose: increase output messages\n"
              "  -q, --quiet: reduce output messages\n"
              "  --debug [0-9]: set debug level\n"
@@ -238,6 +253,176 @@ Done:
   return res;
 }
 
+static void SetUInt32(Byte *buffer, UInt32 value)
+{
+  int i;
+  for (i = 0; i < 4; i++)
+    buffer[i] = (Byte)(value >> (8 * i));
+}
+
+static UInt32 GetUInt32(const Byte *buffer)
+{
+  return (UInt32)buffer[0] | ((UInt32)buffer[1] << 8) |
+         ((UInt32)buffer[2] << 16) | ((UInt32)buffer[3] << 24);
+}
+
+static SRes EncodeChunked(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize, CLzmaEncProps *props)
+{
+  SRes res;
+  size_t inSize = (size_t)fileSize;
+  size_t chunkSize = (size_t)mChunkSize;
+  size_t chunkCount;
+  size_t tableSize;
+  size_t outSize;
+  size_t outPos;
+  size_t i;
+  Byte *inBuffer = 0;
+  Byte *outBuffer = 0;
+
+  if (inSize == 0)
+    return SZ_ERROR_INPUT_EOF;
+  if (fileSize > 0xFFFFFFFF)
+    return SZ_ERROR_PARAM;
+
+  inBuffer = (Byte *)MyAlloc(inSize);
+  if (inBuffer == 0)
+    return SZ_ERROR_MEM;
+
+  if (SeqInStream_Read(inStream, inBuffer, inSize) != SZ_OK) {
+    res = SZ_ERROR_READ;
+    goto Done;
+  }
+
+  chunkCount = (inSize + chunkSize - 1) / chunkSize;
+  tableSize = LZMA_CHUNKED_HEADER_SIZE + chunkCount * LZMA_CHUNK_ENTRY_SIZE;
+
+  // every chunk gets 105% of its size + 64KB, like a non-chunked stream
+  outSize = tableSize + inSize / 20 * 21 + chunkCount * (LZMA_HEADER_SIZE + (1 << 16));
+  outBuffer = (Byte *)MyAlloc(outSize);
+  if (outBuffer == 0) {
+    res = SZ_ERROR_MEM;
+    goto Done;
+  }
+
+  SetUInt32(outBuffer, LZMA_CHUNKED_SIGNATURE);
+  SetUInt32(outBuffer + 4, (UInt32)chunkCount);
+  SetUInt32(outBuffer + 8, (UInt32)chunkSize);
+  SetUInt32(outBuffer + 12, (UInt32)inSize);
+
+  //
+  // A chunk never needs a dictionary larger than itself.
+  //
+  props->reduceSize = chunkSize;
+
+  res = SZ_OK;
+  outPos = tableSize;
+  for (i = 0; i < chunkCount; i++) {
+    size_t chunkIn = (i + 1 < chunkCount) ? chunkSize : inSize - i * chunkSize;
+    size_t outSizeProcessed = outSize - outPos - LZMA_HEADER_SIZE;
+    size_t outPropsSize = LZMA_PROPS_SIZE;
+    int j;
+
+    for (j = 0; j < 8; j++)
+      outBuffer[outPos + j + LZMA_PROPS_SIZE] = (Byte)((UInt64)chunkIn >> (8 * j));
+
+    res = LzmaEncode(outBuffer + outPos + LZMA_HEADER_SIZE, &outSizeProcessed,
+        inBuffer + i * chunkSize, chunkIn,
+        props, outBuffer + outPos, &outPropsSize, 0,
+        NULL, &g_Alloc, &g_Alloc);
+    if (res != SZ_OK)
+      goto Done;
+
+    SetUInt32(outBuffer + LZMA_CHUNKED_HEADER_SIZE + i * LZMA_CHUNK_ENTRY_SIZE, (UInt32)outPos);
+    SetUInt32(outBuffer + LZMA_CHUNKED_HEADER_SIZE + i * LZMA_CHUNK_ENTRY_SIZE + 4, (UInt32)(LZMA_HEADER_SIZE + outSizeProcessed));
+    outPos += LZMA_HEADER_SIZE + outSizeProcessed;
+  }
+
+  if (outStream->Write(outStream, outBuffer, outPos) != outPos)
+    res = SZ_ERROR_WRITE;
+
+Done:
+  MyFree(outBuffer);
+  MyFree(inBuffer);
+
+  return res;
+}
+
+static SRes DecodeChunked(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize)
+{
+  SRes res;
+  size_t inSize = (size_t)fileSize;
+  Byte *inBuffer = 0;
+  Byte *outBuffer = 0;
+  UInt32 chunkCount;
+  UInt32 chunkSize;
+  UInt32 outSize;
+  UInt32 i;
+
+  if (inSize < LZMA_CHUNKED_HEADER_SIZE)
+    return SZ_ERROR_INPUT_EOF;
+
+  inBuffer = (Byte *)MyAlloc(inSize);
+  if (inBuffer == 0)
+    return SZ_ERROR_MEM;
+
+  if (SeqInStream_Read(inStream, inBuffer, inSize) != SZ_OK) {
+    res = SZ_ERROR_READ;
+    goto Done;
+  }
+
+  chunkCount = GetUInt32(inBuffer + 4);
+  chunkSize = GetUInt32(inBuffer + 8);
+  outSize = GetUInt32(inBuffer + 12);
+  if (GetUInt32(inBuffer) != LZMA_CHUNKED_SIGNATURE || chunkSize == 0 || outSize == 0 ||
+      chunkCount > (inSize - LZMA_CHUNKED_HEADER_SIZE) / LZMA_CHUNK_ENTRY_SIZE ||
+      (outSize - 1) / chunkSize + 1 != chunkCount) {
+    res = SZ_ERROR_DATA;
+    goto Done;
+  }
+
+  outBuffer = (Byte *)MyAlloc(outSize);
+  if (outBuffer == 0) {
+    res = SZ_ERROR_MEM;
+    goto Done;
+  }
+
+  res = SZ_OK;
+  for (i = 0; i < chunkCount; i++) {
+    const Byte *entry = inBuffer + LZMA_CHUNKED_HEADER_SIZE + (size_t)i * LZMA_CHUNK_ENTRY_SIZE;
+    UInt32 offset = GetUInt32(entry);
+    UInt32 compressedSize = GetUInt32(entry + 4);
+    size_t chunkOut = (i + 1 < chunkCount) ? chunkSize : outSize - i * chunkSize;
+    size_t outSizeProcessed = chunkOut;
+    size_t inSizePure;
+    ELzmaStatus status;
+
+    if (offset > inSize || compressedSize > inSize - offset || compressedSize < LZMA_HEADER_SIZE) {
+      res = SZ_ERROR_DATA;
+      goto Done;
+    }
+
+    inSizePure = compressedSize - LZMA_HEADER_SIZE;
+    res = LzmaDecode(outBuffer + (size_t)i * chunkSize, &outSizeProcessed,
+        inBuffer + offset + LZMA_HEADER_SIZE, &inSizePure,
+        inBuffer + offset, LZMA_PROPS_SIZE, LZMA_FINISH_END, &status, &g_Alloc);
+    if (res != SZ_OK)
+      goto Done;
+    if (outSizeProcessed != chunkOut) {
+      res = SZ_ERROR_DATA;
+      goto Done;
+    }
+  }
+
+  if (outStream->Write(outStream, outBuffer, outSize) != outSize)
+    res = SZ_ERROR_WRITE;
+
+Done:
+  MyFree(outBuffer);
+  MyFree(inBuffer);
+
+  return res;
+}
+
 int main2(int numArgs, const char *args[], char *rs)
 {
   CFileSeqInStream inStream;
@@ -272,6 +457,16 @@ int main2(int numArgs, const char *args[], char *rs)
       modeWasSet = True;
     } else if (strcmp(args[param], "--f86") == 0) {
       mConType = X86Converter;
+    } else if (strcmp(args[param], "--chunked") == 0) {
+      mChunked = True;
+    } else if (strcmp(args[param], "--chunk-size") == 0) {
+      if (numArgs < (param + 2)) {
+        return PrintUserError(rs);
+      }
+      AsciiStringToUint64(args[++param],FALSE,&mChunkSize);
+      if ((mChunkSize == 0) || (mChunkSize > 0xFFFFFFFF)) {
+        return PrintError(rs, kInvalidParamValMessage);
+      }
     } else if (strcmp(args[param], "-o") == 0 ||
                strcmp(args[param], "--output") == 0) {
       if (numArgs < (param + 2)) {
@@ -342,6 +537,10 @@ int main2(int numArgs, const char *args[], char *rs)
     return PrintUserError(rs);
   }
 
+  if (mChunked && (mConType != NoConverter)) {
+    return PrintError(rs, "--chunked can not be used with --f86");
+  }
+
   {
     size_t t4 = sizeof(UInt32);
     size_t t8 = sizeof(UInt64);
@@ -364,14 +563,22 @@ int main2(int numArgs, const char *args[], char *rs)
     if (!mQuietMode) {
       printf("Encoding\n");
     }
-    res = Encode(&outStream.vt, &inStream.vt, fileSize, &props);
+    if (mChunked) {
+      res = EncodeChunked(&outStream.vt, &inStream.vt, fileSize, &props);
+    } else {
+      res = Encode(&outStream.vt, &inStream.vt, fileSize, &props);
+    }
   }
   else
   {
     if (!mQuietMode) {
       printf("Decoding\n");
     }
-    res = Decode(&outStream.vt, &inStream.vt, fileSize);
+    if (mChunked) {
+      res = DecodeChunked(&outStream.vt, &inStream.vt, fileSize);
+    } else {
+      res = Decode(&outStream.vt, &inStream.vt, fileSize);
+    }
   }
 
   File_Close(&outStream.file);
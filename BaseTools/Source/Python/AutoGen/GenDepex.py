@@ -1,7 +1,7 @@
 ## @file
 # This file is used to generate DEPEX file for module's dependency expression
 #
-# Copyright (c) 2007 - 2018, Intel Corporation. All rights reserved.<BR>
+# Copyright (c) 2007 - 2026, Intel Corporation. All rights reserved.<BR>
 # SPDX-License-Identifier: BSD-2-Clause-Patent
 
 ## Import Modules
@@ -10,6 +10,7 @@ import sys
 import Common.LongFilePathOs as os
 import re
 import traceback
+import uuid
 from Common.LongFilePathSupport import OpenLongFilePath as open
 from io import BytesIO
 from struct import pack
@@ -370,6 +371,101 @@ class DependencyExpression:
         Buffer.close()
         return FileChangeFlag
 
+## Evaluate a binary dependency expression with the GUIDs known to be installed
+#
+#   The expression is evaluated with three values: True, False, and None for an
+# outcome that cannot be known at build time. A GUID not known to be installed
+# may still be installed by a module of another FV, so pushing it gives None
+# rather than False. NOT only folds a False operand, since an installed GUID
+# may be uninstalled later. BEFORE, AFTER and SOR ask the dispatcher to
+# schedule the module rather than state a condition, so they give None too.
+#
+#   @param  Depex       The binary dependency expression, as generated by
+#                       DependencyExpression.Generate()
+#   @param  Installed   The set of GUIDs known to be installed, in registry
+#                       format and upper case
+#
+#   @retval True        The expression is TRUE once the Installed GUIDs are
+#   @retval False       The expression is never TRUE
+#   @retval None        The expression cannot be resolved at build time
+#
+def EvaluateDepex(Depex, Installed):
+    Opcode = DependencyExpression.Opcode["DXE"]
+    Stack = []
+    Offset = 0
+    while Offset < len(Depex):
+        Op = Depex[Offset]
+        Offset += 1
+        if Op == Opcode[DEPEX_OPCODE_PUSH]:
+            if Offset + 16 > len(Depex):
+                return None
+            Guid = str(uuid.UUID(bytes_le=bytes(Depex[Offset:Offset + 16]))).upper()
+            Offset += 16
+            Stack.append(True if Guid in Installed else None)
+        elif Op in (Opcode[DEPEX_OPCODE_AND], Opcode[DEPEX_OPCODE_OR]):
+            if len(Stack) < 2:
+                return None
+            Right = Stack.pop()
+            Left = Stack.pop()
+            if Op == Opcode[DEPEX_OPCODE_AND]:
+                if Left is False or Right is False:
+                    Stack.append(False)
+                else:
+                    Stack.append(True if Left and Right else None)
+            else:
+                if Left or Right:
+                    Stack.append(True)
+                else:
+                    Stack.append(False if Left is False and Right is False else None)
+        elif Op == Opcode[DEPEX_OPCODE_NOT]:
+            if len(Stack) < 1:
+                return None
+            Stack.append(True if Stack.pop() is False else None)
+        elif Op == Opcode[DEPEX_OPCODE_TRUE]:
+            Stack.append(True)
+        elif Op == Opcode[DEPEX_OPCODE_FALSE]:
+            Stack.append(False)
+        elif Op == Opcode[DEPEX_OPCODE_END]:
+            return Stack[0] if len(Stack) == 1 else None
+        else:
+            return None
+    # The dispatchers fail an expression without END
+    return None
+
+## Compute a static dispatch order for the modules of one FV
+#
+#   The modules are ordered in rounds, like the dispatchers do: each round walks
+# the modules not ordered yet in FV order, and appends the ones whose dependency
+# expression is TRUE once the GUIDs produced by the modules already ordered are
+# installed. The rounds stop when no module is appended. The modules left out
+# either can never be dispatched, or depend on something only known at boot.
+#
+#   @param  Modules     List of (Name, Depex, Produced) tuples in FV order.
+#                       Depex is the binary dependency expression, or None for
+#                       a module that must be left out. Produced is the set of
+#                       GUIDs, in registry format and upper case, the module
+#                       always installs when it is dispatched
+#   @param  Installed   The set of GUIDs installed before any module
+#
+#   @retval list        The names of the modules ordered
+#
+def SolveDispatchOrder(Modules, Installed=()):
+    Installed = set(Installed)
+    Pending = [Module for Module in Modules if Module[1] is not None]
+    Order = []
+    while Pending:
+        Waiting = []
+        for Name, Depex, Produced in Pending:
+            if EvaluateDepex(Depex, Installed) is True:
+                Order.append(Name)
+                Installed.update(Produced)
+            else:
+                Waiting.append((Name, Depex, Produced))
+        if len(Waiting) == len(Pending):
+            break
+        Pending = Waiting
+    return Order
+
 versionNumber = ("0.04" + " " + gBUILD_VERSION)
 __version__ = "%prog Version " + versionNumber
 __copyright__ = "Copyright (c) 2007-2018, Intel Corporation  All rights reserved."
@@ -1,7 +1,7 @@
 ## @file
 # Routines for generating Pcd Database
 #
-# Copyright (c) 2013 - 2018, Intel Corporation. All rights reserved.<BR>
+# Copyright (c) 2013 - 2026, Intel Corporation. All rights reserved.<BR>
 # SPDX-License-Identifier: BSD-2-Clause-Patent
 #
 from __future__ import absolute_import
@@ -22,6 +22,9 @@ import Common.LongFilePathOs as os
 
 DATABASE_VERSION = 7
 
+## Value of ExMapAttributes when the ExMapTable is sorted, see PCD_EXMAP_SORTED
+PCD_EXMAP_SORTED = 0x01
+
 gPcdDatabaseAutoGenC = TemplateString("""
 //
 // External PCD database debug information
@@ -188,7 +191,8 @@ typedef struct {
   //UINT16                LocalTokenCount;  // LOCAL_TOKEN_NUMBER for all
   //UINT16                ExTokenCount;     // EX_TOKEN_NUMBER for DynamicEx
   //UINT16                GuidTableCount;   // The Number of Guid in GuidTable
-  //UINT8                 Pad[6];
+  //UINT8                 ExMapAttributes;
+  //UINT8                 Pad[5];
   ${PHASE}_PCD_DATABASE_INIT    Init;
   ${PHASE}_PCD_DATABASE_UNINIT  Uninit;
 } ${PHASE}_PCD_DATABASE;
@@ -836,8 +840,10 @@ def BuildExDataBase(Dict):
     b = pack('=H', GuidTableCount)
 
     Buffer += b
-    b = pack('=B', Pad)
+    b = pack('=B', PCD_EXMAP_SORTED)
+
     Buffer += b
+    b = pack('=B', Pad)
     Buffer += b
     Buffer += b
     Buffer += b
@@ -1550,6 +1556,15 @@ def CreatePcdDatabasePhaseSpecificAutoGen (Platform, DynamicPcdList, Phase):
         Dict['EXMAP_TABLE_EMPTY']    = 'FALSE'
         Dict['EXMAPPING_TABLE_SIZE'] = str(NumberOfExTokens) + 'U'
         Dict['EX_TOKEN_NUMBER']      = str(NumberOfExTokens) + 'U'
+        #
+        # Sort the ExMapTable by token space GUID index, then by token number,
+        # so the PCD drivers can look up a DynamicEx PCD with a binary search.
+        #
+        ExMapTable = sorted(zip(Dict['EXMAPPING_TABLE_EXTOKEN'], Dict['EXMAPPING_TABLE_LOCAL_TOKEN'], Dict['EXMAPPING_TABLE_GUID_INDEX']),
+                            key=lambda Item: (GetIntegerValue(Item[2]), GetIntegerValue(Item[0])))
+        Dict['EXMAPPING_TABLE_EXTOKEN']     = [Item[0] for Item in ExMapTable]
+        Dict['EXMAPPING_TABLE_LOCAL_TOKEN'] = [Item[1] for Item in ExMapTable]
+        Dict['EXMAPPING_TABLE_GUID_INDEX']  = [Item[2] for Item in ExMapTable]
     else:
         Dict['EXMAPPING_TABLE_EXTOKEN'].append('0U')
         Dict['EXMAPPING_TABLE_LOCAL_TOKEN'].append('0U')
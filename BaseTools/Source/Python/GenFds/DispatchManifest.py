@@ -0,0 +1,163 @@
+## @file
+# process dispatch manifest data and generate PEI/DXE dispatch manifest file
+#
+#  The dispatch manifest lists PEIMs or DXE drivers of a FV in a dispatch order
+#  computed from their dependency expressions and from the protocols and PPIs
+#  their INF files say they produce. See MdeModulePkg/Include/Guid/DispatchManifest.h.
+#
+#  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+#
+#  SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+from __future__ import absolute_import
+from struct import pack
+import Common.LongFilePathOs as os
+from io import BytesIO
+from .FfsInfStatement import FfsInfStatement
+from .GenFdsGlobalVariable import GenFdsGlobalVariable
+from Common.Misc import SaveFileOnChange, PackGUID, GuidStructureStringToGuidString
+from Common.LongFilePathSupport import OpenLongFilePath as open
+from Common.DataType import *
+from AutoGen.GenDepex import DependencyExpression, SolveDispatchOrder
+
+DXE_DISPATCH_MANIFEST_GUID = "D4E49C3A-7E64-4B4C-9655-EA792716D2DB"
+PEI_DISPATCH_MANIFEST_GUID = "14766722-1C46-401A-A4A5-B41F51619666"
+
+DISPATCH_MANIFEST_SIGNATURE = 0x4E414D44   # 'DMAN'
+DISPATCH_MANIFEST_VERSION = 1
+DISPATCH_MANIFEST_HEADER_SIZE = 16
+
+## Module types dispatched by each dispatcher
+gManifestModuleTypes = {
+    "PEI" : (SUP_MODULE_PEIM,),
+    "DXE" : (SUP_MODULE_DXE_DRIVER, SUP_MODULE_DXE_RUNTIME_DRIVER, SUP_MODULE_DXE_SAL_DRIVER, SUP_MODULE_UEFI_DRIVER),
+}
+
+## Usages of a protocol or PPI that guarantee it is installed by the module
+gProducesUsages = {"PRODUCES", "PRODUCED", "ALWAYS_PRODUCES", "ALWAYS_PRODUCED"}
+
+## process dispatch manifest data and generate PEI/DXE dispatch manifest file
+#
+#
+class DispatchManifest (object):
+    ## The constructor
+    #
+    #   @param  self            The object pointer
+    #   @param  ManifestType    "PEI" or "DXE"
+    #
+    def __init__(self, ManifestType):
+        self.ManifestType = ManifestType
+
+    ## GetProduced() method
+    #
+    #   Get the protocols or PPIs a module always installs when it is dispatched
+    #
+    #   @param  self        The object pointer
+    #   @param  Inf         The build data of the module
+    #   @retval set         The GUIDs in registry format and upper case
+    #
+    def GetProduced(self, Inf):
+        if self.ManifestType == "PEI":
+            Values, Comments = Inf.Ppis, Inf.PpiComments
+        else:
+            Values, Comments = Inf.Protocols, Inf.ProtocolComments
+        Produced = set()
+        for CName, Value in Values.items():
+            for Comment in Comments.get(CName, []):
+                if gProducesUsages.intersection(Comment.replace('#', ' ').split()):
+                    Produced.add(GuidStructureStringToGuidString(Value).upper())
+                    break
+        return Produced
+
+    ## GetDepex() method
+    #
+    #   Get the binary dependency expression a module is dispatched with
+    #
+    #   @param  self        The object pointer
+    #   @param  FfsInf      The FfsInfStatement of the module, after its FFS is generated
+    #   @retval bytes       The dependency expression, or None if it is not known
+    #
+    def GetDepex(self, FfsInf):
+        DepexFiles = FfsInf.GetFinalTargetSuffixMap().get('.depex')
+        if DepexFiles:
+            if not os.path.exists(DepexFiles[0]):
+                return None
+            with open(DepexFiles[0], 'rb') as File:
+                return File.read()
+        if self.ManifestType == "PEI":
+            # A PEIM without DEPEX is dispatched right away
+            return pack('B', DependencyExpression.Opcode["PEI"][DEPEX_OPCODE_TRUE]) + \
+                   pack('B', DependencyExpression.Opcode["PEI"][DEPEX_OPCODE_END])
+        # A DXE driver without DEPEX waits for all the architectural protocols
+        Opcode = DependencyExpression.Opcode["DXE"]
+        Buffer = BytesIO()
+        for Index, Guid in enumerate(sorted(DependencyExpression.ArchProtocols)):
+            Buffer.write(pack('B', Opcode[DEPEX_OPCODE_PUSH]))
+            Buffer.write(PackGUID(Guid.split('-')))
+            if Index != 0:
+                Buffer.write(pack('B', Opcode[DEPEX_OPCODE_AND]))
+        Buffer.write(pack('B', Opcode[DEPEX_OPCODE_END]))
+        return Buffer.getvalue()
+
+    ## GenFfs() method
+    #
+    #   Generate FFS for dispatch manifest file
+    #
+    #   @param  self        The object pointer
+    #   @param  FvName      for whom dispatch manifest file generated
+    #   @param  FfsList     The FFS statements of the FV, after their FFS are generated
+    #   @retval string      Generated file name, or None if no module could be ordered
+    #
+    def GenFfs(self, FvName, FfsList):
+        if self.ManifestType == "PEI":
+            ManifestFileGuid = PEI_DISPATCH_MANIFEST_GUID
+        else:
+            ManifestFileGuid = DXE_DISPATCH_MANIFEST_GUID
+
+        Modules = []
+        for FfsObj in FfsList:
+            if not isinstance(FfsObj, FfsInfStatement) or FfsObj.InfModule is None:
+                continue
+            if FfsObj.ModuleType not in gManifestModuleTypes[self.ManifestType]:
+                continue
+            if not FfsObj.SourceFileList:
+                # The DEPEX of a binary module is not known here
+                Modules.append((FfsObj.ModuleGuid, None, set()))
+                continue
+            Modules.append((FfsObj.ModuleGuid, self.GetDepex(FfsObj), self.GetProduced(FfsObj.InfModule)))
+
+        Order = SolveDispatchOrder(Modules)
+        GenFdsGlobalVariable.InfLogger("%s dispatch manifest of %s FV orders %d of %d modules" % \
+                                       (self.ManifestType, FvName, len(Order), len(Modules)))
+        if not Order:
+            return None
+
+        OutputManifestFilePath = os.path.join (GenFdsGlobalVariable.WorkSpaceDir, \
+                                   GenFdsGlobalVariable.FfsDir,\
+                                   ManifestFileGuid + FvName)
+        if not os.path.exists(OutputManifestFilePath):
+            os.makedirs(OutputManifestFilePath)
+
+        OutputManifestFileName = os.path.join(OutputManifestFilePath, \
+                                       ManifestFileGuid + FvName + '.Manifest')
+        ManifestFfsFileName = os.path.join (OutputManifestFilePath,\
+                                    ManifestFileGuid + FvName + '.Ffs')
+
+        Buffer = BytesIO()
+        Buffer.write(pack('=IHHII', DISPATCH_MANIFEST_SIGNATURE, DISPATCH_MANIFEST_VERSION,
+                          DISPATCH_MANIFEST_HEADER_SIZE, len(Order), 0))
+        for Guid in Order:
+            Buffer.write(PackGUID(Guid.split('-')))
+        SaveFileOnChange(OutputManifestFileName, Buffer.getvalue())
+
+        RawSectionFileName = os.path.join(OutputManifestFilePath, \
+                                       ManifestFileGuid + FvName + '.raw')
+        GenFdsGlobalVariable.GenerateSection(RawSectionFileName, [OutputManifestFileName], 'EFI_SECTION_RAW')
+        GenFdsGlobalVariable.GenerateFfs(ManifestFfsFileName, [RawSectionFileName],
+                                        'EFI_FV_FILETYPE_FREEFORM', ManifestFileGuid)
+
+        return ManifestFfsFileName
@@ -1,7 +1,7 @@
 ## @file
 # parse FDF file
 #
-#  Copyright (c) 2007 - 2021, Intel Corporation. All rights reserved.<BR>
+#  Copyright (c) 2007 - 2026, Intel Corporation. All rights reserved.<BR>
 #  Copyright (c) 2015, Hewlett Packard Enterprise Development, L.P.<BR>
 #
 #  SPDX-License-Identifier: BSD-2-Clause-Patent
@@ -2102,7 +2102,8 @@ class FdfParser:
             if not (self._GetBlockStatement(FvObj) or self._GetFvBaseAddress(FvObj) or
                 self._GetFvForceRebase(FvObj) or self._GetFvAlignment(FvObj) or
                 self._GetFvAttributes(FvObj) or self._GetFvNameGuid(FvObj) or
-                self._GetFvExtEntryStatement(FvObj) or self._GetFvNameString(FvObj)):
+                self._GetFvExtEntryStatement(FvObj) or self._GetFvNameString(FvObj) or
+                self._GetFvDispatchManifest(FvObj)):
                 break
 
         if FvObj.FvNameString == 'TRUE' and not FvObj.FvNameGuid:
@@ -2272,6 +2273,29 @@ class FdfParser:
 
         return True
 
+    ## _GetFvDispatchManifest() method
+    #
+    #   Get FvDispatchManifest for FV
+    #
+    #   @param  self        The object pointer
+    #   @param  FvObj       for whom FvDispatchManifest is got
+    #   @retval True        Successfully find a FvDispatchManifest statement
+    #   @retval False       Not able to find a FvDispatchManifest statement
+    #
+    def _GetFvDispatchManifest(self, FvObj):
+        if not self._IsKeyword("FvDispatchManifest"):
+            return False
+
+        if not self._IsToken(TAB_EQUAL_SPLIT):
+            raise Warning.ExpectedEquals(self.FileName, self.CurrentLineNumber)
+
+        if not self._GetNextToken() or self._Token.upper() not in {'TRUE', 'FALSE'}:
+            raise Warning.Expected("TRUE or FALSE for FvDispatchManifest", self.FileName, self.CurrentLineNumber)
+
+        FvObj.DispatchManifest = self._Token.upper() == 'TRUE'
+
+        return True
+
     def _GetFvExtEntryStatement(self, FvObj):
         if not (self._IsKeyword("FV_EXT_ENTRY") or self._IsKeyword("FV_EXT_ENTRY_TYPE")):
             return False
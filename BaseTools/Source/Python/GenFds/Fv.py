@@ -1,7 +1,7 @@
 ## @file
 # process FV generation
 #
-#  Copyright (c) 2007 - 2018, Intel Corporation. All rights reserved.<BR>
+#  Copyright (c) 2007 - 2026, Intel Corporation. All rights reserved.<BR>
 #
 #  SPDX-License-Identifier: BSD-2-Clause-Patent
 #
@@ -15,6 +15,7 @@ import subprocess
 from io import BytesIO
 from struct import *
 from . import FfsFileStatement
+from .DispatchManifest import DispatchManifest
 from .GenFdsGlobalVariable import GenFdsGlobalVariable
 from Common.Misc import SaveFileOnChange, PackGUID
 from Common.LongFilePathSupport import CopyLongFilePath
@@ -41,6 +42,7 @@ class FV (object):
         self.FvAttributeDict = {}
         self.FvNameGuid = None
         self.FvNameString = None
+        self.DispatchManifest = False
         self.AprioriSectionList = []
         self.FfsList = []
         self.BsBaseAddress = None
@@ -130,6 +132,19 @@ class FV (object):
                 self.FvInfFile.append("EFI_FILE_NAME = " + \
                                             FileName          + \
                                             TAB_LINE_BREAK)
+
+        #
+        # Then the dispatch manifests, which need the DEPEX of the modules built
+        #
+        if self.DispatchManifest and not Flag:
+            GenFdsGlobalVariable.VerboseLogger('Generate dispatch manifest files !')
+            for ManifestType in ("PEI", "DXE"):
+                FileName = DispatchManifest(ManifestType).GenFfs(self.UiFvName, self.FfsList)
+                if FileName:
+                    FfsFileList.append(FileName)
+                    self.FvInfFile.append("EFI_FILE_NAME = " + \
+                                                FileName          + \
+                                                TAB_LINE_BREAK)
         if not Flag:
             FvInfFile = ''.join(self.FvInfFile)
             SaveFileOnChange(self.InfFileName, FvInfFile, False)
@@ -0,0 +1,60 @@
+## @file
+# Unit tests for the static dispatch order of the dispatch manifest
+#
+# Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+
+import unittest
+import uuid
+from struct import pack
+from AutoGen.GenDepex import EvaluateDepex, SolveDispatchOrder
+
+BEFORE, PUSH, AND, OR, NOT, TRUE, FALSE, END = 0x00, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08
+
+GUID_A = "11111111-1111-1111-1111-111111111111"
+GUID_B = "22222222-2222-2222-2222-222222222222"
+GUID_C = "33333333-3333-3333-3333-333333333333"
+
+def Depex(*Items):
+    Buffer = b''
+    for Item in Items:
+        if isinstance(Item, str):
+            Buffer += pack('B', PUSH) + uuid.UUID(Item).bytes_le
+        else:
+            Buffer += pack('B', Item)
+    return Buffer
+
+class TestDispatchManifest(unittest.TestCase):
+    def test_EvaluateDepex(self):
+        self.assertIs(EvaluateDepex(Depex(TRUE, END), set()), True)
+        self.assertIs(EvaluateDepex(Depex(FALSE, END), set()), False)
+        self.assertIs(EvaluateDepex(Depex(GUID_A, END), {GUID_A}), True)
+        # Not produced in this FV, but another FV may install it
+        self.assertIs(EvaluateDepex(Depex(GUID_A, END), set()), None)
+        self.assertIs(EvaluateDepex(Depex(GUID_A, GUID_B, AND, END), {GUID_A}), None)
+        self.assertIs(EvaluateDepex(Depex(GUID_A, GUID_B, AND, END), {GUID_A, GUID_B}), True)
+        self.assertIs(EvaluateDepex(Depex(GUID_A, FALSE, AND, END), {GUID_A}), False)
+        self.assertIs(EvaluateDepex(Depex(GUID_A, GUID_B, OR, END), {GUID_B}), True)
+        self.assertIs(EvaluateDepex(Depex(FALSE, FALSE, OR, END), set()), False)
+        # An installed GUID may be uninstalled, so only NOT FALSE is folded
+        self.assertIs(EvaluateDepex(Depex(GUID_A, NOT, END), {GUID_A}), None)
+        self.assertIs(EvaluateDepex(Depex(FALSE, NOT, END), set()), True)
+        # BEFORE, a missing END and a truncated GUID are left to the dispatcher
+        self.assertIs(EvaluateDepex(Depex(BEFORE) + uuid.UUID(GUID_A).bytes_le + pack('B', END), {GUID_A}), None)
+        self.assertIs(EvaluateDepex(Depex(GUID_A), {GUID_A}), None)
+        self.assertIs(EvaluateDepex(Depex(GUID_A, END)[:10], {GUID_A}), None)
+
+    def test_SolveDispatchOrder(self):
+        Modules = [
+            ("C", Depex(GUID_B, END), {GUID_C}),
+            ("B", Depex(GUID_A, END), {GUID_B}),
+            ("A", Depex(TRUE, END), {GUID_A}),
+            ("External", Depex(GUID_C, "44444444-4444-4444-4444-444444444444", AND, END), set()),
+            ("Never", Depex(FALSE, END), set()),
+            ("Binary", None, {GUID_A}),
+        ]
+        self.assertEqual(SolveDispatchOrder(Modules), ["A", "B", "C"])
+        self.assertEqual(SolveDispatchOrder(Modules, {GUID_A, GUID_B}), ["C", "B", "A"])
+
+if __name__ == '__main__':
+    unittest.main()
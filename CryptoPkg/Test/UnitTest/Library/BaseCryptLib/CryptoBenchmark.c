@@ -0,0 +1,328 @@
+/** @file
+  Host based benchmark of the BaseCryptLib hash and block cipher primitives.
+
+  The benchmark is built against each OpensslLib instance, so the throughput
+  of the portable C implementations of OpenSSL can be compared with the
+  assembly implementations of the Accel instances, which use SHA, AES-NI and
+  AVX instructions when CPUID reports them. Each primitive processes the same
+  buffer until TEST_BENCH_TOTAL bytes are processed, and the throughput is
+  reported in MB/s.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/UnitTestBenchmarkLib.h>
+#include <Library/BaseCryptLib.h>
+
+#define UNIT_TEST_NAME     "BaseCryptLib Benchmark"
+#define UNIT_TEST_VERSION  "1.0"
+
+///
+/// Size of the buffer hashed or encrypted by each call.
+///
+#define TEST_BENCH_BUFFER_SIZE  SIZE_64KB
+
+///
+/// Number of bytes processed by each benchmark.
+///
+#define TEST_BENCH_TOTAL  SIZE_64MB
+
+typedef
+UINTN
+(EFIAPI *BENCH_HASH_GET_CONTEXT_SIZE)(
+  VOID
+  );
+
+typedef
+BOOLEAN
+(EFIAPI *BENCH_HASH_INIT)(
+  OUT  VOID  *HashContext
+  );
+
+typedef
+BOOLEAN
+(EFIAPI *BENCH_HASH_UPDATE)(
+  IN OUT  VOID        *HashContext,
+  IN      CONST VOID  *Data,
+  IN      UINTN       DataSize
+  );
+
+typedef
+BOOLEAN
+(EFIAPI *BENCH_HASH_FINAL)(
+  IN OUT  VOID   *HashContext,
+  OUT     UINT8  *HashValue
+  );
+
+typedef struct {
+  CONST CHAR8                    *Name;
+  BENCH_HASH_GET_CONTEXT_SIZE    GetContextSize;
+  BENCH_HASH_INIT                Init;
+  BENCH_HASH_UPDATE              Update;
+  BENCH_HASH_FINAL               Final;
+} BENCH_HASH_CONTEXT;
+
+typedef struct {
+  UINTN    KeyLength;
+} BENCH_CIPHER_CONTEXT;
+
+#ifndef DISABLE_SHA1_DEPRECATED_INTERFACES
+STATIC BENCH_HASH_CONTEXT  mSha1Context = {
+  "SHA-1", Sha1GetContextSize, Sha1Init, Sha1Update, Sha1Final
+};
+#endif
+
+STATIC BENCH_HASH_CONTEXT  mSha256Context = {
+  "SHA-256", Sha256GetContextSize, Sha256Init, Sha256Update, Sha256Final
+};
+
+STATIC BENCH_HASH_CONTEXT  mSha384Context = {
+  "SHA-384", Sha384GetContextSize, Sha384Init, Sha384Update, Sha384Final
+};
+
+STATIC BENCH_HASH_CONTEXT  mSha512Context = {
+  "SHA-512", Sha512GetContextSize, Sha512Init, Sha512Update, Sha512Final
+};
+
+STATIC BENCH_CIPHER_CONTEXT  mAes128Context = { 128 };
+STATIC BENCH_CIPHER_CONTEXT  mAes256Context = { 256 };
+
+STATIC UINT8  *mBuffer;
+STATIC UINT8  *mOutput;
+
+/**
+  Allocate and fill the buffers processed by a benchmark.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED                      The buffers were allocated.
+  @retval  UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  Out of memory.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkPreReq (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  mBuffer = AllocatePool (TEST_BENCH_BUFFER_SIZE);
+  mOutput = AllocatePool (TEST_BENCH_BUFFER_SIZE);
+  if ((mBuffer == NULL) || (mOutput == NULL)) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  for (Index = 0; Index < TEST_BENCH_BUFFER_SIZE; Index++) {
+    mBuffer[Index] = (UINT8)(Index * 7 + (Index >> 8));
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Free the buffers processed by a benchmark.
+
+  @param[in]  Context  Unused.
+**/
+STATIC
+VOID
+EFIAPI
+BenchmarkCleanUp (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  if (mBuffer != NULL) {
+    FreePool (mBuffer);
+    mBuffer = NULL;
+  }
+
+  if (mOutput != NULL) {
+    FreePool (mOutput);
+    mOutput = NULL;
+  }
+}
+
+/**
+  Report the throughput of a benchmark.
+
+  @param[in]  Name  The name of the primitive.
+  @param[in]  Ns    The time, in nanoseconds, to process TEST_BENCH_TOTAL bytes.
+**/
+STATIC
+VOID
+ReportThroughput (
+  IN CONST CHAR8  *Name,
+  IN UINT64       Ns
+  )
+{
+  UT_LOG_INFO ("%a: %ld MB/s\n", Name, UnitTestBenchmarkRate (TEST_BENCH_TOTAL, Ns) / 1000000);
+}
+
+/**
+  Measure the throughput of a hash.
+
+  @param[in]  Context  The BENCH_HASH_CONTEXT of the hash.
+
+  @retval  UNIT_TEST_PASSED             The benchmark ran.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The hash failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkHash (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  BENCH_HASH_CONTEXT  *Hash;
+  VOID                *HashCtx;
+  UINT8               Digest[SHA512_DIGEST_SIZE];
+  UINTN               Processed;
+  UINT64              Start;
+  UINT64              Ns;
+
+  Hash    = (BENCH_HASH_CONTEXT *)Context;
+  HashCtx = AllocatePool (Hash->GetContextSize ());
+  UT_ASSERT_NOT_NULL (HashCtx);
+
+  Start = UnitTestBenchmarkStart ();
+  UT_ASSERT_TRUE (Hash->Init (HashCtx));
+  for (Processed = 0; Processed < TEST_BENCH_TOTAL; Processed += TEST_BENCH_BUFFER_SIZE) {
+    UT_ASSERT_TRUE (Hash->Update (HashCtx, mBuffer, TEST_BENCH_BUFFER_SIZE));
+  }
+
+  UT_ASSERT_TRUE (Hash->Final (HashCtx, Digest));
+  Ns = UnitTestBenchmarkStop (Start);
+
+  FreePool (HashCtx);
+  ReportThroughput (Hash->Name, Ns);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Measure the throughput of AES-CBC encryption and decryption.
+
+  @param[in]  Context  The BENCH_CIPHER_CONTEXT of the key length.
+
+  @retval  UNIT_TEST_PASSED             The benchmark ran.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The cipher failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkAesCbc (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  BENCH_CIPHER_CONTEXT  *Cipher;
+  VOID                  *AesCtx;
+  UINT8                 Key[32];
+  UINT8                 Ivec[16];
+  UINTN                 Processed;
+  UINT64                Start;
+  UINT64                EncryptNs;
+  UINT64                DecryptNs;
+
+  Cipher = (BENCH_CIPHER_CONTEXT *)Context;
+  SetMem (Key, sizeof (Key), 0x5A);
+  SetMem (Ivec, sizeof (Ivec), 0xA5);
+  AesCtx = AllocatePool (AesGetContextSize ());
+  UT_ASSERT_NOT_NULL (AesCtx);
+  UT_ASSERT_TRUE (AesInit (AesCtx, Key, Cipher->KeyLength));
+
+  Start = UnitTestBenchmarkStart ();
+  for (Processed = 0; Processed < TEST_BENCH_TOTAL; Processed += TEST_BENCH_BUFFER_SIZE) {
+    UT_ASSERT_TRUE (AesCbcEncrypt (AesCtx, mBuffer, TEST_BENCH_BUFFER_SIZE, Ivec, mOutput));
+  }
+
+  EncryptNs = UnitTestBenchmarkStop (Start);
+
+  Start = UnitTestBenchmarkStart ();
+  for (Processed = 0; Processed < TEST_BENCH_TOTAL; Processed += TEST_BENCH_BUFFER_SIZE) {
+    UT_ASSERT_TRUE (AesCbcDecrypt (AesCtx, mOutput, TEST_BENCH_BUFFER_SIZE, Ivec, mBuffer));
+  }
+
+  DecryptNs = UnitTestBenchmarkStop (Start);
+
+  FreePool (AesCtx);
+  ReportThroughput ((Cipher->KeyLength == 128) ? "AES-128-CBC encrypt" : "AES-256-CBC encrypt", EncryptNs);
+  ReportThroughput ((Cipher->KeyLength == 128) ? "AES-128-CBC decrypt" : "AES-256-CBC decrypt", DecryptNs);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and benchmarks, and run them.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      BenchmarkSuite;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&BenchmarkSuite, Framework, "Throughput Benchmarks", "CryptoPkg.BaseCryptLib.Benchmark", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Throughput Benchmarks\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-----------Description---Name------------Function---------Pre--------------Post--------------Context
+  //
+ #ifndef DISABLE_SHA1_DEPRECATED_INTERFACES
+  AddTestCase (BenchmarkSuite, "SHA-1", "Sha1", BenchmarkHash, BenchmarkPreReq, BenchmarkCleanUp, &mSha1Context);
+ #endif
+  AddTestCase (BenchmarkSuite, "SHA-256", "Sha256", BenchmarkHash, BenchmarkPreReq, BenchmarkCleanUp, &mSha256Context);
+  AddTestCase (BenchmarkSuite, "SHA-384", "Sha384", BenchmarkHash, BenchmarkPreReq, BenchmarkCleanUp, &mSha384Context);
+  AddTestCase (BenchmarkSuite, "SHA-512", "Sha512", BenchmarkHash, BenchmarkPreReq, BenchmarkCleanUp, &mSha512Context);
+  AddTestCase (BenchmarkSuite, "AES-128-CBC", "Aes128Cbc", BenchmarkAesCbc, BenchmarkPreReq, BenchmarkCleanUp, &mAes128Context);
+  AddTestCase (BenchmarkSuite, "AES-256-CBC", "Aes256Cbc", BenchmarkAesCbc, BenchmarkPreReq, BenchmarkCleanUp, &mAes256Context);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
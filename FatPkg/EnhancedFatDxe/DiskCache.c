@@ -1,13 +1,100 @@
 /** @file
   Cache implementation for EFI FAT File system driver.
 
-Copyright (c) 2005 - 2013, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2005 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
 
 #include "Fat.h"
 
+/**
+
+  Get the address of the cache page of a cache tag.
+
+  @param  DiskCache             - The disk cache.
+  @param  CacheTag              - The cache tag.
+
+  @return The address of the cache page.
+
+**/
+STATIC
+UINT8 *
+FatCachePageAddress (
+  IN DISK_CACHE  *DiskCache,
+  IN CACHE_TAG   *CacheTag
+  )
+{
+  return DiskCache->CacheBase + ((UINTN)(CacheTag - DiskCache->CacheTag) << DiskCache->PageAlignment);
+}
+
+/**
+
+  Look up the cache tag that holds a page.
+
+  @param  DiskCache             - The disk cache.
+  @param  PageNo                - The page to look up.
+
+  @return The cache tag of the page, or NULL if the page is not cached.
+
+**/
+STATIC
+CACHE_TAG *
+FatLookupCachePage (
+  IN DISK_CACHE  *DiskCache,
+  IN UINTN       PageNo
+  )
+{
+  CACHE_TAG  *CacheTag;
+  UINTN      Way;
+
+  CacheTag = &DiskCache->CacheTag[(PageNo & DiskCache->GroupMask) * DiskCache->WayCount];
+  for (Way = 0; Way < DiskCache->WayCount; Way++, CacheTag++) {
+    if ((CacheTag->RealSize > 0) && (CacheTag->PageNo == PageNo)) {
+      return CacheTag;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+
+  Select the cache tag that will hold a page that is not cached: an unused tag
+  of the group of the page if any, or else the least recently used one.
+
+  @param  DiskCache             - The disk cache.
+  @param  PageNo                - The page to be cached.
+
+  @return The selected cache tag.
+
+**/
+STATIC
+CACHE_TAG *
+FatSelectCacheTag (
+  IN DISK_CACHE  *DiskCache,
+  IN UINTN       PageNo
+  )
+{
+  CACHE_TAG  *CacheTag;
+  CACHE_TAG  *Victim;
+  UINTN      Way;
+
+  CacheTag = &DiskCache->CacheTag[(PageNo & DiskCache->GroupMask) * DiskCache->WayCount];
+  Victim   = CacheTag;
+  for (Way = 0; Way < DiskCache->WayCount; Way++, CacheTag++) {
+    if (CacheTag->RealSize == 0) {
+      return CacheTag;
+    }
+
+    if (CacheTag->LastUse < Victim->LastUse) {
+      Victim = CacheTag;
+    }
+  }
+
+  return Victim;
+}
+
 /**
 
   This function is used by the Data Cache.
@@ -37,25 +124,25 @@ FatFlushDataCacheRange (
   OUT UINT8       *Buffer
   )
 {
-  UINTN       PageNo;
-  UINTN       GroupNo;
-  UINTN       GroupMask;
+  UINTN       TagIndex;
+  UINTN       TagCount;
   UINTN       PageSize;
   UINT8       PageAlignment;
   DISK_CACHE  *DiskCache;
   CACHE_TAG   *CacheTag;
-  UINT8       *BaseAddress;
 
   DiskCache     = &Volume->DiskCache[CacheData];
-  BaseAddress   = DiskCache->CacheBase;
-  GroupMask     = DiskCache->GroupMask;
   PageAlignment = DiskCache->PageAlignment;
   PageSize      = (UINTN)1 << PageAlignment;
+  TagCount      = (DiskCache->GroupMask + 1) * DiskCache->WayCount;
 
-  for (PageNo = StartPageNo; PageNo < EndPageNo; PageNo++) {
-    GroupNo  = PageNo & GroupMask;
-    CacheTag = &DiskCache->CacheTag[GroupNo];
-    if ((CacheTag->RealSize > 0) && (CacheTag->PageNo == PageNo)) {
+  //
+  // The range may be much larger than the cache, so check every cached page
+  // rather than every page of the range.
+  //
+  for (TagIndex = 0; TagIndex < TagCount; TagIndex++) {
+    CacheTag = &DiskCache->CacheTag[TagIndex];
+    if ((CacheTag->RealSize > 0) && (CacheTag->PageNo >= StartPageNo) && (CacheTag->PageNo < EndPageNo)) {
       //
       // When reading data form disk directly, if some dirty data
       // in cache is in this rang, this data in the Buffer need to
@@ -64,8 +151,8 @@ FatFlushDataCacheRange (
       if (IoMode == ReadDisk) {
         if (CacheTag->Dirty) {
           CopyMem (
-            Buffer + ((PageNo - StartPageNo) << PageAlignment),
-            BaseAddress + (GroupNo << PageAlignment),
+            Buffer + ((CacheTag->PageNo - StartPageNo) << PageAlignment),
+            FatCachePageAddress (DiskCache, CacheTag),
             PageSize
             );
         }
@@ -104,7 +191,6 @@ FatExchangeCachePage (
   )
 {
   EFI_STATUS  Status;
-  UINTN       GroupNo;
   UINTN       PageNo;
   UINTN       WriteCount;
   UINTN       RealSize;
@@ -116,9 +202,8 @@ FatExchangeCachePage (
 
   DiskCache     = &Volume->DiskCache[DataType];
   PageNo        = CacheTag->PageNo;
-  GroupNo       = PageNo & DiskCache->GroupMask;
   PageAlignment = DiskCache->PageAlignment;
-  PageAddress   = DiskCache->CacheBase + (GroupNo << PageAlignment);
+  PageAddress   = FatCachePageAddress (DiskCache, CacheTag);
   EntryPos      = DiskCache->BaseAddress + LShiftU64 (PageNo, PageAlignment);
   RealSize      = CacheTag->RealSize;
   if (IoMode == ReadDisk) {
@@ -152,12 +237,89 @@ FatExchangeCachePage (
   return EFI_SUCCESS;
 }
 
+/**
+
+  Load a page that missed the data cache together with the pages following it,
+  with a single disk read.
+
+  @param  Volume                - FAT file system volume.
+  @param  PageNo                - The page that missed the cache.
+  @param  PageCount             - The number of pages to load, including PageNo.
+                                  None of them is cached, and there are no more
+                                  than the groups of the cache or than
+                                  MaxReadAheadPages + 1.
+
+  @retval EFI_SUCCESS           - The pages are loaded into the cache.
+  @return Others                - An error occurred when accessing the disk.
+
+**/
+STATIC
+EFI_STATUS
+FatReadAheadCachePages (
+  IN FAT_VOLUME  *Volume,
+  IN UINTN       PageNo,
+  IN UINTN       PageCount
+  )
+{
+  EFI_STATUS  Status;
+  DISK_CACHE  *DiskCache;
+  CACHE_TAG   *CacheTag;
+  UINTN       Index;
+  UINTN       Size;
+  UINT64      EntryPos;
+  UINT8       PageAlignment;
+
+  DiskCache     = &Volume->DiskCache[CacheData];
+  PageAlignment = DiskCache->PageAlignment;
+
+  //
+  // The pages fall in different groups, so the tag selected for one page is
+  // not taken by another one. Write the dirty pages they hold back first.
+  //
+  for (Index = 0; Index < PageCount; Index++) {
+    CacheTag = FatSelectCacheTag (DiskCache, PageNo + Index);
+    if ((CacheTag->RealSize > 0) && CacheTag->Dirty) {
+      Status = FatExchangeCachePage (Volume, CacheData, WriteDisk, CacheTag, NULL);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    }
+  }
+
+  EntryPos = DiskCache->BaseAddress + LShiftU64 (PageNo, PageAlignment);
+  Size     = (UINTN)MIN ((UINT64)PageCount << PageAlignment, DiskCache->LimitAddress - EntryPos);
+  Status   = FatDiskIo (Volume, ReadDisk, EntryPos, Size, DiskCache->StagingBuffer, NULL);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  for (Index = 0; Index < PageCount; Index++) {
+    CacheTag           = FatSelectCacheTag (DiskCache, PageNo + Index);
+    CacheTag->PageNo   = PageNo + Index;
+    CacheTag->RealSize = MIN (Size - (Index << PageAlignment), (UINTN)1 << PageAlignment);
+    CacheTag->Dirty    = FALSE;
+    CacheTag->LastUse  = DiskCache->UseCount;
+    CopyMem (
+      FatCachePageAddress (DiskCache, CacheTag),
+      DiskCache->StagingBuffer + (Index << PageAlignment),
+      CacheTag->RealSize
+      );
+  }
+
+  DiskCache->ReadAheadCount += PageCount - 1;
+  return EFI_SUCCESS;
+}
+
 /**
 
   Get one cache page by specified PageNo.
 
+  A read miss that continues a sequential access also loads the pages that
+  follow, with a window that grows while the access stays sequential.
+
   @param  Volume                - FAT file system volume.
   @param  CacheDataType         - The cache type: CACHE_FAT or CACHE_DATA.
+  @param  IoMode                - Indicate whether the page is read or written.
   @param  PageNo                - PageNo to match with the cache.
   @param  CacheTag              - The Cache Tag for the current cache page.
 
@@ -168,28 +330,74 @@ FatExchangeCachePage (
 STATIC
 EFI_STATUS
 FatGetCachePage (
-  IN FAT_VOLUME       *Volume,
-  IN CACHE_DATA_TYPE  CacheDataType,
-  IN UINTN            PageNo,
-  IN CACHE_TAG        *CacheTag
+  IN  FAT_VOLUME       *Volume,
+  IN  CACHE_DATA_TYPE  CacheDataType,
+  IN  IO_MODE          IoMode,
+  IN  UINTN            PageNo,
+  OUT CACHE_TAG        **CacheTag
   )
 {
   EFI_STATUS  Status;
-  UINTN       OldPageNo;
+  DISK_CACHE  *DiskCache;
+  BOOLEAN     Sequential;
+  UINTN       PageCount;
 
-  OldPageNo = CacheTag->PageNo;
-  if ((CacheTag->RealSize > 0) && (OldPageNo == PageNo)) {
+  DiskCache             = &Volume->DiskCache[CacheDataType];
+  Sequential            = (BOOLEAN)(PageNo == DiskCache->NextPageNo);
+  DiskCache->NextPageNo = PageNo + 1;
+  DiskCache->UseCount++;
+
+  *CacheTag = FatLookupCachePage (DiskCache, PageNo);
+  if (*CacheTag != NULL) {
     //
     // Cache Hit occurred
     //
+    DiskCache->HitCount++;
+    (*CacheTag)->LastUse = DiskCache->UseCount;
     return EFI_SUCCESS;
   }
 
+  DiskCache->MissCount++;
+
+  //
+  // Grow the read-ahead window while the pages are read in sequence, and
+  // close it on the first access out of sequence.
+  //
+  if (Sequential && (IoMode == ReadDisk)) {
+    DiskCache->ReadAheadPages = MIN (MAX (DiskCache->ReadAheadPages * 2, 1), DiskCache->MaxReadAheadPages);
+  } else {
+    DiskCache->ReadAheadPages = 0;
+  }
+
+  //
+  // Stop the read-ahead at the end of the cached area, and at the first page
+  // already cached, which may be dirty.
+  //
+  PageCount = 1;
+  while ((PageCount <= DiskCache->ReadAheadPages) &&
+         (DiskCache->BaseAddress + LShiftU64 (PageNo + PageCount, DiskCache->PageAlignment) < DiskCache->LimitAddress) &&
+         (FatLookupCachePage (DiskCache, PageNo + PageCount) == NULL))
+  {
+    PageCount++;
+  }
+
+  if (PageCount > 1) {
+    Status = FatReadAheadCachePages (Volume, PageNo, PageCount);
+    if (!EFI_ERROR (Status)) {
+      *CacheTag = FatLookupCachePage (DiskCache, PageNo);
+      ASSERT (*CacheTag != NULL);
+    }
+
+    return Status;
+  }
+
+  *CacheTag = FatSelectCacheTag (DiskCache, PageNo);
+
   //
   // Write dirty cache page back to disk
   //
-  if ((CacheTag->RealSize > 0) && CacheTag->Dirty) {
-    Status = FatExchangeCachePage (Volume, CacheDataType, WriteDisk, CacheTag, NULL);
+  if (((*CacheTag)->RealSize > 0) && (*CacheTag)->Dirty) {
+    Status = FatExchangeCachePage (Volume, CacheDataType, WriteDisk, *CacheTag, NULL);
     if (EFI_ERROR (Status)) {
       return Status;
     }
@@ -198,8 +406,12 @@ FatGetCachePage (
   //
   // Load new data from disk;
   //
-  CacheTag->PageNo = PageNo;
-  Status           = FatExchangeCachePage (Volume, CacheDataType, ReadDisk, CacheTag, NULL);
+  (*CacheTag)->PageNo  = PageNo;
+  (*CacheTag)->LastUse = DiskCache->UseCount;
+  Status               = FatExchangeCachePage (Volume, CacheDataType, ReadDisk, *CacheTag, NULL);
+  if (EFI_ERROR (Status)) {
+    (*CacheTag)->RealSize = 0;
+  }
 
   return Status;
 }
@@ -238,14 +450,11 @@ FatAccessUnalignedCachePage (
   VOID        *Destination;
   DISK_CACHE  *DiskCache;
   CACHE_TAG   *CacheTag;
-  UINTN       GroupNo;
 
   DiskCache = &Volume->DiskCache[CacheDataType];
-  GroupNo   = PageNo & DiskCache->GroupMask;
-  CacheTag  = &DiskCache->CacheTag[GroupNo];
-  Status    = FatGetCachePage (Volume, CacheDataType, PageNo, CacheTag);
+  Status    = FatGetCachePage (Volume, CacheDataType, IoMode, PageNo, &CacheTag);
   if (!EFI_ERROR (Status)) {
-    Source      = DiskCache->CacheBase + (GroupNo << DiskCache->PageAlignment) + Offset;
+    Source      = FatCachePageAddress (DiskCache, CacheTag) + Offset;
     Destination = Buffer;
     if (IoMode != ReadDisk) {
       CacheTag->Dirty  = TRUE;
@@ -362,7 +571,8 @@ FatAccessCache (
     // to be updated.
     //
     FatFlushDataCacheRange (Volume, IoMode, PageNo, OverRunPageNo, Buffer);
-    Buffer     += AlignedSize;
+    DiskCache->NextPageNo = OverRunPageNo;
+    Buffer               += AlignedSize;
     BufferSize -= AlignedSize;
   }
 
@@ -380,6 +590,84 @@ FatAccessCache (
   return Status;
 }
 
+/**
+
+  Write the run of consecutive dirty data cache pages a dirty page belongs to
+  back to disk, with as few disk writes as the staging buffer allows.
+
+  @param  Volume                - FAT file system volume.
+  @param  CacheTag              - The cache tag of a dirty data cache page.
+
+  @retval EFI_SUCCESS           - The pages are written back.
+  @return Others                - An error occurred when writing the disk.
+
+**/
+STATIC
+EFI_STATUS
+FatWriteBackCachePages (
+  IN FAT_VOLUME  *Volume,
+  IN CACHE_TAG   *CacheTag
+  )
+{
+  EFI_STATUS  Status;
+  DISK_CACHE  *DiskCache;
+  UINTN       PageNo;
+  UINTN       PageCount;
+  UINTN       Index;
+  UINTN       Size;
+  UINT8       PageAlignment;
+
+  DiskCache     = &Volume->DiskCache[CacheData];
+  PageAlignment = DiskCache->PageAlignment;
+
+  PageNo = CacheTag->PageNo;
+  while (PageNo > 0) {
+    CacheTag = FatLookupCachePage (DiskCache, PageNo - 1);
+    if ((CacheTag == NULL) || !CacheTag->Dirty) {
+      break;
+    }
+
+    PageNo--;
+  }
+
+  do {
+    Size = 0;
+    for (PageCount = 0; PageCount <= DiskCache->MaxReadAheadPages; PageCount++) {
+      CacheTag = FatLookupCachePage (DiskCache, PageNo + PageCount);
+      if ((CacheTag == NULL) || !CacheTag->Dirty || (Size != PageCount << PageAlignment)) {
+        break;
+      }
+
+      CopyMem (DiskCache->StagingBuffer + Size, FatCachePageAddress (DiskCache, CacheTag), CacheTag->RealSize);
+      Size += CacheTag->RealSize;
+    }
+
+    if (PageCount == 0) {
+      break;
+    }
+
+    Status = FatDiskIo (
+               Volume,
+               WriteDisk,
+               DiskCache->BaseAddress + LShiftU64 (PageNo, PageAlignment),
+               Size,
+               DiskCache->StagingBuffer,
+               NULL
+               );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    for (Index = 0; Index < PageCount; Index++) {
+      FatLookupCachePage (DiskCache, PageNo + Index)->Dirty = FALSE;
+    }
+
+    PageNo += PageCount;
+  } while (PageCount > DiskCache->MaxReadAheadPages);
+
+  return EFI_SUCCESS;
+}
+
 /**
 
   Flush all the dirty cache back, include the FAT cache and the Data cache.
@@ -399,8 +687,8 @@ FatVolumeFlushCache (
 {
   EFI_STATUS       Status;
   CACHE_DATA_TYPE  CacheDataType;
-  UINTN            GroupIndex;
-  UINTN            GroupMask;
+  UINTN            TagIndex;
+  UINTN            TagCount;
   DISK_CACHE       *DiskCache;
   CACHE_TAG        *CacheTag;
 
@@ -410,14 +698,22 @@ FatVolumeFlushCache (
       //
       // Data cache or fat cache is dirty, write the dirty data back
       //
-      GroupMask = DiskCache->GroupMask;
-      for (GroupIndex = 0; GroupIndex <= GroupMask; GroupIndex++) {
-        CacheTag = &DiskCache->CacheTag[GroupIndex];
+      TagCount = (DiskCache->GroupMask + 1) * DiskCache->WayCount;
+      for (TagIndex = 0; TagIndex < TagCount; TagIndex++) {
+        CacheTag = &DiskCache->CacheTag[TagIndex];
         if ((CacheTag->RealSize > 0) && CacheTag->Dirty) {
           //
-          // Write back all Dirty Data Cache Page to disk
+          // Write back all Dirty Data Cache Page to disk. Blocking write-back
+          // of the data cache merges consecutive pages into one disk write; a
+          // non-blocking one cannot reuse the staging buffer until its
+          // subtasks complete, so it writes page by page.
           //
-          Status = FatExchangeCachePage (Volume, CacheDataType, WriteDisk, CacheTag, Task);
+          if ((CacheDataType == CacheData) && (Task == NULL) && (DiskCache->StagingBuffer != NULL)) {
+            Status = FatWriteBackCachePages (Volume, CacheTag);
+          } else {
+            Status = FatExchangeCachePage (Volume, CacheDataType, WriteDisk, CacheTag, Task);
+          }
+
           if (EFI_ERROR (Status)) {
             return Status;
           }
@@ -452,8 +748,10 @@ FatInitializeDiskCache (
 {
   DISK_CACHE  *DiskCache;
   UINTN       FatCacheGroupCount;
+  UINTN       DataCachePageCount;
   UINTN       DataCacheSize;
   UINTN       FatCacheSize;
+  UINTN       StagingSize;
   UINT8       *CacheBuffer;
 
   DiskCache = Volume->DiskCache;
@@ -470,18 +768,34 @@ FatInitializeDiskCache (
     DiskCache[CacheData].PageAlignment = FAT_DATACACHE_PAGE_MAX_ALIGNMENT;
   }
 
-  DiskCache[CacheData].GroupMask    = FAT_DATACACHE_GROUP_COUNT - 1;
-  DiskCache[CacheData].BaseAddress  = Volume->RootPos;
-  DiskCache[CacheData].LimitAddress = Volume->VolumeSize;
-  DiskCache[CacheFat].GroupMask     = FatCacheGroupCount - 1;
-  DiskCache[CacheFat].BaseAddress   = Volume->FatPos;
-  DiskCache[CacheFat].LimitAddress  = Volume->FatPos + Volume->FatSize;
-  FatCacheSize                      = FatCacheGroupCount << DiskCache[CacheFat].PageAlignment;
-  DataCacheSize                     = FAT_DATACACHE_GROUP_COUNT << DiskCache[CacheData].PageAlignment;
+  DataCachePageCount = GetPowerOfTwo32 (MAX (PcdGet32 (PcdFatDataCachePageCount), FAT_DATACACHE_WAY_COUNT));
+
+  DiskCache[CacheData].GroupMask         = DataCachePageCount / FAT_DATACACHE_WAY_COUNT - 1;
+  DiskCache[CacheData].WayCount          = FAT_DATACACHE_WAY_COUNT;
+  DiskCache[CacheData].BaseAddress       = Volume->RootPos;
+  DiskCache[CacheData].LimitAddress      = Volume->VolumeSize;
+  DiskCache[CacheData].NextPageNo        = MAX_UINTN;
+  DiskCache[CacheData].MaxReadAheadPages = MIN (PcdGet32 (PcdFatDataCacheReadAheadPages), DiskCache[CacheData].GroupMask);
+  DiskCache[CacheFat].GroupMask          = FatCacheGroupCount - 1;
+  DiskCache[CacheFat].WayCount           = 1;
+  DiskCache[CacheFat].BaseAddress        = Volume->FatPos;
+  DiskCache[CacheFat].LimitAddress       = Volume->FatPos + Volume->FatSize;
+  DiskCache[CacheFat].NextPageNo         = MAX_UINTN;
+  FatCacheSize                           = FatCacheGroupCount << DiskCache[CacheFat].PageAlignment;
+  DataCacheSize                          = DataCachePageCount << DiskCache[CacheData].PageAlignment;
+  StagingSize                            = 0;
+  if (DiskCache[CacheData].MaxReadAheadPages > 0) {
+    StagingSize = (DiskCache[CacheData].MaxReadAheadPages + 1) << DiskCache[CacheData].PageAlignment;
+  }
+
   //
-  // Allocate the Fat Cache buffer
+  // Allocate the Fat Cache buffer, followed by the staging buffer and the
+  // cache tags.
   //
-  CacheBuffer = AllocateZeroPool (FatCacheSize + DataCacheSize);
+  CacheBuffer = AllocateZeroPool (
+                  FatCacheSize + DataCacheSize + StagingSize +
+                  (FatCacheGroupCount + DataCachePageCount) * sizeof (CACHE_TAG)
+                  );
   if (CacheBuffer == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
@@ -489,5 +803,11 @@ FatInitializeDiskCache (
   Volume->CacheBuffer            = CacheBuffer;
   DiskCache[CacheFat].CacheBase  = CacheBuffer;
   DiskCache[CacheData].CacheBase = CacheBuffer + FatCacheSize;
+  if (StagingSize > 0) {
+    DiskCache[CacheData].StagingBuffer = CacheBuffer + FatCacheSize + DataCacheSize;
+  }
+
+  DiskCache[CacheFat].CacheTag  = (CACHE_TAG *)(CacheBuffer + FatCacheSize + DataCacheSize + StagingSize);
+  DiskCache[CacheData].CacheTag = DiskCache[CacheFat].CacheTag + FatCacheGroupCount;
   return EFI_SUCCESS;
 }
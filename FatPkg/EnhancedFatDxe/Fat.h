@@ -31,6 +31,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiRuntimeServicesTableLib.h>
 
 #include "FatFileSystem.h"
+#include "FreeClusterMap.h"
 
 //
 // The FAT signature
@@ -75,12 +76,14 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 // Minimum fat page size is 8K, maximum fat page alignment is 32K
 // Minimum data page size is 8K, maximum fat page alignment is 64K
+// The number of data cache pages is set by PcdFatDataCachePageCount, and each
+// data cache group holds FAT_DATACACHE_WAY_COUNT of them.
 //
 #define FAT_FATCACHE_PAGE_MIN_ALIGNMENT   13
 #define FAT_FATCACHE_PAGE_MAX_ALIGNMENT   15
 #define FAT_DATACACHE_PAGE_MIN_ALIGNMENT  13
 #define FAT_DATACACHE_PAGE_MAX_ALIGNMENT  16
-#define FAT_DATACACHE_GROUP_COUNT         64
+#define FAT_DATACACHE_WAY_COUNT           4
 #define FAT_FATCACHE_GROUP_MIN_COUNT      1
 #define FAT_FATCACHE_GROUP_MAX_COUNT      16
 
@@ -145,9 +148,15 @@ typedef enum {
 typedef struct {
   UINTN      PageNo;
   UINTN      RealSize;
+  UINTN      LastUse;                 // Value of DISK_CACHE.UseCount when last accessed
   BOOLEAN    Dirty;
 } CACHE_TAG;
 
+//
+// A page is cached in one of the WayCount cache tags of its group, which is
+// selected by the low bits of the page number. The data of the cache tag with
+// index N is at CacheBase + (N << PageAlignment).
+//
 typedef struct {
   UINT64       BaseAddress;
   UINT64       LimitAddress;
@@ -155,7 +164,25 @@ typedef struct {
   BOOLEAN      Dirty;
   UINT8        PageAlignment;
   UINTN        GroupMask;
-  CACHE_TAG    CacheTag[FAT_DATACACHE_GROUP_COUNT];
+  UINTN        WayCount;
+  CACHE_TAG    *CacheTag;             // (GroupMask + 1) * WayCount tags, group by group
+  UINTN        UseCount;
+
+  //
+  // Sequential access detection. When the pages are accessed in sequence, a
+  // miss loads up to ReadAheadPages following pages with the missed one. The
+  // window doubles on every sequential miss up to MaxReadAheadPages.
+  // StagingBuffer holds MaxReadAheadPages + 1 pages, for the disk accesses
+  // that span several cache pages.
+  //
+  UINTN        NextPageNo;
+  UINTN        ReadAheadPages;
+  UINTN        MaxReadAheadPages;
+  UINT8        *StagingBuffer;
+
+  UINTN        HitCount;
+  UINTN        MissCount;
+  UINTN        ReadAheadCount;
 } DISK_CACHE;
 
 //
@@ -335,6 +362,12 @@ struct _FAT_VOLUME {
   UINTN                              FreeInfoPos;    // Pos with the free cluster info
   BOOLEAN                            FreeInfoValid;  // If free cluster info is valid
   //
+  // Free cluster bitmap, built when the first cluster is allocated and then
+  // kept in sync with every FAT entry update.
+  //
+  FAT_FREE_CLUSTER_MAP               FreeMap;
+  BOOLEAN                            FreeMapFailed;  // If the free cluster bitmap cannot be built
+  //
   // Unpacked Fat BPB info
   //
   UINTN                              NumFats;
@@ -1,7 +1,7 @@
 /** @file
   Routines dealing with disk spaces and FAT table entries.
 
-Copyright (c) 2005 - 2013, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2005 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 
@@ -167,6 +167,10 @@ FatSetFatEntry (
     }
   }
 
+  if ((Volume->FreeMap.Bits != NULL) && (Index < Volume->FreeMap.ClusterCount)) {
+    FatFreeMapSet (&Volume->FreeMap, Index, (BOOLEAN)(Value == FAT_CLUSTER_FREE));
+  }
+
   //
   // Make sure the entry is in memory
   //
@@ -259,6 +263,61 @@ FatFreeClusters (
   return EFI_SUCCESS;
 }
 
+/**
+
+  Build the free cluster bitmap of the volume if it is not built yet.
+
+  The bitmap is built with one pass over the FAT, which also makes the free
+  cluster info of the volume exact.
+
+  @param  Volume                - FAT file system volume.
+
+  @retval TRUE                  - The bitmap is available.
+  @retval FALSE                 - The bitmap cannot be built; the FAT has to be
+                                  searched entry by entry.
+
+**/
+STATIC
+BOOLEAN
+FatLoadFreeMap (
+  IN FAT_VOLUME  *Volume
+  )
+{
+  UINTN  Index;
+
+  if (Volume->FreeMap.Bits != NULL) {
+    return TRUE;
+  }
+
+  if (Volume->FreeMapFailed) {
+    return FALSE;
+  }
+
+  if (EFI_ERROR (FatFreeMapInitialize (&Volume->FreeMap, Volume->MaxCluster + 2))) {
+    Volume->FreeMapFailed = TRUE;
+    return FALSE;
+  }
+
+  for (Index = FAT_MIN_CLUSTER; Index <= Volume->MaxCluster + 1; Index++) {
+    if (FatGetFatEntry (Volume, Index) == FAT_CLUSTER_FREE) {
+      FatFreeMapSet (&Volume->FreeMap, Index, TRUE);
+    }
+
+    if (Volume->DiskError) {
+      FatFreeMapRelease (&Volume->FreeMap);
+      Volume->FreeMapFailed = TRUE;
+      return FALSE;
+    }
+  }
+
+  Volume->FreeInfoValid                       = TRUE;
+  Volume->FatInfoSector.FreeInfo.ClusterCount = (UINT32)Volume->FreeMap.FreeCount;
+  Volume->FatInfoSector.Signature             = FAT_INFO_SIGNATURE;
+  Volume->FatInfoSector.InfoBeginSignature    = FAT_INFO_BEGIN_SIGNATURE;
+  Volume->FatInfoSector.InfoEndSignature      = FAT_INFO_END_SIGNATURE;
+  return TRUE;
+}
+
 /**
 
   Allocate a free cluster and return the cluster index.
@@ -283,6 +342,16 @@ FatAllocateCluster (
     return (UINTN)FAT_CLUSTER_LAST;
   }
 
+  if (FatLoadFreeMap (Volume)) {
+    Cluster = FatFreeMapFindFree (&Volume->FreeMap, Volume->FatInfoSector.FreeInfo.NextCluster);
+    if (Cluster == MAX_UINTN) {
+      return (UINTN)FAT_CLUSTER_LAST;
+    }
+
+    Volume->FatInfoSector.FreeInfo.NextCluster = (UINT32)(Cluster + 1);
+    return Cluster;
+  }
+
   for ( ; ;) {
     //
     // If the end of the list, return no available cluster
@@ -439,6 +508,8 @@ FatGrowEof (
   UINTN       LastCluster;
   UINTN       NewCluster;
   UINTN       ClusterCount;
+  UINTN       RunStart;
+  UINTN       RunLength;
 
   //
   // For FAT file system, the max file is 4GB.
@@ -493,6 +564,22 @@ FatGrowEof (
     //
     LastCluster = OFile->FileLastCluster;
 
+    //
+    // Point the allocation at a run of free clusters long enough for the
+    // whole growth, preferring the one that continues the file.
+    //
+    if (FatLoadFreeMap (Volume)) {
+      RunStart = FatFreeMapFindRun (
+                   &Volume->FreeMap,
+                   (LastCluster != FAT_CLUSTER_FREE) ? LastCluster + 1 : Volume->FatInfoSector.FreeInfo.NextCluster,
+                   NewSize - CurSize,
+                   &RunLength
+                   );
+      if (RunStart != MAX_UINTN) {
+        Volume->FatInfoSector.FreeInfo.NextCluster = (UINT32)RunStart;
+      }
+    }
+
     while (CurSize < NewSize) {
       NewCluster = FatAllocateCluster (Volume);
       if (FAT_END_OF_FAT_CHAIN (NewCluster)) {
@@ -724,8 +811,18 @@ FatComputeFreeInfo (
   UINTN  Index;
 
   //
-  // If we don't have valid info, compute it now
+  // If we don't have valid info, compute it now. The free cluster bitmap
+  // already knows it.
   //
+  if (!Volume->FreeInfoValid && (Volume->FreeMap.Bits != NULL)) {
+    Volume->FreeInfoValid                       = TRUE;
+    Volume->FatInfoSector.FreeInfo.ClusterCount = (UINT32)Volume->FreeMap.FreeCount;
+    Volume->FatInfoSector.FreeInfo.NextCluster  = (UINT32)FatFreeMapFindFree (&Volume->FreeMap, FAT_MIN_CLUSTER);
+    Volume->FatInfoSector.Signature             = FAT_INFO_SIGNATURE;
+    Volume->FatInfoSector.InfoBeginSignature    = FAT_INFO_BEGIN_SIGNATURE;
+    Volume->FatInfoSector.InfoEndSignature      = FAT_INFO_END_SIGNATURE;
+  }
+
   if (!Volume->FreeInfoValid) {
     Volume->FreeInfoValid                       = TRUE;
     Volume->FatInfoSector.FreeInfo.ClusterCount = 0;
@@ -0,0 +1,258 @@
+/** @file
+  Bitmap of the free clusters of a FAT volume.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "FreeClusterMap.h"
+
+/**
+
+  Find the first cluster in [Start, End) that is free, or that is in use.
+
+  @param  Map                   - The map.
+  @param  Start                 - The first cluster to check.
+  @param  End                   - The cluster after the last one to check, no
+                                  more than the clusters the map covers.
+  @param  Free                  - TRUE to find a free cluster, FALSE to find a
+                                  cluster in use.
+
+  @return The cluster found, or End if there is none.
+
+**/
+STATIC
+UINTN
+FatFreeMapScan (
+  IN CONST FAT_FREE_CLUSTER_MAP  *Map,
+  IN UINTN                       Start,
+  IN UINTN                       End,
+  IN BOOLEAN                     Free
+  )
+{
+  UINTN   Index;
+  UINT32  Word;
+
+  for (Index = Start; Index < End; Index = (Index & ~(UINTN)31) + 32) {
+    Word = Map->Bits[Index / 32];
+    if (!Free) {
+      Word = ~Word;
+    }
+
+    //
+    // Skip the whole word when none of its clusters from Index on matches.
+    //
+    Word &= MAX_UINT32 << (Index % 32);
+    if (Word != 0) {
+      Index = (Index & ~(UINTN)31) + (UINTN)LowBitSet32 (Word);
+      return MIN (Index, End);
+    }
+  }
+
+  return End;
+}
+
+/**
+
+  Allocate a map with all clusters in use.
+
+  @param  Map                   - The map to initialize.
+  @param  ClusterCount          - The number of clusters the map covers.
+
+  @retval EFI_SUCCESS           - The map is initialized.
+  @retval EFI_OUT_OF_RESOURCES  - Not enough memory for the map.
+
+**/
+EFI_STATUS
+FatFreeMapInitialize (
+  OUT FAT_FREE_CLUSTER_MAP  *Map,
+  IN  UINTN                 ClusterCount
+  )
+{
+  Map->Bits = AllocateZeroPool ((ClusterCount + 31) / 32 * sizeof (UINT32));
+  if (Map->Bits == NULL) {
+    Map->ClusterCount = 0;
+    Map->FreeCount    = 0;
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Map->ClusterCount = ClusterCount;
+  Map->FreeCount    = 0;
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Free the memory of a map, and make it empty.
+
+  @param  Map                   - The map.
+
+**/
+VOID
+FatFreeMapRelease (
+  IN OUT FAT_FREE_CLUSTER_MAP  *Map
+  )
+{
+  if (Map->Bits != NULL) {
+    FreePool (Map->Bits);
+  }
+
+  Map->Bits         = NULL;
+  Map->ClusterCount = 0;
+  Map->FreeCount    = 0;
+}
+
+/**
+
+  Mark a cluster free or in use.
+
+  @param  Map                   - The map.
+  @param  Cluster               - The cluster, which is covered by the map.
+  @param  Free                  - TRUE if the cluster is free.
+
+**/
+VOID
+FatFreeMapSet (
+  IN OUT FAT_FREE_CLUSTER_MAP  *Map,
+  IN     UINTN                 Cluster,
+  IN     BOOLEAN               Free
+  )
+{
+  UINT32  Bit;
+
+  ASSERT (Cluster < Map->ClusterCount);
+
+  Bit = (UINT32)1 << (Cluster % 32);
+  if (Free && ((Map->Bits[Cluster / 32] & Bit) == 0)) {
+    Map->Bits[Cluster / 32] |= Bit;
+    Map->FreeCount++;
+  } else if (!Free && ((Map->Bits[Cluster / 32] & Bit) != 0)) {
+    Map->Bits[Cluster / 32] &= ~Bit;
+    Map->FreeCount--;
+  }
+}
+
+/**
+
+  Check whether a cluster is free.
+
+  @param  Map                   - The map.
+  @param  Cluster               - The cluster.
+
+  @retval TRUE                  - The cluster is covered by the map and free.
+  @retval FALSE                 - Otherwise.
+
+**/
+BOOLEAN
+FatFreeMapIsFree (
+  IN CONST FAT_FREE_CLUSTER_MAP  *Map,
+  IN UINTN                       Cluster
+  )
+{
+  if (Cluster >= Map->ClusterCount) {
+    return FALSE;
+  }
+
+  return (BOOLEAN)((Map->Bits[Cluster / 32] & ((UINT32)1 << (Cluster % 32))) != 0);
+}
+
+/**
+
+  Find the first free cluster at or after Start, wrapping around to the start
+  of the map.
+
+  @param  Map                   - The map.
+  @param  Start                 - The cluster to start the search at.
+
+  @return The free cluster found, or MAX_UINTN if no cluster is free.
+
+**/
+UINTN
+FatFreeMapFindFree (
+  IN CONST FAT_FREE_CLUSTER_MAP  *Map,
+  IN UINTN                       Start
+  )
+{
+  UINTN  Cluster;
+
+  if (Map->FreeCount == 0) {
+    return MAX_UINTN;
+  }
+
+  Start   = MIN (Start, Map->ClusterCount);
+  Cluster = FatFreeMapScan (Map, Start, Map->ClusterCount, TRUE);
+  if (Cluster == Map->ClusterCount) {
+    Cluster = FatFreeMapScan (Map, 0, Start, TRUE);
+    if (Cluster == Start) {
+      return MAX_UINTN;
+    }
+  }
+
+  return Cluster;
+}
+
+/**
+
+  Find the first run of at least Count consecutive free clusters at or after
+  Start, wrapping around to the start of the map. If there is none, find the
+  longest run.
+
+  @param  Map                   - The map.
+  @param  Start                 - The cluster to start the search at.
+  @param  Count                 - The number of clusters wanted.
+  @param  RunLength             - The length of the run found.
+
+  @return The first cluster of the run found, or MAX_UINTN if no cluster is
+          free.
+
+**/
+UINTN
+FatFreeMapFindRun (
+  IN  CONST FAT_FREE_CLUSTER_MAP  *Map,
+  IN  UINTN                       Start,
+  IN  UINTN                       Count,
+  OUT UINTN                       *RunLength
+  )
+{
+  UINTN  BestStart;
+  UINTN  BestLength;
+  UINTN  Cluster;
+  UINTN  RunEnd;
+  UINTN  End;
+  UINTN  Pass;
+
+  BestStart  = MAX_UINTN;
+  BestLength = 0;
+  Start      = MIN (Start, Map->ClusterCount);
+
+  //
+  // Look for the start of a run in [Start, ClusterCount) first, and then in
+  // [0, Start). A run is measured up to the end of the map in both passes.
+  //
+  for (Pass = 0; Pass < 2 && Map->FreeCount > 0; Pass++) {
+    Cluster = (Pass == 0) ? Start : 0;
+    End     = (Pass == 0) ? Map->ClusterCount : Start;
+    while (Cluster < End) {
+      Cluster = FatFreeMapScan (Map, Cluster, End, TRUE);
+      if (Cluster == End) {
+        break;
+      }
+
+      RunEnd = FatFreeMapScan (Map, Cluster, Map->ClusterCount, FALSE);
+      if (RunEnd - Cluster > BestLength) {
+        BestStart  = Cluster;
+        BestLength = RunEnd - Cluster;
+        if (BestLength >= Count) {
+          *RunLength = BestLength;
+          return BestStart;
+        }
+      }
+
+      Cluster = RunEnd;
+    }
+  }
+
+  *RunLength = BestLength;
+  return BestStart;
+}
@@ -0,0 +1,129 @@
+/** @file
+  Bitmap of the free clusters of a FAT volume.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _FREE_CLUSTER_MAP_H_
+#define _FREE_CLUSTER_MAP_H_
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+
+///
+/// A bit is set for every free cluster. A zero initialized map is empty, and
+/// an empty map has no free cluster.
+///
+typedef struct {
+  UINT32    *Bits;
+  UINTN     ClusterCount;               // Number of clusters covered, from cluster 0
+  UINTN     FreeCount;
+} FAT_FREE_CLUSTER_MAP;
+
+/**
+
+  Allocate a map with all clusters in use.
+
+  @param  Map                   - The map to initialize.
+  @param  ClusterCount          - The number of clusters the map covers.
+
+  @retval EFI_SUCCESS           - The map is initialized.
+  @retval EFI_OUT_OF_RESOURCES  - Not enough memory for the map.
+
+**/
+EFI_STATUS
+FatFreeMapInitialize (
+  OUT FAT_FREE_CLUSTER_MAP  *Map,
+  IN  UINTN                 ClusterCount
+  );
+
+/**
+
+  Free the memory of a map, and make it empty.
+
+  @param  Map                   - The map.
+
+**/
+VOID
+FatFreeMapRelease (
+  IN OUT FAT_FREE_CLUSTER_MAP  *Map
+  );
+
+/**
+
+  Mark a cluster free or in use.
+
+  @param  Map                   - The map.
+  @param  Cluster               - The cluster, which is covered by the map.
+  @param  Free                  - TRUE if the cluster is free.
+
+**/
+VOID
+FatFreeMapSet (
+  IN OUT FAT_FREE_CLUSTER_MAP  *Map,
+  IN     UINTN                 Cluster,
+  IN     BOOLEAN               Free
+  );
+
+/**
+
+  Check whether a cluster is free.
+
+  @param  Map                   - The map.
+  @param  Cluster               - The cluster.
+
+  @retval TRUE                  - The cluster is covered by the map and free.
+  @retval FALSE                 - Otherwise.
+
+**/
+BOOLEAN
+FatFreeMapIsFree (
+  IN CONST FAT_FREE_CLUSTER_MAP  *Map,
+  IN UINTN                       Cluster
+  );
+
+/**
+
+  Find the first free cluster at or after Start, wrapping around to the start
+  of the map.
+
+  @param  Map                   - The map.
+  @param  Start                 - The cluster to start the search at.
+
+  @return The free cluster found, or MAX_UINTN if no cluster is free.
+
+**/
+UINTN
+FatFreeMapFindFree (
+  IN CONST FAT_FREE_CLUSTER_MAP  *Map,
+  IN UINTN                       Start
+  );
+
+/**
+
+  Find the first run of at least Count consecutive free clusters at or after
+  Start, wrapping around to the start of the map. If there is none, find the
+  longest run.
+
+  @param  Map                   - The map.
+  @param  Start                 - The cluster to start the search at.
+  @param  Count                 - The number of clusters wanted.
+  @param  RunLength             - The length of the run found.
+
+  @return The first cluster of the run found, or MAX_UINTN if no cluster is
+          free.
+
+**/
+UINTN
+FatFreeMapFindRun (
+  IN  CONST FAT_FREE_CLUSTER_MAP  *Map,
+  IN  UINTN                       Start,
+  IN  UINTN                       Count,
+  OUT UINTN                       *RunLength
+  );
+
+#endif
@@ -465,9 +465,18 @@ FatFreeVolume (
   // Free disk cache
   //
   if (Volume->CacheBuffer != NULL) {
+    DEBUG ((
+      DEBUG_VERBOSE,
+      "FatFreeVolume: data cache hits %Lu, misses %Lu, pages read ahead %Lu\n",
+      (UINT64)Volume->DiskCache[CacheData].HitCount,
+      (UINT64)Volume->DiskCache[CacheData].MissCount,
+      (UINT64)Volume->DiskCache[CacheData].ReadAheadCount
+      ));
     FreePool (Volume->CacheBuffer);
   }
 
+  FatFreeMapRelease (&Volume->FreeMap);
+
   //
   // Free directory cache
   //
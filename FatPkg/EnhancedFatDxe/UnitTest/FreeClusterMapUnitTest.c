@@ -0,0 +1,645 @@
+/** @file
+  Unit tests of the free cluster bitmap of the FAT driver.
+
+  The tests keep a simulated FAT of a volume in sync with the bitmap, fill the
+  volume with files allocated the way FatGrowEof() allocates them, fragment it
+  by deleting every other file, and check the bitmap against the FAT and the
+  searches against a linear scan.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/UnitTestBenchmarkLib.h>
+
+#include "../FreeClusterMap.h"
+
+#define UNIT_TEST_APP_NAME     "FAT Free Cluster Map Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+//
+// Clusters 0 and 1 are reserved. The count is not a multiple of 32 so that
+// the last word of the bitmap is partly used.
+//
+#define TEST_MIN_CLUSTER     2
+#define TEST_CLUSTER_COUNT   (0x10000 + 13)
+#define TEST_MAX_FILE_COUNT  0x10000
+#define TEST_MAX_FILE_SIZE   64
+
+#define TEST_CLUSTER_FREE  0
+#define TEST_CLUSTER_LAST  MAX_UINT32
+
+STATIC UINT32                *mFat;
+STATIC FAT_FREE_CLUSTER_MAP  mMap;
+STATIC UINTN                 *mFiles;
+STATIC UINTN                 mFileCount;
+STATIC UINTN                 mNextCluster;
+STATIC UINT32                mSeed;
+
+/**
+  Set an entry of the simulated FAT, and keep the bitmap in sync the way
+  FatSetFatEntry() does.
+
+  @param[in]  Cluster  The cluster.
+  @param[in]  Value    The new FAT entry value.
+**/
+STATIC
+VOID
+SetCluster (
+  IN UINTN   Cluster,
+  IN UINT32  Value
+  )
+{
+  mFat[Cluster] = Value;
+  FatFreeMapSet (&mMap, Cluster, (BOOLEAN)(Value == TEST_CLUSTER_FREE));
+}
+
+/**
+  Allocate the cluster chain of a file the way FatGrowEof() does: point the
+  allocation at a long enough free run, and take free clusters from there.
+
+  @param[in]   Count      The number of clusters of the file.
+  @param[out]  Fragments  The number of discontinuities of the chain.
+
+  @return The first cluster of the file, or 0 if the volume is full. A partial
+          chain is freed.
+**/
+STATIC
+UINTN
+AllocateFile (
+  IN  UINTN  Count,
+  OUT UINTN  *Fragments
+  )
+{
+  UINTN  First;
+  UINTN  Last;
+  UINTN  Cluster;
+  UINTN  RunStart;
+  UINTN  RunLength;
+  UINTN  Index;
+
+  *Fragments = 0;
+  RunStart   = FatFreeMapFindRun (&mMap, mNextCluster, Count, &RunLength);
+  if (RunStart != MAX_UINTN) {
+    mNextCluster = RunStart;
+  }
+
+  First = 0;
+  Last  = 0;
+  for (Index = 0; Index < Count; Index++) {
+    Cluster = FatFreeMapFindFree (&mMap, mNextCluster);
+    if (Cluster == MAX_UINTN) {
+      while (First != 0) {
+        Cluster = (mFat[First] == TEST_CLUSTER_LAST) ? 0 : mFat[First];
+        SetCluster (First, TEST_CLUSTER_FREE);
+        First = Cluster;
+      }
+
+      return 0;
+    }
+
+    mNextCluster = Cluster + 1;
+    if (Last == 0) {
+      First = Cluster;
+    } else {
+      SetCluster (Last, (UINT32)Cluster);
+      if (Cluster != Last + 1) {
+        (*Fragments)++;
+      }
+    }
+
+    SetCluster (Cluster, TEST_CLUSTER_LAST);
+    Last = Cluster;
+  }
+
+  return First;
+}
+
+/**
+  Free the cluster chain of a file.
+
+  @param[in]  First  The first cluster of the file.
+**/
+STATIC
+VOID
+DeleteFile (
+  IN UINTN  First
+  )
+{
+  UINTN  Next;
+
+  while (First != 0) {
+    Next = (mFat[First] == TEST_CLUSTER_LAST) ? 0 : mFat[First];
+    SetCluster (First, TEST_CLUSTER_FREE);
+    if (First < mNextCluster) {
+      mNextCluster = First;
+    }
+
+    First = Next;
+  }
+}
+
+/**
+  Find the first free cluster at or after Start, wrapping around, with a
+  linear scan of the simulated FAT.
+
+  @param[in]  Start  The cluster to start at.
+
+  @return The free cluster, or MAX_UINTN if there is none.
+**/
+STATIC
+UINTN
+ReferenceFindFree (
+  IN UINTN  Start
+  )
+{
+  UINTN  Index;
+  UINTN  Cluster;
+
+  for (Index = 0; Index < TEST_CLUSTER_COUNT; Index++) {
+    Cluster = (MIN (Start, TEST_CLUSTER_COUNT) + Index) % TEST_CLUSTER_COUNT;
+    if ((Cluster >= TEST_MIN_CLUSTER) && (mFat[Cluster] == TEST_CLUSTER_FREE)) {
+      return Cluster;
+    }
+  }
+
+  return MAX_UINTN;
+}
+
+/**
+  Get the length of the free run starting at a cluster of the simulated FAT.
+
+  @param[in]  Cluster  The first cluster of the run.
+
+  @return The number of consecutive free clusters.
+**/
+STATIC
+UINTN
+ReferenceRunLength (
+  IN UINTN  Cluster
+  )
+{
+  UINTN  Length;
+
+  for (Length = 0; Cluster + Length < TEST_CLUSTER_COUNT; Length++) {
+    if (mFat[Cluster + Length] != TEST_CLUSTER_FREE) {
+      break;
+    }
+  }
+
+  return Length;
+}
+
+/**
+  Check the bitmap against the simulated FAT.
+
+  @retval  UNIT_TEST_PASSED             The bitmap matches the FAT.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+CheckMapMatchesFat (
+  VOID
+  )
+{
+  UINTN  Cluster;
+  UINTN  FreeCount;
+
+  FreeCount = 0;
+  for (Cluster = TEST_MIN_CLUSTER; Cluster < TEST_CLUSTER_COUNT; Cluster++) {
+    UT_ASSERT_EQUAL (FatFreeMapIsFree (&mMap, Cluster), mFat[Cluster] == TEST_CLUSTER_FREE);
+    if (mFat[Cluster] == TEST_CLUSTER_FREE) {
+      FreeCount++;
+    }
+  }
+
+  UT_ASSERT_FALSE (FatFreeMapIsFree (&mMap, 0));
+  UT_ASSERT_FALSE (FatFreeMapIsFree (&mMap, 1));
+  UT_ASSERT_FALSE (FatFreeMapIsFree (&mMap, TEST_CLUSTER_COUNT));
+  UT_ASSERT_EQUAL (mMap.FreeCount, FreeCount);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Create an empty volume.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED                 The volume is created.
+  @retval  UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  Out of memory.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+CreateVolume (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Cluster;
+
+  mFat   = AllocateZeroPool (TEST_CLUSTER_COUNT * sizeof (UINT32));
+  mFiles = AllocateZeroPool (TEST_MAX_FILE_COUNT * sizeof (UINTN));
+  if ((mFat == NULL) || (mFiles == NULL) ||
+      EFI_ERROR (FatFreeMapInitialize (&mMap, TEST_CLUSTER_COUNT)))
+  {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  mFat[0] = TEST_CLUSTER_LAST;
+  mFat[1] = TEST_CLUSTER_LAST;
+  for (Cluster = TEST_MIN_CLUSTER; Cluster < TEST_CLUSTER_COUNT; Cluster++) {
+    FatFreeMapSet (&mMap, Cluster, TRUE);
+  }
+
+  mFileCount   = 0;
+  mNextCluster = TEST_MIN_CLUSTER;
+  mSeed        = 0x5EED;
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Free the volume.
+
+  @param[in]  Context    Unused.
+**/
+STATIC
+VOID
+EFIAPI
+DestroyVolume (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  FatFreeMapRelease (&mMap);
+  if (mFat != NULL) {
+    FreePool (mFat);
+    mFat = NULL;
+  }
+
+  if (mFiles != NULL) {
+    FreePool (mFiles);
+    mFiles = NULL;
+  }
+}
+
+/**
+  Fill the volume with files of random size.
+
+  @retval  UNIT_TEST_PASSED             The volume is full.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+FillVolume (
+  VOID
+  )
+{
+  UINTN  First;
+  UINTN  Fragments;
+
+  for ( ; ;) {
+    UT_ASSERT_TRUE (mFileCount < TEST_MAX_FILE_COUNT);
+    First = AllocateFile (1 + UnitTestRandom (&mSeed) % TEST_MAX_FILE_SIZE, &Fragments);
+    if (First == 0) {
+      break;
+    }
+
+    mFiles[mFileCount++] = First;
+  }
+
+  //
+  // Top the volume off with single cluster files.
+  //
+  for ( ; ;) {
+    UT_ASSERT_TRUE (mFileCount < TEST_MAX_FILE_COUNT);
+    First = AllocateFile (1, &Fragments);
+    if (First == 0) {
+      break;
+    }
+
+    mFiles[mFileCount++] = First;
+  }
+
+  UT_ASSERT_EQUAL (mMap.FreeCount, 0);
+  UT_ASSERT_EQUAL (FatFreeMapFindFree (&mMap, TEST_MIN_CLUSTER), MAX_UINTN);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Fill an empty volume, and check that files are allocated contiguously and
+  that the bitmap tracks the FAT.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+FillShouldAllocateContiguously (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN             First;
+  UINTN             Fragments;
+  UNIT_TEST_STATUS  Status;
+
+  UT_ASSERT_EQUAL (mMap.FreeCount, TEST_CLUSTER_COUNT - TEST_MIN_CLUSTER);
+
+  //
+  // On an empty volume every file is a single run.
+  //
+  while (mMap.FreeCount >= TEST_MAX_FILE_SIZE) {
+    First = AllocateFile (1 + UnitTestRandom (&mSeed) % TEST_MAX_FILE_SIZE, &Fragments);
+    UT_ASSERT_NOT_EQUAL (First, 0);
+    UT_ASSERT_EQUAL (Fragments, 0);
+    mFiles[mFileCount++] = First;
+  }
+
+  Status = FillVolume ();
+  if (Status != UNIT_TEST_PASSED) {
+    return Status;
+  }
+
+  return CheckMapMatchesFat ();
+}
+
+/**
+  Fragment a full volume by deleting every other file, and check that a new
+  file goes to a long enough free run when there is one, and that the volume
+  can be filled and emptied again.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+FragmentedVolumeShouldUseLongestRun (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN             Index;
+  UINTN             Cluster;
+  UINTN             Longest;
+  UINTN             First;
+  UINTN             Fragments;
+  UNIT_TEST_STATUS  Status;
+
+  Status = FillVolume ();
+  if (Status != UNIT_TEST_PASSED) {
+    return Status;
+  }
+
+  for (Index = 0; Index < mFileCount; Index += 2) {
+    DeleteFile (mFiles[Index]);
+    mFiles[Index] = 0;
+  }
+
+  Status = CheckMapMatchesFat ();
+  if (Status != UNIT_TEST_PASSED) {
+    return Status;
+  }
+
+  Longest = 0;
+  for (Cluster = TEST_MIN_CLUSTER; Cluster < TEST_CLUSTER_COUNT; Cluster++) {
+    Longest = MAX (Longest, ReferenceRunLength (Cluster));
+  }
+
+  UT_ASSERT_TRUE (Longest > 1);
+
+  //
+  // A file that fits in the longest hole is not fragmented, wherever the
+  // allocation hint points.
+  //
+  mNextCluster = TEST_MIN_CLUSTER;
+  First        = AllocateFile (Longest, &Fragments);
+  UT_ASSERT_NOT_EQUAL (First, 0);
+  UT_ASSERT_EQUAL (Fragments, 0);
+  DeleteFile (First);
+
+  mNextCluster = TEST_CLUSTER_COUNT - 1;
+  First        = AllocateFile (Longest, &Fragments);
+  UT_ASSERT_NOT_EQUAL (First, 0);
+  UT_ASSERT_EQUAL (Fragments, 0);
+  DeleteFile (First);
+
+  //
+  // A file larger than any hole still gets all the clusters it needs.
+  //
+  First = AllocateFile (Longest * 4, &Fragments);
+  UT_ASSERT_NOT_EQUAL (First, 0);
+  UT_ASSERT_TRUE (Fragments > 0);
+  DeleteFile (First);
+
+  Status = CheckMapMatchesFat ();
+  if (Status != UNIT_TEST_PASSED) {
+    return Status;
+  }
+
+  Status = FillVolume ();
+  if (Status != UNIT_TEST_PASSED) {
+    return Status;
+  }
+
+  for (Index = 0; Index < mFileCount; Index++) {
+    DeleteFile (mFiles[Index]);
+  }
+
+  UT_ASSERT_EQUAL (mMap.FreeCount, TEST_CLUSTER_COUNT - TEST_MIN_CLUSTER);
+  return CheckMapMatchesFat ();
+}
+
+/**
+  Check the searches against a linear scan on a random bitmap.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SearchShouldMatchLinearScan (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Cluster;
+  UINTN  Start;
+  UINTN  Count;
+  UINTN  RunStart;
+  UINTN  RunLength;
+  UINTN  Round;
+
+  //
+  // Runs of used and free clusters of random length.
+  //
+  Cluster = TEST_MIN_CLUSTER;
+  while (Cluster < TEST_CLUSTER_COUNT) {
+    Count = 1 + UnitTestRandom (&mSeed) % 100;
+    for ( ; Count > 0 && Cluster < TEST_CLUSTER_COUNT; Count--, Cluster++) {
+      SetCluster (Cluster, TEST_CLUSTER_LAST);
+    }
+
+    Count = 1 + UnitTestRandom (&mSeed) % 40;
+    Cluster += Count;
+  }
+
+  for (Round = 0; Round < 2000; Round++) {
+    Start = UnitTestRandom (&mSeed) % (TEST_CLUSTER_COUNT + 2);
+    UT_ASSERT_EQUAL (FatFreeMapFindFree (&mMap, Start), ReferenceFindFree (Start));
+
+    Count    = 1 + UnitTestRandom (&mSeed) % 48;
+    RunStart = FatFreeMapFindRun (&mMap, Start, Count, &RunLength);
+    UT_ASSERT_NOT_EQUAL (RunStart, MAX_UINTN);
+    UT_ASSERT_EQUAL (RunLength, ReferenceRunLength (RunStart));
+    if (RunLength >= Count) {
+      //
+      // No run of Count clusters starts between Start and RunStart.
+      //
+      for (Cluster = Start; Cluster != RunStart; Cluster = (Cluster + 1) % TEST_CLUSTER_COUNT) {
+        UT_ASSERT_TRUE (ReferenceRunLength (Cluster) < Count);
+      }
+    } else {
+      for (Cluster = 0; Cluster < TEST_CLUSTER_COUNT; Cluster++) {
+        UT_ASSERT_TRUE (ReferenceRunLength (Cluster) <= RunLength);
+      }
+    }
+  }
+
+  return CheckMapMatchesFat ();
+}
+
+/**
+  Check the searches on a map without free clusters.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+FullMapShouldHaveNoFreeCluster (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Cluster;
+  UINTN  RunLength;
+
+  for (Cluster = TEST_MIN_CLUSTER; Cluster < TEST_CLUSTER_COUNT; Cluster++) {
+    SetCluster (Cluster, TEST_CLUSTER_LAST);
+  }
+
+  UT_ASSERT_EQUAL (mMap.FreeCount, 0);
+  UT_ASSERT_EQUAL (FatFreeMapFindFree (&mMap, TEST_MIN_CLUSTER), MAX_UINTN);
+  UT_ASSERT_EQUAL (FatFreeMapFindRun (&mMap, TEST_MIN_CLUSTER, 1, &RunLength), MAX_UINTN);
+  UT_ASSERT_EQUAL (RunLength, 0);
+
+  //
+  // The last cluster is found from any start.
+  //
+  SetCluster (TEST_CLUSTER_COUNT - 1, TEST_CLUSTER_FREE);
+  UT_ASSERT_EQUAL (FatFreeMapFindFree (&mMap, 0), TEST_CLUSTER_COUNT - 1);
+  UT_ASSERT_EQUAL (FatFreeMapFindFree (&mMap, TEST_CLUSTER_COUNT), TEST_CLUSTER_COUNT - 1);
+  UT_ASSERT_EQUAL (FatFreeMapFindRun (&mMap, TEST_CLUSTER_COUNT - 1, 8, &RunLength), TEST_CLUSTER_COUNT - 1);
+  UT_ASSERT_EQUAL (RunLength, 1);
+
+  return CheckMapMatchesFat ();
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the free
+  cluster map and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      MapTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&MapTests, Framework, "FAT Free Cluster Map Tests", "Fat.FreeClusterMap", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for FAT Free Cluster Map Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite------Description----------------------Name--------------Function------------------------Pre--------------Post------------Context-----------
+  //
+  AddTestCase (MapTests, "Fill empty volume", "Fill", FillShouldAllocateContiguously, CreateVolume, DestroyVolume, NULL);
+  AddTestCase (MapTests, "Fragmented volume", "Fragment", FragmentedVolumeShouldUseLongestRun, CreateVolume, DestroyVolume, NULL);
+  AddTestCase (MapTests, "Search", "Search", SearchShouldMatchLinearScan, CreateVolume, DestroyVolume, NULL);
+  AddTestCase (MapTests, "Full map", "Full", FullMapShouldHaveNoFreeCluster, CreateVolume, DestroyVolume, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define FreeClusterMapUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+FreeClusterMapUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  UnitTestingEntry ();
+  return 0;
+}
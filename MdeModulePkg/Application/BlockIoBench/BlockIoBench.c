@@ -0,0 +1,583 @@
+/** @file
+  A shell application that measures the sequential read throughput of block
+  devices, through blocking EFI_BLOCK_IO_PROTOCOL requests and through
+  EFI_BLOCK_IO2_PROTOCOL requests kept in flight, and that optionally stresses
+  EFI_BLOCK_IO2_PROTOCOL with random reads checked against blocking ones.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+
+#include <Protocol/BlockIo.h>
+#include <Protocol/BlockIo2.h>
+#include <Protocol/ShellParameters.h>
+
+//
+// String token ID of help message text.
+// Shell supports to find help message in the resource section of an application image if
+// .MAN file is not found. This global variable is added to make build tool recognizes
+// that the help string is consumed by user and then build tool will add the string into
+// the resource section. Thus the application can use '-?' option to show help message in
+// Shell.
+//
+GLOBAL_REMOVE_IF_UNREFERENCED EFI_STRING_ID  mStrBlockIoBenchHelpTokenId = STRING_TOKEN (STR_BLOCK_IO_BENCH_HELP_INFORMATION);
+
+#define DEFAULT_READ_MIB      4096
+#define DEFAULT_TRANSFER_KIB  1024
+#define DEFAULT_DEPTH         32
+#define MAX_DEPTH             256
+
+typedef struct {
+  EFI_BLOCK_IO2_TOKEN    Token;
+  VOID                   *Buffer;
+  UINTN                  Size;
+  EFI_LBA                Lba;
+  BOOLEAN                InFlight;
+} BENCH_REQUEST;
+
+STATIC UINTN   mArgc;
+STATIC CHAR16  **mArgv;
+STATIC UINT64  mReadSize     = DEFAULT_READ_MIB * (UINT64)SIZE_1MB;
+STATIC UINTN   mTransferSize = DEFAULT_TRANSFER_KIB * SIZE_1KB;
+STATIC UINTN   mDepth        = DEFAULT_DEPTH;
+STATIC UINTN   mStressCount  = 0;
+STATIC UINT64  mRandomState  = 0x2545F4914F6CDD1DULL;
+
+/**
+  Retrieve the command line arguments from the shell.
+
+  @retval EFI_SUCCESS  mArgc and mArgv are set.
+  @return              Error codes from HandleProtocol().
+
+**/
+STATIC
+EFI_STATUS
+GetArg (
+  VOID
+  )
+{
+  EFI_STATUS                     Status;
+  EFI_SHELL_PARAMETERS_PROTOCOL  *ShellParameters;
+
+  Status = gBS->HandleProtocol (
+                  gImageHandle,
+                  &gEfiShellParametersProtocolGuid,
+                  (VOID **)&ShellParameters
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  mArgc = ShellParameters->Argc;
+  mArgv = ShellParameters->Argv;
+  return EFI_SUCCESS;
+}
+
+/**
+  Parse the command line options into mReadSize, mTransferSize, mDepth and
+  mStressCount.
+
+  @retval EFI_SUCCESS            The options are valid.
+  @retval EFI_INVALID_PARAMETER  An option is unknown, or its value is missing
+                                 or out of range.
+
+**/
+STATIC
+EFI_STATUS
+ParseOptions (
+  VOID
+  )
+{
+  UINTN  Index;
+  UINTN  Value;
+
+  for (Index = 1; Index < mArgc; Index += 2) {
+    if (Index + 1 >= mArgc) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Value = StrDecimalToUintn (mArgv[Index + 1]);
+    if (Value == 0) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    if (StrCmp (mArgv[Index], L"-m") == 0) {
+      mReadSize = MultU64x32 (Value, SIZE_1MB);
+    } else if ((StrCmp (mArgv[Index], L"-t") == 0) && (Value <= SIZE_1MB)) {
+      mTransferSize = Value * SIZE_1KB;
+    } else if ((StrCmp (mArgv[Index], L"-d") == 0) && (Value <= MAX_DEPTH)) {
+      mDepth = Value;
+    } else if (StrCmp (mArgv[Index], L"-r") == 0) {
+      mStressCount = Value;
+    } else {
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Print the throughput of a pass.
+
+  @param[in] Label    The name of the pass.
+  @param[in] Bytes    The number of bytes read.
+  @param[in] Start    The performance counter value at the start of the pass.
+  @param[in] End      The performance counter value at the end of the pass.
+  @param[in] Status   The outcome of the pass.
+
+**/
+STATIC
+VOID
+PrintResult (
+  IN CONST CHAR16  *Label,
+  IN UINT64        Bytes,
+  IN UINT64        Start,
+  IN UINT64        End,
+  IN EFI_STATUS    Status
+  )
+{
+  UINT64  Nanoseconds;
+
+  if (EFI_ERROR (Status)) {
+    Print (L"  %-10s failed after %Lu bytes: %r\n", Label, Bytes, Status);
+    return;
+  }
+
+  Nanoseconds = GetTimeInNanoSecond (End - Start);
+  if (Nanoseconds == 0) {
+    Print (L"  %-10s %Lu bytes, no timer available\n", Label, Bytes);
+    return;
+  }
+
+  //
+  // Bytes per microsecond is MB/s.
+  //
+  Print (
+    L"  %-10s %Lu bytes in %Lu ms, %Lu MB/s\n",
+    Label,
+    Bytes,
+    DivU64x32 (Nanoseconds, 1000000),
+    DivU64x64Remainder (MultU64x32 (Bytes, 1000), Nanoseconds, NULL)
+    );
+}
+
+/**
+  Read a block device sequentially with blocking ReadBlocks() calls.
+
+  @param[in]  BlockIo  The block device.
+  @param[in]  Size     The number of bytes to read, a multiple of the block size.
+  @param[in]  Buffer   A buffer of mTransferSize bytes.
+
+**/
+STATIC
+VOID
+BenchBlockIo (
+  IN EFI_BLOCK_IO_PROTOCOL  *BlockIo,
+  IN UINT64                 Size,
+  IN VOID                   *Buffer
+  )
+{
+  UINT64      Offset;
+  UINTN       Chunk;
+  UINT64      Start;
+  EFI_STATUS  Status;
+
+  Status = EFI_SUCCESS;
+  Start  = GetPerformanceCounter ();
+  for (Offset = 0; Offset < Size; Offset += Chunk) {
+    Chunk  = (UINTN)MIN (Size - Offset, mTransferSize);
+    Status = BlockIo->ReadBlocks (
+                        BlockIo,
+                        BlockIo->Media->MediaId,
+                        DivU64x32 (Offset, BlockIo->Media->BlockSize),
+                        Chunk,
+                        Buffer
+                        );
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+  }
+
+  PrintResult (L"BlockIo", Offset, Start, GetPerformanceCounter (), Status);
+}
+
+/**
+  Read a block device sequentially with mDepth ReadBlocksEx() requests in
+  flight.
+
+  @param[in]  BlockIo2  The block device.
+  @param[in]  Size      The number of bytes to read, a multiple of the block
+                        size.
+  @param[in]  Requests  mDepth requests, each with a buffer of mTransferSize
+                        bytes and an event.
+
+**/
+STATIC
+VOID
+BenchBlockIo2 (
+  IN EFI_BLOCK_IO2_PROTOCOL  *BlockIo2,
+  IN UINT64                  Size,
+  IN BENCH_REQUEST           *Requests
+  )
+{
+  UINT64         Offset;
+  UINT64         Done;
+  UINTN          InFlight;
+  UINTN          Index;
+  BENCH_REQUEST  *Request;
+  UINT64         Start;
+  EFI_STATUS     Status;
+
+  Offset   = 0;
+  Done     = 0;
+  InFlight = 0;
+  Status   = EFI_SUCCESS;
+  Start    = GetPerformanceCounter ();
+
+  do {
+    for (Index = 0; Index < mDepth; Index++) {
+      Request = &Requests[Index];
+      if (Request->InFlight) {
+        if (gBS->CheckEvent (Request->Token.Event) != EFI_SUCCESS) {
+          continue;
+        }
+
+        Request->InFlight = FALSE;
+        InFlight--;
+        if (EFI_ERROR (Request->Token.TransactionStatus)) {
+          Status = Request->Token.TransactionStatus;
+        } else {
+          Done += Request->Size;
+        }
+      }
+
+      if (EFI_ERROR (Status) || (Offset == Size)) {
+        continue;
+      }
+
+      Request->Size                    = (UINTN)MIN (Size - Offset, mTransferSize);
+      Request->Token.TransactionStatus = EFI_NOT_READY;
+      Status                           = BlockIo2->ReadBlocksEx (
+                                                     BlockIo2,
+                                                     BlockIo2->Media->MediaId,
+                                                     DivU64x32 (Offset, BlockIo2->Media->BlockSize),
+                                                     &Request->Token,
+                                                     Request->Size,
+                                                     Request->Buffer
+                                                     );
+      if (!EFI_ERROR (Status)) {
+        Request->InFlight = TRUE;
+        InFlight++;
+        Offset += Request->Size;
+      }
+    }
+  } while (InFlight > 0);
+
+  PrintResult (L"BlockIo2", Done, Start, GetPerformanceCounter (), Status);
+}
+
+/**
+  Get the next value of a xorshift64 pseudo random sequence.
+
+  @return The pseudo random value.
+
+**/
+STATIC
+UINT64
+NextRandom (
+  VOID
+  )
+{
+  mRandomState ^= LShiftU64 (mRandomState, 13);
+  mRandomState ^= RShiftU64 (mRandomState, 7);
+  mRandomState ^= LShiftU64 (mRandomState, 17);
+  return mRandomState;
+}
+
+/**
+  Issue mStressCount ReadBlocksEx() requests of random position and size with
+  mDepth of them in flight, and compare the data of every completed request
+  with what a blocking ReadBlocks() call returns for the same blocks.
+
+  @param[in]  BlockIo   The block device.
+  @param[in]  BlockIo2  The same block device.
+  @param[in]  Size      The number of bytes at the start of the device the
+                        requests stay within, a multiple of the block size.
+  @param[in]  Requests  mDepth requests, each with a buffer of mTransferSize
+                        bytes and an event.
+  @param[in]  Expected  A buffer of mTransferSize bytes.
+
+**/
+STATIC
+VOID
+StressBlockIo2 (
+  IN EFI_BLOCK_IO_PROTOCOL   *BlockIo,
+  IN EFI_BLOCK_IO2_PROTOCOL  *BlockIo2,
+  IN UINT64                  Size,
+  IN BENCH_REQUEST           *Requests,
+  IN VOID                    *Expected
+  )
+{
+  UINT32         BlockSize;
+  UINT64         Blocks;
+  UINTN          MaxBlocks;
+  UINTN          RequestBlocks;
+  UINTN          Issued;
+  UINTN          Completed;
+  UINTN          Mismatches;
+  UINTN          InFlight;
+  UINTN          Index;
+  BENCH_REQUEST  *Request;
+  UINT64         Start;
+  UINT64         End;
+  UINT64         Nanoseconds;
+  EFI_STATUS     Status;
+
+  BlockSize  = BlockIo->Media->BlockSize;
+  Blocks     = DivU64x32 (Size, BlockSize);
+  MaxBlocks  = (UINTN)MIN (Blocks, mTransferSize / BlockSize);
+  Issued     = 0;
+  Completed  = 0;
+  Mismatches = 0;
+  InFlight   = 0;
+  Status     = EFI_SUCCESS;
+  Start      = GetPerformanceCounter ();
+
+  do {
+    for (Index = 0; Index < mDepth; Index++) {
+      Request = &Requests[Index];
+      if (Request->InFlight) {
+        if (gBS->CheckEvent (Request->Token.Event) != EFI_SUCCESS) {
+          continue;
+        }
+
+        Request->InFlight = FALSE;
+        InFlight--;
+        if (EFI_ERROR (Request->Token.TransactionStatus)) {
+          Status = Request->Token.TransactionStatus;
+          continue;
+        }
+
+        Completed++;
+        Status = BlockIo->ReadBlocks (
+                            BlockIo,
+                            BlockIo->Media->MediaId,
+                            Request->Lba,
+                            Request->Size,
+                            Expected
+                            );
+        if (EFI_ERROR (Status)) {
+          continue;
+        }
+
+        if (CompareMem (Request->Buffer, Expected, Request->Size) != 0) {
+          Print (L"  mismatch at LBA 0x%Lx, %u bytes\n", Request->Lba, (UINT32)Request->Size);
+          Mismatches++;
+        }
+      }
+
+      if (EFI_ERROR (Status) || (Issued == mStressCount)) {
+        continue;
+      }
+
+      RequestBlocks                    = 1 + (UINTN)ModU64x32 (NextRandom (), (UINT32)MaxBlocks);
+      Request->Lba                     = ModU64x32 (NextRandom (), (UINT32)MIN (Blocks - RequestBlocks + 1, MAX_UINT32));
+      Request->Size                    = RequestBlocks * BlockSize;
+      Request->Token.TransactionStatus = EFI_NOT_READY;
+      Status                           = BlockIo2->ReadBlocksEx (
+                                                     BlockIo2,
+                                                     BlockIo2->Media->MediaId,
+                                                     Request->Lba,
+                                                     &Request->Token,
+                                                     Request->Size,
+                                                     Request->Buffer
+                                                     );
+      if (!EFI_ERROR (Status)) {
+        Request->InFlight = TRUE;
+        InFlight++;
+        Issued++;
+      }
+    }
+  } while (InFlight > 0);
+
+  End = GetPerformanceCounter ();
+  if (EFI_ERROR (Status)) {
+    Print (L"  %-10s failed after %u requests: %r\n", L"Stress", (UINT32)Completed, Status);
+    return;
+  }
+
+  Nanoseconds = GetTimeInNanoSecond (End - Start);
+  Print (
+    L"  %-10s %u requests, %u mismatches, %Lu requests/s including the checks\n",
+    L"Stress",
+    (UINT32)Completed,
+    (UINT32)Mismatches,
+    (Nanoseconds == 0) ? 0 : DivU64x64Remainder (MultU64x32 (Completed, 1000000000), Nanoseconds, NULL)
+    );
+}
+
+/**
+  Run the passes on a block device.
+
+  @param[in]  Handle  The handle of the block device.
+
+**/
+STATIC
+VOID
+BenchDevice (
+  IN EFI_HANDLE  Handle
+  )
+{
+  EFI_BLOCK_IO_PROTOCOL   *BlockIo;
+  EFI_BLOCK_IO2_PROTOCOL  *BlockIo2;
+  EFI_BLOCK_IO_MEDIA      *Media;
+  BENCH_REQUEST           *Requests;
+  VOID                    *Expected;
+  UINT64                  Size;
+  UINTN                   Index;
+  EFI_STATUS              Status;
+
+  Status = gBS->HandleProtocol (Handle, &gEfiBlockIoProtocolGuid, (VOID **)&BlockIo);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  Status = gBS->HandleProtocol (Handle, &gEfiBlockIo2ProtocolGuid, (VOID **)&BlockIo2);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  Media = BlockIo->Media;
+  if (!Media->MediaPresent || Media->LogicalPartition ||
+      (mTransferSize % Media->BlockSize != 0) || (Media->IoAlign > EFI_PAGE_SIZE))
+  {
+    return;
+  }
+
+  Size = MultU64x32 (Media->LastBlock + 1, Media->BlockSize);
+  Size = MIN (Size, mReadSize);
+  Size = Size - ModU64x32 (Size, Media->BlockSize);
+
+  Print (
+    L"Handle %p: BlockSize %u, reading %Lu MiB, %u KiB per request\n",
+    Handle,
+    Media->BlockSize,
+    RShiftU64 (Size, 20),
+    (UINT32)(mTransferSize / SIZE_1KB)
+    );
+
+  Requests = AllocateZeroPool (mDepth * sizeof (*Requests));
+  if (Requests == NULL) {
+    Print (L"  out of memory\n");
+    return;
+  }
+
+  Expected = NULL;
+
+  for (Index = 0; Index < mDepth; Index++) {
+    Requests[Index].Buffer = AllocatePages (EFI_SIZE_TO_PAGES (mTransferSize));
+    if (Requests[Index].Buffer == NULL) {
+      Print (L"  out of memory\n");
+      goto FreeRequests;
+    }
+
+    Status = gBS->CreateEvent (0, TPL_CALLBACK, NULL, NULL, &Requests[Index].Token.Event);
+    if (EFI_ERROR (Status)) {
+      Print (L"  CreateEvent: %r\n", Status);
+      goto FreeRequests;
+    }
+  }
+
+  BenchBlockIo (BlockIo, Size, Requests[0].Buffer);
+  BenchBlockIo2 (BlockIo2, Size, Requests);
+
+  if (mStressCount != 0) {
+    Expected = AllocatePages (EFI_SIZE_TO_PAGES (mTransferSize));
+    if (Expected == NULL) {
+      Print (L"  out of memory\n");
+      goto FreeRequests;
+    }
+
+    StressBlockIo2 (BlockIo, BlockIo2, Size, Requests, Expected);
+    FreePages (Expected, EFI_SIZE_TO_PAGES (mTransferSize));
+  }
+
+FreeRequests:
+  for (Index = 0; Index < mDepth; Index++) {
+    if (Requests[Index].Token.Event != NULL) {
+      gBS->CloseEvent (Requests[Index].Token.Event);
+    }
+
+    if (Requests[Index].Buffer != NULL) {
+      FreePages (Requests[Index].Buffer, EFI_SIZE_TO_PAGES (mTransferSize));
+    }
+  }
+
+  FreePool (Requests);
+}
+
+/**
+  Main entrypoint for BlockIoBench shell application.
+
+  @param[in]  ImageHandle     The image handle.
+  @param[in]  SystemTable     The system table.
+
+  @retval EFI_SUCCESS            Command completed successfully.
+  @retval EFI_INVALID_PARAMETER  Command usage error.
+  @retval EFI_NOT_FOUND          No block device found.
+
+**/
+EFI_STATUS
+EFIAPI
+BlockIoBenchMain (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS  Status;
+  EFI_HANDLE  *Handles;
+  UINTN       HandleCount;
+  UINTN       Index;
+
+  Status = GetArg ();
+  if (EFI_ERROR (Status)) {
+    Print (L"Please use UEFI SHELL to run this application!\n");
+    return Status;
+  }
+
+  Status = ParseOptions ();
+  if (EFI_ERROR (Status)) {
+    Print (L"BlockIoBench: Error. Usage: BlockIoBench [-m MiB] [-t KiB] [-d Depth] [-r Count]\n");
+    return Status;
+  }
+
+  Status = gBS->LocateHandleBuffer (
+                  ByProtocol,
+                  &gEfiBlockIo2ProtocolGuid,
+                  NULL,
+                  &HandleCount,
+                  &Handles
+                  );
+  if (EFI_ERROR (Status)) {
+    Print (L"BlockIoBench: No EFI_BLOCK_IO2_PROTOCOL instance found.\n");
+    return EFI_NOT_FOUND;
+  }
+
+  for (Index = 0; Index < HandleCount; Index++) {
+    BenchDevice (Handles[Index]);
+  }
+
+  FreePool (Handles);
+  return EFI_SUCCESS;
+}
@@ -528,43 +528,33 @@ UnregisterNvmeNamespace (
 }
 
 /**
-  Call back function when the timer event is signaled.
+  Submit the queued asynchronous subtasks to the non-blocking I/O submission
+  queue.
 
-  @param[in]  Event     The Event this notify function registered to.
-  @param[in]  Context   Pointer to the context data registered to the
-                        Event.
+  The submission queue tail doorbell is written once after all subtasks that
+  fit into the queue have been placed, instead of once per subtask.
+
+  The function must be called at TPL_NOTIFY.
+
+  @param[in]  Private   The pointer to the NVME_CONTROLLER_PRIVATE_DATA data
+                        structure.
 
 **/
 VOID
-EFIAPI
-ProcessAsyncTaskList (
-  IN EFI_EVENT  Event,
-  IN VOID       *Context
+NvmeSubmitAsyncSubtasks (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
   )
 {
-  NVME_CONTROLLER_PRIVATE_DATA  *Private;
-  EFI_PCI_IO_PROTOCOL           *PciIo;
-  NVME_CQ                       *Cq;
-  UINT16                        QueueId;
-  UINT32                        Data;
-  LIST_ENTRY                    *Link;
-  LIST_ENTRY                    *NextLink;
-  NVME_PASS_THRU_ASYNC_REQ      *AsyncRequest;
-  NVME_BLKIO2_SUBTASK           *Subtask;
-  NVME_BLKIO2_REQUEST           *BlkIo2Request;
-  EFI_BLOCK_IO2_TOKEN           *Token;
-  BOOLEAN                       HasNewItem;
-  EFI_STATUS                    Status;
+  LIST_ENTRY           *Link;
+  LIST_ENTRY           *NextLink;
+  NVME_BLKIO2_SUBTASK  *Subtask;
+  NVME_BLKIO2_REQUEST  *BlkIo2Request;
+  EFI_BLOCK_IO2_TOKEN  *Token;
+  UINT32               Data;
+  EFI_STATUS           Status;
 
-  Private    = (NVME_CONTROLLER_PRIVATE_DATA *)Context;
-  QueueId    = 2;
-  Cq         = Private->CqBuffer[QueueId] + Private->CqHdbl[QueueId].Cqh;
-  HasNewItem = FALSE;
-  PciIo      = Private->PciIo;
+  Private->DeferAsyncSqDoorbell = TRUE;
 
-  //
-  // Submit asynchronous subtasks to the NVMe Submission Queue
-  //
   for (Link = GetFirstNode (&Private->UnsubmittedSubtasks);
        !IsNull (&Private->UnsubmittedSubtasks, Link);
        Link = NextLink)
@@ -636,6 +626,57 @@ ProcessAsyncTaskList (
     }
   }
 
+  Private->DeferAsyncSqDoorbell = FALSE;
+  if (Private->AsyncSqDoorbellPending) {
+    Private->AsyncSqDoorbellPending = FALSE;
+    Data                            = ReadUnaligned32 ((UINT32 *)&Private->SqTdbl[2]);
+    Private->PciIo->Mem.Write (
+                          Private->PciIo,
+                          EfiPciIoWidthUint32,
+                          NVME_BAR,
+                          NVME_SQTDBL_OFFSET (2, Private->Cap.Dstrd),
+                          1,
+                          &Data
+                          );
+  }
+}
+
+/**
+  Call back function when the timer event is signaled.
+
+  @param[in]  Event     The Event this notify function registered to.
+  @param[in]  Context   Pointer to the context data registered to the
+                        Event.
+
+**/
+VOID
+EFIAPI
+ProcessAsyncTaskList (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  NVME_CONTROLLER_PRIVATE_DATA  *Private;
+  EFI_PCI_IO_PROTOCOL           *PciIo;
+  NVME_CQ                       *Cq;
+  UINT16                        QueueId;
+  UINT32                        Data;
+  LIST_ENTRY                    *Link;
+  LIST_ENTRY                    *NextLink;
+  NVME_PASS_THRU_ASYNC_REQ      *AsyncRequest;
+  BOOLEAN                       HasNewItem;
+
+  Private    = (NVME_CONTROLLER_PRIVATE_DATA *)Context;
+  QueueId    = 2;
+  Cq         = Private->CqBuffer[QueueId] + Private->CqHdbl[QueueId].Cqh;
+  HasNewItem = FALSE;
+  PciIo      = Private->PciIo;
+
+  //
+  // Submit asynchronous subtasks to the NVMe Submission Queue
+  //
+  NvmeSubmitAsyncSubtasks (Private);
+
   while (Cq->Pt != Private->Pt[QueueId]) {
     ASSERT (Cq->Sqid == QueueId);
 
@@ -684,6 +725,10 @@ ProcessAsyncTaskList (
                    );
         }
 
+        if (AsyncRequest->PrpListSlot != NVME_PRP_LIST_SLOT_NONE) {
+          NvmeFreePrpListSlot (Private, AsyncRequest->PrpListSlot);
+        }
+
         RemoveEntryList (Link);
         gBS->SignalEvent (AsyncRequest->CallerEvent);
         FreePool (AsyncRequest);
@@ -697,7 +742,7 @@ ProcessAsyncTaskList (
     }
 
     Private->CqHdbl[QueueId].Cqh++;
-    if (Private->CqHdbl[QueueId].Cqh > MIN (NVME_ASYNC_CCQ_SIZE, Private->Cap.Mqes)) {
+    if (Private->CqHdbl[QueueId].Cqh > Private->AsyncCqSize) {
       Private->CqHdbl[QueueId].Cqh = 0;
       Private->Pt[QueueId]        ^= 1;
     }
@@ -1002,21 +1047,36 @@ NvmExpressDriverBindingStart (
     }
 
     //
-    // 6 x 4kB aligned buffers will be carved out of this buffer.
+    // 4kB aligned buffers will be carved out of this buffer.
     // 1st 4kB boundary is the start of the admin submission queue.
     // 2nd 4kB boundary is the start of the admin completion queue.
     // 3rd 4kB boundary is the start of I/O submission queue #1.
     // 4th 4kB boundary is the start of I/O completion queue #1.
     // 5th 4kB boundary is the start of I/O submission queue #2.
-    // 6th 4kB boundary is the start of I/O completion queue #2.
+    // I/O completion queue #2 and the PRP list pool follow.
     //
-    // Allocate 6 pages of memory, then map it for bus master read and write.
+    // The non-blocking I/O queues are sized by PcdNvmeAsyncIoQueueSize, and
+    // the PRP list pool has a page for every entry of the non-blocking I/O
+    // submission queue plus one for the blocking one.
     //
+    // Allocate the pages, then map them for bus master read and write.
+    //
+    Private->AsyncSqPages    = EFI_SIZE_TO_PAGES (PcdGet16 (PcdNvmeAsyncIoQueueSize) * sizeof (NVME_SQ));
+    Private->AsyncCqPages    = EFI_SIZE_TO_PAGES (PcdGet16 (PcdNvmeAsyncIoQueueSize) * NVME_ASYNC_CQ_RATIO * sizeof (NVME_CQ));
+    Private->PrpListPoolSize = PcdGet16 (PcdNvmeAsyncIoQueueSize) + 1;
+    Private->BufferPages     = 4 + Private->AsyncSqPages + Private->AsyncCqPages + Private->PrpListPoolSize;
+
+    Private->PrpListFreeStack = AllocatePool (Private->PrpListPoolSize * sizeof (UINT16));
+    if (Private->PrpListFreeStack == NULL) {
+      Status = EFI_OUT_OF_RESOURCES;
+      goto Exit;
+    }
+
     Status = PciIo->AllocateBuffer (
                       PciIo,
                       AllocateAnyPages,
                       EfiBootServicesData,
-                      6,
+                      Private->BufferPages,
                       (VOID **)&Private->Buffer,
                       0
                       );
@@ -1024,7 +1084,7 @@ NvmExpressDriverBindingStart (
       goto Exit;
     }
 
-    Bytes  = EFI_PAGES_TO_SIZE (6);
+    Bytes  = EFI_PAGES_TO_SIZE (Private->BufferPages);
     Status = PciIo->Map (
                       PciIo,
                       EfiPciIoOperationBusMasterCommonBuffer,
@@ -1034,12 +1094,21 @@ NvmExpressDriverBindingStart (
                       &Private->Mapping
                       );
 
-    if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (6))) {
+    if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (Private->BufferPages))) {
       goto Exit;
     }
 
     Private->BufferPciAddr = (UINT8 *)(UINTN)MappedAddr;
 
+    Private->PrpListPool        = Private->Buffer + EFI_PAGES_TO_SIZE (Private->BufferPages - Private->PrpListPoolSize);
+    Private->PrpListPoolPciAddr = Private->BufferPciAddr + EFI_PAGES_TO_SIZE (Private->BufferPages - Private->PrpListPoolSize);
+    for (Private->PrpListFreeCount = 0;
+         Private->PrpListFreeCount < Private->PrpListPoolSize;
+         Private->PrpListFreeCount++)
+    {
+      Private->PrpListFreeStack[Private->PrpListFreeCount] = Private->PrpListFreeCount;
+    }
+
     Private->Signature                 = NVME_CONTROLLER_PRIVATE_DATA_SIGNATURE;
     Private->ControllerHandle          = Controller;
     Private->ImageHandle               = This->DriverBindingHandle;
@@ -1144,7 +1213,11 @@ Exit:
   }
 
   if ((Private != NULL) && (Private->Buffer != NULL)) {
-    PciIo->FreeBuffer (PciIo, 6, Private->Buffer);
+    PciIo->FreeBuffer (PciIo, Private->BufferPages, Private->Buffer);
+  }
+
+  if ((Private != NULL) && (Private->PrpListFreeStack != NULL)) {
+    FreePool (Private->PrpListFreeStack);
   }
 
   if ((Private != NULL) && (Private->ControllerData != NULL)) {
@@ -1266,9 +1339,11 @@ NvmExpressDriverBindingStop (
       }
 
       if (Private->Buffer != NULL) {
-        Private->PciIo->FreeBuffer (Private->PciIo, 6, Private->Buffer);
+        Private->PciIo->FreeBuffer (Private->PciIo, Private->BufferPages, Private->Buffer);
       }
 
+      FreePool (Private->PrpListFreeStack);
+
       FreePool (Private->ControllerData);
       FreePool (Private);
     }
@@ -40,6 +40,7 @@
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiDriverEntryPoint.h>
 #include <Library/ReportStatusCodeLib.h>
+#include <Library/PcdLib.h>
 
 typedef struct _NVME_CONTROLLER_PRIVATE_DATA  NVME_CONTROLLER_PRIVATE_DATA;
 typedef struct _NVME_DEVICE_PRIVATE_DATA      NVME_DEVICE_PRIVATE_DATA;
@@ -63,15 +64,24 @@ extern EFI_DRIVER_SUPPORTED_EFI_VERSION_PROTOCOL  gNvmExpressDriverSupportedEfiV
 #define NVME_CCQ_SIZE  1                                // Number of I/O completion queue entries, which is 0-based
 
 //
-// Number of asynchronous I/O submission queue entries, which is 0-based.
-// The asynchronous I/O submission queue size is 4kB in total.
+// The number of asynchronous I/O submission queue entries is set by
+// PcdNvmeAsyncIoQueueSize. The asynchronous I/O completion queue has
+// NVME_ASYNC_CQ_RATIO times as many entries, as commands may complete faster
+// than their completions are processed.
 //
-#define NVME_ASYNC_CSQ_SIZE  63
+#define NVME_ASYNC_CQ_RATIO  4
+
+//
+// Value of NVME_PASS_THRU_ASYNC_REQ.PrpListSlot when the command does not use
+// a PRP list page of the pool.
+//
+#define NVME_PRP_LIST_SLOT_NONE  MAX_UINT16
+
 //
-// Number of asynchronous I/O completion queue entries, which is 0-based.
-// The asynchronous I/O completion queue size is 4kB in total.
+// SGL support reported in the SGLS field of the Identify Controller data.
 //
-#define NVME_ASYNC_CCQ_SIZE  255
+#define NVME_CTRL_SGLS_SUPPORTED      (BIT0 | BIT1)
+#define NVME_CTRL_SGLS_DWORD_ALIGNED  BIT1
 
 #define NVME_MAX_QUEUES  3                              // Number of queues supported by the driver
 
@@ -116,16 +126,37 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   NVME_ADMIN_CONTROLLER_DATA            *ControllerData;
 
   //
-  // 6 x 4kB aligned buffers will be carved out of this buffer.
+  // The following 4kB aligned buffers will be carved out of this buffer.
   // 1st 4kB boundary is the start of the admin submission queue.
   // 2nd 4kB boundary is the start of the admin completion queue.
   // 3rd 4kB boundary is the start of I/O submission queue #1.
   // 4th 4kB boundary is the start of I/O completion queue #1.
-  // 5th 4kB boundary is the start of I/O submission queue #2.
-  // 6th 4kB boundary is the start of I/O completion queue #2.
+  // 5th 4kB boundary is the start of I/O submission queue #2, which takes
+  // AsyncSqPages pages.
+  // I/O completion queue #2 follows, and takes AsyncCqPages pages.
+  // The PRP list pool follows, and takes PrpListPoolSize pages.
   //
   UINT8          *Buffer;
   UINT8          *BufferPciAddr;
+  UINTN          BufferPages;
+  UINTN          AsyncSqPages;
+  UINTN          AsyncCqPages;
+
+  //
+  // Sizes of I/O submission & completion queues #2, which are 0-based.
+  //
+  UINT16         AsyncSqSize;
+  UINT16         AsyncCqSize;
+
+  //
+  // Pool of PRP list pages, so that a command whose PRP list fits in a page
+  // does not need to allocate and map one. Free pages are kept in a stack.
+  //
+  UINT8          *PrpListPool;
+  UINT8          *PrpListPoolPciAddr;
+  UINT16         PrpListPoolSize;
+  UINT16         PrpListFreeCount;
+  UINT16         *PrpListFreeStack;
 
   //
   // Pointers to 4kB aligned submission & completion queues.
@@ -142,6 +173,13 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   NVME_CQHDBL    CqHdbl[NVME_MAX_QUEUES];
   UINT16         AsyncSqHead;
 
+  //
+  // While set, non-blocking commands are placed in the submission queue
+  // without ringing its doorbell; the submitter rings it once for the batch.
+  //
+  BOOLEAN        DeferAsyncSqDoorbell;
+  BOOLEAN        AsyncSqDoorbellPending;
+
   //
   // Flag to indicate internal IO queue creation.
   //
@@ -295,6 +333,7 @@ typedef struct {
   VOID                                        *MapPrpList;
   UINTN                                       PrpListNo;
   VOID                                        *PrpListHost;
+  UINT16                                      PrpListSlot;
   VOID                                        *MapData;
   VOID                                        *MapMeta;
   EFI_EVENT                                   CallerEvent;
@@ -741,4 +780,33 @@ NvmeUnregisterShutdownNotification (
   VOID
   );
 
+/**
+  Submit the queued asynchronous subtasks to the non-blocking I/O submission
+  queue.
+
+  The function must be called at TPL_NOTIFY.
+
+  @param[in]  Private   The pointer to the NVME_CONTROLLER_PRIVATE_DATA data
+                        structure.
+
+**/
+VOID
+NvmeSubmitAsyncSubtasks (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  );
+
+/**
+  Return a page taken from the PRP list pool.
+
+  @param[in]  Private       The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+  @param[in]  Slot          The index of the page to return.
+
+**/
+VOID
+NvmeFreePrpListSlot (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN UINT16                        Slot
+  );
+
 #endif
@@ -813,6 +813,14 @@ NvmeAsyncRead (
     }
   }
 
+  //
+  // Hand the subtasks to the controller now rather than on the next tick of
+  // the asynchronous task timer.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  NvmeSubmitAsyncSubtasks (Private);
+  gBS->RestoreTPL (OldTpl);
+
   DEBUG ((
     DEBUG_BLKIO,
     "%a: Lba = 0x%08Lx, Original = 0x%08Lx, "
@@ -941,6 +949,14 @@ NvmeAsyncWrite (
     }
   }
 
+  //
+  // Hand the subtasks to the controller now rather than on the next tick of
+  // the asynchronous task timer.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  NvmeSubmitAsyncSubtasks (Private);
+  gBS->RestoreTPL (OldTpl);
+
   DEBUG ((
     DEBUG_BLKIO,
     "%a: Lba = 0x%08Lx, Original = 0x%08Lx, "
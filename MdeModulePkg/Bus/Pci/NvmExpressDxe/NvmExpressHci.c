@@ -601,11 +601,7 @@ NvmeCreateIoCompletionQueue (
     if (Index == 1) {
       QueueSize = NVME_CCQ_SIZE;
     } else {
-      if (Private->Cap.Mqes > NVME_ASYNC_CCQ_SIZE) {
-        QueueSize = NVME_ASYNC_CCQ_SIZE;
-      } else {
-        QueueSize = Private->Cap.Mqes;
-      }
+      QueueSize = Private->AsyncCqSize;
     }
 
     CrIoCq.Qid   = Index;
@@ -673,11 +669,7 @@ NvmeCreateIoSubmissionQueue (
     if (Index == 1) {
       QueueSize = NVME_CSQ_SIZE;
     } else {
-      if (Private->Cap.Mqes > NVME_ASYNC_CSQ_SIZE) {
-        QueueSize = NVME_ASYNC_CSQ_SIZE;
-      } else {
-        QueueSize = Private->Cap.Mqes;
-      }
+      QueueSize = Private->AsyncSqSize;
     }
 
     CrIoSq.Qid   = Index;
@@ -771,6 +763,19 @@ NvmeControllerInit (
   //
   ASSERT ((Private->Cap.Mpsmin + 12) <= EFI_PAGE_SHIFT);
 
+  //
+  // Size the non-blocking I/O queues within the space allocated for them, and
+  // within the maximum queue size of the controller.
+  //
+  Private->AsyncSqSize = (UINT16)MIN (
+                                   EFI_PAGES_TO_SIZE (Private->AsyncSqPages) / sizeof (NVME_SQ) - 1,
+                                   Private->Cap.Mqes
+                                   );
+  Private->AsyncCqSize = (UINT16)MIN (
+                                   EFI_PAGES_TO_SIZE (Private->AsyncCqPages) / sizeof (NVME_CQ) - 1,
+                                   Private->Cap.Mqes
+                                   );
+
   Private->Cid[0]        = 0;
   Private->Cid[1]        = 0;
   Private->Cid[2]        = 0;
@@ -785,6 +790,8 @@ NvmeControllerInit (
   Private->CqHdbl[2].Cqh = 0;
   Private->AsyncSqHead   = 0;
 
+  Private->AsyncSqDoorbellPending = FALSE;
+
   Status = NvmeDisableController (Private);
 
   if (EFI_ERROR (Status)) {
@@ -812,7 +819,7 @@ NvmeControllerInit (
   //
   // Address of I/O submission & completion queue.
   //
-  ZeroMem (Private->Buffer, EFI_PAGES_TO_SIZE (6));
+  ZeroMem (Private->Buffer, EFI_PAGES_TO_SIZE (4 + Private->AsyncSqPages + Private->AsyncCqPages));
   Private->SqBuffer[0]        = (NVME_SQ *)(UINTN)(Private->Buffer);
   Private->SqBufferPciAddr[0] = (NVME_SQ *)(UINTN)(Private->BufferPciAddr);
   Private->CqBuffer[0]        = (NVME_CQ *)(UINTN)(Private->Buffer + 1 * EFI_PAGE_SIZE);
@@ -823,8 +830,8 @@ NvmeControllerInit (
   Private->CqBufferPciAddr[1] = (NVME_CQ *)(UINTN)(Private->BufferPciAddr + 3 * EFI_PAGE_SIZE);
   Private->SqBuffer[2]        = (NVME_SQ *)(UINTN)(Private->Buffer + 4 * EFI_PAGE_SIZE);
   Private->SqBufferPciAddr[2] = (NVME_SQ *)(UINTN)(Private->BufferPciAddr + 4 * EFI_PAGE_SIZE);
-  Private->CqBuffer[2]        = (NVME_CQ *)(UINTN)(Private->Buffer + 5 * EFI_PAGE_SIZE);
-  Private->CqBufferPciAddr[2] = (NVME_CQ *)(UINTN)(Private->BufferPciAddr + 5 * EFI_PAGE_SIZE);
+  Private->CqBuffer[2]        = (NVME_CQ *)(UINTN)(Private->Buffer + EFI_PAGES_TO_SIZE (4 + Private->AsyncSqPages));
+  Private->CqBufferPciAddr[2] = (NVME_CQ *)(UINTN)(Private->BufferPciAddr + EFI_PAGES_TO_SIZE (4 + Private->AsyncSqPages));
 
   DEBUG ((DEBUG_INFO, "Private->Buffer = [%016X]\n", (UINT64)(UINTN)Private->Buffer));
   DEBUG ((DEBUG_INFO, "Admin     Submission Queue size (Aqa.Asqs) = [%08X]\n", Aqa.Asqs));
@@ -835,6 +842,8 @@ NvmeControllerInit (
   DEBUG ((DEBUG_INFO, "Sync  I/O Completion Queue (CqBuffer[1]) = [%016X]\n", Private->CqBuffer[1]));
   DEBUG ((DEBUG_INFO, "Async I/O Submission Queue (SqBuffer[2]) = [%016X]\n", Private->SqBuffer[2]));
   DEBUG ((DEBUG_INFO, "Async I/O Completion Queue (CqBuffer[2]) = [%016X]\n", Private->CqBuffer[2]));
+  DEBUG ((DEBUG_INFO, "Async I/O Submission Queue size          = [%08X]\n", Private->AsyncSqSize));
+  DEBUG ((DEBUG_INFO, "Async I/O Completion Queue size          = [%08X]\n", Private->AsyncCqSize));
 
   //
   // Program admin queue attributes.
@@ -911,6 +920,7 @@ NvmeControllerInit (
   DEBUG ((DEBUG_INFO, "    SQES      : 0x%x\n", Private->ControllerData->Sqes));
   DEBUG ((DEBUG_INFO, "    CQES      : 0x%x\n", Private->ControllerData->Cqes));
   DEBUG ((DEBUG_INFO, "    NN        : 0x%x\n", Private->ControllerData->Nn));
+  DEBUG ((DEBUG_INFO, "    SGLS      : 0x%x\n", Private->ControllerData->Sgls));
 
   //
   // Create two I/O completion queues.
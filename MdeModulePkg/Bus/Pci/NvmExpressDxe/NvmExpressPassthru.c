@@ -314,6 +314,95 @@ EXIT:
   return NULL;
 }
 
+/**
+  Take a page from the PRP list pool carved out of the controller buffer.
+
+  @param[in]  Private       The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+
+  @return The index of the page taken, or NVME_PRP_LIST_SLOT_NONE if the pool
+          is exhausted.
+
+**/
+UINT16
+NvmeAllocatePrpListSlot (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  )
+{
+  EFI_TPL  OldTpl;
+  UINT16   Slot;
+
+  Slot   = NVME_PRP_LIST_SLOT_NONE;
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  if (Private->PrpListFreeCount != 0) {
+    Slot = Private->PrpListFreeStack[--Private->PrpListFreeCount];
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  return Slot;
+}
+
+/**
+  Return a page taken by NvmeAllocatePrpListSlot() to the PRP list pool.
+
+  @param[in]  Private       The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+  @param[in]  Slot          The index of the page to return.
+
+**/
+VOID
+NvmeFreePrpListSlot (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN UINT16                        Slot
+  )
+{
+  EFI_TPL  OldTpl;
+
+  ASSERT (Slot < Private->PrpListPoolSize);
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  ASSERT (Private->PrpListFreeCount < Private->PrpListPoolSize);
+  Private->PrpListFreeStack[Private->PrpListFreeCount++] = Slot;
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Fill a page of the PRP list pool with the PRP entries of a data buffer.
+
+  @param[in]  Private       The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+  @param[in]  Slot          The index of the page to fill.
+  @param[in]  PhysicalAddr  The page aligned bus master address of the data
+                            following the first PRP entry.
+  @param[in]  Pages         The number of PRP entries, no more than
+                            EFI_PAGE_SIZE / sizeof (UINT64).
+
+  @return The bus master address of the PRP list.
+
+**/
+UINT64
+NvmeFillPrpListSlot (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN UINT16                        Slot,
+  IN EFI_PHYSICAL_ADDRESS          PhysicalAddr,
+  IN UINTN                         Pages
+  )
+{
+  UINT64  *PrpList;
+  UINTN   Index;
+
+  ASSERT (Pages <= EFI_PAGE_SIZE / sizeof (UINT64));
+
+  PrpList = (UINT64 *)(Private->PrpListPool + EFI_PAGES_TO_SIZE (Slot));
+  for (Index = 0; Index < Pages; Index++) {
+    PrpList[Index] = PhysicalAddr;
+    PhysicalAddr  += EFI_PAGE_SIZE;
+  }
+
+  return (UINT64)(UINTN)(Private->PrpListPoolPciAddr + EFI_PAGES_TO_SIZE (Slot));
+}
+
 /**
   Aborts the asynchronous PassThru requests.
 
@@ -396,6 +485,10 @@ AbortAsyncPassThruTasks (
                );
     }
 
+    if (AsyncRequest->PrpListSlot != NVME_PRP_LIST_SLOT_NONE) {
+      NvmeFreePrpListSlot (Private, AsyncRequest->PrpListSlot);
+    }
+
     RemoveEntryList (Link);
     gBS->SignalEvent (AsyncRequest->CallerEvent);
     FreePool (AsyncRequest);
@@ -475,6 +568,8 @@ NvmExpressPassThru (
   UINT64                         *Prp;
   VOID                           *PrpListHost;
   UINTN                          PrpListNo;
+  UINT16                         PrpListSlot;
+  BOOLEAN                        UseSgl;
   UINT32                         Attributes;
   UINT32                         IoAlign;
   UINT32                         MaxTransLen;
@@ -550,10 +645,11 @@ NvmExpressPassThru (
   MapPrpList  = NULL;
   PrpListHost = NULL;
   PrpListNo   = 0;
+  PrpListSlot = NVME_PRP_LIST_SLOT_NONE;
   Prp         = NULL;
   TimerEvent  = NULL;
   Status      = EFI_SUCCESS;
-  QueueSize   = MIN (NVME_ASYNC_CSQ_SIZE, Private->Cap.Mqes) + 1;
+  QueueSize   = Private->AsyncSqSize + 1;
 
   if (Packet->QueueType == NVME_ADMIN_QUEUE) {
     QueueId = 0;
@@ -587,15 +683,6 @@ NvmExpressPassThru (
   Sq->Cid  = Private->Cid[QueueId]++;
   Sq->Nsid = Packet->NvmeCmd->Nsid;
 
-  //
-  // Currently we only support PRP for data transfer, SGL is NOT supported.
-  //
-  ASSERT (Sq->Psdt == 0);
-  if (Sq->Psdt != 0) {
-    DEBUG ((DEBUG_ERROR, "NvmExpressPassThru: doesn't support SGL mechanism\n"));
-    return EFI_UNSUPPORTED;
-  }
-
   Sq->Prp[0] = (UINT64)(UINTN)Packet->TransferBuffer;
   if ((Packet->QueueType == NVME_ADMIN_QUEUE) &&
       ((Sq->Opc == NVME_ADMIN_CRIOCQ_CMD) || (Sq->Opc == NVME_ADMIN_CRIOSQ_CMD)))
@@ -670,23 +757,57 @@ NvmExpressPassThru (
 
   //
   // If the buffer size spans more than two memory pages (page size as defined in CC.Mps),
-  // then build a PRP list in the second PRP submission queue entry.
+  // then describe an I/O command buffer with a single SGL data block descriptor when the
+  // controller supports SGLs, or build a PRP list in the second PRP submission queue entry.
   //
   Offset = ((UINT16)Sq->Prp[0]) & (EFI_PAGE_SIZE - 1);
   Bytes  = Packet->TransferLength;
 
-  if ((Offset + Bytes) > (EFI_PAGE_SIZE * 2)) {
+  UseSgl = FALSE;
+  if (((Offset + Bytes) > (EFI_PAGE_SIZE * 2)) &&
+      (Packet->QueueType == NVME_IO_QUEUE) &&
+      (MapMeta == NULL) &&
+      ((Private->ControllerData->Sgls & NVME_CTRL_SGLS_SUPPORTED) != 0))
+  {
+    UseSgl = TRUE;
+    if (((Private->ControllerData->Sgls & NVME_CTRL_SGLS_DWORD_ALIGNED) == NVME_CTRL_SGLS_DWORD_ALIGNED) &&
+        ((((UINTN)Sq->Prp[0] | Bytes) & (sizeof (UINT32) - 1)) != 0))
+    {
+      UseSgl = FALSE;
+    }
+  }
+
+  if (UseSgl) {
+    //
+    // The data pointer is an SGL and MPTR, unused here, would be a contiguous
+    // buffer. The SGL data block descriptor holds the address in its first
+    // qword and the length in its second one, with a zero SGL identifier in
+    // the last byte.
+    //
+    Sq->Psdt   = NVME_SQ_PSDT_SGL_MPTR_BUFFER;
+    Sq->Prp[1] = Bytes;
+  } else if ((Offset + Bytes) > (EFI_PAGE_SIZE * 2)) {
     //
-    // Create PrpList for remaining data buffer.
+    // Create PrpList for remaining data buffer. A list that fits in a page is
+    // taken from the pool set aside in the controller buffer, so that no
+    // allocation and mapping is needed per command.
     //
     PhyAddr = (Sq->Prp[0] + EFI_PAGE_SIZE) & ~(EFI_PAGE_SIZE - 1);
-    Prp     = NvmeCreatePrpList (PciIo, PhyAddr, EFI_SIZE_TO_PAGES (Offset + Bytes) - 1, &PrpListHost, &PrpListNo, &MapPrpList);
-    if (Prp == NULL) {
-      Status = EFI_OUT_OF_RESOURCES;
-      goto EXIT;
+    if ((EFI_SIZE_TO_PAGES (Offset + Bytes) - 1) <= (EFI_PAGE_SIZE / sizeof (UINT64))) {
+      PrpListSlot = NvmeAllocatePrpListSlot (Private);
     }
 
-    Sq->Prp[1] = (UINT64)(UINTN)Prp;
+    if (PrpListSlot != NVME_PRP_LIST_SLOT_NONE) {
+      Sq->Prp[1] = NvmeFillPrpListSlot (Private, PrpListSlot, PhyAddr, EFI_SIZE_TO_PAGES (Offset + Bytes) - 1);
+    } else {
+      Prp = NvmeCreatePrpList (PciIo, PhyAddr, EFI_SIZE_TO_PAGES (Offset + Bytes) - 1, &PrpListHost, &PrpListNo, &MapPrpList);
+      if (Prp == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        goto EXIT;
+      }
+
+      Sq->Prp[1] = (UINT64)(UINTN)Prp;
+    }
   } else if ((Offset + Bytes) > EFI_PAGE_SIZE) {
     Sq->Prp[1] = (Sq->Prp[0] + EFI_PAGE_SIZE) & ~(EFI_PAGE_SIZE - 1);
   }
@@ -724,7 +845,9 @@ NvmExpressPassThru (
   }
 
   //
-  // Ring the submission queue doorbell.
+  // Ring the submission queue doorbell. While NvmeSubmitAsyncSubtasks() is
+  // placing a batch of non-blocking requests, it rings the doorbell once for
+  // the whole batch.
   //
   if ((Event != NULL) && (QueueId != 0)) {
     Private->SqTdbl[QueueId].Sqt =
@@ -733,18 +856,22 @@ NvmExpressPassThru (
     Private->SqTdbl[QueueId].Sqt ^= 1;
   }
 
-  Data   = ReadUnaligned32 ((UINT32 *)&Private->SqTdbl[QueueId]);
-  Status = PciIo->Mem.Write (
-                        PciIo,
-                        EfiPciIoWidthUint32,
-                        NVME_BAR,
-                        NVME_SQTDBL_OFFSET (QueueId, Private->Cap.Dstrd),
-                        1,
-                        &Data
-                        );
+  if ((Event != NULL) && (QueueId != 0) && Private->DeferAsyncSqDoorbell) {
+    Private->AsyncSqDoorbellPending = TRUE;
+  } else {
+    Data   = ReadUnaligned32 ((UINT32 *)&Private->SqTdbl[QueueId]);
+    Status = PciIo->Mem.Write (
+                          PciIo,
+                          EfiPciIoWidthUint32,
+                          NVME_BAR,
+                          NVME_SQTDBL_OFFSET (QueueId, Private->Cap.Dstrd),
+                          1,
+                          &Data
+                          );
 
-  if (EFI_ERROR (Status)) {
-    goto EXIT;
+    if (EFI_ERROR (Status)) {
+      goto EXIT;
+    }
   }
 
   //
@@ -767,6 +894,7 @@ NvmExpressPassThru (
     AsyncRequest->MapPrpList  = MapPrpList;
     AsyncRequest->PrpListNo   = PrpListNo;
     AsyncRequest->PrpListHost = PrpListHost;
+    AsyncRequest->PrpListSlot = PrpListSlot;
 
     OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
     InsertTailList (&Private->AsyncPassThruQueue, &AsyncRequest->Link);
@@ -916,6 +1044,10 @@ EXIT:
     PciIo->FreeBuffer (PciIo, PrpListNo, PrpListHost);
   }
 
+  if (PrpListSlot != NVME_PRP_LIST_SLOT_NONE) {
+    NvmeFreePrpListSlot (Private, PrpListSlot);
+  }
+
   if (TimerEvent != NULL) {
     gBS->CloseEvent (TimerEvent);
   }
@@ -0,0 +1,309 @@
+/** @file
+  Reverse index of the protocols the waiting dependency expressions push.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DepexWatch.h"
+
+#define DEPEX_WATCH_PROTOCOL_SIGNATURE  SIGNATURE_32('d','w','p','r')
+
+///
+/// Index entry of a protocol pushed by at least one dependency expression.
+/// Entries are never freed, like the protocol database entries.
+///
+typedef struct {
+  UINTN                Signature;
+  HANDLE_INDEX_LINK    IndexLink;
+  EFI_GUID             ProtocolID;
+  ///
+  /// List of DEPEX_WATCH_LINK of the watchers of this protocol.
+  ///
+  LIST_ENTRY           Watchers;
+} DEPEX_WATCH_PROTOCOL;
+
+///
+/// Link between a watcher and the index entry of one protocol it pushes.
+///
+struct _DEPEX_WATCH_LINK {
+  /// Link on DEPEX_WATCH_PROTOCOL.Watchers
+  LIST_ENTRY              ProtocolLink;
+  DEPEX_WATCHER           *Watcher;
+  DEPEX_WATCH_PROTOCOL    *Protocol;
+};
+
+/**
+  Find the index entry of a protocol.
+
+  @param  Index                  The index.
+  @param  Protocol               The GUID of the protocol.
+  @param  Create                 Create a new entry if not found.
+
+  @return The index entry, or NULL if it is not found and it was not created.
+
+**/
+STATIC
+DEPEX_WATCH_PROTOCOL *
+DepexWatchFindProtocol (
+  IN OUT DEPEX_WATCH_INDEX  *Index,
+  IN     CONST EFI_GUID     *Protocol,
+  IN     BOOLEAN            Create
+  )
+{
+  HANDLE_INDEX_LINK     *Link;
+  DEPEX_WATCH_PROTOCOL  *Entry;
+  UINT32                Hash;
+
+  Hash = HandleIndexHashGuid (Protocol);
+  for (Link = HandleIndexFirst (&Index->Protocols, Hash);
+       Link != NULL;
+       Link = HandleIndexNext (Link))
+  {
+    Entry = CR (Link, DEPEX_WATCH_PROTOCOL, IndexLink, DEPEX_WATCH_PROTOCOL_SIGNATURE);
+    if (CompareGuid (&Entry->ProtocolID, Protocol)) {
+      return Entry;
+    }
+  }
+
+  if (!Create) {
+    return NULL;
+  }
+
+  Entry = AllocatePool (sizeof (DEPEX_WATCH_PROTOCOL));
+  if (Entry != NULL) {
+    Entry->Signature = DEPEX_WATCH_PROTOCOL_SIGNATURE;
+    CopyGuid (&Entry->ProtocolID, Protocol);
+    InitializeListHead (&Entry->Watchers);
+    HandleIndexInsert (&Index->Protocols, &Entry->IndexLink, Hash);
+  }
+
+  return Entry;
+}
+
+/**
+  Walk the protocols pushed by a dependency expression.
+
+  Pushes already patched to EFI_DEP_REPLACE_TRUE are skipped. The walk stops
+  at the END opcode, at an unknown opcode, or at the end of the expression.
+
+  @param  Depex                  The dependency expression.
+  @param  DepexSize              The size, in bytes, of Depex.
+  @param  Offset                 On input, the offset to start the walk at. On
+                                 output, the offset of the next opcode.
+  @param  Protocol               The GUID of the protocol pushed.
+
+  @retval TRUE                   A push was found.
+  @retval FALSE                  There is no more push.
+
+**/
+STATIC
+BOOLEAN
+DepexWatchNextPush (
+  IN     CONST UINT8  *Depex,
+  IN     UINTN        DepexSize,
+  IN OUT UINTN        *Offset,
+  OUT    EFI_GUID     *Protocol
+  )
+{
+  while (*Offset < DepexSize) {
+    switch (Depex[*Offset]) {
+      case EFI_DEP_PUSH:
+        if (DepexSize - *Offset - 1 < sizeof (EFI_GUID)) {
+          //
+          // The evaluator stops at the truncated GUID as well.
+          //
+          *Offset = DepexSize;
+          return FALSE;
+        }
+
+        CopyMem (Protocol, &Depex[*Offset + 1], sizeof (EFI_GUID));
+        *Offset += 1 + sizeof (EFI_GUID);
+        return TRUE;
+
+      case EFI_DEP_BEFORE:
+      case EFI_DEP_AFTER:
+      case EFI_DEP_REPLACE_TRUE:
+        *Offset += 1 + sizeof (EFI_GUID);
+        break;
+
+      case EFI_DEP_AND:
+      case EFI_DEP_OR:
+      case EFI_DEP_NOT:
+      case EFI_DEP_TRUE:
+      case EFI_DEP_FALSE:
+      case EFI_DEP_SOR:
+        *Offset += 1;
+        break;
+
+      default:
+        //
+        // EFI_DEP_END, or an unknown opcode the evaluator fails on.
+        //
+        *Offset = DepexSize;
+        return FALSE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Link a watcher to the index entries of the protocols pushed by a dependency
+  expression.
+
+  Pushes already patched to EFI_DEP_REPLACE_TRUE are skipped. The walk stops
+  at the END opcode, at an unknown opcode, or at the end of the expression.
+  The watcher is registered clean: the caller marks it dirty if a protocol
+  was installed since the expression was last evaluated. If memory runs out,
+  the watcher is left unregistered and the caller must keep evaluating the
+  expression each time.
+
+  @param  Index                  The index.
+  @param  Watcher                The watcher of the dependency expression. It
+                                 must not be registered.
+  @param  Depex                  The dependency expression.
+  @param  DepexSize              The size, in bytes, of Depex.
+
+  @retval EFI_SUCCESS            The watcher is registered.
+  @retval EFI_OUT_OF_RESOURCES   There is not enough memory to register the
+                                 watcher.
+
+**/
+EFI_STATUS
+DepexWatchRegister (
+  IN OUT DEPEX_WATCH_INDEX  *Index,
+  IN OUT DEPEX_WATCHER      *Watcher,
+  IN     CONST UINT8        *Depex,
+  IN     UINTN              DepexSize
+  )
+{
+  DEPEX_WATCH_PROTOCOL  *Entry;
+  DEPEX_WATCH_LINK      *WatchLink;
+  UINTN                 Offset;
+  UINTN                 PushCount;
+  UINTN                 Link;
+  EFI_GUID              Protocol;
+
+  ASSERT (!Watcher->Registered);
+
+  Watcher->Links     = NULL;
+  Watcher->LinkCount = 0;
+  Watcher->Dirty     = FALSE;
+
+  //
+  // Allocate the links of all the pushes at once.
+  //
+  PushCount = 0;
+  Offset    = 0;
+  while (DepexWatchNextPush (Depex, DepexSize, &Offset, &Protocol)) {
+    PushCount++;
+  }
+
+  if (PushCount != 0) {
+    Watcher->Links = AllocatePool (PushCount * sizeof (DEPEX_WATCH_LINK));
+    if (Watcher->Links == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  Offset = 0;
+  while (DepexWatchNextPush (Depex, DepexSize, &Offset, &Protocol)) {
+    Entry = DepexWatchFindProtocol (Index, &Protocol, TRUE);
+    if (Entry == NULL) {
+      DepexWatchUnregister (Index, Watcher);
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    //
+    // A dependency expression usually pushes a handful of protocols, so a
+    // linear search is enough to skip the ones pushed twice.
+    //
+    for (Link = 0; Link < Watcher->LinkCount; Link++) {
+      if (Watcher->Links[Link].Protocol == Entry) {
+        break;
+      }
+    }
+
+    if (Link < Watcher->LinkCount) {
+      continue;
+    }
+
+    WatchLink           = &Watcher->Links[Watcher->LinkCount++];
+    WatchLink->Watcher  = Watcher;
+    WatchLink->Protocol = Entry;
+    InsertTailList (&Entry->Watchers, &WatchLink->ProtocolLink);
+    Index->LinkCount++;
+  }
+
+  Watcher->Registered = TRUE;
+  return EFI_SUCCESS;
+}
+
+/**
+  Unlink a watcher from the index. It is a nop if the watcher is not
+  registered.
+
+  @param  Index                  The index.
+  @param  Watcher                The watcher to unregister.
+
+**/
+VOID
+DepexWatchUnregister (
+  IN OUT DEPEX_WATCH_INDEX  *Index,
+  IN OUT DEPEX_WATCHER      *Watcher
+  )
+{
+  UINTN  Link;
+
+  for (Link = 0; Link < Watcher->LinkCount; Link++) {
+    RemoveEntryList (&Watcher->Links[Link].ProtocolLink);
+  }
+
+  Index->LinkCount -= Watcher->LinkCount;
+  if (Watcher->Links != NULL) {
+    FreePool (Watcher->Links);
+  }
+
+  Watcher->Links      = NULL;
+  Watcher->LinkCount  = 0;
+  Watcher->Registered = FALSE;
+}
+
+/**
+  Mark dirty the watchers of a protocol.
+
+  @param  Index                  The index.
+  @param  Protocol               The GUID of the protocol just installed.
+
+  @return The number of watchers of the protocol.
+
+**/
+UINTN
+DepexWatchNotify (
+  IN OUT DEPEX_WATCH_INDEX  *Index,
+  IN     CONST EFI_GUID     *Protocol
+  )
+{
+  DEPEX_WATCH_PROTOCOL  *Entry;
+  DEPEX_WATCH_LINK      *WatchLink;
+  LIST_ENTRY            *Link;
+  UINTN                 Count;
+
+  Index->NotifyCount++;
+
+  Entry = DepexWatchFindProtocol (Index, Protocol, FALSE);
+  if (Entry == NULL) {
+    return 0;
+  }
+
+  Count = 0;
+  for (Link = Entry->Watchers.ForwardLink; Link != &Entry->Watchers; Link = Link->ForwardLink) {
+    WatchLink                 = BASE_CR (Link, DEPEX_WATCH_LINK, ProtocolLink);
+    WatchLink->Watcher->Dirty = TRUE;
+    Count++;
+  }
+
+  return Count;
+}
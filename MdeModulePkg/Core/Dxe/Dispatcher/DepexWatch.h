@@ -0,0 +1,138 @@
+/** @file
+  Reverse index used by the DXE dispatcher to find the drivers whose
+  dependency expression may have changed when a protocol is installed.
+
+  A dependency expression that evaluated to FALSE can only evaluate to TRUE
+  once one of the protocols it pushes, and that was not found installed yet,
+  gets installed: the pushes found installed are patched to
+  EFI_DEP_REPLACE_TRUE and never looked up again. Every waiting driver
+  embeds a DEPEX_WATCHER, which is linked to the index entry of each protocol
+  its dependency expression pushes. Installing a protocol marks the watchers
+  of that protocol dirty, and the dispatcher only evaluates again the
+  dependency expressions of dirty watchers. The discovered driver list stays
+  the authoritative, ordered view of the drivers, so the dispatch order does
+  not change.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _DEPEX_WATCH_H_
+#define _DEPEX_WATCH_H_
+
+#include <PiDxe.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+
+#include "../Hand/HandleIndex.h"
+
+///
+/// EFI_DEP_REPLACE_TRUE - Used to dynamically patch the dependency expression
+///                        to save time.  A EFI_DEP_PUSH is evaluated one an
+///                        replaced with EFI_DEP_REPLACE_TRUE. If PI spec's Vol 2
+///                        Driver Execution Environment Core Interface use 0xff
+///                        as new DEPEX opcode. EFI_DEP_REPLACE_TRUE should be
+///                        defined to a new value that is not conflicting with PI spec.
+///
+#define EFI_DEP_REPLACE_TRUE  0xff
+
+typedef struct _DEPEX_WATCH_LINK DEPEX_WATCH_LINK;
+
+///
+/// Watch state of the dependency expression of one driver. A zero
+/// initialized DEPEX_WATCHER is not registered, and must be evaluated
+/// each time.
+///
+typedef struct {
+  ///
+  /// Array of the links of this watcher, one per protocol pushed.
+  ///
+  DEPEX_WATCH_LINK    *Links;
+  UINTN               LinkCount;
+  BOOLEAN             Registered;
+  ///
+  /// Set when a protocol pushed by the dependency expression is installed.
+  ///
+  volatile BOOLEAN    Dirty;
+} DEPEX_WATCHER;
+
+///
+/// A zero initialized DEPEX_WATCH_INDEX is an empty index.
+///
+typedef struct {
+  HANDLE_INDEX    Protocols;
+  ///
+  /// Number of watcher links in the index.
+  ///
+  UINTN           LinkCount;
+  ///
+  /// Number of protocol installations notified. It tells whether a protocol
+  /// was installed while a dependency expression was evaluated, before its
+  /// watcher was registered.
+  ///
+  UINTN           NotifyCount;
+} DEPEX_WATCH_INDEX;
+
+/**
+  Link a watcher to the index entries of the protocols pushed by a dependency
+  expression.
+
+  Pushes already patched to EFI_DEP_REPLACE_TRUE are skipped. The walk stops
+  at the END opcode, at an unknown opcode, or at the end of the expression.
+  The watcher is registered clean: the caller marks it dirty if a protocol
+  was installed since the expression was last evaluated. If memory runs out,
+  the watcher is left unregistered and the caller must keep evaluating the
+  expression each time.
+
+  @param  Index                  The index.
+  @param  Watcher                The watcher of the dependency expression. It
+                                 must not be registered.
+  @param  Depex                  The dependency expression.
+  @param  DepexSize              The size, in bytes, of Depex.
+
+  @retval EFI_SUCCESS            The watcher is registered.
+  @retval EFI_OUT_OF_RESOURCES   There is not enough memory to register the
+                                 watcher.
+
+**/
+EFI_STATUS
+DepexWatchRegister (
+  IN OUT DEPEX_WATCH_INDEX  *Index,
+  IN OUT DEPEX_WATCHER      *Watcher,
+  IN     CONST UINT8        *Depex,
+  IN     UINTN              DepexSize
+  );
+
+/**
+  Unlink a watcher from the index. It is a nop if the watcher is not
+  registered.
+
+  @param  Index                  The index.
+  @param  Watcher                The watcher to unregister.
+
+**/
+VOID
+DepexWatchUnregister (
+  IN OUT DEPEX_WATCH_INDEX  *Index,
+  IN OUT DEPEX_WATCHER      *Watcher
+  );
+
+/**
+  Mark dirty the watchers of a protocol.
+
+  @param  Index                  The index.
+  @param  Protocol               The GUID of the protocol just installed.
+
+  @return The number of watchers of the protocol.
+
+**/
+UINTN
+DepexWatchNotify (
+  IN OUT DEPEX_WATCH_INDEX  *Index,
+  IN     CONST EFI_GUID     *Protocol
+  );
+
+#endif
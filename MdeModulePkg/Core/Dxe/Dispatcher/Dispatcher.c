@@ -5,8 +5,10 @@
             is added to the mDiscoveredList. The SOR, Before, and After Depex are
             pre-processed as drivers are added to the mDiscoveredList. If an Apriori
             file exists in the FV those drivers are addeded to the
-            mScheduledQueue. The mFvHandleList is used to make sure a
-            FV is only processed once.
+            mScheduledQueue. If a dispatch manifest file exists in the FV, the
+            drivers it lists are then added to the mScheduledQueue in its
+            order without evaluating their Depex. The mFvHandleList is used to
+            make sure a FV is only processed once.
 
   Step #2 - Dispatch. Remove driver from the mScheduledQueue and load and
             start it. After mScheduledQueue is drained check the
@@ -26,7 +28,7 @@
   Depex - Dependency Expresion.
   SOR   - Schedule On Request - Don't schedule if this bit is set.
 
-Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -55,6 +57,14 @@ LIST_ENTRY  mFvHandleList = INITIALIZE_LIST_HEAD_VARIABLE (mFvHandleList);
 //
 EFI_LOCK  mDispatcherLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL);
 
+//
+// Reverse index of the protocols pushed by the dependency expressions of the
+// drivers in the mDiscoveredList that are waiting to be scheduled. It is
+// updated by the protocol services, so it has its own lock.
+//
+DEPEX_WATCH_INDEX  mDepexWatchIndex;
+EFI_LOCK           mDepexWatchLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
+
 //
 // Flag for the DXE Dispacher.  TRUE if dispatcher is execuing.
 //
@@ -115,7 +125,8 @@ CoreInsertOnScheduledQueueWhileProcessingBeforeAndAfter (
   mDiscoveredList is never free'ed and contains variables that define
   the other states the DXE driver transitions to..
   While you are at it read the A Priori file into memory.
-  Place drivers in the A Priori list onto the mScheduledQueue.
+  Place drivers in the A Priori list onto the mScheduledQueue, then the
+  drivers of the dispatch manifest.
 
   @param  Event                 The Event that is being processed, not used.
   @param  Context               Event Context, not used.
@@ -381,6 +392,98 @@ CoreTrust (
   return EFI_NOT_FOUND;
 }
 
+/**
+  Mark for evaluation the dependency expressions of the drivers waiting on
+  a protocol. Called each time a protocol interface is installed.
+
+  @param  Protocol               The GUID of the protocol installed.
+
+**/
+VOID
+CoreNotifyDepexWatchers (
+  IN EFI_GUID  *Protocol
+  )
+{
+  CoreAcquireLock (&mDepexWatchLock);
+  DepexWatchNotify (&mDepexWatchIndex, Protocol);
+  CoreReleaseLock (&mDepexWatchLock);
+}
+
+/**
+  Evaluate the dependency expression of a driver in the Dependent state, unless
+  it cannot have changed since it was last evaluated.
+
+  A dependency expression that evaluated to FALSE cannot evaluate to TRUE
+  before a protocol it pushes is installed, so once it evaluated to FALSE its
+  driver is registered in mDepexWatchIndex, and it is only evaluated again
+  after one of those protocols is installed.
+
+  @param  DriverEntry           The driver in the Dependent state.
+
+  @retval TRUE                  If driver is ready to run.
+  @retval FALSE                 If driver is not ready to run or some fatal error
+                                was found.
+
+**/
+BOOLEAN
+CoreIsSchedulableOnChange (
+  IN  EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  )
+{
+  DEPEX_WATCHER  *Watcher;
+  UINTN          NotifyCount;
+
+  if ((DriverEntry->Depex == NULL) || DriverEntry->Before || DriverEntry->After) {
+    //
+    // A NULL Depex depends on the architectural protocols, and Before and
+    // After are not evaluated, so there is nothing to watch.
+    //
+    return CoreIsSchedulable (DriverEntry);
+  }
+
+  Watcher = &DriverEntry->DepexWatcher;
+
+  CoreAcquireLock (&mDepexWatchLock);
+  if (Watcher->Registered && !Watcher->Dirty) {
+    CoreReleaseLock (&mDepexWatchLock);
+    return FALSE;
+  }
+
+  //
+  // Clear the dirty flag before the evaluation, so that a protocol installed
+  // while the Depex is evaluated triggers another evaluation.
+  //
+  Watcher->Dirty = FALSE;
+  NotifyCount    = mDepexWatchIndex.NotifyCount;
+  CoreReleaseLock (&mDepexWatchLock);
+
+  if (CoreIsSchedulable (DriverEntry)) {
+    CoreAcquireLock (&mDepexWatchLock);
+    DepexWatchUnregister (&mDepexWatchIndex, Watcher);
+    CoreReleaseLock (&mDepexWatchLock);
+    return TRUE;
+  }
+
+  CoreAcquireLock (&mDepexWatchLock);
+  if (!Watcher->Registered) {
+    //
+    // On failure the watcher stays unregistered and the Depex is evaluated
+    // each time, as if it was not watched.
+    //
+    DepexWatchRegister (
+      &mDepexWatchIndex,
+      Watcher,
+      DriverEntry->Depex,
+      DriverEntry->DepexSize
+      );
+    Watcher->Dirty = (BOOLEAN)(NotifyCount != mDepexWatchIndex.NotifyCount);
+  }
+
+  CoreReleaseLock (&mDepexWatchLock);
+
+  return FALSE;
+}
+
 /**
   This is the main Dispatcher for DXE and it exits when there are no more
   drivers to run. Drain the mScheduledQueue and load and start a PE
@@ -444,6 +547,39 @@ CoreDispatcher (
                       EFI_CORE_DRIVER_ENTRY_SIGNATURE
                       );
 
+      //
+      // The dispatch manifest is trusted, and only a driver that fails to load
+      // or start breaks it. DEBUG builds also evaluate the Depex of each
+      // manifest driver to catch a manifest that is stale: the drivers before
+      // this one did not produce the protocols its Depex needs.
+      //
+      DEBUG_CODE_BEGIN ();
+      if ((DriverEntry->ManifestFv != NULL) &&
+          !DriverEntry->ManifestFv->ManifestBroken &&
+          !CoreIsSchedulable (DriverEntry))
+      {
+        DEBUG ((DEBUG_WARN, "Driver %g is in the dispatch manifest with an unsatisfied Depex\n", &DriverEntry->FileName));
+        DriverEntry->ManifestFv->ManifestBroken = TRUE;
+      }
+
+      DEBUG_CODE_END ();
+
+      if ((DriverEntry->ManifestFv != NULL) && DriverEntry->ManifestFv->ManifestBroken) {
+        //
+        // A driver before this one in the dispatch manifest failed, or the
+        // manifest is stale, so the protocols this driver depends on may be
+        // missing. Take it back to the Dependent state so its Depex gets
+        // evaluated.
+        //
+        CoreAcquireDispatcherLock ();
+        DriverEntry->Scheduled  = FALSE;
+        DriverEntry->Dependent  = TRUE;
+        DriverEntry->ManifestFv = NULL;
+        RemoveEntryList (&DriverEntry->ScheduledLink);
+        CoreReleaseDispatcherLock ();
+        continue;
+      }
+
       //
       // Load the DXE Driver image into memory. If the Driver was transitioned from
       // Untrused to Scheduled it would have already been loaded so we may need to
@@ -466,6 +602,10 @@ CoreDispatcher (
         if (EFI_ERROR (Status)) {
           CoreAcquireDispatcherLock ();
 
+          if (DriverEntry->ManifestFv != NULL) {
+            DriverEntry->ManifestFv->ManifestBroken = TRUE;
+          }
+
           if (Status == EFI_SECURITY_VIOLATION) {
             //
             // Take driver from Scheduled to Untrused state
@@ -516,6 +656,13 @@ CoreDispatcher (
         ASSERT (DriverEntry->ImageHandle != NULL);
 
         Status = CoreStartImage (DriverEntry->ImageHandle, NULL, NULL);
+        if (EFI_ERROR (Status) && (DriverEntry->ManifestFv != NULL)) {
+          //
+          // The driver may not have produced the protocols the drivers after
+          // it in the dispatch manifest depend on.
+          //
+          DriverEntry->ManifestFv->ManifestBroken = TRUE;
+        }
 
         REPORT_STATUS_CODE_WITH_EXTENDED_DATA (
           EFI_PROGRESS_CODE,
@@ -552,7 +699,7 @@ CoreDispatcher (
       }
 
       if (DriverEntry->Dependent) {
-        if (CoreIsSchedulable (DriverEntry)) {
+        if (CoreIsSchedulableOnChange (DriverEntry)) {
           CoreInsertOnScheduledQueueWhileProcessingBeforeAndAfter (DriverEntry);
           ReadyToRun = TRUE;
         }
@@ -1177,6 +1324,102 @@ CoreProcessFvImageFile (
   }
 }
 
+/**
+  Place the drivers of the dispatch manifest of a FV onto the mScheduledQueue,
+  in the order of the manifest and without evaluating their Depex.
+
+  The manifest is only valid for the FV it resides in. The drivers are taken
+  in order up to the first one that is not in the Dependent state, or that has
+  a Before or After Depex: the drivers after it may depend on protocols it
+  produces.
+
+  @param  Fv                    Fv protocol of the FV.
+  @param  FvHandle              Handle of the FV.
+  @param  KnownHandle           The mFvHandleList entry of the FV.
+
+**/
+VOID
+CoreScheduleDispatchManifest (
+  IN  EFI_FIRMWARE_VOLUME2_PROTOCOL  *Fv,
+  IN  EFI_HANDLE                     FvHandle,
+  IN  KNOWN_HANDLE                   *KnownHandle
+  )
+{
+  EFI_STATUS               Status;
+  EDKII_DISPATCH_MANIFEST  *Manifest;
+  EFI_GUID                 *FileName;
+  UINTN                    ManifestSize;
+  UINT32                   AuthenticationStatus;
+  UINTN                    Index;
+  LIST_ENTRY               *Link;
+  EFI_CORE_DRIVER_ENTRY    *DriverEntry;
+
+  Manifest = NULL;
+  Status   = Fv->ReadSection (
+                   Fv,
+                   &gEdkiiDxeDispatchManifestFileGuid,
+                   EFI_SECTION_RAW,
+                   0,
+                   (VOID **)&Manifest,
+                   &ManifestSize,
+                   &AuthenticationStatus
+                   );
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  if ((ManifestSize < sizeof (EDKII_DISPATCH_MANIFEST)) ||
+      (Manifest->Signature != EDKII_DISPATCH_MANIFEST_SIGNATURE) ||
+      (Manifest->Version != EDKII_DISPATCH_MANIFEST_VERSION) ||
+      (Manifest->HeaderSize < sizeof (EDKII_DISPATCH_MANIFEST)) ||
+      (Manifest->HeaderSize > ManifestSize) ||
+      ((ManifestSize - Manifest->HeaderSize) / sizeof (EFI_GUID) < Manifest->EntryCount))
+  {
+    DEBUG ((DEBUG_ERROR, "Invalid dispatch manifest in FV %p\n", FvHandle));
+    CoreFreePool (Manifest);
+    return;
+  }
+
+  FileName = (EFI_GUID *)((UINT8 *)Manifest + Manifest->HeaderSize);
+  for (Index = 0; Index < Manifest->EntryCount; Index++) {
+    DriverEntry = NULL;
+    for (Link = mDiscoveredList.ForwardLink; Link != &mDiscoveredList; Link = Link->ForwardLink) {
+      DriverEntry = CR (Link, EFI_CORE_DRIVER_ENTRY, Link, EFI_CORE_DRIVER_ENTRY_SIGNATURE);
+      if (CompareGuid (&DriverEntry->FileName, &FileName[Index]) &&
+          (FvHandle == DriverEntry->FvHandle))
+      {
+        break;
+      }
+    }
+
+    if (Link == &mDiscoveredList) {
+      break;
+    }
+
+    if (DriverEntry->Scheduled || DriverEntry->Initialized) {
+      //
+      // Already placed on the mScheduledQueue by the Apriori file.
+      //
+      continue;
+    }
+
+    if (!DriverEntry->Dependent || DriverEntry->Before || DriverEntry->After) {
+      break;
+    }
+
+    DEBUG ((DEBUG_DISPATCH, "Evaluate DXE DEPEX for FFS(%g)\n", &DriverEntry->FileName));
+    DEBUG ((DEBUG_DISPATCH, "  RESULT = TRUE (Dispatch Manifest)\n"));
+    CoreInsertOnScheduledQueueWhileProcessingBeforeAndAfter (DriverEntry);
+    DriverEntry->ManifestFv = KnownHandle;
+  }
+
+  if (Index < Manifest->EntryCount) {
+    DEBUG ((DEBUG_INFO, "Dispatch manifest of FV %p stopped at %g\n", FvHandle, &FileName[Index]));
+  }
+
+  CoreFreePool (Manifest);
+}
+
 /**
   Event notification that is fired every time a FV dispatch protocol is added.
   More than one protocol may have been added when this event is fired, so you
@@ -1188,7 +1431,8 @@ CoreProcessFvImageFile (
   mDiscoveredList is never free'ed and contains variables that define
   the other states the DXE driver transitions to..
   While you are at it read the A Priori file into memory.
-  Place drivers in the A Priori list onto the mScheduledQueue.
+  Place drivers in the A Priori list onto the mScheduledQueue, then the
+  drivers of the dispatch manifest.
 
   @param  Event                 The Event that is being processed, not used.
   @param  Context               Event Context, not used.
@@ -1432,6 +1676,8 @@ CoreFwVolEventProtocolNotify (
     // Free data allocated by Fv->ReadSection ()
     //
     CoreFreePool (AprioriFile);
+
+    CoreScheduleDispatchManifest (Fv, FvHandle, KnownHandle);
   }
 }
 
@@ -2,7 +2,7 @@
   The internal header file includes the common header files, defines
   internal structure and functions used by DxeCore module.
 
-Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -52,6 +52,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/DebugImageInfoTable.h>
 #include <Guid/FileInfo.h>
 #include <Guid/Apriori.h>
+#include <Guid/DispatchManifest.h>
 #include <Guid/DxeServices.h>
 #include <Guid/MemoryAllocationHob.h>
 #include <Guid/EventLegacyBios.h>
@@ -85,6 +86,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/DebugAgentLib.h>
 #include <Library/CpuExceptionHandlerLib.h>
 
+#include "Mem/RangeTree.h"
+#include "Dispatcher/DepexWatch.h"
+
 //
 // attributes for reserved memory before it is promoted to system memory
 //
@@ -97,16 +101,6 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 #define EFI_MEMORY_PORT_IO  0x4000000000000000ULL
 
-///
-/// EFI_DEP_REPLACE_TRUE - Used to dynamically patch the dependency expression
-///                        to save time.  A EFI_DEP_PUSH is evaluated one an
-///                        replaced with EFI_DEP_REPLACE_TRUE. If PI spec's Vol 2
-///                        Driver Execution Environment Core Interface use 0xff
-///                        as new DEPEX opcode. EFI_DEP_REPLACE_TRUE should be
-///                        defined to a new value that is not conflicting with PI spec.
-///
-#define EFI_DEP_REPLACE_TRUE  0xff
-
 ///
 /// Define the initial size of the dependency expression evaluation stack
 ///
@@ -130,6 +124,7 @@ typedef struct {
   LIST_ENTRY    Link;           // mFvHandleList
   EFI_HANDLE    Handle;
   EFI_GUID      FvNameGuid;
+  BOOLEAN       ManifestBroken; // A driver of the dispatch manifest failed
 } KNOWN_HANDLE;
 
 #define EFI_CORE_DRIVER_ENTRY_SIGNATURE  SIGNATURE_32('d','r','v','r')
@@ -160,6 +155,9 @@ typedef struct {
 
   EFI_HANDLE                       ImageHandle;
   BOOLEAN                          IsFvImage;
+
+  DEPEX_WATCHER                    DepexWatcher;    // mDepexWatchIndex
+  KNOWN_HANDLE                     *ManifestFv;     // Scheduled from the dispatch manifest of this FV
 } EFI_CORE_DRIVER_ENTRY;
 
 //
@@ -177,6 +175,7 @@ typedef struct {
   EFI_GCD_IO_TYPE         GcdIoType;
   EFI_HANDLE              ImageHandle;
   EFI_HANDLE              DeviceHandle;
+  RANGE_TREE_NODE         TreeNode;       // mGcdMemorySpaceTree or mGcdIoSpaceTree
 } EFI_GCD_MAP_ENTRY;
 
 #define LOADED_IMAGE_PRIVATE_DATA_SIGNATURE  SIGNATURE_32('l','d','r','i')
@@ -462,6 +461,18 @@ CoreInitializeDispatcher (
   VOID
   );
 
+/**
+  Mark for evaluation the dependency expressions of the drivers waiting on
+  a protocol. Called each time a protocol interface is installed.
+
+  @param  Protocol               The GUID of the protocol installed.
+
+**/
+VOID
+CoreNotifyDepexWatchers (
+  IN EFI_GUID  *Protocol
+  );
+
 /**
   This is the POSTFIX version of the dependency evaluator.  This code does
   not need to handle Before or After, as it is not valid to call this
@@ -1,7 +1,7 @@
 /** @file
   DXE Core Main Entry Point
 
-Copyright (c) 2006 - 2022, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -788,6 +788,11 @@ CoreExitBootServices (
 
   gMemoryMapTerminated = TRUE;
 
+  //
+  // Report the timer statistics once, now that the timer is stopped for good
+  //
+  CoreDumpTimerStatistics ();
+
   //
   // Notify other drivers that we are exiting boot services.
   //
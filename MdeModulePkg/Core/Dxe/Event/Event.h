@@ -1,7 +1,7 @@
 /** @file
   UEFI Event support functions and structure.
 
-Copyright (c) 2006 - 2010, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 (C) Copyright 2015 Hewlett Packard Enterprise Development LP<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -10,6 +10,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #ifndef __EVENT_H__
 #define __EVENT_H__
 
+#include "TimerQueue.h"
+
 #define VALID_TPL(a)  ((a) <= TPL_HIGH_LEVEL)
 extern  UINTN  gEventPending;
 
@@ -30,11 +32,23 @@ extern  UINTN  gEventPending;
 /// Timer event information
 ///
 typedef struct {
-  LIST_ENTRY    Link;
-  UINT64        TriggerTime;
-  UINT64        Period;
+  TIMER_QUEUE_NODE    Node;
+  UINT64              TriggerTime;
+  UINT64              Period;
 } TIMER_EVENT_INFO;
 
+///
+/// Timer service statistics
+///
+typedef struct {
+  UINT64    Ticks;              ///< Number of CoreTimerTick() calls
+  UINT64    Checks;             ///< Number of CoreCheckTimers() runs
+  UINT64    Expired;            ///< Number of timers that expired
+  UINTN     MaxQueued;          ///< Largest number of armed timers
+  UINTN     MaxExpiredPerCheck; ///< Largest number of timers expired by one check
+  UINT64    MaxLinksPerCheck;   ///< Largest timer queue cost of one check
+} TIMER_STATISTICS;
+
 #define EVENT_SIGNATURE  SIGNATURE_32('e','v','n','t')
 typedef struct {
   UINTN                      Signature;
@@ -85,4 +99,13 @@ CoreInitializeTimer (
   VOID
   );
 
+/**
+  Reports the timer service statistics with DEBUG_VERBOSE.
+
+**/
+VOID
+CoreDumpTimerStatistics (
+  VOID
+  );
+
 #endif
@@ -1,7 +1,7 @@
 /** @file
   Core Timer Services
 
-Copyright (c) 2006 - 2013, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -13,13 +13,15 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 // Internal data
 //
 
-LIST_ENTRY  mEfiTimerList       = INITIALIZE_LIST_HEAD_VARIABLE (mEfiTimerList);
-EFI_LOCK    mEfiTimerLock       = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL - 1);
-EFI_EVENT   mEfiCheckTimerEvent = NULL;
+TIMER_QUEUE  mEfiTimerQueue;
+EFI_LOCK     mEfiTimerLock       = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL - 1);
+EFI_EVENT    mEfiCheckTimerEvent = NULL;
 
 EFI_LOCK  mEfiSystemTimeLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL);
 UINT64    mEfiSystemTime     = 0;
 
+TIMER_STATISTICS  mEfiTimerStatistics;
+
 //
 // Timer functions
 //
@@ -36,29 +38,17 @@ CoreInsertEventTimer (
   IN IEVENT  *Event
   )
 {
-  UINT64      TriggerTime;
-  LIST_ENTRY  *Link;
-  IEVENT      *Event2;
-
   ASSERT_LOCKED (&mEfiTimerLock);
 
   //
-  // Get the timer's trigger time
-  //
-  TriggerTime = Event->Timer.TriggerTime;
-
-  //
-  // Insert the timer into the timer database in assending sorted order
+  // Insert the timer into the timer database, which keeps timers with the
+  // same trigger time in insertion order
   //
-  for (Link = mEfiTimerList.ForwardLink; Link != &mEfiTimerList; Link = Link->ForwardLink) {
-    Event2 = CR (Link, IEVENT, Timer.Link, EVENT_SIGNATURE);
+  TimerQueueInsert (&mEfiTimerQueue, &Event->Timer.Node, Event->Timer.TriggerTime);
 
-    if (Event2->Timer.TriggerTime > TriggerTime) {
-      break;
-    }
+  if (mEfiTimerQueue.Count > mEfiTimerStatistics.MaxQueued) {
+    mEfiTimerStatistics.MaxQueued = mEfiTimerQueue.Count;
   }
-
-  InsertTailList (Link, &Event->Timer.Link);
 }
 
 /**
@@ -82,7 +72,7 @@ CoreCurrentSystemTime (
 }
 
 /**
-  Checks the sorted timer list against the current system time.
+  Checks the timer database against the current system time.
   Signals any expired event timer.
 
   @param  CheckEvent             Not used
@@ -96,17 +86,22 @@ CoreCheckTimers (
   IN VOID       *Context
   )
 {
-  UINT64  SystemTime;
-  IEVENT  *Event;
+  UINT64            SystemTime;
+  UINT64            Links;
+  UINTN             Expired;
+  TIMER_QUEUE_NODE  *Node;
+  IEVENT            *Event;
 
   //
   // Check the timer database for expired timers
   //
   CoreAcquireLock (&mEfiTimerLock);
   SystemTime = CoreCurrentSystemTime ();
+  Links      = mEfiTimerQueue.Links;
+  Expired    = 0;
 
-  while (!IsListEmpty (&mEfiTimerList)) {
-    Event = CR (mEfiTimerList.ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
+  for (Node = TimerQueueFirst (&mEfiTimerQueue); Node != NULL; Node = TimerQueueFirst (&mEfiTimerQueue)) {
+    Event = CR (Node, IEVENT, Timer.Node, EVENT_SIGNATURE);
 
     //
     // If this timer is not expired, then we're done
@@ -118,9 +113,8 @@ CoreCheckTimers (
     //
     // Remove this timer from the timer queue
     //
-
-    RemoveEntryList (&Event->Timer.Link);
-    Event->Timer.Link.ForwardLink = NULL;
+    TimerQueueRemove (&mEfiTimerQueue, &Event->Timer.Node);
+    Expired++;
 
     //
     // Signal it
@@ -151,6 +145,20 @@ CoreCheckTimers (
     }
   }
 
+  //
+  // Account the work done by this check
+  //
+  mEfiTimerStatistics.Checks++;
+  mEfiTimerStatistics.Expired += Expired;
+  if (Expired > mEfiTimerStatistics.MaxExpiredPerCheck) {
+    mEfiTimerStatistics.MaxExpiredPerCheck = Expired;
+  }
+
+  Links = mEfiTimerQueue.Links - Links;
+  if (Links > mEfiTimerStatistics.MaxLinksPerCheck) {
+    mEfiTimerStatistics.MaxLinksPerCheck = Links;
+  }
+
   CoreReleaseLock (&mEfiTimerLock);
 }
 
@@ -176,6 +184,28 @@ CoreInitializeTimer (
   ASSERT_EFI_ERROR (Status);
 }
 
+/**
+  Reports the timer service statistics with DEBUG_VERBOSE.
+
+**/
+VOID
+CoreDumpTimerStatistics (
+  VOID
+  )
+{
+  DEBUG ((
+    DEBUG_VERBOSE,
+    "Timers: %lu ticks, %lu checks, %lu expired, %lu armed (max %lu), max %lu expired and %lu queue links per check\n",
+    mEfiTimerStatistics.Ticks,
+    mEfiTimerStatistics.Checks,
+    mEfiTimerStatistics.Expired,
+    (UINT64)mEfiTimerQueue.Count,
+    (UINT64)mEfiTimerStatistics.MaxQueued,
+    (UINT64)mEfiTimerStatistics.MaxExpiredPerCheck,
+    mEfiTimerStatistics.MaxLinksPerCheck
+    ));
+}
+
 /**
   Called by the platform code to process a tick.
 
@@ -189,7 +219,7 @@ CoreTimerTick (
   IN UINT64  Duration
   )
 {
-  IEVENT  *Event;
+  TIMER_QUEUE_NODE  *Node;
 
   //
   // Check runtiem flag in case there are ticks while exiting boot services
@@ -200,17 +230,15 @@ CoreTimerTick (
   // Update the system time
   //
   mEfiSystemTime += Duration;
+  mEfiTimerStatistics.Ticks++;
 
   //
-  // If the head of the list is expired, fire the timer event
+  // If the first timer of the queue is expired, fire the timer event
   // to process it
   //
-  if (!IsListEmpty (&mEfiTimerList)) {
-    Event = CR (mEfiTimerList.ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
-
-    if (Event->Timer.TriggerTime <= mEfiSystemTime) {
-      CoreSignalEvent (mEfiCheckTimerEvent);
-    }
+  Node = TimerQueueFirst (&mEfiTimerQueue);
+  if ((Node != NULL) && (Node->TriggerTime <= mEfiSystemTime)) {
+    CoreSignalEvent (mEfiCheckTimerEvent);
   }
 
   CoreReleaseLock (&mEfiSystemTimeLock);
@@ -260,9 +288,8 @@ CoreSetTimer (
   //
   // If the timer is queued to the timer database, remove it
   //
-  if (Event->Timer.Link.ForwardLink != NULL) {
-    RemoveEntryList (&Event->Timer.Link);
-    Event->Timer.Link.ForwardLink = NULL;
+  if (Event->Timer.Node.Queued) {
+    TimerQueueRemove (&mEfiTimerQueue, &Event->Timer.Node);
   }
 
   Event->Timer.TriggerTime = 0;
@@ -0,0 +1,214 @@
+/** @file
+  Priority queue of the armed timer events, ordered by trigger time.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TimerQueue.h"
+
+/**
+  Link two heaps. The root that expires later becomes the first child of the
+  other root.
+
+  @param  Queue                  The queue the heaps belong to.
+  @param  First                  The root of the first heap.
+  @param  Second                 The root of the second heap.
+
+  @return The root of the linked heap.
+
+**/
+STATIC
+TIMER_QUEUE_NODE *
+TimerQueueLink (
+  IN OUT TIMER_QUEUE       *Queue,
+  IN OUT TIMER_QUEUE_NODE  *First,
+  IN OUT TIMER_QUEUE_NODE  *Second
+  )
+{
+  TIMER_QUEUE_NODE  *Swap;
+
+  Queue->Links++;
+  if ((Second->TriggerTime < First->TriggerTime) ||
+      ((Second->TriggerTime == First->TriggerTime) && (Second->Sequence < First->Sequence)))
+  {
+    Swap   = First;
+    First  = Second;
+    Second = Swap;
+  }
+
+  Second->Prev = First;
+  Second->Next = First->Child;
+  if (First->Child != NULL) {
+    First->Child->Prev = Second;
+  }
+
+  First->Child = Second;
+  return First;
+}
+
+/**
+  Link a list of sibling heaps into a single heap, in two passes: link the
+  siblings by pairs from the first one, then link the pairs from the last
+  one.
+
+  @param  Queue                  The queue the heaps belong to.
+  @param  First                  The first sibling, or NULL.
+
+  @return The root of the linked heap, or NULL if there was no sibling.
+
+**/
+STATIC
+TIMER_QUEUE_NODE *
+TimerQueueLinkSiblings (
+  IN OUT TIMER_QUEUE       *Queue,
+  IN     TIMER_QUEUE_NODE  *First
+  )
+{
+  TIMER_QUEUE_NODE  *Pairs;
+  TIMER_QUEUE_NODE  *Node;
+  TIMER_QUEUE_NODE  *Pair;
+  TIMER_QUEUE_NODE  *Root;
+
+  //
+  // Link the siblings by pairs and stack the results through their Next
+  // field, so the second pass visits them from the last one.
+  //
+  Pairs = NULL;
+  while (First != NULL) {
+    Node = First;
+    Pair = Node->Next;
+    if (Pair == NULL) {
+      First = NULL;
+    } else {
+      First      = Pair->Next;
+      Pair->Prev = NULL;
+      Pair->Next = NULL;
+    }
+
+    Node->Prev = NULL;
+    Node->Next = NULL;
+    if (Pair != NULL) {
+      Node = TimerQueueLink (Queue, Node, Pair);
+    }
+
+    Node->Next = Pairs;
+    Pairs      = Node;
+  }
+
+  if (Pairs == NULL) {
+    return NULL;
+  }
+
+  Root       = Pairs;
+  Pairs      = Pairs->Next;
+  Root->Next = NULL;
+  while (Pairs != NULL) {
+    Node       = Pairs;
+    Pairs      = Pairs->Next;
+    Node->Next = NULL;
+    Root       = TimerQueueLink (Queue, Root, Node);
+  }
+
+  return Root;
+}
+
+/**
+  Insert a node into a queue.
+
+  @param  Queue                  The queue to insert into.
+  @param  Node                   The node embedded in the timer event. It must
+                                 not be queued.
+  @param  TriggerTime            The time the timer expires at.
+
+**/
+VOID
+TimerQueueInsert (
+  IN OUT TIMER_QUEUE       *Queue,
+  IN OUT TIMER_QUEUE_NODE  *Node,
+  IN     UINT64            TriggerTime
+  )
+{
+  ASSERT (!Node->Queued);
+
+  Node->Child       = NULL;
+  Node->Next        = NULL;
+  Node->Prev        = NULL;
+  Node->TriggerTime = TriggerTime;
+  Node->Sequence    = Queue->Sequence++;
+  Node->Queued      = TRUE;
+
+  if (Queue->Root == NULL) {
+    Queue->Root = Node;
+  } else {
+    Queue->Root = TimerQueueLink (Queue, Queue->Root, Node);
+  }
+
+  Queue->Count++;
+}
+
+/**
+  Remove a node from a queue.
+
+  @param  Queue                  The queue to remove from.
+  @param  Node                   The node previously inserted into Queue.
+
+**/
+VOID
+TimerQueueRemove (
+  IN OUT TIMER_QUEUE       *Queue,
+  IN OUT TIMER_QUEUE_NODE  *Node
+  )
+{
+  TIMER_QUEUE_NODE  *Subtree;
+
+  ASSERT (Node->Queued);
+  ASSERT (Queue->Count > 0);
+
+  if (Node == Queue->Root) {
+    Queue->Root = TimerQueueLinkSiblings (Queue, Node->Child);
+  } else {
+    //
+    // Detach the subtree of the node from its parent or previous sibling,
+    // then link the children of the node back to the root.
+    //
+    if (Node->Prev->Child == Node) {
+      Node->Prev->Child = Node->Next;
+    } else {
+      Node->Prev->Next = Node->Next;
+    }
+
+    if (Node->Next != NULL) {
+      Node->Next->Prev = Node->Prev;
+    }
+
+    Subtree = TimerQueueLinkSiblings (Queue, Node->Child);
+    if (Subtree != NULL) {
+      Queue->Root = TimerQueueLink (Queue, Queue->Root, Subtree);
+    }
+  }
+
+  Node->Child  = NULL;
+  Node->Next   = NULL;
+  Node->Prev   = NULL;
+  Node->Queued = FALSE;
+  Queue->Count--;
+}
+
+/**
+  Get the node with the lowest trigger time in a queue. Of the nodes with the
+  same trigger time, the one inserted first is returned.
+
+  @param  Queue                  The queue.
+
+  @return The node, or NULL if the queue is empty.
+
+**/
+TIMER_QUEUE_NODE *
+TimerQueueFirst (
+  IN CONST TIMER_QUEUE  *Queue
+  )
+{
+  return Queue->Root;
+}
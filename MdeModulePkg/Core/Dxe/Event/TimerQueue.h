@@ -0,0 +1,96 @@
+/** @file
+  Priority queue used by the DXE core to order the armed timer events by
+  trigger time.
+
+  The queue is an intrusive pairing heap: every timer event embeds a
+  TIMER_QUEUE_NODE. Arming a timer takes constant time, the next timer to
+  expire is read in constant time, and removing the next timer or cancelling
+  any armed timer takes logarithmic amortized time. Timers with the same
+  trigger time leave the queue in the order they were armed. The queue never
+  allocates memory, so it can be updated at TPL_HIGH_LEVEL - 1.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _TIMER_QUEUE_H_
+#define _TIMER_QUEUE_H_
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+
+typedef struct _TIMER_QUEUE_NODE TIMER_QUEUE_NODE;
+
+struct _TIMER_QUEUE_NODE {
+  ///
+  /// First child, next sibling, and previous sibling or parent of the first
+  /// child, in the heap.
+  ///
+  TIMER_QUEUE_NODE    *Child;
+  TIMER_QUEUE_NODE    *Next;
+  TIMER_QUEUE_NODE    *Prev;
+  UINT64              TriggerTime;
+  UINT64              Sequence;
+  BOOLEAN             Queued;
+};
+
+///
+/// A zero initialized TIMER_QUEUE is an empty queue.
+///
+typedef struct {
+  TIMER_QUEUE_NODE    *Root;
+  UINTN               Count;
+  UINT64              Sequence;
+  ///
+  /// Number of node comparisons done by the queue since it was created,
+  /// which measures the cost of the queue operations.
+  ///
+  UINT64              Links;
+} TIMER_QUEUE;
+
+/**
+  Insert a node into a queue.
+
+  @param  Queue                  The queue to insert into.
+  @param  Node                   The node embedded in the timer event. It must
+                                 not be queued.
+  @param  TriggerTime            The time the timer expires at.
+
+**/
+VOID
+TimerQueueInsert (
+  IN OUT TIMER_QUEUE       *Queue,
+  IN OUT TIMER_QUEUE_NODE  *Node,
+  IN     UINT64            TriggerTime
+  );
+
+/**
+  Remove a node from a queue.
+
+  @param  Queue                  The queue to remove from.
+  @param  Node                   The node previously inserted into Queue.
+
+**/
+VOID
+TimerQueueRemove (
+  IN OUT TIMER_QUEUE       *Queue,
+  IN OUT TIMER_QUEUE_NODE  *Node
+  );
+
+/**
+  Get the node with the lowest trigger time in a queue. Of the nodes with the
+  same trigger time, the one inserted first is returned.
+
+  @param  Queue                  The queue.
+
+  @return The node, or NULL if the queue is empty.
+
+**/
+TIMER_QUEUE_NODE *
+TimerQueueFirst (
+  IN CONST TIMER_QUEUE  *Queue
+  );
+
+#endif
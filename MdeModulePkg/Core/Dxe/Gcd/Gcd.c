@@ -3,7 +3,7 @@
   The GCD services are used to manage the memory and I/O regions that
   are accessible to the CPU that is executing the DXE core.
 
-Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -45,6 +45,13 @@ EFI_LOCK    mGcdIoSpaceLock     = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
 LIST_ENTRY  mGcdMemorySpaceMap  = INITIALIZE_LIST_HEAD_VARIABLE (mGcdMemorySpaceMap);
 LIST_ENTRY  mGcdIoSpaceMap      = INITIALIZE_LIST_HEAD_VARIABLE (mGcdIoSpaceMap);
 
+//
+// Indexes of the entries of the GCD maps by base address. The lists above
+// stay the authoritative view of the maps.
+//
+RANGE_TREE  mGcdMemorySpaceTree;
+RANGE_TREE  mGcdIoSpaceTree;
+
 EFI_GCD_MAP_ENTRY  mGcdMemorySpaceMapEntryTemplate = {
   EFI_GCD_MAP_SIGNATURE,
   {
@@ -413,6 +420,27 @@ CoreAllocateGcdMapEntry (
   return EFI_SUCCESS;
 }
 
+/**
+  Get the index of a GCD map.
+
+  @param  Map                    The GCD memory space map or the GCD I/O space map.
+
+  @return The index of the entries of Map.
+
+**/
+RANGE_TREE *
+CoreGetGcdMapTree (
+  IN LIST_ENTRY  *Map
+  )
+{
+  if (Map == &mGcdMemorySpaceMap) {
+    return &mGcdMemorySpaceTree;
+  }
+
+  ASSERT (Map == &mGcdIoSpaceMap);
+  return &mGcdIoSpaceTree;
+}
+
 /**
   Internal function.  Inserts a new descriptor into a sorted list
 
@@ -423,6 +451,7 @@ CoreAllocateGcdMapEntry (
   @param  Length                 The length of the new range in bytes
   @param  TopEntry               Top pad entry to insert if needed.
   @param  BottomEntry            Bottom pad entry to insert if needed.
+  @param  Map                    The GCD map that Entry belongs to.
 
   @retval EFI_SUCCESS            The new range was inserted into the linked list
 
@@ -434,11 +463,16 @@ CoreInsertGcdMapEntry (
   IN EFI_PHYSICAL_ADDRESS  BaseAddress,
   IN UINT64                Length,
   IN EFI_GCD_MAP_ENTRY     *TopEntry,
-  IN EFI_GCD_MAP_ENTRY     *BottomEntry
+  IN EFI_GCD_MAP_ENTRY     *BottomEntry,
+  IN LIST_ENTRY            *Map
   )
 {
+  RANGE_TREE  *Tree;
+
   ASSERT (Length != 0);
 
+  Tree = CoreGetGcdMapTree (Map);
+
   if (BaseAddress > Entry->BaseAddress) {
     ASSERT (BottomEntry->Signature == 0);
 
@@ -446,6 +480,8 @@ CoreInsertGcdMapEntry (
     Entry->BaseAddress      = BaseAddress;
     BottomEntry->EndAddress = BaseAddress - 1;
     InsertTailList (Link, &BottomEntry->Link);
+    RangeTreeUpdate (&Entry->TreeNode, Entry->BaseAddress, 0);
+    RangeTreeInsert (Tree, &BottomEntry->TreeNode, BottomEntry->BaseAddress, 0);
   }
 
   if ((BaseAddress + Length - 1) < Entry->EndAddress) {
@@ -455,6 +491,7 @@ CoreInsertGcdMapEntry (
     TopEntry->BaseAddress = BaseAddress + Length;
     Entry->EndAddress     = BaseAddress + Length - 1;
     InsertHeadList (Link, &TopEntry->Link);
+    RangeTreeInsert (Tree, &TopEntry->TreeNode, TopEntry->BaseAddress, 0);
   }
 
   return EFI_SUCCESS;
@@ -526,10 +563,12 @@ CoreMergeGcdMapEntry (
     return EFI_UNSUPPORTED;
   }
 
+  RangeTreeRemove (CoreGetGcdMapTree (Map), &AdjacentEntry->TreeNode);
   if (Forward) {
     Entry->EndAddress = AdjacentEntry->EndAddress;
   } else {
     Entry->BaseAddress = AdjacentEntry->BaseAddress;
+    RangeTreeUpdate (&Entry->TreeNode, Entry->BaseAddress, 0);
   }
 
   RemoveEntryList (AdjacentLink);
@@ -604,34 +643,47 @@ CoreSearchGcdMapEntry (
   IN  LIST_ENTRY            *Map
   )
 {
-  LIST_ENTRY         *Link;
-  EFI_GCD_MAP_ENTRY  *Entry;
+  RANGE_TREE         *Tree;
+  RANGE_TREE_NODE    *Node;
+  EFI_GCD_MAP_ENTRY  *StartEntry;
+  EFI_GCD_MAP_ENTRY  *EndEntry;
 
   ASSERT (Length != 0);
 
   *StartLink = NULL;
   *EndLink   = NULL;
 
-  Link = Map->ForwardLink;
-  while (Link != Map) {
-    Entry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
-    if ((BaseAddress >= Entry->BaseAddress) && (BaseAddress <= Entry->EndAddress)) {
-      *StartLink = Link;
-    }
+  Tree = CoreGetGcdMapTree (Map);
 
-    if (*StartLink != NULL) {
-      if (((BaseAddress + Length - 1) >= Entry->BaseAddress) &&
-          ((BaseAddress + Length - 1) <= Entry->EndAddress))
-      {
-        *EndLink = Link;
-        return EFI_SUCCESS;
-      }
-    }
+  //
+  // Find the entry that contains the first byte of the segment
+  //
+  Node = RangeTreeFindFloor (Tree, BaseAddress);
+  if (Node == NULL) {
+    return EFI_NOT_FOUND;
+  }
 
-    Link = Link->ForwardLink;
+  StartEntry = BASE_CR (Node, EFI_GCD_MAP_ENTRY, TreeNode);
+  if (BaseAddress > StartEntry->EndAddress) {
+    return EFI_NOT_FOUND;
   }
 
-  return EFI_NOT_FOUND;
+  //
+  // Find the entry that contains the last byte of the segment, which must not
+  // come before the first one
+  //
+  Node = RangeTreeFindFloor (Tree, BaseAddress + Length - 1);
+  ASSERT (Node != NULL);
+  EndEntry = BASE_CR (Node, EFI_GCD_MAP_ENTRY, TreeNode);
+  if ((EndEntry->BaseAddress < StartEntry->BaseAddress) ||
+      ((BaseAddress + Length - 1) > EndEntry->EndAddress))
+  {
+    return EFI_NOT_FOUND;
+  }
+
+  *StartLink = &StartEntry->Link;
+  *EndLink   = &EndEntry->Link;
+  return EFI_SUCCESS;
 }
 
 /**
@@ -934,7 +986,7 @@ CoreConvertSpace (
   Link = StartLink;
   while (Link != EndLink->ForwardLink) {
     Entry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
-    CoreInsertGcdMapEntry (Link, Entry, BaseAddress, Length, TopEntry, BottomEntry);
+    CoreInsertGcdMapEntry (Link, Entry, BaseAddress, Length, TopEntry, BottomEntry, Map);
     switch (Operation) {
       //
       // Add operations
@@ -1322,7 +1374,7 @@ CoreAllocateSpace (
   Link = StartLink;
   while (Link != EndLink->ForwardLink) {
     Entry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
-    CoreInsertGcdMapEntry (Link, Entry, *BaseAddress, Length, TopEntry, BottomEntry);
+    CoreInsertGcdMapEntry (Link, Entry, *BaseAddress, Length, TopEntry, BottomEntry, Map);
     Entry->ImageHandle  = ImageHandle;
     Entry->DeviceHandle = DeviceHandle;
     Link                = Link->ForwardLink;
@@ -2547,6 +2599,7 @@ CoreInitializeGcdServices (
   Entry->EndAddress = LShiftU64 (1, SizeOfMemorySpace) - 1;
 
   InsertHeadList (&mGcdMemorySpaceMap, &Entry->Link);
+  RangeTreeInsert (&mGcdMemorySpaceTree, &Entry->TreeNode, Entry->BaseAddress, 0);
 
   CoreDumpGcdMemorySpaceMap (TRUE);
 
@@ -2559,6 +2612,7 @@ CoreInitializeGcdServices (
   Entry->EndAddress = LShiftU64 (1, SizeOfIoSpace) - 1;
 
   InsertHeadList (&mGcdIoSpaceMap, &Entry->Link);
+  RangeTreeInsert (&mGcdIoSpaceTree, &Entry->TreeNode, Entry->BaseAddress, 0);
 
   CoreDumpGcdIoSpaceMap (TRUE);
 
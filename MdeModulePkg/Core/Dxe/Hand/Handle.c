@@ -1,7 +1,7 @@
 /** @file
   UEFI handle & protocol handling.
 
-Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -14,11 +14,15 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 // gHandleList           - A list of all the handles in the system
 // gProtocolDatabaseLock - Lock to protect the mProtocolDatabase
 // gHandleDatabaseKey    -  The Key to show that the handle has been created/modified
+// mProtocolIndex        - Index of mProtocolDatabase by protocol GUID
+// mHandleIndex          - Index of gHandleList by handle value
 //
-LIST_ENTRY  mProtocolDatabase     = INITIALIZE_LIST_HEAD_VARIABLE (mProtocolDatabase);
-LIST_ENTRY  gHandleList           = INITIALIZE_LIST_HEAD_VARIABLE (gHandleList);
-EFI_LOCK    gProtocolDatabaseLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
-UINT64      gHandleDatabaseKey    = 0;
+LIST_ENTRY    mProtocolDatabase     = INITIALIZE_LIST_HEAD_VARIABLE (mProtocolDatabase);
+LIST_ENTRY    gHandleList           = INITIALIZE_LIST_HEAD_VARIABLE (gHandleList);
+EFI_LOCK      gProtocolDatabaseLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
+UINT64        gHandleDatabaseKey    = 0;
+HANDLE_INDEX  mProtocolIndex;
+HANDLE_INDEX  mHandleIndex;
 
 /**
   Acquire lock on gProtocolDatabaseLock.
@@ -59,8 +63,8 @@ CoreValidateHandle (
   IN  EFI_HANDLE  UserHandle
   )
 {
-  IHANDLE     *Handle;
-  LIST_ENTRY  *Link;
+  IHANDLE            *Handle;
+  HANDLE_INDEX_LINK  *Link;
 
   if (UserHandle == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -68,8 +72,15 @@ CoreValidateHandle (
 
   ASSERT_LOCKED (&gProtocolDatabaseLock);
 
-  for (Link = gHandleList.BackLink; Link != &gHandleList; Link = Link->BackLink) {
-    Handle = CR (Link, IHANDLE, AllHandles, EFI_HANDLE_SIGNATURE);
+  //
+  // Only compare pointer values, UserHandle must not be dereferenced before
+  // it is known to be a handle in the database.
+  //
+  for (Link = HandleIndexFirst (&mHandleIndex, HandleIndexHashPointer (UserHandle));
+       Link != NULL;
+       Link = HandleIndexNext (Link))
+  {
+    Handle = CR (Link, IHANDLE, IndexLink, EFI_HANDLE_SIGNATURE);
     if (Handle == (IHANDLE *)UserHandle) {
       return EFI_SUCCESS;
     }
@@ -94,22 +105,24 @@ CoreFindProtocolEntry (
   IN BOOLEAN   Create
   )
 {
-  LIST_ENTRY      *Link;
-  PROTOCOL_ENTRY  *Item;
-  PROTOCOL_ENTRY  *ProtEntry;
+  HANDLE_INDEX_LINK  *Link;
+  PROTOCOL_ENTRY     *Item;
+  PROTOCOL_ENTRY     *ProtEntry;
+  UINT32             Hash;
 
   ASSERT_LOCKED (&gProtocolDatabaseLock);
 
   //
-  // Search the database for the matching GUID
+  // Search the database index for the matching GUID
   //
 
   ProtEntry = NULL;
-  for (Link = mProtocolDatabase.ForwardLink;
-       Link != &mProtocolDatabase;
-       Link = Link->ForwardLink)
+  Hash      = HandleIndexHashGuid (Protocol);
+  for (Link = HandleIndexFirst (&mProtocolIndex, Hash);
+       Link != NULL;
+       Link = HandleIndexNext (Link))
   {
-    Item = CR (Link, PROTOCOL_ENTRY, AllEntries, PROTOCOL_ENTRY_SIGNATURE);
+    Item = CR (Link, PROTOCOL_ENTRY, IndexLink, PROTOCOL_ENTRY_SIGNATURE);
     if (CompareGuid (&Item->ProtocolID, Protocol)) {
       //
       // This is the protocol entry
@@ -140,6 +153,7 @@ CoreFindProtocolEntry (
       // Add it to protocol database
       //
       InsertTailList (&mProtocolDatabase, &ProtEntry->AllEntries);
+      HandleIndexInsert (&mProtocolIndex, &ProtEntry->IndexLink, Hash);
     }
   }
 
@@ -409,6 +423,7 @@ CoreInstallProtocolInterfaceNotify (
     // in the system
     //
     InsertTailList (&gHandleList, &Handle->AllHandles);
+    HandleIndexInsert (&mHandleIndex, &Handle->IndexLink, HandleIndexHashPointer (Handle));
   } else {
     Status = CoreValidateHandle (Handle);
     if (EFI_ERROR (Status)) {
@@ -448,6 +463,11 @@ CoreInstallProtocolInterfaceNotify (
   //
   InsertTailList (&ProtEntry->Protocols, &Prot->ByProtocol);
 
+  //
+  // Let the dispatcher evaluate again the drivers waiting on this protocol
+  //
+  CoreNotifyDepexWatchers (Protocol);
+
   //
   // Notify the notification list for this protocol
   //
@@ -771,6 +791,7 @@ CoreUninstallProtocolInterface (
   if (IsListEmpty (&Handle->Protocols)) {
     Handle->Signature = 0;
     RemoveEntryList (&Handle->AllHandles);
+    HandleIndexRemove (&mHandleIndex, &Handle->IndexLink);
     CoreFreePool (Handle);
   }
 
@@ -9,20 +9,24 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #ifndef  _HAND_H_
 #define  _HAND_H_
 
+#include "HandleIndex.h"
+
 #define EFI_HANDLE_SIGNATURE  SIGNATURE_32('h','n','d','l')
 
 ///
 /// IHANDLE - contains a list of protocol handles
 ///
 typedef struct {
-  UINTN         Signature;
+  UINTN                Signature;
   /// All handles list of IHANDLE
-  LIST_ENTRY    AllHandles;
+  LIST_ENTRY           AllHandles;
+  /// Link in the handle index, hashed by the handle value
+  HANDLE_INDEX_LINK    IndexLink;
   /// List of PROTOCOL_INTERFACE's for this handle
-  LIST_ENTRY    Protocols;
-  UINTN         LocateRequest;
+  LIST_ENTRY           Protocols;
+  UINTN                LocateRequest;
   /// The Handle Database Key value when this handle was last created or modified
-  UINT64        Key;
+  UINT64               Key;
 } IHANDLE;
 
 #define ASSERT_IS_HANDLE(a)  ASSERT((a)->Signature == EFI_HANDLE_SIGNATURE)
@@ -35,15 +39,17 @@ typedef struct {
 /// with a list of registered notifies.
 ///
 typedef struct {
-  UINTN         Signature;
+  UINTN                Signature;
   /// Link Entry inserted to mProtocolDatabase
-  LIST_ENTRY    AllEntries;
+  LIST_ENTRY           AllEntries;
+  /// Link in the protocol index, hashed by ProtocolID
+  HANDLE_INDEX_LINK    IndexLink;
   /// ID of the protocol
-  EFI_GUID      ProtocolID;
+  EFI_GUID             ProtocolID;
   /// All protocol interfaces
-  LIST_ENTRY    Protocols;
+  LIST_ENTRY           Protocols;
   /// Registerd notification handlers
-  LIST_ENTRY    Notify;
+  LIST_ENTRY           Notify;
 } PROTOCOL_ENTRY;
 
 #define PROTOCOL_INTERFACE_SIGNATURE  SIGNATURE_32('p','i','f','c')
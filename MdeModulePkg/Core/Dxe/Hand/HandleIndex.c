@@ -0,0 +1,253 @@
+/** @file
+  Hash index used by the DXE core to look up handles and protocol entries.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "HandleIndex.h"
+
+//
+// Multiplier of the Fibonacci hashing. The bucket of a link is selected by
+// the upper bits of its hash, which are the best mixed ones.
+//
+#define HANDLE_INDEX_HASH_MULTIPLIER  0x9E3779B1
+
+/**
+  Get the bucket of a hash value.
+
+  @param  Index                  The index.
+  @param  Hash                   The hash value.
+
+  @return The bucket index.
+
+**/
+STATIC
+UINTN
+HandleIndexBucket (
+  IN CONST HANDLE_INDEX  *Index,
+  IN UINT32              Hash
+  )
+{
+  return (UINTN)(Hash >> (32 - Index->BucketBits));
+}
+
+/**
+  Compute the index hash of a pointer value. The pointer is not dereferenced.
+
+  @param  Pointer                The pointer to hash.
+
+  @return The hash value.
+
+**/
+UINT32
+HandleIndexHashPointer (
+  IN CONST VOID  *Pointer
+  )
+{
+  UINT64  Value;
+
+  //
+  // Pool allocations are at least 8 byte aligned, so drop the low bits.
+  //
+  Value = RShiftU64 ((UINT64)(UINTN)Pointer, 3);
+  return ((UINT32)Value ^ (UINT32)RShiftU64 (Value, 32)) * HANDLE_INDEX_HASH_MULTIPLIER;
+}
+
+/**
+  Compute the index hash of a GUID.
+
+  @param  Guid                   The GUID to hash.
+
+  @return The hash value.
+
+**/
+UINT32
+HandleIndexHashGuid (
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  CONST UINT32  *Data;
+  UINT32        Value;
+
+  Data  = (CONST UINT32 *)Guid;
+  Value = Data[0];
+  Value = (Value * HANDLE_INDEX_HASH_MULTIPLIER) ^ Data[1];
+  Value = (Value * HANDLE_INDEX_HASH_MULTIPLIER) ^ Data[2];
+  Value = (Value * HANDLE_INDEX_HASH_MULTIPLIER) ^ Data[3];
+  return Value * HANDLE_INDEX_HASH_MULTIPLIER;
+}
+
+/**
+  Move all links of an index into a bucket array four times as large.
+
+  @param  Index                  The index to grow.
+
+**/
+STATIC
+VOID
+HandleIndexGrow (
+  IN OUT HANDLE_INDEX  *Index
+  )
+{
+  HANDLE_INDEX_LINK  **OldBuckets;
+  HANDLE_INDEX_LINK  *Link;
+  UINTN              OldCount;
+  UINTN              BucketIndex;
+  UINTN              Bucket;
+
+  OldBuckets = Index->Buckets;
+  OldCount   = (UINTN)1 << Index->BucketBits;
+
+  Index->Buckets = AllocateZeroPool (sizeof (HANDLE_INDEX_LINK *) << (Index->BucketBits + 2));
+  if (Index->Buckets == NULL) {
+    Index->Buckets = OldBuckets;
+    return;
+  }
+
+  Index->BucketBits += 2;
+  for (BucketIndex = 0; BucketIndex < OldCount; BucketIndex++) {
+    while (OldBuckets[BucketIndex] != NULL) {
+      Link                    = OldBuckets[BucketIndex];
+      OldBuckets[BucketIndex] = Link->Next;
+      Bucket                  = HandleIndexBucket (Index, Link->Hash);
+      Link->Next              = Index->Buckets[Bucket];
+      Index->Buckets[Bucket]  = Link;
+    }
+  }
+
+  if (OldBuckets != Index->InitialBuckets) {
+    FreePool (OldBuckets);
+  }
+}
+
+/**
+  Insert a link into an index.
+
+  The bucket array grows when the index gets crowded. If the memory for a
+  larger bucket array cannot be allocated the index keeps working with longer
+  chains.
+
+  @param  Index                  The index to insert into.
+  @param  Link                   The link embedded in the indexed object.
+  @param  Hash                   The hash of the object key.
+
+**/
+VOID
+HandleIndexInsert (
+  IN OUT HANDLE_INDEX       *Index,
+  IN OUT HANDLE_INDEX_LINK  *Link,
+  IN     UINT32             Hash
+  )
+{
+  UINTN  Bucket;
+
+  if (Index->Buckets == NULL) {
+    Index->Buckets    = Index->InitialBuckets;
+    Index->BucketBits = HANDLE_INDEX_INITIAL_BUCKET_BITS;
+  }
+
+  //
+  // Keep the average chain length at or below two.
+  //
+  if ((Index->Count >= ((UINTN)2 << Index->BucketBits)) &&
+      (Index->BucketBits + 2 <= HANDLE_INDEX_MAX_BUCKET_BITS))
+  {
+    HandleIndexGrow (Index);
+  }
+
+  Link->Hash             = Hash;
+  Bucket                 = HandleIndexBucket (Index, Hash);
+  Link->Next             = Index->Buckets[Bucket];
+  Index->Buckets[Bucket] = Link;
+  Index->Count++;
+}
+
+/**
+  Remove a link from an index.
+
+  @param  Index                  The index to remove from.
+  @param  Link                   The link previously inserted into Index.
+
+**/
+VOID
+HandleIndexRemove (
+  IN OUT HANDLE_INDEX       *Index,
+  IN OUT HANDLE_INDEX_LINK  *Link
+  )
+{
+  HANDLE_INDEX_LINK  **Previous;
+
+  ASSERT (Index->Buckets != NULL);
+
+  for (Previous = &Index->Buckets[HandleIndexBucket (Index, Link->Hash)];
+       *Previous != NULL;
+       Previous = &(*Previous)->Next)
+  {
+    if (*Previous == Link) {
+      *Previous  = Link->Next;
+      Link->Next = NULL;
+      Index->Count--;
+      return;
+    }
+  }
+
+  ASSERT (FALSE);
+}
+
+/**
+  Get the first link of an index with the specified hash.
+
+  @param  Index                  The index to search.
+  @param  Hash                   The hash of the key to look up.
+
+  @return The first link with the hash, or NULL if there is none.
+
+**/
+HANDLE_INDEX_LINK *
+HandleIndexFirst (
+  IN CONST HANDLE_INDEX  *Index,
+  IN UINT32              Hash
+  )
+{
+  HANDLE_INDEX_LINK  *Link;
+
+  if (Index->Buckets == NULL) {
+    return NULL;
+  }
+
+  for (Link = Index->Buckets[HandleIndexBucket (Index, Hash)]; Link != NULL; Link = Link->Next) {
+    if (Link->Hash == Hash) {
+      return Link;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Get the next link with the same hash as Link.
+
+  @param  Link                   A link returned by HandleIndexFirst() or
+                                 HandleIndexNext().
+
+  @return The next link with the same hash, or NULL if there is none.
+
+**/
+HANDLE_INDEX_LINK *
+HandleIndexNext (
+  IN CONST HANDLE_INDEX_LINK  *Link
+  )
+{
+  UINT32  Hash;
+
+  Hash = Link->Hash;
+  for (Link = Link->Next; Link != NULL; Link = Link->Next) {
+    if (Link->Hash == Hash) {
+      return (HANDLE_INDEX_LINK *)Link;
+    }
+  }
+
+  return NULL;
+}
@@ -0,0 +1,135 @@
+/** @file
+  Hash index used by the DXE core to look up handles and protocol entries
+  without walking the global handle list and protocol database.
+
+  The index is intrusive: every indexed object embeds a HANDLE_INDEX_LINK,
+  which records the hash of the object key. A lookup returns the links whose
+  hash matches, and the caller compares the actual key, so the index never
+  dereferences a key supplied by the caller. The lists the index accelerates
+  stay the authoritative, ordered view of the database.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _HANDLE_INDEX_H_
+#define _HANDLE_INDEX_H_
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+
+//
+// log2 of the bucket count of an index before its first growth, and the
+// largest bucket count an index grows to.
+//
+#define HANDLE_INDEX_INITIAL_BUCKET_BITS  6
+#define HANDLE_INDEX_MAX_BUCKET_BITS      16
+
+typedef struct _HANDLE_INDEX_LINK HANDLE_INDEX_LINK;
+
+struct _HANDLE_INDEX_LINK {
+  HANDLE_INDEX_LINK    *Next;
+  UINT32               Hash;
+};
+
+///
+/// A zero initialized HANDLE_INDEX is an empty index.
+///
+typedef struct {
+  HANDLE_INDEX_LINK    **Buckets;
+  UINTN                BucketBits;
+  UINTN                Count;
+  HANDLE_INDEX_LINK    *InitialBuckets[1 << HANDLE_INDEX_INITIAL_BUCKET_BITS];
+} HANDLE_INDEX;
+
+/**
+  Compute the index hash of a pointer value. The pointer is not dereferenced.
+
+  @param  Pointer                The pointer to hash.
+
+  @return The hash value.
+
+**/
+UINT32
+HandleIndexHashPointer (
+  IN CONST VOID  *Pointer
+  );
+
+/**
+  Compute the index hash of a GUID.
+
+  @param  Guid                   The GUID to hash.
+
+  @return The hash value.
+
+**/
+UINT32
+HandleIndexHashGuid (
+  IN CONST EFI_GUID  *Guid
+  );
+
+/**
+  Insert a link into an index.
+
+  The bucket array grows when the index gets crowded. If the memory for a
+  larger bucket array cannot be allocated the index keeps working with longer
+  chains.
+
+  @param  Index                  The index to insert into.
+  @param  Link                   The link embedded in the indexed object.
+  @param  Hash                   The hash of the object key.
+
+**/
+VOID
+HandleIndexInsert (
+  IN OUT HANDLE_INDEX       *Index,
+  IN OUT HANDLE_INDEX_LINK  *Link,
+  IN     UINT32             Hash
+  );
+
+/**
+  Remove a link from an index.
+
+  @param  Index                  The index to remove from.
+  @param  Link                   The link previously inserted into Index.
+
+**/
+VOID
+HandleIndexRemove (
+  IN OUT HANDLE_INDEX       *Index,
+  IN OUT HANDLE_INDEX_LINK  *Link
+  );
+
+/**
+  Get the first link of an index with the specified hash.
+
+  @param  Index                  The index to search.
+  @param  Hash                   The hash of the key to look up.
+
+  @return The first link with the hash, or NULL if there is none.
+
+**/
+HANDLE_INDEX_LINK *
+HandleIndexFirst (
+  IN CONST HANDLE_INDEX  *Index,
+  IN UINT32              Hash
+  );
+
+/**
+  Get the next link with the same hash as Link.
+
+  @param  Link                   A link returned by HandleIndexFirst() or
+                                 HandleIndexNext().
+
+  @return The next link with the same hash, or NULL if there is none.
+
+**/
+HANDLE_INDEX_LINK *
+HandleIndexNext (
+  IN CONST HANDLE_INDEX_LINK  *Link
+  );
+
+#endif
@@ -1,7 +1,7 @@
 /** @file
   Data structure and functions to allocate and free memory space.
 
-Copyright (c) 2006 - 2017, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -41,6 +41,8 @@ typedef struct {
 
   UINT64             VirtualStart;
   UINT64             Attribute;
+
+  RANGE_TREE_NODE    TreeNode;        // mMemoryMapTree
 } MEMORY_MAP;
 
 //
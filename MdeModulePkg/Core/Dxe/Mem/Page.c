@@ -1,7 +1,7 @@
 /** @file
   UEFI Memory page management functions.
 
-Copyright (c) 2007 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2007 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -45,6 +45,12 @@ UINTN       mFreeMapStack = 0;
 ///
 LIST_ENTRY  mFreeMemoryMapEntryList           = INITIALIZE_LIST_HEAD_VARIABLE (mFreeMemoryMapEntryList);
 BOOLEAN     mMemoryTypeInformationInitialized = FALSE;
+///
+/// Index of the entries of gMemoryMap by start address, which also tracks the
+/// largest free range below any address. gMemoryMap stays the authoritative
+/// list of the entries.
+///
+RANGE_TREE  mMemoryMapTree;
 
 EFI_MEMORY_TYPE_STATISTICS  mMemoryTypeStatistics[EfiMaxMemoryType + 1] = {
   { 0, MAX_ALLOC_ADDRESS, 0, 0, EfiMaxMemoryType, TRUE,  FALSE },  // EfiReservedMemoryType
@@ -119,6 +125,94 @@ CoreReleaseMemoryLock (
   CoreReleaseLock (&gMemoryLock);
 }
 
+/**
+  Internal function.  Returns the number of free bytes that a descriptor entry
+  contributes to the memory map index.
+
+  @param  Entry                  The entry
+
+  @return The size of the entry if it is EfiConventionalMemory, or 0
+
+**/
+STATIC
+UINT64
+MemoryMapEntryFreeSize (
+  IN CONST MEMORY_MAP  *Entry
+  )
+{
+  if (Entry->Type != EfiConventionalMemory) {
+    return 0;
+  }
+
+  return Entry->End - Entry->Start + 1;
+}
+
+/**
+  Internal function.  Finds the descriptor entry that covers an address.
+
+  @param  Address                The address to look up
+
+  @return The entry, or NULL if no entry covers Address
+
+**/
+STATIC
+MEMORY_MAP *
+FindMemoryMapEntry (
+  IN UINT64  Address
+  )
+{
+  RANGE_TREE_NODE  *Node;
+  MEMORY_MAP       *Entry;
+
+  Node = RangeTreeFindFloor (&mMemoryMapTree, Address);
+  if (Node == NULL) {
+    return NULL;
+  }
+
+  Entry = BASE_CR (Node, MEMORY_MAP, TreeNode);
+  if (Entry->End <= Address) {
+    return NULL;
+  }
+
+  return Entry;
+}
+
+/**
+  Internal function.  Finds the descriptor entry with the highest start address
+  not above Address, if it has the type and the attributes of a new range and
+  so may be merged with it.
+
+  @param  Type                   The type of the new range
+  @param  Attribute              The attributes of the new range
+  @param  Address                Start - 1 or End + 1 of the new range
+
+  @return The entry, or NULL if there is none
+
+**/
+STATIC
+MEMORY_MAP *
+FindAdjoiningMemoryMapEntry (
+  IN EFI_MEMORY_TYPE  Type,
+  IN UINT64           Attribute,
+  IN UINT64           Address
+  )
+{
+  RANGE_TREE_NODE  *Node;
+  MEMORY_MAP       *Entry;
+
+  Node = RangeTreeFindFloor (&mMemoryMapTree, Address);
+  if (Node == NULL) {
+    return NULL;
+  }
+
+  Entry = BASE_CR (Node, MEMORY_MAP, TreeNode);
+  if ((Entry->Type != Type) || (Entry->Attribute != Attribute)) {
+    return NULL;
+  }
+
+  return Entry;
+}
+
 /**
   Internal function.  Removes a descriptor entry.
 
@@ -130,6 +224,7 @@ RemoveMemoryMapEntry (
   IN OUT MEMORY_MAP  *Entry
   )
 {
+  RangeTreeRemove (&mMemoryMapTree, &Entry->TreeNode);
   RemoveEntryList (&Entry->Link);
   Entry->Link.ForwardLink = NULL;
 
@@ -161,7 +256,6 @@ CoreAddRange (
   IN UINT64                Attribute
   )
 {
-  LIST_ENTRY  *Link;
   MEMORY_MAP  *Entry;
 
   ASSERT ((Start & EFI_PAGE_MASK) == 0);
@@ -210,26 +304,24 @@ CoreAddRange (
   // and the same Attribute
   //
 
-  Link = gMemoryMap.ForwardLink;
-  while (Link != &gMemoryMap) {
-    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-    Link  = Link->ForwardLink;
-
-    if (Entry->Type != Type) {
-      continue;
+  while (Start != 0) {
+    Entry = FindAdjoiningMemoryMapEntry (Type, Attribute, Start - 1);
+    if ((Entry == NULL) || (Entry->End + 1 != Start)) {
+      break;
     }
 
-    if (Entry->Attribute != Attribute) {
-      continue;
-    }
+    Start = Entry->Start;
+    RemoveMemoryMapEntry (Entry);
+  }
 
-    if (Entry->End + 1 == Start) {
-      Start = Entry->Start;
-      RemoveMemoryMapEntry (Entry);
-    } else if (Entry->Start == End + 1) {
-      End = Entry->End;
-      RemoveMemoryMapEntry (Entry);
+  while (End != MAX_UINT64) {
+    Entry = FindAdjoiningMemoryMapEntry (Type, Attribute, End + 1);
+    if ((Entry == NULL) || (Entry->Start != End + 1)) {
+      break;
     }
+
+    End = Entry->End;
+    RemoveMemoryMapEntry (Entry);
   }
 
   //
@@ -244,6 +336,12 @@ CoreAddRange (
   mMapStack[mMapDepth].VirtualStart = 0;
   mMapStack[mMapDepth].Attribute    = Attribute;
   InsertTailList (&gMemoryMap, &mMapStack[mMapDepth].Link);
+  RangeTreeInsert (
+    &mMemoryMapTree,
+    &mMapStack[mMapDepth].TreeNode,
+    Start,
+    MemoryMapEntryFreeSize (&mMapStack[mMapDepth])
+    );
 
   mMapDepth += 1;
   ASSERT (mMapDepth < MAX_MAP_DEPTH);
@@ -315,9 +413,10 @@ CoreFreeMemoryMapStack (
   VOID
   )
 {
-  MEMORY_MAP  *Entry;
-  MEMORY_MAP  *Entry2;
-  LIST_ENTRY  *Link2;
+  MEMORY_MAP       *Entry;
+  MEMORY_MAP       *Entry2;
+  LIST_ENTRY       *Link2;
+  RANGE_TREE_NODE  *Node;
 
   ASSERT_LOCKED (&gMemoryLock);
 
@@ -355,13 +454,17 @@ CoreFreeMemoryMapStack (
 
       CopyMem (Entry, &mMapStack[mMapDepth], sizeof (MEMORY_MAP));
       Entry->FromPages = TRUE;
+      RangeTreeReplace (&mMemoryMapTree, &mMapStack[mMapDepth].TreeNode, &Entry->TreeNode);
 
       //
-      // Find insertion location
+      // Find insertion location: in front of the next entry by address that
+      // is in general memory, which keeps those entries sorted in the list
       //
-      for (Link2 = gMemoryMap.ForwardLink; Link2 != &gMemoryMap; Link2 = Link2->ForwardLink) {
-        Entry2 = CR (Link2, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-        if (Entry2->FromPages && (Entry2->Start > Entry->Start)) {
+      Link2 = &gMemoryMap;
+      for (Node = RangeTreeNext (&Entry->TreeNode); Node != NULL; Node = RangeTreeNext (Node)) {
+        Entry2 = BASE_CR (Node, MEMORY_MAP, TreeNode);
+        if (Entry2->FromPages) {
+          Link2 = &Entry2->Link;
           break;
         }
       }
@@ -741,7 +844,6 @@ CoreConvertPagesEx (
   UINT64           RangeEnd;
   UINT64           Attribute;
   EFI_MEMORY_TYPE  MemType;
-  LIST_ENTRY       *Link;
   MEMORY_MAP       *Entry;
 
   Entry         = NULL;
@@ -766,15 +868,8 @@ CoreConvertPagesEx (
     //
     // Find the entry that the covers the range
     //
-    for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-      Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-
-      if ((Entry->Start <= Start) && (Entry->End > Start)) {
-        break;
-      }
-    }
-
-    if (Link == &gMemoryMap) {
+    Entry = FindMemoryMapEntry (Start);
+    if (Entry == NULL) {
       DEBUG ((DEBUG_ERROR | DEBUG_PAGE, "ConvertPages: failed to find range %lx - %lx\n", Start, End));
       return EFI_NOT_FOUND;
     }
@@ -860,11 +955,13 @@ CoreConvertPagesEx (
       // Clip start
       //
       Entry->Start = RangeEnd + 1;
+      RangeTreeUpdate (&Entry->TreeNode, Entry->Start, MemoryMapEntryFreeSize (Entry));
     } else if (Entry->End == RangeEnd) {
       //
       // Clip end
       //
       Entry->End = Start - 1;
+      RangeTreeUpdate (&Entry->TreeNode, Entry->Start, MemoryMapEntryFreeSize (Entry));
     } else {
       //
       // Pull it out of the center, clip current
@@ -886,9 +983,11 @@ CoreConvertPagesEx (
 
       Entry->End = Start - 1;
       ASSERT (Entry->Start < Entry->End);
+      RangeTreeUpdate (&Entry->TreeNode, Entry->Start, MemoryMapEntryFreeSize (Entry));
 
       Entry = &mMapStack[mMapDepth];
       InsertTailList (&gMemoryMap, &Entry->Link);
+      RangeTreeInsert (&mMemoryMapTree, &Entry->TreeNode, Entry->Start, MemoryMapEntryFreeSize (Entry));
 
       mMapDepth += 1;
       ASSERT (mMapDepth < MAX_MAP_DEPTH);
@@ -1035,13 +1134,13 @@ CoreFindFreePagesI (
   IN BOOLEAN          NeedGuard
   )
 {
-  UINT64      NumberOfBytes;
-  UINT64      Target;
-  UINT64      DescStart;
-  UINT64      DescEnd;
-  UINT64      DescNumberOfBytes;
-  LIST_ENTRY  *Link;
-  MEMORY_MAP  *Entry;
+  UINT64           NumberOfBytes;
+  UINT64           Target;
+  UINT64           DescStart;
+  UINT64           DescEnd;
+  UINT64           DescNumberOfBytes;
+  MEMORY_MAP       *Entry;
+  RANGE_TREE_NODE  *Node;
 
   if ((MaxAddress < EFI_PAGE_MASK) || (NumberOfPages == 0)) {
     return 0;
@@ -1071,24 +1170,26 @@ CoreFindFreePagesI (
   NumberOfBytes = LShiftU64 (NumberOfPages, EFI_PAGE_SHIFT);
   Target        = 0;
 
-  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-
-    //
-    // If it's not a free entry, don't bother with it
-    //
-    if (Entry->Type != EfiConventionalMemory) {
-      continue;
-    }
+  //
+  // Visit the free entries that start below MaxAddress and are large enough
+  // from the highest address down. The first one that satisfies the request
+  // holds the highest possible target, because entries do not overlap.
+  //
+  for (Node = RangeTreeFindFreeBelow (&mMemoryMapTree, MaxAddress - 1, NumberOfBytes);
+       (Node != NULL) && (Target == 0);
+       Node = (DescStart == 0) ? NULL : RangeTreeFindFreeBelow (&mMemoryMapTree, DescStart - 1, NumberOfBytes))
+  {
+    Entry = BASE_CR (Node, MEMORY_MAP, TreeNode);
+    ASSERT (Entry->Type == EfiConventionalMemory);
 
     DescStart = Entry->Start;
     DescEnd   = Entry->End;
 
     //
-    // If desc is past max allowed address or below min allowed address, skip it
+    // If desc is below min allowed address, so are all the remaining ones
     //
-    if ((DescStart >= MaxAddress) || (DescEnd < MinAddress)) {
-      continue;
+    if (DescEnd < MinAddress) {
+      break;
     }
 
     //
@@ -1119,23 +1220,18 @@ CoreFindFreePagesI (
         continue;
       }
 
-      //
-      // If this is the best match so far remember it
-      //
-      if (DescEnd > Target) {
-        if (NeedGuard) {
-          DescEnd = AdjustMemoryS (
-                      DescEnd + 1 - DescNumberOfBytes,
-                      DescNumberOfBytes,
-                      NumberOfBytes
-                      );
-          if (DescEnd == 0) {
-            continue;
-          }
+      if (NeedGuard) {
+        DescEnd = AdjustMemoryS (
+                    DescEnd + 1 - DescNumberOfBytes,
+                    DescNumberOfBytes,
+                    NumberOfBytes
+                    );
+        if (DescEnd == 0) {
+          continue;
         }
-
-        Target = DescEnd;
       }
+
+      Target = DescEnd;
     }
   }
 
@@ -1529,7 +1625,6 @@ CoreInternalFreePages (
   )
 {
   EFI_STATUS  Status;
-  LIST_ENTRY  *Link;
   MEMORY_MAP  *Entry;
   UINTN       Alignment;
   BOOLEAN     IsGuarded;
@@ -1543,15 +1638,8 @@ CoreInternalFreePages (
   // Find the entry that the covers the range
   //
   IsGuarded = FALSE;
-  Entry     = NULL;
-  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-    if ((Entry->Start <= Memory) && (Entry->End > Memory)) {
-      break;
-    }
-  }
-
-  if (Link == &gMemoryMap) {
+  Entry     = FindMemoryMapEntry (Memory);
+  if (Entry == NULL) {
     Status = EFI_NOT_FOUND;
     goto Done;
   }
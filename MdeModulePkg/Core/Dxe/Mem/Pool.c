@@ -9,6 +9,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "DxeMain.h"
 #include "Imem.h"
 #include "HeapGuard.h"
+#include "PoolSlab.h"
 
 STATIC EFI_LOCK  mPoolMemoryLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
 
@@ -31,6 +32,11 @@ typedef struct {
 
 #define SIZE_OF_POOL_HEAD  OFFSET_OF(POOL_HEAD,Data)
 
+//
+// Stored in POOL_HEAD.Reserved of the pool entries served from a slab cache
+//
+#define POOL_SLAB_MARKER  SIGNATURE_32('p','s','l','0')
+
 #define POOL_TAIL_SIGNATURE  SIGNATURE_32('p','t','a','l')
 typedef struct {
   UINT32    Signature;
@@ -82,6 +88,28 @@ POOL  mPoolHead[EfiMaxMemoryType];
 //
 LIST_ENTRY  mPoolHeadList = INITIALIZE_LIST_HEAD_VARIABLE (mPoolHeadList);
 
+//
+// Slab caches for small pool allocations of each memory type, used when
+// PcdDxePoolSlabAllocator is TRUE.
+//
+STATIC POOL_SLAB_CACHE  mPoolSlabCache[EfiMaxMemoryType];
+
+STATIC
+VOID *
+CoreAllocatePoolSlabPages (
+  IN EFI_MEMORY_TYPE  PoolType,
+  IN UINTN            NoPages,
+  IN UINTN            Granularity
+  );
+
+STATIC
+VOID
+CoreFreePoolSlabPages (
+  IN EFI_MEMORY_TYPE  PoolType,
+  IN VOID             *Buffer,
+  IN UINTN            NoPages
+  );
+
 /**
   Get pool size table index from the specified size.
 
@@ -118,6 +146,7 @@ CoreInitializePool (
 {
   UINTN  Type;
   UINTN  Index;
+  UINTN  Granularity;
 
   for (Type = 0; Type < EfiMaxMemoryType; Type++) {
     mPoolHead[Type].Signature  = 0;
@@ -126,6 +155,27 @@ CoreInitializePool (
     for (Index = 0; Index < MAX_POOL_LIST; Index++) {
       InitializeListHead (&mPoolHead[Type].FreeList[Index]);
     }
+
+    if (PcdGetBool (PcdDxePoolSlabAllocator)) {
+      if ((Type == EfiACPIReclaimMemory) ||
+          (Type == EfiACPIMemoryNVS) ||
+          (Type == EfiRuntimeServicesCode) ||
+          (Type == EfiRuntimeServicesData))
+      {
+        Granularity = RUNTIME_PAGE_ALLOCATION_GRANULARITY;
+      } else {
+        Granularity = DEFAULT_PAGE_ALLOCATION_GRANULARITY;
+      }
+
+      PoolSlabInitialize (
+        &mPoolSlabCache[Type],
+        (EFI_MEMORY_TYPE)Type,
+        Granularity,
+        PcdGet8 (PcdDxePoolSlabRefillCount),
+        CoreAllocatePoolSlabPages,
+        CoreFreePoolSlabPages
+        );
+    }
   }
 }
 
@@ -336,6 +386,27 @@ CoreAllocatePoolPagesI (
   return Buffer;
 }
 
+/**
+  Internal function.  Used by the slab caches to allocate pages for new slabs.
+
+  @param  PoolType               The type of memory for the new slab pages
+  @param  NoPages                No of pages to allocate
+  @param  Granularity            Bits to align.
+
+  @return The allocated memory, or NULL
+
+**/
+STATIC
+VOID *
+CoreAllocatePoolSlabPages (
+  IN EFI_MEMORY_TYPE  PoolType,
+  IN UINTN            NoPages,
+  IN UINTN            Granularity
+  )
+{
+  return CoreAllocatePoolPagesI (PoolType, NoPages, Granularity, FALSE);
+}
+
 /**
   Internal function to allocate pool of a particular type.
   Caller must have the memory lock held
@@ -365,8 +436,10 @@ CoreAllocatePoolI (
   UINTN      Offset, MaxOffset;
   UINTN      NoPages;
   UINTN      Granularity;
+  UINTN      SlabClass;
   BOOLEAN    HasPoolTail;
   BOOLEAN    PageAsPool;
+  BOOLEAN    IsSlab;
 
   ASSERT_LOCKED (&mPoolMemoryLock);
 
@@ -402,7 +475,24 @@ CoreAllocatePoolI (
     return NULL;
   }
 
-  Head = NULL;
+  Head   = NULL;
+  IsSlab = FALSE;
+
+  //
+  // Small allocations of the standard memory types are served from the slab
+  // cache of the memory type when it is enabled: the size class is found in
+  // constant time and freed objects are reused without any list search.
+  //
+  if (PcdGetBool (PcdDxePoolSlabAllocator) && !NeedGuard && !PageAsPool &&
+      ((UINT32)PoolType < EfiMaxMemoryType))
+  {
+    SlabClass = PoolSlabSizeToClass (Size);
+    if (SlabClass < POOL_SLAB_CLASS_COUNT) {
+      Head   = PoolSlabAllocate (&mPoolSlabCache[PoolType], SlabClass);
+      IsSlab = TRUE;
+      goto Done;
+    }
+  }
 
   //
   // If allocation is over max size, just allocate pages for the request
@@ -506,6 +596,7 @@ Done:
     // If we have a pool buffer, fill in the header & tail info
     //
     Head->Signature = (PageAsPool) ? POOLPAGE_HEAD_SIGNATURE : POOL_HEAD_SIGNATURE;
+    Head->Reserved  = (IsSlab) ? POOL_SLAB_MARKER : 0;
     Head->Size      = Size;
     Head->Type      = (EFI_MEMORY_TYPE)PoolType;
     Buffer          = Head->Data;
@@ -665,6 +756,26 @@ CoreFreePoolPagesWithGuard (
   }
 }
 
+/**
+  Internal function.  Used by the slab caches to free the pages of an empty
+  slab.
+
+  @param  PoolType               The type of memory for the slab pages
+  @param  Buffer                 The base address to free
+  @param  NoPages                The number of pages to free
+
+**/
+STATIC
+VOID
+CoreFreePoolSlabPages (
+  IN EFI_MEMORY_TYPE  PoolType,
+  IN VOID             *Buffer,
+  IN UINTN            NoPages
+  )
+{
+  CoreFreePoolPagesI (PoolType, (EFI_PHYSICAL_ADDRESS)(UINTN)Buffer, NoPages);
+}
+
 /**
   Internal function to free a pool entry.
   Caller must have the memory lock held
@@ -696,6 +807,8 @@ CoreFreePoolI (
   BOOLEAN    IsGuarded;
   BOOLEAN    HasPoolTail;
   BOOLEAN    PageAsPool;
+  BOOLEAN    IsSlab;
+  EFI_STATUS Status;
 
   ASSERT (Buffer != NULL);
   //
@@ -719,6 +832,7 @@ CoreFreePoolI (
   HasPoolTail = !(IsGuarded &&
                   ((PcdGet8 (PcdHeapGuardPropertyMask) & BIT7) == 0));
   PageAsPool = (Head->Signature == POOLPAGE_HEAD_SIGNATURE);
+  IsSlab     = (Head->Reserved == POOL_SLAB_MARKER);
 
   if (HasPoolTail) {
     Tail = HEAD_TO_TAIL (Head);
@@ -773,10 +887,19 @@ CoreFreePoolI (
   Index = SIZE_TO_LIST (Size);
   DEBUG_CLEAR_MEMORY (Head, Size);
 
-  //
-  // If it's not on the list, it must be pool pages
-  //
-  if ((Index >= SIZE_TO_LIST (Granularity)) || IsGuarded || PageAsPool) {
+  if (IsSlab) {
+    //
+    // Give the object back to the slab cache it was allocated from
+    //
+    Status = PoolSlabFree (&mPoolSlabCache[Pool->MemoryType], Head);
+    ASSERT_EFI_ERROR (Status);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  } else if ((Index >= SIZE_TO_LIST (Granularity)) || IsGuarded || PageAsPool) {
+    //
+    // If it's not on the list, it must be pool pages
+    //
     //
     // Return the memory pages back to free memory
     //
@@ -0,0 +1,316 @@
+/** @file
+  Segregated slab cache used by the DXE core pool allocator.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "PoolSlab.h"
+
+#define POOL_SLAB_SIGNATURE       SIGNATURE_32('p','s','l','b')
+#define POOL_SLAB_FREE_SIGNATURE  SIGNATURE_32('p','s','f','r')
+
+typedef struct {
+  UINT32    Signature;
+  UINT32    ClassIndex;
+  UINTN     InUse;
+} POOL_SLAB_HEADER;
+
+typedef struct {
+  UINT32        Signature;
+  UINT32        Reserved;
+  LIST_ENTRY    Link;
+} POOL_SLAB_FREE;
+
+#define POOL_SLAB_DATA_OFFSET  ALIGN_VALUE (sizeof (POOL_SLAB_HEADER), POOL_SLAB_OBJECT_ALIGNMENT)
+
+//
+// Object size of each slab class. All sizes are multiples of
+// POOL_SLAB_OBJECT_ALIGNMENT so every carved object stays aligned.
+//
+STATIC CONST UINT16  mPoolSlabClassSize[POOL_SLAB_CLASS_COUNT] = {
+  48, 64, 80, 96, 128, 160, 192, 256, 320, 384, 512, 768, 1024
+};
+
+//
+// Size class of every object size rounded up to POOL_SLAB_OBJECT_ALIGNMENT,
+// indexed by (Size + POOL_SLAB_OBJECT_ALIGNMENT - 1) / POOL_SLAB_OBJECT_ALIGNMENT.
+//
+STATIC CONST UINT8  mPoolSlabSizeToClass[POOL_SLAB_MAX_OBJECT_SIZE / POOL_SLAB_OBJECT_ALIGNMENT + 1] = {
+  0,  0,  0,  0,  1,  2,  3,  4,  4,  5,  5,  6,  6,  7,  7,  7,
+  7,  8,  8,  8,  8,  9,  9,  9,  9,  10, 10, 10, 10, 10, 10, 10,
+  10, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11,
+  11, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+  12
+};
+
+/**
+  Initialize a slab cache for one memory type.
+
+  @param  Cache                  The slab cache to initialize.
+  @param  MemoryType             The memory type served by the cache.
+  @param  Granularity            The size and alignment of one slab in bytes.
+  @param  RefillCount            The number of slabs allocated at once when a
+                                 size class runs out of free objects.
+  @param  AllocatePages          Function used to allocate slab pages.
+  @param  FreePages              Function used to free slab pages.
+
+**/
+VOID
+PoolSlabInitialize (
+  OUT POOL_SLAB_CACHE          *Cache,
+  IN  EFI_MEMORY_TYPE          MemoryType,
+  IN  UINTN                    Granularity,
+  IN  UINTN                    RefillCount,
+  IN  POOL_SLAB_ALLOCATE_PAGES AllocatePages,
+  IN  POOL_SLAB_FREE_PAGES     FreePages
+  )
+{
+  UINTN  Index;
+
+  ASSERT (Granularity >= SIZE_4KB && (Granularity & (Granularity - 1)) == 0);
+
+  Cache->MemoryType    = MemoryType;
+  Cache->Granularity   = Granularity;
+  Cache->RefillCount   = MAX (RefillCount, 1);
+  Cache->AllocatePages = AllocatePages;
+  Cache->FreePages     = FreePages;
+
+  for (Index = 0; Index < POOL_SLAB_CLASS_COUNT; Index++) {
+    InitializeListHead (&Cache->Class[Index].FreeList);
+    Cache->Class[Index].FreeCount      = 0;
+    Cache->Class[Index].SlabCount      = 0;
+    Cache->Class[Index].ObjectsPerSlab = (Granularity - POOL_SLAB_DATA_OFFSET) / mPoolSlabClassSize[Index];
+  }
+}
+
+/**
+  Get the slab size class of the specified object size in constant time.
+
+  @param  Size                   The object size in bytes.
+
+  @return The size class index, or POOL_SLAB_CLASS_COUNT if Size is too large
+          to be served from a slab.
+
+**/
+UINTN
+PoolSlabSizeToClass (
+  IN UINTN  Size
+  )
+{
+  if (Size > POOL_SLAB_MAX_OBJECT_SIZE) {
+    return POOL_SLAB_CLASS_COUNT;
+  }
+
+  return mPoolSlabSizeToClass[(Size + POOL_SLAB_OBJECT_ALIGNMENT - 1) / POOL_SLAB_OBJECT_ALIGNMENT];
+}
+
+/**
+  Get the object size of a slab size class.
+
+  @param  ClassIndex             The size class index.
+
+  @return The object size in bytes.
+
+**/
+UINTN
+PoolSlabClassToSize (
+  IN UINTN  ClassIndex
+  )
+{
+  ASSERT (ClassIndex < POOL_SLAB_CLASS_COUNT);
+  return mPoolSlabClassSize[ClassIndex];
+}
+
+/**
+  Carve a batch of new slabs for a size class and put all their objects onto
+  the free list of the class.
+
+  @param  Cache                  The slab cache to refill.
+  @param  ClassIndex             The size class index.
+
+  @retval TRUE                   At least one slab was added.
+  @retval FALSE                  No memory is available.
+
+**/
+STATIC
+BOOLEAN
+PoolSlabRefill (
+  IN OUT POOL_SLAB_CACHE  *Cache,
+  IN     UINTN            ClassIndex
+  )
+{
+  POOL_SLAB_CLASS   *Class;
+  POOL_SLAB_HEADER  *Slab;
+  POOL_SLAB_FREE    *Free;
+  CHAR8             *Pages;
+  UINTN             SlabCount;
+  UINTN             SlabIndex;
+  UINTN             ObjectIndex;
+  UINTN             ObjectSize;
+
+  Class      = &Cache->Class[ClassIndex];
+  ObjectSize = mPoolSlabClassSize[ClassIndex];
+
+  //
+  // Refill in batches to amortize the cost of the page allocator, and fall
+  // back to a single slab if memory is getting tight.
+  //
+  SlabCount = Cache->RefillCount;
+  Pages     = Cache->AllocatePages (
+                Cache->MemoryType,
+                EFI_SIZE_TO_PAGES (Cache->Granularity * SlabCount),
+                Cache->Granularity
+                );
+  if ((Pages == NULL) && (SlabCount > 1)) {
+    SlabCount = 1;
+    Pages     = Cache->AllocatePages (
+                  Cache->MemoryType,
+                  EFI_SIZE_TO_PAGES (Cache->Granularity),
+                  Cache->Granularity
+                  );
+  }
+
+  if (Pages == NULL) {
+    return FALSE;
+  }
+
+  ASSERT (((UINTN)Pages & (Cache->Granularity - 1)) == 0);
+
+  //
+  // Insert the objects of the last slab first, so the objects of the first
+  // slab are handed out first in ascending address order.
+  //
+  SlabIndex = SlabCount;
+  while (SlabIndex-- > 0) {
+    Slab             = (POOL_SLAB_HEADER *)(Pages + SlabIndex * Cache->Granularity);
+    Slab->Signature  = POOL_SLAB_SIGNATURE;
+    Slab->ClassIndex = (UINT32)ClassIndex;
+    Slab->InUse      = 0;
+
+    ObjectIndex = Class->ObjectsPerSlab;
+    while (ObjectIndex-- > 0) {
+      Free            = (POOL_SLAB_FREE *)((CHAR8 *)Slab + POOL_SLAB_DATA_OFFSET + ObjectIndex * ObjectSize);
+      Free->Signature = POOL_SLAB_FREE_SIGNATURE;
+      InsertHeadList (&Class->FreeList, &Free->Link);
+    }
+  }
+
+  Class->SlabCount += SlabCount;
+  Class->FreeCount += SlabCount * Class->ObjectsPerSlab;
+  return TRUE;
+}
+
+/**
+  Allocate one object of the specified size class.
+
+  @param  Cache                  The slab cache to allocate from.
+  @param  ClassIndex             The size class index.
+
+  @return The allocated object, or NULL if no memory is available.
+
+**/
+VOID *
+PoolSlabAllocate (
+  IN OUT POOL_SLAB_CACHE  *Cache,
+  IN     UINTN            ClassIndex
+  )
+{
+  POOL_SLAB_CLASS   *Class;
+  POOL_SLAB_FREE    *Free;
+  POOL_SLAB_HEADER  *Slab;
+
+  ASSERT (ClassIndex < POOL_SLAB_CLASS_COUNT);
+
+  Class = &Cache->Class[ClassIndex];
+  if (IsListEmpty (&Class->FreeList)) {
+    if (!PoolSlabRefill (Cache, ClassIndex)) {
+      return NULL;
+    }
+  }
+
+  Free = BASE_CR (Class->FreeList.ForwardLink, POOL_SLAB_FREE, Link);
+  ASSERT (Free->Signature == POOL_SLAB_FREE_SIGNATURE);
+  RemoveEntryList (&Free->Link);
+  Free->Signature = 0;
+  Class->FreeCount--;
+
+  Slab = (POOL_SLAB_HEADER *)((UINTN)Free & ~(Cache->Granularity - 1));
+  Slab->InUse++;
+
+  return Free;
+}
+
+/**
+  Free an object previously returned by PoolSlabAllocate().
+
+  @param  Cache                  The slab cache the object belongs to.
+  @param  Object                 The object to free.
+
+  @retval EFI_SUCCESS            The object was returned to the cache.
+  @retval EFI_INVALID_PARAMETER  Object does not belong to a slab of Cache.
+
+**/
+EFI_STATUS
+PoolSlabFree (
+  IN OUT POOL_SLAB_CACHE  *Cache,
+  IN     VOID             *Object
+  )
+{
+  POOL_SLAB_CLASS   *Class;
+  POOL_SLAB_HEADER  *Slab;
+  POOL_SLAB_FREE    *Free;
+  UINTN             ObjectSize;
+  UINTN             Offset;
+
+  Slab = (POOL_SLAB_HEADER *)((UINTN)Object & ~(Cache->Granularity - 1));
+  if ((Slab->Signature != POOL_SLAB_SIGNATURE) ||
+      (Slab->ClassIndex >= POOL_SLAB_CLASS_COUNT) ||
+      (Slab->InUse == 0))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Class      = &Cache->Class[Slab->ClassIndex];
+  ObjectSize = mPoolSlabClassSize[Slab->ClassIndex];
+  Offset     = (UINTN)Object - (UINTN)Slab;
+  if ((Offset < POOL_SLAB_DATA_OFFSET) ||
+      (((Offset - POOL_SLAB_DATA_OFFSET) % ObjectSize) != 0) ||
+      ((Offset - POOL_SLAB_DATA_OFFSET) / ObjectSize >= Class->ObjectsPerSlab))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Reuse the most recently freed object first, its cache lines are hot.
+  //
+  Free            = (POOL_SLAB_FREE *)Object;
+  Free->Signature = POOL_SLAB_FREE_SIGNATURE;
+  InsertHeadList (&Class->FreeList, &Free->Link);
+  Class->FreeCount++;
+  Slab->InUse--;
+
+  //
+  // Give an empty slab back to the page allocator only if the class keeps at
+  // least one refill batch worth of free objects without it, so a workload
+  // allocating and freeing around a slab boundary does not keep hitting the
+  // page allocator.
+  //
+  if ((Slab->InUse == 0) &&
+      (Class->FreeCount >= (Cache->RefillCount + 1) * Class->ObjectsPerSlab))
+  {
+    for (Offset = 0; Offset < Class->ObjectsPerSlab * ObjectSize; Offset += ObjectSize) {
+      Free = (POOL_SLAB_FREE *)((CHAR8 *)Slab + POOL_SLAB_DATA_OFFSET + Offset);
+      ASSERT (Free->Signature == POOL_SLAB_FREE_SIGNATURE);
+      RemoveEntryList (&Free->Link);
+    }
+
+    Class->FreeCount -= Class->ObjectsPerSlab;
+    Class->SlabCount--;
+    Slab->Signature = 0;
+    Cache->FreePages (Cache->MemoryType, Slab, EFI_SIZE_TO_PAGES (Cache->Granularity));
+  }
+
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,164 @@
+/** @file
+  Data structure and functions of the segregated slab cache used by the DXE
+  core pool allocator to serve small pool requests.
+
+  Each slab is one allocation granule (page) dedicated to objects of a single
+  size class. The first bytes of a slab hold a POOL_SLAB_HEADER, so the slab
+  owning an object is found by aligning the object address down to the
+  granularity. Free objects of one size class are kept on a single list across
+  all slabs of the cache, and are handed out in LIFO order.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _POOL_SLAB_H_
+#define _POOL_SLAB_H_
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+
+//
+// Number of slab size classes, and the largest object a slab serves.
+//
+#define POOL_SLAB_CLASS_COUNT      13
+#define POOL_SLAB_MAX_OBJECT_SIZE  1024
+
+//
+// Objects are carved at this alignment from the start of the slab data area.
+//
+#define POOL_SLAB_OBJECT_ALIGNMENT  16
+
+/**
+  Allocate pages to back new slabs.
+
+  @param  MemoryType             The type of memory to allocate.
+  @param  NoPages                The number of pages to allocate.
+  @param  Granularity            The alignment of the allocation in bytes.
+
+  @return The allocated memory, or NULL.
+
+**/
+typedef
+VOID *
+(*POOL_SLAB_ALLOCATE_PAGES)(
+  IN EFI_MEMORY_TYPE  MemoryType,
+  IN UINTN            NoPages,
+  IN UINTN            Granularity
+  );
+
+/**
+  Free pages of a slab that no longer holds any allocated object.
+
+  @param  MemoryType             The type of memory being freed.
+  @param  Buffer                 The base address of the slab.
+  @param  NoPages                The number of pages to free.
+
+**/
+typedef
+VOID
+(*POOL_SLAB_FREE_PAGES)(
+  IN EFI_MEMORY_TYPE  MemoryType,
+  IN VOID             *Buffer,
+  IN UINTN            NoPages
+  );
+
+typedef struct {
+  LIST_ENTRY    FreeList;
+  UINTN         FreeCount;
+  UINTN         SlabCount;
+  UINTN         ObjectsPerSlab;
+} POOL_SLAB_CLASS;
+
+typedef struct {
+  EFI_MEMORY_TYPE             MemoryType;
+  UINTN                       Granularity;
+  UINTN                       RefillCount;
+  POOL_SLAB_ALLOCATE_PAGES    AllocatePages;
+  POOL_SLAB_FREE_PAGES        FreePages;
+  POOL_SLAB_CLASS             Class[POOL_SLAB_CLASS_COUNT];
+} POOL_SLAB_CACHE;
+
+/**
+  Initialize a slab cache for one memory type.
+
+  @param  Cache                  The slab cache to initialize.
+  @param  MemoryType             The memory type served by the cache.
+  @param  Granularity            The size and alignment of one slab in bytes.
+  @param  RefillCount            The number of slabs allocated at once when a
+                                 size class runs out of free objects.
+  @param  AllocatePages          Function used to allocate slab pages.
+  @param  FreePages              Function used to free slab pages.
+
+**/
+VOID
+PoolSlabInitialize (
+  OUT POOL_SLAB_CACHE          *Cache,
+  IN  EFI_MEMORY_TYPE          MemoryType,
+  IN  UINTN                    Granularity,
+  IN  UINTN                    RefillCount,
+  IN  POOL_SLAB_ALLOCATE_PAGES AllocatePages,
+  IN  POOL_SLAB_FREE_PAGES     FreePages
+  );
+
+/**
+  Get the slab size class of the specified object size in constant time.
+
+  @param  Size                   The object size in bytes.
+
+  @return The size class index, or POOL_SLAB_CLASS_COUNT if Size is too large
+          to be served from a slab.
+
+**/
+UINTN
+PoolSlabSizeToClass (
+  IN UINTN  Size
+  );
+
+/**
+  Get the object size of a slab size class.
+
+  @param  ClassIndex             The size class index.
+
+  @return The object size in bytes.
+
+**/
+UINTN
+PoolSlabClassToSize (
+  IN UINTN  ClassIndex
+  );
+
+/**
+  Allocate one object of the specified size class.
+
+  @param  Cache                  The slab cache to allocate from.
+  @param  ClassIndex             The size class index.
+
+  @return The allocated object, or NULL if no memory is available.
+
+**/
+VOID *
+PoolSlabAllocate (
+  IN OUT POOL_SLAB_CACHE  *Cache,
+  IN     UINTN            ClassIndex
+  );
+
+/**
+  Free an object previously returned by PoolSlabAllocate().
+
+  @param  Cache                  The slab cache the object belongs to.
+  @param  Object                 The object to free.
+
+  @retval EFI_SUCCESS            The object was returned to the cache.
+  @retval EFI_INVALID_PARAMETER  Object does not belong to a slab of Cache.
+
+**/
+EFI_STATUS
+PoolSlabFree (
+  IN OUT POOL_SLAB_CACHE  *Cache,
+  IN     VOID             *Object
+  );
+
+#endif
@@ -0,0 +1,562 @@
+/** @file
+  Ordered index of the memory map and GCD map entries by address.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "RangeTree.h"
+
+/**
+  Check the color of a node. Missing children are black.
+
+  @param  Node                   The node, or NULL.
+
+  @retval TRUE                   The node is red.
+  @retval FALSE                  The node is black or NULL.
+
+**/
+STATIC
+BOOLEAN
+RangeTreeIsRed (
+  IN CONST RANGE_TREE_NODE  *Node
+  )
+{
+  return (BOOLEAN)((Node != NULL) && Node->Red);
+}
+
+/**
+  Recompute the largest free size in the subtree of a node from the node and
+  its children.
+
+  @param  Node                   The node to recompute.
+
+**/
+STATIC
+VOID
+RangeTreeRecompute (
+  IN OUT RANGE_TREE_NODE  *Node
+  )
+{
+  UINT64  MaxFreeSize;
+
+  MaxFreeSize = Node->FreeSize;
+  if ((Node->Left != NULL) && (Node->Left->MaxFreeSize > MaxFreeSize)) {
+    MaxFreeSize = Node->Left->MaxFreeSize;
+  }
+
+  if ((Node->Right != NULL) && (Node->Right->MaxFreeSize > MaxFreeSize)) {
+    MaxFreeSize = Node->Right->MaxFreeSize;
+  }
+
+  Node->MaxFreeSize = MaxFreeSize;
+}
+
+/**
+  Recompute the largest free size of a node and of all its ancestors.
+
+  @param  Node                   The lowest node to recompute, or NULL.
+
+**/
+STATIC
+VOID
+RangeTreePropagate (
+  IN OUT RANGE_TREE_NODE  *Node
+  )
+{
+  while (Node != NULL) {
+    RangeTreeRecompute (Node);
+    Node = Node->Parent;
+  }
+}
+
+/**
+  Make New take the place of Old as the child of the parent of Old.
+
+  @param  Tree                   The index.
+  @param  Old                    The node to replace.
+  @param  New                    The node that takes the place, or NULL.
+
+**/
+STATIC
+VOID
+RangeTreeReplaceChild (
+  IN OUT RANGE_TREE       *Tree,
+  IN     RANGE_TREE_NODE  *Old,
+  IN OUT RANGE_TREE_NODE  *New
+  )
+{
+  if (Old->Parent == NULL) {
+    Tree->Root = New;
+  } else if (Old->Parent->Left == Old) {
+    Old->Parent->Left = New;
+  } else {
+    Old->Parent->Right = New;
+  }
+
+  if (New != NULL) {
+    New->Parent = Old->Parent;
+  }
+}
+
+/**
+  Rotate a node down to the left. The subtree keeps its set of nodes, so only
+  the two rotated nodes need to be recomputed.
+
+  @param  Tree                   The index.
+  @param  Node                   The node to rotate. Its right child moves up.
+
+**/
+STATIC
+VOID
+RangeTreeRotateLeft (
+  IN OUT RANGE_TREE       *Tree,
+  IN OUT RANGE_TREE_NODE  *Node
+  )
+{
+  RANGE_TREE_NODE  *Child;
+
+  Child       = Node->Right;
+  Node->Right = Child->Left;
+  if (Child->Left != NULL) {
+    Child->Left->Parent = Node;
+  }
+
+  RangeTreeReplaceChild (Tree, Node, Child);
+  Child->Left  = Node;
+  Node->Parent = Child;
+
+  RangeTreeRecompute (Node);
+  RangeTreeRecompute (Child);
+}
+
+/**
+  Rotate a node down to the right. The subtree keeps its set of nodes, so
+  only the two rotated nodes need to be recomputed.
+
+  @param  Tree                   The index.
+  @param  Node                   The node to rotate. Its left child moves up.
+
+**/
+STATIC
+VOID
+RangeTreeRotateRight (
+  IN OUT RANGE_TREE       *Tree,
+  IN OUT RANGE_TREE_NODE  *Node
+  )
+{
+  RANGE_TREE_NODE  *Child;
+
+  Child      = Node->Left;
+  Node->Left = Child->Right;
+  if (Child->Right != NULL) {
+    Child->Right->Parent = Node;
+  }
+
+  RangeTreeReplaceChild (Tree, Node, Child);
+  Child->Right = Node;
+  Node->Parent = Child;
+
+  RangeTreeRecompute (Node);
+  RangeTreeRecompute (Child);
+}
+
+/**
+  Insert a node into an index.
+
+  The ranges of the nodes in an index must not overlap, so no two nodes have
+  the same start address.
+
+  @param  Tree                   The index to insert into.
+  @param  Node                   The node embedded in the indexed range. Its
+                                 previous content is ignored.
+  @param  Start                  The start address of the range.
+  @param  FreeSize               The size of the range if it is free, or 0.
+
+**/
+VOID
+RangeTreeInsert (
+  IN OUT RANGE_TREE       *Tree,
+  IN OUT RANGE_TREE_NODE  *Node,
+  IN     UINT64           Start,
+  IN     UINT64           FreeSize
+  )
+{
+  RANGE_TREE_NODE  *Parent;
+  RANGE_TREE_NODE  *GrandParent;
+  RANGE_TREE_NODE  *Uncle;
+  RANGE_TREE_NODE  **Slot;
+
+  Node->Left        = NULL;
+  Node->Right       = NULL;
+  Node->Start       = Start;
+  Node->FreeSize    = FreeSize;
+  Node->MaxFreeSize = FreeSize;
+  Node->Red         = TRUE;
+
+  Parent = NULL;
+  Slot   = &Tree->Root;
+  while (*Slot != NULL) {
+    Parent = *Slot;
+    ASSERT (Start != Parent->Start);
+    Slot = (Start < Parent->Start) ? &Parent->Left : &Parent->Right;
+  }
+
+  Node->Parent = Parent;
+  *Slot        = Node;
+  Tree->Count++;
+  RangeTreePropagate (Parent);
+
+  //
+  // Restore the red-black properties.
+  //
+  while (RangeTreeIsRed (Node->Parent)) {
+    Parent      = Node->Parent;
+    GrandParent = Parent->Parent;
+    if (Parent == GrandParent->Left) {
+      Uncle = GrandParent->Right;
+      if (RangeTreeIsRed (Uncle)) {
+        Parent->Red      = FALSE;
+        Uncle->Red       = FALSE;
+        GrandParent->Red = TRUE;
+        Node             = GrandParent;
+        continue;
+      }
+
+      if (Node == Parent->Right) {
+        RangeTreeRotateLeft (Tree, Parent);
+        Node   = Parent;
+        Parent = Node->Parent;
+      }
+
+      Parent->Red      = FALSE;
+      GrandParent->Red = TRUE;
+      RangeTreeRotateRight (Tree, GrandParent);
+    } else {
+      Uncle = GrandParent->Left;
+      if (RangeTreeIsRed (Uncle)) {
+        Parent->Red      = FALSE;
+        Uncle->Red       = FALSE;
+        GrandParent->Red = TRUE;
+        Node             = GrandParent;
+        continue;
+      }
+
+      if (Node == Parent->Left) {
+        RangeTreeRotateRight (Tree, Parent);
+        Node   = Parent;
+        Parent = Node->Parent;
+      }
+
+      Parent->Red      = FALSE;
+      GrandParent->Red = TRUE;
+      RangeTreeRotateLeft (Tree, GrandParent);
+    }
+  }
+
+  Tree->Root->Red = FALSE;
+}
+
+/**
+  Remove a node from an index.
+
+  @param  Tree                   The index to remove from.
+  @param  Node                   The node previously inserted into Tree.
+
+**/
+VOID
+RangeTreeRemove (
+  IN OUT RANGE_TREE       *Tree,
+  IN OUT RANGE_TREE_NODE  *Node
+  )
+{
+  RANGE_TREE_NODE  *Child;
+  RANGE_TREE_NODE  *Parent;
+  RANGE_TREE_NODE  *Successor;
+  RANGE_TREE_NODE  *Sibling;
+  BOOLEAN          RemovedRed;
+
+  ASSERT (Tree->Count > 0);
+
+  //
+  // Unlink the node, or its successor if it has two children, and remember
+  // where a black node may be missing afterwards.
+  //
+  if (Node->Left == NULL) {
+    Child      = Node->Right;
+    Parent     = Node->Parent;
+    RemovedRed = Node->Red;
+    RangeTreeReplaceChild (Tree, Node, Child);
+  } else if (Node->Right == NULL) {
+    Child      = Node->Left;
+    Parent     = Node->Parent;
+    RemovedRed = Node->Red;
+    RangeTreeReplaceChild (Tree, Node, Child);
+  } else {
+    Successor = Node->Right;
+    while (Successor->Left != NULL) {
+      Successor = Successor->Left;
+    }
+
+    RemovedRed = Successor->Red;
+    Child      = Successor->Right;
+    if (Successor->Parent == Node) {
+      Parent = Successor;
+    } else {
+      Parent = Successor->Parent;
+      RangeTreeReplaceChild (Tree, Successor, Child);
+      Successor->Right         = Node->Right;
+      Successor->Right->Parent = Successor;
+    }
+
+    RangeTreeReplaceChild (Tree, Node, Successor);
+    Successor->Left         = Node->Left;
+    Successor->Left->Parent = Successor;
+    Successor->Red          = Node->Red;
+  }
+
+  Tree->Count--;
+  RangeTreePropagate (Parent);
+
+  if (RemovedRed) {
+    return;
+  }
+
+  //
+  // Restore the red-black properties.
+  //
+  while ((Child != Tree->Root) && !RangeTreeIsRed (Child)) {
+    if (Child == Parent->Left) {
+      Sibling = Parent->Right;
+      if (RangeTreeIsRed (Sibling)) {
+        Sibling->Red = FALSE;
+        Parent->Red  = TRUE;
+        RangeTreeRotateLeft (Tree, Parent);
+        Sibling = Parent->Right;
+      }
+
+      if (!RangeTreeIsRed (Sibling->Left) && !RangeTreeIsRed (Sibling->Right)) {
+        Sibling->Red = TRUE;
+        Child        = Parent;
+        Parent       = Child->Parent;
+      } else {
+        if (!RangeTreeIsRed (Sibling->Right)) {
+          Sibling->Left->Red = FALSE;
+          Sibling->Red       = TRUE;
+          RangeTreeRotateRight (Tree, Sibling);
+          Sibling = Parent->Right;
+        }
+
+        Sibling->Red        = Parent->Red;
+        Parent->Red         = FALSE;
+        Sibling->Right->Red = FALSE;
+        RangeTreeRotateLeft (Tree, Parent);
+        Child = Tree->Root;
+      }
+    } else {
+      Sibling = Parent->Left;
+      if (RangeTreeIsRed (Sibling)) {
+        Sibling->Red = FALSE;
+        Parent->Red  = TRUE;
+        RangeTreeRotateRight (Tree, Parent);
+        Sibling = Parent->Left;
+      }
+
+      if (!RangeTreeIsRed (Sibling->Left) && !RangeTreeIsRed (Sibling->Right)) {
+        Sibling->Red = TRUE;
+        Child        = Parent;
+        Parent       = Child->Parent;
+      } else {
+        if (!RangeTreeIsRed (Sibling->Left)) {
+          Sibling->Right->Red = FALSE;
+          Sibling->Red        = TRUE;
+          RangeTreeRotateLeft (Tree, Sibling);
+          Sibling = Parent->Left;
+        }
+
+        Sibling->Red       = Parent->Red;
+        Parent->Red        = FALSE;
+        Sibling->Left->Red = FALSE;
+        RangeTreeRotateRight (Tree, Parent);
+        Child = Tree->Root;
+      }
+    }
+  }
+
+  if (Child != NULL) {
+    Child->Red = FALSE;
+  }
+}
+
+/**
+  Update the start address and the free size of a node in an index.
+
+  The new start address must keep the node between its neighbors, which is
+  the case when a range is clipped or grown without overlapping another one.
+
+  @param  Node                   The node to update.
+  @param  Start                  The new start address of the range.
+  @param  FreeSize               The new size of the range if it is free, or 0.
+
+**/
+VOID
+RangeTreeUpdate (
+  IN OUT RANGE_TREE_NODE  *Node,
+  IN     UINT64           Start,
+  IN     UINT64           FreeSize
+  )
+{
+  Node->Start    = Start;
+  Node->FreeSize = FreeSize;
+  RangeTreePropagate (Node);
+}
+
+/**
+  Make NewNode take the place of OldNode in an index.
+
+  This is used when an indexed range is moved to a new location in memory.
+  The content of OldNode must have been copied to NewNode before.
+
+  @param  Tree                   The index.
+  @param  OldNode                The node previously inserted into Tree.
+  @param  NewNode                The copy of OldNode that replaces it.
+
+**/
+VOID
+RangeTreeReplace (
+  IN OUT RANGE_TREE       *Tree,
+  IN     RANGE_TREE_NODE  *OldNode,
+  IN OUT RANGE_TREE_NODE  *NewNode
+  )
+{
+  RangeTreeReplaceChild (Tree, OldNode, NewNode);
+  if (NewNode->Left != NULL) {
+    NewNode->Left->Parent = NewNode;
+  }
+
+  if (NewNode->Right != NULL) {
+    NewNode->Right->Parent = NewNode;
+  }
+}
+
+/**
+  Get the node with the highest start address that is not above Address.
+
+  @param  Tree                   The index to search.
+  @param  Address                The address to look up.
+
+  @return The node, or NULL if all nodes start above Address.
+
+**/
+RANGE_TREE_NODE *
+RangeTreeFindFloor (
+  IN CONST RANGE_TREE  *Tree,
+  IN UINT64            Address
+  )
+{
+  RANGE_TREE_NODE  *Node;
+  RANGE_TREE_NODE  *Floor;
+
+  Floor = NULL;
+  Node  = Tree->Root;
+  while (Node != NULL) {
+    if (Node->Start <= Address) {
+      Floor = Node;
+      Node  = Node->Right;
+    } else {
+      Node = Node->Left;
+    }
+  }
+
+  return Floor;
+}
+
+/**
+  Get the node with the highest start address that is not above Address and
+  whose free size is at least FreeSize.
+
+  @param  Tree                   The index to search.
+  @param  Address                The highest start address to accept.
+  @param  FreeSize               The minimum free size to accept. Must not be 0.
+
+  @return The node, or NULL if there is none.
+
+**/
+RANGE_TREE_NODE *
+RangeTreeFindFreeBelow (
+  IN CONST RANGE_TREE  *Tree,
+  IN UINT64            Address,
+  IN UINT64            FreeSize
+  )
+{
+  RANGE_TREE_NODE  *Node;
+
+  ASSERT (FreeSize != 0);
+
+  //
+  // The nodes not above Address are the floor node, its left subtree, and
+  // every ancestor whose right subtree holds the floor node together with
+  // the left subtree of that ancestor. Visit them from the highest address
+  // down and skip the subtrees without a large enough free range.
+  //
+  Node = RangeTreeFindFloor (Tree, Address);
+  while (Node != NULL) {
+    if (Node->FreeSize >= FreeSize) {
+      return Node;
+    }
+
+    if ((Node->Left != NULL) && (Node->Left->MaxFreeSize >= FreeSize)) {
+      Node = Node->Left;
+      while (TRUE) {
+        if ((Node->Right != NULL) && (Node->Right->MaxFreeSize >= FreeSize)) {
+          Node = Node->Right;
+        } else if (Node->FreeSize >= FreeSize) {
+          return Node;
+        } else {
+          Node = Node->Left;
+          ASSERT (Node != NULL && Node->MaxFreeSize >= FreeSize);
+        }
+      }
+    }
+
+    while ((Node->Parent != NULL) && (Node == Node->Parent->Left)) {
+      Node = Node->Parent;
+    }
+
+    Node = Node->Parent;
+  }
+
+  return NULL;
+}
+
+/**
+  Get the node that follows Node in address order.
+
+  @param  Node                   A node of an index.
+
+  @return The next node, or NULL if Node is the last one.
+
+**/
+RANGE_TREE_NODE *
+RangeTreeNext (
+  IN CONST RANGE_TREE_NODE  *Node
+  )
+{
+  RANGE_TREE_NODE  *Next;
+
+  if (Node->Right != NULL) {
+    Next = Node->Right;
+    while (Next->Left != NULL) {
+      Next = Next->Left;
+    }
+
+    return Next;
+  }
+
+  while ((Node->Parent != NULL) && (Node == Node->Parent->Right)) {
+    Node = Node->Parent;
+  }
+
+  return Node->Parent;
+}
@@ -0,0 +1,162 @@
+/** @file
+  Ordered index used by the DXE core to look up the entries of the UEFI
+  memory map and of the GCD memory and I/O space maps by address.
+
+  The index is an intrusive red-black tree: every indexed range embeds a
+  RANGE_TREE_NODE, which records the start address of the range and the size
+  of the range if it is free. Each node also caches the largest free size in
+  its subtree, so the highest free range of a minimum size below an address
+  is found without visiting the ranges that are too small. The index never
+  allocates memory, so it can be updated while the memory map is being
+  changed. The lists the index accelerates stay the authoritative, ordered
+  view of the maps.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _RANGE_TREE_H_
+#define _RANGE_TREE_H_
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+
+typedef struct _RANGE_TREE_NODE RANGE_TREE_NODE;
+
+struct _RANGE_TREE_NODE {
+  RANGE_TREE_NODE    *Parent;
+  RANGE_TREE_NODE    *Left;
+  RANGE_TREE_NODE    *Right;
+  UINT64             Start;
+  UINT64             FreeSize;
+  UINT64             MaxFreeSize;
+  BOOLEAN            Red;
+};
+
+///
+/// A zero initialized RANGE_TREE is an empty index.
+///
+typedef struct {
+  RANGE_TREE_NODE    *Root;
+  UINTN              Count;
+} RANGE_TREE;
+
+/**
+  Insert a node into an index.
+
+  The ranges of the nodes in an index must not overlap, so no two nodes have
+  the same start address.
+
+  @param  Tree                   The index to insert into.
+  @param  Node                   The node embedded in the indexed range. Its
+                                 previous content is ignored.
+  @param  Start                  The start address of the range.
+  @param  FreeSize               The size of the range if it is free, or 0.
+
+**/
+VOID
+RangeTreeInsert (
+  IN OUT RANGE_TREE       *Tree,
+  IN OUT RANGE_TREE_NODE  *Node,
+  IN     UINT64           Start,
+  IN     UINT64           FreeSize
+  );
+
+/**
+  Remove a node from an index.
+
+  @param  Tree                   The index to remove from.
+  @param  Node                   The node previously inserted into Tree.
+
+**/
+VOID
+RangeTreeRemove (
+  IN OUT RANGE_TREE       *Tree,
+  IN OUT RANGE_TREE_NODE  *Node
+  );
+
+/**
+  Update the start address and the free size of a node in an index.
+
+  The new start address must keep the node between its neighbors, which is
+  the case when a range is clipped or grown without overlapping another one.
+
+  @param  Node                   The node to update.
+  @param  Start                  The new start address of the range.
+  @param  FreeSize               The new size of the range if it is free, or 0.
+
+**/
+VOID
+RangeTreeUpdate (
+  IN OUT RANGE_TREE_NODE  *Node,
+  IN     UINT64           Start,
+  IN     UINT64           FreeSize
+  );
+
+/**
+  Make NewNode take the place of OldNode in an index.
+
+  This is used when an indexed range is moved to a new location in memory.
+  The content of OldNode must have been copied to NewNode before.
+
+  @param  Tree                   The index.
+  @param  OldNode                The node previously inserted into Tree.
+  @param  NewNode                The copy of OldNode that replaces it.
+
+**/
+VOID
+RangeTreeReplace (
+  IN OUT RANGE_TREE       *Tree,
+  IN     RANGE_TREE_NODE  *OldNode,
+  IN OUT RANGE_TREE_NODE  *NewNode
+  );
+
+/**
+  Get the node with the highest start address that is not above Address.
+
+  @param  Tree                   The index to search.
+  @param  Address                The address to look up.
+
+  @return The node, or NULL if all nodes start above Address.
+
+**/
+RANGE_TREE_NODE *
+RangeTreeFindFloor (
+  IN CONST RANGE_TREE  *Tree,
+  IN UINT64            Address
+  );
+
+/**
+  Get the node with the highest start address that is not above Address and
+  whose free size is at least FreeSize.
+
+  @param  Tree                   The index to search.
+  @param  Address                The highest start address to accept.
+  @param  FreeSize               The minimum free size to accept. Must not be 0.
+
+  @return The node, or NULL if there is none.
+
+**/
+RANGE_TREE_NODE *
+RangeTreeFindFreeBelow (
+  IN CONST RANGE_TREE  *Tree,
+  IN UINT64            Address,
+  IN UINT64            FreeSize
+  );
+
+/**
+  Get the node that follows Node in address order.
+
+  @param  Node                   A node of an index.
+
+  @return The next node, or NULL if Node is the last one.
+
+**/
+RANGE_TREE_NODE *
+RangeTreeNext (
+  IN CONST RANGE_TREE_NODE  *Node
+  );
+
+#endif
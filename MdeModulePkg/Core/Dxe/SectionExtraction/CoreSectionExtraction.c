@@ -27,7 +27,13 @@
   3) A support protocol is not found, and the data is not available to be read
      without it.  This results in EFI_PROTOCOL_ERROR.
 
-Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
+  The streams extracted from compression and GUIDed sections into new buffers
+  are kept in a least recently used list, with the size of their buffers. When
+  the size of the list exceeds PcdDxeSectionCacheMaxSize, the least recently
+  used streams are closed, and their sections are extracted again if they are
+  searched again.
+
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -65,8 +71,28 @@ typedef struct {
   // when the required GUIDed extraction protocol becomes available.
   //
   EFI_EVENT     Event;
+  //
+  // Link on mSectionCache when the encapsulated stream owns the buffer the
+  // section was extracted to. CacheSize is the size of that buffer, or 0 if
+  // the child is not on mSectionCache.
+  //
+  LIST_ENTRY    CacheLink;
+  UINTN         CacheSize;
+  //
+  // Number of searches walking the encapsulated stream. The stream of a
+  // child in use is not closed to trim the cache.
+  //
+  UINTN         UseCount;
+  //
+  // TRUE if the encapsulated stream was closed to trim the cache. It is
+  // extracted again when the child is searched.
+  //
+  BOOLEAN       Evicted;
 } CORE_SECTION_CHILD_NODE;
 
+#define CHILD_SECTION_NODE_FROM_CACHE_LINK(Node) \
+  CR (Node, CORE_SECTION_CHILD_NODE, CacheLink, CORE_SECTION_CHILD_SIGNATURE)
+
 #define CORE_SECTION_STREAM_SIGNATURE  SIGNATURE_32('S','X','S','S')
 #define STREAM_NODE_FROM_LINK(Node) \
   CR (Node, CORE_SECTION_STREAM_NODE, Link, CORE_SECTION_STREAM_SIGNATURE)
@@ -190,6 +216,13 @@ CustomGuidedSectionExtract (
 //
 LIST_ENTRY  mStreamRoot = INITIALIZE_LIST_HEAD_VARIABLE (mStreamRoot);
 
+//
+// Children owning an extracted stream buffer, most recently used first, and
+// the total size of their buffers.
+//
+LIST_ENTRY  mSectionCache     = INITIALIZE_LIST_HEAD_VARIABLE (mSectionCache);
+UINTN       mSectionCacheSize = 0;
+
 EFI_HANDLE  mSectionExtractionHandle = NULL;
 
 EFI_GUIDED_SECTION_EXTRACTION_PROTOCOL  mCustomGuidedSectionExtractionProtocol = {
@@ -532,6 +565,129 @@ VerifyGuidedSectionGuid (
   return FALSE;
 }
 
+/**
+  Worker function.  Remove a child from the section cache.  It is a nop if
+  the child is not in the cache.
+
+  @param  ChildNode              Indicates the child to remove.
+
+**/
+VOID
+SectionCacheRemove (
+  IN CORE_SECTION_CHILD_NODE  *ChildNode
+  )
+{
+  if (ChildNode->CacheSize != 0) {
+    RemoveEntryList (&ChildNode->CacheLink);
+    mSectionCacheSize   -= ChildNode->CacheSize;
+    ChildNode->CacheSize = 0;
+  }
+}
+
+/**
+  Worker function.  Mark a child of the section cache as the most recently
+  used one.  It is a nop if the child is not in the cache.
+
+  @param  ChildNode              Indicates the child just used.
+
+**/
+VOID
+SectionCacheTouch (
+  IN CORE_SECTION_CHILD_NODE  *ChildNode
+  )
+{
+  if (ChildNode->CacheSize != 0) {
+    RemoveEntryList (&ChildNode->CacheLink);
+    InsertHeadList (&mSectionCache, &ChildNode->CacheLink);
+  }
+}
+
+/**
+  Worker function.  Close the encapsulated streams of the least recently used
+  children of the section cache until the size of the cache does not exceed
+  PcdDxeSectionCacheMaxSize.  The streams of the children in use are kept.
+
+**/
+VOID
+SectionCacheTrim (
+  VOID
+  )
+{
+  UINTN                    MaxSize;
+  LIST_ENTRY               *Link;
+  CORE_SECTION_CHILD_NODE  *ChildNode;
+
+  MaxSize = PcdGet32 (PcdDxeSectionCacheMaxSize);
+  if (MaxSize == 0) {
+    return;
+  }
+
+  while (mSectionCacheSize > MaxSize) {
+    //
+    // Closing a stream frees the children of that stream, which may be in the
+    // cache too, so the search starts again from the least recently used
+    // child after each stream closed.
+    //
+    ChildNode = NULL;
+    for (Link = mSectionCache.BackLink; Link != &mSectionCache; Link = Link->BackLink) {
+      ChildNode = CHILD_SECTION_NODE_FROM_CACHE_LINK (Link);
+      if (ChildNode->UseCount == 0) {
+        break;
+      }
+    }
+
+    if (Link == &mSectionCache) {
+      return;
+    }
+
+    DEBUG ((
+      DEBUG_VERBOSE,
+      "SectionCache: close stream of %ld bytes, %ld bytes cached\n",
+      (UINT64)ChildNode->CacheSize,
+      (UINT64)(mSectionCacheSize - ChildNode->CacheSize)
+      ));
+    SectionCacheRemove (ChildNode);
+    CloseSectionStream (ChildNode->EncapsulatedStreamHandle, TRUE);
+    ChildNode->EncapsulatedStreamHandle = NULL_STREAM_HANDLE;
+    ChildNode->Evicted                  = TRUE;
+  }
+}
+
+/**
+  Worker function.  Add a child to the section cache as the most recently used
+  one, then trim the cache.  The encapsulated stream of the child must own its
+  stream buffer.
+
+  @param  ChildNode              Indicates the child whose stream was just
+                                 extracted.
+  @param  Size                   Indicates the size of the stream buffer.
+
+**/
+VOID
+SectionCacheInsert (
+  IN CORE_SECTION_CHILD_NODE  *ChildNode,
+  IN UINTN                    Size
+  )
+{
+  ASSERT (ChildNode->CacheSize == 0);
+
+  if (Size == 0) {
+    return;
+  }
+
+  InsertHeadList (&mSectionCache, &ChildNode->CacheLink);
+  ChildNode->CacheSize = Size;
+  mSectionCacheSize   += Size;
+
+  //
+  // The stream just extracted is about to be searched, so it is kept even if
+  // it is larger than the cache.
+  //
+  ChildNode->UseCount++;
+  SectionCacheTrim ();
+  ChildNode->UseCount--;
+}
+
 /**
   RPN callback function. Initializes the section stream
   when GUIDED_SECTION_EXTRACTION_PROTOCOL is installed.
@@ -598,6 +754,9 @@ NotifyGuidedExtraction (
              &Context->ChildNode->EncapsulatedStreamHandle
              );
   ASSERT_EFI_ERROR (Status);
+  if (!EFI_ERROR (Status)) {
+    SectionCacheInsert (Context->ChildNode, NewStreamBufferSize);
+  }
 
   //
   //  Close the event when done.
@@ -641,31 +800,27 @@ CreateGuidedExtractionRpnEvent (
 }
 
 /**
-  Worker function.  Constructor for new child nodes.
+  Worker function.  Extract the encapsulated stream of a child node, if the
+  child is an encapsulating section.
 
-  @param  Stream                 Indicates the section stream in which to add the
-                                 child.
-  @param  ChildOffset            Indicates the offset in Stream that is the
-                                 beginning of the child section.
-  @param  ChildNode              Indicates the Callee allocated and initialized
-                                 child.
+  @param  Stream                 Indicates the section stream of the child.
+  @param  Node                   Indicates the child.
 
-  @retval EFI_SUCCESS            Child node was found and returned.
-                                 EFI_OUT_OF_RESOURCES- Memory allocation failed.
-  @retval EFI_PROTOCOL_ERROR     Encapsulation sections produce new stream
-                                 handles when the child node is created.  If the
-                                 section type is GUID defined, and the extraction
-                                 GUID does not exist, and producing the stream
-                                 requires the GUID, then a protocol error is
-                                 generated and no child is produced. Values
-                                 returned by OpenSectionStreamEx.
+  @retval EFI_SUCCESS            The child is a leaf, or its stream was
+                                 extracted, or its GUIDed extraction protocol
+                                 is not available yet and a RPN event was
+                                 registered.
+  @retval EFI_OUT_OF_RESOURCES   Memory allocation failed.
+  @retval EFI_PROTOCOL_ERROR     The GUIDed extraction protocol failed to
+                                 extract the section.
+  @retval others                 Values returned by the decompression
+                                 protocol or by OpenSectionStreamEx.
 
 **/
 EFI_STATUS
-CreateChildNode (
+ExtractChildStream (
   IN     CORE_SECTION_STREAM_NODE  *Stream,
-  IN     UINT32                    ChildOffset,
-  OUT    CORE_SECTION_CHILD_NODE   **ChildNode
+  IN OUT CORE_SECTION_CHILD_NODE   *Node
   )
 {
   EFI_STATUS                              Status;
@@ -685,44 +840,14 @@ CreateChildNode (
   UINT8                                   CompressionType;
   UINT16                                  GuidedSectionAttributes;
 
-  CORE_SECTION_CHILD_NODE  *Node;
-
-  SectionHeader = (EFI_COMMON_SECTION_HEADER *)(Stream->StreamBuffer + ChildOffset);
-
-  //
-  // Allocate a new node
-  //
-  *ChildNode = AllocateZeroPool (sizeof (CORE_SECTION_CHILD_NODE));
-  Node       = *ChildNode;
-  if (Node == NULL) {
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  //
-  // Now initialize it
-  //
-  Node->Signature = CORE_SECTION_CHILD_SIGNATURE;
-  Node->Type      = SectionHeader->Type;
-  if (IS_SECTION2 (SectionHeader)) {
-    Node->Size = SECTION2_SIZE (SectionHeader);
-  } else {
-    Node->Size = SECTION_SIZE (SectionHeader);
-  }
-
-  Node->OffsetInStream           = ChildOffset;
-  Node->EncapsulatedStreamHandle = NULL_STREAM_HANDLE;
-  Node->EncapsulationGuid        = NULL;
+  SectionHeader = (EFI_COMMON_SECTION_HEADER *)(Stream->StreamBuffer + Node->OffsetInStream);
 
-  //
-  // If it's an encapsulating section, then create the new section stream also
-  //
   switch (Node->Type) {
     case EFI_SECTION_COMPRESSION:
       //
       // Get the CompressionSectionHeader
       //
       if (Node->Size < sizeof (EFI_COMPRESSION_SECTION)) {
-        CoreFreePool (Node);
         return EFI_NOT_FOUND;
       }
 
@@ -747,7 +872,6 @@ CreateChildNode (
         NewStreamBufferSize = UncompressedLength;
         NewStreamBuffer     = AllocatePool (NewStreamBufferSize);
         if (NewStreamBuffer == NULL) {
-          CoreFreePool (Node);
           return EFI_OUT_OF_RESOURCES;
         }
 
@@ -776,7 +900,6 @@ CreateChildNode (
                                  &ScratchSize
                                  );
           if (EFI_ERROR (Status) || (NewStreamBufferSize != UncompressedLength)) {
-            CoreFreePool (Node);
             CoreFreePool (NewStreamBuffer);
             if (!EFI_ERROR (Status)) {
               Status = EFI_BAD_BUFFER_SIZE;
@@ -787,7 +910,6 @@ CreateChildNode (
 
           ScratchBuffer = AllocatePool (ScratchSize);
           if (ScratchBuffer == NULL) {
-            CoreFreePool (Node);
             CoreFreePool (NewStreamBuffer);
             return EFI_OUT_OF_RESOURCES;
           }
@@ -803,7 +925,6 @@ CreateChildNode (
                                  );
           CoreFreePool (ScratchBuffer);
           if (EFI_ERROR (Status)) {
-            CoreFreePool (Node);
             CoreFreePool (NewStreamBuffer);
             return Status;
           }
@@ -821,11 +942,14 @@ CreateChildNode (
                  &Node->EncapsulatedStreamHandle
                  );
       if (EFI_ERROR (Status)) {
-        CoreFreePool (Node);
-        CoreFreePool (NewStreamBuffer);
+        if (NewStreamBuffer != NULL) {
+          CoreFreePool (NewStreamBuffer);
+        }
+
         return Status;
       }
 
+      SectionCacheInsert (Node, NewStreamBufferSize);
       break;
 
     case EFI_SECTION_GUID_DEFINED:
@@ -851,7 +975,6 @@ CreateChildNode (
                                      &AuthenticationStatus
                                      );
         if (EFI_ERROR (Status)) {
-          CoreFreePool (*ChildNode);
           return EFI_PROTOCOL_ERROR;
         }
 
@@ -880,10 +1003,11 @@ CreateChildNode (
                    &Node->EncapsulatedStreamHandle
                    );
         if (EFI_ERROR (Status)) {
-          CoreFreePool (*ChildNode);
           CoreFreePool (NewStreamBuffer);
           return Status;
         }
+
+        SectionCacheInsert (Node, NewStreamBufferSize);
       } else {
         //
         // There's no GUIDed section extraction protocol available.
@@ -923,7 +1047,6 @@ CreateChildNode (
           }
 
           if (EFI_ERROR (Status)) {
-            CoreFreePool (Node);
             return Status;
           }
         }
@@ -939,6 +1062,77 @@ CreateChildNode (
       break;
   }
 
+  Node->Evicted = FALSE;
+  return EFI_SUCCESS;
+}
+
+/**
+  Worker function.  Constructor for new child nodes.
+
+  @param  Stream                 Indicates the section stream in which to add the
+                                 child.
+  @param  ChildOffset            Indicates the offset in Stream that is the
+                                 beginning of the child section.
+  @param  ChildNode              Indicates the Callee allocated and initialized
+                                 child.
+
+  @retval EFI_SUCCESS            Child node was found and returned.
+                                 EFI_OUT_OF_RESOURCES- Memory allocation failed.
+  @retval EFI_PROTOCOL_ERROR     Encapsulation sections produce new stream
+                                 handles when the child node is created.  If the
+                                 section type is GUID defined, and the extraction
+                                 GUID does not exist, and producing the stream
+                                 requires the GUID, then a protocol error is
+                                 generated and no child is produced. Values
+                                 returned by OpenSectionStreamEx.
+
+**/
+EFI_STATUS
+CreateChildNode (
+  IN     CORE_SECTION_STREAM_NODE  *Stream,
+  IN     UINT32                    ChildOffset,
+  OUT    CORE_SECTION_CHILD_NODE   **ChildNode
+  )
+{
+  EFI_STATUS                 Status;
+  EFI_COMMON_SECTION_HEADER  *SectionHeader;
+  CORE_SECTION_CHILD_NODE    *Node;
+
+  SectionHeader = (EFI_COMMON_SECTION_HEADER *)(Stream->StreamBuffer + ChildOffset);
+
+  //
+  // Allocate a new node
+  //
+  *ChildNode = AllocateZeroPool (sizeof (CORE_SECTION_CHILD_NODE));
+  Node       = *ChildNode;
+  if (Node == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Now initialize it
+  //
+  Node->Signature = CORE_SECTION_CHILD_SIGNATURE;
+  Node->Type      = SectionHeader->Type;
+  if (IS_SECTION2 (SectionHeader)) {
+    Node->Size = SECTION2_SIZE (SectionHeader);
+  } else {
+    Node->Size = SECTION_SIZE (SectionHeader);
+  }
+
+  Node->OffsetInStream           = ChildOffset;
+  Node->EncapsulatedStreamHandle = NULL_STREAM_HANDLE;
+  Node->EncapsulationGuid        = NULL;
+
+  //
+  // If it's an encapsulating section, then create the new section stream also
+  //
+  Status = ExtractChildStream (Stream, Node);
+  if (EFI_ERROR (Status)) {
+    CoreFreePool (Node);
+    return Status;
+  }
+
   //
   // Last, add the new child node to the stream
   //
@@ -1059,10 +1253,24 @@ FindChildNode (
     //
     ASSERT (*SectionInstance > 0);
 
+    if (CurrentChildNode->Evicted) {
+      //
+      // The encapsulated stream was closed to trim the section cache, so
+      // extract it again.
+      //
+      Status = ExtractChildStream (SourceStream, CurrentChildNode);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    }
+
     if (CurrentChildNode->EncapsulatedStreamHandle != NULL_STREAM_HANDLE) {
       //
       // If the current node is an encapsulating node, recurse into it...
+      // Its stream is kept in the section cache while it is searched.
       //
+      SectionCacheTouch (CurrentChildNode);
+      CurrentChildNode->UseCount++;
       Status = FindChildNode (
                  (CORE_SECTION_STREAM_NODE *)CurrentChildNode->EncapsulatedStreamHandle,
                  SearchType,
@@ -1073,6 +1281,7 @@ FindChildNode (
                  &RecursedFoundStream,
                  AuthenticationStatus
                  );
+      CurrentChildNode->UseCount--;
       if (*SectionInstance == 0) {
         //
         // The recursive FindChildNode() call decreased (*SectionInstance) to
@@ -1377,9 +1586,10 @@ FreeChildNode (
 {
   ASSERT (ChildNode->Signature == CORE_SECTION_CHILD_SIGNATURE);
   //
-  // Remove the child from it's list
+  // Remove the child from it's list, and from the section cache
   //
   RemoveEntryList (&ChildNode->Link);
+  SectionCacheRemove (ChildNode);
 
   if (ChildNode->EncapsulatedStreamHandle != NULL_STREAM_HANDLE) {
     //
@@ -1,7 +1,7 @@
 /** @file
   EFI PEI Core dispatch services
 
-Copyright (c) 2006 - 2019, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 (C) Copyright 2016 Hewlett Packard Enterprise Development LP<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -9,10 +9,132 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "PeiMain.h"
 
+/**
+  Order the PEIMs of one FV that follow the Apriori PEIMs with the optional
+  dispatch manifest of the FV.
+
+  The PEIMs of the manifest are moved, in its order, right after the Apriori
+  PEIMs. The manifest is taken up to its first file that is not a PEIM of the
+  FV, since the PEIMs after it may depend on PPIs it installs.
+
+  @param Private          Pointer to the private data passed in from caller
+  @param CoreFileHandle   The instance of PEI_CORE_FV_HANDLE, with its
+                          FvFileHandles ordered with the Apriori file.
+
+**/
+VOID
+OrderWithDispatchManifest (
+  IN  PEI_CORE_INSTANCE   *Private,
+  IN  PEI_CORE_FV_HANDLE  *CoreFileHandle
+  )
+{
+  EFI_STATUS                   Status;
+  EFI_PEI_FILE_HANDLE          ManifestFileHandle;
+  EDKII_DISPATCH_MANIFEST      *Manifest;
+  EFI_GUID                     *FileName;
+  UINTN                        ManifestSize;
+  UINTN                        Index;
+  UINTN                        Entry;
+  UINTN                        PeimIndex;
+  UINTN                        PeimCount;
+  EFI_GUID                     *Guid;
+  EFI_PEI_FILE_HANDLE          *TempFileHandles;
+  EFI_GUID                     *TempFileGuid;
+  EFI_PEI_FIRMWARE_VOLUME_PPI  *FvPpi;
+  EFI_FV_FILE_INFO             FileInfo;
+
+  FvPpi     = CoreFileHandle->FvPpi;
+  PeimCount = CoreFileHandle->PeimCount;
+
+  CoreFileHandle->ManifestStart = Private->AprioriCount;
+  CoreFileHandle->ManifestEnd   = Private->AprioriCount;
+  CoreFileHandle->ManifestNext  = Private->AprioriCount;
+
+  ManifestFileHandle = NULL;
+  Status             = FvPpi->FindFileByName (FvPpi, &gEdkiiPeiDispatchManifestFileGuid, &CoreFileHandle->FvHandle, &ManifestFileHandle);
+  if (EFI_ERROR (Status) || (ManifestFileHandle == NULL)) {
+    return;
+  }
+
+  Status = FvPpi->FindSectionByType (FvPpi, EFI_SECTION_RAW, ManifestFileHandle, (VOID **)&Manifest);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  Status = FvPpi->GetFileInfo (FvPpi, ManifestFileHandle, &FileInfo);
+  ASSERT_EFI_ERROR (Status);
+  ManifestSize = FileInfo.BufferSize;
+  if (IS_SECTION2 (FileInfo.Buffer)) {
+    ManifestSize -= sizeof (EFI_COMMON_SECTION_HEADER2);
+  } else {
+    ManifestSize -= sizeof (EFI_COMMON_SECTION_HEADER);
+  }
+
+  if ((ManifestSize < sizeof (EDKII_DISPATCH_MANIFEST)) ||
+      (Manifest->Signature != EDKII_DISPATCH_MANIFEST_SIGNATURE) ||
+      (Manifest->Version != EDKII_DISPATCH_MANIFEST_VERSION) ||
+      (Manifest->HeaderSize < sizeof (EDKII_DISPATCH_MANIFEST)) ||
+      (Manifest->HeaderSize > ManifestSize) ||
+      ((ManifestSize - Manifest->HeaderSize) / sizeof (EFI_GUID) < Manifest->EntryCount))
+  {
+    DEBUG ((DEBUG_ERROR, "Invalid dispatch manifest in the %dth FV\n", Private->CurrentPeimFvCount));
+    return;
+  }
+
+  //
+  // Make an array of file name GUIDs that matches the FvFileHandles array. The
+  // Apriori PEIMs keep their place, so they are not taken from TempFileHandles.
+  //
+  TempFileHandles = Private->TempFileHandles;
+  TempFileGuid    = Private->TempFileGuid;
+  for (Index = 0; Index < PeimCount; Index++) {
+    Status = FvPpi->GetFileInfo (FvPpi, CoreFileHandle->FvFileHandles[Index], &FileInfo);
+    ASSERT_EFI_ERROR (Status);
+    CopyMem (&TempFileGuid[Index], &FileInfo.FileName, sizeof (EFI_GUID));
+    TempFileHandles[Index] = (Index < Private->AprioriCount) ? NULL : CoreFileHandle->FvFileHandles[Index];
+  }
+
+  FileName = (EFI_GUID *)((UINT8 *)Manifest + Manifest->HeaderSize);
+  Index    = Private->AprioriCount;
+  for (Entry = 0; Entry < Manifest->EntryCount; Entry++) {
+    Guid = ScanGuid (TempFileGuid, PeimCount * sizeof (EFI_GUID), &FileName[Entry]);
+    if (Guid == NULL) {
+      DEBUG ((DEBUG_INFO, "Dispatch manifest of the %dth FV stopped at %g\n", Private->CurrentPeimFvCount, &FileName[Entry]));
+      break;
+    }
+
+    PeimIndex = ((UINTN)Guid - (UINTN)&TempFileGuid[0])/sizeof (EFI_GUID);
+    if (TempFileHandles[PeimIndex] == NULL) {
+      //
+      // The PEIM is in the Apriori file, it is dispatched before anyway.
+      //
+      continue;
+    }
+
+    CoreFileHandle->FvFileHandles[Index++] = TempFileHandles[PeimIndex];
+    TempFileHandles[PeimIndex]             = NULL;
+  }
+
+  CoreFileHandle->ManifestEnd = Index;
+
+  //
+  // Add in any PEIMs not in the Apriori file nor in the dispatch manifest
+  //
+  for (PeimIndex = Private->AprioriCount; PeimIndex < PeimCount; PeimIndex++) {
+    if (TempFileHandles[PeimIndex] != NULL) {
+      CoreFileHandle->FvFileHandles[Index++] = TempFileHandles[PeimIndex];
+      TempFileHandles[PeimIndex]             = NULL;
+    }
+  }
+
+  ASSERT (Index == PeimCount);
+}
+
 /**
 
   Discover all PEIMs and optional Apriori file in one FV. There is at most one
-  Apriori file in one FV.
+  Apriori file in one FV. The PEIMs not in the Apriori file are then ordered
+  with the optional dispatch manifest of the FV.
 
 
   @param Private          Pointer to the private data passed in from caller
@@ -115,11 +237,13 @@ DiscoverPeimsAndOrderWithApriori (
   }
 
   //
-  // Record PeimCount, allocate buffer for PeimState and FvFileHandles.
+  // Record PeimCount, allocate buffer for PeimState, PeimSucceeded and FvFileHandles.
   //
   CoreFileHandle->PeimCount = PeimCount;
   CoreFileHandle->PeimState = AllocateZeroPool (sizeof (UINT8) * PeimCount);
   ASSERT (CoreFileHandle->PeimState != NULL);
+  CoreFileHandle->PeimSucceeded = AllocateZeroPool (sizeof (BOOLEAN) * PeimCount);
+  ASSERT (CoreFileHandle->PeimSucceeded != NULL);
   CoreFileHandle->FvFileHandles = AllocateZeroPool (sizeof (EFI_PEI_FILE_HANDLE) * PeimCount);
   ASSERT (CoreFileHandle->FvFileHandles != NULL);
 
@@ -197,6 +321,8 @@ DiscoverPeimsAndOrderWithApriori (
     CopyMem (CoreFileHandle->FvFileHandles, TempFileHandles, sizeof (EFI_PEI_FILE_HANDLE) * PeimCount);
   }
 
+  OrderWithDispatchManifest (Private, CoreFileHandle);
+
   //
   // The current FV File Handles have been cached. So that we don't have to scan the FV again.
   // Instead, we can retrieve the file handles within this FV from cached records.
@@ -1410,7 +1536,8 @@ PeiDispatcher (
             PeimEntryPoint = (EFI_PEIM_ENTRY_POINT2)(UINTN)EntryPoint;
 
             PERF_START_IMAGE_BEGIN (PeimFileHandle);
-            PeimEntryPoint (PeimFileHandle, (const EFI_PEI_SERVICES **)&Private->Ps);
+            Status                                    = PeimEntryPoint (PeimFileHandle, (const EFI_PEI_SERVICES **)&Private->Ps);
+            Private->Fv[Index1].PeimSucceeded[Index2] = (BOOLEAN)(Status == EFI_SUCCESS);
             PERF_START_IMAGE_END (PeimFileHandle);
           }
 
@@ -1495,7 +1622,8 @@ PeiDispatcher (
                 // PEIM_STATE_NOT_DISPATCHED move to PEIM_STATE_DISPATCHED
                 //
                 Private->Fv[FvCount].PeimState[PeimCount]++;
-                Private->PeimDispatchOnThisPass = TRUE;
+                Private->Fv[FvCount].PeimSucceeded[PeimCount] = TRUE;
+                Private->PeimDispatchOnThisPass               = TRUE;
               } else {
                 //
                 // The related GuidedSectionExtraction/Decompress PPI for the
@@ -1539,7 +1667,14 @@ PeiDispatcher (
                   // Call the PEIM entry point for PEIM driver
                   //
                   PeimEntryPoint = (EFI_PEIM_ENTRY_POINT2)(UINTN)EntryPoint;
-                  PeimEntryPoint (PeimFileHandle, (const EFI_PEI_SERVICES **)PeiServices);
+                  Status         = PeimEntryPoint (PeimFileHandle, (const EFI_PEI_SERVICES **)PeiServices);
+                  if (Private->Fv[FvCount].PeimState[PeimCount] == PEIM_STATE_DISPATCHED) {
+                    //
+                    // A PEIM registered for shadow succeeds on its shadowed call.
+                    //
+                    Private->Fv[FvCount].PeimSucceeded[PeimCount] = (BOOLEAN)(Status == EFI_SUCCESS);
+                  }
+
                   Private->PeimDispatchOnThisPass = TRUE;
                 } else {
                   //
@@ -1605,7 +1740,8 @@ PeiDispatcher (
               }
 
               ASSERT (PeimEntryPoint != NULL);
-              PeimEntryPoint (PeimFileHandle, (const EFI_PEI_SERVICES **)PeiServices);
+              Status                                        = PeimEntryPoint (PeimFileHandle, (const EFI_PEI_SERVICES **)PeiServices);
+              Private->Fv[FvCount].PeimSucceeded[PeimCount] = (BOOLEAN)(Status == EFI_SUCCESS);
               // PERF_END (PeiServices, L"PEIM", PeimFileHandle, 0);
 
               //
@@ -1699,9 +1835,10 @@ DepexSatisfied (
   IN UINTN                PeimCount
   )
 {
-  EFI_STATUS        Status;
-  VOID              *DepexData;
-  EFI_FV_FILE_INFO  FileInfo;
+  EFI_STATUS          Status;
+  VOID                *DepexData;
+  EFI_FV_FILE_INFO    FileInfo;
+  PEI_CORE_FV_HANDLE  *CoreFvHandle;
 
   Status = PeiServicesFfsGetFileInfo (FileHandle, &FileInfo);
   if (EFI_ERROR (Status)) {
@@ -1718,6 +1855,26 @@ DepexSatisfied (
     return TRUE;
   }
 
+  CoreFvHandle = &Private->Fv[Private->CurrentPeimFvCount];
+  if ((PeimCount >= CoreFvHandle->ManifestStart) && (PeimCount < CoreFvHandle->ManifestEnd)) {
+    while ((CoreFvHandle->ManifestNext < PeimCount) &&
+           CoreFvHandle->PeimSucceeded[CoreFvHandle->ManifestNext])
+    {
+      CoreFvHandle->ManifestNext++;
+    }
+
+    if (CoreFvHandle->ManifestNext == PeimCount) {
+      //
+      // The PEIMs before this one in the dispatch manifest were dispatched
+      // successfully, so they installed the PPIs its DEPEX needs. A PEIM that
+      // failed or waits to be shadowed stops the walk, and the PEIMs after it
+      // fall back to their DEPEX.
+      //
+      DEBUG ((DEBUG_DISPATCH, "  RESULT = TRUE (Dispatch Manifest)\n"));
+      return TRUE;
+    }
+  }
+
   //
   // Depex section not in the encapsulated section.
   //
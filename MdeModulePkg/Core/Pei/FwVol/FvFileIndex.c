@@ -0,0 +1,394 @@
+/** @file
+  Index of the FFS files of a firmware volume used by the PEI core.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "FvFileIndex.h"
+
+/**
+  Get the entries of an index.
+
+  @param  Index                  The index.
+
+  @return The entries.
+
+**/
+STATIC
+FV_FILE_INDEX_ENTRY *
+FvFileIndexEntries (
+  IN CONST FV_FILE_INDEX  *Index
+  )
+{
+  return (FV_FILE_INDEX_ENTRY *)(Index + 1);
+}
+
+/**
+  Get the heads of the name chains of an index.
+
+  @param  Index                  The index.
+
+  @return The heads of the name chains.
+
+**/
+STATIC
+UINT16 *
+FvFileIndexNameFirst (
+  IN CONST FV_FILE_INDEX  *Index
+  )
+{
+  return (UINT16 *)(FvFileIndexEntries (Index) + Index->MaxCount);
+}
+
+/**
+  Get the number of name chains of an index of FileCount files: the smallest
+  power of two not below FileCount.
+
+  @param  FileCount              The number of files to index.
+
+  @return The number of name chains.
+
+**/
+STATIC
+UINTN
+FvFileIndexNameBucketCount (
+  IN UINTN  FileCount
+  )
+{
+  if (FileCount <= 1) {
+    return 1;
+  }
+
+  return GetPowerOfTwo32 ((UINT32)(FileCount - 1)) << 1;
+}
+
+/**
+  Get the first 32 bits of a GUID, which the build tools generate at random,
+  so they are both the key compared before the whole name and the hash of the
+  name.
+
+  @param  Name                   The GUID.
+
+  @return The key of the GUID.
+
+**/
+STATIC
+UINT32
+FvFileIndexNameKey (
+  IN CONST EFI_GUID  *Name
+  )
+{
+  return ReadUnaligned32 ((CONST UINT32 *)Name);
+}
+
+/**
+  Check whether a file type matches a search type.
+
+  @param  SearchType             The type of the file, EFI_FV_FILETYPE_ALL, or
+                                 FV_FILE_INDEX_DISPATCH_TYPE.
+  @param  Type                   The type of the file.
+
+  @retval TRUE                   The type matches.
+  @retval FALSE                  The type does not match.
+
+**/
+STATIC
+BOOLEAN
+FvFileIndexTypeMatch (
+  IN EFI_FV_FILETYPE  SearchType,
+  IN EFI_FV_FILETYPE  Type
+  )
+{
+  if (SearchType == EFI_FV_FILETYPE_ALL) {
+    return TRUE;
+  }
+
+  if (SearchType == FV_FILE_INDEX_DISPATCH_TYPE) {
+    return (BOOLEAN)((Type == EFI_FV_FILETYPE_PEIM) ||
+                     (Type == EFI_FV_FILETYPE_COMBINED_PEIM_DRIVER) ||
+                     (Type == EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE));
+  }
+
+  return (BOOLEAN)(SearchType == Type);
+}
+
+/**
+  Get the size of the buffer of an index.
+
+  @param  FileCount              The number of files to index.
+
+  @return The size, in bytes, of the buffer, or 0 if there are too many files.
+
+**/
+UINTN
+FvFileIndexGetSize (
+  IN UINTN  FileCount
+  )
+{
+  if (FileCount > FV_FILE_INDEX_MAX_FILES) {
+    return 0;
+  }
+
+  return sizeof (FV_FILE_INDEX) +
+         FileCount * sizeof (FV_FILE_INDEX_ENTRY) +
+         FvFileIndexNameBucketCount (FileCount) * sizeof (UINT16);
+}
+
+/**
+  Initialize an empty index.
+
+  @param  Index                  Buffer of FvFileIndexGetSize (FileCount) bytes.
+  @param  FileCount              The number of files to index.
+
+**/
+VOID
+FvFileIndexInitialize (
+  OUT FV_FILE_INDEX  *Index,
+  IN  UINTN          FileCount
+  )
+{
+  ASSERT (FileCount <= FV_FILE_INDEX_MAX_FILES);
+
+  Index->Signature       = FV_FILE_INDEX_SIGNATURE;
+  Index->Count           = 0;
+  Index->MaxCount        = (UINT16)FileCount;
+  Index->NameBucketCount = (UINT16)FvFileIndexNameBucketCount (FileCount);
+  Index->Reserved        = 0;
+  SetMem16 (Index->TypeFirst, sizeof (Index->TypeFirst), FV_FILE_INDEX_END);
+  SetMem16 (Index->TypeLast, sizeof (Index->TypeLast), FV_FILE_INDEX_END);
+  SetMem16 (FvFileIndexNameFirst (Index), Index->NameBucketCount * sizeof (UINT16), FV_FILE_INDEX_END);
+}
+
+/**
+  Append a file to an index. Files must be appended in firmware volume order.
+
+  @param  Index                  The index.
+  @param  FileOffset             The offset of the FFS file header from the
+                                 firmware volume header.
+  @param  Name                   The name of the file.
+  @param  Type                   The type of the file.
+
+  @retval TRUE                   The file is appended.
+  @retval FALSE                  The index is full, or the file is not after
+                                 the last file appended.
+
+**/
+BOOLEAN
+FvFileIndexAdd (
+  IN OUT FV_FILE_INDEX    *Index,
+  IN     UINT32           FileOffset,
+  IN     CONST EFI_GUID   *Name,
+  IN     EFI_FV_FILETYPE  Type
+  )
+{
+  FV_FILE_INDEX_ENTRY  *Entries;
+  FV_FILE_INDEX_ENTRY  *Entry;
+  UINT16               *NameFirst;
+  UINT16               EntryIndex;
+  UINTN                Bucket;
+
+  ASSERT (Index->Signature == FV_FILE_INDEX_SIGNATURE);
+
+  Entries = FvFileIndexEntries (Index);
+  if ((Index->Count >= Index->MaxCount) ||
+      ((Index->Count != 0) && (FileOffset <= Entries[Index->Count - 1].FileOffset)) ||
+      (FileOffset == FV_FILE_INDEX_FIRST))
+  {
+    return FALSE;
+  }
+
+  EntryIndex         = Index->Count;
+  Entry              = &Entries[EntryIndex];
+  Entry->FileOffset  = FileOffset;
+  Entry->NameKey     = FvFileIndexNameKey (Name);
+  Entry->NextOfType  = FV_FILE_INDEX_END;
+  Entry->Type        = Type;
+  Entry->Reserved[0] = 0;
+  Entry->Reserved[1] = 0;
+  Entry->Reserved[2] = 0;
+
+  //
+  // The name chains are searched whole, so the entry goes to the head.
+  //
+  NameFirst          = FvFileIndexNameFirst (Index);
+  Bucket             = Entry->NameKey & (Index->NameBucketCount - 1);
+  Entry->NextByName  = NameFirst[Bucket];
+  NameFirst[Bucket]  = EntryIndex;
+
+  //
+  // The type chains are followed in order, so the entry goes to the tail.
+  //
+  if ((Type != EFI_FV_FILETYPE_ALL) && (Type < FV_FILE_INDEX_TYPE_COUNT)) {
+    if (Index->TypeLast[Type] == FV_FILE_INDEX_END) {
+      Index->TypeFirst[Type] = EntryIndex;
+    } else {
+      Entries[Index->TypeLast[Type]].NextOfType = EntryIndex;
+    }
+
+    Index->TypeLast[Type] = EntryIndex;
+  }
+
+  Index->Count++;
+  return TRUE;
+}
+
+/**
+  Find the first file of a name.
+
+  @param  Index                  The index.
+  @param  FvHeader               The firmware volume of the index. The file
+                                 names are compared in the FFS file headers.
+  @param  Name                   The name of the file.
+  @param  FileOffset             The offset of the FFS file header from the
+                                 firmware volume header.
+
+  @retval TRUE                   The file is found.
+  @retval FALSE                  There is no file of that name.
+
+**/
+BOOLEAN
+FvFileIndexFindByName (
+  IN  CONST FV_FILE_INDEX  *Index,
+  IN  CONST VOID           *FvHeader,
+  IN  CONST EFI_GUID       *Name,
+  OUT UINT32               *FileOffset
+  )
+{
+  CONST FV_FILE_INDEX_ENTRY  *Entries;
+  CONST EFI_FFS_FILE_HEADER  *FileHeader;
+  UINT32                     NameKey;
+  UINT16                     EntryIndex;
+  UINT16                     Found;
+
+  ASSERT (Index->Signature == FV_FILE_INDEX_SIGNATURE);
+
+  Entries = FvFileIndexEntries (Index);
+  NameKey = FvFileIndexNameKey (Name);
+  Found   = FV_FILE_INDEX_END;
+
+  //
+  // A name chain runs from the last file to the first one. A firmware volume
+  // may hold several files of a name, and the walk returns the first one, so
+  // the whole chain is searched.
+  //
+  for (EntryIndex = FvFileIndexNameFirst (Index)[NameKey & (Index->NameBucketCount - 1)];
+       EntryIndex != FV_FILE_INDEX_END;
+       EntryIndex = Entries[EntryIndex].NextByName)
+  {
+    if (Entries[EntryIndex].NameKey != NameKey) {
+      continue;
+    }
+
+    FileHeader = (CONST EFI_FFS_FILE_HEADER *)((CONST UINT8 *)FvHeader + Entries[EntryIndex].FileOffset);
+    if (CompareGuid (&FileHeader->Name, Name)) {
+      Found = EntryIndex;
+    }
+  }
+
+  if (Found == FV_FILE_INDEX_END) {
+    return FALSE;
+  }
+
+  *FileOffset = Entries[Found].FileOffset;
+  return TRUE;
+}
+
+/**
+  Find the next file of a type.
+
+  @param  Index                  The index.
+  @param  PreviousOffset         The offset of the file to start the search
+                                 after, or FV_FILE_INDEX_FIRST.
+  @param  SearchType             The type of the file, EFI_FV_FILETYPE_ALL, or
+                                 FV_FILE_INDEX_DISPATCH_TYPE.
+  @param  FileOffset             The offset of the FFS file header from the
+                                 firmware volume header.
+
+  @retval EFI_SUCCESS            The file is found.
+  @retval EFI_NOT_FOUND          There is no more file of that type.
+  @retval EFI_INVALID_PARAMETER  PreviousOffset is not the offset of an indexed
+                                 file.
+
+**/
+EFI_STATUS
+FvFileIndexFindNext (
+  IN  CONST FV_FILE_INDEX  *Index,
+  IN  UINT32               PreviousOffset,
+  IN  EFI_FV_FILETYPE      SearchType,
+  OUT UINT32               *FileOffset
+  )
+{
+  CONST FV_FILE_INDEX_ENTRY  *Entries;
+  UINTN                      Low;
+  UINTN                      High;
+  UINTN                      Middle;
+  UINTN                      Start;
+  UINT16                     EntryIndex;
+
+  ASSERT (Index->Signature == FV_FILE_INDEX_SIGNATURE);
+
+  Entries = FvFileIndexEntries (Index);
+
+  //
+  // The entries are in firmware volume order, so the previous file is found
+  // by a binary search of its offset.
+  //
+  Start = 0;
+  if (PreviousOffset != FV_FILE_INDEX_FIRST) {
+    Low  = 0;
+    High = Index->Count;
+    while (Low < High) {
+      Middle = (Low + High) / 2;
+      if (Entries[Middle].FileOffset < PreviousOffset) {
+        Low = Middle + 1;
+      } else {
+        High = Middle;
+      }
+    }
+
+    if ((Low == Index->Count) || (Entries[Low].FileOffset != PreviousOffset)) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Start = Low + 1;
+  }
+
+  if ((SearchType != EFI_FV_FILETYPE_ALL) && (SearchType < FV_FILE_INDEX_TYPE_COUNT)) {
+    //
+    // Follow the type chain when the search starts at the first file, or
+    // after a file of the same type, as it does when the files of a type are
+    // enumerated.
+    //
+    if (Start == 0) {
+      EntryIndex = Index->TypeFirst[SearchType];
+    } else if (Entries[Start - 1].Type == SearchType) {
+      EntryIndex = Entries[Start - 1].NextOfType;
+    } else {
+      EntryIndex = FV_FILE_INDEX_END;
+      for ( ; Start < Index->Count; Start++) {
+        if (Entries[Start].Type == SearchType) {
+          EntryIndex = (UINT16)Start;
+          break;
+        }
+      }
+    }
+
+    if (EntryIndex == FV_FILE_INDEX_END) {
+      return EFI_NOT_FOUND;
+    }
+
+    *FileOffset = Entries[EntryIndex].FileOffset;
+    return EFI_SUCCESS;
+  }
+
+  for ( ; Start < Index->Count; Start++) {
+    if (FvFileIndexTypeMatch (SearchType, Entries[Start].Type)) {
+      *FileOffset = Entries[Start].FileOffset;
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_NOT_FOUND;
+}
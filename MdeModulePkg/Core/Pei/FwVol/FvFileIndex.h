@@ -0,0 +1,182 @@
+/** @file
+  Index of the FFS files of a firmware volume used by the PEI core to find
+  files without walking the firmware volume.
+
+  The index is built once, when the PEI core registers the firmware volume,
+  from the files a walk of the whole volume returns, in volume order. Each
+  entry records the offset of the file from the firmware volume header, so
+  the index stays valid when the firmware volume is migrated, and the index
+  holds no pointer, so it can be migrated to permanent memory like any other
+  PEI core pool. The entries are chained by name hash and, for the file types
+  0x01 - 0x0F, by type.
+
+  Pad files are not indexed: a search by type never returns them, and they
+  are not searched by name.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _FV_FILE_INDEX_H_
+#define _FV_FILE_INDEX_H_
+
+#include <PiPei.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+
+#define FV_FILE_INDEX_SIGNATURE  SIGNATURE_32('F','F','I','X')
+
+///
+/// Search type matching the PEIM, combined PEIM/driver and firmware volume
+/// image files. It has the value of PEI_CORE_INTERNAL_FFS_FILE_DISPATCH_TYPE.
+///
+#define FV_FILE_INDEX_DISPATCH_TYPE  0xFF
+
+///
+/// Previous file offset that starts a search at the first file.
+///
+#define FV_FILE_INDEX_FIRST  MAX_UINT32
+
+///
+/// Maximum number of files of an index. Larger firmware volumes are walked.
+///
+#define FV_FILE_INDEX_MAX_FILES  0xFFFE
+
+///
+/// End of an entry chain.
+///
+#define FV_FILE_INDEX_END  0xFFFF
+
+///
+/// Number of file types chained by type, starting at type 0x00 which is not
+/// used.
+///
+#define FV_FILE_INDEX_TYPE_COUNT  0x10
+
+typedef struct {
+  ///
+  /// Offset of the FFS file header from the firmware volume header.
+  ///
+  UINT32    FileOffset;
+  ///
+  /// First 32 bits of the file name.
+  ///
+  UINT32    NameKey;
+  UINT16    NextByName;
+  UINT16    NextOfType;
+  UINT8     Type;
+  UINT8     Reserved[3];
+} FV_FILE_INDEX_ENTRY;
+
+///
+/// An index is one buffer: this header, then the MaxCount entries, then the
+/// NameBucketCount heads of the name chains.
+///
+typedef struct {
+  UINT32    Signature;
+  UINT16    Count;
+  UINT16    MaxCount;
+  UINT16    NameBucketCount;
+  UINT16    Reserved;
+  UINT16    TypeFirst[FV_FILE_INDEX_TYPE_COUNT];
+  UINT16    TypeLast[FV_FILE_INDEX_TYPE_COUNT];
+} FV_FILE_INDEX;
+
+/**
+  Get the size of the buffer of an index.
+
+  @param  FileCount              The number of files to index.
+
+  @return The size, in bytes, of the buffer, or 0 if there are too many files.
+
+**/
+UINTN
+FvFileIndexGetSize (
+  IN UINTN  FileCount
+  );
+
+/**
+  Initialize an empty index.
+
+  @param  Index                  Buffer of FvFileIndexGetSize (FileCount) bytes.
+  @param  FileCount              The number of files to index.
+
+**/
+VOID
+FvFileIndexInitialize (
+  OUT FV_FILE_INDEX  *Index,
+  IN  UINTN          FileCount
+  );
+
+/**
+  Append a file to an index. Files must be appended in firmware volume order.
+
+  @param  Index                  The index.
+  @param  FileOffset             The offset of the FFS file header from the
+                                 firmware volume header.
+  @param  Name                   The name of the file.
+  @param  Type                   The type of the file.
+
+  @retval TRUE                   The file is appended.
+  @retval FALSE                  The index is full, or the file is not after
+                                 the last file appended.
+
+**/
+BOOLEAN
+FvFileIndexAdd (
+  IN OUT FV_FILE_INDEX    *Index,
+  IN     UINT32           FileOffset,
+  IN     CONST EFI_GUID   *Name,
+  IN     EFI_FV_FILETYPE  Type
+  );
+
+/**
+  Find the first file of a name.
+
+  @param  Index                  The index.
+  @param  FvHeader               The firmware volume of the index. The file
+                                 names are compared in the FFS file headers.
+  @param  Name                   The name of the file.
+  @param  FileOffset             The offset of the FFS file header from the
+                                 firmware volume header.
+
+  @retval TRUE                   The file is found.
+  @retval FALSE                  There is no file of that name.
+
+**/
+BOOLEAN
+FvFileIndexFindByName (
+  IN  CONST FV_FILE_INDEX  *Index,
+  IN  CONST VOID           *FvHeader,
+  IN  CONST EFI_GUID       *Name,
+  OUT UINT32               *FileOffset
+  );
+
+/**
+  Find the next file of a type.
+
+  @param  Index                  The index.
+  @param  PreviousOffset         The offset of the file to start the search
+                                 after, or FV_FILE_INDEX_FIRST.
+  @param  SearchType             The type of the file, EFI_FV_FILETYPE_ALL, or
+                                 FV_FILE_INDEX_DISPATCH_TYPE.
+  @param  FileOffset             The offset of the FFS file header from the
+                                 firmware volume header.
+
+  @retval EFI_SUCCESS            The file is found.
+  @retval EFI_NOT_FOUND          There is no more file of that type.
+  @retval EFI_INVALID_PARAMETER  PreviousOffset is not the offset of an indexed
+                                 file.
+
+**/
+EFI_STATUS
+FvFileIndexFindNext (
+  IN  CONST FV_FILE_INDEX  *Index,
+  IN  UINT32               PreviousOffset,
+  IN  EFI_FV_FILETYPE      SearchType,
+  OUT UINT32               *FileOffset
+  );
+
+#endif
@@ -2,7 +2,7 @@
   Pei Core Firmware File System service routines.
 
 Copyright (c) 2015 HP Development Company, L.P.
-Copyright (c) 2006 - 2019, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -243,6 +243,70 @@ FileHandleToVolume (
   return NULL;
 }
 
+STATIC_ASSERT (
+  FV_FILE_INDEX_DISPATCH_TYPE == PEI_CORE_INTERNAL_FFS_FILE_DISPATCH_TYPE,
+  "The dispatch search types of the FV file index and of the PEI core differ"
+  );
+
+/**
+  Search for a file in the file index of a firmware volume.
+
+  @param FileIndex       The file index of the firmware volume.
+  @param FvHandle        Pointer to the FV header of the volume to search
+  @param FileName        File name
+  @param SearchType      Filter to find only files of this type.
+  @param FileHandle      On input, the file to start the search after, or NULL.
+                         On output, the file found, or NULL.
+
+  @retval EFI_SUCCESS            The file was found.
+  @retval EFI_NOT_FOUND          No files matching the search criteria were found.
+  @retval EFI_INVALID_PARAMETER  The file to start the search after is not
+                                 indexed. The volume must be walked.
+
+**/
+STATIC
+EFI_STATUS
+FindFileInIndex (
+  IN CONST  FV_FILE_INDEX        *FileIndex,
+  IN CONST  EFI_PEI_FV_HANDLE    FvHandle,
+  IN CONST  EFI_GUID             *FileName    OPTIONAL,
+  IN        EFI_FV_FILETYPE      SearchType,
+  IN OUT    EFI_PEI_FILE_HANDLE  *FileHandle
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      FileOffset;
+  UINTN       PreviousOffset;
+
+  if (FileName != NULL) {
+    if (!FvFileIndexFindByName (FileIndex, FvHandle, FileName, &FileOffset)) {
+      *FileHandle = NULL;
+      return EFI_NOT_FOUND;
+    }
+  } else {
+    if (*FileHandle == NULL) {
+      PreviousOffset = FV_FILE_INDEX_FIRST;
+    } else {
+      PreviousOffset = (UINTN)*FileHandle - (UINTN)FvHandle;
+      if (PreviousOffset >= ((EFI_FIRMWARE_VOLUME_HEADER *)FvHandle)->FvLength) {
+        return EFI_INVALID_PARAMETER;
+      }
+    }
+
+    Status = FvFileIndexFindNext (FileIndex, (UINT32)PreviousOffset, SearchType, &FileOffset);
+    if (Status == EFI_NOT_FOUND) {
+      *FileHandle = NULL;
+    }
+
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  *FileHandle = (EFI_PEI_FILE_HANDLE)((UINT8 *)FvHandle + FileOffset);
+  return EFI_SUCCESS;
+}
+
 /**
   Given the input file pointer, search for the first matching file in the
   FFS volume as defined by SearchType. The search starts from FileHeader inside
@@ -283,6 +347,22 @@ FindFileEx (
   UINT8                           FileState;
   UINT8                           DataCheckSum;
   BOOLEAN                         IsFfs3Fv;
+  PEI_CORE_FV_HANDLE              *CoreFvHandle;
+  EFI_STATUS                      Status;
+
+  //
+  // Search the file index of the FV if it has one. The index does not record
+  // the apriori file, so the FV is walked when it is requested.
+  //
+  if (AprioriFile == NULL) {
+    CoreFvHandle = FvHandleToCoreHandle (FvHandle);
+    if ((CoreFvHandle != NULL) && (CoreFvHandle->FileIndex != NULL)) {
+      Status = FindFileInIndex (CoreFvHandle->FileIndex, FvHandle, FileName, SearchType, FileHandle);
+      if (Status != EFI_INVALID_PARAMETER) {
+        return Status;
+      }
+    }
+  }
 
   //
   // Convert the handle of FV to FV header for memory-mapped firmware volume
@@ -455,6 +535,87 @@ FindFileEx (
   return EFI_NOT_FOUND;
 }
 
+/**
+  Build the file index of a firmware volume registered in the PEI core.
+
+  The index is built from the files a walk of the whole volume returns, so a
+  search in the index finds the files a walk would find. If the volume is not
+  handled by the firmware volume PPI of the PEI core, if it holds too many
+  files, or if memory runs out, the volume keeps being walked.
+
+  @param CoreFvHandle    The firmware volume.
+
+**/
+STATIC
+VOID
+BuildFvFileIndex (
+  IN OUT PEI_CORE_FV_HANDLE  *CoreFvHandle
+  )
+{
+  EFI_PEI_FILE_HANDLE  FileHandle;
+  EFI_FFS_FILE_HEADER  *FileHeader;
+  FV_FILE_INDEX        *FileIndex;
+  UINTN                FileCount;
+  UINTN                Size;
+
+  if (!PcdGetBool (PcdPeiCoreFvFileIndex)) {
+    return;
+  }
+
+  if ((CoreFvHandle->FvPpi != &mPeiFfs2FwVol.Fv) && (CoreFvHandle->FvPpi != &mPeiFfs3FwVol.Fv)) {
+    return;
+  }
+
+  ASSERT (CoreFvHandle->FileIndex == NULL);
+
+  PERF_INMODULE_BEGIN ("FvFileIndex");
+
+  //
+  // Count the files, then index them.
+  //
+  FileCount  = 0;
+  FileHandle = NULL;
+  while (!EFI_ERROR (FindFileEx (CoreFvHandle->FvHandle, NULL, EFI_FV_FILETYPE_ALL, &FileHandle, NULL))) {
+    FileCount++;
+  }
+
+  Size      = FvFileIndexGetSize (FileCount);
+  FileIndex = NULL;
+  if (Size != 0) {
+    FileIndex = AllocatePool (Size);
+  }
+
+  if (FileIndex != NULL) {
+    FvFileIndexInitialize (FileIndex, FileCount);
+    FileHandle = NULL;
+    while (!EFI_ERROR (FindFileEx (CoreFvHandle->FvHandle, NULL, EFI_FV_FILETYPE_ALL, &FileHandle, NULL))) {
+      FileHeader = (EFI_FFS_FILE_HEADER *)FileHandle;
+      if (!FvFileIndexAdd (
+             FileIndex,
+             (UINT32)((UINTN)FileHeader - (UINTN)CoreFvHandle->FvHandle),
+             &FileHeader->Name,
+             FileHeader->Type
+             ))
+      {
+        FileIndex = NULL;
+        break;
+      }
+    }
+  }
+
+  CoreFvHandle->FileIndex = FileIndex;
+
+  PERF_INMODULE_END ("FvFileIndex");
+
+  DEBUG ((
+    DEBUG_INFO,
+    "FV %p: %a %d files\n",
+    CoreFvHandle->FvHandle,
+    (FileIndex != NULL) ? "indexed" : "cannot index",
+    (UINT32)FileCount
+    ));
+}
+
 /**
   Initialize PeiCore FV List.
 
@@ -526,6 +687,7 @@ PeiInitializeFv (
     FvHandle
     ));
   PrivateData->FvCount++;
+  BuildFvFileIndex (&PrivateData->Fv[PrivateData->FvCount - 1]);
 
   //
   // Post a call-back for the FvInfoPPI and FvInfo2PPI services to expose
@@ -668,6 +830,7 @@ FirmwareVolumeInfoPpiNotifyCallback (
       FvHandle
       ));
     PrivateData->FvCount++;
+    BuildFvFileIndex (&PrivateData->Fv[CurFvCount]);
 
     //
     // Scan and process the new discovered FV for EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE
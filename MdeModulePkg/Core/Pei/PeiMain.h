@@ -1,7 +1,7 @@
 /** @file
   Definition of Pei Core Structures and Services
 
-Copyright (c) 2006 - 2019, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -44,8 +44,11 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/FirmwareFileSystem2.h>
 #include <Guid/FirmwareFileSystem3.h>
 #include <Guid/AprioriFileName.h>
+#include <Guid/DispatchManifest.h>
 #include <Guid/MigratedFvInfo.h>
 
+#include "FwVol/FvFileIndex.h"
+
 ///
 /// It is an FFS type extension used for PeiFindFileEx. It indicates current
 /// FFS searching is for all PEIMs can be dispatched by PeiCore.
@@ -141,11 +144,29 @@ typedef struct {
   //
   UINT8                          *PeimState;
   //
+  // Pointer to the buffer with the PeimCount number of Entries, TRUE once
+  // the last entry point call of the PEIM returned EFI_SUCCESS.
+  //
+  BOOLEAN                        *PeimSucceeded;
+  //
   // Pointer to the buffer with the PeimCount number of Entries.
   //
   EFI_PEI_FILE_HANDLE            *FvFileHandles;
   BOOLEAN                        ScanFv;
   UINT32                         AuthenticationStatus;
+  //
+  // FvFileHandles[ManifestStart] to FvFileHandles[ManifestEnd - 1] are
+  // ordered by the dispatch manifest of the FV. The PEIMs of that range before
+  // ManifestNext are known to be dispatched successfully.
+  //
+  UINTN                          ManifestStart;
+  UINTN                          ManifestEnd;
+  UINTN                          ManifestNext;
+  //
+  // Index of the FFS files of the FV, or NULL if the FV is walked on every
+  // file search.
+  //
+  FV_FILE_INDEX                  *FileIndex;
 } PEI_CORE_FV_HANDLE;
 
 typedef struct {
@@ -1,7 +1,7 @@
 /** @file
   Pei Core Main Entry Point
 
-Copyright (c) 2006 - 2019, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -233,9 +233,17 @@ PeiCore (
             OldCoreData->Fv[Index].PeimState = (UINT8 *)OldCoreData->Fv[Index].PeimState + OldCoreData->HeapOffset;
           }
 
+          if (OldCoreData->Fv[Index].PeimSucceeded != NULL) {
+            OldCoreData->Fv[Index].PeimSucceeded = (BOOLEAN *)((UINT8 *)OldCoreData->Fv[Index].PeimSucceeded + OldCoreData->HeapOffset);
+          }
+
           if (OldCoreData->Fv[Index].FvFileHandles != NULL) {
             OldCoreData->Fv[Index].FvFileHandles = (EFI_PEI_FILE_HANDLE *)((UINT8 *)OldCoreData->Fv[Index].FvFileHandles + OldCoreData->HeapOffset);
           }
+
+          if (OldCoreData->Fv[Index].FileIndex != NULL) {
+            OldCoreData->Fv[Index].FileIndex = (FV_FILE_INDEX *)((UINT8 *)OldCoreData->Fv[Index].FileIndex + OldCoreData->HeapOffset);
+          }
         }
 
         OldCoreData->TempFileGuid    = (EFI_GUID *)((UINT8 *)OldCoreData->TempFileGuid + OldCoreData->HeapOffset);
@@ -268,9 +276,17 @@ PeiCore (
             OldCoreData->Fv[Index].PeimState = (UINT8 *)OldCoreData->Fv[Index].PeimState - OldCoreData->HeapOffset;
           }
 
+          if (OldCoreData->Fv[Index].PeimSucceeded != NULL) {
+            OldCoreData->Fv[Index].PeimSucceeded = (BOOLEAN *)((UINT8 *)OldCoreData->Fv[Index].PeimSucceeded - OldCoreData->HeapOffset);
+          }
+
           if (OldCoreData->Fv[Index].FvFileHandles != NULL) {
             OldCoreData->Fv[Index].FvFileHandles = (EFI_PEI_FILE_HANDLE *)((UINT8 *)OldCoreData->Fv[Index].FvFileHandles - OldCoreData->HeapOffset);
           }
+
+          if (OldCoreData->Fv[Index].FileIndex != NULL) {
+            OldCoreData->Fv[Index].FileIndex = (FV_FILE_INDEX *)((UINT8 *)OldCoreData->Fv[Index].FileIndex - OldCoreData->HeapOffset);
+          }
         }
 
         OldCoreData->TempFileGuid    = (EFI_GUID *)((UINT8 *)OldCoreData->TempFileGuid - OldCoreData->HeapOffset);
@@ -0,0 +1,56 @@
+/** @file
+  Dispatch manifest file of a firmware volume.
+
+  The dispatch manifest is an optional FREEFORM file of a firmware volume,
+  generated by GenFds for an FV that sets FvDispatchManifest = TRUE in the FDF.
+  Its RAW section holds an EDKII_DISPATCH_MANIFEST header followed by the file
+  names of drivers of the FV, in a dispatch order computed at build time: the
+  dependency expression of each driver is satisfied by the protocols or PPIs
+  that the drivers before it in the manifest always produce, per the usage
+  comments of their INF files.
+
+  The dispatchers may dispatch the drivers of the manifest in that order without
+  evaluating their dependency expression, as long as every driver before them in
+  the manifest was dispatched. Drivers not in the manifest, and the drivers of
+  the manifest once that does not hold, are dispatched by evaluating their
+  dependency expression.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_DISPATCH_MANIFEST_GUID_H__
+#define __EDKII_DISPATCH_MANIFEST_GUID_H__
+
+///
+/// File name of the dispatch manifest of the DXE drivers of an FV.
+///
+#define EDKII_DXE_DISPATCH_MANIFEST_FILE_GUID \
+  { 0xd4e49c3a, 0x7e64, 0x4b4c, { 0x96, 0x55, 0xea, 0x79, 0x27, 0x16, 0xd2, 0xdb } }
+
+///
+/// File name of the dispatch manifest of the PEIMs of an FV.
+///
+#define EDKII_PEI_DISPATCH_MANIFEST_FILE_GUID \
+  { 0x14766722, 0x1c46, 0x401a, { 0xa4, 0xa5, 0xb4, 0x1f, 0x51, 0x61, 0x96, 0x66 } }
+
+#define EDKII_DISPATCH_MANIFEST_SIGNATURE  SIGNATURE_32 ('D', 'M', 'A', 'N')
+#define EDKII_DISPATCH_MANIFEST_VERSION    1
+
+typedef struct {
+  UINT32    Signature;
+  UINT16    Version;
+  ///
+  /// Offset of the first file name, from the start of the header.
+  ///
+  UINT16    HeaderSize;
+  UINT32    EntryCount;
+  UINT32    Reserved;
+  // EFI_GUID  FileName[EntryCount];
+} EDKII_DISPATCH_MANIFEST;
+
+extern EFI_GUID  gEdkiiDxeDispatchManifestFileGuid;
+extern EFI_GUID  gEdkiiPeiDispatchManifestFileGuid;
+
+#endif // #ifndef __EDKII_DISPATCH_MANIFEST_GUID_H__
@@ -1,7 +1,7 @@
 /** @file
   Lzma Custom decompress algorithm Guid definition.
 
-Copyright (c) 2009 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2009 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -23,7 +23,44 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define LZMAF86_CUSTOM_DECOMPRESS_GUID  \
   { 0xD42AE6BD, 0x1352, 0x4bfb, { 0x90, 0x9A, 0xCA, 0x72, 0xA6, 0xEA, 0xE8, 0x89 } }
 
+///
+/// The Global ID used to identify a section of an FFS file of type
+/// EFI_SECTION_GUID_DEFINED, whose contents have been split into fixed size
+/// chunks that are compressed using LZMA independently of each other.
+///
+#define LZMA_CHUNKED_CUSTOM_DECOMPRESS_GUID  \
+  { 0x5B1D2E7A, 0x9C43, 0x4F08, { 0xA6, 0xE2, 0x3D, 0x8B, 0x71, 0xC0, 0x4F, 0x95 } }
+
+#define LZMA_CHUNKED_SIGNATURE  SIGNATURE_32 ('L', 'Z', 'C', 'K')
+
+#pragma pack(1)
+
+///
+/// Header of the data in a chunked LZMA GUIDed section. It is followed by
+/// ChunkCount LZMA_CHUNK_ENTRY structures. Every chunk decompresses to
+/// ChunkSize bytes, except the last one that holds the remainder of
+/// DecompressedSize. The compressed data of each chunk is a regular LZMA
+/// stream, including the LZMA properties and the decompressed size.
+///
+typedef struct {
+  UINT32    Signature;
+  UINT32    ChunkCount;
+  UINT32    ChunkSize;
+  UINT32    DecompressedSize;
+} LZMA_CHUNKED_HEADER;
+
+typedef struct {
+  ///
+  /// Offset of the compressed chunk from the start of LZMA_CHUNKED_HEADER.
+  ///
+  UINT32    Offset;
+  UINT32    CompressedSize;
+} LZMA_CHUNK_ENTRY;
+
+#pragma pack()
+
 extern GUID  gLzmaCustomDecompressGuid;
 extern GUID  gLzmaF86CustomDecompressGuid;
+extern GUID  gLzmaChunkedCustomDecompressGuid;
 
 #endif
@@ -1,7 +1,7 @@
 /** @file
   Guid for Pcd DataBase Signature.
 
-Copyright (c) 2012 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2012 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -48,6 +48,14 @@ typedef UINT64 SKU_ID;
 
 #define PCD_DATABASE_OFFSET_MASK  (~(PCD_TYPE_ALL_SET | PCD_DATUM_TYPE_ALL_SET | PCD_DATUM_TYPE_UINT8_BOOLEAN))
 
+//
+// Value of the ExMapAttributes field of the PCD database when the ExMapTable is
+// sorted by ExGuidIndex, then by ExTokenNumber. The PCD drivers then look up
+// a DynamicEx PCD with a binary search. Databases built by older tools store a
+// pad byte in this field and have their ExMapTable searched linearly.
+//
+#define PCD_EXMAP_SORTED  0x01
+
 typedef struct  {
   UINT32    ExTokenNumber;
   UINT16    TokenNumber;        // Token Number for Dynamic-Ex PCD.
@@ -96,7 +104,8 @@ typedef struct {
   UINT16          LocalTokenCount;              // LOCAL_TOKEN_NUMBER for all.
   UINT16          ExTokenCount;                 // EX_TOKEN_NUMBER for DynamicEx.
   UINT16          GuidTableCount;               // The Number of Guid in GuidTable.
-  UINT8           Pad[6];                       // Pad bytes to satisfy the alignment.
+  UINT8           ExMapAttributes;              // PCD_EXMAP_SORTED if ExMapTable is sorted.
+  UINT8           Pad[5];                       // Pad bytes to satisfy the alignment.
 
   //
   // Default initialized external PCD database binary structure
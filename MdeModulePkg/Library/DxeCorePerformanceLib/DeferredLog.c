@@ -0,0 +1,199 @@
+/** @file
+  Deferred log of performance measurements for DxeCorePerformanceLib.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DeferredLog.h"
+
+/**
+  Initialize a deferred log over a buffer of slots.
+
+  @param  Log                    The log to initialize.
+  @param  Records                Buffer of Capacity zeroed slots.
+  @param  Capacity               Number of slots in Records. Only the largest
+                                 power of two not above Capacity is used, so
+                                 the claim counters can wrap around.
+  @param  CountUp                TRUE if the performance counter counts up.
+
+**/
+VOID
+DeferredLogInitialize (
+  OUT DEFERRED_LOG     *Log,
+  IN  DEFERRED_RECORD  *Records,
+  IN  UINT32           Capacity,
+  IN  BOOLEAN          CountUp
+  )
+{
+  Log->Records  = Records;
+  Log->Capacity = GetPowerOfTwo32 (Capacity);
+  Log->Claimed  = 0;
+  Log->Released = 0;
+  Log->Dropped  = 0;
+  Log->CountUp  = CountUp;
+}
+
+/**
+  Copy a performance measurement into the next free slot of a deferred log.
+
+  This function does not take any lock and does not call any boot service,
+  so it may be called from APs.
+
+  @param  Log                    The log.
+  @param  CallerIdentifier       Image handle or pointer to caller ID GUID.
+  @param  Guid                   Pointer to a GUID, or NULL.
+  @param  String                 Pointer to a string describing the measurement,
+                                 or NULL. Only its first
+                                 FPDT_STRING_EVENT_RECORD_NAME_LENGTH - 1
+                                 characters are kept.
+  @param  Ticker                 Value of the performance counter when the
+                                 measurement was taken, or 1 for no time stamp.
+  @param  Address                Pointer to a location in memory relevant to the
+                                 measurement.
+  @param  PerfId                 Performance identifier of the measurement.
+  @param  Attribute              The attribute of the measurement.
+  @param  EntryTicker            Value of the performance counter when the
+                                 performance library was called, used to
+                                 measure the cost of logging.
+
+  @retval EFI_SUCCESS            The measurement was logged.
+  @retval EFI_OUT_OF_RESOURCES   The log is full. The measurement is dropped
+                                 and counted in Log->Dropped.
+
+**/
+EFI_STATUS
+DeferredLogAppend (
+  IN OUT DEFERRED_LOG                *Log,
+  IN     CONST VOID                  *CallerIdentifier OPTIONAL,
+  IN     CONST VOID                  *Guid             OPTIONAL,
+  IN     CONST CHAR8                 *String           OPTIONAL,
+  IN     UINT64                      Ticker,
+  IN     UINT64                      Address,
+  IN     UINT16                      PerfId,
+  IN     PERF_MEASUREMENT_ATTRIBUTE  Attribute,
+  IN     UINT64                      EntryTicker
+  )
+{
+  UINT32           Claimed;
+  DEFERRED_RECORD  *Record;
+  UINTN            Index;
+  UINT8            Flags;
+  UINT64           ExitTicker;
+  UINT64           Cost;
+
+  //
+  // Claim the next slot, unless all slots hold records the BSP did not
+  // release yet.
+  //
+  do {
+    Claimed = Log->Claimed;
+    if (Claimed - Log->Released >= Log->Capacity) {
+      InterlockedIncrement (&Log->Dropped);
+      return EFI_OUT_OF_RESOURCES;
+    }
+  } while (InterlockedCompareExchange32 (&Log->Claimed, Claimed, Claimed + 1) != Claimed);
+
+  Record = &Log->Records[Claimed % Log->Capacity];
+
+  Flags                    = 0;
+  Record->CallerIdentifier = CallerIdentifier;
+  Record->Ticker           = Ticker;
+  Record->Address          = Address;
+  Record->PerfId           = PerfId;
+  Record->Attribute        = (UINT8)Attribute;
+
+  //
+  // The event signal and callback measurements identify their caller by a
+  // GUID, which is copied in case the caller is unloaded before the record
+  // is drained.
+  //
+  if ((CallerIdentifier != NULL) &&
+      ((PerfId == PERF_EVENTSIGNAL_START_ID) || (PerfId == PERF_EVENTSIGNAL_END_ID) ||
+       (PerfId == PERF_CALLBACK_START_ID) || (PerfId == PERF_CALLBACK_END_ID)))
+  {
+    CopyGuid (&Record->CallerGuid, CallerIdentifier);
+    Flags |= DEFERRED_RECORD_CALLER_GUID;
+  }
+
+  if (Guid != NULL) {
+    CopyGuid (&Record->Guid, Guid);
+    Flags |= DEFERRED_RECORD_GUID;
+  }
+
+  if (String != NULL) {
+    for (Index = 0; Index < sizeof (Record->String) - 1 && String[Index] != '\0'; Index++) {
+      Record->String[Index] = String[Index];
+    }
+
+    Record->String[Index] = '\0';
+    Flags                |= DEFERRED_RECORD_STRING;
+  }
+
+  ExitTicker = GetPerformanceCounter ();
+  if (Log->CountUp) {
+    Cost = ExitTicker - EntryTicker;
+  } else {
+    Cost = EntryTicker - ExitTicker;
+  }
+
+  Record->Cost = (Cost > MAX_UINT32) ? MAX_UINT32 : (UINT32)Cost;
+
+  //
+  // Publish the record only once all its fields are written.
+  //
+  MemoryFence ();
+  Record->Flags = Flags | DEFERRED_RECORD_COMMITTED;
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the oldest record of a deferred log.
+
+  @param  Log                    The log.
+
+  @return The record, or NULL if the log is empty or if the oldest record is
+          still being written.
+
+**/
+DEFERRED_RECORD *
+DeferredLogFirst (
+  IN DEFERRED_LOG  *Log
+  )
+{
+  DEFERRED_RECORD  *Record;
+
+  if (Log->Released == Log->Claimed) {
+    return NULL;
+  }
+
+  Record = &Log->Records[Log->Released % Log->Capacity];
+  if ((Record->Flags & DEFERRED_RECORD_COMMITTED) == 0) {
+    return NULL;
+  }
+
+  MemoryFence ();
+  return Record;
+}
+
+/**
+  Release the oldest record of a deferred log, so its slot can be reused.
+
+  @param  Log                    The log.
+  @param  Record                 The record returned by DeferredLogFirst().
+
+**/
+VOID
+DeferredLogRelease (
+  IN OUT DEFERRED_LOG     *Log,
+  IN OUT DEFERRED_RECORD  *Record
+  )
+{
+  ASSERT (Record == &Log->Records[Log->Released % Log->Capacity]);
+  ASSERT ((Record->Flags & DEFERRED_RECORD_COMMITTED) != 0);
+
+  Record->Flags = 0;
+  MemoryFence ();
+  InterlockedIncrement (&Log->Released);
+}
@@ -0,0 +1,165 @@
+/** @file
+  Deferred log of performance measurements for DxeCorePerformanceLib.
+
+  In the deferred mode, a performance measurement only copies its arguments
+  into a fixed size slot of a ring preallocated by the library constructor.
+  Slots are claimed with an interlocked compare exchange, so measurements can
+  be logged without a lock and from MP callbacks. The image handles are only
+  resolved to module names and GUIDs, and the FPDT records only built, when
+  the ring is drained on the BSP.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _DEFERRED_LOG_H_
+#define _DEFERRED_LOG_H_
+
+#include <Uefi.h>
+#include <Guid/ExtendedFirmwarePerformance.h>
+#include <Guid/PerformanceMeasurement.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/PerformanceLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/TimerLib.h>
+
+//
+// Flags of a deferred record.
+//
+#define DEFERRED_RECORD_COMMITTED    BIT0
+#define DEFERRED_RECORD_GUID         BIT1
+#define DEFERRED_RECORD_STRING       BIT2
+#define DEFERRED_RECORD_CALLER_GUID  BIT3
+
+///
+/// Copy of the arguments of one performance measurement.
+///
+typedef struct {
+  ///
+  /// Image or controller handle of the caller. It is not used when the caller
+  /// identifier is a GUID, see CallerGuid.
+  ///
+  CONST VOID    *CallerIdentifier;
+  UINT64        Ticker;
+  UINT64        Address;
+  EFI_GUID      CallerGuid;
+  EFI_GUID      Guid;
+  CHAR8         String[FPDT_STRING_EVENT_RECORD_NAME_LENGTH];
+  ///
+  /// Performance counter ticks spent to log the measurement.
+  ///
+  UINT32        Cost;
+  UINT16        PerfId;
+  UINT8         Attribute;
+  UINT8         Flags;
+} DEFERRED_RECORD;
+
+///
+/// Ring of deferred records. Any processor may append a record, only the BSP
+/// removes them. A zero initialized DEFERRED_LOG has no slot and drops every
+/// record.
+///
+typedef struct {
+  DEFERRED_RECORD    *Records;
+  UINT32             Capacity;
+  ///
+  /// Number of slots claimed and number of slots released since the log was
+  /// initialized. The slot of a record is its claim number modulo Capacity.
+  ///
+  volatile UINT32    Claimed;
+  volatile UINT32    Released;
+  volatile UINT32    Dropped;
+  BOOLEAN            CountUp;
+} DEFERRED_LOG;
+
+/**
+  Initialize a deferred log over a buffer of slots.
+
+  @param  Log                    The log to initialize.
+  @param  Records                Buffer of Capacity zeroed slots.
+  @param  Capacity               Number of slots in Records. Only the largest
+                                 power of two not above Capacity is used, so
+                                 the claim counters can wrap around.
+  @param  CountUp                TRUE if the performance counter counts up.
+
+**/
+VOID
+DeferredLogInitialize (
+  OUT DEFERRED_LOG     *Log,
+  IN  DEFERRED_RECORD  *Records,
+  IN  UINT32           Capacity,
+  IN  BOOLEAN          CountUp
+  );
+
+/**
+  Copy a performance measurement into the next free slot of a deferred log.
+
+  This function does not take any lock and does not call any boot service,
+  so it may be called from APs.
+
+  @param  Log                    The log.
+  @param  CallerIdentifier       Image handle or pointer to caller ID GUID.
+  @param  Guid                   Pointer to a GUID, or NULL.
+  @param  String                 Pointer to a string describing the measurement,
+                                 or NULL. Only its first
+                                 FPDT_STRING_EVENT_RECORD_NAME_LENGTH - 1
+                                 characters are kept.
+  @param  Ticker                 Value of the performance counter when the
+                                 measurement was taken, or 1 for no time stamp.
+  @param  Address                Pointer to a location in memory relevant to the
+                                 measurement.
+  @param  PerfId                 Performance identifier of the measurement.
+  @param  Attribute              The attribute of the measurement.
+  @param  EntryTicker            Value of the performance counter when the
+                                 performance library was called, used to
+                                 measure the cost of logging.
+
+  @retval EFI_SUCCESS            The measurement was logged.
+  @retval EFI_OUT_OF_RESOURCES   The log is full. The measurement is dropped
+                                 and counted in Log->Dropped.
+
+**/
+EFI_STATUS
+DeferredLogAppend (
+  IN OUT DEFERRED_LOG                *Log,
+  IN     CONST VOID                  *CallerIdentifier OPTIONAL,
+  IN     CONST VOID                  *Guid             OPTIONAL,
+  IN     CONST CHAR8                 *String           OPTIONAL,
+  IN     UINT64                      Ticker,
+  IN     UINT64                      Address,
+  IN     UINT16                      PerfId,
+  IN     PERF_MEASUREMENT_ATTRIBUTE  Attribute,
+  IN     UINT64                      EntryTicker
+  );
+
+/**
+  Get the oldest record of a deferred log.
+
+  @param  Log                    The log.
+
+  @return The record, or NULL if the log is empty or if the oldest record is
+          still being written.
+
+**/
+DEFERRED_RECORD *
+DeferredLogFirst (
+  IN DEFERRED_LOG  *Log
+  );
+
+/**
+  Release the oldest record of a deferred log, so its slot can be reused.
+
+  @param  Log                    The log.
+  @param  Record                 The record returned by DeferredLogFirst().
+
+**/
+VOID
+DeferredLogRelease (
+  IN OUT DEFERRED_LOG     *Log,
+  IN OUT DEFERRED_RECORD  *Record
+  );
+
+#endif
@@ -10,7 +10,7 @@
   This library is mainly used by DxeCore to start performance logging to ensure that
   Performance Protocol is installed at the very beginning of DXE phase.
 
-Copyright (c) 2006 - 2021, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 (C) Copyright 2016 Hewlett Packard Enterprise Development LP<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -76,6 +76,19 @@ CHAR8    *mDevicePathString    = NULL;
 
 EFI_DEVICE_PATH_TO_TEXT_PROTOCOL  *mDevicePathToText = NULL;
 
+//
+// Deferred log of the measurements taken before EndOfDxe, and cost of the
+// performance logging.
+//
+DEFERRED_LOG  mDeferredLog;
+BOOLEAN       mDeferredLogEnabled    = FALSE;
+UINT64        mImmediateRecordCount  = 0;
+UINT64        mImmediateRecordTicks  = 0;
+UINT64        mDeferredRecordCount   = 0;
+UINT64        mDeferredRecordTicks   = 0;
+UINT64        mDeferredLogDrainTicks = 0;
+BOOLEAN       mPerformanceCounterUp  = TRUE;
+
 //
 // Interfaces for PerformanceMeasurement Protocol.
 //
@@ -1319,6 +1332,89 @@ InsertFpdtRecord (
   return EFI_SUCCESS;
 }
 
+/**
+  Get the number of ticks between two values of the performance counter.
+
+  @param  StartTicker    The first value of the performance counter.
+  @param  EndTicker      The second value of the performance counter.
+
+  @return The number of ticks elapsed from StartTicker to EndTicker.
+
+**/
+UINT64
+GetElapsedTicks (
+  IN UINT64  StartTicker,
+  IN UINT64  EndTicker
+  )
+{
+  if (mPerformanceCounterUp) {
+    return EndTicker - StartTicker;
+  }
+
+  return StartTicker - EndTicker;
+}
+
+/**
+  Build the FPDT records of the measurements in the deferred log.
+
+  This function resolves the image handles of the measurements to module
+  names and GUIDs, so it must run on the BSP, with mLockInsertRecord set.
+
+**/
+VOID
+DrainDeferredLog (
+  VOID
+  )
+{
+  DEFERRED_RECORD  *Record;
+  UINT64           StartTicker;
+
+  StartTicker = GetPerformanceCounter ();
+  for (Record = DeferredLogFirst (&mDeferredLog); Record != NULL; Record = DeferredLogFirst (&mDeferredLog)) {
+    InsertFpdtRecord (
+      ((Record->Flags & DEFERRED_RECORD_CALLER_GUID) != 0) ? &Record->CallerGuid : Record->CallerIdentifier,
+      ((Record->Flags & DEFERRED_RECORD_GUID) != 0) ? &Record->Guid : NULL,
+      ((Record->Flags & DEFERRED_RECORD_STRING) != 0) ? Record->String : NULL,
+      Record->Ticker,
+      Record->Address,
+      Record->PerfId,
+      (PERF_MEASUREMENT_ATTRIBUTE)Record->Attribute
+      );
+    mDeferredRecordCount++;
+    mDeferredRecordTicks += Record->Cost;
+    DeferredLogRelease (&mDeferredLog, Record);
+  }
+
+  mDeferredLogDrainTicks += GetElapsedTicks (StartTicker, GetPerformanceCounter ());
+}
+
+/**
+  Report the time spent to log the performance measurements.
+
+**/
+VOID
+ReportPerformanceLoggingCost (
+  VOID
+  )
+{
+  DEBUG ((
+    DEBUG_INFO,
+    "DxeCorePerformanceLib: %lu records logged in %lu ns\n",
+    mImmediateRecordCount,
+    GetTimeInNanoSecond (mImmediateRecordTicks)
+    ));
+  if (mDeferredLog.Capacity != 0) {
+    DEBUG ((
+      DEBUG_INFO,
+      "DxeCorePerformanceLib: %lu deferred records logged in %lu ns and drained in %lu ns, %u dropped\n",
+      mDeferredRecordCount,
+      GetTimeInNanoSecond (mDeferredRecordTicks),
+      GetTimeInNanoSecond (mDeferredLogDrainTicks),
+      mDeferredLog.Dropped
+      ));
+  }
+}
+
 /**
   Dumps all the PEI performance.
 
@@ -1391,6 +1487,19 @@ ReportFpdtRecordBuffer (
   UINT64      BPDTAddr;
 
   if (!mFpdtBufferIsReported) {
+    //
+    // The measurements taken from now on are appended to the boot performance
+    // table right away.
+    //
+    if (mDeferredLogEnabled) {
+      mDeferredLogEnabled = FALSE;
+      mLockInsertRecord   = TRUE;
+      DrainDeferredLog ();
+      mLockInsertRecord = FALSE;
+    }
+
+    ReportPerformanceLoggingCost ();
+
     Status = AllocateBootPerformanceTable ();
     if (!EFI_ERROR (Status)) {
       BPDTAddr = (UINT64)(UINTN)mAcpiBootPerformanceTable;
@@ -1481,6 +1590,9 @@ DxeCorePerformanceLibConstructor (
   EFI_EVENT             EndOfDxeEvent;
   EFI_EVENT             ReadyToBootEvent;
   PERFORMANCE_PROPERTY  *PerformanceProperty;
+  UINT64                StartValue;
+  UINT64                EndValue;
+  DEFERRED_RECORD       *DeferredRecords;
 
   if (!PerformanceMeasurementEnabled ()) {
     //
@@ -1494,6 +1606,20 @@ DxeCorePerformanceLibConstructor (
   //
   InternalGetPeiPerformance (GetHobList ());
 
+  GetPerformanceCounterProperties (&StartValue, &EndValue);
+  mPerformanceCounterUp = (BOOLEAN)(EndValue >= StartValue);
+
+  //
+  // Allocate the deferred log used until EndOfDxe.
+  //
+  if (PcdGet32 (PcdEdkiiFpdtDeferredRecordCount) != 0) {
+    DeferredRecords = AllocateZeroPool (PcdGet32 (PcdEdkiiFpdtDeferredRecordCount) * sizeof (DEFERRED_RECORD));
+    if (DeferredRecords != NULL) {
+      DeferredLogInitialize (&mDeferredLog, DeferredRecords, PcdGet32 (PcdEdkiiFpdtDeferredRecordCount), mPerformanceCounterUp);
+      mDeferredLogEnabled = TRUE;
+    }
+  }
+
   //
   // Install the protocol interfaces for DXE performance library instance.
   //
@@ -1581,8 +1707,43 @@ CreatePerformanceMeasurement (
   )
 {
   EFI_STATUS  Status;
+  UINT64      EntryTicker;
+  CHAR8       ModuleName[FPDT_STRING_EVENT_RECORD_NAME_LENGTH];
+  EFI_GUID    ModuleGuid;
 
-  Status = EFI_SUCCESS;
+  Status      = EFI_SUCCESS;
+  EntryTicker = GetPerformanceCounter ();
+
+  if (mDeferredLogEnabled) {
+    //
+    // Only copy the measurement, the FPDT record is built when the log is
+    // drained at the end of StartImage().
+    //
+    if (TimeStamp == 0) {
+      TimeStamp = EntryTicker;
+    }
+
+    if ((CallerIdentifier != NULL) &&
+        (((Identifier == MODULE_START_ID) && (Attribute == PerfEntry)) || (Identifier == MODULE_LOADIMAGE_END_ID)))
+    {
+      //
+      // The DXE core logs these on the BSP while the image handle is valid.
+      // StartImage() and UnloadImage() may free the handle before the log is
+      // drained, so cache the module GUID and name of the handle now for the
+      // records of the image.
+      //
+      GetModuleInfoFromHandle ((EFI_HANDLE)CallerIdentifier, ModuleName, sizeof (ModuleName), &ModuleGuid);
+    }
+
+    Status = DeferredLogAppend (&mDeferredLog, CallerIdentifier, Guid, String, TimeStamp, Address, (UINT16)Identifier, Attribute, EntryTicker);
+    if ((Identifier == MODULE_END_ID) && (Attribute == PerfEntry) && !mLockInsertRecord) {
+      mLockInsertRecord = TRUE;
+      DrainDeferredLog ();
+      mLockInsertRecord = FALSE;
+    }
+
+    return Status;
+  }
 
   if (mLockInsertRecord) {
     return EFI_INVALID_PARAMETER;
@@ -1592,6 +1753,9 @@ CreatePerformanceMeasurement (
 
   Status = InsertFpdtRecord (CallerIdentifier, Guid, String, TimeStamp, Address, (UINT16)Identifier, Attribute);
 
+  mImmediateRecordCount++;
+  mImmediateRecordTicks += GetElapsedTicks (EntryTicker, GetPerformanceCounter ());
+
   mLockInsertRecord = FALSE;
 
   return Status;
@@ -0,0 +1,354 @@
+/** @file
+  Unit tests and microbenchmark of the DxeCorePerformanceLib deferred log.
+
+  The tests append measurements to a small log and drain it at random
+  points, checking that the records come out in order, with their GUIDs and
+  strings copied, and that the measurements logged while the log is full are
+  counted as dropped. The benchmark measures the cost of logging one
+  measurement, both from the outside and as recorded by the log itself.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/UnitTestBenchmarkLib.h>
+
+#include "../DeferredLog.h"
+
+#define UNIT_TEST_APP_NAME     "DxeCorePerformanceLib Deferred Log Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_LOG_CAPACITY     100
+#define TEST_RANDOM_STEPS     50000
+#define TEST_BENCH_CAPACITY   0x10000
+#define TEST_BENCH_RECORDS    0x200000
+
+STATIC DEFERRED_LOG     mLog;
+STATIC DEFERRED_RECORD  *mRecords;
+STATIC UINTN            mRecordCount;
+
+STATIC CONST EFI_GUID  mTestGuid = {
+  0x6f1a8c25, 0x3b7d, 0x4e90, { 0x9a, 0x41, 0xc2, 0x5e, 0x07, 0xd8, 0x13, 0xb6 }
+};
+
+STATIC CONST CHAR8  *mTestStrings[] = {
+  "StartImage:",
+  "DB:Start:",
+  "PcdDxe",
+  "AVeryLongMeasurementDescriptionString"
+};
+
+/**
+  Allocate the slots of a deferred log.
+
+  @param[in]  Context  Number of slots to allocate.
+
+  @retval  UNIT_TEST_PASSED                      The slots were allocated.
+  @retval  UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  Out of memory.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+BuildLog (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  mRecordCount = (UINTN)Context;
+  mRecords     = AllocateZeroPool (mRecordCount * sizeof (DEFERRED_RECORD));
+  if (mRecords == NULL) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  DeferredLogInitialize (&mLog, mRecords, (UINT32)mRecordCount, TRUE);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Free the slots of the deferred log.
+
+  @param[in]  Context  Unused.
+**/
+STATIC
+VOID
+EFIAPI
+FreeLog (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  FreePool (mRecords);
+  mRecords = NULL;
+  ZeroMem (&mLog, sizeof (mLog));
+}
+
+/**
+  Append measurements and drain the log at random points, and check the
+  drained records against the sequence of measurements that were not
+  dropped.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The log behaves as expected.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+RandomAppendsShouldDrainInOrder (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32           Seed;
+  UINTN            Step;
+  UINT64           Appended;
+  UINT64           Drained;
+  UINT32           Dropped;
+  UINT16           PerfId;
+  UINTN            StringIndex;
+  UINTN            Pending;
+  EFI_STATUS       Status;
+  DEFERRED_RECORD  *Record;
+
+  //
+  // Only the largest power of two not above the requested count is used.
+  //
+  UT_ASSERT_EQUAL (mLog.Capacity, 64);
+
+  Seed     = 3;
+  Appended = 0;
+  Drained  = 0;
+  Dropped  = 0;
+  for (Step = 0; Step < TEST_RANDOM_STEPS; Step++) {
+    if ((UnitTestRandom (&Seed) % 32) != 0) {
+      //
+      // The sequence number of the measurement goes into Address, its kind
+      // is derived from it.
+      //
+      PerfId      = ((Appended % 3) == 0) ? PERF_CALLBACK_START_ID : PERF_INMODULE_START_ID;
+      StringIndex = (UINTN)(Appended % ARRAY_SIZE (mTestStrings));
+      Pending     = (UINTN)(Appended - Drained);
+      Status      = DeferredLogAppend (
+                      &mLog,
+                      &mTestGuid,
+                      ((Appended % 2) == 0) ? &mTestGuid : NULL,
+                      ((Appended % 5) != 0) ? mTestStrings[StringIndex] : NULL,
+                      Appended + 2,
+                      Appended,
+                      PerfId,
+                      PerfStartEntry,
+                      GetPerformanceCounter ()
+                      );
+      if (Pending == mLog.Capacity) {
+        UT_ASSERT_STATUS_EQUAL (Status, EFI_OUT_OF_RESOURCES);
+        Dropped++;
+      } else {
+        UT_ASSERT_NOT_EFI_ERROR (Status);
+        Appended++;
+      }
+
+      continue;
+    }
+
+    for (Record = DeferredLogFirst (&mLog); Record != NULL; Record = DeferredLogFirst (&mLog)) {
+      UT_ASSERT_EQUAL (Record->Address, Drained);
+      UT_ASSERT_EQUAL (Record->Ticker, Drained + 2);
+      UT_ASSERT_EQUAL (Record->Attribute, PerfStartEntry);
+      UT_ASSERT_TRUE (Record->CallerIdentifier == &mTestGuid);
+      if ((Drained % 3) == 0) {
+        UT_ASSERT_EQUAL (Record->PerfId, PERF_CALLBACK_START_ID);
+        UT_ASSERT_TRUE ((Record->Flags & DEFERRED_RECORD_CALLER_GUID) != 0);
+        UT_ASSERT_TRUE (CompareGuid (&Record->CallerGuid, &mTestGuid));
+      } else {
+        UT_ASSERT_EQUAL (Record->PerfId, PERF_INMODULE_START_ID);
+        UT_ASSERT_TRUE ((Record->Flags & DEFERRED_RECORD_CALLER_GUID) == 0);
+      }
+
+      if ((Drained % 2) == 0) {
+        UT_ASSERT_TRUE ((Record->Flags & DEFERRED_RECORD_GUID) != 0);
+        UT_ASSERT_TRUE (CompareGuid (&Record->Guid, &mTestGuid));
+      } else {
+        UT_ASSERT_TRUE ((Record->Flags & DEFERRED_RECORD_GUID) == 0);
+      }
+
+      if ((Drained % 5) != 0) {
+        StringIndex = (UINTN)(Drained % ARRAY_SIZE (mTestStrings));
+        UT_ASSERT_TRUE ((Record->Flags & DEFERRED_RECORD_STRING) != 0);
+        UT_ASSERT_EQUAL (
+          AsciiStrLen (Record->String),
+          MIN (AsciiStrLen (mTestStrings[StringIndex]), FPDT_STRING_EVENT_RECORD_NAME_LENGTH - 1)
+          );
+        UT_ASSERT_MEM_EQUAL (Record->String, mTestStrings[StringIndex], AsciiStrLen (Record->String));
+      } else {
+        UT_ASSERT_TRUE ((Record->Flags & DEFERRED_RECORD_STRING) == 0);
+      }
+
+      DeferredLogRelease (&mLog, Record);
+      Drained++;
+    }
+
+    UT_ASSERT_EQUAL (Drained, Appended);
+  }
+
+  UT_ASSERT_TRUE (Dropped > 0);
+  UT_ASSERT_EQUAL (mLog.Dropped, Dropped);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Measure the cost of logging one measurement.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The benchmark ran.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkAppend (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN            Index;
+  UINT64           Start;
+  UINT64           AppendNs;
+  UINT64           SelfTicks;
+  UINT64           Logged;
+  EFI_STATUS       Status;
+  DEFERRED_RECORD  *Record;
+
+  Logged    = 0;
+  SelfTicks = 0;
+  AppendNs  = 0;
+  for (Index = 0; Index < TEST_BENCH_RECORDS; Index += TEST_BENCH_CAPACITY) {
+    //
+    // Fill the log, then drain it outside of the measured time.
+    //
+    Start = UnitTestBenchmarkStart ();
+    while (mLog.Claimed - mLog.Released < mLog.Capacity) {
+      Status = DeferredLogAppend (
+                 &mLog,
+                 &mTestGuid,
+                 &mTestGuid,
+                 mTestStrings[2],
+                 Start,
+                 0,
+                 PERF_INMODULE_START_ID,
+                 PerfStartEntry,
+                 GetPerformanceCounter ()
+                 );
+      UT_ASSERT_NOT_EFI_ERROR (Status);
+    }
+
+    AppendNs += UnitTestBenchmarkStop (Start);
+
+    for (Record = DeferredLogFirst (&mLog); Record != NULL; Record = DeferredLogFirst (&mLog)) {
+      SelfTicks += Record->Cost;
+      Logged++;
+      DeferredLogRelease (&mLog, Record);
+    }
+  }
+
+  UT_ASSERT_EQUAL (Logged, TEST_BENCH_RECORDS);
+  UT_ASSERT_EQUAL (mLog.Dropped, 0);
+
+  UT_LOG_INFO (
+    "%ld records: %ld ns per record, %ld ns per record as measured by the log\n",
+    Logged,
+    AppendNs / Logged,
+    GetTimeInNanoSecond (SelfTicks) / Logged
+    );
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the deferred
+  log and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      LogTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&LogTests, Framework, "Deferred Log Tests", "DxeCorePerformanceLib.DeferredLog", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Deferred Log Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite----Description-----------------Name-----------Function-------------------------Pre-------Post-----Context-----------
+  //
+  AddTestCase (LogTests, "Random appends and drains", "RandomAppends", RandomAppendsShouldDrainInOrder, BuildLog, FreeLog, (UNIT_TEST_CONTEXT)(UINTN)TEST_LOG_CAPACITY);
+  AddTestCase (LogTests, "Append benchmark", "Benchmark", BenchmarkAppend, BuildLog, FreeLog, (UNIT_TEST_CONTEXT)(UINTN)TEST_BENCH_CAPACITY);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define DeferredLogUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+DeferredLogUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  UnitTestingEntry ();
+  return 0;
+}
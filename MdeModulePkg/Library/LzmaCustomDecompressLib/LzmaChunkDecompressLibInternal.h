@@ -0,0 +1,82 @@
+/** @file
+  Chunked LZMA Decompress Library internal header file. It declares the
+  interfaces shared by the chunked GUIDed section handlers and the instance
+  specific code that runs the chunk decompression workers.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __LZMA_CHUNK_DECOMPRESSLIB_INTERNAL_H__
+#define __LZMA_CHUNK_DECOMPRESSLIB_INTERNAL_H__
+
+#include "LzmaDecompressLibInternal.h"
+#include <Library/SynchronizationLib.h>
+
+///
+/// State shared by all the processors that decompress one chunked section.
+/// Processors claim a scratch buffer slot first and then claim chunks one by
+/// one until all chunks are claimed, so the work is balanced even if chunks
+/// do not take the same time to decompress.
+///
+typedef struct {
+  CONST UINT8               *Source;
+  CONST LZMA_CHUNK_ENTRY    *Chunks;
+  UINT32                    ChunkCount;
+  UINT32                    ChunkSize;
+  UINT32                    DecompressedSize;
+  UINT8                     *Destination;
+  UINT8                     *Scratch;
+  UINT32                    SlotScratchSize;
+  UINT32                    SlotCount;
+  volatile UINT32           NextSlot;
+  volatile UINT32           NextChunk;
+  volatile UINT32           Failed;
+} LZMA_CHUNK_CONTEXT;
+
+/**
+  Decompress chunks of a chunked section until no unclaimed chunk is left.
+
+  This function is called on every processor that takes part in the
+  decompression. It must not use any PEI or DXE service because it may run
+  on an application processor.
+
+  @param[in, out] Buffer  Pointer to the LZMA_CHUNK_CONTEXT of the section.
+
+**/
+VOID
+EFIAPI
+LzmaChunkWorker (
+  IN OUT VOID  *Buffer
+  );
+
+/**
+  Return the maximum number of processors that this library instance uses to
+  decompress one chunked section.
+
+  The value must not change between the GetInfo and the Extraction calls for
+  the same section, because the scratch buffer is sized from it.
+
+  @return The maximum number of chunk decompression workers, at least 1.
+
+**/
+UINT32
+LzmaChunkGetMaxWorkers (
+  VOID
+  );
+
+/**
+  Run LzmaChunkWorker() on the processors available to this library instance
+  and return when all chunks of the section have been decompressed or a chunk
+  failed to decompress.
+
+  @param[in, out] Context  The LZMA_CHUNK_CONTEXT of the section.
+
+**/
+VOID
+LzmaChunkRunWorkers (
+  IN OUT LZMA_CHUNK_CONTEXT  *Context
+  );
+
+#endif
@@ -0,0 +1,380 @@
+/** @file
+  Chunked LZMA Decompress GUIDed Section Extraction Library.
+
+  The data of a chunked LZMA GUIDed section is split into fixed size chunks
+  that are compressed independently, so they can be decompressed in parallel.
+  The handlers in this file validate the chunk table and hand the chunks to
+  LzmaChunkRunWorkers(), which is provided by the library instance.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "LzmaChunkDecompressLibInternal.h"
+#include "Sdk/C/7zTypes.h"
+#include "Sdk/C/LzmaDec.h"
+
+/**
+  Get the data of a chunked LZMA GUIDed section.
+
+  @param[in]  InputSection      A pointer to a GUIDed section of an FFS formatted file.
+  @param[out] Source            The data of the section.
+  @param[out] SourceSize        The size, in bytes, of the data of the section.
+  @param[out] SectionAttribute  The attributes of the section. Optional.
+
+  @retval  RETURN_SUCCESS            The data of the section was returned.
+  @retval  RETURN_INVALID_PARAMETER  The section is not a chunked LZMA GUIDed section.
+
+**/
+STATIC
+RETURN_STATUS
+LzmaChunkGetSectionData (
+  IN  CONST VOID   *InputSection,
+  OUT CONST UINT8  **Source,
+  OUT UINT32       *SourceSize,
+  OUT UINT16       *SectionAttribute OPTIONAL
+  )
+{
+  EFI_GUID  *InputGuid;
+  UINT16    DataOffset;
+  UINT16    Attributes;
+  UINT32    SectionSize;
+
+  if (IS_SECTION2 (InputSection)) {
+    InputGuid   = &(((EFI_GUID_DEFINED_SECTION2 *)InputSection)->SectionDefinitionGuid);
+    DataOffset  = ((EFI_GUID_DEFINED_SECTION2 *)InputSection)->DataOffset;
+    Attributes  = ((EFI_GUID_DEFINED_SECTION2 *)InputSection)->Attributes;
+    SectionSize = SECTION2_SIZE (InputSection);
+  } else {
+    InputGuid   = &(((EFI_GUID_DEFINED_SECTION *)InputSection)->SectionDefinitionGuid);
+    DataOffset  = ((EFI_GUID_DEFINED_SECTION *)InputSection)->DataOffset;
+    Attributes  = ((EFI_GUID_DEFINED_SECTION *)InputSection)->Attributes;
+    SectionSize = SECTION_SIZE (InputSection);
+  }
+
+  if (!CompareGuid (&gLzmaChunkedCustomDecompressGuid, InputGuid) || (DataOffset > SectionSize)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  *Source     = (CONST UINT8 *)InputSection + DataOffset;
+  *SourceSize = SectionSize - DataOffset;
+  if (SectionAttribute != NULL) {
+    *SectionAttribute = Attributes;
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Validate the chunk table of a chunked LZMA section and get the size of the
+  scratch buffer that is required to decompress one chunk.
+
+  Every chunk must be inside the section data and carry the decompressed size
+  that matches its position, so a worker can never write past its part of the
+  destination buffer.
+
+  @param[in]  Source           The data of the section.
+  @param[in]  SourceSize       The size, in bytes, of the data of the section.
+  @param[out] SlotScratchSize  The size, in bytes, of the scratch buffer one
+                               worker needs.
+
+  @retval  RETURN_SUCCESS            The chunk table is valid.
+  @retval  RETURN_INVALID_PARAMETER  The chunk table is corrupted.
+
+**/
+STATIC
+RETURN_STATUS
+LzmaChunkValidate (
+  IN  CONST UINT8  *Source,
+  IN  UINT32       SourceSize,
+  OUT UINT32       *SlotScratchSize
+  )
+{
+  CONST LZMA_CHUNKED_HEADER  *Header;
+  CONST LZMA_CHUNK_ENTRY     *Chunks;
+  UINT32                     Index;
+  UINT32                     ExpectedSize;
+  UINT32                     DecompressedSize;
+  UINT32                     ScratchSize;
+  RETURN_STATUS              Status;
+
+  if (SourceSize < sizeof (LZMA_CHUNKED_HEADER)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Header = (CONST LZMA_CHUNKED_HEADER *)Source;
+  if ((Header->Signature != LZMA_CHUNKED_SIGNATURE) ||
+      (Header->DecompressedSize == 0) ||
+      (Header->ChunkSize == 0) ||
+      (Header->ChunkCount > (SourceSize - sizeof (LZMA_CHUNKED_HEADER)) / sizeof (LZMA_CHUNK_ENTRY)) ||
+      ((Header->DecompressedSize - 1) / Header->ChunkSize + 1 != Header->ChunkCount))
+  {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Chunks           = (CONST LZMA_CHUNK_ENTRY *)(Header + 1);
+  *SlotScratchSize = 0;
+  for (Index = 0; Index < Header->ChunkCount; Index++) {
+    if ((Chunks[Index].Offset > SourceSize) ||
+        (Chunks[Index].CompressedSize > SourceSize - Chunks[Index].Offset) ||
+        (Chunks[Index].CompressedSize < LZMA_PROPS_SIZE + 8))
+    {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    Status = LzmaUefiDecompressGetInfo (
+               Source + Chunks[Index].Offset,
+               Chunks[Index].CompressedSize,
+               &DecompressedSize,
+               &ScratchSize
+               );
+    if (RETURN_ERROR (Status)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    ExpectedSize = MIN (Header->ChunkSize, Header->DecompressedSize - Index * Header->ChunkSize);
+    if (DecompressedSize != ExpectedSize) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    *SlotScratchSize = MAX (*SlotScratchSize, ScratchSize);
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decompress chunks of a chunked section until no unclaimed chunk is left.
+
+  This function is called on every processor that takes part in the
+  decompression. It must not use any PEI or DXE service because it may run
+  on an application processor.
+
+  @param[in, out] Buffer  Pointer to the LZMA_CHUNK_CONTEXT of the section.
+
+**/
+VOID
+EFIAPI
+LzmaChunkWorker (
+  IN OUT VOID  *Buffer
+  )
+{
+  LZMA_CHUNK_CONTEXT      *Context;
+  CONST LZMA_CHUNK_ENTRY  *Chunk;
+  UINT32                  Slot;
+  UINT32                  Index;
+  RETURN_STATUS           Status;
+
+  Context = (LZMA_CHUNK_CONTEXT *)Buffer;
+
+  //
+  // Each worker owns one scratch buffer slot. Processors that come late find
+  // all slots taken and leave the remaining chunks to the slot owners.
+  //
+  Slot = InterlockedIncrement (&Context->NextSlot) - 1;
+  if (Slot >= Context->SlotCount) {
+    return;
+  }
+
+  while (Context->Failed == 0) {
+    Index = InterlockedIncrement (&Context->NextChunk) - 1;
+    if (Index >= Context->ChunkCount) {
+      break;
+    }
+
+    Chunk  = &Context->Chunks[Index];
+    Status = LzmaUefiDecompress (
+               Context->Source + Chunk->Offset,
+               Chunk->CompressedSize,
+               Context->Destination + (UINTN)Index * Context->ChunkSize,
+               Context->Scratch + (UINTN)Slot * Context->SlotScratchSize
+               );
+    if (RETURN_ERROR (Status)) {
+      Context->Failed = 1;
+      break;
+    }
+  }
+}
+
+/**
+  Examines a GUIDed section and returns the size of the decoded buffer and the
+  size of an scratch buffer required to actually decode the data in a GUIDed section.
+
+  Examines a GUIDed section specified by InputSection.
+  If GUID for InputSection does not match the GUID that this handler supports,
+  then RETURN_UNSUPPORTED is returned.
+  If the required information can not be retrieved from InputSection,
+  then RETURN_INVALID_PARAMETER is returned.
+  If the GUID of InputSection does match the GUID that this handler supports,
+  then the size required to hold the decoded buffer is returned in OututBufferSize,
+  the size of an optional scratch buffer is returned in ScratchSize, and the Attributes field
+  from EFI_GUID_DEFINED_SECTION header of InputSection is returned in SectionAttribute.
+
+  The scratch buffer holds one LZMA scratch buffer for every processor that
+  may decompress chunks of the section at the same time.
+
+  If InputSection is NULL, then ASSERT().
+  If OutputBufferSize is NULL, then ASSERT().
+  If ScratchBufferSize is NULL, then ASSERT().
+  If SectionAttribute is NULL, then ASSERT().
+
+
+  @param[in]  InputSection       A pointer to a GUIDed section of an FFS formatted file.
+  @param[out] OutputBufferSize   A pointer to the size, in bytes, of an output buffer required
+                                 if the buffer specified by InputSection were decoded.
+  @param[out] ScratchBufferSize  A pointer to the size, in bytes, required as scratch space
+                                 if the buffer specified by InputSection were decoded.
+  @param[out] SectionAttribute   A pointer to the attributes of the GUIDed section. See the Attributes
+                                 field of EFI_GUID_DEFINED_SECTION in the PI Specification.
+
+  @retval  RETURN_SUCCESS            The information about InputSection was returned.
+  @retval  RETURN_UNSUPPORTED        The section specified by InputSection does not match the GUID this handler supports.
+  @retval  RETURN_INVALID_PARAMETER  The information can not be retrieved from the section specified by InputSection.
+
+**/
+RETURN_STATUS
+EFIAPI
+LzmaChunkGuidedSectionGetInfo (
+  IN  CONST VOID  *InputSection,
+  OUT UINT32      *OutputBufferSize,
+  OUT UINT32      *ScratchBufferSize,
+  OUT UINT16      *SectionAttribute
+  )
+{
+  CONST UINT8    *Source;
+  UINT32         SourceSize;
+  UINT32         SlotScratchSize;
+  UINT32         SlotCount;
+  RETURN_STATUS  Status;
+
+  ASSERT (InputSection != NULL);
+  ASSERT (OutputBufferSize != NULL);
+  ASSERT (ScratchBufferSize != NULL);
+  ASSERT (SectionAttribute != NULL);
+
+  Status = LzmaChunkGetSectionData (InputSection, &Source, &SourceSize, SectionAttribute);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = LzmaChunkValidate (Source, SourceSize, &SlotScratchSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  SlotCount          = MIN (((CONST LZMA_CHUNKED_HEADER *)Source)->ChunkCount, LzmaChunkGetMaxWorkers ());
+  *OutputBufferSize  = ((CONST LZMA_CHUNKED_HEADER *)Source)->DecompressedSize;
+  *ScratchBufferSize = SlotCount * SlotScratchSize;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decompress a chunked LZMA compressed GUIDed section into a caller allocated output buffer.
+
+  Decodes the GUIDed section specified by InputSection.
+  If GUID for InputSection does not match the GUID that this handler supports, then RETURN_UNSUPPORTED is returned.
+  If the data in InputSection can not be decoded, then RETURN_INVALID_PARAMETER is returned.
+  If the GUID of InputSection does match the GUID that this handler supports, then InputSection
+  is decoded into the buffer specified by OutputBuffer and the authentication status of this
+  decode operation is returned in AuthenticationStatus.  If the decoded buffer is identical to the
+  data in InputSection, then OutputBuffer is set to point at the data in InputSection.  Otherwise,
+  the decoded data will be placed in caller allocated buffer specified by OutputBuffer.
+
+  If InputSection is NULL, then ASSERT().
+  If OutputBuffer is NULL, then ASSERT().
+  If ScratchBuffer is NULL and this decode operation requires a scratch buffer, then ASSERT().
+  If AuthenticationStatus is NULL, then ASSERT().
+
+
+  @param[in]  InputSection  A pointer to a GUIDed section of an FFS formatted file.
+  @param[out] OutputBuffer  A pointer to a buffer that contains the result of a decode operation.
+  @param[out] ScratchBuffer A caller allocated buffer that may be required by this function
+                            as a scratch buffer to perform the decode operation.
+  @param[out] AuthenticationStatus
+                            A pointer to the authentication status of the decoded output buffer.
+                            See the definition of authentication status in the EFI_PEI_GUIDED_SECTION_EXTRACTION_PPI
+                            section of the PI Specification. EFI_AUTH_STATUS_PLATFORM_OVERRIDE must
+                            never be set by this handler.
+
+  @retval  RETURN_SUCCESS            The buffer specified by InputSection was decoded.
+  @retval  RETURN_UNSUPPORTED        The section specified by InputSection does not match the GUID this handler supports.
+  @retval  RETURN_INVALID_PARAMETER  The section specified by InputSection can not be decoded.
+
+**/
+RETURN_STATUS
+EFIAPI
+LzmaChunkGuidedSectionExtraction (
+  IN CONST  VOID    *InputSection,
+  OUT       VOID    **OutputBuffer,
+  OUT       VOID    *ScratchBuffer         OPTIONAL,
+  OUT       UINT32  *AuthenticationStatus
+  )
+{
+  CONST UINT8                *Source;
+  UINT32                     SourceSize;
+  UINT32                     SlotScratchSize;
+  CONST LZMA_CHUNKED_HEADER  *Header;
+  LZMA_CHUNK_CONTEXT         Context;
+  RETURN_STATUS              Status;
+
+  ASSERT (OutputBuffer != NULL);
+  ASSERT (InputSection != NULL);
+
+  Status = LzmaChunkGetSectionData (InputSection, &Source, &SourceSize, NULL);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = LzmaChunkValidate (Source, SourceSize, &SlotScratchSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Authentication is set to Zero, which may be ignored.
+  //
+  *AuthenticationStatus = 0;
+
+  Header                   = (CONST LZMA_CHUNKED_HEADER *)Source;
+  Context.Source           = Source;
+  Context.Chunks           = (CONST LZMA_CHUNK_ENTRY *)(Header + 1);
+  Context.ChunkCount       = Header->ChunkCount;
+  Context.ChunkSize        = Header->ChunkSize;
+  Context.DecompressedSize = Header->DecompressedSize;
+  Context.Destination      = *OutputBuffer;
+  Context.Scratch          = ScratchBuffer;
+  Context.SlotScratchSize  = SlotScratchSize;
+  Context.SlotCount        = MIN (Header->ChunkCount, LzmaChunkGetMaxWorkers ());
+  Context.NextSlot         = 0;
+  Context.NextChunk        = 0;
+  Context.Failed           = 0;
+
+  LzmaChunkRunWorkers (&Context);
+
+  if ((Context.Failed != 0) || (Context.NextChunk < Context.ChunkCount)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Register LzmaChunkGuidedSectionExtraction and LzmaChunkGuidedSectionGetInfo
+  handlers with LzmaChunkedCustomDecompressGuid.
+
+  @retval  RETURN_SUCCESS            Register successfully.
+  @retval  RETURN_OUT_OF_RESOURCES   No enough memory to store this handler.
+**/
+EFI_STATUS
+EFIAPI
+LzmaChunkDecompressLibConstructor (
+  VOID
+  )
+{
+  return ExtractGuidedSectionRegisterHandlers (
+           &gLzmaChunkedCustomDecompressGuid,
+           LzmaChunkGuidedSectionGetInfo,
+           LzmaChunkGuidedSectionExtraction
+           );
+}
@@ -0,0 +1,39 @@
+/** @file
+  Chunk decompression workers of the chunked LZMA Decompress Library that
+  decompress all chunks on the calling processor.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "LzmaChunkDecompressLibInternal.h"
+
+/**
+  Return the maximum number of processors that this library instance uses to
+  decompress one chunked section.
+
+  @return 1, all chunks are decompressed on the calling processor.
+
+**/
+UINT32
+LzmaChunkGetMaxWorkers (
+  VOID
+  )
+{
+  return 1;
+}
+
+/**
+  Run LzmaChunkWorker() on the calling processor.
+
+  @param[in, out] Context  The LZMA_CHUNK_CONTEXT of the section.
+
+**/
+VOID
+LzmaChunkRunWorkers (
+  IN OUT LZMA_CHUNK_CONTEXT  *Context
+  )
+{
+  LzmaChunkWorker (Context);
+}
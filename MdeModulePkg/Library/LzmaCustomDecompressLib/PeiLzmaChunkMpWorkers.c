@@ -0,0 +1,84 @@
+/** @file
+  Chunk decompression workers of the chunked LZMA Decompress Library that
+  decompress the chunks on the application processors through the PEI MP
+  Services PPI.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "LzmaChunkDecompressLibInternal.h"
+#include <Library/PcdLib.h>
+#include <Library/PeiServicesLib.h>
+#include <Library/PeiServicesTablePointerLib.h>
+#include <Ppi/MpServices.h>
+
+/**
+  Return the maximum number of processors that this library instance uses to
+  decompress one chunked section.
+
+  @return The maximum number of chunk decompression workers, at least 1.
+
+**/
+UINT32
+LzmaChunkGetMaxWorkers (
+  VOID
+  )
+{
+  return MAX (PcdGet32 (PcdLzmaChunkDecompressMaxWorkers), 1);
+}
+
+/**
+  Run LzmaChunkWorker() on all enabled APs and then on the BSP.
+
+  The BSP waits for the APs in StartupAllAPs() and afterwards decompresses
+  the chunks that are left, which are all of them if the MP Services PPI is
+  not installed or no AP is enabled.
+
+  @param[in, out] Context  The LZMA_CHUNK_CONTEXT of the section.
+
+**/
+VOID
+LzmaChunkRunWorkers (
+  IN OUT LZMA_CHUNK_CONTEXT  *Context
+  )
+{
+  EFI_STATUS               Status;
+  CONST EFI_PEI_SERVICES   **PeiServices;
+  EFI_PEI_MP_SERVICES_PPI  *MpServicesPpi;
+
+  if (Context->SlotCount > 1) {
+    Status = PeiServicesLocatePpi (
+               &gEfiPeiMpServicesPpiGuid,
+               0,
+               NULL,
+               (VOID **)&MpServicesPpi
+               );
+    if (!EFI_ERROR (Status)) {
+      //
+      // Blocking mode, no AP uses the context any more on return.
+      //
+      PeiServices = GetPeiServicesTablePointer ();
+      Status      = MpServicesPpi->StartupAllAPs (
+                                     PeiServices,
+                                     MpServicesPpi,
+                                     LzmaChunkWorker,
+                                     FALSE,
+                                     0,
+                                     Context
+                                     );
+      DEBUG ((
+        DEBUG_INFO,
+        "LzmaChunk: %d of %d chunks decompressed on %d APs - %r\n",
+        MIN (Context->NextChunk, Context->ChunkCount),
+        Context->ChunkCount,
+        MIN (Context->NextSlot, Context->SlotCount),
+        Status
+        ));
+    }
+  }
+
+  Context->NextSlot = 0;
+  LzmaChunkWorker (Context);
+}
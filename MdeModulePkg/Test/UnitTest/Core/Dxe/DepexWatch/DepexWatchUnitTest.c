@@ -0,0 +1,1083 @@
+/** @file
+  Unit tests and replay harness of the DXE dispatcher dependency watch index.
+
+  The harness replays a dispatch log through a model of the scan loop of
+  CoreDispatcher(): the drivers are scanned in discovery order, the drivers
+  whose dependency expression is satisfied are scheduled, and dispatching a
+  driver installs the protocols it installed in the log. The log is replayed
+  once evaluating every waiting dependency expression on every scan, like the
+  dispatcher did, and once evaluating only the ones the watch index marks
+  dirty. Both replays must dispatch the drivers in the same order.
+
+  Without a log, a synthetic one of several hundred drivers is generated. A
+  log recorded on a platform can be replayed by setting the environment
+  variable DEPEX_WATCH_REPLAY_LOG to its path. Each line of the log describes
+  one driver, in discovery order:
+
+    <FFS file GUID> <DXE_DEPEX section as hex bytes> [<installed protocol GUID> ...]
+
+  Empty lines and lines starting with '#' are ignored. BEFORE and AFTER
+  dependency expressions are not modelled, and their drivers are never
+  dispatched by either replay.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <PiDxe.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/UnitTestBenchmarkLib.h>
+
+#include "../../../../../Core/Dxe/Dispatcher/DepexWatch.h"
+
+#define UNIT_TEST_APP_NAME     "DXE Core Dependency Watch Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_DRIVER_COUNT       600
+#define TEST_RANDOM_LOGS        20
+#define TEST_RANDOM_DRIVERS     150
+#define TEST_REPLAY_ROUNDS      5
+#define TEST_DEPEX_STACK_SIZE   64
+#define TEST_LOG_LINE_SIZE      4096
+#define TEST_LOG_MAX_INSTALLS   64
+
+///
+/// One driver of a dispatch log.
+///
+typedef struct {
+  EFI_GUID    FileName;
+  UINT8       *Depex;
+  UINTN       DepexSize;
+  EFI_GUID    *Installs;
+  UINTN       InstallCount;
+} REPLAY_DRIVER;
+
+///
+/// A dispatch log.
+///
+typedef struct {
+  REPLAY_DRIVER    *Drivers;
+  UINTN            Count;
+} REPLAY_LOG;
+
+///
+/// Mirror of the EFI_CORE_DRIVER_ENTRY fields used by the dispatcher scan.
+///
+typedef struct {
+  LIST_ENTRY       Link;
+  LIST_ENTRY       ScheduledLink;
+  REPLAY_DRIVER    *Replay;
+  UINT8            *Depex;
+  BOOLEAN          Dependent;
+  DEPEX_WATCHER    DepexWatcher;
+} TEST_DRIVER;
+
+///
+/// An installed protocol interface of the model protocol database.
+///
+typedef struct {
+  HANDLE_INDEX_LINK    IndexLink;
+  EFI_GUID             ProtocolID;
+} TEST_PROTOCOL;
+
+///
+/// Result of a replay.
+///
+typedef struct {
+  UINTN     *Order;
+  UINTN     Dispatched;
+  UINTN     Evaluations;
+  UINTN     Lookups;
+  UINT64    Ns;
+} REPLAY_RESULT;
+
+STATIC REPLAY_LOG  mLog;
+
+/**
+  Fill a GUID with pseudo random bytes.
+
+  @param[in, out]  Seed  The generator state.
+  @param[out]      Guid  The GUID to fill.
+**/
+STATIC
+VOID
+RandomGuid (
+  IN OUT UINT32    *Seed,
+  OUT    EFI_GUID  *Guid
+  )
+{
+  UINT8  *Bytes;
+  UINTN  Index;
+
+  Bytes = (UINT8 *)Guid;
+  for (Index = 0; Index < sizeof (EFI_GUID); Index++) {
+    Bytes[Index] = (UINT8)UnitTestRandom (Seed);
+  }
+}
+
+/**
+  Append a push of a protocol to a dependency expression.
+
+  @param[in, out]  Depex     The dependency expression.
+  @param[in, out]  Size      The size of the dependency expression.
+  @param[in]       Protocol  The protocol to push.
+**/
+STATIC
+VOID
+AppendPush (
+  IN OUT UINT8           *Depex,
+  IN OUT UINTN           *Size,
+  IN     CONST EFI_GUID  *Protocol
+  )
+{
+  Depex[(*Size)++] = EFI_DEP_PUSH;
+  CopyMem (&Depex[*Size], Protocol, sizeof (EFI_GUID));
+  *Size += sizeof (EFI_GUID);
+}
+
+/**
+  Free a dispatch log.
+
+  @param[in, out]  Log  The log to free.
+**/
+STATIC
+VOID
+FreeLog (
+  IN OUT REPLAY_LOG  *Log
+  )
+{
+  UINTN  Index;
+
+  if (Log->Drivers == NULL) {
+    return;
+  }
+
+  for (Index = 0; Index < Log->Count; Index++) {
+    if (Log->Drivers[Index].Depex != NULL) {
+      FreePool (Log->Drivers[Index].Depex);
+    }
+
+    if (Log->Drivers[Index].Installs != NULL) {
+      FreePool (Log->Drivers[Index].Installs);
+    }
+  }
+
+  FreePool (Log->Drivers);
+  Log->Drivers = NULL;
+  Log->Count   = 0;
+}
+
+/**
+  Pick the protocol a synthetic dependency expression pushes. Half of the
+  pushes are of the first protocols installed, like the architectural
+  protocols most drivers depend on.
+
+  @param[in, out]  Seed       The generator state.
+  @param[in]       Installed  The number of protocols installed so far.
+
+  @return The index of the protocol.
+**/
+STATIC
+UINTN
+PickProtocol (
+  IN OUT UINT32  *Seed,
+  IN     UINTN   Installed
+  )
+{
+  if ((Installed > 32) && ((UnitTestRandom (Seed) & 1) != 0)) {
+    return UnitTestRandom (Seed) % 32;
+  }
+
+  return UnitTestRandom (Seed) % Installed;
+}
+
+/**
+  Generate a synthetic dispatch log.
+
+  The drivers are generated in a random dependency order, and discovered in
+  another one. Each driver may install up to three protocols, and its
+  dependency expression combines up to four pushes of protocols installed by
+  drivers earlier in the dependency order with AND, sometimes with OR, so that
+  most drivers are dispatched after several scans. A few dependency
+  expressions AND NOT a protocol, which makes the dispatch order matter, or
+  push a protocol that is never installed.
+
+  @param[out]  Log          The log to generate.
+  @param[in]   DriverCount  The number of drivers.
+  @param[in]   Seed         The seed of the log.
+**/
+STATIC
+VOID
+GenerateLog (
+  OUT REPLAY_LOG  *Log,
+  IN  UINTN       DriverCount,
+  IN  UINT32      Seed
+  )
+{
+  EFI_GUID       *Protocols;
+  UINTN          *Order;
+  REPLAY_DRIVER  *Driver;
+  UINT8          Depex[5 * (1 + sizeof (EFI_GUID)) + 8];
+  EFI_GUID       Missing;
+  UINTN          Size;
+  UINTN          Index;
+  UINTN          Other;
+  UINTN          Swap;
+  UINTN          Push;
+  UINTN          PushCount;
+  UINTN          Installed;
+  UINT32         Kind;
+
+  //
+  // Each driver installs at most three protocols, and each protocol is
+  // installed once.
+  //
+  Protocols = AllocatePool (DriverCount * 3 * sizeof (EFI_GUID));
+  Order     = AllocatePool (DriverCount * sizeof (UINTN));
+  ASSERT (Protocols != NULL && Order != NULL);
+  for (Index = 0; Index < DriverCount * 3; Index++) {
+    RandomGuid (&Seed, &Protocols[Index]);
+  }
+
+  //
+  // Order[] is the discovery position of the drivers, in dependency order.
+  //
+  for (Index = 0; Index < DriverCount; Index++) {
+    Order[Index] = Index;
+  }
+
+  for (Index = DriverCount - 1; Index > 0; Index--) {
+    Other        = UnitTestRandom (&Seed) % (Index + 1);
+    Swap         = Order[Index];
+    Order[Index] = Order[Other];
+    Order[Other] = Swap;
+  }
+
+  Log->Drivers = AllocateZeroPool (DriverCount * sizeof (REPLAY_DRIVER));
+  Log->Count   = DriverCount;
+  ASSERT (Log->Drivers != NULL);
+
+  Installed = 0;
+  for (Index = 0; Index < DriverCount; Index++) {
+    Driver = &Log->Drivers[Order[Index]];
+    RandomGuid (&Seed, &Driver->FileName);
+
+    Size = 0;
+    Kind = UnitTestRandom (&Seed) % 64;
+    if ((Installed == 0) || (Kind == 0)) {
+      Depex[Size++] = EFI_DEP_TRUE;
+    } else {
+      PushCount = UnitTestRandom (&Seed) % 4 + 1;
+      AppendPush (Depex, &Size, &Protocols[PickProtocol (&Seed, Installed)]);
+      for (Push = 1; Push < PushCount; Push++) {
+        AppendPush (Depex, &Size, &Protocols[PickProtocol (&Seed, Installed)]);
+        Depex[Size++] = (Kind < 8) ? EFI_DEP_OR : EFI_DEP_AND;
+      }
+
+      if ((Kind == 8) || (Kind == 9)) {
+        //
+        // AND NOT a protocol installed by any driver.
+        //
+        AppendPush (Depex, &Size, &Protocols[UnitTestRandom (&Seed) % (DriverCount * 3)]);
+        Depex[Size++] = EFI_DEP_NOT;
+        Depex[Size++] = EFI_DEP_AND;
+      } else if (Kind == 10) {
+        RandomGuid (&Seed, &Missing);
+        AppendPush (Depex, &Size, &Missing);
+        Depex[Size++] = EFI_DEP_AND;
+      }
+    }
+
+    Depex[Size++]     = EFI_DEP_END;
+    Driver->Depex     = AllocateCopyPool (Size, Depex);
+    Driver->DepexSize = Size;
+    ASSERT (Driver->Depex != NULL);
+
+    Driver->InstallCount = UnitTestRandom (&Seed) % 4;
+    if (Driver->InstallCount != 0) {
+      Driver->Installs = AllocateCopyPool (Driver->InstallCount * sizeof (EFI_GUID), &Protocols[Installed]);
+      ASSERT (Driver->Installs != NULL);
+      Installed += Driver->InstallCount;
+    }
+  }
+
+  FreePool (Protocols);
+  FreePool (Order);
+}
+
+/**
+  Parse a GUID in registry format.
+
+  @param[in]   Text  The text of the GUID.
+  @param[out]  Guid  The GUID.
+
+  @retval TRUE   The GUID was parsed.
+  @retval FALSE  The text is not a GUID.
+**/
+STATIC
+BOOLEAN
+ParseGuid (
+  IN  CONST CHAR8  *Text,
+  OUT EFI_GUID     *Guid
+  )
+{
+  UINT32  Data1;
+  UINT32  Data2;
+  UINT32  Data3;
+  UINT32  Data4[8];
+  UINTN   Index;
+
+  if (sscanf (
+        Text,
+        "%8x-%4x-%4x-%2x%2x-%2x%2x%2x%2x%2x%2x",
+        &Data1,
+        &Data2,
+        &Data3,
+        &Data4[0],
+        &Data4[1],
+        &Data4[2],
+        &Data4[3],
+        &Data4[4],
+        &Data4[5],
+        &Data4[6],
+        &Data4[7]
+        ) != 11)
+  {
+    return FALSE;
+  }
+
+  Guid->Data1 = Data1;
+  Guid->Data2 = (UINT16)Data2;
+  Guid->Data3 = (UINT16)Data3;
+  for (Index = 0; Index < 8; Index++) {
+    Guid->Data4[Index] = (UINT8)Data4[Index];
+  }
+
+  return TRUE;
+}
+
+/**
+  Load a dispatch log recorded on a platform.
+
+  @param[in]   Path  The path of the log.
+  @param[out]  Log   The log.
+
+  @retval TRUE   The log was loaded.
+  @retval FALSE  The log cannot be read or is malformed.
+**/
+STATIC
+BOOLEAN
+LoadLog (
+  IN  CONST CHAR8  *Path,
+  OUT REPLAY_LOG   *Log
+  )
+{
+  FILE           *File;
+  CHAR8          *Line;
+  CHAR8          *Token;
+  UINTN          Capacity;
+  UINTN          Index;
+  UINTN          Length;
+  UINT32         Byte;
+  EFI_GUID       Installs[TEST_LOG_MAX_INSTALLS];
+  REPLAY_DRIVER  *Driver;
+  REPLAY_DRIVER  *Drivers;
+  BOOLEAN        Valid;
+
+  File = fopen (Path, "r");
+  if (File == NULL) {
+    return FALSE;
+  }
+
+  Line          = AllocatePool (TEST_LOG_LINE_SIZE);
+  Capacity      = 0;
+  Log->Drivers  = NULL;
+  Log->Count    = 0;
+  Valid         = (Line != NULL);
+  while (Valid && (fgets (Line, TEST_LOG_LINE_SIZE, File) != NULL)) {
+    Token = strtok (Line, " \t\r\n");
+    if ((Token == NULL) || (Token[0] == '#')) {
+      continue;
+    }
+
+    if (Log->Count == Capacity) {
+      Capacity = (Capacity == 0) ? 256 : Capacity * 2;
+      Drivers  = ReallocatePool (Log->Count * sizeof (REPLAY_DRIVER), Capacity * sizeof (REPLAY_DRIVER), Log->Drivers);
+      if (Drivers == NULL) {
+        Valid = FALSE;
+        break;
+      }
+
+      Log->Drivers = Drivers;
+    }
+
+    Driver = &Log->Drivers[Log->Count++];
+    ZeroMem (Driver, sizeof (REPLAY_DRIVER));
+    if (!ParseGuid (Token, &Driver->FileName)) {
+      Valid = FALSE;
+      break;
+    }
+
+    Token  = strtok (NULL, " \t\r\n");
+    Length = (Token == NULL) ? 0 : strlen (Token);
+    if ((Length == 0) || ((Length % 2) != 0)) {
+      Valid = FALSE;
+      break;
+    }
+
+    Driver->DepexSize = Length / 2;
+    Driver->Depex     = AllocatePool (Driver->DepexSize);
+    if (Driver->Depex == NULL) {
+      Valid = FALSE;
+      break;
+    }
+
+    for (Index = 0; Index < Driver->DepexSize; Index++) {
+      if (sscanf (&Token[Index * 2], "%2x", &Byte) != 1) {
+        Valid = FALSE;
+        break;
+      }
+
+      Driver->Depex[Index] = (UINT8)Byte;
+    }
+
+    while (Valid && ((Token = strtok (NULL, " \t\r\n")) != NULL)) {
+      if ((Driver->InstallCount == TEST_LOG_MAX_INSTALLS) ||
+          !ParseGuid (Token, &Installs[Driver->InstallCount]))
+      {
+        Valid = FALSE;
+        break;
+      }
+
+      Driver->InstallCount++;
+    }
+
+    if (Valid && (Driver->InstallCount != 0)) {
+      Driver->Installs = AllocateCopyPool (Driver->InstallCount * sizeof (EFI_GUID), Installs);
+      Valid            = (Driver->Installs != NULL);
+    }
+  }
+
+  fclose (File);
+  if (Line != NULL) {
+    FreePool (Line);
+  }
+
+  if (!Valid) {
+    FreeLog (Log);
+  }
+
+  return Valid;
+}
+
+/**
+  Check whether a protocol is installed in the model protocol database.
+
+  @param[in]  Database  The model protocol database.
+  @param[in]  Protocol  The protocol.
+
+  @retval TRUE   The protocol is installed.
+  @retval FALSE  The protocol is not installed.
+**/
+STATIC
+BOOLEAN
+IsInstalled (
+  IN CONST HANDLE_INDEX  *Database,
+  IN CONST EFI_GUID      *Protocol
+  )
+{
+  HANDLE_INDEX_LINK  *Link;
+  TEST_PROTOCOL      *Item;
+  UINT32             Hash;
+
+  Hash = HandleIndexHashGuid (Protocol);
+  for (Link = HandleIndexFirst (Database, Hash); Link != NULL; Link = HandleIndexNext (Link)) {
+    Item = BASE_CR (Link, TEST_PROTOCOL, IndexLink);
+    if (CompareGuid (&Item->ProtocolID, Protocol)) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Evaluate a dependency expression like CoreIsSchedulable(), patching the
+  pushes of installed protocols to EFI_DEP_REPLACE_TRUE.
+
+  @param[in]       Database  The model protocol database.
+  @param[in]       Driver    The driver.
+  @param[in, out]  Lookups   Incremented for each protocol looked up.
+
+  @retval TRUE   The dependency expression is satisfied.
+  @retval FALSE  The dependency expression is not satisfied or is malformed.
+**/
+STATIC
+BOOLEAN
+EvaluateDepex (
+  IN     CONST HANDLE_INDEX  *Database,
+  IN     TEST_DRIVER         *Driver,
+  IN OUT UINTN               *Lookups
+  )
+{
+  BOOLEAN   Stack[TEST_DEPEX_STACK_SIZE];
+  UINTN     Top;
+  UINTN     Offset;
+  UINTN     Size;
+  UINT8     *Depex;
+  EFI_GUID  Protocol;
+
+  Depex = Driver->Depex;
+  Size  = Driver->Replay->DepexSize;
+  Top   = 0;
+  for (Offset = 0; Offset < Size; Offset++) {
+    switch (Depex[Offset]) {
+      case EFI_DEP_SOR:
+        if (Offset != 0) {
+          return FALSE;
+        }
+
+        break;
+
+      case EFI_DEP_PUSH:
+      case EFI_DEP_REPLACE_TRUE:
+        if ((Top == TEST_DEPEX_STACK_SIZE) || (Size - Offset - 1 < sizeof (EFI_GUID))) {
+          return FALSE;
+        }
+
+        if (Depex[Offset] == EFI_DEP_REPLACE_TRUE) {
+          Stack[Top++] = TRUE;
+        } else {
+          CopyMem (&Protocol, &Depex[Offset + 1], sizeof (EFI_GUID));
+          Stack[Top] = IsInstalled (Database, &Protocol);
+          (*Lookups)++;
+          if (Stack[Top++]) {
+            Depex[Offset] = EFI_DEP_REPLACE_TRUE;
+          }
+        }
+
+        Offset += sizeof (EFI_GUID);
+        break;
+
+      case EFI_DEP_AND:
+      case EFI_DEP_OR:
+        if (Top < 2) {
+          return FALSE;
+        }
+
+        Top--;
+        if (Depex[Offset] == EFI_DEP_AND) {
+          Stack[Top - 1] = (BOOLEAN)(Stack[Top - 1] && Stack[Top]);
+        } else {
+          Stack[Top - 1] = (BOOLEAN)(Stack[Top - 1] || Stack[Top]);
+        }
+
+        break;
+
+      case EFI_DEP_NOT:
+        if (Top < 1) {
+          return FALSE;
+        }
+
+        Stack[Top - 1] = (BOOLEAN)!Stack[Top - 1];
+        break;
+
+      case EFI_DEP_TRUE:
+      case EFI_DEP_FALSE:
+        if (Top == TEST_DEPEX_STACK_SIZE) {
+          return FALSE;
+        }
+
+        Stack[Top++] = (BOOLEAN)(Depex[Offset] == EFI_DEP_TRUE);
+        break;
+
+      case EFI_DEP_END:
+        return (BOOLEAN)((Top >= 1) && Stack[Top - 1]);
+
+      default:
+        //
+        // BEFORE, AFTER and unknown opcodes.
+        //
+        return FALSE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Replay a dispatch log through a model of the CoreDispatcher() scan loop.
+
+  @param[in]   Log      The log.
+  @param[in]   Watched  TRUE to only evaluate the dependency expressions
+                        the watch index marks dirty.
+  @param[out]  Result   The dispatch order, the number of dependency
+                        expression evaluations and protocol lookups, and the
+                        replay time. The Order buffer must hold Log->Count
+                        entries.
+**/
+STATIC
+VOID
+Replay (
+  IN  CONST REPLAY_LOG  *Log,
+  IN  BOOLEAN           Watched,
+  OUT REPLAY_RESULT     *Result
+  )
+{
+  TEST_DRIVER        *Drivers;
+  TEST_DRIVER        *Driver;
+  TEST_PROTOCOL      *Protocols;
+  UINTN              ProtocolCount;
+  UINTN              Index;
+  UINTN              Install;
+  HANDLE_INDEX       Database;
+  DEPEX_WATCH_INDEX  WatchIndex;
+  LIST_ENTRY         Discovered;
+  LIST_ENTRY         Scheduled;
+  LIST_ENTRY         *Link;
+  DEPEX_WATCHER      *Watcher;
+  UINTN              NotifyCount;
+  BOOLEAN            ReadyToRun;
+  UINT64             Start;
+
+  ProtocolCount = 0;
+  for (Index = 0; Index < Log->Count; Index++) {
+    ProtocolCount += Log->Drivers[Index].InstallCount;
+  }
+
+  Drivers   = AllocateZeroPool (Log->Count * sizeof (TEST_DRIVER));
+  Protocols = AllocatePool ((ProtocolCount + 1) * sizeof (TEST_PROTOCOL));
+  ASSERT (Drivers != NULL && Protocols != NULL);
+
+  ZeroMem (&Database, sizeof (Database));
+  ZeroMem (&WatchIndex, sizeof (WatchIndex));
+  InitializeListHead (&Discovered);
+  InitializeListHead (&Scheduled);
+  for (Index = 0; Index < Log->Count; Index++) {
+    Drivers[Index].Replay    = &Log->Drivers[Index];
+    Drivers[Index].Depex     = AllocateCopyPool (Log->Drivers[Index].DepexSize, Log->Drivers[Index].Depex);
+    Drivers[Index].Dependent = TRUE;
+    ASSERT (Drivers[Index].Depex != NULL);
+    InsertTailList (&Discovered, &Drivers[Index].Link);
+  }
+
+  Result->Dispatched  = 0;
+  Result->Evaluations = 0;
+  Result->Lookups     = 0;
+  ProtocolCount       = 0;
+
+  Start = UnitTestBenchmarkStart ();
+  do {
+    //
+    // Drain the scheduled queue
+    //
+    while (!IsListEmpty (&Scheduled)) {
+      Driver = BASE_CR (Scheduled.ForwardLink, TEST_DRIVER, ScheduledLink);
+      RemoveEntryList (&Driver->ScheduledLink);
+      Result->Order[Result->Dispatched++] = (UINTN)(Driver - Drivers);
+
+      for (Install = 0; Install < Driver->Replay->InstallCount; Install++) {
+        CopyGuid (&Protocols[ProtocolCount].ProtocolID, &Driver->Replay->Installs[Install]);
+        HandleIndexInsert (
+          &Database,
+          &Protocols[ProtocolCount].IndexLink,
+          HandleIndexHashGuid (&Protocols[ProtocolCount].ProtocolID)
+          );
+        ProtocolCount++;
+        if (Watched) {
+          DepexWatchNotify (&WatchIndex, &Driver->Replay->Installs[Install]);
+        }
+      }
+    }
+
+    //
+    // Search the discovered drivers for drivers to schedule
+    //
+    ReadyToRun = FALSE;
+    for (Link = Discovered.ForwardLink; Link != &Discovered; Link = Link->ForwardLink) {
+      Driver = BASE_CR (Link, TEST_DRIVER, Link);
+      if (!Driver->Dependent) {
+        continue;
+      }
+
+      //
+      // Like CoreIsSchedulableOnChange()
+      //
+      Watcher = &Driver->DepexWatcher;
+      if (Watched && Watcher->Registered && !Watcher->Dirty) {
+        continue;
+      }
+
+      Watcher->Dirty = FALSE;
+      NotifyCount    = WatchIndex.NotifyCount;
+      Result->Evaluations++;
+      if (EvaluateDepex (&Database, Driver, &Result->Lookups)) {
+        if (Watched) {
+          DepexWatchUnregister (&WatchIndex, Watcher);
+        }
+
+        Driver->Dependent = FALSE;
+        InsertTailList (&Scheduled, &Driver->ScheduledLink);
+        ReadyToRun = TRUE;
+      } else if (Watched && !Watcher->Registered) {
+        DepexWatchRegister (&WatchIndex, Watcher, Driver->Depex, Driver->Replay->DepexSize);
+        Watcher->Dirty = (BOOLEAN)(NotifyCount != WatchIndex.NotifyCount);
+      }
+    }
+  } while (ReadyToRun);
+
+  Result->Ns = UnitTestBenchmarkStop (Start);
+
+  for (Index = 0; Index < Log->Count; Index++) {
+    DepexWatchUnregister (&WatchIndex, &Drivers[Index].DepexWatcher);
+    FreePool (Drivers[Index].Depex);
+  }
+
+  ASSERT (WatchIndex.LinkCount == 0);
+  FreePool (Drivers);
+  FreePool (Protocols);
+}
+
+/**
+  Replay a log with and without the watch index and compare the results.
+
+  @param[in]   Log    The log.
+  @param[out]  Full   The result of the replay without the index.
+  @param[out]  Watch  The result of the replay with the index.
+
+  @retval  UNIT_TEST_PASSED             The dispatch orders match.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+ReplayAndCompare (
+  IN  CONST REPLAY_LOG  *Log,
+  OUT REPLAY_RESULT     *Full,
+  OUT REPLAY_RESULT     *Watch
+  )
+{
+  UINTN  Index;
+
+  Replay (Log, FALSE, Full);
+  Replay (Log, TRUE, Watch);
+
+  UT_ASSERT_EQUAL (Full->Dispatched, Watch->Dispatched);
+  for (Index = 0; Index < Full->Dispatched; Index++) {
+    UT_ASSERT_EQUAL (Full->Order[Index], Watch->Order[Index]);
+  }
+
+  UT_ASSERT_TRUE (Watch->Evaluations <= Full->Evaluations);
+  UT_ASSERT_TRUE (Watch->Lookups <= Full->Lookups);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check the links the index creates for a dependency expression.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+WatchLinksShouldFollowPushes (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  DEPEX_WATCH_INDEX  Index;
+  DEPEX_WATCHER      Watcher;
+  DEPEX_WATCHER      Other;
+  EFI_GUID           Guids[3];
+  UINT8              Depex[4 * (1 + sizeof (EFI_GUID)) + 4];
+  UINTN              Size;
+  UINT32             Seed;
+
+  Seed = 5;
+  RandomGuid (&Seed, &Guids[0]);
+  RandomGuid (&Seed, &Guids[1]);
+  RandomGuid (&Seed, &Guids[2]);
+  ZeroMem (&Index, sizeof (Index));
+  ZeroMem (&Watcher, sizeof (Watcher));
+  ZeroMem (&Other, sizeof (Other));
+
+  //
+  // SOR PUSH 0 PUSH 1 AND PUSH 0 OR, with PUSH 1 already found installed
+  //
+  Size          = 0;
+  Depex[Size++] = EFI_DEP_SOR;
+  AppendPush (Depex, &Size, &Guids[0]);
+  AppendPush (Depex, &Size, &Guids[1]);
+  Depex[Size - 1 - sizeof (EFI_GUID)] = EFI_DEP_REPLACE_TRUE;
+  Depex[Size++]                       = EFI_DEP_AND;
+  AppendPush (Depex, &Size, &Guids[0]);
+  Depex[Size++] = EFI_DEP_OR;
+  Depex[Size++] = EFI_DEP_END;
+
+  UT_ASSERT_NOT_EFI_ERROR (DepexWatchRegister (&Index, &Watcher, Depex, Size));
+  UT_ASSERT_TRUE (Watcher.Registered);
+  UT_ASSERT_FALSE (Watcher.Dirty);
+  UT_ASSERT_EQUAL (Index.LinkCount, 1);
+
+  //
+  // A truncated push is not watched, and a registration with no push leaves
+  // the watcher registered without links.
+  //
+  UT_ASSERT_NOT_EFI_ERROR (DepexWatchRegister (&Index, &Other, Depex, 1 + 1 + sizeof (EFI_GUID) - 1));
+  UT_ASSERT_TRUE (Other.Registered);
+  UT_ASSERT_EQUAL (Index.LinkCount, 1);
+
+  UT_ASSERT_EQUAL (DepexWatchNotify (&Index, &Guids[1]), 0);
+  UT_ASSERT_EQUAL (DepexWatchNotify (&Index, &Guids[2]), 0);
+  UT_ASSERT_FALSE (Watcher.Dirty);
+  UT_ASSERT_EQUAL (DepexWatchNotify (&Index, &Guids[0]), 1);
+  UT_ASSERT_TRUE (Watcher.Dirty);
+
+  DepexWatchUnregister (&Index, &Watcher);
+  DepexWatchUnregister (&Index, &Other);
+  UT_ASSERT_FALSE (Watcher.Registered);
+  UT_ASSERT_EQUAL (Index.LinkCount, 0);
+  Watcher.Dirty = FALSE;
+  UT_ASSERT_EQUAL (DepexWatchNotify (&Index, &Guids[0]), 0);
+  UT_ASSERT_FALSE (Watcher.Dirty);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Replay random small logs with and without the index and compare the
+  dispatch orders.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+RandomLogsShouldDispatchInSameOrder (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  REPLAY_LOG        Log;
+  REPLAY_RESULT     Full;
+  REPLAY_RESULT     Watch;
+  UINTN             Round;
+  UNIT_TEST_STATUS  Status;
+
+  Full.Order  = AllocatePool (TEST_RANDOM_DRIVERS * sizeof (UINTN));
+  Watch.Order = AllocatePool (TEST_RANDOM_DRIVERS * sizeof (UINTN));
+  UT_ASSERT_NOT_NULL (Full.Order);
+  UT_ASSERT_NOT_NULL (Watch.Order);
+
+  Status = UNIT_TEST_PASSED;
+  for (Round = 0; Round < TEST_RANDOM_LOGS && Status == UNIT_TEST_PASSED; Round++) {
+    GenerateLog (&Log, TEST_RANDOM_DRIVERS, (UINT32)Round + 1);
+    Status = ReplayAndCompare (&Log, &Full, &Watch);
+    FreeLog (&Log);
+  }
+
+  FreePool (Full.Order);
+  FreePool (Watch.Order);
+  return Status;
+}
+
+/**
+  Load the recorded log, or generate a synthetic one.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The log is ready.
+  @retval  UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  The recorded log cannot be
+                                                 loaded.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+PrepareLog (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONST CHAR8  *Path;
+
+  Path = getenv ("DEPEX_WATCH_REPLAY_LOG");
+  if (Path != NULL) {
+    if (!LoadLog (Path, &mLog)) {
+      DEBUG ((DEBUG_ERROR, "Cannot load dispatch log %a\n", Path));
+      return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+    }
+
+    return UNIT_TEST_PASSED;
+  }
+
+  GenerateLog (&mLog, TEST_DRIVER_COUNT, 0x5EED);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Free the log.
+
+  @param[in]  Context    Unused.
+**/
+STATIC
+VOID
+EFIAPI
+CleanupLog (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  FreeLog (&mLog);
+}
+
+/**
+  Replay the log with and without the index, compare the dispatch orders
+  and report the number of evaluations and the replay times.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+ReplayLogBenchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  REPLAY_RESULT     Full;
+  REPLAY_RESULT     Watch;
+  UINT64            FullNs;
+  UINT64            WatchNs;
+  UINTN             Round;
+  UNIT_TEST_STATUS  Status;
+
+  Full.Order  = AllocatePool (mLog.Count * sizeof (UINTN));
+  Watch.Order = AllocatePool (mLog.Count * sizeof (UINTN));
+  UT_ASSERT_NOT_NULL (Full.Order);
+  UT_ASSERT_NOT_NULL (Watch.Order);
+
+  //
+  // Keep the fastest of a few replays, to leave out the cold caches.
+  //
+  FullNs  = MAX_UINT64;
+  WatchNs = MAX_UINT64;
+  Status  = UNIT_TEST_PASSED;
+  for (Round = 0; Round < TEST_REPLAY_ROUNDS && Status == UNIT_TEST_PASSED; Round++) {
+    Status  = ReplayAndCompare (&mLog, &Full, &Watch);
+    FullNs  = MIN (FullNs, Full.Ns);
+    WatchNs = MIN (WatchNs, Watch.Ns);
+  }
+
+  Full.Ns  = FullNs;
+  Watch.Ns = WatchNs;
+  if (Status == UNIT_TEST_PASSED) {
+    UT_LOG_INFO (
+      "%ld drivers, %ld dispatched: %ld evaluations, %ld lookups, %ld ns (full) vs %ld evaluations, %ld lookups, %ld ns (watched)\n",
+      (UINT64)mLog.Count,
+      (UINT64)Full.Dispatched,
+      (UINT64)Full.Evaluations,
+      (UINT64)Full.Lookups,
+      Full.Ns,
+      (UINT64)Watch.Evaluations,
+      (UINT64)Watch.Lookups,
+      Watch.Ns
+      );
+  }
+
+  FreePool (Full.Order);
+  FreePool (Watch.Order);
+  return Status;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  dependency watch index and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      WatchTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&WatchTests, Framework, "DXE Core Dependency Watch Tests", "DxeCore.DepexWatch", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for DXE Core Dependency Watch Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite------Description-------------------Name----------Function-------------------------------Pre---------Post--------Context-----------
+  //
+  AddTestCase (WatchTests, "Watch links", "WatchLinks", WatchLinksShouldFollowPushes, NULL, NULL, NULL);
+  AddTestCase (WatchTests, "Random dispatch logs", "RandomLogs", RandomLogsShouldDispatchInSameOrder, NULL, NULL, NULL);
+  AddTestCase (WatchTests, "Dispatch log replay benchmark", "Replay", ReplayLogBenchmark, PrepareLog, CleanupLog, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define DepexWatchUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+DepexWatchUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  UnitTestingEntry ();
+  return 0;
+}
@@ -0,0 +1,534 @@
+/** @file
+  Unit tests and microbenchmark of the DXE core handle and protocol index.
+
+  The benchmark builds a handle database shaped like the one of a typical
+  platform at BDS (a few thousand handles and a few hundred protocol GUIDs),
+  and compares handle validation and protocol entry lookup through the index
+  against the linear list walks the index replaces.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/UnitTestBenchmarkLib.h>
+
+#include "../../../../../Core/Dxe/Hand/HandleIndex.h"
+
+#define UNIT_TEST_APP_NAME     "DXE Core Handle Index Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_HANDLE_COUNT    2000
+#define TEST_PROTOCOL_COUNT  400
+#define TEST_BENCH_LOOKUPS   1000000
+
+#define TEST_HANDLE_SIGNATURE    SIGNATURE_32('t','h','n','d')
+#define TEST_PROTOCOL_SIGNATURE  SIGNATURE_32('t','p','r','t')
+
+///
+/// Mirror of the IHANDLE fields used by the handle lookups.
+///
+typedef struct {
+  UINTN                Signature;
+  LIST_ENTRY           AllHandles;
+  HANDLE_INDEX_LINK    IndexLink;
+} TEST_HANDLE;
+
+///
+/// Mirror of the PROTOCOL_ENTRY fields used by the protocol lookups.
+///
+typedef struct {
+  UINTN                Signature;
+  LIST_ENTRY           AllEntries;
+  HANDLE_INDEX_LINK    IndexLink;
+  EFI_GUID             ProtocolID;
+} TEST_PROTOCOL;
+
+STATIC LIST_ENTRY     mHandleList   = INITIALIZE_LIST_HEAD_VARIABLE (mHandleList);
+STATIC LIST_ENTRY     mProtocolList = INITIALIZE_LIST_HEAD_VARIABLE (mProtocolList);
+STATIC HANDLE_INDEX   mHandleIndex;
+STATIC HANDLE_INDEX   mProtocolIndex;
+STATIC TEST_HANDLE    *mHandles;
+STATIC TEST_PROTOCOL  *mProtocols;
+
+/**
+  Validate a handle with the linear walk of the handle list.
+
+  @param  Handle                 The handle to validate.
+
+  @retval TRUE                   Handle is in the handle list.
+  @retval FALSE                  Handle is not in the handle list.
+**/
+STATIC
+BOOLEAN
+ListContainsHandle (
+  IN VOID  *Handle
+  )
+{
+  LIST_ENTRY  *Link;
+
+  for (Link = mHandleList.BackLink; Link != &mHandleList; Link = Link->BackLink) {
+    if (BASE_CR (Link, TEST_HANDLE, AllHandles) == Handle) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Validate a handle through the handle index.
+
+  @param  Handle                 The handle to validate.
+
+  @retval TRUE                   Handle is in the index.
+  @retval FALSE                  Handle is not in the index.
+**/
+STATIC
+BOOLEAN
+IndexContainsHandle (
+  IN VOID  *Handle
+  )
+{
+  HANDLE_INDEX_LINK  *Link;
+
+  for (Link = HandleIndexFirst (&mHandleIndex, HandleIndexHashPointer (Handle));
+       Link != NULL;
+       Link = HandleIndexNext (Link))
+  {
+    if (BASE_CR (Link, TEST_HANDLE, IndexLink) == Handle) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Find a protocol entry with the linear walk of the protocol list.
+
+  @param  Guid                   The protocol GUID.
+
+  @return The protocol entry, or NULL.
+**/
+STATIC
+TEST_PROTOCOL *
+ListFindProtocol (
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  LIST_ENTRY     *Link;
+  TEST_PROTOCOL  *Protocol;
+
+  for (Link = mProtocolList.ForwardLink; Link != &mProtocolList; Link = Link->ForwardLink) {
+    Protocol = BASE_CR (Link, TEST_PROTOCOL, AllEntries);
+    if (CompareGuid (&Protocol->ProtocolID, Guid)) {
+      return Protocol;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Find a protocol entry through the protocol index.
+
+  @param  Guid                   The protocol GUID.
+
+  @return The protocol entry, or NULL.
+**/
+STATIC
+TEST_PROTOCOL *
+IndexFindProtocol (
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  HANDLE_INDEX_LINK  *Link;
+  TEST_PROTOCOL      *Protocol;
+
+  for (Link = HandleIndexFirst (&mProtocolIndex, HandleIndexHashGuid (Guid));
+       Link != NULL;
+       Link = HandleIndexNext (Link))
+  {
+    Protocol = BASE_CR (Link, TEST_PROTOCOL, IndexLink);
+    if (CompareGuid (&Protocol->ProtocolID, Guid)) {
+      return Protocol;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Build the handle and protocol population used by every test case.
+
+  Protocol GUIDs share their last eight bytes in groups, like the GUIDs of
+  one package often do, to make sure the hash does not depend on them.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED                      The population is ready.
+  @retval  UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  Out of memory.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+BuildPopulation (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN   Index;
+  UINT32  Seed;
+
+  mHandles   = AllocateZeroPool (TEST_HANDLE_COUNT * sizeof (TEST_HANDLE));
+  mProtocols = AllocateZeroPool (TEST_PROTOCOL_COUNT * sizeof (TEST_PROTOCOL));
+  if ((mHandles == NULL) || (mProtocols == NULL)) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  InitializeListHead (&mHandleList);
+  InitializeListHead (&mProtocolList);
+  ZeroMem (&mHandleIndex, sizeof (mHandleIndex));
+  ZeroMem (&mProtocolIndex, sizeof (mProtocolIndex));
+
+  for (Index = 0; Index < TEST_HANDLE_COUNT; Index++) {
+    mHandles[Index].Signature = TEST_HANDLE_SIGNATURE;
+    InsertTailList (&mHandleList, &mHandles[Index].AllHandles);
+    HandleIndexInsert (&mHandleIndex, &mHandles[Index].IndexLink, HandleIndexHashPointer (&mHandles[Index]));
+  }
+
+  Seed = 7;
+  for (Index = 0; Index < TEST_PROTOCOL_COUNT; Index++) {
+    mProtocols[Index].Signature        = TEST_PROTOCOL_SIGNATURE;
+    mProtocols[Index].ProtocolID.Data1 = UnitTestRandom (&Seed) ^ (UnitTestRandom (&Seed) << 16);
+    mProtocols[Index].ProtocolID.Data2 = (UINT16)UnitTestRandom (&Seed);
+    mProtocols[Index].ProtocolID.Data3 = (UINT16)UnitTestRandom (&Seed);
+    SetMem (mProtocols[Index].ProtocolID.Data4, sizeof (mProtocols[Index].ProtocolID.Data4), (UINT8)(Index / 16));
+    InsertTailList (&mProtocolList, &mProtocols[Index].AllEntries);
+    HandleIndexInsert (
+      &mProtocolIndex,
+      &mProtocols[Index].IndexLink,
+      HandleIndexHashGuid (&mProtocols[Index].ProtocolID)
+      );
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Free the handle and protocol population.
+
+  @param[in]  Context    Unused.
+**/
+STATIC
+VOID
+EFIAPI
+FreePopulation (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  if ((mHandleIndex.Buckets != NULL) && (mHandleIndex.Buckets != mHandleIndex.InitialBuckets)) {
+    FreePool (mHandleIndex.Buckets);
+  }
+
+  if ((mProtocolIndex.Buckets != NULL) && (mProtocolIndex.Buckets != mProtocolIndex.InitialBuckets)) {
+    FreePool (mProtocolIndex.Buckets);
+  }
+
+  FreePool (mHandles);
+  FreePool (mProtocols);
+  mHandles   = NULL;
+  mProtocols = NULL;
+}
+
+/**
+  Check every handle is found, pointers that are not handles are not, and the
+  index grew past its initial bucket array.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+HandleLookupShouldMatchList (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+  UINT8  *Bytes;
+
+  UT_ASSERT_EQUAL (mHandleIndex.Count, TEST_HANDLE_COUNT);
+  UT_ASSERT_TRUE (mHandleIndex.BucketBits > HANDLE_INDEX_INITIAL_BUCKET_BITS);
+
+  for (Index = 0; Index < TEST_HANDLE_COUNT; Index++) {
+    UT_ASSERT_TRUE (IndexContainsHandle (&mHandles[Index]));
+
+    //
+    // Pointers into the middle of a handle, or right past the last one, are
+    // not handles.
+    //
+    Bytes = (UINT8 *)&mHandles[Index];
+    UT_ASSERT_FALSE (IndexContainsHandle (Bytes + sizeof (UINTN)));
+    UT_ASSERT_FALSE (IndexContainsHandle (Bytes + 1));
+  }
+
+  UT_ASSERT_FALSE (IndexContainsHandle (&mHandles[TEST_HANDLE_COUNT]));
+  UT_ASSERT_FALSE (IndexContainsHandle (&Index));
+  UT_ASSERT_FALSE (IndexContainsHandle (NULL));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Remove every other handle and check the index tracks the handle list.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+RemovedHandleShouldBeInvalid (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < TEST_HANDLE_COUNT; Index += 2) {
+    RemoveEntryList (&mHandles[Index].AllHandles);
+    HandleIndexRemove (&mHandleIndex, &mHandles[Index].IndexLink);
+  }
+
+  UT_ASSERT_EQUAL (mHandleIndex.Count, TEST_HANDLE_COUNT / 2);
+
+  for (Index = 0; Index < TEST_HANDLE_COUNT; Index++) {
+    UT_ASSERT_EQUAL (IndexContainsHandle (&mHandles[Index]), ListContainsHandle (&mHandles[Index]));
+    UT_ASSERT_EQUAL (IndexContainsHandle (&mHandles[Index]), (BOOLEAN)((Index & 1) != 0));
+  }
+
+  //
+  // Put the handles back, in a different order.
+  //
+  for (Index = TEST_HANDLE_COUNT; Index > 0; Index -= 2) {
+    InsertTailList (&mHandleList, &mHandles[Index - 2].AllHandles);
+    HandleIndexInsert (&mHandleIndex, &mHandles[Index - 2].IndexLink, HandleIndexHashPointer (&mHandles[Index - 2]));
+  }
+
+  for (Index = 0; Index < TEST_HANDLE_COUNT; Index++) {
+    UT_ASSERT_TRUE (IndexContainsHandle (&mHandles[Index]));
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check every protocol GUID resolves to its own entry, and GUIDs that differ
+  in a single byte do not resolve.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+ProtocolLookupShouldMatchList (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN     Index;
+  UINTN     Byte;
+  EFI_GUID  Guid;
+
+  UT_ASSERT_EQUAL (mProtocolIndex.Count, TEST_PROTOCOL_COUNT);
+
+  for (Index = 0; Index < TEST_PROTOCOL_COUNT; Index++) {
+    UT_ASSERT_EQUAL ((UINTN)IndexFindProtocol (&mProtocols[Index].ProtocolID), (UINTN)&mProtocols[Index]);
+
+    for (Byte = 0; Byte < sizeof (EFI_GUID); Byte++) {
+      CopyGuid (&Guid, &mProtocols[Index].ProtocolID);
+      ((UINT8 *)&Guid)[Byte] ^= 0x01;
+      UT_ASSERT_EQUAL ((UINTN)IndexFindProtocol (&Guid), (UINTN)ListFindProtocol (&Guid));
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Measure handle validation and protocol entry lookup through the index and
+  through the list walks.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkLookups (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32  Seed;
+  UINTN   Index;
+  UINTN   Found;
+  UINT64  Start;
+  UINT64  ListHandleNs;
+  UINT64  IndexHandleNs;
+  UINT64  ListProtocolNs;
+  UINT64  IndexProtocolNs;
+
+  Seed  = 1;
+  Found = 0;
+  Start = UnitTestBenchmarkStart ();
+  for (Index = 0; Index < TEST_BENCH_LOOKUPS / 100; Index++) {
+    Found += ListContainsHandle (&mHandles[UnitTestRandom (&Seed) % TEST_HANDLE_COUNT]);
+  }
+
+  ListHandleNs = UnitTestBenchmarkStop (Start) * 100;
+  UT_ASSERT_EQUAL (Found, TEST_BENCH_LOOKUPS / 100);
+
+  Seed  = 1;
+  Found = 0;
+  Start = UnitTestBenchmarkStart ();
+  for (Index = 0; Index < TEST_BENCH_LOOKUPS; Index++) {
+    Found += IndexContainsHandle (&mHandles[UnitTestRandom (&Seed) % TEST_HANDLE_COUNT]);
+  }
+
+  IndexHandleNs = UnitTestBenchmarkStop (Start);
+  UT_ASSERT_EQUAL (Found, TEST_BENCH_LOOKUPS);
+
+  Seed  = 1;
+  Found = 0;
+  Start = UnitTestBenchmarkStart ();
+  for (Index = 0; Index < TEST_BENCH_LOOKUPS / 10; Index++) {
+    Found += (ListFindProtocol (&mProtocols[UnitTestRandom (&Seed) % TEST_PROTOCOL_COUNT].ProtocolID) != NULL);
+  }
+
+  ListProtocolNs = UnitTestBenchmarkStop (Start) * 10;
+  UT_ASSERT_EQUAL (Found, TEST_BENCH_LOOKUPS / 10);
+
+  Seed  = 1;
+  Found = 0;
+  Start = UnitTestBenchmarkStart ();
+  for (Index = 0; Index < TEST_BENCH_LOOKUPS; Index++) {
+    Found += (IndexFindProtocol (&mProtocols[UnitTestRandom (&Seed) % TEST_PROTOCOL_COUNT].ProtocolID) != NULL);
+  }
+
+  IndexProtocolNs = UnitTestBenchmarkStop (Start);
+  UT_ASSERT_EQUAL (Found, TEST_BENCH_LOOKUPS);
+
+  UT_LOG_INFO (
+    "%d handles: validate %ld ns (list) vs %ld ns (index) per million lookups\n",
+    TEST_HANDLE_COUNT,
+    ListHandleNs,
+    IndexHandleNs
+    );
+  UT_LOG_INFO (
+    "%d protocols: lookup %ld ns (list) vs %ld ns (index) per million lookups\n",
+    TEST_PROTOCOL_COUNT,
+    ListProtocolNs,
+    IndexProtocolNs
+    );
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the handle
+  index and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      IndexTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&IndexTests, Framework, "DXE Core Handle Index Tests", "DxeCore.HandleIndex", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for DXE Core Handle Index Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite------Description----------------------Name--------------Function------------------------Pre--------------Post------------Context-----------
+  //
+  AddTestCase (IndexTests, "Handle lookup", "HandleLookup", HandleLookupShouldMatchList, BuildPopulation, FreePopulation, NULL);
+  AddTestCase (IndexTests, "Removed handle", "RemovedHandle", RemovedHandleShouldBeInvalid, BuildPopulation, FreePopulation, NULL);
+  AddTestCase (IndexTests, "Protocol lookup", "ProtocolLookup", ProtocolLookupShouldMatchList, BuildPopulation, FreePopulation, NULL);
+  AddTestCase (IndexTests, "Lookup benchmark", "Benchmark", BenchmarkLookups, BuildPopulation, FreePopulation, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define HandleIndexUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+HandleIndexUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  UnitTestingEntry ();
+  return 0;
+}
@@ -0,0 +1,576 @@
+/** @file
+  Unit tests and microbenchmark of the DXE core pool slab cache.
+
+  The benchmark compares the slab cache against a model of the generic pool
+  allocator (linear size class scan and per class free lists carved from
+  pages) under the same mixed small allocation workload.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/UnitTestBenchmarkLib.h>
+
+#include "../../../../../Core/Dxe/Mem/PoolSlab.h"
+
+#define UNIT_TEST_APP_NAME     "DXE Core Pool Slab Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_GRANULARITY    SIZE_4KB
+#define TEST_ARENA_PAGES    8192
+#define TEST_LIVE_OBJECTS   4096
+#define TEST_BENCH_OPS      2000000
+
+//
+// Page arena backing the slab cache under test. Pages are handed out with a
+// bump pointer; freed pages are only accounted.
+//
+STATIC UINT8  *mArena;
+STATIC UINTN  mArenaUsedPages;
+STATIC UINTN  mPagesOutstanding;
+STATIC UINTN  mAllocatePagesCalls;
+
+/**
+  Allocate pages for the slab cache from the test arena.
+
+  @param  MemoryType             The type of memory to allocate.
+  @param  NoPages                The number of pages to allocate.
+  @param  Granularity            The alignment of the allocation in bytes.
+
+  @return The allocated memory, or NULL.
+
+**/
+STATIC
+VOID *
+TestAllocatePages (
+  IN EFI_MEMORY_TYPE  MemoryType,
+  IN UINTN            NoPages,
+  IN UINTN            Granularity
+  )
+{
+  VOID  *Buffer;
+
+  if (mArenaUsedPages + NoPages > TEST_ARENA_PAGES) {
+    return NULL;
+  }
+
+  Buffer               = mArena + EFI_PAGES_TO_SIZE (mArenaUsedPages);
+  mArenaUsedPages     += NoPages;
+  mPagesOutstanding   += NoPages;
+  mAllocatePagesCalls += 1;
+  return Buffer;
+}
+
+/**
+  Free pages of an empty slab back to the test arena.
+
+  @param  MemoryType             The type of memory being freed.
+  @param  Buffer                 The base address of the slab.
+  @param  NoPages                The number of pages to free.
+
+**/
+STATIC
+VOID
+TestFreePages (
+  IN EFI_MEMORY_TYPE  MemoryType,
+  IN VOID             *Buffer,
+  IN UINTN            NoPages
+  )
+{
+  ASSERT (mPagesOutstanding >= NoPages);
+  mPagesOutstanding -= NoPages;
+}
+
+/**
+  Reset the test arena before each test case.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED                The arena is ready.
+  @retval  UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  The arena could not be allocated.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+ResetArena (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  if (mArena == NULL) {
+    mArena = AllocateAlignedPages (TEST_ARENA_PAGES, TEST_GRANULARITY);
+    if (mArena == NULL) {
+      return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+    }
+  }
+
+  mArenaUsedPages     = 0;
+  mPagesOutstanding   = 0;
+  mAllocatePagesCalls = 0;
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Verify the constant time size to class mapping returns the smallest class
+  that fits each size.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SizeToClassShouldPickSmallestFit (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Size;
+  UINTN  Class;
+  UINTN  Expected;
+
+  for (Size = 1; Size <= POOL_SLAB_MAX_OBJECT_SIZE + 64; Size++) {
+    for (Expected = 0; Expected < POOL_SLAB_CLASS_COUNT; Expected++) {
+      if (PoolSlabClassToSize (Expected) >= Size) {
+        break;
+      }
+    }
+
+    Class = PoolSlabSizeToClass (Size);
+    UT_ASSERT_EQUAL (Class, Expected);
+    if (Class < POOL_SLAB_CLASS_COUNT) {
+      UT_ASSERT_TRUE (PoolSlabClassToSize (Class) >= Size);
+      UT_ASSERT_EQUAL (PoolSlabClassToSize (Class) % POOL_SLAB_OBJECT_ALIGNMENT, 0);
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Allocate many objects of every class, check they are aligned, disjoint and
+  writable, then free them all and check the empty slabs are released.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+AllocateFreeShouldRoundTrip (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  POOL_SLAB_CACHE  Cache;
+  UINT8            **Objects;
+  UINTN            Class;
+  UINTN            Index;
+  UINTN            Size;
+  UINTN            Count;
+
+  Count   = 3 * (TEST_GRANULARITY / 48);
+  Objects = AllocateZeroPool (Count * sizeof (UINT8 *));
+  UT_ASSERT_NOT_NULL (Objects);
+
+  PoolSlabInitialize (&Cache, EfiBootServicesData, TEST_GRANULARITY, 4, TestAllocatePages, TestFreePages);
+
+  for (Class = 0; Class < POOL_SLAB_CLASS_COUNT; Class++) {
+    Size = PoolSlabClassToSize (Class);
+    for (Index = 0; Index < Count; Index++) {
+      Objects[Index] = PoolSlabAllocate (&Cache, Class);
+      UT_ASSERT_NOT_NULL (Objects[Index]);
+      UT_ASSERT_EQUAL ((UINTN)Objects[Index] % POOL_SLAB_OBJECT_ALIGNMENT, 0);
+      SetMem (Objects[Index], Size, (UINT8)Index);
+    }
+
+    for (Index = 0; Index < Count; Index++) {
+      UT_ASSERT_EQUAL (Objects[Index][0], (UINT8)Index);
+      UT_ASSERT_EQUAL (Objects[Index][Size - 1], (UINT8)Index);
+    }
+
+    UT_ASSERT_EQUAL (Cache.Class[Class].FreeCount, Cache.Class[Class].SlabCount * Cache.Class[Class].ObjectsPerSlab - Count);
+
+    for (Index = 0; Index < Count; Index++) {
+      UT_ASSERT_NOT_EFI_ERROR (PoolSlabFree (&Cache, Objects[Index]));
+    }
+
+    //
+    // At most one refill batch worth of slabs may be cached once the class
+    // is empty.
+    //
+    UT_ASSERT_TRUE (Cache.Class[Class].SlabCount <= 4);
+    UT_ASSERT_EQUAL (Cache.Class[Class].FreeCount, Cache.Class[Class].SlabCount * Cache.Class[Class].ObjectsPerSlab);
+  }
+
+  FreePool (Objects);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Verify freed objects are reused in LIFO order and refills are batched.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+FreedObjectShouldBeReused (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  POOL_SLAB_CACHE  Cache;
+  VOID             *First;
+  VOID             *Second;
+  UINTN            Index;
+  UINTN            ObjectsPerBatch;
+
+  PoolSlabInitialize (&Cache, EfiBootServicesData, TEST_GRANULARITY, 4, TestAllocatePages, TestFreePages);
+
+  First = PoolSlabAllocate (&Cache, 2);
+  UT_ASSERT_NOT_NULL (First);
+  UT_ASSERT_NOT_EFI_ERROR (PoolSlabFree (&Cache, First));
+  Second = PoolSlabAllocate (&Cache, 2);
+  UT_ASSERT_TRUE (First == Second);
+
+  //
+  // One batch of four slabs serves all of these allocations.
+  //
+  ObjectsPerBatch = 4 * Cache.Class[2].ObjectsPerSlab;
+  for (Index = 1; Index < ObjectsPerBatch; Index++) {
+    UT_ASSERT_NOT_NULL (PoolSlabAllocate (&Cache, 2));
+  }
+
+  UT_ASSERT_EQUAL (mAllocatePagesCalls, 1);
+  UT_ASSERT_EQUAL (Cache.Class[2].SlabCount, 4);
+  UT_ASSERT_NOT_NULL (PoolSlabAllocate (&Cache, 2));
+  UT_ASSERT_EQUAL (mAllocatePagesCalls, 2);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Verify pointers that are not slab objects are rejected.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+InvalidFreeShouldFail (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  POOL_SLAB_CACHE  Cache;
+  UINT8            *Object;
+
+  PoolSlabInitialize (&Cache, EfiBootServicesData, TEST_GRANULARITY, 1, TestAllocatePages, TestFreePages);
+
+  Object = PoolSlabAllocate (&Cache, 0);
+  UT_ASSERT_NOT_NULL (Object);
+  UT_ASSERT_STATUS_EQUAL (PoolSlabFree (&Cache, Object + 8), EFI_INVALID_PARAMETER);
+  UT_ASSERT_NOT_EFI_ERROR (PoolSlabFree (&Cache, Object));
+
+  //
+  // The slab is empty now, so a second free of the object is rejected.
+  //
+  UT_ASSERT_STATUS_EQUAL (PoolSlabFree (&Cache, Object), EFI_INVALID_PARAMETER);
+
+  ZeroMem (mArena + EFI_PAGES_TO_SIZE (mArenaUsedPages), TEST_GRANULARITY);
+  UT_ASSERT_STATUS_EQUAL (PoolSlabFree (&Cache, mArena + EFI_PAGES_TO_SIZE (mArenaUsedPages) + 64), EFI_INVALID_PARAMETER);
+
+  return UNIT_TEST_PASSED;
+}
+
+//
+// Model of the generic pool allocator: the size class is found with a linear
+// scan of the pool size table, each class has a free list refilled by carving
+// one page into blocks, and every free checks whether all blocks of the page
+// are free.
+//
+STATIC CONST UINT16  mModelPoolSizeTable[] = {
+  128, 256, 384, 640, 1024, 1664, 2688, 4352, 7040, 11392, 18432, 29824
+};
+
+#define MODEL_POOL_FREE_SIGNATURE  SIGNATURE_32('m','p','f','0')
+typedef struct {
+  UINT32        Signature;
+  UINT32        Index;
+  LIST_ENTRY    Link;
+} MODEL_POOL_FREE;
+
+STATIC LIST_ENTRY  mModelFreeList[ARRAY_SIZE (mModelPoolSizeTable)];
+
+/**
+  Allocate a block from the generic pool allocator model.
+
+  @param  Size   The size of the block.
+
+  @return The block, or NULL.
+**/
+STATIC
+VOID *
+ModelPoolAllocate (
+  IN UINTN  Size
+  )
+{
+  UINTN            Index;
+  UINTN            Offset;
+  UINT8            *Page;
+  MODEL_POOL_FREE  *Free;
+
+  for (Index = 0; Index < ARRAY_SIZE (mModelPoolSizeTable); Index++) {
+    if (mModelPoolSizeTable[Index] >= Size) {
+      break;
+    }
+  }
+
+  if (IsListEmpty (&mModelFreeList[Index])) {
+    Page = TestAllocatePages (EfiBootServicesData, 1, TEST_GRANULARITY);
+    if (Page == NULL) {
+      return NULL;
+    }
+
+    for (Offset = 0; Offset + mModelPoolSizeTable[Index] <= TEST_GRANULARITY; Offset += mModelPoolSizeTable[Index]) {
+      Free            = (MODEL_POOL_FREE *)(Page + Offset);
+      Free->Signature = MODEL_POOL_FREE_SIGNATURE;
+      Free->Index     = (UINT32)Index;
+      InsertHeadList (&mModelFreeList[Index], &Free->Link);
+    }
+  }
+
+  Free = BASE_CR (mModelFreeList[Index].ForwardLink, MODEL_POOL_FREE, Link);
+  RemoveEntryList (&Free->Link);
+  Free->Signature = 0;
+  return Free;
+}
+
+/**
+  Free a block to the generic pool allocator model.
+
+  @param  Buffer  The block.
+  @param  Size    The size the block was allocated with.
+**/
+STATIC
+VOID
+ModelPoolFree (
+  IN VOID   *Buffer,
+  IN UINTN  Size
+  )
+{
+  UINTN            Index;
+  UINTN            Offset;
+  UINT8            *Page;
+  MODEL_POOL_FREE  *Free;
+
+  for (Index = 0; Index < ARRAY_SIZE (mModelPoolSizeTable); Index++) {
+    if (mModelPoolSizeTable[Index] >= Size) {
+      break;
+    }
+  }
+
+  Free            = Buffer;
+  Free->Signature = MODEL_POOL_FREE_SIGNATURE;
+  Free->Index     = (UINT32)Index;
+  InsertHeadList (&mModelFreeList[Index], &Free->Link);
+
+  //
+  // The page itself is kept, only the cost of the scan is modeled.
+  //
+  Page   = (UINT8 *)((UINTN)Buffer & ~(TEST_GRANULARITY - 1));
+  Offset = 0;
+  while (Offset + mModelPoolSizeTable[Index] <= TEST_GRANULARITY) {
+    Free = (MODEL_POOL_FREE *)(Page + Offset);
+    if (Free->Signature != MODEL_POOL_FREE_SIGNATURE) {
+      break;
+    }
+
+    Offset += mModelPoolSizeTable[Free->Index];
+  }
+}
+
+/**
+  Run the same mixed alloc/free workload on the slab cache and on the generic
+  pool model, and report allocations per second for both.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkAllocationRate (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  POOL_SLAB_CACHE  Cache;
+  VOID             **Objects;
+  UINT16           *Sizes;
+  UINT32           Seed;
+  UINTN            Index;
+  UINTN            Slot;
+  UINT64           Start;
+  UINT64           SlabNs;
+  UINT64           ModelNs;
+
+  Objects = AllocateZeroPool (TEST_LIVE_OBJECTS * sizeof (VOID *));
+  Sizes   = AllocateZeroPool (TEST_LIVE_OBJECTS * sizeof (UINT16));
+  UT_ASSERT_NOT_NULL (Objects);
+  UT_ASSERT_NOT_NULL (Sizes);
+
+  //
+  // Slab cache
+  //
+  PoolSlabInitialize (&Cache, EfiBootServicesData, TEST_GRANULARITY, 4, TestAllocatePages, TestFreePages);
+  Seed  = 1;
+  Start = UnitTestBenchmarkStart ();
+  for (Index = 0; Index < TEST_BENCH_OPS; Index++) {
+    Slot = UnitTestRandom (&Seed) % TEST_LIVE_OBJECTS;
+    if (Objects[Slot] != NULL) {
+      PoolSlabFree (&Cache, Objects[Slot]);
+    }
+
+    Sizes[Slot]   = (UINT16)(40 + UnitTestRandom (&Seed) % (POOL_SLAB_MAX_OBJECT_SIZE - 40));
+    Objects[Slot] = PoolSlabAllocate (&Cache, PoolSlabSizeToClass (Sizes[Slot]));
+    UT_ASSERT_NOT_NULL (Objects[Slot]);
+  }
+
+  SlabNs = UnitTestBenchmarkStop (Start);
+
+  ResetArena (NULL);
+  ZeroMem (Objects, TEST_LIVE_OBJECTS * sizeof (VOID *));
+
+  //
+  // Generic pool model
+  //
+  for (Index = 0; Index < ARRAY_SIZE (mModelFreeList); Index++) {
+    InitializeListHead (&mModelFreeList[Index]);
+  }
+
+  Seed  = 1;
+  Start = UnitTestBenchmarkStart ();
+  for (Index = 0; Index < TEST_BENCH_OPS; Index++) {
+    Slot = UnitTestRandom (&Seed) % TEST_LIVE_OBJECTS;
+    if (Objects[Slot] != NULL) {
+      ModelPoolFree (Objects[Slot], Sizes[Slot]);
+    }
+
+    Sizes[Slot]   = (UINT16)(40 + UnitTestRandom (&Seed) % (POOL_SLAB_MAX_OBJECT_SIZE - 40));
+    Objects[Slot] = ModelPoolAllocate (Sizes[Slot]);
+    UT_ASSERT_NOT_NULL (Objects[Slot]);
+  }
+
+  ModelNs = UnitTestBenchmarkStop (Start);
+
+  UT_LOG_INFO (
+    "Slab: %ld allocs/sec, generic pool model: %ld allocs/sec\n",
+    UnitTestBenchmarkRate (TEST_BENCH_OPS, SlabNs),
+    UnitTestBenchmarkRate (TEST_BENCH_OPS, ModelNs)
+    );
+
+  FreePool (Objects);
+  FreePool (Sizes);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the pool slab
+  cache and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      SlabTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&SlabTests, Framework, "DXE Core Pool Slab Tests", "DxeCore.PoolSlab", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for DXE Core Pool Slab Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-----Description-------------------------Name-------------Function-----------------------------Pre---------Post---Context-----------
+  //
+  AddTestCase (SlabTests, "Size to class mapping", "SizeToClass", SizeToClassShouldPickSmallestFit, ResetArena, NULL, NULL);
+  AddTestCase (SlabTests, "Allocate and free round trip", "RoundTrip", AllocateFreeShouldRoundTrip, ResetArena, NULL, NULL);
+  AddTestCase (SlabTests, "Freed object reuse", "Reuse", FreedObjectShouldBeReused, ResetArena, NULL, NULL);
+  AddTestCase (SlabTests, "Invalid free", "InvalidFree", InvalidFreeShouldFail, ResetArena, NULL, NULL);
+  AddTestCase (SlabTests, "Allocation rate benchmark", "Benchmark", BenchmarkAllocationRate, ResetArena, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define PoolSlabUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+PoolSlabUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  UnitTestingEntry ();
+  return 0;
+}
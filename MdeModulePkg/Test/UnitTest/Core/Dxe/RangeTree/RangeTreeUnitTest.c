@@ -0,0 +1,456 @@
+/** @file
+  Unit tests and microbenchmark of the DXE core memory map range tree.
+
+  The tests apply random inserts, removals, updates and moves to a set of
+  ranges and check the tree invariants and every lookup against a linear
+  scan of the ranges after each step. The benchmark builds a fragmented
+  memory map of a few thousand descriptors and compares the top down free
+  range search of the page allocator through the tree against the linear
+  walk of the memory map list the tree replaces.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/UnitTestBenchmarkLib.h>
+
+#include "../../../../../Core/Dxe/Mem/RangeTree.h"
+
+#define UNIT_TEST_APP_NAME     "DXE Core Range Tree Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_SLOT_COUNT      512
+#define TEST_SLOT_SIZE       SIZE_64KB
+#define TEST_RANDOM_STEPS    20000
+#define TEST_BENCH_RANGES    4000
+#define TEST_BENCH_SEARCHES  20000
+
+///
+/// One range of the simulated map. Every slot owns an address window that
+/// does not overlap the other ones, and two node storages so that moving a
+/// range to a new location in memory can be exercised.
+///
+typedef struct {
+  BOOLEAN            InTree;
+  UINTN              Active;
+  UINT64             Start;
+  UINT64             FreeSize;
+  RANGE_TREE_NODE    Nodes[2];
+} TEST_RANGE;
+
+STATIC RANGE_TREE  mTree;
+STATIC TEST_RANGE  *mRanges;
+
+/**
+  Check the red-black properties, the order and the cached free sizes of a
+  subtree.
+
+  @param  Node                   The root of the subtree, or NULL.
+  @param  Parent                 The expected parent of Node.
+  @param  Low                    Lowest start address allowed in the subtree.
+  @param  High                   Highest start address allowed in the subtree.
+  @param  Count                  Incremented by the number of nodes.
+
+  @return The black height of the subtree, or -1 if a check failed.
+**/
+STATIC
+INTN
+CheckSubtree (
+  IN     RANGE_TREE_NODE  *Node,
+  IN     RANGE_TREE_NODE  *Parent,
+  IN     UINT64           Low,
+  IN     UINT64           High,
+  IN OUT UINTN            *Count
+  )
+{
+  INTN    LeftHeight;
+  INTN    RightHeight;
+  UINT64  MaxFreeSize;
+
+  if (Node == NULL) {
+    return 1;
+  }
+
+  (*Count)++;
+  if ((Node->Parent != Parent) || (Node->Start < Low) || (Node->Start > High)) {
+    return -1;
+  }
+
+  if (Node->Red && ((Parent == NULL) || Parent->Red)) {
+    return -1;
+  }
+
+  MaxFreeSize = Node->FreeSize;
+  if ((Node->Left != NULL) && (Node->Left->MaxFreeSize > MaxFreeSize)) {
+    MaxFreeSize = Node->Left->MaxFreeSize;
+  }
+
+  if ((Node->Right != NULL) && (Node->Right->MaxFreeSize > MaxFreeSize)) {
+    MaxFreeSize = Node->Right->MaxFreeSize;
+  }
+
+  if (Node->MaxFreeSize != MaxFreeSize) {
+    return -1;
+  }
+
+  LeftHeight  = CheckSubtree (Node->Left, Node, Low, Node->Start - 1, Count);
+  RightHeight = CheckSubtree (Node->Right, Node, Node->Start + 1, High, Count);
+  if ((LeftHeight < 0) || (LeftHeight != RightHeight)) {
+    return -1;
+  }
+
+  return LeftHeight + (Node->Red ? 0 : 1);
+}
+
+/**
+  Find the range whose node has the highest start address not above Address
+  and a free size of at least FreeSize with a linear scan of the ranges.
+
+  @param  Address                The highest start address to accept.
+  @param  FreeSize               The minimum free size, or 0 for any range.
+
+  @return The node of the range, or NULL.
+**/
+STATIC
+RANGE_TREE_NODE *
+LinearFind (
+  IN UINT64  Address,
+  IN UINT64  FreeSize
+  )
+{
+  UINTN  Index;
+
+  for (Index = TEST_SLOT_COUNT; Index > 0; Index--) {
+    if (mRanges[Index - 1].InTree &&
+        (mRanges[Index - 1].Start <= Address) &&
+        (mRanges[Index - 1].FreeSize >= FreeSize))
+    {
+      return &mRanges[Index - 1].Nodes[mRanges[Index - 1].Active];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Allocate the simulated ranges and start with an empty tree.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED                      The ranges are ready.
+  @retval  UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  Out of memory.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+BuildRanges (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  mRanges = AllocateZeroPool (MAX (TEST_SLOT_COUNT, TEST_BENCH_RANGES) * sizeof (TEST_RANGE));
+  if (mRanges == NULL) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  ZeroMem (&mTree, sizeof (mTree));
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Free the simulated ranges.
+
+  @param[in]  Context    Unused.
+**/
+STATIC
+VOID
+EFIAPI
+FreeRanges (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  FreePool (mRanges);
+  mRanges = NULL;
+}
+
+/**
+  Apply random changes to the tree and check it against the ranges after
+  each one.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+RandomChangesShouldMatchLinearScan (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32           Seed;
+  UINTN            Step;
+  UINTN            Slot;
+  UINTN            Count;
+  UINTN            Expected;
+  UINTN            Probe;
+  UINT64           Address;
+  UINT64           FreeSize;
+  TEST_RANGE       *Range;
+  RANGE_TREE_NODE  *Node;
+
+  Seed     = 11;
+  Expected = 0;
+  for (Step = 0; Step < TEST_RANDOM_STEPS; Step++) {
+    Slot  = UnitTestRandom (&Seed) % TEST_SLOT_COUNT;
+    Range = &mRanges[Slot];
+
+    //
+    // Free sizes are 0 half of the time, so the search has to skip ranges.
+    //
+    FreeSize = (UnitTestRandom (&Seed) & 1) ? (UINT64)(UnitTestRandom (&Seed) % 64 + 1) * SIZE_4KB : 0;
+    Address  = (UINT64)Slot * TEST_SLOT_SIZE + (UINT64)(UnitTestRandom (&Seed) % 16) * SIZE_4KB;
+
+    if (!Range->InTree) {
+      Range->InTree   = TRUE;
+      Range->Start    = Address;
+      Range->FreeSize = FreeSize;
+      RangeTreeInsert (&mTree, &Range->Nodes[Range->Active], Address, FreeSize);
+      Expected++;
+    } else {
+      switch (UnitTestRandom (&Seed) % 3) {
+        case 0:
+          Range->InTree = FALSE;
+          RangeTreeRemove (&mTree, &Range->Nodes[Range->Active]);
+          Expected--;
+          break;
+
+        case 1:
+          Range->Start    = Address;
+          Range->FreeSize = FreeSize;
+          RangeTreeUpdate (&Range->Nodes[Range->Active], Address, FreeSize);
+          break;
+
+        default:
+          CopyMem (&Range->Nodes[1 - Range->Active], &Range->Nodes[Range->Active], sizeof (RANGE_TREE_NODE));
+          RangeTreeReplace (&mTree, &Range->Nodes[Range->Active], &Range->Nodes[1 - Range->Active]);
+          SetMem (&Range->Nodes[Range->Active], sizeof (RANGE_TREE_NODE), 0xAF);
+          Range->Active = 1 - Range->Active;
+          break;
+      }
+    }
+
+    Count = 0;
+    UT_ASSERT_TRUE (CheckSubtree (mTree.Root, NULL, 0, MAX_UINT64, &Count) > 0);
+    UT_ASSERT_TRUE ((mTree.Root == NULL) || !mTree.Root->Red);
+    UT_ASSERT_EQUAL (Count, Expected);
+    UT_ASSERT_EQUAL (mTree.Count, Expected);
+
+    for (Probe = 0; Probe < 4; Probe++) {
+      Address  = UnitTestRandom (&Seed) % (TEST_SLOT_COUNT * TEST_SLOT_SIZE + TEST_SLOT_SIZE);
+      FreeSize = (UINT64)(UnitTestRandom (&Seed) % 72 + 1) * SIZE_4KB;
+      UT_ASSERT_EQUAL ((UINTN)RangeTreeFindFloor (&mTree, Address), (UINTN)LinearFind (Address, 0));
+      UT_ASSERT_EQUAL ((UINTN)RangeTreeFindFreeBelow (&mTree, Address, FreeSize), (UINTN)LinearFind (Address, FreeSize));
+    }
+  }
+
+  //
+  // Walking the tree in order visits the ranges by increasing address.
+  //
+  Count = 0;
+  Node  = NULL;
+  for (Slot = 0; Slot < TEST_SLOT_COUNT; Slot++) {
+    if (!mRanges[Slot].InTree) {
+      continue;
+    }
+
+    Node = (Count == 0) ? RangeTreeFindFloor (&mTree, mRanges[Slot].Start) : RangeTreeNext (Node);
+    UT_ASSERT_EQUAL ((UINTN)Node, (UINTN)&mRanges[Slot].Nodes[mRanges[Slot].Active]);
+    Count++;
+  }
+
+  UT_ASSERT_EQUAL (Count, Expected);
+  if (Node != NULL) {
+    Node = RangeTreeNext (Node);
+  }
+
+  UT_ASSERT_EQUAL ((UINTN)Node, (UINTN)NULL);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Measure the top down search of a free range through the tree and through
+  a walk of the ranges from the highest address down.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkFreeSearch (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32           Seed;
+  UINTN            Index;
+  UINTN            Search;
+  UINT64           Start;
+  UINT64           Address;
+  UINT64           FreeSize;
+  UINT64           ListNs;
+  UINT64           TreeNs;
+  UINTN            ListFound;
+  UINTN            TreeFound;
+  RANGE_TREE_NODE  *Node;
+
+  //
+  // A fragmented map: allocated ranges alternate with free ranges, and only
+  // a few free ranges are large enough for the bigger requests.
+  //
+  Seed = 3;
+  for (Index = 0; Index < TEST_BENCH_RANGES; Index++) {
+    mRanges[Index].InTree   = TRUE;
+    mRanges[Index].Start    = (UINT64)Index * TEST_SLOT_SIZE;
+    mRanges[Index].FreeSize = ((Index & 1) != 0) ? (UINT64)(UnitTestRandom (&Seed) % 8 + 1) * SIZE_4KB : 0;
+    if (UnitTestRandom (&Seed) % 256 == 0) {
+      mRanges[Index].FreeSize = TEST_SLOT_SIZE;
+    }
+
+    RangeTreeInsert (&mTree, &mRanges[Index].Nodes[0], mRanges[Index].Start, mRanges[Index].FreeSize);
+  }
+
+  Seed      = 5;
+  ListFound = 0;
+  Start     = UnitTestBenchmarkStart ();
+  for (Search = 0; Search < TEST_BENCH_SEARCHES; Search++) {
+    Address  = (UINT64)(UnitTestRandom (&Seed) % TEST_BENCH_RANGES) * TEST_SLOT_SIZE;
+    FreeSize = (UINT64)(UnitTestRandom (&Seed) % 16 + 1) * SIZE_4KB;
+    for (Index = TEST_BENCH_RANGES; Index > 0; Index--) {
+      if ((mRanges[Index - 1].Start <= Address) && (mRanges[Index - 1].FreeSize >= FreeSize)) {
+        ListFound += Index;
+        break;
+      }
+    }
+  }
+
+  ListNs = UnitTestBenchmarkStop (Start);
+
+  Seed      = 5;
+  TreeFound = 0;
+  Start     = UnitTestBenchmarkStart ();
+  for (Search = 0; Search < TEST_BENCH_SEARCHES; Search++) {
+    Address  = (UINT64)(UnitTestRandom (&Seed) % TEST_BENCH_RANGES) * TEST_SLOT_SIZE;
+    FreeSize = (UINT64)(UnitTestRandom (&Seed) % 16 + 1) * SIZE_4KB;
+    Node     = RangeTreeFindFreeBelow (&mTree, Address, FreeSize);
+    if (Node != NULL) {
+      TreeFound += (UINTN)(Node->Start / TEST_SLOT_SIZE) + 1;
+    }
+  }
+
+  TreeNs = UnitTestBenchmarkStop (Start);
+  UT_ASSERT_EQUAL (ListFound, TreeFound);
+
+  UT_LOG_INFO (
+    "%d ranges: %d free range searches take %ld ns (list) vs %ld ns (tree)\n",
+    TEST_BENCH_RANGES,
+    TEST_BENCH_SEARCHES,
+    ListNs,
+    TreeNs
+    );
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the range
+  tree and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      TreeTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&TreeTests, Framework, "DXE Core Range Tree Tests", "DxeCore.RangeTree", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for DXE Core Range Tree Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-----Description---------------Name--------------Function-------------------------------Pre----------Post--------Context-----------
+  //
+  AddTestCase (TreeTests, "Random changes", "RandomChanges", RandomChangesShouldMatchLinearScan, BuildRanges, FreeRanges, NULL);
+  AddTestCase (TreeTests, "Free range search benchmark", "Benchmark", BenchmarkFreeSearch, BuildRanges, FreeRanges, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define RangeTreeUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+RangeTreeUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  UnitTestingEntry ();
+  return 0;
+}
@@ -0,0 +1,396 @@
+/** @file
+  Unit tests and microbenchmark of the DXE core timer queue.
+
+  The tests arm, cancel and expire timers at random and check the queue
+  against a sorted list that keeps timers with the same trigger time in
+  arming order, like the timer list the queue replaces. The benchmark
+  re-arms periodic timers of a few hundred events, the pattern of USB,
+  network and console drivers polling at BDS, through the queue and through
+  the sorted list.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/UnitTestBenchmarkLib.h>
+
+#include "../../../../../Core/Dxe/Event/TimerQueue.h"
+
+#define UNIT_TEST_APP_NAME     "DXE Core Timer Queue Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_TIMER_COUNT   300
+#define TEST_RANDOM_STEPS  50000
+#define TEST_BENCH_TICKS   20000
+
+///
+/// Mirror of the IEVENT fields used by the timer services.
+///
+typedef struct {
+  LIST_ENTRY          Link;
+  TIMER_QUEUE_NODE    Node;
+  UINT64              TriggerTime;
+  UINT64              Period;
+} TEST_TIMER;
+
+STATIC TIMER_QUEUE  mQueue;
+STATIC LIST_ENTRY   mList = INITIALIZE_LIST_HEAD_VARIABLE (mList);
+STATIC TEST_TIMER   *mTimers;
+
+/**
+  Insert a timer into the sorted list after the timers that do not expire
+  later, like the sorted list insert of the timer services did.
+
+  @param  Timer                  The timer to insert.
+**/
+STATIC
+VOID
+ListInsert (
+  IN TEST_TIMER  *Timer
+  )
+{
+  LIST_ENTRY  *Link;
+
+  for (Link = mList.ForwardLink; Link != &mList; Link = Link->ForwardLink) {
+    if (BASE_CR (Link, TEST_TIMER, Link)->TriggerTime > Timer->TriggerTime) {
+      break;
+    }
+  }
+
+  InsertTailList (Link, &Timer->Link);
+}
+
+/**
+  Allocate the timers and start with an empty queue and list.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED                      The timers are ready.
+  @retval  UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  Out of memory.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+BuildTimers (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  mTimers = AllocateZeroPool (TEST_TIMER_COUNT * sizeof (TEST_TIMER));
+  if (mTimers == NULL) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  ZeroMem (&mQueue, sizeof (mQueue));
+  InitializeListHead (&mList);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Free the timers.
+
+  @param[in]  Context    Unused.
+**/
+STATIC
+VOID
+EFIAPI
+FreeTimers (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  FreePool (mTimers);
+  mTimers = NULL;
+}
+
+/**
+  Arm, cancel and expire timers at random and check the queue expires them
+  in the order of the sorted list.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+RandomTimersShouldMatchSortedList (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32            Seed;
+  UINTN             Step;
+  UINTN             Queued;
+  UINT64            Now;
+  TEST_TIMER        *Timer;
+  TIMER_QUEUE_NODE  *Node;
+
+  Seed   = 17;
+  Now    = 0;
+  Queued = 0;
+  for (Step = 0; Step < TEST_RANDOM_STEPS; Step++) {
+    Timer = &mTimers[UnitTestRandom (&Seed) % TEST_TIMER_COUNT];
+    switch (UnitTestRandom (&Seed) % 4) {
+      case 0:
+      case 1:
+        //
+        // Arm or re-arm. Trigger times are coarse so that many timers share
+        // the same one.
+        //
+        if (Timer->Node.Queued) {
+          TimerQueueRemove (&mQueue, &Timer->Node);
+          RemoveEntryList (&Timer->Link);
+          Queued--;
+        }
+
+        Timer->TriggerTime = Now + (UnitTestRandom (&Seed) % 32) * 10000;
+        TimerQueueInsert (&mQueue, &Timer->Node, Timer->TriggerTime);
+        ListInsert (Timer);
+        Queued++;
+        break;
+
+      case 2:
+        //
+        // Cancel
+        //
+        if (Timer->Node.Queued) {
+          TimerQueueRemove (&mQueue, &Timer->Node);
+          RemoveEntryList (&Timer->Link);
+          Queued--;
+        }
+
+        break;
+
+      default:
+        //
+        // Advance the time and expire the timers that are due
+        //
+        Now += (UnitTestRandom (&Seed) % 8) * 10000;
+        for (Node = TimerQueueFirst (&mQueue); Node != NULL; Node = TimerQueueFirst (&mQueue)) {
+          if (Node->TriggerTime > Now) {
+            break;
+          }
+
+          UT_ASSERT_FALSE (IsListEmpty (&mList));
+          UT_ASSERT_EQUAL ((UINTN)BASE_CR (Node, TEST_TIMER, Node), (UINTN)BASE_CR (mList.ForwardLink, TEST_TIMER, Link));
+          TimerQueueRemove (&mQueue, Node);
+          RemoveEntryList (mList.ForwardLink);
+          Queued--;
+        }
+
+        if (!IsListEmpty (&mList)) {
+          UT_ASSERT_TRUE (BASE_CR (mList.ForwardLink, TEST_TIMER, Link)->TriggerTime > Now);
+        }
+
+        break;
+    }
+
+    UT_ASSERT_EQUAL (mQueue.Count, Queued);
+    Node = TimerQueueFirst (&mQueue);
+    if (IsListEmpty (&mList)) {
+      UT_ASSERT_EQUAL ((UINTN)Node, (UINTN)NULL);
+    } else {
+      UT_ASSERT_EQUAL ((UINTN)Node, (UINTN)&BASE_CR (mList.ForwardLink, TEST_TIMER, Link)->Node);
+    }
+  }
+
+  //
+  // Drain the queue
+  //
+  while (!IsListEmpty (&mList)) {
+    Node = TimerQueueFirst (&mQueue);
+    UT_ASSERT_EQUAL ((UINTN)BASE_CR (Node, TEST_TIMER, Node), (UINTN)BASE_CR (mList.ForwardLink, TEST_TIMER, Link));
+    TimerQueueRemove (&mQueue, Node);
+    RemoveEntryList (mList.ForwardLink);
+  }
+
+  UT_ASSERT_EQUAL (mQueue.Count, 0);
+  UT_ASSERT_EQUAL ((UINTN)TimerQueueFirst (&mQueue), (UINTN)NULL);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Measure periodic timer expiry and re-arming through the queue and through
+  the sorted list.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkPeriodicTimers (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32            Seed;
+  UINTN             Index;
+  UINTN             Tick;
+  UINT64            Now;
+  UINT64            Start;
+  UINT64            ListNs;
+  UINT64            QueueNs;
+  UINTN             ListExpired;
+  UINTN             QueueExpired;
+  TEST_TIMER        *Timer;
+  TIMER_QUEUE_NODE  *Node;
+
+  //
+  // Periods from 1 ms to 100 ms, with a 1 ms tick
+  //
+  Seed = 9;
+  for (Index = 0; Index < TEST_TIMER_COUNT; Index++) {
+    mTimers[Index].Period      = (UnitTestRandom (&Seed) % 100 + 1) * 10000;
+    mTimers[Index].TriggerTime = mTimers[Index].Period;
+    ListInsert (&mTimers[Index]);
+  }
+
+  ListExpired = 0;
+  Now         = 0;
+  Start       = UnitTestBenchmarkStart ();
+  for (Tick = 0; Tick < TEST_BENCH_TICKS; Tick++) {
+    Now += 10000;
+    while (!IsListEmpty (&mList)) {
+      Timer = BASE_CR (mList.ForwardLink, TEST_TIMER, Link);
+      if (Timer->TriggerTime > Now) {
+        break;
+      }
+
+      RemoveEntryList (&Timer->Link);
+      Timer->TriggerTime += Timer->Period;
+      ListInsert (Timer);
+      ListExpired++;
+    }
+  }
+
+  ListNs = UnitTestBenchmarkStop (Start);
+
+  for (Index = 0; Index < TEST_TIMER_COUNT; Index++) {
+    mTimers[Index].TriggerTime = mTimers[Index].Period;
+    TimerQueueInsert (&mQueue, &mTimers[Index].Node, mTimers[Index].TriggerTime);
+  }
+
+  QueueExpired = 0;
+  Now          = 0;
+  Start        = UnitTestBenchmarkStart ();
+  for (Tick = 0; Tick < TEST_BENCH_TICKS; Tick++) {
+    Now += 10000;
+    for (Node = TimerQueueFirst (&mQueue); Node != NULL; Node = TimerQueueFirst (&mQueue)) {
+      if (Node->TriggerTime > Now) {
+        break;
+      }
+
+      Timer = BASE_CR (Node, TEST_TIMER, Node);
+      TimerQueueRemove (&mQueue, Node);
+      Timer->TriggerTime += Timer->Period;
+      TimerQueueInsert (&mQueue, Node, Timer->TriggerTime);
+      QueueExpired++;
+    }
+  }
+
+  QueueNs = UnitTestBenchmarkStop (Start);
+  UT_ASSERT_EQUAL (ListExpired, QueueExpired);
+
+  UT_LOG_INFO (
+    "%d periodic timers, %d ticks: %ld ns (list) vs %ld ns (queue), %ld queue links\n",
+    TEST_TIMER_COUNT,
+    TEST_BENCH_TICKS,
+    ListNs,
+    QueueNs,
+    mQueue.Links
+    );
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the timer
+  queue and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      QueueTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&QueueTests, Framework, "DXE Core Timer Queue Tests", "DxeCore.TimerQueue", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for DXE Core Timer Queue Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite------Description----------------Name-------------Function-----------------------------Pre----------Post--------Context-----------
+  //
+  AddTestCase (QueueTests, "Random timers", "RandomTimers", RandomTimersShouldMatchSortedList, BuildTimers, FreeTimers, NULL);
+  AddTestCase (QueueTests, "Periodic timer benchmark", "Benchmark", BenchmarkPeriodicTimers, BuildTimers, FreeTimers, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define TimerQueueUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+TimerQueueUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  UnitTestingEntry ();
+  return 0;
+}
@@ -0,0 +1,715 @@
+/** @file
+  Unit tests and microbenchmark of the PEI core FV file index.
+
+  The tests build emulated firmware volumes in memory, index their files, and
+  check that every search by name and by type finds in the index the file a
+  walk of the volume finds. The walk is a model of FindFileEx() for volumes
+  without corrupted or deleted files: it follows the file sizes and checks the
+  header checksum of each file it passes. The benchmark times the searches
+  the PEI dispatcher does on a volume of several hundred files with both.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <PiPei.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/UnitTestBenchmarkLib.h>
+
+#include "../../../../../Core/Pei/FwVol/FvFileIndex.h"
+
+#define UNIT_TEST_APP_NAME     "PEI Core FV File Index Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_RANDOM_VOLUMES     20
+#define TEST_RANDOM_FILES       200
+#define TEST_BENCHMARK_FILES    400
+#define TEST_BENCHMARK_ROUNDS   5
+#define TEST_MAX_PAYLOAD        2048
+#define TEST_MISSING_NAMES      16
+
+///
+/// An emulated firmware volume.
+///
+typedef struct {
+  EFI_FIRMWARE_VOLUME_HEADER    *FvHeader;
+  ///
+  /// Offsets of the files, including the pad files, in volume order.
+  ///
+  UINT32                        *FileOffsets;
+  UINTN                         FileCount;
+  FV_FILE_INDEX                 *Index;
+} TEST_VOLUME;
+
+///
+/// Search types checked on every volume.
+///
+STATIC CONST EFI_FV_FILETYPE  mSearchTypes[] = {
+  EFI_FV_FILETYPE_ALL,
+  EFI_FV_FILETYPE_RAW,
+  EFI_FV_FILETYPE_FREEFORM,
+  EFI_FV_FILETYPE_SECURITY_CORE,
+  EFI_FV_FILETYPE_PEI_CORE,
+  EFI_FV_FILETYPE_DXE_CORE,
+  EFI_FV_FILETYPE_PEIM,
+  EFI_FV_FILETYPE_DRIVER,
+  EFI_FV_FILETYPE_COMBINED_PEIM_DRIVER,
+  EFI_FV_FILETYPE_APPLICATION,
+  EFI_FV_FILETYPE_MM,
+  EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE,
+  EFI_FV_FILETYPE_OEM_MIN,
+  EFI_FV_FILETYPE_FFS_PAD,
+  FV_FILE_INDEX_DISPATCH_TYPE
+};
+
+///
+/// File types of the emulated volumes, PEIMs being the most frequent.
+///
+STATIC CONST EFI_FV_FILETYPE  mFileTypes[] = {
+  EFI_FV_FILETYPE_PEIM,
+  EFI_FV_FILETYPE_PEIM,
+  EFI_FV_FILETYPE_PEIM,
+  EFI_FV_FILETYPE_PEIM,
+  EFI_FV_FILETYPE_DRIVER,
+  EFI_FV_FILETYPE_DRIVER,
+  EFI_FV_FILETYPE_FREEFORM,
+  EFI_FV_FILETYPE_RAW,
+  EFI_FV_FILETYPE_COMBINED_PEIM_DRIVER,
+  EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE,
+  EFI_FV_FILETYPE_PEI_CORE,
+  EFI_FV_FILETYPE_OEM_MIN,
+  EFI_FV_FILETYPE_FFS_PAD
+};
+
+STATIC TEST_VOLUME  mBenchmarkVolume;
+
+/**
+  Fill a GUID with pseudo random bytes.
+
+  @param[in, out]  Seed  The generator state.
+  @param[out]      Guid  The GUID to fill.
+**/
+STATIC
+VOID
+RandomGuid (
+  IN OUT UINT32    *Seed,
+  OUT    EFI_GUID  *Guid
+  )
+{
+  UINT8  *Bytes;
+  UINTN  Index;
+
+  Bytes = (UINT8 *)Guid;
+  for (Index = 0; Index < sizeof (EFI_GUID); Index++) {
+    Bytes[Index] = (UINT8)UnitTestRandom (Seed);
+  }
+}
+
+/**
+  Free an emulated firmware volume.
+
+  @param[in, out]  Volume  The volume to free.
+**/
+STATIC
+VOID
+FreeVolume (
+  IN OUT TEST_VOLUME  *Volume
+  )
+{
+  if (Volume->FvHeader != NULL) {
+    FreePool (Volume->FvHeader);
+  }
+
+  if (Volume->FileOffsets != NULL) {
+    FreePool (Volume->FileOffsets);
+  }
+
+  if (Volume->Index != NULL) {
+    FreePool (Volume->Index);
+  }
+
+  ZeroMem (Volume, sizeof (TEST_VOLUME));
+}
+
+/**
+  Build an emulated firmware volume of random files and index it.
+
+  One file in eight reuses the name of an earlier file, so the volume holds
+  files of the same name.
+
+  @param[in, out]  Seed       The generator state.
+  @param[in]       FileCount  The number of files of the volume.
+  @param[out]      Volume     The volume.
+
+  @retval TRUE   The volume is built and indexed.
+  @retval FALSE  Memory ran out, or the index rejected a file.
+**/
+STATIC
+BOOLEAN
+BuildVolume (
+  IN OUT UINT32       *Seed,
+  IN     UINTN        FileCount,
+  OUT    TEST_VOLUME  *Volume
+  )
+{
+  EFI_FFS_FILE_HEADER  *FileHeader;
+  EFI_FFS_FILE_HEADER  *NameSource;
+  UINTN                HeaderLength;
+  UINTN                FvLength;
+  UINTN                Offset;
+  UINTN                FileSize;
+  UINTN                Index;
+  UINTN                IndexedCount;
+
+  ZeroMem (Volume, sizeof (TEST_VOLUME));
+
+  HeaderLength = ALIGN_VALUE (sizeof (EFI_FIRMWARE_VOLUME_HEADER) + sizeof (EFI_FV_BLOCK_MAP_ENTRY), 8);
+  FvLength     = HeaderLength + FileCount * ALIGN_VALUE (sizeof (EFI_FFS_FILE_HEADER) + TEST_MAX_PAYLOAD, 8) + sizeof (EFI_FFS_FILE_HEADER);
+
+  Volume->FvHeader    = AllocateZeroPool (FvLength);
+  Volume->FileOffsets = AllocatePool ((FileCount + 1) * sizeof (UINT32));
+  if ((Volume->FvHeader == NULL) || (Volume->FileOffsets == NULL)) {
+    FreeVolume (Volume);
+    return FALSE;
+  }
+
+  Volume->FvHeader->HeaderLength = (UINT16)HeaderLength;
+  Volume->FvHeader->FvLength     = FvLength;
+  Volume->FvHeader->Signature    = EFI_FVH_SIGNATURE;
+
+  Offset = HeaderLength;
+  for (Index = 0; Index < FileCount; Index++) {
+    FileHeader       = (EFI_FFS_FILE_HEADER *)((UINT8 *)Volume->FvHeader + Offset);
+    FileHeader->Type = mFileTypes[UnitTestRandom (Seed) % ARRAY_SIZE (mFileTypes)];
+
+    //
+    // Pad files are not searched by name, so no other file takes their name.
+    //
+    NameSource = NULL;
+    if ((Index != 0) && (UnitTestRandom (Seed) % 8 == 0)) {
+      NameSource = (EFI_FFS_FILE_HEADER *)((UINT8 *)Volume->FvHeader + Volume->FileOffsets[UnitTestRandom (Seed) % Index]);
+    }
+
+    if ((NameSource != NULL) && (NameSource->Type != EFI_FV_FILETYPE_FFS_PAD)) {
+      CopyGuid (&FileHeader->Name, &NameSource->Name);
+    } else {
+      RandomGuid (Seed, &FileHeader->Name);
+    }
+
+    FileSize                                   = sizeof (EFI_FFS_FILE_HEADER) + UnitTestRandom (Seed) % TEST_MAX_PAYLOAD;
+    FileHeader->Attributes                     = 0;
+    FileHeader->Size[0]                        = (UINT8)FileSize;
+    FileHeader->Size[1]                        = (UINT8)(FileSize >> 8);
+    FileHeader->Size[2]                        = (UINT8)(FileSize >> 16);
+    FileHeader->State                          = EFI_FILE_HEADER_CONSTRUCTION | EFI_FILE_HEADER_VALID | EFI_FILE_DATA_VALID;
+    FileHeader->IntegrityCheck.Checksum.File   = FFS_FIXED_CHECKSUM;
+    FileHeader->IntegrityCheck.Checksum.Header = 0;
+    FileHeader->IntegrityCheck.Checksum.Header = CalculateCheckSum8 ((UINT8 *)FileHeader, sizeof (EFI_FFS_FILE_HEADER));
+
+    Volume->FileOffsets[Index] = (UINT32)Offset;
+    Offset                    += ALIGN_VALUE (FileSize, 8);
+  }
+
+  Volume->FileCount          = FileCount;
+  Volume->FvHeader->FvLength = Offset + sizeof (EFI_FFS_FILE_HEADER);
+
+  //
+  // Index the files a walk returns: all of them but the pad files.
+  //
+  IndexedCount = 0;
+  for (Index = 0; Index < FileCount; Index++) {
+    FileHeader = (EFI_FFS_FILE_HEADER *)((UINT8 *)Volume->FvHeader + Volume->FileOffsets[Index]);
+    if (FileHeader->Type != EFI_FV_FILETYPE_FFS_PAD) {
+      IndexedCount++;
+    }
+  }
+
+  Volume->Index = AllocatePool (FvFileIndexGetSize (IndexedCount));
+  if (Volume->Index == NULL) {
+    FreeVolume (Volume);
+    return FALSE;
+  }
+
+  FvFileIndexInitialize (Volume->Index, IndexedCount);
+  for (Index = 0; Index < FileCount; Index++) {
+    FileHeader = (EFI_FFS_FILE_HEADER *)((UINT8 *)Volume->FvHeader + Volume->FileOffsets[Index]);
+    if (FileHeader->Type == EFI_FV_FILETYPE_FFS_PAD) {
+      continue;
+    }
+
+    if (!FvFileIndexAdd (Volume->Index, Volume->FileOffsets[Index], &FileHeader->Name, FileHeader->Type)) {
+      FreeVolume (Volume);
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Search a file the way FindFileEx() walks a firmware volume.
+
+  @param[in]   Volume          The volume.
+  @param[in]   Name            The name of the file, or NULL to search by type.
+  @param[in]   SearchType      The type of the file, EFI_FV_FILETYPE_ALL, or
+                               FV_FILE_INDEX_DISPATCH_TYPE.
+  @param[in]   PreviousOffset  The offset of the file to start the search
+                               after, or FV_FILE_INDEX_FIRST.
+  @param[out]  FileOffset      The offset of the file found.
+
+  @retval TRUE   The file is found.
+  @retval FALSE  The file is not found.
+**/
+STATIC
+BOOLEAN
+WalkVolume (
+  IN  CONST TEST_VOLUME     *Volume,
+  IN  CONST EFI_GUID        *Name        OPTIONAL,
+  IN        EFI_FV_FILETYPE  SearchType,
+  IN        UINT32           PreviousOffset,
+  OUT       UINT32           *FileOffset
+  )
+{
+  EFI_FFS_FILE_HEADER  *FileHeader;
+  UINTN                Offset;
+  UINTN                FileSize;
+  UINT8                Type;
+
+  Offset = Volume->FvHeader->HeaderLength;
+  if ((Name == NULL) && (PreviousOffset != FV_FILE_INDEX_FIRST)) {
+    FileHeader = (EFI_FFS_FILE_HEADER *)((UINT8 *)Volume->FvHeader + PreviousOffset);
+    Offset     = PreviousOffset + ALIGN_VALUE (FFS_FILE_SIZE (FileHeader), 8);
+  }
+
+  while (Offset < Volume->FvHeader->FvLength - sizeof (EFI_FFS_FILE_HEADER)) {
+    FileHeader = (EFI_FFS_FILE_HEADER *)((UINT8 *)Volume->FvHeader + Offset);
+    FileSize   = FFS_FILE_SIZE (FileHeader);
+    if (CalculateSum8 ((UINT8 *)FileHeader, sizeof (EFI_FFS_FILE_HEADER)) != 0) {
+      return FALSE;
+    }
+
+    Type = FileHeader->Type;
+    if (Name != NULL) {
+      if (CompareGuid (&FileHeader->Name, Name)) {
+        *FileOffset = (UINT32)Offset;
+        return TRUE;
+      }
+    } else if (SearchType == FV_FILE_INDEX_DISPATCH_TYPE) {
+      if ((Type == EFI_FV_FILETYPE_PEIM) ||
+          (Type == EFI_FV_FILETYPE_COMBINED_PEIM_DRIVER) ||
+          (Type == EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE))
+      {
+        *FileOffset = (UINT32)Offset;
+        return TRUE;
+      }
+    } else if (((SearchType == Type) || (SearchType == EFI_FV_FILETYPE_ALL)) &&
+               (Type != EFI_FV_FILETYPE_FFS_PAD))
+    {
+      *FileOffset = (UINT32)Offset;
+      return TRUE;
+    }
+
+    Offset += ALIGN_VALUE (FileSize, 8);
+  }
+
+  return FALSE;
+}
+
+/**
+  Check the searches of a volume in its index against walks of the volume.
+
+  @param[in]  Volume  The volume.
+  @param[in]  Seed    The generator state of the missing names.
+
+  @retval UNIT_TEST_PASSED  The index finds the files the walks find.
+**/
+STATIC
+UNIT_TEST_STATUS
+CheckVolume (
+  IN CONST TEST_VOLUME  *Volume,
+  IN       UINT32       Seed
+  )
+{
+  EFI_FFS_FILE_HEADER  *FileHeader;
+  EFI_GUID             Name;
+  EFI_STATUS           Status;
+  BOOLEAN              Found;
+  UINT32               Expected;
+  UINT32               Actual;
+  UINT32               Previous;
+  UINTN                Index;
+  UINTN                TypeIndex;
+
+  //
+  // Every name, including the pad files', and a few missing ones.
+  //
+  for (Index = 0; Index < Volume->FileCount + TEST_MISSING_NAMES; Index++) {
+    if (Index < Volume->FileCount) {
+      FileHeader = (EFI_FFS_FILE_HEADER *)((UINT8 *)Volume->FvHeader + Volume->FileOffsets[Index]);
+      if (FileHeader->Type == EFI_FV_FILETYPE_FFS_PAD) {
+        continue;
+      }
+
+      CopyGuid (&Name, &FileHeader->Name);
+    } else {
+      RandomGuid (&Seed, &Name);
+    }
+
+    Found = WalkVolume (Volume, &Name, 0, FV_FILE_INDEX_FIRST, &Expected);
+    UT_ASSERT_EQUAL (FvFileIndexFindByName (Volume->Index, Volume->FvHeader, &Name, &Actual), Found);
+    if (Found) {
+      UT_ASSERT_EQUAL (Actual, Expected);
+    }
+  }
+
+  //
+  // Every type enumerated from the first file.
+  //
+  for (TypeIndex = 0; TypeIndex < ARRAY_SIZE (mSearchTypes); TypeIndex++) {
+    Previous = FV_FILE_INDEX_FIRST;
+    do {
+      Found  = WalkVolume (Volume, NULL, mSearchTypes[TypeIndex], Previous, &Expected);
+      Status = FvFileIndexFindNext (Volume->Index, Previous, mSearchTypes[TypeIndex], &Actual);
+      UT_ASSERT_STATUS_EQUAL (Status, Found ? EFI_SUCCESS : EFI_NOT_FOUND);
+      if (Found) {
+        UT_ASSERT_EQUAL (Actual, Expected);
+      }
+
+      Previous = Expected;
+    } while (Found);
+  }
+
+  //
+  // Every type searched from every indexed file, whatever its type.
+  //
+  for (Index = 0; Index < Volume->FileCount; Index++) {
+    FileHeader = (EFI_FFS_FILE_HEADER *)((UINT8 *)Volume->FvHeader + Volume->FileOffsets[Index]);
+    for (TypeIndex = 0; TypeIndex < ARRAY_SIZE (mSearchTypes); TypeIndex++) {
+      Status = FvFileIndexFindNext (Volume->Index, Volume->FileOffsets[Index], mSearchTypes[TypeIndex], &Actual);
+      if (FileHeader->Type == EFI_FV_FILETYPE_FFS_PAD) {
+        UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+        continue;
+      }
+
+      Found = WalkVolume (Volume, NULL, mSearchTypes[TypeIndex], Volume->FileOffsets[Index], &Expected);
+      UT_ASSERT_STATUS_EQUAL (Status, Found ? EFI_SUCCESS : EFI_NOT_FOUND);
+      if (Found) {
+        UT_ASSERT_EQUAL (Actual, Expected);
+      }
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check that random volumes of up to TEST_RANDOM_FILES files, and empty
+  volumes, are searched in their index like they are walked.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED  The index finds the files the walks find.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+RandomVolumesShouldMatchWalk (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_VOLUME       Volume;
+  UNIT_TEST_STATUS  Status;
+  UINT32            Seed;
+  UINTN             Round;
+
+  Seed = 0x46464958;
+  for (Round = 0; Round < TEST_RANDOM_VOLUMES; Round++) {
+    UT_ASSERT_TRUE (BuildVolume (&Seed, (Round == 0) ? 0 : UnitTestRandom (&Seed) % TEST_RANDOM_FILES + 1, &Volume));
+    Status = CheckVolume (&Volume, Seed);
+    FreeVolume (&Volume);
+    if (Status != UNIT_TEST_PASSED) {
+      return Status;
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check the limits of an index: files appended out of order or past its
+  size, offsets that are not indexed, and too many files.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED  The limits are enforced.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+IndexLimitsShouldBeEnforced (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  FV_FILE_INDEX  *Index;
+  EFI_GUID       Name;
+  UINT32         Seed;
+  UINT32         Offset;
+
+  UT_ASSERT_EQUAL (FvFileIndexGetSize (FV_FILE_INDEX_MAX_FILES + 1), 0);
+  UT_ASSERT_NOT_EQUAL (FvFileIndexGetSize (FV_FILE_INDEX_MAX_FILES), 0);
+
+  Index = AllocatePool (FvFileIndexGetSize (2));
+  UT_ASSERT_NOT_NULL (Index);
+
+  Seed = 1;
+  RandomGuid (&Seed, &Name);
+  FvFileIndexInitialize (Index, 2);
+  UT_ASSERT_TRUE (FvFileIndexAdd (Index, 0x100, &Name, EFI_FV_FILETYPE_PEIM));
+  UT_ASSERT_FALSE (FvFileIndexAdd (Index, 0x100, &Name, EFI_FV_FILETYPE_PEIM));
+  UT_ASSERT_FALSE (FvFileIndexAdd (Index, 0x80, &Name, EFI_FV_FILETYPE_PEIM));
+  UT_ASSERT_TRUE (FvFileIndexAdd (Index, 0x180, &Name, EFI_FV_FILETYPE_DRIVER));
+  UT_ASSERT_FALSE (FvFileIndexAdd (Index, 0x200, &Name, EFI_FV_FILETYPE_PEIM));
+
+  UT_ASSERT_STATUS_EQUAL (FvFileIndexFindNext (Index, 0x140, EFI_FV_FILETYPE_ALL, &Offset), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (FvFileIndexFindNext (Index, 0x200, EFI_FV_FILETYPE_ALL, &Offset), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (FvFileIndexFindNext (Index, 0x100, EFI_FV_FILETYPE_ALL, &Offset), EFI_SUCCESS);
+  UT_ASSERT_EQUAL (Offset, 0x180);
+  UT_ASSERT_STATUS_EQUAL (FvFileIndexFindNext (Index, 0x100, EFI_FV_FILETYPE_PEIM, &Offset), EFI_NOT_FOUND);
+  UT_ASSERT_STATUS_EQUAL (FvFileIndexFindNext (Index, 0x180, EFI_FV_FILETYPE_ALL, &Offset), EFI_NOT_FOUND);
+
+  FreePool (Index);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Build the volume of the benchmark.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED  The volume is built.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+PrepareVolume (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32  Seed;
+
+  Seed = 0x50454942;
+  UT_ASSERT_TRUE (BuildVolume (&Seed, TEST_BENCHMARK_FILES, &mBenchmarkVolume));
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Free the volume of the benchmark.
+
+  @param[in]  Context  Unused.
+**/
+STATIC
+VOID
+EFIAPI
+CleanupVolume (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  FreeVolume (&mBenchmarkVolume);
+}
+
+/**
+  Do the searches of the PEI dispatcher on the benchmark volume: enumerate the
+  files to dispatch, then find each of them by name, as the apriori file and
+  the dispatch manifest do, and look for a missing file.
+
+  @param[in]  UseIndex  TRUE to search in the index, FALSE to walk.
+
+  @return The number of files found.
+**/
+STATIC
+UINTN
+DispatchSearches (
+  IN BOOLEAN  UseIndex
+  )
+{
+  EFI_FFS_FILE_HEADER  *FileHeader;
+  EFI_GUID             Missing;
+  UINT32               Previous;
+  UINT32               Offset;
+  UINT32               Found;
+  UINTN                Count;
+  BOOLEAN              Next;
+
+  Count    = 0;
+  Previous = FV_FILE_INDEX_FIRST;
+  do {
+    if (UseIndex) {
+      Next = (BOOLEAN)!EFI_ERROR (FvFileIndexFindNext (mBenchmarkVolume.Index, Previous, FV_FILE_INDEX_DISPATCH_TYPE, &Offset));
+    } else {
+      Next = WalkVolume (&mBenchmarkVolume, NULL, FV_FILE_INDEX_DISPATCH_TYPE, Previous, &Offset);
+    }
+
+    if (Next) {
+      FileHeader = (EFI_FFS_FILE_HEADER *)((UINT8 *)mBenchmarkVolume.FvHeader + Offset);
+      if (UseIndex) {
+        Count += FvFileIndexFindByName (mBenchmarkVolume.Index, mBenchmarkVolume.FvHeader, &FileHeader->Name, &Found) ? 1 : 0;
+      } else {
+        Count += WalkVolume (&mBenchmarkVolume, &FileHeader->Name, 0, FV_FILE_INDEX_FIRST, &Found) ? 1 : 0;
+      }
+
+      Previous = Offset;
+    }
+  } while (Next);
+
+  ZeroMem (&Missing, sizeof (Missing));
+  if (UseIndex) {
+    Count += FvFileIndexFindByName (mBenchmarkVolume.Index, mBenchmarkVolume.FvHeader, &Missing, &Found) ? 1 : 0;
+  } else {
+    Count += WalkVolume (&mBenchmarkVolume, &Missing, 0, FV_FILE_INDEX_FIRST, &Found) ? 1 : 0;
+  }
+
+  return Count;
+}
+
+/**
+  Time the searches of the PEI dispatcher on a volume of
+  TEST_BENCHMARK_FILES files, walked and in the index.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED  Both find the same number of files.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+DispatchSearchBenchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT64  Start;
+  UINT64  WalkNs;
+  UINT64  IndexNs;
+  UINTN   WalkCount;
+  UINTN   IndexCount;
+  UINTN   Round;
+
+  //
+  // Keep the fastest of a few rounds, to leave out the cold caches.
+  //
+  WalkNs     = MAX_UINT64;
+  IndexNs    = MAX_UINT64;
+  WalkCount  = 0;
+  IndexCount = 0;
+  for (Round = 0; Round < TEST_BENCHMARK_ROUNDS; Round++) {
+    Start     = UnitTestBenchmarkStart ();
+    WalkCount = DispatchSearches (FALSE);
+    WalkNs    = MIN (WalkNs, UnitTestBenchmarkStop (Start));
+
+    Start      = UnitTestBenchmarkStart ();
+    IndexCount = DispatchSearches (TRUE);
+    IndexNs    = MIN (IndexNs, UnitTestBenchmarkStop (Start));
+  }
+
+  UT_ASSERT_EQUAL (WalkCount, IndexCount);
+
+  UT_LOG_INFO (
+    "%ld files, %ld dispatchable: %ld ns (walk) vs %ld ns (index, %ld bytes)\n",
+    (UINT64)mBenchmarkVolume.FileCount,
+    (UINT64)IndexCount,
+    WalkNs,
+    IndexNs,
+    (UINT64)FvFileIndexGetSize (mBenchmarkVolume.Index->Count)
+    );
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  FV file index and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      IndexTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&IndexTests, Framework, "PEI Core FV File Index Tests", "PeiCore.FvFileIndex", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for PEI Core FV File Index Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite------Description-------------------Name----------Function-------------------------------Pre------------Post-----------Context-----------
+  //
+  AddTestCase (IndexTests, "Random volumes", "RandomVolumes", RandomVolumesShouldMatchWalk, NULL, NULL, NULL);
+  AddTestCase (IndexTests, "Index limits", "Limits", IndexLimitsShouldBeEnforced, NULL, NULL, NULL);
+  AddTestCase (IndexTests, "Dispatch search benchmark", "Benchmark", DispatchSearchBenchmark, PrepareVolume, CleanupVolume, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define FvFileIndexUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+FvFileIndexUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  UnitTestingEntry ();
+  return 0;
+}
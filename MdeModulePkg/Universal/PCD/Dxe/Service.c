@@ -2,7 +2,7 @@
     Help functions used by PCD DXE driver.
 
 Copyright (c) 2014, Hewlett-Packard Development Company, L.P.<BR>
-Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 (C) Copyright 2016-2021 Hewlett Packard Enterprise Development LP<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -1568,6 +1568,69 @@ SetHiiVariable (
   return Status;
 }
 
+/**
+  Find the entry of a dynamic-ex PCD in the ExMapTable of a PCD database.
+
+  When the build tools sorted the ExMapTable by token space guid index, then by
+  token number, the entry is found with a binary search. The ExMapTable of a
+  database built by older tools is searched linearly.
+
+  @param Database        The PCD database.
+  @param GuidTableIdx    Index of the token space guid in the GuidTable of Database.
+  @param ExTokenNumber   Dynamic-ex PCD token number.
+
+  @return The entry of the PCD, or NULL if the PCD is not in Database.
+
+**/
+DYNAMICEX_MAPPING *
+FindExMapEntry (
+  IN PCD_DATABASE_INIT  *Database,
+  IN UINTN              GuidTableIdx,
+  IN UINT32             ExTokenNumber
+  )
+{
+  DYNAMICEX_MAPPING  *ExMap;
+  UINTN              Low;
+  UINTN              High;
+  UINTN              Middle;
+
+  ExMap = (DYNAMICEX_MAPPING *)((UINT8 *)Database + Database->ExMapTableOffset);
+
+  if (Database->ExMapAttributes != PCD_EXMAP_SORTED) {
+    for (Middle = 0; Middle < Database->ExTokenCount; Middle++) {
+      if ((ExTokenNumber == ExMap[Middle].ExTokenNumber) &&
+          (GuidTableIdx == ExMap[Middle].ExGuidIndex))
+      {
+        return &ExMap[Middle];
+      }
+    }
+
+    return NULL;
+  }
+
+  Low  = 0;
+  High = Database->ExTokenCount;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    if ((ExMap[Middle].ExGuidIndex < GuidTableIdx) ||
+        ((ExMap[Middle].ExGuidIndex == GuidTableIdx) && (ExMap[Middle].ExTokenNumber < ExTokenNumber)))
+    {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  if ((Low < Database->ExTokenCount) &&
+      (ExMap[Low].ExGuidIndex == GuidTableIdx) &&
+      (ExMap[Low].ExTokenNumber == ExTokenNumber))
+  {
+    return &ExMap[Low];
+  }
+
+  return NULL;
+}
+
 /**
   Get Token Number according to dynamic-ex PCD's {token space guid:token number}
 
@@ -1587,14 +1650,12 @@ GetExPcdTokenNumber (
   IN UINT32          ExTokenNumber
   )
 {
-  UINT32             Index;
   DYNAMICEX_MAPPING  *ExMap;
   EFI_GUID           *GuidTable;
   EFI_GUID           *MatchGuid;
   UINTN              MatchGuidIdx;
 
   if (!mPeiDatabaseEmpty) {
-    ExMap     = (DYNAMICEX_MAPPING *)((UINT8 *)mPcdDatabase.PeiDb + mPcdDatabase.PeiDb->ExMapTableOffset);
     GuidTable = (EFI_GUID *)((UINT8 *)mPcdDatabase.PeiDb + mPcdDatabase.PeiDb->GuidTableOffset);
 
     MatchGuid = ScanGuid (GuidTable, mPeiGuidTableSize, Guid);
@@ -1602,17 +1663,13 @@ GetExPcdTokenNumber (
     if (MatchGuid != NULL) {
       MatchGuidIdx = MatchGuid - GuidTable;
 
-      for (Index = 0; Index < mPcdDatabase.PeiDb->ExTokenCount; Index++) {
-        if ((ExTokenNumber == ExMap[Index].ExTokenNumber) &&
-            (MatchGuidIdx == ExMap[Index].ExGuidIndex))
-        {
-          return ExMap[Index].TokenNumber;
-        }
+      ExMap = FindExMapEntry (mPcdDatabase.PeiDb, MatchGuidIdx, ExTokenNumber);
+      if (ExMap != NULL) {
+        return ExMap->TokenNumber;
       }
     }
   }
 
-  ExMap     = (DYNAMICEX_MAPPING *)((UINT8 *)mPcdDatabase.DxeDb + mPcdDatabase.DxeDb->ExMapTableOffset);
   GuidTable = (EFI_GUID *)((UINT8 *)mPcdDatabase.DxeDb + mPcdDatabase.DxeDb->GuidTableOffset);
 
   MatchGuid = ScanGuid (GuidTable, mDxeGuidTableSize, Guid);
@@ -1624,12 +1681,9 @@ GetExPcdTokenNumber (
 
   MatchGuidIdx = MatchGuid - GuidTable;
 
-  for (Index = 0; Index < mPcdDatabase.DxeDb->ExTokenCount; Index++) {
-    if ((ExTokenNumber == ExMap[Index].ExTokenNumber) &&
-        (MatchGuidIdx == ExMap[Index].ExGuidIndex))
-    {
-      return ExMap[Index].TokenNumber;
-    }
+  ExMap = FindExMapEntry (mPcdDatabase.DxeDb, MatchGuidIdx, ExTokenNumber);
+  if (ExMap != NULL) {
+    return ExMap->TokenNumber;
   }
 
   DEBUG ((DEBUG_ERROR, "%a: Failed to find PCD with GUID: %g and token number: %d\n", __func__, Guid, ExTokenNumber));
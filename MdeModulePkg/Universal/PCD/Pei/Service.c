@@ -2,7 +2,7 @@
   The driver internal functions are implmented here.
   They build Pei PCD database, and provide access service to PCD database.
 
-Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -959,6 +959,69 @@ GetWorker (
   return NULL;
 }
 
+/**
+  Find the entry of a dynamic-ex PCD in the ExMapTable of a PCD database.
+
+  When the build tools sorted the ExMapTable by token space guid index, then by
+  token number, the entry is found with a binary search. The ExMapTable of a
+  database built by older tools is searched linearly.
+
+  @param Database        The PCD database.
+  @param GuidTableIdx    Index of the token space guid in the GuidTable of Database.
+  @param ExTokenNumber   Dynamic-ex PCD token number.
+
+  @return The entry of the PCD, or NULL if the PCD is not in Database.
+
+**/
+DYNAMICEX_MAPPING *
+FindExMapEntry (
+  IN PEI_PCD_DATABASE  *Database,
+  IN UINTN             GuidTableIdx,
+  IN UINTN             ExTokenNumber
+  )
+{
+  DYNAMICEX_MAPPING  *ExMap;
+  UINTN              Low;
+  UINTN              High;
+  UINTN              Middle;
+
+  ExMap = (DYNAMICEX_MAPPING *)((UINT8 *)Database + Database->ExMapTableOffset);
+
+  if (Database->ExMapAttributes != PCD_EXMAP_SORTED) {
+    for (Middle = 0; Middle < Database->ExTokenCount; Middle++) {
+      if ((ExTokenNumber == ExMap[Middle].ExTokenNumber) &&
+          (GuidTableIdx == ExMap[Middle].ExGuidIndex))
+      {
+        return &ExMap[Middle];
+      }
+    }
+
+    return NULL;
+  }
+
+  Low  = 0;
+  High = Database->ExTokenCount;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    if ((ExMap[Middle].ExGuidIndex < GuidTableIdx) ||
+        ((ExMap[Middle].ExGuidIndex == GuidTableIdx) && (ExMap[Middle].ExTokenNumber < ExTokenNumber)))
+    {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  if ((Low < Database->ExTokenCount) &&
+      (ExMap[Low].ExGuidIndex == GuidTableIdx) &&
+      (ExMap[Low].ExTokenNumber == ExTokenNumber))
+  {
+    return &ExMap[Low];
+  }
+
+  return NULL;
+}
+
 /**
   Get Token Number according to dynamic-ex PCD's {token space guid:token number}
 
@@ -978,7 +1041,6 @@ GetExPcdTokenNumber (
   IN UINTN           ExTokenNumber
   )
 {
-  UINT32             Index;
   DYNAMICEX_MAPPING  *ExMap;
   EFI_GUID           *GuidTable;
   EFI_GUID           *MatchGuid;
@@ -987,7 +1049,6 @@ GetExPcdTokenNumber (
 
   PeiPcdDb = GetPcdDatabase ();
 
-  ExMap     = (DYNAMICEX_MAPPING *)((UINT8 *)PeiPcdDb + PeiPcdDb->ExMapTableOffset);
   GuidTable = (EFI_GUID *)((UINT8 *)PeiPcdDb + PeiPcdDb->GuidTableOffset);
 
   MatchGuid = ScanGuid (GuidTable, PeiPcdDb->GuidTableCount * sizeof (EFI_GUID), Guid);
@@ -999,12 +1060,9 @@ GetExPcdTokenNumber (
 
   MatchGuidIdx = MatchGuid - GuidTable;
 
-  for (Index = 0; Index < PeiPcdDb->ExTokenCount; Index++) {
-    if ((ExTokenNumber == ExMap[Index].ExTokenNumber) &&
-        (MatchGuidIdx == ExMap[Index].ExGuidIndex))
-    {
-      return ExMap[Index].TokenNumber;
-    }
+  ExMap = FindExMapEntry (PeiPcdDb, MatchGuidIdx, ExTokenNumber);
+  if (ExMap != NULL) {
+    return ExMap->TokenNumber;
   }
 
   return PCD_INVALID_TOKEN_NUMBER;
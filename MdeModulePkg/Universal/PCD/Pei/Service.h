@@ -1,7 +1,7 @@
 /** @file
   The internal header file declares the private functions used by PeiPcd driver.
 
-Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -969,6 +969,27 @@ typedef struct {
   UINT32    LocalTokenNumberAlias;
 } EX_PCD_ENTRY_ATTRIBUTE;
 
+/**
+  Find the entry of a dynamic-ex PCD in the ExMapTable of a PCD database.
+
+  When the build tools sorted the ExMapTable by token space guid index, then by
+  token number, the entry is found with a binary search. The ExMapTable of a
+  database built by older tools is searched linearly.
+
+  @param Database        The PCD database.
+  @param GuidTableIdx    Index of the token space guid in the GuidTable of Database.
+  @param ExTokenNumber   Dynamic-ex PCD token number.
+
+  @return The entry of the PCD, or NULL if the PCD is not in Database.
+
+**/
+DYNAMICEX_MAPPING *
+FindExMapEntry (
+  IN PEI_PCD_DATABASE  *Database,
+  IN UINTN             GuidTableIdx,
+  IN UINTN             ExTokenNumber
+  );
+
 /**
   Get Token Number according to dynamic-ex PCD's {token space guid:token number}
 
@@ -94,6 +94,8 @@ GetLbaAndOffsetByAddress (
 
   @param  VariableBase   Base address of variable to write
   @param  VariableBuffer Point to the variable data buffer.
+  @param  WriteOffset    Offset in the variable store of the first byte to write.
+  @param  WriteSize      Number of bytes to write.
 
   @retval EFI_SUCCESS    The function completed successfully.
   @retval EFI_NOT_FOUND  Fail to locate Fault Tolerant Write protocol.
@@ -103,7 +105,9 @@ GetLbaAndOffsetByAddress (
 EFI_STATUS
 FtwVariableSpace (
   IN EFI_PHYSICAL_ADDRESS   VariableBase,
-  IN VARIABLE_STORE_HEADER  *VariableBuffer
+  IN VARIABLE_STORE_HEADER  *VariableBuffer,
+  IN UINTN                  WriteOffset,
+  IN UINTN                  WriteSize
   )
 {
   EFI_STATUS                         Status;
@@ -132,13 +136,14 @@ FtwVariableSpace (
   //
   // Get LBA and Offset by address.
   //
-  Status = GetLbaAndOffsetByAddress (VariableBase, &VarLba, &VarOffset);
+  Status = GetLbaAndOffsetByAddress (VariableBase + WriteOffset, &VarLba, &VarOffset);
   if (EFI_ERROR (Status)) {
     return EFI_ABORTED;
   }
 
   FtwBufferSize = ((VARIABLE_STORE_HEADER *)((UINTN)VariableBase))->Size;
   ASSERT (FtwBufferSize == VariableBuffer->Size);
+  ASSERT (WriteOffset + WriteSize <= FtwBufferSize);
 
   //
   // FTW write record.
@@ -147,10 +152,10 @@ FtwVariableSpace (
                           FtwProtocol,
                           VarLba,                // LBA
                           VarOffset,             // Offset
-                          FtwBufferSize,         // NumBytes
+                          WriteSize,             // NumBytes
                           NULL,                  // PrivateData NULL
                           FvbHandle,             // Fvb Handle
-                          (VOID *)VariableBuffer // write buffer
+                          (UINT8 *)VariableBuffer + WriteOffset // write buffer
                           );
 
   return Status;
@@ -0,0 +1,881 @@
+/** @file
+  Host based unit test of the variable store index used by FindVariableEx()
+  and VariableServiceGetNextVariableInternal().
+
+  Every lookup through the index is checked against the linear search of the
+  same store, and the lookup and full enumeration costs of both are measured
+  across store sizes. The range written by an incremental reclaim is checked
+  against a full write of the compacted store.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PrintLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/UnitTestBenchmarkLib.h>
+
+#include "../VariableParsing.h"
+#include "../VariableRuntimeCache.h"
+
+#define UNIT_TEST_NAME     "Variable Store Index Unit Test"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define TEST_STORE_SIZE      SIZE_1MB
+#define TEST_VARIABLE_COUNT  500
+#define TEST_GUID_COUNT      4
+#define TEST_NAME_LENGTH     16
+
+//
+// Globals of the variable driver referenced by the code under test.
+//
+VARIABLE_MODULE_GLOBAL  *mVariableModuleGlobal;
+VARIABLE_STORE_HEADER   *mNvVariableCache;
+
+STATIC BOOLEAN                mAtRuntime;
+STATIC VARIABLE_STORE_HEADER  *mStore;
+STATIC VARIABLE_HEADER        *mStoreEnd;
+
+STATIC EFI_GUID  mTestGuid[TEST_GUID_COUNT] = {
+  { 0x3d17fa2e, 0x5b41, 0x4c1e, { 0x9a, 0x8f, 0x21, 0x6c, 0x0d, 0x44, 0x7e, 0x90 }
+  },
+  { 0x8e0c9b61, 0x2f7a, 0x4d03, { 0xb2, 0x5e, 0x6a, 0x13, 0xc8, 0x7f, 0x01, 0x5d }
+  },
+  { 0xc5a4e3d2, 0x7b16, 0x4f88, { 0x83, 0x0a, 0x9f, 0x54, 0x2e, 0xb1, 0x6c, 0x37 }
+  },
+  { 0x1f62b8c9, 0xe04d, 0x47a5, { 0xa6, 0x71, 0x3b, 0xd9, 0x58, 0x0e, 0xf2, 0xc4 }
+  }
+};
+
+/**
+  Return TRUE if ExitBootServices () has been called.
+
+  @retval TRUE If ExitBootServices () has been called.
+**/
+BOOLEAN
+AtRuntime (
+  VOID
+  )
+{
+  return mAtRuntime;
+}
+
+/**
+  Build the name of a test variable.
+
+  @param[out] Name      Buffer of TEST_NAME_LENGTH characters.
+  @param[in]  Index     Index of the test variable.
+**/
+STATIC
+VOID
+TestVariableName (
+  OUT CHAR16  *Name,
+  IN  UINTN   Index
+  )
+{
+  UnicodeSPrint (Name, TEST_NAME_LENGTH * sizeof (CHAR16), L"TestVar%05d", Index);
+}
+
+/**
+  Format an empty variable store.
+**/
+STATIC
+VOID
+FormatStore (
+  VOID
+  )
+{
+  SetMem (mStore, TEST_STORE_SIZE, 0xFF);
+  CopyGuid (&mStore->Signature, &gEfiVariableGuid);
+  mStore->Size   = TEST_STORE_SIZE;
+  mStore->Format = VARIABLE_STORE_FORMATTED;
+  mStore->State  = VARIABLE_STORE_HEALTHY;
+  mStoreEnd      = GetStartPointer (mStore);
+}
+
+/**
+  Append a variable to the test store.
+
+  @param[in] Name         Name of the variable.
+  @param[in] Guid         Vendor GUID of the variable.
+  @param[in] State        State of the variable.
+  @param[in] Attributes   Attributes of the variable.
+
+  @return Pointer to the header of the new variable.
+**/
+STATIC
+VARIABLE_HEADER *
+AppendVariable (
+  IN CHAR16    *Name,
+  IN EFI_GUID  *Guid,
+  IN UINT8     State,
+  IN UINT32    Attributes
+  )
+{
+  VARIABLE_HEADER  *Variable;
+
+  Variable             = mStoreEnd;
+  Variable->StartId    = VARIABLE_DATA;
+  Variable->State      = State;
+  Variable->Reserved   = 0;
+  Variable->Attributes = Attributes;
+  Variable->NameSize   = (UINT32)StrSize (Name);
+  Variable->DataSize   = sizeof (UINT64);
+  CopyGuid (&Variable->VendorGuid, Guid);
+  CopyMem (GetVariableNamePtr (Variable, FALSE), Name, Variable->NameSize);
+  SetMem (GetVariableDataPtr (Variable, FALSE), Variable->DataSize, 0x5A);
+  mStoreEnd = GetNextVariablePtr (Variable, FALSE);
+  return Variable;
+}
+
+/**
+  Fill the test store with Count variables in every state a store can hold:
+  plain added variables, updated variables with a deleted old copy, updates
+  interrupted in the middle (in deleted transition), and variables without
+  runtime access.
+
+  @param[in] Count        Number of variable names.
+**/
+STATIC
+VOID
+PopulateStore (
+  IN UINTN  Count
+  )
+{
+  UINTN   Index;
+  CHAR16  Name[TEST_NAME_LENGTH];
+  UINT32  Attributes;
+
+  FormatStore ();
+  Attributes = EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS;
+
+  for (Index = 0; Index < Count; Index++) {
+    TestVariableName (Name, Index);
+    switch (Index % 5) {
+      case 1:
+        AppendVariable (Name, &mTestGuid[Index % TEST_GUID_COUNT], VAR_ADDED & VAR_DELETED, Attributes);
+        break;
+      case 2:
+      case 3:
+        AppendVariable (Name, &mTestGuid[Index % TEST_GUID_COUNT], VAR_ADDED & VAR_IN_DELETED_TRANSITION, Attributes);
+        break;
+      default:
+        break;
+    }
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    TestVariableName (Name, Index);
+    switch (Index % 5) {
+      case 3:
+        break;
+      case 4:
+        AppendVariable (Name, &mTestGuid[Index % TEST_GUID_COUNT], VAR_ADDED, EFI_VARIABLE_BOOTSERVICE_ACCESS);
+        break;
+      default:
+        AppendVariable (Name, &mTestGuid[Index % TEST_GUID_COUNT], VAR_ADDED, Attributes);
+        break;
+    }
+  }
+}
+
+/**
+  Attach or detach the index of the test store.
+
+  @param[in] Attach       TRUE to attach the index, FALSE to detach it.
+**/
+STATIC
+VOID
+AttachStoreIndex (
+  IN BOOLEAN  Attach
+  )
+{
+  VARIABLE_STORE_HEADER  *StoreList[VariableStoreTypeMax];
+
+  ZeroMem (StoreList, sizeof (StoreList));
+  StoreList[VariableStoreTypeNv] = Attach ? mStore : NULL;
+  RefreshVariableStoreIndex (StoreList, FALSE);
+}
+
+/**
+  Look up a variable of the test store.
+
+  @param[in]  Name           Name of the variable.
+  @param[in]  Guid           Vendor GUID of the variable.
+  @param[in]  IgnoreRtCheck  Ignore the runtime access attribute.
+  @param[out] PtrTrack       The lookup result.
+
+  @return The status returned by FindVariableEx().
+**/
+STATIC
+EFI_STATUS
+LookupVariable (
+  IN  CHAR16                  *Name,
+  IN  EFI_GUID                *Guid,
+  IN  BOOLEAN                 IgnoreRtCheck,
+  OUT VARIABLE_POINTER_TRACK  *PtrTrack
+  )
+{
+  ZeroMem (PtrTrack, sizeof (*PtrTrack));
+  PtrTrack->StartPtr = GetStartPointer (mStore);
+  PtrTrack->EndPtr   = GetEndPointer (mStore);
+  return FindVariableEx (Name, Guid, IgnoreRtCheck, PtrTrack, FALSE);
+}
+
+/**
+  Check a lookup through the index returns the same result as the linear
+  search.
+
+  @param[in] Name           Name of the variable.
+  @param[in] Guid           Vendor GUID of the variable.
+  @param[in] IgnoreRtCheck  Ignore the runtime access attribute.
+
+  @retval TRUE              The results match.
+  @retval FALSE             The results differ.
+**/
+STATIC
+BOOLEAN
+LookupMatchesLinear (
+  IN CHAR16    *Name,
+  IN EFI_GUID  *Guid,
+  IN BOOLEAN   IgnoreRtCheck
+  )
+{
+  EFI_STATUS              IndexStatus;
+  EFI_STATUS              LinearStatus;
+  VARIABLE_POINTER_TRACK  IndexTrack;
+  VARIABLE_POINTER_TRACK  LinearTrack;
+
+  IndexStatus = LookupVariable (Name, Guid, IgnoreRtCheck, &IndexTrack);
+
+  mVariableStoreIndex[VariableStoreTypeNv].Store = NULL;
+  LinearStatus                                   = LookupVariable (Name, Guid, IgnoreRtCheck, &LinearTrack);
+  mVariableStoreIndex[VariableStoreTypeNv].Store = mStore;
+
+  return (BOOLEAN)((IndexStatus == LinearStatus) &&
+                   (IndexTrack.CurrPtr == LinearTrack.CurrPtr) &&
+                   (IndexTrack.InDeletedTransitionPtr == LinearTrack.InDeletedTransitionPtr));
+}
+
+/**
+  Allocate the test store before each test case.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED                      The store is ready.
+  @retval  UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  Out of memory.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SetupStore (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  mAtRuntime = FALSE;
+  mStore     = AllocatePool (TEST_STORE_SIZE);
+  if (mStore == NULL) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  FormatStore ();
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Free the test store and the store indexes after each test case.
+
+  @param[in]  Context    Unused.
+**/
+STATIC
+VOID
+EFIAPI
+CleanupStore (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VARIABLE_STORE_TYPE  Type;
+
+  for (Type = (VARIABLE_STORE_TYPE)0; Type < VariableStoreTypeMax; Type++) {
+    if (mVariableStoreIndex[Type].Entries != NULL) {
+      FreePool (mVariableStoreIndex[Type].Entries);
+    }
+
+    ZeroMem (&mVariableStoreIndex[Type], sizeof (mVariableStoreIndex[Type]));
+  }
+
+  FreePool (mStore);
+  mStore = NULL;
+}
+
+/**
+  Every lookup through the index must match the linear search, before and
+  after ExitBootServices, for present and absent names and GUIDs.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+LookupShouldMatchLinearSearch (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN   Index;
+  UINTN   GuidIndex;
+  UINTN   Pass;
+  CHAR16  Name[TEST_NAME_LENGTH];
+
+  PopulateStore (TEST_VARIABLE_COUNT);
+  AttachStoreIndex (TRUE);
+  UT_ASSERT_NOT_NULL (mVariableStoreIndex[VariableStoreTypeNv].Entries);
+
+  for (Pass = 0; Pass < 2; Pass++) {
+    mAtRuntime = (BOOLEAN)(Pass == 1);
+    for (Index = 0; Index < TEST_VARIABLE_COUNT + 10; Index++) {
+      TestVariableName (Name, Index);
+      for (GuidIndex = 0; GuidIndex < TEST_GUID_COUNT; GuidIndex++) {
+        UT_ASSERT_TRUE (LookupMatchesLinear (Name, &mTestGuid[GuidIndex], FALSE));
+        UT_ASSERT_TRUE (LookupMatchesLinear (Name, &mTestGuid[GuidIndex], TRUE));
+      }
+    }
+
+    UT_ASSERT_TRUE (LookupMatchesLinear (L"TestVar", &mTestGuid[0], FALSE));
+    UT_ASSERT_TRUE (LookupMatchesLinear (L"TestVar000000", &mTestGuid[0], FALSE));
+  }
+
+  //
+  // The store is bigger than the initial index, so the index has grown.
+  //
+  UT_ASSERT_TRUE (mVariableStoreIndex[VariableStoreTypeNv].MaxEntries >= TEST_VARIABLE_COUNT);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Variables appended or deleted after the store was indexed, and variables
+  moved by a reclaim, must be found as by the linear search.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+StoreUpdatesShouldBeTracked (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VARIABLE_POINTER_TRACK  PtrTrack;
+  VARIABLE_HEADER         *Variable;
+  VARIABLE_HEADER         *Added;
+  CHAR16                  Name[TEST_NAME_LENGTH];
+  UINTN                   Index;
+  UINTN                   Offset;
+  UINT8                   *Live;
+  UINTN                   LiveSize;
+
+  PopulateStore (TEST_VARIABLE_COUNT);
+  AttachStoreIndex (TRUE);
+
+  //
+  // Append: a new variable, and a new copy of an existing one.
+  //
+  UT_ASSERT_EQUAL (LookupVariable (L"NewVar", &mTestGuid[1], FALSE, &PtrTrack), EFI_NOT_FOUND);
+  Added = AppendVariable (L"NewVar", &mTestGuid[1], VAR_ADDED, EFI_VARIABLE_BOOTSERVICE_ACCESS);
+  UT_ASSERT_EQUAL (LookupVariable (L"NewVar", &mTestGuid[1], FALSE, &PtrTrack), EFI_SUCCESS);
+  UT_ASSERT_EQUAL ((UINTN)PtrTrack.CurrPtr, (UINTN)Added);
+
+  TestVariableName (Name, 0);
+  UT_ASSERT_EQUAL (LookupVariable (Name, &mTestGuid[0], FALSE, &PtrTrack), EFI_SUCCESS);
+  Variable = PtrTrack.CurrPtr;
+  Variable->State &= VAR_IN_DELETED_TRANSITION;
+  Added            = AppendVariable (Name, &mTestGuid[0], VAR_ADDED, EFI_VARIABLE_BOOTSERVICE_ACCESS);
+  UT_ASSERT_TRUE (LookupMatchesLinear (Name, &mTestGuid[0], FALSE));
+  UT_ASSERT_EQUAL (LookupVariable (Name, &mTestGuid[0], FALSE, &PtrTrack), EFI_SUCCESS);
+  UT_ASSERT_EQUAL ((UINTN)PtrTrack.CurrPtr, (UINTN)Added);
+  UT_ASSERT_EQUAL ((UINTN)PtrTrack.InDeletedTransitionPtr, (UINTN)Variable);
+
+  //
+  // Delete: deleted variables are dropped from the index.
+  //
+  Variable->State &= VAR_DELETED;
+  UT_ASSERT_TRUE (LookupMatchesLinear (Name, &mTestGuid[0], FALSE));
+  UT_ASSERT_NOT_EQUAL (mVariableStoreIndex[VariableStoreTypeNv].FreeEntry, VARIABLE_STORE_INDEX_NIL);
+
+  Added->State &= VAR_DELETED;
+  UT_ASSERT_EQUAL (LookupVariable (Name, &mTestGuid[0], FALSE, &PtrTrack), EFI_NOT_FOUND);
+
+  //
+  // Reclaim: compact the store in place, keeping the live variables only.
+  //
+  Live     = AllocatePool (TEST_STORE_SIZE);
+  LiveSize = 0;
+  UT_ASSERT_NOT_NULL (Live);
+  for (Variable = GetStartPointer (mStore); IsValidVariableHeader (Variable, mStoreEnd); Variable = GetNextVariablePtr (Variable, FALSE)) {
+    if ((Variable->State == VAR_ADDED) || (Variable->State == (VAR_ADDED & VAR_IN_DELETED_TRANSITION))) {
+      Offset = (UINTN)GetNextVariablePtr (Variable, FALSE) - (UINTN)Variable;
+      CopyMem (Live + LiveSize, Variable, Offset);
+      LiveSize += Offset;
+    }
+  }
+
+  FormatStore ();
+  CopyMem (mStoreEnd, Live, LiveSize);
+  mStoreEnd = (VARIABLE_HEADER *)((UINTN)mStoreEnd + LiveSize);
+  FreePool (Live);
+  InvalidateVariableStoreIndex ();
+
+  for (Index = 0; Index < TEST_VARIABLE_COUNT; Index++) {
+    TestVariableName (Name, Index);
+    UT_ASSERT_TRUE (LookupMatchesLinear (Name, &mTestGuid[Index % TEST_GUID_COUNT], FALSE));
+  }
+
+  UT_ASSERT_TRUE (LookupMatchesLinear (L"NewVar", &mTestGuid[1], FALSE));
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  At runtime the index cannot grow. Variables it has no room for must still
+  be found.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+FullIndexShouldFallBackToLinearSearch (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VARIABLE_STORE_HEADER  *StoreList[VariableStoreTypeMax];
+  UINTN                  Index;
+  CHAR16                 Name[TEST_NAME_LENGTH];
+
+  //
+  // Attach at boot time while the store is small, then fill it at runtime.
+  //
+  PopulateStore (10);
+  AttachStoreIndex (TRUE);
+  UT_ASSERT_TRUE (LookupMatchesLinear (L"TestVar00000", &mTestGuid[0], FALSE));
+  UT_ASSERT_EQUAL (mVariableStoreIndex[VariableStoreTypeNv].MaxEntries, VARIABLE_STORE_INDEX_MIN_ENTRIES);
+
+  mAtRuntime = TRUE;
+  PopulateStore (TEST_VARIABLE_COUNT);
+  InvalidateVariableStoreIndex ();
+
+  for (Index = 0; Index < TEST_VARIABLE_COUNT; Index++) {
+    TestVariableName (Name, Index);
+    UT_ASSERT_TRUE (LookupMatchesLinear (Name, &mTestGuid[Index % TEST_GUID_COUNT], FALSE));
+  }
+
+  UT_ASSERT_EQUAL (mVariableStoreIndex[VariableStoreTypeNv].MaxEntries, VARIABLE_STORE_INDEX_MIN_ENTRIES);
+
+  //
+  // A store can't be attached at runtime if no index memory was allocated.
+  //
+  mVariableStoreIndex[VariableStoreTypeVolatile].Store = NULL;
+  UT_ASSERT_TRUE (mVariableStoreIndex[VariableStoreTypeVolatile].Entries == NULL);
+  ZeroMem (StoreList, sizeof (StoreList));
+  StoreList[VariableStoreTypeVolatile] = mStore;
+  RefreshVariableStoreIndex (StoreList, FALSE);
+  UT_ASSERT_TRUE (mVariableStoreIndex[VariableStoreTypeVolatile].Store == NULL);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Enumerate all the variables of the test store.
+
+  @param[out] Count     Number of variables enumerated.
+  @param[out] Checksum  Sum of the addresses of the variables enumerated.
+
+  @return The status returned by the enumeration.
+**/
+STATIC
+EFI_STATUS
+EnumerateStore (
+  OUT UINTN  *Count,
+  OUT UINTN  *Checksum
+  )
+{
+  EFI_STATUS             Status;
+  VARIABLE_STORE_HEADER  *StoreList[VariableStoreTypeMax];
+  VARIABLE_HEADER        *Variable;
+  CHAR16                 Name[TEST_NAME_LENGTH];
+  EFI_GUID               Guid;
+
+  ZeroMem (StoreList, sizeof (StoreList));
+  StoreList[VariableStoreTypeNv] = mStore;
+
+  *Count    = 0;
+  *Checksum = 0;
+  Name[0]   = 0;
+  ZeroMem (&Guid, sizeof (Guid));
+  while (TRUE) {
+    Status = VariableServiceGetNextVariableInternal (Name, &Guid, StoreList, &Variable, FALSE);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    CopyMem (Name, GetVariableNamePtr (Variable, FALSE), NameSizeOfVariable (Variable, FALSE));
+    CopyGuid (&Guid, GetVendorGuidPtr (Variable, FALSE));
+    *Count    += 1;
+    *Checksum += (UINTN)Variable;
+  }
+}
+
+/**
+  Enumeration through the index must return the same variables as the
+  linear search.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+EnumerationShouldMatchLinearSearch (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  IndexCount;
+  UINTN  IndexChecksum;
+  UINTN  LinearCount;
+  UINTN  LinearChecksum;
+
+  PopulateStore (TEST_VARIABLE_COUNT);
+
+  AttachStoreIndex (FALSE);
+  UT_ASSERT_EQUAL (EnumerateStore (&LinearCount, &LinearChecksum), EFI_NOT_FOUND);
+  AttachStoreIndex (TRUE);
+  UT_ASSERT_EQUAL (EnumerateStore (&IndexCount, &IndexChecksum), EFI_NOT_FOUND);
+
+  UT_ASSERT_EQUAL (IndexCount, LinearCount);
+  UT_ASSERT_EQUAL (IndexChecksum, LinearChecksum);
+  UT_ASSERT_EQUAL (IndexCount, TEST_VARIABLE_COUNT / 5 * 4);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Measure the lookup and full enumeration costs with and without the index,
+  across store sizes.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkLookupCost (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINTN      StoreSizes[] = { 256, 1024, 4096 };
+  VARIABLE_POINTER_TRACK  PtrTrack;
+  CHAR16                  Name[TEST_NAME_LENGTH];
+  UINTN                   SizeIndex;
+  UINTN                   Count;
+  UINTN                   Index;
+  UINTN                   Checksum;
+  UINTN                   Pass;
+  UINT64                  Start;
+  UINT64                  LookupNs[2];
+  UINT64                  EnumerateNs[2];
+
+  for (SizeIndex = 0; SizeIndex < ARRAY_SIZE (StoreSizes); SizeIndex++) {
+    Count = StoreSizes[SizeIndex];
+    PopulateStore (Count);
+
+    for (Pass = 0; Pass < 2; Pass++) {
+      AttachStoreIndex ((BOOLEAN)(Pass == 1));
+
+      Start = UnitTestBenchmarkStart ();
+      for (Index = 0; Index < Count; Index++) {
+        TestVariableName (Name, Index);
+        LookupVariable (Name, &mTestGuid[Index % TEST_GUID_COUNT], FALSE, &PtrTrack);
+      }
+
+      LookupNs[Pass] = UnitTestBenchmarkStop (Start);
+
+      Start = UnitTestBenchmarkStart ();
+      UT_ASSERT_EQUAL (EnumerateStore (&Index, &Checksum), EFI_NOT_FOUND);
+      EnumerateNs[Pass] = UnitTestBenchmarkStop (Start);
+    }
+
+    UT_LOG_INFO (
+      "%d variables: lookup %ld ns (linear) vs %ld ns (index), enumeration %ld ns (linear) vs %ld ns (index)\n",
+      Count,
+      DivU64x64Remainder (LookupNs[0], Count, NULL),
+      DivU64x64Remainder (LookupNs[1], Count, NULL),
+      EnumerateNs[0],
+      EnumerateNs[1]
+      );
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Compact the test store the way Reclaim() does, and check that writing only
+  the range returned by GetReclaimWriteRange() over the old store gives the
+  compacted store.
+
+  @param[in]  UpdatingVariable  The variable replaced by the reclaim, or NULL.
+  @param[in]  AddVariable       TRUE to append a new variable to the compacted
+                                store.
+  @param[out] WriteOffset       The offset of the range written.
+  @param[out] WriteEnd          The end of the range written.
+
+  @retval  UNIT_TEST_PASSED             The partial write gives the compacted store.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+CheckReclaimWriteRange (
+  IN  VARIABLE_HEADER  *UpdatingVariable OPTIONAL,
+  IN  BOOLEAN          AddVariable,
+  OUT UINTN            *WriteOffset,
+  OUT UINTN            *WriteEnd
+  )
+{
+  UINT8            *NewStore;
+  UINT8            *Written;
+  UINTN            NewUsedSize;
+  UINTN            VariableSize;
+  VARIABLE_HEADER  *Variable;
+  VARIABLE_HEADER  *Copied;
+
+  NewStore = AllocatePool (TEST_STORE_SIZE);
+  Written  = AllocatePool (TEST_STORE_SIZE);
+  UT_ASSERT_NOT_NULL (NewStore);
+  UT_ASSERT_NOT_NULL (Written);
+
+  SetMem (NewStore, TEST_STORE_SIZE, 0xFF);
+  CopyMem (NewStore, mStore, sizeof (VARIABLE_STORE_HEADER));
+  NewUsedSize = (UINTN)GetStartPointer (mStore) - (UINTN)mStore;
+
+  //
+  // Added variables first, then the ones in deleted transition promoted to
+  // added, then the new variable.
+  //
+  for (Variable = GetStartPointer (mStore); IsValidVariableHeader (Variable, mStoreEnd); Variable = GetNextVariablePtr (Variable, FALSE)) {
+    if ((Variable != UpdatingVariable) && (Variable->State == VAR_ADDED)) {
+      VariableSize = (UINTN)GetNextVariablePtr (Variable, FALSE) - (UINTN)Variable;
+      CopyMem (NewStore + NewUsedSize, Variable, VariableSize);
+      NewUsedSize += VariableSize;
+    }
+  }
+
+  for (Variable = GetStartPointer (mStore); IsValidVariableHeader (Variable, mStoreEnd); Variable = GetNextVariablePtr (Variable, FALSE)) {
+    if ((Variable != UpdatingVariable) && (Variable->State == (VAR_ADDED & VAR_IN_DELETED_TRANSITION))) {
+      VariableSize = (UINTN)GetNextVariablePtr (Variable, FALSE) - (UINTN)Variable;
+      Copied       = (VARIABLE_HEADER *)(NewStore + NewUsedSize);
+      CopyMem (Copied, Variable, VariableSize);
+      Copied->State = VAR_ADDED;
+      NewUsedSize  += VariableSize;
+    }
+  }
+
+  if (AddVariable) {
+    Variable     = GetStartPointer (mStore);
+    VariableSize = (UINTN)GetNextVariablePtr (Variable, FALSE) - (UINTN)Variable;
+    Copied       = (VARIABLE_HEADER *)(NewStore + NewUsedSize);
+    CopyMem (Copied, Variable, VariableSize);
+    Copied->State = VAR_ADDED;
+    NewUsedSize  += VariableSize;
+  }
+
+  GetReclaimWriteRange (mStore, UpdatingVariable, NewUsedSize, FALSE, WriteOffset, WriteEnd);
+  UT_ASSERT_TRUE (*WriteOffset <= *WriteEnd);
+  UT_ASSERT_TRUE (*WriteEnd <= TEST_STORE_SIZE);
+
+  CopyMem (Written, mStore, TEST_STORE_SIZE);
+  CopyMem (Written + *WriteOffset, NewStore + *WriteOffset, *WriteEnd - *WriteOffset);
+  UT_ASSERT_MEM_EQUAL (Written, NewStore, TEST_STORE_SIZE);
+
+  FreePool (NewStore);
+  FreePool (Written);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  An incremental reclaim only writes from the first variable that moves to
+  the end of the used area of the old or the compacted store.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+ReclaimShouldWriteChangedRangeOnly (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UNIT_TEST_STATUS  Status;
+  VARIABLE_HEADER   *Variable[100];
+  CHAR16            Name[TEST_NAME_LENGTH];
+  UINTN             Index;
+  UINTN             OldUsedSize;
+  UINTN             WriteOffset;
+  UINTN             WriteEnd;
+
+  //
+  // A store that starts with deleted variables is written from its first
+  // variable.
+  //
+  PopulateStore (TEST_VARIABLE_COUNT);
+  Status = CheckReclaimWriteRange (NULL, FALSE, &WriteOffset, &WriteEnd);
+  UT_ASSERT_STATUS_EQUAL (Status, UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (WriteOffset, (UINTN)GetStartPointer (mStore) - (UINTN)mStore);
+  UT_ASSERT_TRUE (WriteEnd <= (UINTN)mStoreEnd - (UINTN)mStore);
+
+  //
+  // Nothing to reclaim: nothing is written.
+  //
+  FormatStore ();
+  for (Index = 0; Index < ARRAY_SIZE (Variable); Index++) {
+    TestVariableName (Name, Index);
+    Variable[Index] = AppendVariable (Name, &mTestGuid[Index % TEST_GUID_COUNT], VAR_ADDED, EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS);
+  }
+
+  OldUsedSize = (UINTN)mStoreEnd - (UINTN)mStore;
+  Status      = CheckReclaimWriteRange (NULL, FALSE, &WriteOffset, &WriteEnd);
+  UT_ASSERT_STATUS_EQUAL (Status, UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (WriteOffset, OldUsedSize);
+  UT_ASSERT_EQUAL (WriteEnd, OldUsedSize);
+
+  //
+  // A new variable only: the tail of the store is written.
+  //
+  Status = CheckReclaimWriteRange (NULL, TRUE, &WriteOffset, &WriteEnd);
+  UT_ASSERT_STATUS_EQUAL (Status, UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (WriteOffset, OldUsedSize);
+  UT_ASSERT_TRUE (WriteEnd > OldUsedSize);
+
+  //
+  // A variable replaced near the end of the store: the store is written
+  // from it, through the end of the compacted store.
+  //
+  Status = CheckReclaimWriteRange (Variable[95], TRUE, &WriteOffset, &WriteEnd);
+  UT_ASSERT_STATUS_EQUAL (Status, UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (WriteOffset, (UINTN)Variable[95] - (UINTN)mStore);
+  UT_ASSERT_TRUE (WriteEnd >= OldUsedSize);
+
+  //
+  // A variable deleted near the end of the store: the store is written from
+  // it, through the end of the old store that the compacted one erases.
+  //
+  Variable[90]->State &= VAR_DELETED;
+  Status               = CheckReclaimWriteRange (NULL, FALSE, &WriteOffset, &WriteEnd);
+  UT_ASSERT_STATUS_EQUAL (Status, UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (WriteOffset, (UINTN)Variable[90] - (UINTN)mStore);
+  UT_ASSERT_TRUE (WriteEnd > (UINTN)Variable[99] - (UINTN)mStore);
+  UT_ASSERT_TRUE (WriteEnd <= OldUsedSize);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the variable
+  store index and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      IndexTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&IndexTests, Framework, "Variable Store Index Tests", "Variable.StoreIndex", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Variable Store Index Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (IndexTests, "Lookup matches linear search", "Lookup", LookupShouldMatchLinearSearch, SetupStore, CleanupStore, NULL);
+  AddTestCase (IndexTests, "Store updates are tracked", "Updates", StoreUpdatesShouldBeTracked, SetupStore, CleanupStore, NULL);
+  AddTestCase (IndexTests, "Full index falls back to linear search", "FullIndex", FullIndexShouldFallBackToLinearSearch, SetupStore, CleanupStore, NULL);
+  AddTestCase (IndexTests, "Enumeration matches linear search", "Enumeration", EnumerationShouldMatchLinearSearch, SetupStore, CleanupStore, NULL);
+  AddTestCase (IndexTests, "Lookup cost benchmark", "Benchmark", BenchmarkLookupCost, SetupStore, CleanupStore, NULL);
+  AddTestCase (IndexTests, "Reclaim writes the changed range only", "ReclaimRange", ReclaimShouldWriteChangedRangeOnly, SetupStore, CleanupStore, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define VariableStoreIndexUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+VariableStoreIndexUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  UnitTestingEntry ();
+  return 0;
+}
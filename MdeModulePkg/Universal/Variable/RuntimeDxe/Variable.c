@@ -545,6 +545,13 @@ Reclaim (
   VARIABLE_HEADER        *UpdatingVariable;
   VARIABLE_HEADER        *UpdatingInDeletedTransition;
   BOOLEAN                AuthFormat;
+  UINTN                  WriteOffset;
+  UINTN                  WriteEnd;
+  UINTN                  DeletedVariableSize;
+
+  if (!AtRuntime ()) {
+    PERF_INMODULE_BEGIN ("VariableReclaim");
+  }
 
   AuthFormat                  = mVariableModuleGlobal->VariableGlobal.AuthFormat;
   UpdatingVariable            = NULL;
@@ -595,6 +602,10 @@ Reclaim (
     MaximumBufferSize += 1;
     ValidBuffer        = AllocatePool (MaximumBufferSize);
     if (ValidBuffer == NULL) {
+      if (!AtRuntime ()) {
+        PERF_INMODULE_END ("VariableReclaim");
+      }
+
       return EFI_OUT_OF_RESOURCES;
     }
   } else {
@@ -748,9 +759,10 @@ Reclaim (
       //
       // Emulated non-volatile variable mode.
       //
-      mVariableModuleGlobal->HwErrVariableTotalSize      = HwErrVariableTotalSize;
-      mVariableModuleGlobal->CommonVariableTotalSize     = CommonVariableTotalSize;
-      mVariableModuleGlobal->CommonUserVariableTotalSize = CommonUserVariableTotalSize;
+      mVariableModuleGlobal->HwErrVariableTotalSize         = HwErrVariableTotalSize;
+      mVariableModuleGlobal->CommonVariableTotalSize        = CommonVariableTotalSize;
+      mVariableModuleGlobal->CommonUserVariableTotalSize    = CommonUserVariableTotalSize;
+      mVariableModuleGlobal->NonVolatileDeletedVariableSize = 0;
     }
 
     Status = EFI_SUCCESS;
@@ -758,23 +770,61 @@ Reclaim (
     //
     // If non-volatile variable store, perform FTW here.
     //
-    Status = FtwVariableSpace (
-               VariableBase,
-               (VARIABLE_STORE_HEADER *)ValidBuffer
-               );
+    WriteOffset = 0;
+    WriteEnd    = VariableStoreHeader->Size;
+    if (FeaturePcdGet (PcdVariableIncrementalReclaim)) {
+      //
+      // Only write from the first variable that moves through the end of the
+      // used area of the old or the new store, whichever is larger. The rest
+      // of the store is the same before and after the reclaim.
+      //
+      GetReclaimWriteRange (
+        VariableStoreHeader,
+        UpdatingVariable,
+        (UINTN)CurrPtr - (UINTN)ValidBuffer,
+        AuthFormat,
+        &WriteOffset,
+        &WriteEnd
+        );
+    }
+
+    DEBUG ((
+      DEBUG_VERBOSE,
+      "Variable driver: reclaim writes 0x%x bytes at offset 0x%x of the 0x%x bytes store\n",
+      WriteEnd - WriteOffset,
+      WriteOffset,
+      VariableStoreHeader->Size
+      ));
+
+    Status = EFI_SUCCESS;
+    if (WriteEnd > WriteOffset) {
+      Status = FtwVariableSpace (
+                 VariableBase,
+                 (VARIABLE_STORE_HEADER *)ValidBuffer,
+                 WriteOffset,
+                 WriteEnd - WriteOffset
+                 );
+    }
+
     if (!EFI_ERROR (Status)) {
-      *LastVariableOffset                                = (UINTN)CurrPtr - (UINTN)ValidBuffer;
-      mVariableModuleGlobal->HwErrVariableTotalSize      = HwErrVariableTotalSize;
-      mVariableModuleGlobal->CommonVariableTotalSize     = CommonVariableTotalSize;
-      mVariableModuleGlobal->CommonUserVariableTotalSize = CommonUserVariableTotalSize;
+      *LastVariableOffset                                   = (UINTN)CurrPtr - (UINTN)ValidBuffer;
+      mVariableModuleGlobal->HwErrVariableTotalSize         = HwErrVariableTotalSize;
+      mVariableModuleGlobal->CommonVariableTotalSize        = CommonVariableTotalSize;
+      mVariableModuleGlobal->CommonUserVariableTotalSize    = CommonUserVariableTotalSize;
+      mVariableModuleGlobal->NonVolatileDeletedVariableSize = 0;
     } else {
       mVariableModuleGlobal->HwErrVariableTotalSize      = 0;
       mVariableModuleGlobal->CommonVariableTotalSize     = 0;
       mVariableModuleGlobal->CommonUserVariableTotalSize = 0;
+      DeletedVariableSize                                = 0;
       Variable                                           = GetStartPointer ((VARIABLE_STORE_HEADER *)(UINTN)VariableBase);
       while (IsValidVariableHeader (Variable, GetEndPointer ((VARIABLE_STORE_HEADER *)(UINTN)VariableBase))) {
         NextVariable = GetNextVariablePtr (Variable, AuthFormat);
         VariableSize = (UINTN)NextVariable - (UINTN)Variable;
+        if (Variable->State != VAR_ADDED) {
+          DeletedVariableSize += VariableSize;
+        }
+
         if ((Variable->Attributes & EFI_VARIABLE_HARDWARE_ERROR_RECORD) == EFI_VARIABLE_HARDWARE_ERROR_RECORD) {
           mVariableModuleGlobal->HwErrVariableTotalSize += VariableSize;
         } else if ((Variable->Attributes & EFI_VARIABLE_HARDWARE_ERROR_RECORD) != EFI_VARIABLE_HARDWARE_ERROR_RECORD) {
@@ -787,11 +837,17 @@ Reclaim (
         Variable = NextVariable;
       }
 
-      *LastVariableOffset = (UINTN)Variable - (UINTN)VariableBase;
+      *LastVariableOffset                                   = (UINTN)Variable - (UINTN)VariableBase;
+      mVariableModuleGlobal->NonVolatileDeletedVariableSize = DeletedVariableSize;
     }
   }
 
 Done:
+  //
+  // The variables of the store have moved, index them again.
+  //
+  InvalidateVariableStoreIndex ();
+
   DoneStatus = EFI_SUCCESS;
   if (IsVolatile || mVariableModuleGlobal->VariableGlobal.EmuNvMode) {
     DoneStatus = SynchronizeRuntimeVariableCache (
@@ -818,6 +874,10 @@ Done:
     Status = DoneStatus;
   }
 
+  if (!AtRuntime ()) {
+    PERF_INMODULE_END ("VariableReclaim");
+  }
+
   return Status;
 }
 
@@ -872,6 +932,7 @@ FindVariable (
   VariableStoreHeader[VariableStoreTypeVolatile] = (VARIABLE_STORE_HEADER *)(UINTN)Global->VolatileVariableBase;
   VariableStoreHeader[VariableStoreTypeHob]      = (VARIABLE_STORE_HEADER *)(UINTN)Global->HobVariableBase;
   VariableStoreHeader[VariableStoreTypeNv]       = mNvVariableCache;
+  RefreshVariableStoreIndex (VariableStoreHeader, Global->AuthFormat);
 
   //
   // Find the variable by walk through HOB, volatile and non-volatile variable store.
@@ -1877,7 +1938,8 @@ UpdateVariable (
       if (!EFI_ERROR (Status)) {
         UpdateVariableInfo (VariableName, VendorGuid, Variable->Volatile, FALSE, FALSE, TRUE, FALSE, &gVariableInfo);
         if (!Variable->Volatile) {
-          CacheVariable->CurrPtr->State = State;
+          CacheVariable->CurrPtr->State                         = State;
+          mVariableModuleGlobal->NonVolatileDeletedVariableSize += (UINTN)GetNextVariablePtr (CacheVariable->CurrPtr, AuthFormat) - (UINTN)CacheVariable->CurrPtr;
           FlushHobVariableToFlash (VariableName, VendorGuid);
         }
       }
@@ -2374,7 +2436,8 @@ UpdateVariable (
                &State
                );
     if (!EFI_ERROR (Status) && !Variable->Volatile) {
-      CacheVariable->CurrPtr->State = State;
+      CacheVariable->CurrPtr->State                         = State;
+      mVariableModuleGlobal->NonVolatileDeletedVariableSize += (UINTN)GetNextVariablePtr (CacheVariable->CurrPtr, AuthFormat) - (UINTN)CacheVariable->CurrPtr;
     }
   }
 
@@ -2561,6 +2624,7 @@ VariableServiceGetNextVariableName (
   VariableStoreHeader[VariableStoreTypeVolatile] = (VARIABLE_STORE_HEADER *)(UINTN)mVariableModuleGlobal->VariableGlobal.VolatileVariableBase;
   VariableStoreHeader[VariableStoreTypeHob]      = (VARIABLE_STORE_HEADER *)(UINTN)mVariableModuleGlobal->VariableGlobal.HobVariableBase;
   VariableStoreHeader[VariableStoreTypeNv]       = mNvVariableCache;
+  RefreshVariableStoreIndex (VariableStoreHeader, AuthFormat);
 
   Status =  VariableServiceGetNextVariableInternal (
               VariableName,
@@ -3241,12 +3305,14 @@ ReclaimForOS (
   RemainingHwErrVariableSpace = PcdGet32 (PcdHwErrStorageSize) - mVariableModuleGlobal->HwErrVariableTotalSize;
 
   //
-  // Check if the free area is below a threshold.
+  // Check if the free area is below a threshold, and if a reclaim can free
+  // anything: a store without deleted variables would be rewritten as is.
   //
-  if (((RemainingCommonRuntimeVariableSpace < mVariableModuleGlobal->MaxVariableSize) ||
-       (RemainingCommonRuntimeVariableSpace < mVariableModuleGlobal->MaxAuthVariableSize)) ||
-      ((PcdGet32 (PcdHwErrStorageSize) != 0) &&
-       (RemainingHwErrVariableSpace < PcdGet32 (PcdMaxHardwareErrorVariableSize))))
+  if ((((RemainingCommonRuntimeVariableSpace < mVariableModuleGlobal->MaxVariableSize) ||
+        (RemainingCommonRuntimeVariableSpace < mVariableModuleGlobal->MaxAuthVariableSize)) ||
+       ((PcdGet32 (PcdHwErrStorageSize) != 0) &&
+        (RemainingHwErrVariableSpace < PcdGet32 (PcdMaxHardwareErrorVariableSize)))) &&
+      (mVariableModuleGlobal->NonVolatileDeletedVariableSize != 0))
   {
     Status = Reclaim (
                mVariableModuleGlobal->VariableGlobal.NonVolatileVariableBase,
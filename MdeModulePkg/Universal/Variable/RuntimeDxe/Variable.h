@@ -33,6 +33,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/VarCheckLib.h>
 #include <Library/VariableFlashInfoLib.h>
 #include <Library/SafeIntLib.h>
+#include <Library/PerformanceLib.h>
 #include <Guid/GlobalVariable.h>
 #include <Guid/EventGroup.h>
 #include <Guid/VariableFormat.h>
@@ -90,6 +91,39 @@ typedef struct {
   BOOLEAN            Volatile;
 } VARIABLE_POINTER_TRACK;
 
+#define VARIABLE_STORE_INDEX_NIL          MAX_UINT32
+#define VARIABLE_STORE_INDEX_MIN_ENTRIES  64
+
+///
+/// One variable of a variable store index. Variables are recorded by offset
+/// from the start of the store, so the index does not need to be converted
+/// when the store is.
+///
+typedef struct {
+  UINT32    Offset;
+  UINT32    Hash;
+  UINT32    Next;
+} VARIABLE_STORE_INDEX_ENTRY;
+
+///
+/// Hash index of the variables of one variable store, keyed by name and GUID.
+/// The variables in front of IndexedOffset are indexed, except the deleted
+/// ones which are dropped as they are found. Variables appended to the store
+/// are indexed by the next lookup. A store rewritten in place (by Reclaim)
+/// requires the index to be reset.
+///
+typedef struct {
+  VARIABLE_STORE_HEADER         *Store;
+  VARIABLE_STORE_INDEX_ENTRY    *Entries;
+  UINT32                        *Buckets;
+  UINT32                        BucketMask;
+  UINT32                        MaxEntries;
+  UINT32                        EntryCount;
+  UINT32                        FreeEntry;
+  UINT32                        IndexedOffset;
+  BOOLEAN                       AuthFormat;
+} VARIABLE_STORE_INDEX;
+
 typedef struct {
   EFI_PHYSICAL_ADDRESS              HobVariableBase;
   EFI_PHYSICAL_ADDRESS              VolatileVariableBase;
@@ -112,6 +146,7 @@ typedef struct {
   UINTN                                 CommonVariableTotalSize;
   UINTN                                 CommonUserVariableTotalSize;
   UINTN                                 HwErrVariableTotalSize;
+  UINTN                                 NonVolatileDeletedVariableSize;
   UINTN                                 MaxVariableSize;
   UINTN                                 MaxAuthVariableSize;
   UINTN                                 MaxVolatileVariableSize;
@@ -145,6 +180,8 @@ FlushHobVariableToFlash (
 
   @param  VariableBase   Base address of the variable to write.
   @param  VariableBuffer Point to the variable data buffer.
+  @param  WriteOffset    Offset in the variable store of the first byte to write.
+  @param  WriteSize      Number of bytes to write.
 
   @retval EFI_SUCCESS    The function completed successfully.
   @retval EFI_NOT_FOUND  Fail to locate Fault Tolerant Write protocol.
@@ -154,7 +191,9 @@ FlushHobVariableToFlash (
 EFI_STATUS
 FtwVariableSpace (
   IN EFI_PHYSICAL_ADDRESS   VariableBase,
-  IN VARIABLE_STORE_HEADER  *VariableBuffer
+  IN VARIABLE_STORE_HEADER  *VariableBuffer,
+  IN UINTN                  WriteOffset,
+  IN UINTN                  WriteSize
   );
 
 /**
@@ -691,6 +730,7 @@ extern BOOLEAN                     mEndOfDxe;
 extern VAR_CHECK_REQUEST_SOURCE    mRequestSource;
 
 extern AUTH_VAR_LIB_CONTEXT_OUT  mAuthContextOut;
+extern VARIABLE_STORE_INDEX      mVariableStoreIndex[VariableStoreTypeMax];
 
 /**
   Finds variable in storage blocks of volatile and non-volatile storage areas.
@@ -266,6 +266,12 @@ VariableClassAddressChangeEvent (
   EfiConvertPointer (0x0, (VOID **)&mNvVariableCache);
   EfiConvertPointer (0x0, (VOID **)&mNvFvHeaderCache);
 
+  for (Index = 0; Index < VariableStoreTypeMax; Index++) {
+    EfiConvertPointer (0x0, (VOID **)&mVariableStoreIndex[Index].Store);
+    EfiConvertPointer (0x0, (VOID **)&mVariableStoreIndex[Index].Entries);
+    EfiConvertPointer (0x0, (VOID **)&mVariableStoreIndex[Index].Buckets);
+  }
+
   if (mAuthContextOut.AddressPointer != NULL) {
     for (Index = 0; Index < mAuthContextOut.AddressPointerCount; Index++) {
       EfiConvertPointer (0x0, (VOID **)mAuthContextOut.AddressPointer[Index]);
@@ -338,6 +338,10 @@ InitNonVolatileVariableStore (
       mVariableModuleGlobal->CommonVariableTotalSize += VariableSize;
     }
 
+    if (Variable->State != VAR_ADDED) {
+      mVariableModuleGlobal->NonVolatileDeletedVariableSize += VariableSize;
+    }
+
     Variable = NextVariable;
   }
 
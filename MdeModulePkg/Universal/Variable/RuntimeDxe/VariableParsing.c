@@ -9,6 +9,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "VariableParsing.h"
 
+//
+// Hash indexes of the variable stores searched by FindVariableEx(). An index
+// is only used for a store attached to it by the variable driver owning the
+// store, see RefreshVariableStoreIndex().
+//
+VARIABLE_STORE_INDEX  mVariableStoreIndex[VariableStoreTypeMax];
+
 /**
 
   This code checks if variable header is valid or not.
@@ -445,6 +452,389 @@ VariableCompareTimeStampInternal (
   return (BOOLEAN)(FirstTime->Second <= SecondTime->Second);
 }
 
+/**
+  Compute the index hash of a variable name and vendor GUID.
+
+  The name is hashed up to its first null character, and at most NameSize
+  bytes of it are read.
+
+  @param[in] Name         Pointer to the variable name.
+  @param[in] NameSize     Maximum size of the name in bytes.
+  @param[in] Guid         Pointer to the vendor GUID.
+
+  @return The hash value.
+
+**/
+STATIC
+UINT32
+VariableStoreIndexHash (
+  IN CONST UINT8     *Name,
+  IN UINTN           NameSize,
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  UINT32  Hash;
+  UINTN   Index;
+
+  //
+  // 32-bit FNV-1a
+  //
+  Hash = 0x811C9DC5;
+  for (Index = 0; Index + 1 < NameSize; Index += sizeof (CHAR16)) {
+    if ((Name[Index] == 0) && (Name[Index + 1] == 0)) {
+      break;
+    }
+
+    Hash = (Hash ^ Name[Index]) * 0x01000193;
+    Hash = (Hash ^ Name[Index + 1]) * 0x01000193;
+  }
+
+  for (Index = 0; Index < sizeof (EFI_GUID); Index++) {
+    Hash = (Hash ^ ((CONST UINT8 *)Guid)[Index]) * 0x01000193;
+  }
+
+  return Hash;
+}
+
+/**
+  Drop all the entries of a variable store index, so the store is indexed
+  again from its start by the next lookup.
+
+  @param[in, out] StoreIndex   The variable store index.
+
+**/
+VOID
+ResetVariableStoreIndex (
+  IN OUT VARIABLE_STORE_INDEX  *StoreIndex
+  )
+{
+  StoreIndex->EntryCount    = 0;
+  StoreIndex->FreeEntry     = VARIABLE_STORE_INDEX_NIL;
+  StoreIndex->IndexedOffset = 0;
+  if (StoreIndex->Buckets != NULL) {
+    SetMem32 (StoreIndex->Buckets, (StoreIndex->BucketMask + 1) * sizeof (UINT32), VARIABLE_STORE_INDEX_NIL);
+  }
+}
+
+/**
+  Replace the entry and bucket arrays of a variable store index with larger
+  ones, and reset the index.
+
+  @param[in, out] StoreIndex   The variable store index.
+  @param[in]      MaxEntries   The number of entries of the new arrays.
+
+  @retval TRUE                 The index was resized.
+  @retval FALSE                Out of resources, the index is unchanged.
+
+**/
+BOOLEAN
+GrowVariableStoreIndex (
+  IN OUT VARIABLE_STORE_INDEX  *StoreIndex,
+  IN     UINT32                MaxEntries
+  )
+{
+  VARIABLE_STORE_INDEX_ENTRY  *Entries;
+  UINT32                      BucketCount;
+
+  //
+  // Keep the load factor of the hash table at or below one.
+  //
+  BucketCount = (UINT32)GetPowerOfTwo32 (MaxEntries);
+  if (BucketCount < MaxEntries) {
+    BucketCount <<= 1;
+  }
+
+  Entries = AllocateRuntimePool (MaxEntries * sizeof (VARIABLE_STORE_INDEX_ENTRY) + BucketCount * sizeof (UINT32));
+  if (Entries == NULL) {
+    return FALSE;
+  }
+
+  if (StoreIndex->Entries != NULL) {
+    FreePool (StoreIndex->Entries);
+  }
+
+  StoreIndex->Entries    = Entries;
+  StoreIndex->Buckets    = (UINT32 *)(Entries + MaxEntries);
+  StoreIndex->BucketMask = BucketCount - 1;
+  StoreIndex->MaxEntries = MaxEntries;
+  ResetVariableStoreIndex (StoreIndex);
+  return TRUE;
+}
+
+/**
+  Index the variables appended to a variable store since its last lookup.
+
+  If the index runs out of entries at runtime, the remaining variables are
+  left to the linear search done by FindVariableInStoreIndex().
+
+  @param[in, out] StoreIndex   The variable store index.
+
+**/
+STATIC
+VOID
+CatchUpVariableStoreIndex (
+  IN OUT VARIABLE_STORE_INDEX  *StoreIndex
+  )
+{
+  VARIABLE_HEADER             *StartPtr;
+  VARIABLE_HEADER             *EndPtr;
+  VARIABLE_HEADER             *Variable;
+  VARIABLE_HEADER             *NextVariable;
+  VARIABLE_STORE_INDEX_ENTRY  *Entry;
+  UINT32                      EntryIndex;
+  UINT32                      Hash;
+
+  StartPtr = GetStartPointer (StoreIndex->Store);
+  EndPtr   = GetEndPointer (StoreIndex->Store);
+  Variable = (VARIABLE_HEADER *)((UINTN)StartPtr + StoreIndex->IndexedOffset);
+
+  while (IsValidVariableHeader (Variable, EndPtr)) {
+    NextVariable = GetNextVariablePtr (Variable, StoreIndex->AuthFormat);
+
+    //
+    // The name of the last variable may not be written yet.
+    //
+    if ((Variable->State == VAR_HEADER_VALID_ONLY) && !IsValidVariableHeader (NextVariable, EndPtr)) {
+      break;
+    }
+
+    //
+    // Deleted variables are never found, don't index them.
+    //
+    if ((Variable->State & (UINT8)(~VAR_DELETED)) != 0) {
+      if (StoreIndex->FreeEntry != VARIABLE_STORE_INDEX_NIL) {
+        EntryIndex            = StoreIndex->FreeEntry;
+        StoreIndex->FreeEntry = StoreIndex->Entries[EntryIndex].Next;
+      } else if (StoreIndex->EntryCount < StoreIndex->MaxEntries) {
+        EntryIndex = StoreIndex->EntryCount++;
+      } else {
+        if (AtRuntime () || !GrowVariableStoreIndex (StoreIndex, StoreIndex->MaxEntries * 2)) {
+          break;
+        }
+
+        Variable = StartPtr;
+        continue;
+      }
+
+      Hash = VariableStoreIndexHash (
+               (UINT8 *)GetVariableNamePtr (Variable, StoreIndex->AuthFormat),
+               NameSizeOfVariable (Variable, StoreIndex->AuthFormat),
+               GetVendorGuidPtr (Variable, StoreIndex->AuthFormat)
+               );
+      Entry                                               = &StoreIndex->Entries[EntryIndex];
+      Entry->Offset                                       = (UINT32)((UINTN)Variable - (UINTN)StartPtr);
+      Entry->Hash                                         = Hash;
+      Entry->Next                                         = StoreIndex->Buckets[Hash & StoreIndex->BucketMask];
+      StoreIndex->Buckets[Hash & StoreIndex->BucketMask] = EntryIndex;
+    }
+
+    StoreIndex->IndexedOffset = (UINT32)((UINTN)NextVariable - (UINTN)StartPtr);
+    Variable                  = NextVariable;
+  }
+}
+
+/**
+  Check whether a variable is an added or in deleted transition variable with
+  the specified name and GUID, which can be accessed in the current phase.
+
+  @param[in] Variable           Pointer to the variable header.
+  @param[in] VariableName       Name of the variable to be found.
+  @param[in] VendorGuid         Vendor GUID to be found.
+  @param[in] IgnoreRtCheck      Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute
+                                check at runtime.
+  @param[in] AuthFormat         TRUE indicates authenticated variables are used.
+                                FALSE indicates authenticated variables are not used.
+
+  @retval TRUE                  The variable matches.
+  @retval FALSE                 The variable does not match.
+
+**/
+STATIC
+BOOLEAN
+IsMatchingVariable (
+  IN VARIABLE_HEADER  *Variable,
+  IN CHAR16           *VariableName,
+  IN EFI_GUID         *VendorGuid,
+  IN BOOLEAN          IgnoreRtCheck,
+  IN BOOLEAN          AuthFormat
+  )
+{
+  if ((Variable->State != VAR_ADDED) && (Variable->State != (VAR_IN_DELETED_TRANSITION & VAR_ADDED))) {
+    return FALSE;
+  }
+
+  if (!IgnoreRtCheck && AtRuntime () && ((Variable->Attributes & EFI_VARIABLE_RUNTIME_ACCESS) == 0)) {
+    return FALSE;
+  }
+
+  if (!CompareGuid (VendorGuid, GetVendorGuidPtr (Variable, AuthFormat))) {
+    return FALSE;
+  }
+
+  ASSERT (NameSizeOfVariable (Variable, AuthFormat) != 0);
+  return (BOOLEAN)(CompareMem (
+                     VariableName,
+                     GetVariableNamePtr (Variable, AuthFormat),
+                     NameSizeOfVariable (Variable, AuthFormat)
+                     ) == 0);
+}
+
+/**
+  Find the variable index attached to the store searched by PtrTrack.
+
+  @param[in] PtrTrack           Variable Track Pointer structure.
+  @param[in] AuthFormat         TRUE indicates authenticated variables are used.
+                                FALSE indicates authenticated variables are not used.
+
+  @return The variable store index, or NULL if the store has none.
+
+**/
+STATIC
+VARIABLE_STORE_INDEX *
+GetVariableStoreIndex (
+  IN VARIABLE_POINTER_TRACK  *PtrTrack,
+  IN BOOLEAN                 AuthFormat
+  )
+{
+  VARIABLE_STORE_TYPE  Type;
+
+  for (Type = (VARIABLE_STORE_TYPE)0; Type < VariableStoreTypeMax; Type++) {
+    if ((mVariableStoreIndex[Type].Store != NULL) &&
+        (mVariableStoreIndex[Type].Entries != NULL) &&
+        (mVariableStoreIndex[Type].AuthFormat == AuthFormat) &&
+        (GetStartPointer (mVariableStoreIndex[Type].Store) == PtrTrack->StartPtr) &&
+        (GetEndPointer (mVariableStoreIndex[Type].Store) == PtrTrack->EndPtr))
+    {
+      return &mVariableStoreIndex[Type];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Find a variable through the index of its store, with the same result as the
+  linear search of FindVariableEx().
+
+  @param[in, out]  StoreIndex          The index of the store searched by PtrTrack.
+  @param[in]       VariableName        Name of the variable to be found, not empty.
+  @param[in]       VendorGuid          Vendor GUID to be found.
+  @param[in]       IgnoreRtCheck       Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute
+                                       check at runtime when searching variable.
+  @param[in, out]  PtrTrack            Variable Track Pointer structure that contains Variable Information.
+
+  @retval          EFI_SUCCESS         Variable found successfully
+  @retval          EFI_NOT_FOUND       Variable not found
+**/
+STATIC
+EFI_STATUS
+FindVariableInStoreIndex (
+  IN OUT VARIABLE_STORE_INDEX    *StoreIndex,
+  IN     CHAR16                  *VariableName,
+  IN     EFI_GUID                *VendorGuid,
+  IN     BOOLEAN                 IgnoreRtCheck,
+  IN OUT VARIABLE_POINTER_TRACK  *PtrTrack
+  )
+{
+  VARIABLE_HEADER             *Variable;
+  VARIABLE_HEADER             *AddedVariable;
+  VARIABLE_HEADER             *InDeletedVariable;
+  VARIABLE_STORE_INDEX_ENTRY  *Entry;
+  UINT32                      *Link;
+  UINT32                      EntryIndex;
+  UINT32                      Hash;
+  BOOLEAN                     AuthFormat;
+
+  CatchUpVariableStoreIndex (StoreIndex);
+
+  AuthFormat = StoreIndex->AuthFormat;
+  Hash       = VariableStoreIndexHash ((UINT8 *)VariableName, MAX_UINTN, VendorGuid);
+
+  //
+  // The linear search returns the first added variable, along with the last
+  // in deleted transition variable in front of it. Entries are not chained in
+  // store order, so pick the added variable with the lowest address first.
+  //
+  AddedVariable     = NULL;
+  InDeletedVariable = NULL;
+  Link              = &StoreIndex->Buckets[Hash & StoreIndex->BucketMask];
+  while (*Link != VARIABLE_STORE_INDEX_NIL) {
+    EntryIndex = *Link;
+    Entry      = &StoreIndex->Entries[EntryIndex];
+    Variable   = (VARIABLE_HEADER *)((UINTN)PtrTrack->StartPtr + Entry->Offset);
+
+    if ((Variable->State & (UINT8)(~VAR_DELETED)) == 0) {
+      //
+      // Deleted variables never come back, drop them from the index.
+      //
+      *Link                 = Entry->Next;
+      Entry->Next           = StoreIndex->FreeEntry;
+      StoreIndex->FreeEntry = EntryIndex;
+      continue;
+    }
+
+    if ((Entry->Hash == Hash) && IsMatchingVariable (Variable, VariableName, VendorGuid, IgnoreRtCheck, AuthFormat)) {
+      if (Variable->State == VAR_ADDED) {
+        if ((AddedVariable == NULL) || (Variable < AddedVariable)) {
+          AddedVariable = Variable;
+        }
+      } else {
+        InDeletedVariable = Variable;
+      }
+    }
+
+    Link = &Entry->Next;
+  }
+
+  if (InDeletedVariable != NULL) {
+    InDeletedVariable = NULL;
+    for (EntryIndex = StoreIndex->Buckets[Hash & StoreIndex->BucketMask];
+         EntryIndex != VARIABLE_STORE_INDEX_NIL;
+         EntryIndex = Entry->Next)
+    {
+      Entry    = &StoreIndex->Entries[EntryIndex];
+      Variable = (VARIABLE_HEADER *)((UINTN)PtrTrack->StartPtr + Entry->Offset);
+      if ((Entry->Hash == Hash) &&
+          (Variable->State == (VAR_IN_DELETED_TRANSITION & VAR_ADDED)) &&
+          ((AddedVariable == NULL) || (Variable < AddedVariable)) &&
+          ((InDeletedVariable == NULL) || (Variable > InDeletedVariable)) &&
+          IsMatchingVariable (Variable, VariableName, VendorGuid, IgnoreRtCheck, AuthFormat))
+      {
+        InDeletedVariable = Variable;
+      }
+    }
+  }
+
+  //
+  // Search the variables the index could not take linearly.
+  //
+  if (AddedVariable == NULL) {
+    for ( Variable = (VARIABLE_HEADER *)((UINTN)PtrTrack->StartPtr + StoreIndex->IndexedOffset)
+          ; IsValidVariableHeader (Variable, PtrTrack->EndPtr)
+          ; Variable = GetNextVariablePtr (Variable, AuthFormat)
+          )
+    {
+      if (IsMatchingVariable (Variable, VariableName, VendorGuid, IgnoreRtCheck, AuthFormat)) {
+        if (Variable->State == VAR_ADDED) {
+          AddedVariable = Variable;
+          break;
+        }
+
+        InDeletedVariable = Variable;
+      }
+    }
+  }
+
+  if (AddedVariable != NULL) {
+    PtrTrack->CurrPtr                = AddedVariable;
+    PtrTrack->InDeletedTransitionPtr = InDeletedVariable;
+    return EFI_SUCCESS;
+  }
+
+  PtrTrack->CurrPtr = InDeletedVariable;
+  return (PtrTrack->CurrPtr == NULL) ? EFI_NOT_FOUND : EFI_SUCCESS;
+}
+
 /**
   Find the variable in the specified variable store.
 
@@ -468,11 +858,19 @@ FindVariableEx (
   IN     BOOLEAN                 AuthFormat
   )
 {
-  VARIABLE_HEADER  *InDeletedVariable;
-  VOID             *Point;
+  VARIABLE_HEADER       *InDeletedVariable;
+  VOID                  *Point;
+  VARIABLE_STORE_INDEX  *StoreIndex;
 
   PtrTrack->InDeletedTransitionPtr = NULL;
 
+  if (VariableName[0] != 0) {
+    StoreIndex = GetVariableStoreIndex (PtrTrack, AuthFormat);
+    if (StoreIndex != NULL) {
+      return FindVariableInStoreIndex (StoreIndex, VariableName, VendorGuid, IgnoreRtCheck, PtrTrack);
+    }
+  }
+
   //
   // Find the variable by walk through HOB, volatile and non-volatile variable store.
   //
@@ -704,6 +1102,57 @@ Done:
   return Status;
 }
 
+/**
+  Get the range of a non-volatile variable store that a reclaim has to write.
+
+  The variables in front of the first one that is deleted, in deleted
+  transition or replaced keep their offset in the compacted store, and the
+  store past the used areas of the old and of the compacted store stays
+  erased. Only the bytes in between differ.
+
+  @param[in]  VariableStoreHeader  The variable store before the reclaim.
+  @param[in]  UpdatingVariable     The variable replaced by the reclaim, or NULL.
+  @param[in]  NewUsedSize          Size of the used area of the compacted store,
+                                   including the store header.
+  @param[in]  AuthFormat           TRUE indicates authenticated variables are used.
+                                   FALSE indicates authenticated variables are not used.
+  @param[out] WriteOffset          Offset in the store of the first byte to write.
+  @param[out] WriteEnd             Offset in the store following the last byte
+                                   to write, WriteOffset if nothing changes.
+
+**/
+VOID
+GetReclaimWriteRange (
+  IN  VARIABLE_STORE_HEADER  *VariableStoreHeader,
+  IN  VARIABLE_HEADER        *UpdatingVariable OPTIONAL,
+  IN  UINTN                  NewUsedSize,
+  IN  BOOLEAN                AuthFormat,
+  OUT UINTN                  *WriteOffset,
+  OUT UINTN                  *WriteEnd
+  )
+{
+  VARIABLE_HEADER  *Variable;
+  UINTN            End;
+
+  Variable = GetStartPointer (VariableStoreHeader);
+  while (IsValidVariableHeader (Variable, GetEndPointer (VariableStoreHeader)) &&
+         (Variable != UpdatingVariable) && (Variable->State == VAR_ADDED))
+  {
+    Variable = GetNextVariablePtr (Variable, AuthFormat);
+  }
+
+  *WriteOffset = (UINTN)Variable - (UINTN)VariableStoreHeader;
+
+  End = VariableStoreHeader->Size;
+  while ((End > MAX (NewUsedSize, *WriteOffset)) &&
+         (((UINT8 *)VariableStoreHeader)[End - 1] == 0xff))
+  {
+    End--;
+  }
+
+  *WriteEnd = End;
+}
+
 /**
   Routine used to track statistical information about variable usage.
   The data is stored in the EFI system table so it can be accessed later.
@@ -257,6 +257,35 @@ VariableCompareTimeStampInternal (
   IN EFI_TIME  *SecondTime
   );
 
+/**
+  Drop all the entries of a variable store index, so the store is indexed
+  again from its start by the next lookup.
+
+  @param[in, out] StoreIndex   The variable store index.
+
+**/
+VOID
+ResetVariableStoreIndex (
+  IN OUT VARIABLE_STORE_INDEX  *StoreIndex
+  );
+
+/**
+  Replace the entry and bucket arrays of a variable store index with larger
+  ones, and reset the index.
+
+  @param[in, out] StoreIndex   The variable store index.
+  @param[in]      MaxEntries   The number of entries of the new arrays.
+
+  @retval TRUE                 The index was resized.
+  @retval FALSE                Out of resources, the index is unchanged.
+
+**/
+BOOLEAN
+GrowVariableStoreIndex (
+  IN OUT VARIABLE_STORE_INDEX  *StoreIndex,
+  IN     UINT32                MaxEntries
+  );
+
 /**
   Find the variable in the specified variable store.
 
@@ -311,6 +340,35 @@ VariableServiceGetNextVariableInternal (
   IN  BOOLEAN                AuthFormat
   );
 
+/**
+  Get the range of a non-volatile variable store that a reclaim has to write.
+
+  The variables in front of the first one that is deleted, in deleted
+  transition or replaced keep their offset in the compacted store, and the
+  store past the used areas of the old and of the compacted store stays
+  erased. Only the bytes in between differ.
+
+  @param[in]  VariableStoreHeader  The variable store before the reclaim.
+  @param[in]  UpdatingVariable     The variable replaced by the reclaim, or NULL.
+  @param[in]  NewUsedSize          Size of the used area of the compacted store,
+                                   including the store header.
+  @param[in]  AuthFormat           TRUE indicates authenticated variables are used.
+                                   FALSE indicates authenticated variables are not used.
+  @param[out] WriteOffset          Offset in the store of the first byte to write.
+  @param[out] WriteEnd             Offset in the store following the last byte
+                                   to write, WriteOffset if nothing changes.
+
+**/
+VOID
+GetReclaimWriteRange (
+  IN  VARIABLE_STORE_HEADER  *VariableStoreHeader,
+  IN  VARIABLE_HEADER        *UpdatingVariable OPTIONAL,
+  IN  UINTN                  NewUsedSize,
+  IN  BOOLEAN                AuthFormat,
+  OUT UINTN                  *WriteOffset,
+  OUT UINTN                  *WriteEnd
+  );
+
 /**
   Routine used to track statistical information about variable usage.
   The data is stored in the EFI system table so it can be accessed later.
@@ -156,3 +156,66 @@ SynchronizeRuntimeVariableCache (
 
   return EFI_SUCCESS;
 }
+
+/**
+  Attach the variable store indexes to the variable stores searched by the
+  variable services.
+
+  A store replaced by another one gets its index reset. Stores are only
+  attached at boot time, unless the index memory was allocated before.
+
+  @param[in] VariableStoreList  The variable stores, indexed by VARIABLE_STORE_TYPE.
+                                NULL entries detach the corresponding index.
+  @param[in] AuthFormat         TRUE indicates authenticated variables are used.
+                                FALSE indicates authenticated variables are not used.
+
+**/
+VOID
+RefreshVariableStoreIndex (
+  IN VARIABLE_STORE_HEADER  **VariableStoreList,
+  IN BOOLEAN                AuthFormat
+  )
+{
+  VARIABLE_STORE_TYPE   Type;
+  VARIABLE_STORE_INDEX  *StoreIndex;
+
+  for (Type = (VARIABLE_STORE_TYPE)0; Type < VariableStoreTypeMax; Type++) {
+    StoreIndex = &mVariableStoreIndex[Type];
+    if ((StoreIndex->Store == VariableStoreList[Type]) && (StoreIndex->AuthFormat == AuthFormat)) {
+      continue;
+    }
+
+    StoreIndex->Store      = VariableStoreList[Type];
+    StoreIndex->AuthFormat = AuthFormat;
+    if (StoreIndex->Store == NULL) {
+      continue;
+    }
+
+    if (StoreIndex->Entries == NULL) {
+      if (AtRuntime () || !GrowVariableStoreIndex (StoreIndex, VARIABLE_STORE_INDEX_MIN_ENTRIES)) {
+        StoreIndex->Store = NULL;
+      }
+
+      continue;
+    }
+
+    ResetVariableStoreIndex (StoreIndex);
+  }
+}
+
+/**
+  Reset the variable store indexes after the variables of a store have been
+  moved, such as by Reclaim().
+
+**/
+VOID
+InvalidateVariableStoreIndex (
+  VOID
+  )
+{
+  VARIABLE_STORE_TYPE  Type;
+
+  for (Type = (VARIABLE_STORE_TYPE)0; Type < VariableStoreTypeMax; Type++) {
+    ResetVariableStoreIndex (&mVariableStoreIndex[Type]);
+  }
+}
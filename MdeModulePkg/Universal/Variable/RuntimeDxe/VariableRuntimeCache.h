@@ -48,4 +48,33 @@ SynchronizeRuntimeVariableCache (
   IN  UINTN                   Length
   );
 
+/**
+  Attach the variable store indexes to the variable stores searched by the
+  variable services.
+
+  A store replaced by another one gets its index reset. Stores are only
+  attached at boot time, unless the index memory was allocated before.
+
+  @param[in] VariableStoreList  The variable stores, indexed by VARIABLE_STORE_TYPE.
+                                NULL entries detach the corresponding index.
+  @param[in] AuthFormat         TRUE indicates authenticated variables are used.
+                                FALSE indicates authenticated variables are not used.
+
+**/
+VOID
+RefreshVariableStoreIndex (
+  IN VARIABLE_STORE_HEADER  **VariableStoreList,
+  IN BOOLEAN                AuthFormat
+  );
+
+/**
+  Reset the variable store indexes after the variables of a store have been
+  moved, such as by Reclaim().
+
+**/
+VOID
+InvalidateVariableStoreIndex (
+  VOID
+  );
+
 #endif
@@ -227,6 +227,27 @@
 ///
 #define HTTP_HEADER_ETAG  "ETag"
 
+///
+/// Range Request Header
+/// The Range request-header field asks the server to send only part of the
+/// entity, as one or more byte ranges.
+/// Example:     Range: bytes=0-1023
+///
+#define HTTP_HEADER_RANGE  "Range"
+
+///
+/// Content-Range Response Header
+/// The Content-Range entity-header field is sent with a partial entity-body
+/// to specify where in the full entity-body the partial body belongs.
+/// Example:     Content-Range: bytes 0-1023/4096
+///
+#define HTTP_HEADER_CONTENT_RANGE  "Content-Range"
+
+///
+/// The byte range unit, for the Accept-Ranges, Range and Content-Range headers.
+///
+#define HTTP_RANGE_UNIT_BYTES  "bytes"
+
 ///
 /// Custom header field checked by the iLO web server to
 /// specify a client session key.
@@ -796,8 +796,8 @@ typedef struct {
   //
   UINT8           Opc;       // Opcode
   UINT8           Fuse  : 2; // Fused Operation
-  UINT8           Rsvd1 : 5;
-  UINT8           Psdt  : 1; // PRP or SGL for Data Transfer
+  UINT8           Rsvd1 : 4;
+  UINT8           Psdt  : 2; // PRP or SGL for Data Transfer
   UINT16          Cid;       // Command Identifier
 
   //
@@ -822,6 +822,9 @@ typedef struct {
 
   NVME_PAYLOAD    Payload;
 } NVME_SQ;
+#define NVME_SQ_PSDT_PRP              0
+#define NVME_SQ_PSDT_SGL_MPTR_BUFFER  1 // SGL, MPTR is a contiguous buffer
+#define NVME_SQ_PSDT_SGL_MPTR_SGL     2 // SGL, MPTR is an SGL segment
 
 //
 // Completion Queue
@@ -0,0 +1,151 @@
+/** @file
+  CRC32 and CRC32c with the ARMv8 CRC32 instructions.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "BaseLibInternals.h"
+
+//
+// The CRC32 field of ID_AA64ISAR0_EL1.
+//
+#define ID_AA64ISAR0_CRC32_SHIFT  16
+#define ID_AA64ISAR0_CRC32_MASK   0xF
+
+//
+// Reading the ID register costs little, but short buffers are left to the
+// table driven code, which is as fast for them.
+//
+#define CRC_ACCELERATED_MIN_LENGTH  64
+
+/**
+  Reads the ID_AA64ISAR0 register.
+
+  @return The contents of the ID_AA64ISAR0 register.
+
+**/
+UINT64
+EFIAPI
+InternalArmReadIdAa64Isar0 (
+  VOID
+  );
+
+/**
+  Updates a CRC32 (ITU-T V.42) over a buffer with the CRC32X and CRC32B
+  instructions.
+
+  @param[in]  Crc     The CRC to update, without the initial and final inversion.
+  @param[in]  Buffer  The pointer to the buffer.
+  @param[in]  Length  The number of bytes in the buffer.
+
+  @return The updated CRC.
+
+**/
+UINT32
+EFIAPI
+InternalCrc32Armv8 (
+  IN UINT32       Crc,
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  );
+
+/**
+  Updates a CRC32c over a buffer with the CRC32CX and CRC32CB instructions.
+
+  @param[in]  Crc     The CRC to update, without the initial and final inversion.
+  @param[in]  Buffer  The pointer to the buffer.
+  @param[in]  Length  The number of bytes in the buffer.
+
+  @return The updated CRC.
+
+**/
+UINT32
+EFIAPI
+InternalCrc32cArmv8 (
+  IN UINT32       Crc,
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  );
+
+/**
+  Checks whether the CPU implements the CRC32 instructions.
+
+  @retval TRUE   The CRC32 instructions are implemented.
+  @retval FALSE  The CRC32 instructions are not implemented.
+
+**/
+STATIC
+BOOLEAN
+InternalHasCrc32Instructions (
+  VOID
+  )
+{
+  return (BOOLEAN)(((InternalArmReadIdAa64Isar0 () >> ID_AA64ISAR0_CRC32_SHIFT) &
+                    ID_AA64ISAR0_CRC32_MASK) != 0);
+}
+
+/**
+  Updates a CRC32 (ITU-T V.42) over the start of a buffer with CPU specific
+  instructions, if the CPU supports them.
+
+  The CRC is passed and returned without the initial and final inversion.
+
+  @param[in]       Buffer  The pointer to the buffer.
+  @param[in]       Length  The number of bytes in the buffer.
+  @param[in, out]  Crc     The CRC to update.
+
+  @return The number of bytes at the start of the buffer that were processed.
+          The caller processes the remaining bytes. Zero is returned if the
+          CPU does not support the instructions or the buffer is too short to
+          benefit from them.
+
+**/
+UINTN
+EFIAPI
+InternalCrc32Accelerated (
+  IN     CONST UINT8  *Buffer,
+  IN     UINTN        Length,
+  IN OUT UINT32       *Crc
+  )
+{
+  if ((Length < CRC_ACCELERATED_MIN_LENGTH) || !InternalHasCrc32Instructions ()) {
+    return 0;
+  }
+
+  *Crc = InternalCrc32Armv8 (*Crc, Buffer, Length);
+  return Length;
+}
+
+/**
+  Updates a CRC32c over the start of a buffer with CPU specific instructions,
+  if the CPU supports them.
+
+  The CRC is passed and returned without the initial and final inversion.
+
+  @param[in]       Buffer  The pointer to the buffer.
+  @param[in]       Length  The number of bytes in the buffer.
+  @param[in, out]  Crc     The CRC to update.
+
+  @return The number of bytes at the start of the buffer that were processed.
+          The caller processes the remaining bytes. Zero is returned if the
+          CPU does not support the instructions or the buffer is too short to
+          benefit from them.
+
+**/
+UINTN
+EFIAPI
+InternalCrc32cAccelerated (
+  IN     CONST UINT8  *Buffer,
+  IN     UINTN        Length,
+  IN OUT UINT32       *Crc
+  )
+{
+  if ((Length < CRC_ACCELERATED_MIN_LENGTH) || !InternalHasCrc32Instructions ()) {
+    return 0;
+  }
+
+  *Crc = InternalCrc32cArmv8 (*Crc, Buffer, Length);
+  return Length;
+}
@@ -0,0 +1,117 @@
+;------------------------------------------------------------------------------
+;
+; CRC32 and CRC32c with the ARMv8 CRC32 instructions.
+;
+; Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+;
+; SPDX-License-Identifier: BSD-2-Clause-Patent
+;
+;------------------------------------------------------------------------------
+
+  EXPORT InternalArmReadIdAa64Isar0
+  EXPORT InternalCrc32Armv8
+  EXPORT InternalCrc32cArmv8
+  AREA BaseLib_LowLevel, CODE, READONLY
+
+;/**
+;  Reads the ID_AA64ISAR0 register.
+;
+;  @return The contents of the ID_AA64ISAR0 register.
+;
+;**/
+;UINT64
+;EFIAPI
+;InternalArmReadIdAa64Isar0 (
+;  VOID
+;  );
+;
+InternalArmReadIdAa64Isar0
+    mrs     x0, id_aa64isar0_el1
+    ret
+
+;/**
+;  Updates a CRC32 (ITU-T V.42) over a buffer with the CRC32X and CRC32B
+;  instructions.
+;
+;  The bytes up to an eight byte boundary are processed one at a time, so that
+;  no load is unaligned.
+;
+;**/
+;UINT32
+;EFIAPI
+;InternalCrc32Armv8 (
+;  IN UINT32       Crc,
+;  IN CONST UINT8  *Buffer,
+;  IN UINTN        Length
+;  );
+;
+InternalCrc32Armv8
+    cbz     x2, InternalCrc32Armv8Done
+    tst     x1, #7
+    beq     InternalCrc32Armv8Words
+    ldrb    w3, [x1], #1
+    crc32b  w0, w0, w3
+    sub     x2, x2, #1
+    b       InternalCrc32Armv8
+
+InternalCrc32Armv8Words
+    cmp     x2, #8
+    blo     InternalCrc32Armv8Tail
+    ldr     x3, [x1], #8
+    crc32x  w0, w0, x3
+    sub     x2, x2, #8
+    b       InternalCrc32Armv8Words
+
+InternalCrc32Armv8Tail
+    cbz     x2, InternalCrc32Armv8Done
+    ldrb    w3, [x1], #1
+    crc32b  w0, w0, w3
+    sub     x2, x2, #1
+    b       InternalCrc32Armv8Tail
+
+InternalCrc32Armv8Done
+    ret
+
+;/**
+;  Updates a CRC32c over a buffer with the CRC32CX and CRC32CB instructions.
+;
+;  The bytes up to an eight byte boundary are processed one at a time, so that
+;  no load is unaligned.
+;
+;**/
+;UINT32
+;EFIAPI
+;InternalCrc32cArmv8 (
+;  IN UINT32       Crc,
+;  IN CONST UINT8  *Buffer,
+;  IN UINTN        Length
+;  );
+;
+InternalCrc32cArmv8
+    cbz     x2, InternalCrc32cArmv8Done
+    tst     x1, #7
+    beq     InternalCrc32cArmv8Words
+    ldrb    w3, [x1], #1
+    crc32cb w0, w0, w3
+    sub     x2, x2, #1
+    b       InternalCrc32cArmv8
+
+InternalCrc32cArmv8Words
+    cmp     x2, #8
+    blo     InternalCrc32cArmv8Tail
+    ldr     x3, [x1], #8
+    crc32cx w0, w0, x3
+    sub     x2, x2, #8
+    b       InternalCrc32cArmv8Words
+
+InternalCrc32cArmv8Tail
+    cbz     x2, InternalCrc32cArmv8Done
+    ldrb    w3, [x1], #1
+    crc32cb w0, w0, w3
+    sub     x2, x2, #1
+    b       InternalCrc32cArmv8Tail
+
+InternalCrc32cArmv8Done
+    ret
+
+  END
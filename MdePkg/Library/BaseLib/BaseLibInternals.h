@@ -553,6 +553,58 @@ InternalAsciiHexCharToUintn (
   IN      CHAR8  Char
   );
 
+//
+// CRC functions
+//
+
+/**
+  Updates a CRC32 (ITU-T V.42) over the start of a buffer with CPU specific
+  instructions, if the CPU supports them.
+
+  The CRC is passed and returned without the initial and final inversion.
+
+  @param[in]       Buffer  The pointer to the buffer.
+  @param[in]       Length  The number of bytes in the buffer.
+  @param[in, out]  Crc     The CRC to update.
+
+  @return The number of bytes at the start of the buffer that were processed.
+          The caller processes the remaining bytes. Zero is returned if the
+          CPU does not support the instructions or the buffer is too short to
+          benefit from them.
+
+**/
+UINTN
+EFIAPI
+InternalCrc32Accelerated (
+  IN     CONST UINT8  *Buffer,
+  IN     UINTN        Length,
+  IN OUT UINT32       *Crc
+  );
+
+/**
+  Updates a CRC32c over the start of a buffer with CPU specific instructions,
+  if the CPU supports them.
+
+  The CRC is passed and returned without the initial and final inversion.
+
+  @param[in]       Buffer  The pointer to the buffer.
+  @param[in]       Length  The number of bytes in the buffer.
+  @param[in, out]  Crc     The CRC to update.
+
+  @return The number of bytes at the start of the buffer that were processed.
+          The caller processes the remaining bytes. Zero is returned if the
+          CPU does not support the instructions or the buffer is too short to
+          benefit from them.
+
+**/
+UINTN
+EFIAPI
+InternalCrc32cAccelerated (
+  IN     CONST UINT8  *Buffer,
+  IN     UINTN        Length,
+  IN OUT UINT32       *Crc
+  );
+
 //
 // Ia32 and x64 specific functions
 //
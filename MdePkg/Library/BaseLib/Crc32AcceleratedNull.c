@@ -0,0 +1,57 @@
+/** @file
+  CRC32 and CRC32c for CPUs without CRC instructions.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "BaseLibInternals.h"
+
+/**
+  Updates a CRC32 (ITU-T V.42) over the start of a buffer with CPU specific
+  instructions, if the CPU supports them.
+
+  The CRC is passed and returned without the initial and final inversion.
+
+  @param[in]       Buffer  The pointer to the buffer.
+  @param[in]       Length  The number of bytes in the buffer.
+  @param[in, out]  Crc     The CRC to update.
+
+  @return Zero, the whole buffer is left to the caller.
+
+**/
+UINTN
+EFIAPI
+InternalCrc32Accelerated (
+  IN     CONST UINT8  *Buffer,
+  IN     UINTN        Length,
+  IN OUT UINT32       *Crc
+  )
+{
+  return 0;
+}
+
+/**
+  Updates a CRC32c over the start of a buffer with CPU specific instructions,
+  if the CPU supports them.
+
+  The CRC is passed and returned without the initial and final inversion.
+
+  @param[in]       Buffer  The pointer to the buffer.
+  @param[in]       Length  The number of bytes in the buffer.
+  @param[in, out]  Crc     The CRC to update.
+
+  @return Zero, the whole buffer is left to the caller.
+
+**/
+UINTN
+EFIAPI
+InternalCrc32cAccelerated (
+  IN     CONST UINT8  *Buffer,
+  IN     UINTN        Length,
+  IN OUT UINT32       *Crc
+  )
+{
+  return 0;
+}
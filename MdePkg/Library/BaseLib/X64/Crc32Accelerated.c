@@ -0,0 +1,140 @@
+/** @file
+  CRC32 with the PCLMULQDQ instruction and CRC32c with the SSE4.2 CRC32
+  instruction.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "BaseLibInternals.h"
+#include <Register/Intel/Cpuid.h>
+
+//
+// The CPUID result is not cached because BaseLib may run from flash, where
+// globals cannot be written, and CPUID may trap to a hypervisor. Only buffers
+// long enough to hide the cost of CPUID use the instructions.
+//
+#define CRC_ACCELERATED_MIN_LENGTH  SIZE_4KB
+
+//
+// InternalCrc32Pclmul() processes a multiple of 16 bytes.
+//
+#define CRC32_PCLMUL_BLOCK_SIZE  16
+
+/**
+  Updates a CRC32 (ITU-T V.42) over a buffer by folding it with PCLMULQDQ.
+
+  @param[in]  Crc     The CRC to update, without the initial and final inversion.
+  @param[in]  Buffer  The pointer to the buffer.
+  @param[in]  Length  The number of bytes in the buffer. It is a multiple of 16
+                      and at least 64.
+
+  @return The updated CRC.
+
+**/
+UINT32
+EFIAPI
+InternalCrc32Pclmul (
+  IN UINT32       Crc,
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  );
+
+/**
+  Updates a CRC32c over a buffer with the SSE4.2 CRC32 instruction.
+
+  @param[in]  Crc     The CRC to update, without the initial and final inversion.
+  @param[in]  Buffer  The pointer to the buffer.
+  @param[in]  Length  The number of bytes in the buffer.
+
+  @return The updated CRC.
+
+**/
+UINT32
+EFIAPI
+InternalCrc32cSse42 (
+  IN UINT32       Crc,
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  );
+
+/**
+  Updates a CRC32 (ITU-T V.42) over the start of a buffer with CPU specific
+  instructions, if the CPU supports them.
+
+  The CRC is passed and returned without the initial and final inversion.
+
+  @param[in]       Buffer  The pointer to the buffer.
+  @param[in]       Length  The number of bytes in the buffer.
+  @param[in, out]  Crc     The CRC to update.
+
+  @return The number of bytes at the start of the buffer that were processed.
+          The caller processes the remaining bytes. Zero is returned if the
+          CPU does not support the instructions or the buffer is too short to
+          benefit from them.
+
+**/
+UINTN
+EFIAPI
+InternalCrc32Accelerated (
+  IN     CONST UINT8  *Buffer,
+  IN     UINTN        Length,
+  IN OUT UINT32       *Crc
+  )
+{
+  CPUID_VERSION_INFO_ECX  VersionInfoEcx;
+  UINTN                   Processed;
+
+  if (Length < CRC_ACCELERATED_MIN_LENGTH) {
+    return 0;
+  }
+
+  AsmCpuid (CPUID_VERSION_INFO, NULL, NULL, &VersionInfoEcx.Uint32, NULL);
+  if (VersionInfoEcx.Bits.PCLMULQDQ == 0) {
+    return 0;
+  }
+
+  Processed = Length & ~(UINTN)(CRC32_PCLMUL_BLOCK_SIZE - 1);
+  *Crc      = InternalCrc32Pclmul (*Crc, Buffer, Processed);
+  return Processed;
+}
+
+/**
+  Updates a CRC32c over the start of a buffer with CPU specific instructions,
+  if the CPU supports them.
+
+  The CRC is passed and returned without the initial and final inversion.
+
+  @param[in]       Buffer  The pointer to the buffer.
+  @param[in]       Length  The number of bytes in the buffer.
+  @param[in, out]  Crc     The CRC to update.
+
+  @return The number of bytes at the start of the buffer that were processed.
+          The caller processes the remaining bytes. Zero is returned if the
+          CPU does not support the instructions or the buffer is too short to
+          benefit from them.
+
+**/
+UINTN
+EFIAPI
+InternalCrc32cAccelerated (
+  IN     CONST UINT8  *Buffer,
+  IN     UINTN        Length,
+  IN OUT UINT32       *Crc
+  )
+{
+  CPUID_VERSION_INFO_ECX  VersionInfoEcx;
+
+  if (Length < CRC_ACCELERATED_MIN_LENGTH) {
+    return 0;
+  }
+
+  AsmCpuid (CPUID_VERSION_INFO, NULL, NULL, &VersionInfoEcx.Uint32, NULL);
+  if (VersionInfoEcx.Bits.SSE4_2 == 0) {
+    return 0;
+  }
+
+  *Crc = InternalCrc32cSse42 (*Crc, Buffer, Length);
+  return Length;
+}
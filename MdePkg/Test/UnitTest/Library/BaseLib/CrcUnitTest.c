@@ -0,0 +1,406 @@
+/** @file
+  Unit tests and benchmark of the CRC32 and CRC32c APIs in BaseLib.
+
+  The results are checked against a byte at a time table driven reference
+  for all buffer alignments and for lengths around the points where BaseLib
+  switches between its table driven code and CPU instructions.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/UnitTestBenchmarkLib.h>
+
+#define UNIT_TEST_APP_NAME     "BaseLib CRC Unit Test Application"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define CRC32_POLYNOMIAL   0xEDB88320
+#define CRC32C_POLYNOMIAL  0x82F63B78
+
+//
+// The buffer is large enough for the longest tested length at every offset.
+//
+#define TEST_MAX_OFFSET      16
+#define TEST_MAX_LENGTH      (SIZE_64KB + 37)
+#define TEST_BUFFER_SIZE     (TEST_MAX_LENGTH + TEST_MAX_OFFSET)
+#define TEST_BENCH_SIZE      SIZE_1MB
+#define TEST_BENCH_PASSES    16
+#define TEST_CHECK_VALUE     "123456789"
+
+typedef struct {
+  UINT8     *Buffer;
+  UINT32    Crc32Table[256];
+  UINT32    Crc32cTable[256];
+} CRC_TEST_CONTEXT;
+
+STATIC CRC_TEST_CONTEXT  mCrcTestContext;
+
+//
+// Lengths around the block sizes of the table driven and CPU specific code.
+//
+STATIC CONST UINTN  mTestLengths[] = {
+  0,    1,    2,    3,    4,    5,    7,    8,    9,    15,   16,   17,
+  31,   32,   33,   63,   64,   65,   79,   80,   127,  128,  129,  255,
+  256,  1000, 4095, 4096, 4097, 4103, 4111, 4112, 4127, 8191, 8192, 9000,
+  SIZE_64KB - 1, SIZE_64KB, TEST_MAX_LENGTH
+};
+
+/**
+  Build the byte table of a reflected CRC polynomial.
+
+  @param[in]   Polynomial  The reflected polynomial.
+  @param[out]  Table       The table of the CRC of each byte value.
+**/
+STATIC
+VOID
+BuildCrcTable (
+  IN  UINT32  Polynomial,
+  OUT UINT32  *Table
+  )
+{
+  UINT32  Index;
+  UINT32  Crc;
+  UINTN   Bit;
+
+  for (Index = 0; Index < 256; Index++) {
+    Crc = Index;
+    for (Bit = 0; Bit < 8; Bit++) {
+      Crc = (Crc >> 1) ^ (((Crc & 1) != 0) ? Polynomial : 0);
+    }
+
+    Table[Index] = Crc;
+  }
+}
+
+/**
+  Update a CRC over a buffer a byte at a time.
+
+  @param[in]  Table   The table of the CRC of each byte value.
+  @param[in]  Crc     The CRC to update, without the initial and final inversion.
+  @param[in]  Buffer  The buffer.
+  @param[in]  Length  The number of bytes in the buffer.
+
+  @return The updated CRC.
+**/
+STATIC
+UINT32
+ReferenceCrc (
+  IN CONST UINT32  *Table,
+  IN UINT32        Crc,
+  IN CONST UINT8   *Buffer,
+  IN UINTN         Length
+  )
+{
+  while (Length-- != 0) {
+    Crc = (Crc >> 8) ^ Table[(UINT8)Crc ^ *Buffer++];
+  }
+
+  return Crc;
+}
+
+/**
+  Allocate the test buffer and build the reference tables.
+
+  @param[in]  Context    The CRC_TEST_CONTEXT.
+
+  @retval  UNIT_TEST_PASSED                      The context is ready.
+  @retval  UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  Out of memory.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+CrcTestSetup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CRC_TEST_CONTEXT  *TestContext;
+  UINT32            Seed;
+  UINTN             Index;
+
+  TestContext         = Context;
+  TestContext->Buffer = AllocatePool (MAX (TEST_BUFFER_SIZE, TEST_BENCH_SIZE));
+  if (TestContext->Buffer == NULL) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  Seed = 0xC5C32;
+  for (Index = 0; Index < MAX (TEST_BUFFER_SIZE, TEST_BENCH_SIZE); Index++) {
+    TestContext->Buffer[Index] = (UINT8)UnitTestRandom (&Seed);
+  }
+
+  BuildCrcTable (CRC32_POLYNOMIAL, TestContext->Crc32Table);
+  BuildCrcTable (CRC32C_POLYNOMIAL, TestContext->Crc32cTable);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Free the test buffer.
+
+  @param[in]  Context    The CRC_TEST_CONTEXT.
+**/
+STATIC
+VOID
+EFIAPI
+CrcTestCleanup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CRC_TEST_CONTEXT  *TestContext;
+
+  TestContext = Context;
+  if (TestContext->Buffer != NULL) {
+    FreePool (TestContext->Buffer);
+    TestContext->Buffer = NULL;
+  }
+}
+
+/**
+  Check the CRCs of the standard check value.
+
+  @param[in]  Context    The CRC_TEST_CONTEXT.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+CheckValueTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CRC_TEST_CONTEXT  *TestContext;
+  CONST UINTN       Length = sizeof (TEST_CHECK_VALUE) - 1;
+
+  TestContext = Context;
+  UT_ASSERT_EQUAL (CalculateCrc32 (TEST_CHECK_VALUE, Length), 0xCBF43926);
+  UT_ASSERT_EQUAL (CalculateCrc32c (TEST_CHECK_VALUE, Length, 0), 0xE3069283);
+  UT_ASSERT_EQUAL (ReferenceCrc (TestContext->Crc32Table, MAX_UINT32, (CONST UINT8 *)TEST_CHECK_VALUE, Length), ~0xCBF43926U);
+  UT_ASSERT_EQUAL (ReferenceCrc (TestContext->Crc32cTable, MAX_UINT32, (CONST UINT8 *)TEST_CHECK_VALUE, Length), ~0xE3069283U);
+  UT_ASSERT_EQUAL (CalculateCrc32 (TestContext->Buffer, 0), 0);
+  UT_ASSERT_EQUAL (CalculateCrc32c (TestContext->Buffer, 0, 0x12345678), 0x12345678);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check CalculateCrc32() and CalculateCrc32c() against the reference for all
+  alignments of the buffer and lengths around the block sizes.
+
+  @param[in]  Context    The CRC_TEST_CONTEXT.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+EquivalenceTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CRC_TEST_CONTEXT  *TestContext;
+  UINTN             Offset;
+  UINTN             LengthIndex;
+  UINTN             Length;
+  UINT8             *Buffer;
+  UINT32            Seed;
+  UINT32            InitialValue;
+
+  TestContext = Context;
+  Seed        = 1;
+  for (Offset = 0; Offset < TEST_MAX_OFFSET; Offset++) {
+    for (LengthIndex = 0; LengthIndex < ARRAY_SIZE (mTestLengths); LengthIndex++) {
+      Length       = mTestLengths[LengthIndex];
+      Buffer       = TestContext->Buffer + Offset;
+      InitialValue = UnitTestRandom (&Seed);
+      UT_ASSERT_EQUAL (
+        CalculateCrc32 (Buffer, Length),
+        ~ReferenceCrc (TestContext->Crc32Table, MAX_UINT32, Buffer, Length)
+        );
+      UT_ASSERT_EQUAL (
+        CalculateCrc32c (Buffer, Length, InitialValue),
+        ~ReferenceCrc (TestContext->Crc32cTable, ~InitialValue, Buffer, Length)
+        );
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check that CalculateCrc32c() of a buffer is the CRC of its pieces chained
+  through InitialValue, wherever the buffer is split.
+
+  @param[in]  Context    The CRC_TEST_CONTEXT.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+ChainingTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CRC_TEST_CONTEXT  *TestContext;
+  UINT32            Whole;
+  UINT32            Seed;
+  UINTN             Round;
+  UINTN             Split;
+
+  TestContext = Context;
+  Whole       = CalculateCrc32c (TestContext->Buffer, TEST_MAX_LENGTH, 0);
+  Seed        = 2;
+  for (Round = 0; Round < 64; Round++) {
+    Split = UnitTestRandom (&Seed) % TEST_MAX_LENGTH;
+    UT_ASSERT_EQUAL (
+      CalculateCrc32c (
+        TestContext->Buffer + Split,
+        TEST_MAX_LENGTH - Split,
+        CalculateCrc32c (TestContext->Buffer, Split, 0)
+        ),
+      Whole
+      );
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Measure the throughput of CalculateCrc32() and CalculateCrc32c() against
+  the byte at a time reference on a large buffer.
+
+  @param[in]  Context    The CRC_TEST_CONTEXT.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CRC_TEST_CONTEXT  *TestContext;
+  UINTN             Pass;
+  UINT32            Reference;
+  UINT32            Crc;
+  UINT64            Start;
+  UINT64            ReferenceNs;
+  UINT64            Crc32Ns;
+  UINT64            Crc32cNs;
+
+  TestContext = Context;
+
+  //
+  // Each pass starts from the CRC of the previous one, so that the passes
+  // cannot be merged.
+  //
+  Reference = MAX_UINT32;
+  Start     = UnitTestBenchmarkStart ();
+  for (Pass = 0; Pass < TEST_BENCH_PASSES; Pass++) {
+    Reference = ReferenceCrc (TestContext->Crc32cTable, Reference, TestContext->Buffer, TEST_BENCH_SIZE);
+  }
+
+  ReferenceNs = UnitTestBenchmarkStop (Start);
+
+  Crc   = 0;
+  Start = UnitTestBenchmarkStart ();
+  for (Pass = 0; Pass < TEST_BENCH_PASSES; Pass++) {
+    Crc = CalculateCrc32c (TestContext->Buffer, TEST_BENCH_SIZE, Crc);
+  }
+
+  Crc32cNs = UnitTestBenchmarkStop (Start);
+  UT_ASSERT_EQUAL (Crc, ~Reference);
+
+  Start = UnitTestBenchmarkStart ();
+  for (Pass = 0; Pass < TEST_BENCH_PASSES; Pass++) {
+    Crc = CalculateCrc32 (TestContext->Buffer, TEST_BENCH_SIZE);
+  }
+
+  Crc32Ns = UnitTestBenchmarkStop (Start);
+  UT_ASSERT_EQUAL (Crc, ~ReferenceCrc (TestContext->Crc32Table, MAX_UINT32, TestContext->Buffer, TEST_BENCH_SIZE));
+
+  UT_LOG_INFO (
+    "%d x %d bytes: byte table %ld ns, CalculateCrc32 %ld ns, CalculateCrc32c %ld ns\n",
+    TEST_BENCH_PASSES,
+    TEST_BENCH_SIZE,
+    ReferenceNs,
+    Crc32Ns,
+    Crc32cNs
+    );
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the CRC APIs
+  and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      CrcTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&CrcTests, Framework, "CRC32 and CRC32c", "BaseLib.Crc", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for CRC Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  // --------------Suite-----Description-------------------Class Name----Function---------Pre-----------Post------------Context-----------
+  AddTestCase (CrcTests, "Check value", "CheckValue", CheckValueTest, CrcTestSetup, CrcTestCleanup, &mCrcTestContext);
+  AddTestCase (CrcTests, "Equivalence with byte table", "Equivalence", EquivalenceTest, CrcTestSetup, CrcTestCleanup, &mCrcTestContext);
+  AddTestCase (CrcTests, "CRC32c chaining", "Chaining", ChainingTest, CrcTestSetup, CrcTestCleanup, &mCrcTestContext);
+  AddTestCase (CrcTests, "Throughput benchmark", "Benchmark", BenchmarkTest, CrcTestSetup, CrcTestCleanup, &mCrcTestContext);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -1,7 +1,7 @@
 /** @file
   Implementation of the boot file download function.
 
-Copyright (c) 2015 - 2021, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2015 - 2026, Intel Corporation. All rights reserved.<BR>
 (C) Copyright 2016 Hewlett Packard Enterprise Development LP<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -597,26 +597,26 @@ HttpBootHttpIoCallback (
 }
 
 /**
-  Create a HttpIo instance for the file download.
+  Create and configure a HttpIo instance on the boot NIC.
 
   @param[in]    Private        The pointer to the driver's private data.
+  @param[out]   HttpIo         The HttpIo instance to create.
 
   @retval EFI_SUCCESS          Successfully created.
   @retval Others               Failed to create HttpIo.
 
 **/
+STATIC
 EFI_STATUS
-HttpBootCreateHttpIo (
-  IN     HTTP_BOOT_PRIVATE_DATA  *Private
+HttpBootCreateHttpIoInstance (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  OUT    HTTP_IO                 *HttpIo
   )
 {
   HTTP_IO_CONFIG_DATA  ConfigData;
-  EFI_STATUS           Status;
   EFI_HANDLE           ImageHandle;
   UINT32               TimeoutValue;
 
-  ASSERT (Private != NULL);
-
   //
   // Get HTTP timeout value
   //
@@ -636,15 +636,36 @@ HttpBootCreateHttpIo (
     ImageHandle = Private->Ip6Nic->ImageHandle;
   }
 
-  Status = HttpIoCreateIo (
-             ImageHandle,
-             Private->Controller,
-             Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
-             &ConfigData,
-             HttpBootHttpIoCallback,
-             (VOID *)Private,
-             &Private->HttpIo
-             );
+  return HttpIoCreateIo (
+           ImageHandle,
+           Private->Controller,
+           Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
+           &ConfigData,
+           HttpBootHttpIoCallback,
+           (VOID *)Private,
+           HttpIo
+           );
+}
+
+/**
+  Create a HttpIo instance for the file download.
+
+  @param[in]    Private        The pointer to the driver's private data.
+
+  @retval EFI_SUCCESS          Successfully created.
+  @retval Others               Failed to create HttpIo.
+
+**/
+EFI_STATUS
+HttpBootCreateHttpIo (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private
+  )
+{
+  EFI_STATUS  Status;
+
+  ASSERT (Private != NULL);
+
+  Status = HttpBootCreateHttpIoInstance (Private, &Private->HttpIo);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -901,6 +922,129 @@ HttpBootGetBootFileCallback (
   return EFI_SUCCESS;
 }
 
+/**
+  Build the HTTP header of a request to download the boot file.
+
+  @param[in]    Private            The pointer to the driver's private data.
+  @param[in]    ExtraHeaderCount   The number of headers the caller adds.
+  @param[out]   HttpIoHeader       The HTTP header holder, to be freed with
+                                   HttpIoFreeHeader().
+
+  @retval EFI_SUCCESS              The header was built.
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources
+  @retval EFI_UNSUPPORTED          The server requires an unsupported authentication scheme.
+  @retval Others                   Unexpected error happened.
+
+**/
+STATIC
+EFI_STATUS
+HttpBootCreateRequestHeader (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     UINTN                   ExtraHeaderCount,
+  OUT    HTTP_IO_HEADER          **HttpIoHeader
+  )
+{
+  EFI_STATUS      Status;
+  CHAR8           *HostName;
+  CHAR8           BaseAuthValue[80];
+  HTTP_IO_HEADER  *Header;
+
+  //
+  // 3 header is needed to download a boot file:
+  //       Host
+  //       Accept
+  //       User-Agent
+  //       [Authorization]
+  //
+  Header = HttpIoCreateHeader (((Private->AuthData != NULL) ? 4 : 3) + ExtraHeaderCount);
+  if (Header == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Add HTTP header field 1: Host
+  //
+  HostName = NULL;
+  Status   = HttpUrlGetHostName (
+               Private->BootFileUri,
+               Private->BootFileUriParser,
+               &HostName
+               );
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = HttpIoSetHeader (
+             Header,
+             HTTP_HEADER_HOST,
+             HostName
+             );
+  FreePool (HostName);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  //
+  // Add HTTP header field 2: Accept
+  //
+  Status = HttpIoSetHeader (
+             Header,
+             HTTP_HEADER_ACCEPT,
+             "*/*"
+             );
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  //
+  // Add HTTP header field 3: User-Agent
+  //
+  Status = HttpIoSetHeader (
+             Header,
+             HTTP_HEADER_USER_AGENT,
+             HTTP_USER_AGENT_EFI_HTTP_BOOT
+             );
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  //
+  // Add HTTP header field 4: Authorization
+  //
+  if (Private->AuthData != NULL) {
+    ASSERT (Header->MaxHeaderCount == 4 + ExtraHeaderCount);
+
+    if ((Private->AuthScheme != NULL) && (CompareMem (Private->AuthScheme, "Basic", 5) != 0)) {
+      Status = EFI_UNSUPPORTED;
+      goto ON_ERROR;
+    }
+
+    AsciiSPrint (
+      BaseAuthValue,
+      sizeof (BaseAuthValue),
+      "%a %a",
+      "Basic",
+      Private->AuthData
+      );
+
+    Status = HttpIoSetHeader (
+               Header,
+               HTTP_HEADER_AUTHORIZATION,
+               BaseAuthValue
+               );
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
+    }
+  }
+
+  *HttpIoHeader = Header;
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  HttpIoFreeHeader (Header);
+  return Status;
+}
+
 /**
   This function download the boot file by using UEFI HTTP protocol.
 
@@ -937,7 +1081,6 @@ HttpBootGetBootFile (
 {
   EFI_STATUS               Status;
   EFI_HTTP_STATUS_CODE     StatusCode;
-  CHAR8                    *HostName;
   EFI_HTTP_REQUEST_DATA    *RequestData;
   HTTP_IO_RESPONSE_DATA    *ResponseData;
   HTTP_IO_RESPONSE_DATA    ResponseBody;
@@ -952,7 +1095,6 @@ HttpBootGetBootFile (
   CHAR16                   *Url;
   BOOLEAN                  IdentityMode;
   UINTN                    ReceivedSize;
-  CHAR8                    BaseAuthValue[80];
   EFI_HTTP_HEADER          *HttpHeader;
   CHAR8                    *Data;
 
@@ -1009,92 +1151,11 @@ HttpBootGetBootFile (
   //
 
   //
-  // 2.1 Build HTTP header for the request, 3 header is needed to download a boot file:
-  //       Host
-  //       Accept
-  //       User-Agent
-  //       [Authorization]
-  //
-  HttpIoHeader = HttpIoCreateHeader ((Private->AuthData != NULL) ? 4 : 3);
-  if (HttpIoHeader == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
-    goto ERROR_2;
-  }
-
-  //
-  // Add HTTP header field 1: Host
-  //
-  HostName = NULL;
-  Status   = HttpUrlGetHostName (
-               Private->BootFileUri,
-               Private->BootFileUriParser,
-               &HostName
-               );
-  if (EFI_ERROR (Status)) {
-    goto ERROR_3;
-  }
-
-  Status = HttpIoSetHeader (
-             HttpIoHeader,
-             HTTP_HEADER_HOST,
-             HostName
-             );
-  FreePool (HostName);
-  if (EFI_ERROR (Status)) {
-    goto ERROR_3;
-  }
-
-  //
-  // Add HTTP header field 2: Accept
-  //
-  Status = HttpIoSetHeader (
-             HttpIoHeader,
-             HTTP_HEADER_ACCEPT,
-             "*/*"
-             );
-  if (EFI_ERROR (Status)) {
-    goto ERROR_3;
-  }
-
-  //
-  // Add HTTP header field 3: User-Agent
+  // 2.1 Build HTTP header for the request.
   //
-  Status = HttpIoSetHeader (
-             HttpIoHeader,
-             HTTP_HEADER_USER_AGENT,
-             HTTP_USER_AGENT_EFI_HTTP_BOOT
-             );
+  Status = HttpBootCreateRequestHeader (Private, 0, &HttpIoHeader);
   if (EFI_ERROR (Status)) {
-    goto ERROR_3;
-  }
-
-  //
-  // Add HTTP header field 4: Authorization
-  //
-  if (Private->AuthData != NULL) {
-    ASSERT (HttpIoHeader->MaxHeaderCount == 4);
-
-    if ((Private->AuthScheme != NULL) && (CompareMem (Private->AuthScheme, "Basic", 5) != 0)) {
-      Status = EFI_UNSUPPORTED;
-      goto ERROR_3;
-    }
-
-    AsciiSPrint (
-      BaseAuthValue,
-      sizeof (BaseAuthValue),
-      "%a %a",
-      "Basic",
-      Private->AuthData
-      );
-
-    Status = HttpIoSetHeader (
-               HttpIoHeader,
-               HTTP_HEADER_AUTHORIZATION,
-               BaseAuthValue
-               );
-    if (EFI_ERROR (Status)) {
-      goto ERROR_3;
-    }
+    goto ERROR_2;
   }
 
   //
@@ -1237,6 +1298,19 @@ HttpBootGetBootFile (
     goto ERROR_5;
   }
 
+  //
+  // Check whether the server accepts byte range requests for the boot file.
+  //
+  if (HeaderOnly) {
+    HttpHeader = HttpFindHeader (
+                   ResponseData->HeaderCount,
+                   ResponseData->Headers,
+                   HTTP_HEADER_ACCEPT_RANGES
+                   );
+    Private->BootFileRanges = (BOOLEAN)((HttpHeader != NULL) &&
+                                        (AsciiStriCmp (HttpHeader->FieldValue, HTTP_RANGE_UNIT_BYTES) == 0));
+  }
+
   //
   // 3.2 Cache the response header.
   //
@@ -1447,3 +1521,455 @@ ERROR_1:
 
   return Status;
 }
+
+/**
+  Close the HTTP connection of a byte range, if it is open.
+
+  @param[in]       This            The HTTP_BOOT_RANGE_IO of the download.
+  @param[in, out]  Range           The byte range.
+
+**/
+STATIC
+VOID
+EFIAPI
+HttpBootCloseRange (
+  IN     HTTP_BOOT_RANGE_IO  *This,
+  IN OUT HTTP_BOOT_RANGE     *Range
+  )
+{
+  HTTP_BOOT_RANGE_CONNECTION  *Connection;
+
+  Connection = Range->Connection;
+  if (Connection->RxPending) {
+    gBS->SetTimer (Connection->HttpIo.TimeoutEvent, TimerCancel, 0);
+    Connection->HttpIo.Http->Cancel (Connection->HttpIo.Http, &Connection->HttpIo.RspToken);
+    Connection->RxPending = FALSE;
+  }
+
+  if (Connection->HttpCreated) {
+    //
+    // Run the DPC of a cancelled token before its event is closed.
+    //
+    DispatchDpc ();
+    HttpIoDestroyIo (&Connection->HttpIo);
+    Connection->HttpCreated = FALSE;
+  }
+}
+
+/**
+  Open the HTTP connection of a byte range, and request the part of the range
+  which is not received yet.
+
+  @param[in]       This            The HTTP_BOOT_RANGE_IO of the download.
+  @param[in, out]  Range           The byte range.
+
+  @retval EFI_SUCCESS              The request was sent.
+  @retval Others                   Failed to open the connection or to send the request.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+HttpBootSendRangeRequest (
+  IN     HTTP_BOOT_RANGE_IO  *This,
+  IN OUT HTTP_BOOT_RANGE     *Range
+  )
+{
+  EFI_STATUS                  Status;
+  HTTP_BOOT_RANGE_CLIENT      *Client;
+  HTTP_BOOT_RANGE_CONNECTION  *Connection;
+  CHAR8                       RangeValue[HTTP_BOOT_RANGE_VALUE_LEN];
+
+  ASSERT (Range->ReceivedSize < Range->Length);
+
+  Client     = HTTP_BOOT_RANGE_CLIENT_FROM_IO (This);
+  Connection = Range->Connection;
+
+  Status = HttpBootCreateHttpIoInstance (Client->Private, &Connection->HttpIo);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // The ranges don't report their requests and responses as whole file ones.
+  //
+  Connection->HttpIo.Callback = NULL;
+  Connection->HttpCreated     = TRUE;
+
+  HttpBootBuildRangeValue (
+    Range->Offset,
+    Range->Length,
+    Range->ReceivedSize,
+    RangeValue,
+    sizeof (RangeValue)
+    );
+
+  Status = HttpIoSetHeader (
+             Client->HttpIoHeader,
+             HTTP_HEADER_RANGE,
+             RangeValue
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return HttpIoSendRequest (
+           &Connection->HttpIo,
+           &Client->RequestData,
+           Client->HttpIoHeader->HeaderCount,
+           Client->HttpIoHeader->Headers,
+           0,
+           NULL
+           );
+}
+
+/**
+  Receive the response header for a byte range, and check that the server
+  returns the requested part of the range.
+
+  @param[in]       This            The HTTP_BOOT_RANGE_IO of the download.
+  @param[in, out]  Range           The byte range.
+
+  @retval EFI_SUCCESS              The server returns the requested part of the range.
+  @retval EFI_UNSUPPORTED          The server ignored the Range header, returns another
+                                   range, or the boot file changed size.
+  @retval Others                   Failed to receive the response header.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+HttpBootRecvRangeHeader (
+  IN     HTTP_BOOT_RANGE_IO  *This,
+  IN OUT HTTP_BOOT_RANGE     *Range
+  )
+{
+  EFI_STATUS                  Status;
+  HTTP_BOOT_RANGE_CLIENT      *Client;
+  HTTP_BOOT_RANGE_CONNECTION  *Connection;
+  HTTP_IO_RESPONSE_DATA       ResponseData;
+  EFI_HTTP_HEADER             *HttpHeader;
+
+  Client     = HTTP_BOOT_RANGE_CLIENT_FROM_IO (This);
+  Connection = Range->Connection;
+
+  ZeroMem (&ResponseData, sizeof (HTTP_IO_RESPONSE_DATA));
+  Status = HttpIoRecvResponse (
+             &Connection->HttpIo,
+             TRUE,
+             &ResponseData
+             );
+  if (EFI_ERROR (Status) || EFI_ERROR (ResponseData.Status)) {
+    if (!EFI_ERROR (Status)) {
+      HttpBootPrintErrorMessage (ResponseData.Response.StatusCode);
+      Status = ResponseData.Status;
+    }
+
+    goto ON_EXIT;
+  }
+
+  //
+  // A server which ignores the Range header returns the whole file.
+  //
+  if (ResponseData.Response.StatusCode != HTTP_STATUS_206_PARTIAL_CONTENT) {
+    Status = EFI_UNSUPPORTED;
+    goto ON_EXIT;
+  }
+
+  HttpHeader = HttpFindHeader (
+                 ResponseData.HeaderCount,
+                 ResponseData.Headers,
+                 HTTP_HEADER_CONTENT_RANGE
+                 );
+  if (HttpHeader == NULL) {
+    Status = EFI_UNSUPPORTED;
+    goto ON_EXIT;
+  }
+
+  Status = HttpBootCheckContentRange (
+             HttpHeader->FieldValue,
+             Range->Offset,
+             Range->Length,
+             Range->ReceivedSize,
+             Client->Private->BootFileSize
+             );
+
+ON_EXIT:
+  if (ResponseData.Headers != NULL) {
+    HttpFreeHeaderFields (ResponseData.Headers, ResponseData.HeaderCount);
+  }
+
+  return Status;
+}
+
+/**
+  Receive part of the message-body of a byte range directly into the caller's
+  buffer, after the bytes already received.
+
+  A response token for the rest of the range is queued if none is pending,
+  then the connection is polled once.
+
+  @param[in]       This            The HTTP_BOOT_RANGE_IO of the download.
+  @param[in, out]  Range           The byte range.
+  @param[out]      ReceivedSize    The number of bytes received by this call.
+
+  @retval EFI_SUCCESS              The range is in progress.
+  @retval EFI_TIMEOUT              No data was received for the range in time.
+  @retval Others                   The connection of the range failed.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+HttpBootPollRange (
+  IN     HTTP_BOOT_RANGE_IO  *This,
+  IN OUT HTTP_BOOT_RANGE     *Range,
+  OUT    UINTN               *ReceivedSize
+  )
+{
+  EFI_STATUS                  Status;
+  HTTP_BOOT_RANGE_CLIENT      *Client;
+  HTTP_BOOT_RANGE_CONNECTION  *Connection;
+  HTTP_IO                     *HttpIo;
+  EFI_HTTP_PROTOCOL           *Http;
+  EFI_HTTP_MESSAGE            *Message;
+
+  Client        = HTTP_BOOT_RANGE_CLIENT_FROM_IO (This);
+  Connection    = Range->Connection;
+  HttpIo        = &Connection->HttpIo;
+  Http          = HttpIo->Http;
+  Message       = HttpIo->RspToken.Message;
+  *ReceivedSize = 0;
+
+  if (!Connection->RxPending) {
+    HttpIo->RspToken.Status = EFI_NOT_READY;
+    Message->Data.Response  = NULL;
+    Message->HeaderCount    = 0;
+    Message->Headers        = NULL;
+    Message->BodyLength     = Range->Length - Range->ReceivedSize;
+    Message->Body           = Client->Buffer + Range->Offset + Range->ReceivedSize;
+    HttpIo->IsRxDone        = FALSE;
+
+    Status = gBS->SetTimer (HttpIo->TimeoutEvent, TimerRelative, HttpIo->Timeout * TICKS_PER_MS);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Status = Http->Response (Http, &HttpIo->RspToken);
+    if (EFI_ERROR (Status)) {
+      gBS->SetTimer (HttpIo->TimeoutEvent, TimerCancel, 0);
+      return Status;
+    }
+
+    Connection->RxPending = TRUE;
+  }
+
+  Http->Poll (Http);
+
+  if (!HttpIo->IsRxDone) {
+    if (!EFI_ERROR (gBS->CheckEvent (HttpIo->TimeoutEvent))) {
+      return EFI_TIMEOUT;
+    }
+
+    return EFI_SUCCESS;
+  }
+
+  gBS->SetTimer (HttpIo->TimeoutEvent, TimerCancel, 0);
+  Connection->RxPending = FALSE;
+  HttpIo->IsRxDone      = FALSE;
+
+  if (EFI_ERROR (HttpIo->RspToken.Status)) {
+    return HttpIo->RspToken.Status;
+  }
+
+  *ReceivedSize = Message->BodyLength;
+  return EFI_SUCCESS;
+}
+
+/**
+  Report the request of the whole file once, when the server returns all the
+  byte ranges. The file size is known from the response to the HEAD request.
+  Until then, HttpBootGetBootFile() reports it on a fallback.
+
+  @param[in]  This                 The HTTP_BOOT_RANGE_IO of the download.
+
+  @retval EFI_SUCCESS              Go on with the download.
+  @retval Others                   The callback aborted the download.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+HttpBootRangesStarted (
+  IN HTTP_BOOT_RANGE_IO  *This
+  )
+{
+  HTTP_BOOT_RANGE_CLIENT  *Client;
+  EFI_HTTP_MESSAGE        RequestMessage;
+
+  Client = HTTP_BOOT_RANGE_CLIENT_FROM_IO (This);
+
+  ZeroMem (&RequestMessage, sizeof (EFI_HTTP_MESSAGE));
+  RequestMessage.Data.Request = &Client->RequestData;
+  RequestMessage.HeaderCount  = Client->HttpIoHeader->HeaderCount;
+  RequestMessage.Headers      = Client->HttpIoHeader->Headers;
+  return HttpBootHttpIoCallback (HttpIoRequest, &RequestMessage, Client->Private);
+}
+
+/**
+  Report the bytes of a byte range received into the caller's buffer to the
+  HTTP boot callback.
+
+  @param[in]  This                 The HTTP_BOOT_RANGE_IO of the download.
+  @param[in]  Range                The byte range.
+  @param[in]  ReceivedSize         The number of bytes received.
+
+  @retval EFI_SUCCESS              Go on with the download.
+  @retval Others                   The callback aborted the download.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+HttpBootRangeReceived (
+  IN HTTP_BOOT_RANGE_IO  *This,
+  IN HTTP_BOOT_RANGE     *Range,
+  IN UINTN               ReceivedSize
+  )
+{
+  HTTP_BOOT_RANGE_CLIENT  *Client;
+
+  Client = HTTP_BOOT_RANGE_CLIENT_FROM_IO (This);
+  if (Client->Private->HttpBootCallback == NULL) {
+    return EFI_SUCCESS;
+  }
+
+  return Client->Private->HttpBootCallback->Callback (
+                                              Client->Private->HttpBootCallback,
+                                              HttpBootHttpEntityBody,
+                                              TRUE,
+                                              (UINT32)ReceivedSize,
+                                              Client->Buffer + Range->Offset + Range->ReceivedSize - ReceivedSize
+                                              );
+}
+
+/**
+  This function downloads the boot file in byte ranges, over parallel HTTP
+  connections, directly into the caller's buffer.
+
+  The size and the type of the boot file must have been discovered with the
+  HTTP HEAD method, and the server must have accepted byte range requests.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in, out]  BufferSize      On input the size of Buffer in bytes. On output with a return
+                                   code of EFI_SUCCESS, the amount of data transferred to
+                                   Buffer.
+  @param[out]      Buffer          The memory buffer to transfer the file to.
+  @param[out]      ImageType       The image type of the downloaded file.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_UNSUPPORTED          The file is too small to be split, or the server did not
+                                   return the requested ranges. Nothing was transferred,
+                                   the caller should use HttpBootGetBootFile().
+  @retval EFI_BUFFER_TOO_SMALL     The BufferSize is too small to hold the file.
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources
+  @retval Others                   A range could not be downloaded.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileRanges (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN OUT UINTN                   *BufferSize,
+  OUT UINT8                      *Buffer,
+  OUT HTTP_BOOT_IMAGE_TYPE       *ImageType
+  )
+{
+  EFI_STATUS                  Status;
+  HTTP_BOOT_RANGE_CLIENT      Client;
+  HTTP_BOOT_RANGE_CONNECTION  *Connections;
+  HTTP_BOOT_RANGE             *Ranges;
+  UINTN                       RangeCount;
+  UINTN                       Index;
+  UINTN                       UrlSize;
+  CHAR16                      *Url;
+
+  ASSERT (Private != NULL);
+  ASSERT (Private->BootFileRanges);
+
+  if ((BufferSize == NULL) || (Buffer == NULL) || (ImageType == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  *ImageType = Private->ImageType;
+  if (*BufferSize < Private->BootFileSize) {
+    *BufferSize = Private->BootFileSize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  RangeCount = HttpBootSplitRange (Private->BootFileSize, PcdGet8 (PcdHttpBootRangeConnections), 0, NULL, NULL);
+  if (RangeCount < 2) {
+    return EFI_UNSUPPORTED;
+  }
+
+  UrlSize = AsciiStrSize (Private->BootFileUri);
+  Url     = AllocatePool (UrlSize * sizeof (CHAR16));
+  if (Url == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  AsciiStrToUnicodeStrS (Private->BootFileUri, Url, UrlSize);
+
+  ZeroMem (&Client, sizeof (Client));
+  Client.Io.Send               = HttpBootSendRangeRequest;
+  Client.Io.RecvHeader         = HttpBootRecvRangeHeader;
+  Client.Io.Poll               = HttpBootPollRange;
+  Client.Io.Close              = HttpBootCloseRange;
+  Client.Io.Started            = HttpBootRangesStarted;
+  Client.Io.Received           = HttpBootRangeReceived;
+  Client.Private               = Private;
+  Client.RequestData.Method    = HttpMethodGet;
+  Client.RequestData.Url       = Url;
+  Client.Buffer                = Buffer;
+
+  Connections = NULL;
+  Ranges      = NULL;
+  Status      = HttpBootCreateRequestHeader (Private, 1, &Client.HttpIoHeader);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  Connections = AllocateZeroPool (RangeCount * sizeof (HTTP_BOOT_RANGE_CONNECTION));
+  Ranges      = AllocateZeroPool (RangeCount * sizeof (HTTP_BOOT_RANGE));
+  if ((Connections == NULL) || (Ranges == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_EXIT;
+  }
+
+  for (Index = 0; Index < RangeCount; Index++) {
+    HttpBootSplitRange (Private->BootFileSize, RangeCount, Index, &Ranges[Index].Offset, &Ranges[Index].Length);
+    Ranges[Index].Connection = &Connections[Index];
+  }
+
+  DEBUG ((DEBUG_INFO, "HttpBootGetBootFileRanges: %Lu bytes over %Lu connections.\n", (UINT64)Private->BootFileSize, (UINT64)RangeCount));
+
+  Status = HttpBootDownloadRanges (&Client.Io, Ranges, RangeCount);
+  if (!EFI_ERROR (Status)) {
+    *BufferSize = Private->BootFileSize;
+  }
+
+ON_EXIT:
+  if (Ranges != NULL) {
+    FreePool (Ranges);
+  }
+
+  if (Connections != NULL) {
+    FreePool (Connections);
+  }
+
+  if (Client.HttpIoHeader != NULL) {
+    HttpIoFreeHeader (Client.HttpIoHeader);
+  }
+
+  FreePool (Url);
+  return Status;
+}
@@ -1,7 +1,7 @@
 /** @file
   Declaration of the boot file download function.
 
-Copyright (c) 2015 - 2021, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2015 - 2026, Intel Corporation. All rights reserved.<BR>
 (C) Copyright 2016 Hewlett Packard Enterprise Development LP<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -58,6 +58,29 @@ typedef struct {
   HTTP_BOOT_PRIVATE_DATA     *Private;
 } HTTP_BOOT_CALLBACK_DATA;
 
+//
+// The HTTP connection of a byte range of the boot file.
+//
+typedef struct {
+  HTTP_IO    HttpIo;
+  BOOLEAN    HttpCreated;
+  BOOLEAN    RxPending;                   // A response token for the message-body is queued.
+} HTTP_BOOT_RANGE_CONNECTION;
+
+//
+// The HTTP connections of the byte ranges of the boot file, and the request
+// they all send.
+//
+typedef struct {
+  HTTP_BOOT_RANGE_IO        Io;
+  HTTP_BOOT_PRIVATE_DATA    *Private;
+  HTTP_IO_HEADER            *HttpIoHeader; // The HTTP header of the request, with room for the Range header.
+  EFI_HTTP_REQUEST_DATA     RequestData;   // The HTTP GET request of the boot file.
+  UINT8                     *Buffer;       // The caller's buffer to transfer the file to.
+} HTTP_BOOT_RANGE_CLIENT;
+
+#define HTTP_BOOT_RANGE_CLIENT_FROM_IO(a)  BASE_CR (a, HTTP_BOOT_RANGE_CLIENT, Io)
+
 /**
   Discover all the boot information for boot file.
 
@@ -120,6 +143,37 @@ HttpBootGetBootFile (
   OUT HTTP_BOOT_IMAGE_TYPE       *ImageType
   );
 
+/**
+  This function downloads the boot file in byte ranges, over parallel HTTP
+  connections, directly into the caller's buffer.
+
+  The size and the type of the boot file must have been discovered with the
+  HTTP HEAD method, and the server must have accepted byte range requests.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in, out]  BufferSize      On input the size of Buffer in bytes. On output with a return
+                                   code of EFI_SUCCESS, the amount of data transferred to
+                                   Buffer.
+  @param[out]      Buffer          The memory buffer to transfer the file to.
+  @param[out]      ImageType       The image type of the downloaded file.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_UNSUPPORTED          The file is too small to be split, or the server did not
+                                   return the requested ranges. Nothing was transferred,
+                                   the caller should use HttpBootGetBootFile().
+  @retval EFI_BUFFER_TOO_SMALL     The BufferSize is too small to hold the file.
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources
+  @retval Others                   A range could not be downloaded.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileRanges (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN OUT UINTN                   *BufferSize,
+  OUT UINT8                      *Buffer,
+  OUT HTTP_BOOT_IMAGE_TYPE       *ImageType
+  );
+
 /**
   Clean up all cached data.
 
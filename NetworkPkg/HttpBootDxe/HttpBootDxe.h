@@ -1,7 +1,7 @@
 /** @file
   UEFI HTTP boot driver's private data structure and interfaces declaration.
 
-Copyright (c) 2015 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2015 - 2026, Intel Corporation. All rights reserved.<BR>
 (C) Copyright 2016 - 2020 Hewlett Packard Enterprise Development LP<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -107,6 +107,7 @@ typedef enum  {
 #include "HttpBootDhcp6.h"
 #include "HttpBootImpl.h"
 #include "HttpBootSupport.h"
+#include "HttpBootRange.h"
 #include "HttpBootClient.h"
 #include "HttpBootConfig.h"
 
@@ -214,6 +215,7 @@ struct _HTTP_BOOT_PRIVATE_DATA {
   CHAR8                                        *BootFileUri;
   VOID                                         *BootFileUriParser;
   UINTN                                        BootFileSize;
+  BOOLEAN                                      BootFileRanges;
   BOOLEAN                                      NoGateway;
   HTTP_BOOT_IMAGE_TYPE                         ImageType;
 
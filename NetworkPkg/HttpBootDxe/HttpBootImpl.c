@@ -1,7 +1,7 @@
 /** @file
   The implementation of EFI_LOAD_FILE_PROTOCOL for UEFI HTTP boot.
 
-Copyright (c) 2015 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2015 - 2026, Intel Corporation. All rights reserved.<BR>
 (C) Copyright 2016 Hewlett Packard Enterprise Development LP<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -398,15 +398,28 @@ HttpBootLoadFile (
   }
 
   //
-  // Load the boot file into Buffer
+  // Load the boot file into Buffer, in byte ranges over parallel connections
+  // if the server accepts them.
   //
-  Status = HttpBootGetBootFile (
-             Private,
-             FALSE,
-             BufferSize,
-             Buffer,
-             ImageType
-             );
+  Status = EFI_UNSUPPORTED;
+  if (Private->BootFileRanges) {
+    Status = HttpBootGetBootFileRanges (
+               Private,
+               BufferSize,
+               Buffer,
+               ImageType
+               );
+  }
+
+  if (Status == EFI_UNSUPPORTED) {
+    Status = HttpBootGetBootFile (
+               Private,
+               FALSE,
+               BufferSize,
+               Buffer,
+               ImageType
+               );
+  }
 
 ON_EXIT:
   HttpBootUninstallCallback (Private);
@@ -471,6 +484,7 @@ HttpBootStop (
   Private->BootFileUri       = NULL;
   Private->BootFileUriParser = NULL;
   Private->BootFileSize      = 0;
+  Private->BootFileRanges    = FALSE;
   Private->SelectIndex       = 0;
   Private->SelectProxyType   = HttpOfferTypeMax;
 
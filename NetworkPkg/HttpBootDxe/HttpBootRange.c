@@ -0,0 +1,335 @@
+/** @file
+  Byte ranges of the parallel boot file download.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "HttpBootRange.h"
+
+/**
+  Split the boot file into byte ranges. Each range gets at least
+  HTTP_BOOT_RANGE_MIN_SIZE bytes, the last range also takes the remainder.
+
+  @param[in]   FileSize        The size of the boot file, in bytes.
+  @param[in]   MaxCount        The maximum number of ranges.
+  @param[in]   Index           The index of the range, ignored if Offset and
+                               Length are NULL.
+  @param[out]  Offset          The offset of the range in the boot file.
+  @param[out]  Length          The length of the range.
+
+  @return The number of ranges. It is less than 2 if the file should be
+          downloaded over a single connection.
+
+**/
+UINTN
+HttpBootSplitRange (
+  IN  UINTN  FileSize,
+  IN  UINTN  MaxCount,
+  IN  UINTN  Index,
+  OUT UINTN  *Offset  OPTIONAL,
+  OUT UINTN  *Length  OPTIONAL
+  )
+{
+  UINTN  RangeCount;
+  UINTN  RangeLength;
+  UINTN  RangeOffset;
+
+  RangeCount = MIN (MaxCount, FileSize / HTTP_BOOT_RANGE_MIN_SIZE);
+  if ((RangeCount < 2) || ((Offset == NULL) && (Length == NULL))) {
+    return RangeCount;
+  }
+
+  RangeLength = FileSize / RangeCount;
+  RangeOffset = Index * RangeLength;
+  if (Index == RangeCount - 1) {
+    RangeLength = FileSize - RangeOffset;
+  }
+
+  if (Offset != NULL) {
+    *Offset = RangeOffset;
+  }
+
+  if (Length != NULL) {
+    *Length = RangeLength;
+  }
+
+  return RangeCount;
+}
+
+/**
+  Build the value of the Range header which requests the part of a byte range
+  which is not received yet.
+
+  @param[in]   Offset          The offset of the range in the boot file.
+  @param[in]   Length          The length of the range.
+  @param[in]   ReceivedSize    The bytes of the range already received.
+  @param[out]  Value           The value of the Range header.
+  @param[in]   ValueSize       The size of Value, in bytes.
+
+**/
+VOID
+HttpBootBuildRangeValue (
+  IN  UINTN  Offset,
+  IN  UINTN  Length,
+  IN  UINTN  ReceivedSize,
+  OUT CHAR8  *Value,
+  IN  UINTN  ValueSize
+  )
+{
+  AsciiSPrint (
+    Value,
+    ValueSize,
+    "%a=%Lu-%Lu",
+    HTTP_RANGE_UNIT_BYTES,
+    (UINT64)(Offset + ReceivedSize),
+    (UINT64)(Offset + Length - 1)
+    );
+}
+
+/**
+  Check the value of the Content-Range header of a 206 response against the
+  part of a byte range which was requested.
+
+  @param[in]  Value            The value of the Content-Range header.
+  @param[in]  Offset           The offset of the range in the boot file.
+  @param[in]  Length           The length of the range.
+  @param[in]  ReceivedSize     The bytes of the range already received.
+  @param[in]  FileSize         The size of the boot file, in bytes.
+
+  @retval EFI_SUCCESS          The server returns the requested part of the range.
+  @retval EFI_UNSUPPORTED      The server returns another range or an unsatisfied
+                               range, or the boot file changed size.
+
+**/
+EFI_STATUS
+HttpBootCheckContentRange (
+  IN CONST CHAR8  *Value,
+  IN UINTN        Offset,
+  IN UINTN        Length,
+  IN UINTN        ReceivedSize,
+  IN UINTN        FileSize
+  )
+{
+  CHAR8  *Next;
+  UINTN  First;
+  UINTN  Last;
+  UINTN  Total;
+
+  //
+  // Content-Range: bytes First-Last/Total
+  //
+  // An unsatisfied range is reported as "bytes */Total", which fails to
+  // parse like any other malformed value.
+  //
+  if (AsciiStrnCmp (Value, HTTP_RANGE_UNIT_BYTES " ", sizeof (HTTP_RANGE_UNIT_BYTES)) != 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Next = (CHAR8 *)Value + sizeof (HTTP_RANGE_UNIT_BYTES);
+  if (RETURN_ERROR (AsciiStrDecimalToUintnS (Next, &Next, &First)) || (*Next != '-') ||
+      RETURN_ERROR (AsciiStrDecimalToUintnS (Next + 1, &Next, &Last)) || (*Next != '/') ||
+      RETURN_ERROR (AsciiStrDecimalToUintnS (Next + 1, &Next, &Total)))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  if ((First != Offset + ReceivedSize) ||
+      (Last != Offset + Length - 1) ||
+      (Total != FileSize))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Resume a byte range after its connection failed: reopen the connection,
+  request the part of the range which is not received yet, and receive the
+  response header.
+
+  @param[in]       Io              The HTTP connections of the ranges.
+  @param[in, out]  Range           The byte range.
+  @param[in]       Failure         The status of the failure.
+
+  @retval EFI_SUCCESS              The range is resumed.
+  @retval Others                   The failure can't be recovered from, or the range failed
+                                   HTTP_BOOT_RANGE_MAX_RETRY times in a row.
+
+**/
+STATIC
+EFI_STATUS
+HttpBootResumeRange (
+  IN     HTTP_BOOT_RANGE_IO  *Io,
+  IN OUT HTTP_BOOT_RANGE     *Range,
+  IN     EFI_STATUS          Failure
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = Failure;
+  do {
+    Io->Close (Io, Range);
+    Range->HeaderReceived = FALSE;
+
+    if ((Status == EFI_ABORTED) ||
+        (Status == EFI_OUT_OF_RESOURCES) ||
+        (Status == EFI_UNSUPPORTED) ||
+        (Status == EFI_PROTOCOL_ERROR) ||
+        (Range->RetryCount >= HTTP_BOOT_RANGE_MAX_RETRY))
+    {
+      return Status;
+    }
+
+    Range->RetryCount++;
+    DEBUG ((
+      DEBUG_WARN,
+      "HttpBootResumeRange: %r, resume the range at %Lu from %Lu.\n",
+      Status,
+      (UINT64)Range->Offset,
+      (UINT64)(Range->Offset + Range->ReceivedSize)
+      ));
+
+    Status = Io->Send (Io, Range);
+    if (!EFI_ERROR (Status)) {
+      Status = Io->RecvHeader (Io, Range);
+    }
+  } while (EFI_ERROR (Status));
+
+  Range->HeaderReceived = TRUE;
+  return EFI_SUCCESS;
+}
+
+/**
+  Download byte ranges of the boot file over parallel HTTP connections.
+
+  The requests of all the ranges are sent first, then their response headers
+  are received, then the connections are polled in turn until all the
+  message-bodies are received. A range whose connection fails is resumed
+  from the first byte it misses, HTTP_BOOT_RANGE_MAX_RETRY times in a row at
+  most. The connections are closed on return.
+
+  @param[in]       Io              The HTTP connections of the ranges.
+  @param[in, out]  Ranges          The byte ranges, with nothing received yet.
+  @param[in]       RangeCount      The number of ranges.
+
+  @retval EFI_SUCCESS              All the ranges were received.
+  @retval EFI_UNSUPPORTED          The server did not return the requested ranges.
+                                   Nothing was received.
+  @retval EFI_PROTOCOL_ERROR       The server stopped returning the requested ranges
+                                   after part of them was received.
+  @retval Others                   A range could not be downloaded, or the download
+                                   was aborted.
+
+**/
+EFI_STATUS
+HttpBootDownloadRanges (
+  IN     HTTP_BOOT_RANGE_IO  *Io,
+  IN OUT HTTP_BOOT_RANGE     *Ranges,
+  IN     UINTN               RangeCount
+  )
+{
+  EFI_STATUS       Status;
+  HTTP_BOOT_RANGE  *Range;
+  UINTN            Remaining;
+  UINTN            Index;
+  UINTN            ReceivedSize;
+
+  //
+  // Send all the requests first, so that the server works on all the ranges
+  // while their response headers are received one after another.
+  //
+  for (Index = 0; Index < RangeCount; Index++) {
+    Status = Io->Send (Io, &Ranges[Index]);
+    if (EFI_ERROR (Status)) {
+      Status = HttpBootResumeRange (Io, &Ranges[Index], Status);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
+    }
+  }
+
+  //
+  // A range resumed above already has its response header.
+  //
+  for (Index = 0; Index < RangeCount; Index++) {
+    if (Ranges[Index].HeaderReceived) {
+      continue;
+    }
+
+    Status = Io->RecvHeader (Io, &Ranges[Index]);
+    if (EFI_ERROR (Status)) {
+      Status = HttpBootResumeRange (Io, &Ranges[Index], Status);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
+    } else {
+      Ranges[Index].HeaderReceived = TRUE;
+    }
+  }
+
+  Status = Io->Started (Io);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  //
+  // Poll the connections in turn until all the message-bodies are received.
+  //
+  Remaining = RangeCount;
+  while (Remaining > 0) {
+    for (Index = 0; Index < RangeCount; Index++) {
+      Range = &Ranges[Index];
+      if (Range->ReceivedSize == Range->Length) {
+        continue;
+      }
+
+      Status = Io->Poll (Io, Range, &ReceivedSize);
+      if (EFI_ERROR (Status)) {
+        Status = HttpBootResumeRange (Io, Range, Status);
+        if (EFI_ERROR (Status)) {
+          //
+          // Part of the file was transferred, don't let the caller retry
+          // with another method.
+          //
+          if (Status == EFI_UNSUPPORTED) {
+            Status = EFI_PROTOCOL_ERROR;
+          }
+
+          goto ON_EXIT;
+        }
+
+        continue;
+      }
+
+      if (ReceivedSize == 0) {
+        continue;
+      }
+
+      ASSERT (ReceivedSize <= Range->Length - Range->ReceivedSize);
+      Range->ReceivedSize += ReceivedSize;
+      Range->RetryCount    = 0;
+
+      Status = Io->Received (Io, Range, ReceivedSize);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
+
+      if (Range->ReceivedSize == Range->Length) {
+        Io->Close (Io, Range);
+        Remaining--;
+      }
+    }
+  }
+
+  Status = EFI_SUCCESS;
+
+ON_EXIT:
+  for (Index = 0; Index < RangeCount; Index++) {
+    Io->Close (Io, &Ranges[Index]);
+  }
+
+  return Status;
+}
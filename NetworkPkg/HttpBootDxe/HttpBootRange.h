@@ -0,0 +1,260 @@
+/** @file
+  Byte ranges of the parallel boot file download.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EFI_HTTP_BOOT_RANGE_H__
+#define __EFI_HTTP_BOOT_RANGE_H__
+
+#include <Uefi.h>
+#include <IndustryStandard/Http11.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/PrintLib.h>
+
+//
+// Parallel download of byte ranges of the boot file: each connection gets a
+// range of at least HTTP_BOOT_RANGE_MIN_SIZE bytes, and resumes its range at
+// most HTTP_BOOT_RANGE_MAX_RETRY times in a row without receiving any data.
+//
+#define HTTP_BOOT_RANGE_MIN_SIZE   SIZE_1MB
+#define HTTP_BOOT_RANGE_MAX_RETRY  3
+#define HTTP_BOOT_RANGE_VALUE_LEN  64
+
+typedef struct _HTTP_BOOT_RANGE_IO HTTP_BOOT_RANGE_IO;
+
+//
+// A byte range of the boot file, downloaded over its own HTTP connection.
+//
+typedef struct {
+  UINTN      Offset;                      // Offset of the range in the boot file.
+  UINTN      Length;                      // Length of the range.
+  UINTN      ReceivedSize;                // Bytes of the range already in the caller's buffer.
+  UINTN      RetryCount;
+  BOOLEAN    HeaderReceived;              // The response header to the last request is accepted.
+  VOID       *Connection;                 // The HTTP connection, owned by the HTTP_BOOT_RANGE_IO.
+} HTTP_BOOT_RANGE;
+
+/**
+  Open the HTTP connection of a byte range, and request the part of the range
+  which is not received yet.
+
+  @param[in]       This            The HTTP_BOOT_RANGE_IO of the download.
+  @param[in, out]  Range           The byte range.
+
+  @retval EFI_SUCCESS              The request was sent.
+  @retval Others                   Failed to open the connection or to send the request.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *HTTP_BOOT_RANGE_SEND)(
+  IN     HTTP_BOOT_RANGE_IO  *This,
+  IN OUT HTTP_BOOT_RANGE     *Range
+  );
+
+/**
+  Receive the response header for a byte range, and check that the server
+  returns the requested part of the range.
+
+  @param[in]       This            The HTTP_BOOT_RANGE_IO of the download.
+  @param[in, out]  Range           The byte range.
+
+  @retval EFI_SUCCESS              The server returns the requested part of the range.
+  @retval EFI_UNSUPPORTED          The server ignored the Range header, returns another
+                                   range, or the boot file changed size.
+  @retval Others                   Failed to receive the response header.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *HTTP_BOOT_RANGE_RECV_HEADER)(
+  IN     HTTP_BOOT_RANGE_IO  *This,
+  IN OUT HTTP_BOOT_RANGE     *Range
+  );
+
+/**
+  Receive part of the message-body of a byte range into the caller's buffer,
+  after the bytes already received. The connection is polled once.
+
+  @param[in]       This            The HTTP_BOOT_RANGE_IO of the download.
+  @param[in, out]  Range           The byte range.
+  @param[out]      ReceivedSize    The number of bytes received by this call.
+
+  @retval EFI_SUCCESS              The range is in progress.
+  @retval EFI_TIMEOUT              No data was received for the range in time.
+  @retval Others                   The connection of the range failed.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *HTTP_BOOT_RANGE_POLL)(
+  IN     HTTP_BOOT_RANGE_IO  *This,
+  IN OUT HTTP_BOOT_RANGE     *Range,
+  OUT    UINTN               *ReceivedSize
+  );
+
+/**
+  Close the HTTP connection of a byte range, if it is open.
+
+  @param[in]       This            The HTTP_BOOT_RANGE_IO of the download.
+  @param[in, out]  Range           The byte range.
+
+**/
+typedef
+VOID
+(EFIAPI *HTTP_BOOT_RANGE_CLOSE)(
+  IN     HTTP_BOOT_RANGE_IO  *This,
+  IN OUT HTTP_BOOT_RANGE     *Range
+  );
+
+/**
+  Report that the server returns all the byte ranges, before their
+  message-bodies are received.
+
+  @param[in]  This                 The HTTP_BOOT_RANGE_IO of the download.
+
+  @retval EFI_SUCCESS              Go on with the download.
+  @retval Others                   Abort the download.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *HTTP_BOOT_RANGE_STARTED)(
+  IN HTTP_BOOT_RANGE_IO  *This
+  );
+
+/**
+  Report the bytes of a byte range received into the caller's buffer. They are
+  the last ReceivedSize bytes of the Range->ReceivedSize bytes of the range.
+
+  @param[in]  This                 The HTTP_BOOT_RANGE_IO of the download.
+  @param[in]  Range                The byte range.
+  @param[in]  ReceivedSize         The number of bytes received.
+
+  @retval EFI_SUCCESS              Go on with the download.
+  @retval Others                   Abort the download.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *HTTP_BOOT_RANGE_RECEIVED)(
+  IN HTTP_BOOT_RANGE_IO  *This,
+  IN HTTP_BOOT_RANGE     *Range,
+  IN UINTN               ReceivedSize
+  );
+
+//
+// The HTTP connections that HttpBootDownloadRanges() downloads the byte
+// ranges over.
+//
+struct _HTTP_BOOT_RANGE_IO {
+  HTTP_BOOT_RANGE_SEND           Send;
+  HTTP_BOOT_RANGE_RECV_HEADER    RecvHeader;
+  HTTP_BOOT_RANGE_POLL           Poll;
+  HTTP_BOOT_RANGE_CLOSE          Close;
+  HTTP_BOOT_RANGE_STARTED        Started;
+  HTTP_BOOT_RANGE_RECEIVED       Received;
+};
+
+/**
+  Split the boot file into byte ranges. Each range gets at least
+  HTTP_BOOT_RANGE_MIN_SIZE bytes, the last range also takes the remainder.
+
+  @param[in]   FileSize        The size of the boot file, in bytes.
+  @param[in]   MaxCount        The maximum number of ranges.
+  @param[in]   Index           The index of the range, ignored if Offset and
+                               Length are NULL.
+  @param[out]  Offset          The offset of the range in the boot file.
+  @param[out]  Length          The length of the range.
+
+  @return The number of ranges. It is less than 2 if the file should be
+          downloaded over a single connection.
+
+**/
+UINTN
+HttpBootSplitRange (
+  IN  UINTN  FileSize,
+  IN  UINTN  MaxCount,
+  IN  UINTN  Index,
+  OUT UINTN  *Offset  OPTIONAL,
+  OUT UINTN  *Length  OPTIONAL
+  );
+
+/**
+  Build the value of the Range header which requests the part of a byte range
+  which is not received yet.
+
+  @param[in]   Offset          The offset of the range in the boot file.
+  @param[in]   Length          The length of the range.
+  @param[in]   ReceivedSize    The bytes of the range already received.
+  @param[out]  Value           The value of the Range header.
+  @param[in]   ValueSize       The size of Value, in bytes.
+
+**/
+VOID
+HttpBootBuildRangeValue (
+  IN  UINTN  Offset,
+  IN  UINTN  Length,
+  IN  UINTN  ReceivedSize,
+  OUT CHAR8  *Value,
+  IN  UINTN  ValueSize
+  );
+
+/**
+  Check the value of the Content-Range header of a 206 response against the
+  part of a byte range which was requested.
+
+  @param[in]  Value            The value of the Content-Range header.
+  @param[in]  Offset           The offset of the range in the boot file.
+  @param[in]  Length           The length of the range.
+  @param[in]  ReceivedSize     The bytes of the range already received.
+  @param[in]  FileSize         The size of the boot file, in bytes.
+
+  @retval EFI_SUCCESS          The server returns the requested part of the range.
+  @retval EFI_UNSUPPORTED      The server returns another range or an unsatisfied
+                               range, or the boot file changed size.
+
+**/
+EFI_STATUS
+HttpBootCheckContentRange (
+  IN CONST CHAR8  *Value,
+  IN UINTN        Offset,
+  IN UINTN        Length,
+  IN UINTN        ReceivedSize,
+  IN UINTN        FileSize
+  );
+
+/**
+  Download byte ranges of the boot file over parallel HTTP connections.
+
+  The requests of all the ranges are sent first, then their response headers
+  are received, then the connections are polled in turn until all the
+  message-bodies are received. A range whose connection fails is resumed
+  from the first byte it misses, HTTP_BOOT_RANGE_MAX_RETRY times in a row at
+  most. The connections are closed on return.
+
+  @param[in]       Io              The HTTP connections of the ranges.
+  @param[in, out]  Ranges          The byte ranges, with nothing received yet.
+  @param[in]       RangeCount      The number of ranges.
+
+  @retval EFI_SUCCESS              All the ranges were received.
+  @retval EFI_UNSUPPORTED          The server did not return the requested ranges.
+                                   Nothing was received.
+  @retval EFI_PROTOCOL_ERROR       The server stopped returning the requested ranges
+                                   after part of them was received.
+  @retval Others                   A range could not be downloaded, or the download
+                                   was aborted.
+
+**/
+EFI_STATUS
+HttpBootDownloadRanges (
+  IN     HTTP_BOOT_RANGE_IO  *Io,
+  IN OUT HTTP_BOOT_RANGE     *Ranges,
+  IN     UINTN               RangeCount
+  );
+
+#endif
@@ -0,0 +1,836 @@
+/** @file
+  Unit tests of the byte ranges of the parallel HTTP boot file download,
+  against a simulated range server whose connections fail on request.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PrintLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "../HttpBootRange.h"
+
+#define UNIT_TEST_APP_NAME     "HttpBootDxe Range Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_FILE_SIZE     (4 * HTTP_BOOT_RANGE_MIN_SIZE + 3)
+#define TEST_RANGE_COUNT   4
+#define TEST_CHUNK_SIZE    0x23456
+#define TEST_MAX_REQUESTS  8
+
+/**
+  Check that the ranges of a boot file are contiguous, cover the whole file,
+  and get at least HTTP_BOOT_RANGE_MIN_SIZE bytes each.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The file is split as expected.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  A check failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TestSplitRange (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  RangeCount;
+  UINTN  Index;
+  UINTN  Offset;
+  UINTN  Length;
+  UINTN  End;
+
+  RangeCount = HttpBootSplitRange (TEST_FILE_SIZE, TEST_RANGE_COUNT, 0, NULL, NULL);
+  UT_ASSERT_EQUAL (RangeCount, TEST_RANGE_COUNT);
+
+  End = 0;
+  for (Index = 0; Index < RangeCount; Index++) {
+    UT_ASSERT_EQUAL (HttpBootSplitRange (TEST_FILE_SIZE, TEST_RANGE_COUNT, Index, &Offset, &Length), RangeCount);
+    UT_ASSERT_EQUAL (Offset, End);
+    UT_ASSERT_TRUE (Length >= HTTP_BOOT_RANGE_MIN_SIZE);
+    End = Offset + Length;
+  }
+
+  //
+  // The last range takes the remainder.
+  //
+  UT_ASSERT_EQUAL (End, TEST_FILE_SIZE);
+  UT_ASSERT_EQUAL (Length, HTTP_BOOT_RANGE_MIN_SIZE + 3);
+
+  //
+  // The minimum range size limits the number of ranges, a file too small for
+  // two ranges isn't split.
+  //
+  UT_ASSERT_EQUAL (HttpBootSplitRange (3 * HTTP_BOOT_RANGE_MIN_SIZE - 1, TEST_RANGE_COUNT, 0, NULL, NULL), 2);
+  UT_ASSERT_TRUE (HttpBootSplitRange (2 * HTTP_BOOT_RANGE_MIN_SIZE - 1, TEST_RANGE_COUNT, 0, NULL, NULL) < 2);
+  UT_ASSERT_TRUE (HttpBootSplitRange (TEST_FILE_SIZE, 1, 0, NULL, NULL) < 2);
+  UT_ASSERT_TRUE (HttpBootSplitRange (TEST_FILE_SIZE, 0, 0, NULL, NULL) < 2);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check that a resumed range requests, and accepts, only the part of the
+  range which is not received yet.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             Every resume requests the rest of its range.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  A check failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TestResumeRange (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+  UINTN  Offset;
+  UINTN  Length;
+  UINTN  ReceivedSize;
+  CHAR8  RangeValue[HTTP_BOOT_RANGE_VALUE_LEN];
+  CHAR8  Expected[HTTP_BOOT_RANGE_VALUE_LEN];
+  CHAR8  ContentRange[HTTP_BOOT_RANGE_VALUE_LEN];
+
+  for (Index = 0; Index < TEST_RANGE_COUNT; Index++) {
+    HttpBootSplitRange (TEST_FILE_SIZE, TEST_RANGE_COUNT, Index, &Offset, &Length);
+
+    //
+    // Each connection fails after every chunk, and resumes its range from
+    // the first byte it misses.
+    //
+    for (ReceivedSize = 0; ReceivedSize < Length; ReceivedSize += MIN (TEST_CHUNK_SIZE, Length - ReceivedSize)) {
+      HttpBootBuildRangeValue (Offset, Length, ReceivedSize, RangeValue, sizeof (RangeValue));
+      AsciiSPrint (Expected, sizeof (Expected), "bytes=%Lu-%Lu", (UINT64)(Offset + ReceivedSize), (UINT64)(Offset + Length - 1));
+      UT_ASSERT_MEM_EQUAL (RangeValue, Expected, AsciiStrSize (Expected));
+
+      AsciiSPrint (
+        ContentRange,
+        sizeof (ContentRange),
+        "bytes %Lu-%Lu/%Lu",
+        (UINT64)(Offset + ReceivedSize),
+        (UINT64)(Offset + Length - 1),
+        (UINT64)TEST_FILE_SIZE
+        );
+      UT_ASSERT_NOT_EFI_ERROR (HttpBootCheckContentRange (ContentRange, Offset, Length, ReceivedSize, TEST_FILE_SIZE));
+
+      //
+      // A server which resends the bytes already received is rejected.
+      //
+      if (ReceivedSize != 0) {
+        AsciiSPrint (
+          ContentRange,
+          sizeof (ContentRange),
+          "bytes %Lu-%Lu/%Lu",
+          (UINT64)Offset,
+          (UINT64)(Offset + Length - 1),
+          (UINT64)TEST_FILE_SIZE
+          );
+        UT_ASSERT_STATUS_EQUAL (HttpBootCheckContentRange (ContentRange, Offset, Length, ReceivedSize, TEST_FILE_SIZE), EFI_UNSUPPORTED);
+      }
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check that every Content-Range which doesn't match the request makes the
+  download fall back to a single connection.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             Every mismatch is unsupported.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  A check failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TestContentRangeMismatch (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Offset;
+  UINTN  Length;
+
+  HttpBootSplitRange (TEST_FILE_SIZE, TEST_RANGE_COUNT, 1, &Offset, &Length);
+  UT_ASSERT_EQUAL (Offset, 0x100000);
+  UT_ASSERT_EQUAL (Length, 0x100000);
+
+  UT_ASSERT_NOT_EFI_ERROR (HttpBootCheckContentRange ("bytes 1048576-2097151/4194307", Offset, Length, 0, TEST_FILE_SIZE));
+  UT_ASSERT_NOT_EFI_ERROR (HttpBootCheckContentRange ("bytes 1049000-2097151/4194307", Offset, Length, 424, TEST_FILE_SIZE));
+
+  //
+  // Unsatisfied range, another range, a file which changed size, and values
+  // which don't parse.
+  //
+  UT_ASSERT_STATUS_EQUAL (HttpBootCheckContentRange ("bytes */4194307", Offset, Length, 0, TEST_FILE_SIZE), EFI_UNSUPPORTED);
+  UT_ASSERT_STATUS_EQUAL (HttpBootCheckContentRange ("bytes 0-4194306/4194307", Offset, Length, 0, TEST_FILE_SIZE), EFI_UNSUPPORTED);
+  UT_ASSERT_STATUS_EQUAL (HttpBootCheckContentRange ("bytes 1048576-2097150/4194307", Offset, Length, 0, TEST_FILE_SIZE), EFI_UNSUPPORTED);
+  UT_ASSERT_STATUS_EQUAL (HttpBootCheckContentRange ("bytes 1048576-2097151/4194308", Offset, Length, 0, TEST_FILE_SIZE), EFI_UNSUPPORTED);
+  UT_ASSERT_STATUS_EQUAL (HttpBootCheckContentRange ("bytes 1048576-2097151/*", Offset, Length, 0, TEST_FILE_SIZE), EFI_UNSUPPORTED);
+  UT_ASSERT_STATUS_EQUAL (HttpBootCheckContentRange ("bytes 1048576-2097151", Offset, Length, 0, TEST_FILE_SIZE), EFI_UNSUPPORTED);
+  UT_ASSERT_STATUS_EQUAL (HttpBootCheckContentRange ("items 1048576-2097151/4194307", Offset, Length, 0, TEST_FILE_SIZE), EFI_UNSUPPORTED);
+  UT_ASSERT_STATUS_EQUAL (HttpBootCheckContentRange ("bytes", Offset, Length, 0, TEST_FILE_SIZE), EFI_UNSUPPORTED);
+
+  return UNIT_TEST_PASSED;
+}
+
+//
+// A connection of the simulated range server. It fails the next SendFailures
+// requests, and fails its message-body once before each file offset of
+// BodyFailAt.
+//
+typedef struct {
+  BOOLEAN    Open;
+  BOOLEAN    HeaderPending;
+  UINTN      Next;
+  UINTN      End;
+  UINTN      SendFailures;
+  UINTN      BodyFailAt[HTTP_BOOT_RANGE_MAX_RETRY + 1];
+  UINTN      BodyFailCount;
+  UINTN      RequestStart[TEST_MAX_REQUESTS];
+  UINTN      RequestCount;
+} TEST_CONNECTION;
+
+//
+// The simulated range server, behind the HTTP_BOOT_RANGE_IO of the download.
+//
+typedef struct {
+  HTTP_BOOT_RANGE_IO    Io;
+  UINT8                 *File;
+  UINT8                 *Buffer;
+  BOOLEAN               IgnoreRange;
+  BOOLEAN               Started;
+  UINTN                 ReceivedTotal;
+  HTTP_BOOT_RANGE       Ranges[TEST_RANGE_COUNT];
+  TEST_CONNECTION       Connections[TEST_RANGE_COUNT];
+} TEST_SERVER;
+
+#define TEST_SERVER_FROM_IO(a)  BASE_CR (a, TEST_SERVER, Io)
+
+STATIC TEST_SERVER  mServer;
+
+/**
+  Open the connection of a byte range, and parse the Range header of its
+  request.
+
+  @param[in]       This            The HTTP_BOOT_RANGE_IO of the download.
+  @param[in, out]  Range           The byte range.
+
+  @retval EFI_SUCCESS              The request was sent.
+  @retval EFI_CONNECTION_RESET     The connection fails this request.
+  @retval EFI_PROTOCOL_ERROR       The request is malformed.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestRangeSend (
+  IN     HTTP_BOOT_RANGE_IO  *This,
+  IN OUT HTTP_BOOT_RANGE     *Range
+  )
+{
+  TEST_CONNECTION  *Connection;
+  CHAR8            RangeValue[HTTP_BOOT_RANGE_VALUE_LEN];
+  CHAR8            *Next;
+  UINTN            First;
+  UINTN            Last;
+
+  Connection = Range->Connection;
+  if (Connection->Open) {
+    return EFI_PROTOCOL_ERROR;
+  }
+
+  Connection->Open = TRUE;
+  if (Connection->SendFailures > 0) {
+    Connection->SendFailures--;
+    return EFI_CONNECTION_RESET;
+  }
+
+  HttpBootBuildRangeValue (Range->Offset, Range->Length, Range->ReceivedSize, RangeValue, sizeof (RangeValue));
+  if ((AsciiStrnCmp (RangeValue, "bytes=", 6) != 0) ||
+      RETURN_ERROR (AsciiStrDecimalToUintnS (RangeValue + 6, &Next, &First)) || (*Next != '-') ||
+      RETURN_ERROR (AsciiStrDecimalToUintnS (Next + 1, &Next, &Last)) || (*Next != '\0') ||
+      (Connection->RequestCount == TEST_MAX_REQUESTS))
+  {
+    return EFI_PROTOCOL_ERROR;
+  }
+
+  Connection->RequestStart[Connection->RequestCount++] = First;
+  Connection->Next                                     = First;
+  Connection->End                                      = Last + 1;
+  Connection->HeaderPending                            = TRUE;
+  return EFI_SUCCESS;
+}
+
+/**
+  Return the response header of the last request of a byte range, once.
+
+  @param[in]       This            The HTTP_BOOT_RANGE_IO of the download.
+  @param[in, out]  Range           The byte range.
+
+  @retval EFI_SUCCESS              The server returns the requested part of the range.
+  @retval EFI_UNSUPPORTED          The server ignores the Range header.
+  @retval EFI_PROTOCOL_ERROR       No response header is pending.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestRangeRecvHeader (
+  IN     HTTP_BOOT_RANGE_IO  *This,
+  IN OUT HTTP_BOOT_RANGE     *Range
+  )
+{
+  TEST_CONNECTION  *Connection;
+  CHAR8            ContentRange[HTTP_BOOT_RANGE_VALUE_LEN];
+
+  Connection = Range->Connection;
+  if (!Connection->Open || !Connection->HeaderPending) {
+    return EFI_PROTOCOL_ERROR;
+  }
+
+  Connection->HeaderPending = FALSE;
+  if (TEST_SERVER_FROM_IO (This)->IgnoreRange) {
+    return EFI_UNSUPPORTED;
+  }
+
+  AsciiSPrint (
+    ContentRange,
+    sizeof (ContentRange),
+    "bytes %Lu-%Lu/%Lu",
+    (UINT64)Connection->Next,
+    (UINT64)(Connection->End - 1),
+    (UINT64)TEST_FILE_SIZE
+    );
+  return HttpBootCheckContentRange (ContentRange, Range->Offset, Range->Length, Range->ReceivedSize, TEST_FILE_SIZE);
+}
+
+/**
+  Return the next chunk of the message-body of a byte range.
+
+  @param[in]       This            The HTTP_BOOT_RANGE_IO of the download.
+  @param[in, out]  Range           The byte range.
+  @param[out]      ReceivedSize    The number of bytes received by this call.
+
+  @retval EFI_SUCCESS              The range is in progress.
+  @retval EFI_CONNECTION_RESET     The connection fails before the next failure offset.
+  @retval EFI_PROTOCOL_ERROR       The message-body is polled out of turn.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestRangePoll (
+  IN     HTTP_BOOT_RANGE_IO  *This,
+  IN OUT HTTP_BOOT_RANGE     *Range,
+  OUT    UINTN               *ReceivedSize
+  )
+{
+  TEST_SERVER      *Server;
+  TEST_CONNECTION  *Connection;
+  UINTN            Size;
+
+  Server        = TEST_SERVER_FROM_IO (This);
+  Connection    = Range->Connection;
+  *ReceivedSize = 0;
+
+  if (!Connection->Open || Connection->HeaderPending ||
+      (Connection->Next != Range->Offset + Range->ReceivedSize) ||
+      (Connection->Next >= Connection->End))
+  {
+    return EFI_PROTOCOL_ERROR;
+  }
+
+  Size = MIN (TEST_CHUNK_SIZE, Connection->End - Connection->Next);
+  if (Connection->BodyFailCount > 0) {
+    if (Connection->Next >= Connection->BodyFailAt[0]) {
+      Connection->BodyFailCount--;
+      CopyMem (Connection->BodyFailAt, Connection->BodyFailAt + 1, Connection->BodyFailCount * sizeof (UINTN));
+      return EFI_CONNECTION_RESET;
+    }
+
+    Size = MIN (Size, Connection->BodyFailAt[0] - Connection->Next);
+  }
+
+  CopyMem (Server->Buffer + Connection->Next, Server->File + Connection->Next, Size);
+  Connection->Next += Size;
+  *ReceivedSize     = Size;
+  return EFI_SUCCESS;
+}
+
+/**
+  Close the connection of a byte range.
+
+  @param[in]       This            The HTTP_BOOT_RANGE_IO of the download.
+  @param[in, out]  Range           The byte range.
+
+**/
+STATIC
+VOID
+EFIAPI
+TestRangeClose (
+  IN     HTTP_BOOT_RANGE_IO  *This,
+  IN OUT HTTP_BOOT_RANGE     *Range
+  )
+{
+  TEST_CONNECTION  *Connection;
+
+  Connection                = Range->Connection;
+  Connection->Open          = FALSE;
+  Connection->HeaderPending = FALSE;
+}
+
+/**
+  Record that the server returns all the byte ranges.
+
+  @param[in]  This                 The HTTP_BOOT_RANGE_IO of the download.
+
+  @retval EFI_SUCCESS              Go on with the download.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestRangesStarted (
+  IN HTTP_BOOT_RANGE_IO  *This
+  )
+{
+  TEST_SERVER_FROM_IO (This)->Started = TRUE;
+  return EFI_SUCCESS;
+}
+
+/**
+  Count the bytes of a byte range received into the buffer, and check that
+  they are where the download reports them.
+
+  @param[in]  This                 The HTTP_BOOT_RANGE_IO of the download.
+  @param[in]  Range                The byte range.
+  @param[in]  ReceivedSize         The number of bytes received.
+
+  @retval EFI_SUCCESS              Go on with the download.
+  @retval EFI_ABORTED              The bytes are not the ones of the file.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestRangeReceived (
+  IN HTTP_BOOT_RANGE_IO  *This,
+  IN HTTP_BOOT_RANGE     *Range,
+  IN UINTN               ReceivedSize
+  )
+{
+  TEST_SERVER  *Server;
+  UINTN        Offset;
+
+  Server = TEST_SERVER_FROM_IO (This);
+  Offset = Range->Offset + Range->ReceivedSize - ReceivedSize;
+  if (CompareMem (Server->Buffer + Offset, Server->File + Offset, ReceivedSize) != 0) {
+    return EFI_ABORTED;
+  }
+
+  Server->ReceivedTotal += ReceivedSize;
+  return EFI_SUCCESS;
+}
+
+/**
+  Create the simulated range server and the byte ranges of the boot file.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED                      The server is created.
+  @retval  UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  Out of memory.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+CreateServer (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  ZeroMem (&mServer, sizeof (mServer));
+  mServer.Io.Send       = TestRangeSend;
+  mServer.Io.RecvHeader = TestRangeRecvHeader;
+  mServer.Io.Poll       = TestRangePoll;
+  mServer.Io.Close      = TestRangeClose;
+  mServer.Io.Started    = TestRangesStarted;
+  mServer.Io.Received   = TestRangeReceived;
+
+  mServer.File   = AllocatePool (TEST_FILE_SIZE);
+  mServer.Buffer = AllocateZeroPool (TEST_FILE_SIZE);
+  if ((mServer.File == NULL) || (mServer.Buffer == NULL)) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  for (Index = 0; Index < TEST_FILE_SIZE; Index++) {
+    mServer.File[Index] = (UINT8)(Index ^ (Index >> 8) ^ (Index >> 16));
+  }
+
+  for (Index = 0; Index < TEST_RANGE_COUNT; Index++) {
+    HttpBootSplitRange (TEST_FILE_SIZE, TEST_RANGE_COUNT, Index, &mServer.Ranges[Index].Offset, &mServer.Ranges[Index].Length);
+    mServer.Ranges[Index].Connection = &mServer.Connections[Index];
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Free the simulated range server.
+
+  @param[in]  Context    Unused.
+**/
+STATIC
+VOID
+EFIAPI
+DestroyServer (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  if (mServer.File != NULL) {
+    FreePool (mServer.File);
+    mServer.File = NULL;
+  }
+
+  if (mServer.Buffer != NULL) {
+    FreePool (mServer.Buffer);
+    mServer.Buffer = NULL;
+  }
+}
+
+/**
+  Check that the download returned with every connection closed.
+
+  @retval  UNIT_TEST_PASSED             No connection is open.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A connection is left open.
+**/
+STATIC
+UNIT_TEST_STATUS
+CheckClosed (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < TEST_RANGE_COUNT; Index++) {
+    UT_ASSERT_FALSE (mServer.Connections[Index].Open);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check that the whole file is received, each byte once.
+
+  @retval  UNIT_TEST_PASSED             The buffer holds the file.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A check failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+CheckFile (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  UT_ASSERT_TRUE (mServer.Started);
+  UT_ASSERT_EQUAL (mServer.ReceivedTotal, TEST_FILE_SIZE);
+  UT_ASSERT_MEM_EQUAL (mServer.Buffer, mServer.File, TEST_FILE_SIZE);
+  for (Index = 0; Index < TEST_RANGE_COUNT; Index++) {
+    UT_ASSERT_EQUAL (mServer.Ranges[Index].ReceivedSize, mServer.Ranges[Index].Length);
+  }
+
+  return CheckClosed ();
+}
+
+/**
+  Download the file from a server which doesn't fail.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             Each range is requested once.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  A check failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TestDownloadRanges (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  UT_ASSERT_NOT_EFI_ERROR (HttpBootDownloadRanges (&mServer.Io, mServer.Ranges, TEST_RANGE_COUNT));
+  UT_ASSERT_STATUS_EQUAL (CheckFile (), UNIT_TEST_PASSED);
+
+  for (Index = 0; Index < TEST_RANGE_COUNT; Index++) {
+    UT_ASSERT_EQUAL (mServer.Connections[Index].RequestCount, 1);
+    UT_ASSERT_EQUAL (mServer.Connections[Index].RequestStart[0], mServer.Ranges[Index].Offset);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Resume the ranges whose requests fail. The response header of a resumed
+  range is received once, while resuming it.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The file is received.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  A check failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TestSendFailureResume (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  mServer.Connections[1].SendFailures = 1;
+  mServer.Connections[3].SendFailures = HTTP_BOOT_RANGE_MAX_RETRY;
+
+  UT_ASSERT_NOT_EFI_ERROR (HttpBootDownloadRanges (&mServer.Io, mServer.Ranges, TEST_RANGE_COUNT));
+  UT_ASSERT_STATUS_EQUAL (CheckFile (), UNIT_TEST_PASSED);
+
+  UT_ASSERT_EQUAL (mServer.Connections[0].RequestCount, 1);
+  UT_ASSERT_EQUAL (mServer.Connections[1].RequestCount, 1);
+  UT_ASSERT_EQUAL (mServer.Connections[3].RequestCount, 1);
+  UT_ASSERT_EQUAL (mServer.Connections[1].RequestStart[0], mServer.Ranges[1].Offset);
+  UT_ASSERT_EQUAL (mServer.Connections[3].RequestStart[0], mServer.Ranges[3].Offset);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Resume the ranges whose message-bodies fail, from the first byte they miss.
+  A range which receives data between failures may fail more than
+  HTTP_BOOT_RANGE_MAX_RETRY times in all.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The file is received.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  A check failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TestBodyFailureResume (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_CONNECTION  *Connection;
+  UINTN            Offset;
+  UINTN            Index;
+
+  //
+  // One failure in the middle of a chunk.
+  //
+  Offset                    = mServer.Ranges[1].Offset;
+  Connection                = &mServer.Connections[1];
+  Connection->BodyFailAt[0] = Offset + 2 * TEST_CHUNK_SIZE + 5;
+  Connection->BodyFailCount = 1;
+
+  //
+  // A failure on every chunk boundary, and one before the last byte.
+  //
+  Offset     = mServer.Ranges[2].Offset;
+  Connection = &mServer.Connections[2];
+  for (Index = 0; Index < HTTP_BOOT_RANGE_MAX_RETRY; Index++) {
+    Connection->BodyFailAt[Index] = Offset + Index * TEST_CHUNK_SIZE;
+  }
+
+  Connection->BodyFailAt[Index] = Offset + mServer.Ranges[2].Length - 1;
+  Connection->BodyFailCount     = HTTP_BOOT_RANGE_MAX_RETRY + 1;
+
+  UT_ASSERT_NOT_EFI_ERROR (HttpBootDownloadRanges (&mServer.Io, mServer.Ranges, TEST_RANGE_COUNT));
+  UT_ASSERT_STATUS_EQUAL (CheckFile (), UNIT_TEST_PASSED);
+
+  Connection = &mServer.Connections[1];
+  UT_ASSERT_EQUAL (Connection->RequestCount, 2);
+  UT_ASSERT_EQUAL (Connection->RequestStart[0], mServer.Ranges[1].Offset);
+  UT_ASSERT_EQUAL (Connection->RequestStart[1], mServer.Ranges[1].Offset + 2 * TEST_CHUNK_SIZE + 5);
+
+  //
+  // The failure at the start of the range resumes it from its start.
+  //
+  Connection = &mServer.Connections[2];
+  UT_ASSERT_EQUAL (Connection->RequestCount, HTTP_BOOT_RANGE_MAX_RETRY + 2);
+  UT_ASSERT_EQUAL (Connection->RequestStart[0], Offset);
+  for (Index = 0; Index < HTTP_BOOT_RANGE_MAX_RETRY; Index++) {
+    UT_ASSERT_EQUAL (Connection->RequestStart[Index + 1], Offset + Index * TEST_CHUNK_SIZE);
+  }
+
+  UT_ASSERT_EQUAL (Connection->RequestStart[Index + 1], Offset + mServer.Ranges[2].Length - 1);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Fail the download when a range fails more than HTTP_BOOT_RANGE_MAX_RETRY
+  times in a row without receiving any data.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The download fails with every connection closed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  A check failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TestRetryLimit (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_CONNECTION  *Connection;
+  UINTN            FailAt;
+  UINTN            Index;
+
+  FailAt     = mServer.Ranges[0].Offset + TEST_CHUNK_SIZE + 1;
+  Connection = &mServer.Connections[0];
+  for (Index = 0; Index <= HTTP_BOOT_RANGE_MAX_RETRY; Index++) {
+    Connection->BodyFailAt[Index] = FailAt;
+  }
+
+  Connection->BodyFailCount = HTTP_BOOT_RANGE_MAX_RETRY + 1;
+
+  UT_ASSERT_STATUS_EQUAL (HttpBootDownloadRanges (&mServer.Io, mServer.Ranges, TEST_RANGE_COUNT), EFI_CONNECTION_RESET);
+  UT_ASSERT_STATUS_EQUAL (CheckClosed (), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (Connection->RequestCount, HTTP_BOOT_RANGE_MAX_RETRY + 1);
+  UT_ASSERT_EQUAL (mServer.Ranges[0].ReceivedSize, FailAt - mServer.Ranges[0].Offset);
+  UT_ASSERT_MEM_EQUAL (mServer.Buffer, mServer.File, FailAt);
+
+  //
+  // A range whose requests keep failing fails the download before any
+  // message-body is received.
+  //
+  DestroyServer (NULL);
+  UT_ASSERT_STATUS_EQUAL (CreateServer (NULL), UNIT_TEST_PASSED);
+  mServer.Connections[2].SendFailures = HTTP_BOOT_RANGE_MAX_RETRY + 1;
+
+  UT_ASSERT_STATUS_EQUAL (HttpBootDownloadRanges (&mServer.Io, mServer.Ranges, TEST_RANGE_COUNT), EFI_CONNECTION_RESET);
+  UT_ASSERT_STATUS_EQUAL (CheckClosed (), UNIT_TEST_PASSED);
+  UT_ASSERT_FALSE (mServer.Started);
+  UT_ASSERT_EQUAL (mServer.Connections[2].SendFailures, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Give up before receiving anything when the server ignores the Range header,
+  so that the caller can download the file over a single connection.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The download is unsupported.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  A check failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TestIgnoreRange (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  mServer.IgnoreRange = TRUE;
+
+  UT_ASSERT_STATUS_EQUAL (HttpBootDownloadRanges (&mServer.Io, mServer.Ranges, TEST_RANGE_COUNT), EFI_UNSUPPORTED);
+  UT_ASSERT_STATUS_EQUAL (CheckClosed (), UNIT_TEST_PASSED);
+  UT_ASSERT_FALSE (mServer.Started);
+  UT_ASSERT_EQUAL (mServer.ReceivedTotal, 0);
+  UT_ASSERT_EQUAL (mServer.Connections[0].RequestCount, 1);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the byte
+  ranges of the HTTP boot file download and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      RangeTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&RangeTests, Framework, "HTTP Boot Range Tests", "HttpBootDxe.Range", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for HTTP Boot Range Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (RangeTests, "Ranges cover the boot file", "Split", TestSplitRange, NULL, NULL, NULL);
+  AddTestCase (RangeTests, "Resume requests the rest of the range", "Resume", TestResumeRange, NULL, NULL, NULL);
+  AddTestCase (RangeTests, "Content-Range mismatch is unsupported", "Mismatch", TestContentRangeMismatch, NULL, NULL, NULL);
+  AddTestCase (RangeTests, "Download the ranges", "Download", TestDownloadRanges, CreateServer, DestroyServer, NULL);
+  AddTestCase (RangeTests, "Resume after a request failure", "SendFailure", TestSendFailureResume, CreateServer, DestroyServer, NULL);
+  AddTestCase (RangeTests, "Resume after a message-body failure", "BodyFailure", TestBodyFailureResume, CreateServer, DestroyServer, NULL);
+  AddTestCase (RangeTests, "Retry limit fails the download", "RetryLimit", TestRetryLimit, CreateServer, DestroyServer, NULL);
+  AddTestCase (RangeTests, "Server ignoring the Range header", "IgnoreRange", TestIgnoreRange, CreateServer, DestroyServer, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+#define HttpBootRangeUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in]  Argc  Number of arguments.
+  @param[in]  Argv  Array of arguments.
+
+  @return Test application exit code.
+**/
+INT32
+HttpBootRangeUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -1,7 +1,7 @@
 /** @file
   Miscellaneous routines for HttpDxe driver.
 
-Copyright (c) 2015 - 2021, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2015 - 2026, Intel Corporation. All rights reserved.<BR>
 (C) Copyright 2016 Hewlett Packard Enterprise Development LP<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -1073,18 +1073,19 @@ HttpConfigureTcp4 (
   Tcp4AP->ActiveFlag  = TRUE;
   IP4_COPY_ADDRESS (&Tcp4AP->RemoteAddress, &HttpInstance->RemoteAddr);
 
-  Tcp4Option                    = Tcp4CfgData->ControlOption;
-  Tcp4Option->ReceiveBufferSize = HTTP_BUFFER_SIZE_DEAULT;
-  Tcp4Option->SendBufferSize    = HTTP_BUFFER_SIZE_DEAULT;
-  Tcp4Option->MaxSynBackLog     = HTTP_MAX_SYN_BACK_LOG;
-  Tcp4Option->ConnectionTimeout = HTTP_CONNECTION_TIMEOUT;
-  Tcp4Option->DataRetries       = HTTP_DATA_RETRIES;
-  Tcp4Option->FinTimeout        = HTTP_FIN_TIMEOUT;
-  Tcp4Option->KeepAliveProbes   = HTTP_KEEP_ALIVE_PROBES;
-  Tcp4Option->KeepAliveTime     = HTTP_KEEP_ALIVE_TIME;
-  Tcp4Option->KeepAliveInterval = HTTP_KEEP_ALIVE_INTERVAL;
-  Tcp4Option->EnableNagle       = TRUE;
-  Tcp4CfgData->ControlOption    = Tcp4Option;
+  Tcp4Option                     = Tcp4CfgData->ControlOption;
+  Tcp4Option->ReceiveBufferSize  = HTTP_BUFFER_SIZE_DEAULT;
+  Tcp4Option->SendBufferSize     = HTTP_BUFFER_SIZE_DEAULT;
+  Tcp4Option->MaxSynBackLog      = HTTP_MAX_SYN_BACK_LOG;
+  Tcp4Option->ConnectionTimeout  = HTTP_CONNECTION_TIMEOUT;
+  Tcp4Option->DataRetries        = HTTP_DATA_RETRIES;
+  Tcp4Option->FinTimeout         = HTTP_FIN_TIMEOUT;
+  Tcp4Option->KeepAliveProbes    = HTTP_KEEP_ALIVE_PROBES;
+  Tcp4Option->KeepAliveTime      = HTTP_KEEP_ALIVE_TIME;
+  Tcp4Option->KeepAliveInterval  = HTTP_KEEP_ALIVE_INTERVAL;
+  Tcp4Option->EnableNagle        = TRUE;
+  Tcp4Option->EnableSelectiveAck = TRUE;
+  Tcp4CfgData->ControlOption     = Tcp4Option;
 
   if ((HttpInstance->State == HTTP_STATE_TCP_CONNECTED) ||
       (HttpInstance->State == HTTP_STATE_TCP_CLOSED))
@@ -1099,6 +1100,14 @@ HttpConfigureTcp4 (
   }
 
   Status = HttpInstance->Tcp4->Configure (HttpInstance->Tcp4, Tcp4CfgData);
+  if (Status == EFI_UNSUPPORTED) {
+    //
+    // The TCP driver may not support selective acknowledgment.
+    //
+    Tcp4Option->EnableSelectiveAck = FALSE;
+    Status                         = HttpInstance->Tcp4->Configure (HttpInstance->Tcp4, Tcp4CfgData);
+  }
+
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "HttpConfigureTcp4 - %r\n", Status));
     return Status;
@@ -1156,17 +1165,18 @@ HttpConfigureTcp6 (
   IP6_COPY_ADDRESS (&Tcp6Ap->StationAddress, &HttpInstance->Ipv6Node.LocalAddress);
   IP6_COPY_ADDRESS (&Tcp6Ap->RemoteAddress, &HttpInstance->RemoteIpv6Addr);
 
-  Tcp6Option                    = Tcp6CfgData->ControlOption;
-  Tcp6Option->ReceiveBufferSize = HTTP_BUFFER_SIZE_DEAULT;
-  Tcp6Option->SendBufferSize    = HTTP_BUFFER_SIZE_DEAULT;
-  Tcp6Option->MaxSynBackLog     = HTTP_MAX_SYN_BACK_LOG;
-  Tcp6Option->ConnectionTimeout = HTTP_CONNECTION_TIMEOUT;
-  Tcp6Option->DataRetries       = HTTP_DATA_RETRIES;
-  Tcp6Option->FinTimeout        = HTTP_FIN_TIMEOUT;
-  Tcp6Option->KeepAliveProbes   = HTTP_KEEP_ALIVE_PROBES;
-  Tcp6Option->KeepAliveTime     = HTTP_KEEP_ALIVE_TIME;
-  Tcp6Option->KeepAliveInterval = HTTP_KEEP_ALIVE_INTERVAL;
-  Tcp6Option->EnableNagle       = TRUE;
+  Tcp6Option                     = Tcp6CfgData->ControlOption;
+  Tcp6Option->ReceiveBufferSize  = HTTP_BUFFER_SIZE_DEAULT;
+  Tcp6Option->SendBufferSize     = HTTP_BUFFER_SIZE_DEAULT;
+  Tcp6Option->MaxSynBackLog      = HTTP_MAX_SYN_BACK_LOG;
+  Tcp6Option->ConnectionTimeout  = HTTP_CONNECTION_TIMEOUT;
+  Tcp6Option->DataRetries        = HTTP_DATA_RETRIES;
+  Tcp6Option->FinTimeout         = HTTP_FIN_TIMEOUT;
+  Tcp6Option->KeepAliveProbes    = HTTP_KEEP_ALIVE_PROBES;
+  Tcp6Option->KeepAliveTime      = HTTP_KEEP_ALIVE_TIME;
+  Tcp6Option->KeepAliveInterval  = HTTP_KEEP_ALIVE_INTERVAL;
+  Tcp6Option->EnableNagle        = TRUE;
+  Tcp6Option->EnableSelectiveAck = TRUE;
 
   if ((HttpInstance->State == HTTP_STATE_TCP_CONNECTED) ||
       (HttpInstance->State == HTTP_STATE_TCP_CLOSED))
@@ -1181,6 +1191,14 @@ HttpConfigureTcp6 (
   }
 
   Status = HttpInstance->Tcp6->Configure (HttpInstance->Tcp6, Tcp6CfgData);
+  if (Status == EFI_UNSUPPORTED) {
+    //
+    // The TCP driver may not support selective acknowledgment.
+    //
+    Tcp6Option->EnableSelectiveAck = FALSE;
+    Status                         = HttpInstance->Tcp6->Configure (HttpInstance->Tcp6, Tcp6CfgData);
+  }
+
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "HttpConfigureTcp6 - %r\n", Status));
     return Status;
@@ -0,0 +1,98 @@
+/** @file
+  This file defines the EDKII Network Offload Protocol interface.
+
+  A network interface driver installs the protocol on the handle of its Simple
+  Network Protocol to let the network stack above it leave the TCP and UDP
+  checksums to the interface.
+
+  On transmit, once a kind of checksum is enabled with SetTxChecksum(), every
+  frame of that kind given to EFI_SIMPLE_NETWORK_PROTOCOL.Transmit() carries a
+  partial checksum: its checksum field holds the one's complement sum of the
+  pseudo header, including the length, not complemented. The interface adds
+  the transport header and payload to the sum and stores the complement. Only
+  untagged Ethernet frames of an unfragmented IPv4 datagram, or of an IPv6
+  packet without extension headers, are completed; other frames are sent as
+  they are and must carry their full checksum.
+
+  On receive, the interface records which frames returned by
+  EFI_SIMPLE_NETWORK_PROTOCOL.Receive() had their checksum validated, so the
+  stack can skip its own check of these frames.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef EDKII_NETWORK_OFFLOAD_H_
+#define EDKII_NETWORK_OFFLOAD_H_
+
+#define EDKII_NETWORK_OFFLOAD_PROTOCOL_GUID \
+  { \
+    0x8c5b5e2a, 0x3f7d, 0x4c61, {0x9b, 0x0e, 0x52, 0xd4, 0x1a, 0x77, 0xc3, 0x96} \
+  }
+
+typedef struct _EDKII_NETWORK_OFFLOAD_PROTOCOL EDKII_NETWORK_OFFLOAD_PROTOCOL;
+
+//
+// Kinds of checksum, for TxChecksum, RxChecksum and SetTxChecksum().
+//
+#define EDKII_NETWORK_OFFLOAD_TCP4  BIT0
+#define EDKII_NETWORK_OFFLOAD_UDP4  BIT1
+#define EDKII_NETWORK_OFFLOAD_TCP6  BIT2
+#define EDKII_NETWORK_OFFLOAD_UDP6  BIT3
+
+/**
+  Enable or disable the completion of partial checksums on transmit.
+
+  The transport driver that produces all the frames of a kind enables the
+  kind when it starts on the interface, and disables it when it stops.
+
+  @param[in]  This                Pointer to the EDKII_NETWORK_OFFLOAD_PROTOCOL instance.
+  @param[in]  Kinds               The kinds of checksum, EDKII_NETWORK_OFFLOAD_xxx.
+  @param[in]  Enable              TRUE to enable, FALSE to disable.
+
+  @retval EFI_SUCCESS             The kinds are enabled or disabled.
+  @retval EFI_UNSUPPORTED         A kind is not in TxChecksum.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_NETWORK_OFFLOAD_SET_TX_CHECKSUM)(
+  IN EDKII_NETWORK_OFFLOAD_PROTOCOL  *This,
+  IN UINT32                          Kinds,
+  IN BOOLEAN                         Enable
+  );
+
+/**
+  Check whether the interface validated the checksum of a received TCP or
+  UDP packet.
+
+  @param[in]  This                Pointer to the EDKII_NETWORK_OFFLOAD_PROTOCOL instance.
+  @param[in]  Header              The TCP or UDP header, in the buffer the frame
+                                  was received into.
+  @param[in]  Length              The length of the TCP or UDP header and data.
+
+  @retval TRUE                    The frame was recently received, Header is its
+                                  transport header, and its checksum is valid.
+  @retval FALSE                   The stack must check the checksum itself.
+**/
+typedef
+BOOLEAN
+(EFIAPI *EDKII_NETWORK_OFFLOAD_RX_CHECKSUM_VALID)(
+  IN EDKII_NETWORK_OFFLOAD_PROTOCOL  *This,
+  IN CONST VOID                      *Header,
+  IN UINTN                           Length
+  );
+
+///
+/// EDKII Network Offload Protocol, installed next to the Simple Network
+/// Protocol of an interface that can compute or validate checksums.
+///
+struct _EDKII_NETWORK_OFFLOAD_PROTOCOL {
+  UINT32                                     TxChecksum; ///< The kinds completed on transmit.
+  UINT32                                     RxChecksum; ///< The kinds validated on receive.
+  EDKII_NETWORK_OFFLOAD_SET_TX_CHECKSUM      SetTxChecksum;
+  EDKII_NETWORK_OFFLOAD_RX_CHECKSUM_VALID    RxChecksumValid;
+};
+
+extern EFI_GUID  gEdkiiNetworkOffloadProtocolGuid;
+
+#endif /* EDKII_NETWORK_OFFLOAD_H_ */
@@ -0,0 +1,83 @@
+/** @file
+  This file defines the EDKII Network Rx Buffer Protocol interface.
+
+  A network interface driver installs the protocol on the handle of its Simple
+  Network Protocol to lend the frames it received, in its own receive buffers,
+  instead of copying them into the caller's buffer as
+  EFI_SIMPLE_NETWORK_PROTOCOL.Receive() does.
+
+  A frame on loan is not handed back to the device until it is returned, so
+  the interface lends only part of its receive buffers; when they are all on
+  loan, the caller falls back to EFI_SIMPLE_NETWORK_PROTOCOL.Receive(). The
+  two receive paths take the frames from the same queue and can be mixed.
+
+  The frames stay valid until they are returned, even after the interface is
+  shut down. All the frames must be returned before the Simple Network
+  Protocol is closed.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef EDKII_NETWORK_RX_BUFFER_H_
+#define EDKII_NETWORK_RX_BUFFER_H_
+
+#define EDKII_NETWORK_RX_BUFFER_PROTOCOL_GUID \
+  { \
+    0x5d0e7b61, 0x92c4, 0x4f3a, {0xa8, 0x1d, 0x6e, 0x3b, 0xc0, 0x47, 0x9f, 0x28} \
+  }
+
+typedef struct _EDKII_NETWORK_RX_BUFFER_PROTOCOL EDKII_NETWORK_RX_BUFFER_PROTOCOL;
+
+/**
+  Receive a frame without copying it.
+
+  @param[in]   This               Pointer to the EDKII_NETWORK_RX_BUFFER_PROTOCOL instance.
+  @param[out]  Frame              The frame, starting with the media header, in the
+                                  receive buffer of the interface.
+  @param[out]  FrameSize          The size of the frame, in bytes, at least the media
+                                  header size.
+
+  @retval EFI_SUCCESS             The frame is on loan until it is returned.
+  @retval EFI_NOT_READY           No frame is received.
+  @retval EFI_OUT_OF_RESOURCES    Too many frames are on loan. The frame is kept,
+                                  EFI_SIMPLE_NETWORK_PROTOCOL.Receive() can copy it.
+  @retval EFI_NOT_STARTED         The network interface has not been started.
+  @retval EFI_DEVICE_ERROR        The network interface is not initialized, or a
+                                  malformed frame is dropped.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_NETWORK_RX_BUFFER_RECEIVE)(
+  IN  EDKII_NETWORK_RX_BUFFER_PROTOCOL  *This,
+  OUT VOID                              **Frame,
+  OUT UINTN                             *FrameSize
+  );
+
+/**
+  Return a frame on loan to the interface, so the buffer receives again.
+
+  This function may be called at TPL_NOTIFY.
+
+  @param[in]  This                Pointer to the EDKII_NETWORK_RX_BUFFER_PROTOCOL instance.
+  @param[in]  Frame               The frame returned by Receive().
+**/
+typedef
+VOID
+(EFIAPI *EDKII_NETWORK_RX_BUFFER_RETURN)(
+  IN EDKII_NETWORK_RX_BUFFER_PROTOCOL  *This,
+  IN VOID                              *Frame
+  );
+
+///
+/// EDKII Network Rx Buffer Protocol, installed next to the Simple Network
+/// Protocol of an interface that can lend its received frames.
+///
+struct _EDKII_NETWORK_RX_BUFFER_PROTOCOL {
+  EDKII_NETWORK_RX_BUFFER_RECEIVE    Receive;
+  EDKII_NETWORK_RX_BUFFER_RETURN     Return;
+};
+
+extern EFI_GUID  gEdkiiNetworkRxBufferProtocolGuid;
+
+#endif /* EDKII_NETWORK_RX_BUFFER_H_ */
@@ -1,7 +1,7 @@
 /** @file
   Network library functions providing net buffer operation support.
 
-Copyright (c) 2005 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2005 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
@@ -1604,6 +1604,11 @@ NetbufQueFlush (
 /**
   Compute the checksum for a bulk of data.
 
+  The one's complement sum of 32-bit words folds to the one's complement sum
+  of their 16-bit halves, so the aligned part of the data is summed four
+  bytes at a time into a 64-bit accumulator, which doesn't overflow for any
+  length a UINT32 can hold.
+
   @param[in]   Bulk                  Pointer to the data.
   @param[in]   Len                   Length of the data, in bytes.
 
@@ -1617,7 +1622,8 @@ NetblockChecksum (
   IN UINT32  Len
   )
 {
-  register UINT32  Sum;
+  UINT64  Sum;
+  UINT32  *Word;
 
   Sum = 0;
 
@@ -1628,6 +1634,34 @@ NetblockChecksum (
     Sum += *(Bulk + Len - 1);
   }
 
+  //
+  // An odd address is left to the 16-bit loop, the words of the data
+  // don't line up with any aligned word.
+  //
+  if (((UINTN)Bulk & 0x01) == 0) {
+    if ((((UINTN)Bulk & 0x02) != 0) && (Len > 1)) {
+      Sum  += *(UINT16 *)Bulk;
+      Bulk += 2;
+      Len  -= 2;
+    }
+
+    Word = (UINT32 *)Bulk;
+
+    while (Len >= 16) {
+      Sum  += (UINT64)Word[0] + Word[1] + Word[2] + Word[3];
+      Word += 4;
+      Len  -= 16;
+    }
+
+    while (Len >= 4) {
+      Sum += *Word;
+      Word++;
+      Len -= 4;
+    }
+
+    Bulk = (UINT8 *)Word;
+  }
+
   while (Len > 1) {
     Sum  += *(UINT16 *)Bulk;
     Bulk += 2;
@@ -1635,7 +1669,7 @@ NetblockChecksum (
   }
 
   //
-  // Fold 32-bit sum to 16 bits
+  // Fold 64-bit sum to 16 bits
   //
   while ((Sum >> 16) != 0) {
     Sum = (Sum & 0xffff) + (Sum >> 16);
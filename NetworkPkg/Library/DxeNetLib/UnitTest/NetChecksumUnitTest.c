@@ -0,0 +1,375 @@
+/** @file
+  Unit tests and benchmark of the Internet checksum routines of DxeNetLib.
+
+  NetblockChecksum and NetbufChecksum are checked against a byte by byte
+  reference on random data, lengths and alignments, then NetblockChecksum is
+  timed against the 16-bit loop it replaced.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/NetLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/UnitTestBenchmarkLib.h>
+
+#define UNIT_TEST_APP_NAME     "DxeNetLib Checksum Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_BUFFER_SIZE       4096
+#define TEST_RANDOM_ROUNDS     20000
+#define TEST_NETBUF_ROUNDS     2000
+#define TEST_MAX_FRAGMENTS     8
+#define TEST_BENCH_PACKET      1500
+#define TEST_BENCH_ROUNDS      200000
+
+STATIC UINT8  mData[TEST_BUFFER_SIZE + 8];
+
+/**
+  NetBuffer.c is built alone, without DxeNetLib.c and the UEFI services it
+  needs. Its queue routines use this one list helper of DxeNetLib.c.
+
+  @param[in, out]  Head  The list header.
+
+  @return The first node entry that is removed from the list, NULL if the list is empty.
+**/
+LIST_ENTRY *
+EFIAPI
+NetListRemoveHead (
+  IN OUT LIST_ENTRY  *Head
+  )
+{
+  LIST_ENTRY  *First;
+
+  if (IsListEmpty (Head)) {
+    return NULL;
+  }
+
+  First = Head->ForwardLink;
+  RemoveEntryList (First);
+  return First;
+}
+
+/**
+  Compute the checksum of the data one byte at a time, in the byte order
+  NetblockChecksum uses.
+
+  @param[in]  Bulk  Pointer to the data.
+  @param[in]  Len   Length of the data, in bytes.
+
+  @return The checksum.
+**/
+STATIC
+UINT16
+ReferenceChecksum (
+  IN CONST UINT8  *Bulk,
+  IN UINT32       Len
+  )
+{
+  UINT32  Sum;
+  UINT32  Index;
+
+  Sum = 0;
+  for (Index = 0; Index < Len; Index++) {
+    Sum += ((Index & 0x01) == 0) ? Bulk[Index] : (UINT32)Bulk[Index] << 8;
+    Sum  = (Sum & 0xffff) + (Sum >> 16);
+  }
+
+  return (UINT16)Sum;
+}
+
+/**
+  The 16-bit loop NetblockChecksum used before, kept as the baseline of the
+  benchmark.
+
+  @param[in]  Bulk  Pointer to the data.
+  @param[in]  Len   Length of the data, in bytes.
+
+  @return The checksum.
+**/
+STATIC
+UINT16
+Checksum16 (
+  IN CONST UINT8  *Bulk,
+  IN UINT32       Len
+  )
+{
+  UINT32  Sum;
+
+  Sum = 0;
+  if (Len % 2 != 0) {
+    Sum += *(Bulk + Len - 1);
+  }
+
+  while (Len > 1) {
+    Sum  += *(CONST UINT16 *)Bulk;
+    Bulk += 2;
+    Len  -= 2;
+  }
+
+  while ((Sum >> 16) != 0) {
+    Sum = (Sum & 0xffff) + (Sum >> 16);
+  }
+
+  return (UINT16)Sum;
+}
+
+/**
+  Free callback of the external fragments, they belong to the test.
+
+  @param[in]  Arg  Unused.
+**/
+STATIC
+VOID
+EFIAPI
+TestFreeFragments (
+  IN VOID  *Arg
+  )
+{
+}
+
+/**
+  NetblockChecksum matches the reference for any length and alignment.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED  The checksums match.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TestBlockChecksum (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32  Seed;
+  UINT32  Index;
+  UINT32  Round;
+  UINT32  Offset;
+  UINT32  Len;
+
+  Seed = 0x5EED;
+  for (Index = 0; Index < sizeof (mData); Index++) {
+    mData[Index] = (UINT8)UnitTestRandom (&Seed);
+  }
+
+  //
+  // Every short length at every alignment, then random ones.
+  //
+  for (Offset = 0; Offset < 8; Offset++) {
+    for (Len = 0; Len <= 64; Len++) {
+      UT_ASSERT_EQUAL (NetblockChecksum (mData + Offset, Len), ReferenceChecksum (mData + Offset, Len));
+    }
+  }
+
+  for (Round = 0; Round < TEST_RANDOM_ROUNDS; Round++) {
+    Offset = UnitTestRandom (&Seed) % 8;
+    Len    = UnitTestRandom (&Seed) % (TEST_BUFFER_SIZE + 1);
+    UT_ASSERT_EQUAL (NetblockChecksum (mData + Offset, Len), ReferenceChecksum (mData + Offset, Len));
+  }
+
+  //
+  // All ones is the worst case of the carries.
+  //
+  SetMem (mData, sizeof (mData), 0xFF);
+  for (Offset = 0; Offset < 8; Offset++) {
+    UT_ASSERT_EQUAL (NetblockChecksum (mData + Offset, TEST_BUFFER_SIZE - 1), ReferenceChecksum (mData + Offset, TEST_BUFFER_SIZE - 1));
+    UT_ASSERT_EQUAL (NetblockChecksum (mData + Offset, TEST_BUFFER_SIZE), 0xFFFF);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  NetbufChecksum of data split in fragments of any size matches the reference
+  on the whole data.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED  The checksums match.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TestNetbufChecksum (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32          Seed;
+  UINT32          Index;
+  UINT32          Round;
+  UINT32          Count;
+  UINT32          Len;
+  UINT32          Start;
+  NET_FRAGMENT    Fragment[TEST_MAX_FRAGMENTS];
+  NET_BUF         *Nbuf;
+
+  Seed = 0xC0FFEE;
+  for (Index = 0; Index < sizeof (mData); Index++) {
+    mData[Index] = (UINT8)UnitTestRandom (&Seed);
+  }
+
+  for (Round = 0; Round < TEST_NETBUF_ROUNDS; Round++) {
+    Count = UnitTestRandom (&Seed) % TEST_MAX_FRAGMENTS + 1;
+    Start = UnitTestRandom (&Seed) % 8;
+    Len   = 0;
+
+    for (Index = 0; Index < Count; Index++) {
+      Fragment[Index].Bulk = mData + Start + Len;
+      Fragment[Index].Len  = UnitTestRandom (&Seed) % ((TEST_BUFFER_SIZE - 8) / TEST_MAX_FRAGMENTS) + 1;
+      Len                 += Fragment[Index].Len;
+    }
+
+    Nbuf = NetbufFromExt (Fragment, Count, 0, 0, TestFreeFragments, NULL);
+    UT_ASSERT_NOT_NULL (Nbuf);
+    UT_ASSERT_EQUAL (Nbuf->TotalSize, Len);
+    UT_ASSERT_EQUAL (NetbufChecksum (Nbuf), ReferenceChecksum (mData + Start, Len));
+    NetbufFree (Nbuf);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Time NetblockChecksum against the 16-bit loop on Ethernet sized packets.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED  Both give the same checksum.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TestChecksumBenchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32   Seed;
+  UINT32   Index;
+  UINT32   Round;
+  UINT64   Start;
+  UINT64   OldNs;
+  UINT64   NewNs;
+  UINT64   Bytes;
+  UINT32   OldSum;
+  UINT32   NewSum;
+
+  Seed = 0xBE7C;
+  for (Index = 0; Index < sizeof (mData); Index++) {
+    mData[Index] = (UINT8)UnitTestRandom (&Seed);
+  }
+
+  Bytes  = (UINT64)TEST_BENCH_ROUNDS * TEST_BENCH_PACKET;
+  OldSum = 0;
+  NewSum = 0;
+
+  //
+  // The offset of the TCP header in an Ethernet frame is a multiple of 2.
+  //
+  Start = UnitTestBenchmarkStart ();
+  for (Round = 0; Round < TEST_BENCH_ROUNDS; Round++) {
+    OldSum += Checksum16 (mData + (Round & 0x06), TEST_BENCH_PACKET);
+  }
+
+  OldNs = UnitTestBenchmarkStop (Start);
+
+  Start = UnitTestBenchmarkStart ();
+  for (Round = 0; Round < TEST_BENCH_ROUNDS; Round++) {
+    NewSum += NetblockChecksum (mData + (Round & 0x06), TEST_BENCH_PACKET);
+  }
+
+  NewNs = UnitTestBenchmarkStop (Start);
+
+  UT_ASSERT_EQUAL (OldSum, NewSum);
+
+  UT_LOG_INFO (
+    "Checksum of %d byte packets: 16-bit loop %ld MB/s, NetblockChecksum %ld MB/s\n",
+    TEST_BENCH_PACKET,
+    UnitTestBenchmarkRate (Bytes, OldNs) / 1000000,
+    UnitTestBenchmarkRate (Bytes, NewNs) / 1000000
+    );
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the checksum
+  routines and run them.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      ChecksumTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&ChecksumTests, Framework, "Checksum Tests", "DxeNetLib.Checksum", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Checksum Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (ChecksumTests, "NetblockChecksum matches the reference", "Block", TestBlockChecksum, NULL, NULL, NULL);
+  AddTestCase (ChecksumTests, "NetbufChecksum matches the reference", "Netbuf", TestNetbufChecksum, NULL, NULL, NULL);
+  AddTestCase (ChecksumTests, "NetblockChecksum throughput", "Benchmark", TestChecksumBenchmark, NULL, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+#define NetChecksumUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in]  Argc  Number of arguments.
+  @param[in]  Argv  Array of arguments.
+
+  @return Test application exit code.
+**/
+INT32
+NetChecksumUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -1,7 +1,7 @@
 /** @file
   Implementation of Managed Network Protocol private services.
 
-Copyright (c) 2005 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2005 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -181,7 +181,12 @@ MnpFreeNbuf (
 
   NET_PUT_REF (Nbuf);
 
-  if (Nbuf->RefCnt == 1) {
+  if ((Nbuf->RefCnt == 1) && (Nbuf->Vector->Free != NULL)) {
+    //
+    // The Nbuf wraps a frame on loan from SNP, free it to return the frame.
+    //
+    NetbufFree (Nbuf);
+  } else if (Nbuf->RefCnt == 1) {
     //
     // Trim all buffer contained in the Nbuf, then append it to the NbufQue.
     //
@@ -457,6 +462,21 @@ MnpInitializeDeviceData (
   SnpMode            = Snp->Mode;
   MnpDeviceData->Snp = Snp;
 
+  //
+  // Receive without copying if SNP can lend its frames.
+  //
+  Status = gBS->OpenProtocol (
+                  ControllerHandle,
+                  &gEdkiiNetworkRxBufferProtocolGuid,
+                  (VOID **)&MnpDeviceData->RxBuffer,
+                  ImageHandle,
+                  ControllerHandle,
+                  EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                  );
+  if (EFI_ERROR (Status)) {
+    MnpDeviceData->RxBuffer = NULL;
+  }
+
   //
   // Initialize the lists.
   //
@@ -512,6 +532,9 @@ MnpInitializeDeviceData (
   InitializeListHead (&MnpDeviceData->AllTxBufList);
   MnpDeviceData->TxBufCount = 0;
 
+  InitializeListHead (&MnpDeviceData->PendingTxList);
+  MnpDeviceData->PendingTxCount = 0;
+
   //
   // Create the system poll timer.
   //
@@ -641,6 +664,11 @@ MnpDestroyDeviceData (
   gBS->CloseEvent (MnpDeviceData->MediaDetectTimer);
   gBS->CloseEvent (MnpDeviceData->PollTimer);
 
+  //
+  // The pending transmit queue is flushed when SNP stops.
+  //
+  ASSERT (IsListEmpty (&MnpDeviceData->PendingTxList));
+
   //
   // Free the Tx buffer pool.
   //
@@ -1151,6 +1179,23 @@ MnpStopSnp (
   Snp = MnpDeviceData->Snp;
   ASSERT (Snp != NULL);
 
+  //
+  // Abort the packets still waiting for room in SNP.
+  //
+  MnpCancelPendingTx (NULL, MnpDeviceData, NULL);
+
+  //
+  // Report the copies per byte of the receive path.
+  //
+  DEBUG (
+    (DEBUG_INFO,
+     "MnpStopSnp: %Lu bytes delivered, %Lu bytes copied.\n",
+     MnpDeviceData->RxDeliveredBytes,
+     MnpDeviceData->RxCopiedBytes)
+    );
+  MnpDeviceData->RxDeliveredBytes = 0;
+  MnpDeviceData->RxCopiedBytes    = 0;
+
   //
   // Recycle all the transmit buffer from SNP.
   //
@@ -1273,6 +1318,8 @@ MnpStart (
     }
 
     MnpDeviceData->EnableSystemPoll = EnableSystemPoll;
+    MnpDeviceData->PollInterval     = MNP_SYS_POLL_INTERVAL;
+    MnpDeviceData->IdlePollCount    = 0;
   }
 
   //
@@ -1,7 +1,7 @@
 /** @file
   Declaration of structures and functions for MnpDxe driver.
 
-Copyright (c) 2005 - 2016, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2005 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -12,6 +12,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Uefi.h>
 
 #include <Protocol/ManagedNetwork.h>
+#include <Protocol/NetworkRxBuffer.h>
 #include <Protocol/SimpleNetwork.h>
 #include <Protocol/ServiceBinding.h>
 #include <Protocol/VlanConfig.h>
@@ -38,53 +39,77 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 extern  EFI_DRIVER_BINDING_PROTOCOL  gMnpDriverBinding;
 
 typedef struct {
-  UINT32                         Signature;
+  UINT32                            Signature;
 
-  EFI_HANDLE                     ControllerHandle;
-  EFI_HANDLE                     ImageHandle;
+  EFI_HANDLE                        ControllerHandle;
+  EFI_HANDLE                        ImageHandle;
 
-  EFI_VLAN_CONFIG_PROTOCOL       VlanConfig;
-  UINTN                          NumberOfVlan;
-  CHAR16                         *MacString;
-  EFI_SIMPLE_NETWORK_PROTOCOL    *Snp;
+  EFI_VLAN_CONFIG_PROTOCOL          VlanConfig;
+  UINTN                             NumberOfVlan;
+  CHAR16                            *MacString;
+  EFI_SIMPLE_NETWORK_PROTOCOL       *Snp;
+  //
+  // Lends the frames received by SNP, NULL if SNP can't.
+  //
+  EDKII_NETWORK_RX_BUFFER_PROTOCOL  *RxBuffer;
 
   //
   // List of MNP_SERVICE_DATA
   //
-  LIST_ENTRY                     ServiceList;
+  LIST_ENTRY                        ServiceList;
   //
   // Number of configured MNP Service Binding child
   //
-  UINTN                          ConfiguredChildrenNumber;
+  UINTN                             ConfiguredChildrenNumber;
+
+  LIST_ENTRY                        GroupAddressList;
+  UINT32                            GroupAddressCount;
 
-  LIST_ENTRY                     GroupAddressList;
-  UINT32                         GroupAddressCount;
+  LIST_ENTRY                        FreeTxBufList;
+  LIST_ENTRY                        AllTxBufList;
+  UINT32                            TxBufCount;
 
-  LIST_ENTRY                     FreeTxBufList;
-  LIST_ENTRY                     AllTxBufList;
-  UINT32                         TxBufCount;
+  //
+  // List of MNP_TX_PENDING, the packets SNP had no room for. They are
+  // transmitted in order by the poll, which then signals their tokens.
+  //
+  LIST_ENTRY                        PendingTxList;
+  UINT32                            PendingTxCount;
 
-  NET_BUF_QUEUE                  FreeNbufQue;
-  INTN                           NbufCnt;
+  NET_BUF_QUEUE                     FreeNbufQue;
+  INTN                              NbufCnt;
 
-  EFI_EVENT                      PollTimer;
-  BOOLEAN                        EnableSystemPoll;
+  EFI_EVENT                         PollTimer;
+  BOOLEAN                           EnableSystemPoll;
+  //
+  // The current period of PollTimer, shortened while packets flow and
+  // lengthened after IdlePollCount polls in a row find nothing to do.
+  //
+  UINT64                            PollInterval;
+  UINT32                            IdlePollCount;
 
-  EFI_EVENT                      TimeoutCheckTimer;
-  EFI_EVENT                      MediaDetectTimer;
+  EFI_EVENT                         TimeoutCheckTimer;
+  EFI_EVENT                         MediaDetectTimer;
 
-  UINT32                         UnicastCount;
-  UINT32                         BroadcastCount;
-  UINT32                         MulticastCount;
-  UINT32                         PromiscuousCount;
+  UINT32                            UnicastCount;
+  UINT32                            BroadcastCount;
+  UINT32                            MulticastCount;
+  UINT32                            PromiscuousCount;
 
   //
   // The size of the data buffer in the MNP_PACKET_BUFFER used to
   // store a packet.
   //
-  UINT32                         BufferLength;
-  UINT32                         PaddingSize;
-  NET_BUF                        *RxNbufCache;
+  UINT32                            BufferLength;
+  UINT32                            PaddingSize;
+  NET_BUF                           *RxNbufCache;
+
+  //
+  // The bytes of the received packets delivered to the instances, and the
+  // bytes copied to deliver them, reported when SNP stops.
+  //
+  UINT64                            RxDeliveredBytes;
+  UINT64                            RxCopiedBytes;
 } MNP_DEVICE_DATA;
 
 #define MNP_DEVICE_DATA_FROM_THIS(a) \
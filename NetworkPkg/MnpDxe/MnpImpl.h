@@ -1,7 +1,7 @@
 /** @file
   Declaration of structures and functions of MnpDxe driver.
 
-Copyright (c) 2005 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2005 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -13,7 +13,10 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define NET_ETHER_FCS_SIZE  4
 
-#define MNP_SYS_POLL_INTERVAL        (10 * TICKS_PER_MS)    // 10 milliseconds
+#define MNP_SYS_POLL_INTERVAL        (10 * TICKS_PER_MS)    // 10 milliseconds, when idle
+#define MNP_SYS_POLL_INTERVAL_MIN    (1 * TICKS_PER_MS)     // 1 millisecond, while packets flow
+#define MNP_SYS_POLL_IDLE_COUNT      8      // Idle polls before the poll interval is doubled.
+#define MNP_RX_BATCH_SIZE            32     // Max packets received by one system poll.
 #define MNP_TIMEOUT_CHECK_INTERVAL   (50 * TICKS_PER_MS)    // 50 milliseconds
 #define MNP_MEDIA_DETECT_INTERVAL    (500 * TICKS_PER_MS)   // 500 milliseconds
 #define MNP_TX_TIMEOUT_TIME          (500 * TICKS_PER_MS)   // 500 milliseconds
@@ -22,6 +25,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define MNP_MAX_NET_BUFFER_NUM       65536
 #define MNP_TX_BUFFER_INCREASEMENT   32     // Same as the recycling Q length for xmit_done in UNDI command.
 #define MNP_MAX_TX_BUFFER_NUM        65536
+#define MNP_MAX_PENDING_TX_NUM       64     // Max packets waiting for room in the SNP transmit queue.
 
 #define MNP_MAX_RCVD_PACKET_QUE_SIZE  256
 
@@ -97,6 +101,21 @@ typedef struct {
   UINT8         TxBuf[1];
 } MNP_TX_BUF_WRAP;
 
+typedef struct {
+  LIST_ENTRY                              Link;           // Link to PendingTxList
+  MNP_INSTANCE_DATA                       *Instance;
+  EFI_MANAGED_NETWORK_COMPLETION_TOKEN    *Token;
+  UINT8                                   *Packet;        // Start of the TX buffer
+  UINT32                                  Length;
+  UINTN                                   HeaderSize;
+  UINT16                                  ProtocolType;
+} MNP_TX_PENDING;
+
+typedef struct {
+  MNP_DEVICE_DATA    *MnpDeviceData;
+  VOID               *Frame;                // The frame on loan from SNP
+} MNP_RX_LOAN;
+
 /**
   Initialize the mnp device context data.
 
@@ -359,30 +378,102 @@ MnpBuildTxPacket (
   );
 
 /**
-  Synchronously send out the packet.
+  Send out the packet.
 
   This function places the packet buffer to SNP driver's tansmit queue. The packet
   can be considered successfully sent out once SNP accept the packet, while the
-  packet buffer recycle is deferred for better performance.
+  packet buffer recycle is deferred for better performance. If the SNP transmit
+  queue is full, the packet waits in the pending transmit queue and the token is
+  signaled once the poll hands the packet to SNP.
 
-  @param[in]       MnpServiceData      Pointer to the mnp service context data.
+  @param[in]       Instance            Pointer to the mnp instance context data.
   @param[in]       Packet              Pointer to the packet buffer.
   @param[in]       Length              The length of the packet.
   @param[in, out]  Token               Pointer to the token the packet generated from.
 
-  @retval EFI_SUCCESS                  The packet is sent out.
-  @retval EFI_TIMEOUT                  Time out occurs, the packet isn't sent.
-  @retval EFI_DEVICE_ERROR             An unexpected network error occurs.
+  @retval EFI_SUCCESS                  The packet is sent out or queued, the token
+                                       is or will be signaled.
+  @retval EFI_NOT_READY                The pending transmit queue is full.
+  @retval EFI_OUT_OF_RESOURCES         Failed to queue the packet.
 
 **/
 EFI_STATUS
-MnpSyncSendPacket (
-  IN     MNP_SERVICE_DATA                      *MnpServiceData,
+MnpSendPacket (
+  IN     MNP_INSTANCE_DATA                     *Instance,
   IN     UINT8                                 *Packet,
   IN     UINT32                                Length,
   IN OUT EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Token
   );
 
+/**
+  Hand the packets in the pending transmit queue to SNP, in order, until SNP
+  runs out of room again, and signal their tokens.
+
+  @param[in, out]  MnpDeviceData       Pointer to the mnp device context data.
+
+  @return The number of tokens signaled.
+
+**/
+UINTN
+MnpTransmitPending (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData
+  );
+
+/**
+  Check whether a transmit token is in the pending transmit queue.
+
+  @param[in]  MnpDeviceData           Pointer to the mnp device context data.
+  @param[in]  Token                   Pointer to the token to look for.
+
+  @retval TRUE                        The token, or a token with the same event,
+                                      is pending.
+  @retval FALSE                       The token is not pending.
+
+**/
+BOOLEAN
+MnpIsTxTokenPending (
+  IN MNP_DEVICE_DATA                       *MnpDeviceData,
+  IN EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Token
+  );
+
+/**
+  Abort the pending transmit tokens of an instance.
+
+  @param[in]  Instance                Pointer to the mnp instance context data,
+                                      or NULL for all the instances.
+  @param[in]  MnpDeviceData           Pointer to the mnp device context data.
+  @param[in]  Token                   Pointer to the token to abort, or NULL for
+                                      all the tokens.
+
+  @retval EFI_SUCCESS                 Token is NULL and the tokens are aborted, or
+                                      Token is not pending.
+  @retval EFI_ABORTED                 Token is aborted.
+
+**/
+EFI_STATUS
+MnpCancelPendingTx (
+  IN MNP_INSTANCE_DATA                     *Instance OPTIONAL,
+  IN MNP_DEVICE_DATA                       *MnpDeviceData,
+  IN EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Token OPTIONAL
+  );
+
+/**
+  Adapt the period of the system poll timer to the traffic.
+
+  The period drops to MNP_SYS_POLL_INTERVAL_MIN as soon as packets flow, and
+  doubles up to MNP_SYS_POLL_INTERVAL after MNP_SYS_POLL_IDLE_COUNT polls in
+  a row found nothing to do.
+
+  @param[in, out]  MnpDeviceData       Pointer to the mnp device context data.
+  @param[in]       Busy                TRUE if packets were received or sent.
+
+**/
+VOID
+MnpUpdatePollInterval (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  IN     BOOLEAN          Busy
+  );
+
 /**
   Try to deliver the received packet to the instance.
 
@@ -475,6 +566,19 @@ MnpAllocTxBuf (
   IN OUT MNP_DEVICE_DATA  *MnpDeviceData
   );
 
+/**
+  Try to reclaim the TX buffer into the buffer pool.
+
+  @param[in, out]  MnpDeviceData         Pointer to the mnp device context data.
+  @param[in, out]  TxBuf                 Pointer to the TX buffer to free.
+
+**/
+VOID
+MnpFreeTxBuf (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  IN OUT UINT8            *TxBuf
+  );
+
 /**
   Try to recycle all the transmitted buffer address from SNP.
 
@@ -518,8 +622,8 @@ MnpCheckMediaStatus (
   );
 
 /**
-  Poll to receive the packets from Snp. This function is either called by upperlayer
-  protocols/applications or the system poll timer notify mechanism.
+  Poll to receive the packets from Snp and transmit the pending packets. This
+  function is called by the system poll timer notify mechanism.
 
   @param[in]  Event        The event this notify function registered to.
   @param[in]  Context      Pointer to the context data registered to the event.
@@ -1,7 +1,7 @@
 /** @file
   Implementation of Managed Network Protocol I/O functions.
 
-Copyright (c) 2005 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2005 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -186,25 +186,85 @@ MnpBuildTxPacket (
 }
 
 /**
-  Synchronously send out the packet.
+  Queue the packet until SNP has room for it.
+
+  @param[in]       Instance            Pointer to the mnp instance context data.
+  @param[in]       Packet              Pointer to the packet buffer, the start of
+                                       the TX buffer.
+  @param[in]       Length              The length of the packet.
+  @param[in]       HeaderSize          The media header size to pass to SNP.
+  @param[in]       ProtocolType        The protocol type to pass to SNP.
+  @param[in]       Token               Pointer to the token the packet generated from.
+
+  @retval EFI_SUCCESS                  The packet is queued.
+  @retval EFI_NOT_READY                The pending transmit queue is full.
+  @retval EFI_OUT_OF_RESOURCES         Failed to allocate the queue entry.
+
+**/
+STATIC
+EFI_STATUS
+MnpQueuePendingTx (
+  IN MNP_INSTANCE_DATA                     *Instance,
+  IN UINT8                                 *Packet,
+  IN UINT32                                Length,
+  IN UINTN                                 HeaderSize,
+  IN UINT16                                ProtocolType,
+  IN EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Token
+  )
+{
+  MNP_DEVICE_DATA  *MnpDeviceData;
+  MNP_TX_PENDING   *Pending;
+
+  MnpDeviceData = Instance->MnpServiceData->MnpDeviceData;
+
+  if (MnpDeviceData->PendingTxCount >= MNP_MAX_PENDING_TX_NUM) {
+    DEBUG ((DEBUG_WARN, "MnpQueuePendingTx: The pending transmit queue is full.\n"));
+    MnpFreeTxBuf (MnpDeviceData, Packet);
+    return EFI_NOT_READY;
+  }
+
+  Pending = AllocatePool (sizeof (MNP_TX_PENDING));
+  if (Pending == NULL) {
+    MnpFreeTxBuf (MnpDeviceData, Packet);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Pending->Instance     = Instance;
+  Pending->Token        = Token;
+  Pending->Packet       = Packet;
+  Pending->Length       = Length;
+  Pending->HeaderSize   = HeaderSize;
+  Pending->ProtocolType = ProtocolType;
+
+  InsertTailList (&MnpDeviceData->PendingTxList, &Pending->Link);
+  MnpDeviceData->PendingTxCount++;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Send out the packet.
 
   This function places the packet buffer to SNP driver's tansmit queue. The packet
   can be considered successfully sent out once SNP accept the packet, while the
-  packet buffer recycle is deferred for better performance.
+  packet buffer recycle is deferred for better performance. If the SNP transmit
+  queue is full, the packet waits in the pending transmit queue and the token is
+  signaled once the poll hands the packet to SNP.
 
-  @param[in]       MnpServiceData      Pointer to the mnp service context data.
+  @param[in]       Instance            Pointer to the mnp instance context data.
   @param[in]       Packet              Pointer to the packet buffer.
   @param[in]       Length              The length of the packet.
   @param[in, out]  Token               Pointer to the token the packet generated from.
 
-  @retval EFI_SUCCESS                  The packet is sent out.
-  @retval EFI_TIMEOUT                  Time out occurs, the packet isn't sent.
-  @retval EFI_DEVICE_ERROR             An unexpected network error occurs.
+  @retval EFI_SUCCESS                  The packet is sent out or queued, the token
+                                       is or will be signaled.
+  @retval EFI_NOT_READY                The pending transmit queue is full.
+  @retval EFI_OUT_OF_RESOURCES         Failed to queue the packet.
 
 **/
 EFI_STATUS
-MnpSyncSendPacket (
-  IN     MNP_SERVICE_DATA                      *MnpServiceData,
+MnpSendPacket (
+  IN     MNP_INSTANCE_DATA                     *Instance,
   IN     UINT8                                 *Packet,
   IN     UINT32                                Length,
   IN OUT EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Token
@@ -214,14 +274,16 @@ MnpSyncSendPacket (
   EFI_SIMPLE_NETWORK_PROTOCOL        *Snp;
   EFI_MANAGED_NETWORK_TRANSMIT_DATA  *TxData;
   UINT32                             HeaderSize;
+  MNP_SERVICE_DATA                   *MnpServiceData;
   MNP_DEVICE_DATA                    *MnpDeviceData;
   UINT16                             ProtocolType;
 
-  MnpDeviceData = MnpServiceData->MnpDeviceData;
-  Snp           = MnpDeviceData->Snp;
-  TxData        = Token->Packet.TxData;
-  Token->Status = EFI_SUCCESS;
-  HeaderSize    = Snp->Mode->MediaHeaderSize - TxData->HeaderLength;
+  MnpServiceData = Instance->MnpServiceData;
+  MnpDeviceData  = MnpServiceData->MnpDeviceData;
+  Snp            = MnpDeviceData->Snp;
+  TxData         = Token->Packet.TxData;
+  Token->Status  = EFI_SUCCESS;
+  HeaderSize     = Snp->Mode->MediaHeaderSize - TxData->HeaderLength;
 
   //
   // Check media status before transmit packet.
@@ -231,7 +293,7 @@ MnpSyncSendPacket (
     //
     // Media not present, skip packet transmit and report EFI_NO_MEDIA
     //
-    DEBUG ((DEBUG_WARN, "MnpSyncSendPacket: No network cable detected.\n"));
+    DEBUG ((DEBUG_WARN, "MnpSendPacket: No network cable detected.\n"));
     Token->Status = EFI_NO_MEDIA;
     goto SIGNAL_TOKEN;
   }
@@ -245,6 +307,19 @@ MnpSyncSendPacket (
     ProtocolType = TxData->ProtocolType;
   }
 
+  //
+  // A reply usually follows, poll at the fastest rate to catch it.
+  //
+  MnpUpdatePollInterval (MnpDeviceData, TRUE);
+
+  //
+  // Keep the packets in order, the packets queued before go out first.
+  //
+  MnpTransmitPending (MnpDeviceData);
+  if (!IsListEmpty (&MnpDeviceData->PendingTxList)) {
+    return MnpQueuePendingTx (Instance, Packet, Length, HeaderSize, ProtocolType, Token);
+  }
+
   //
   // Transmit the packet through SNP.
   //
@@ -260,6 +335,7 @@ MnpSyncSendPacket (
   if (Status == EFI_NOT_READY) {
     Status = MnpRecycleTxBuf (MnpDeviceData);
     if (EFI_ERROR (Status)) {
+      MnpFreeTxBuf (MnpDeviceData, Packet);
       Token->Status = EFI_DEVICE_ERROR;
       goto SIGNAL_TOKEN;
     }
@@ -275,7 +351,16 @@ MnpSyncSendPacket (
                     );
   }
 
+  if (Status == EFI_NOT_READY) {
+    //
+    // The SNP transmit queue is still full, don't wait for it. The poll
+    // transmits the packet and signals the token later.
+    //
+    return MnpQueuePendingTx (Instance, Packet, Length, HeaderSize, ProtocolType, Token);
+  }
+
   if (EFI_ERROR (Status)) {
+    MnpFreeTxBuf (MnpDeviceData, Packet);
     Token->Status = EFI_DEVICE_ERROR;
   }
 
@@ -291,6 +376,156 @@ SIGNAL_TOKEN:
   return EFI_SUCCESS;
 }
 
+/**
+  Hand the packets in the pending transmit queue to SNP, in order, until SNP
+  runs out of room again, and signal their tokens.
+
+  @param[in, out]  MnpDeviceData       Pointer to the mnp device context data.
+
+  @return The number of tokens signaled.
+
+**/
+UINTN
+MnpTransmitPending (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData
+  )
+{
+  EFI_STATUS                         Status;
+  EFI_SIMPLE_NETWORK_PROTOCOL        *Snp;
+  EFI_MANAGED_NETWORK_TRANSMIT_DATA  *TxData;
+  MNP_TX_PENDING                     *Pending;
+  UINTN                              Count;
+
+  if (IsListEmpty (&MnpDeviceData->PendingTxList)) {
+    return 0;
+  }
+
+  Snp = MnpDeviceData->Snp;
+
+  //
+  // Make room in the SNP transmit queue. If that fails, SNP is broken and
+  // all the pending packets fail.
+  //
+  Status = MnpRecycleTxBuf (MnpDeviceData);
+
+  Count = 0;
+  while (!IsListEmpty (&MnpDeviceData->PendingTxList)) {
+    Pending = NET_LIST_HEAD (&MnpDeviceData->PendingTxList, MNP_TX_PENDING, Link);
+
+    if (!EFI_ERROR (Status)) {
+      TxData = Pending->Token->Packet.TxData;
+      Status = Snp->Transmit (
+                      Snp,
+                      Pending->HeaderSize,
+                      Pending->Length,
+                      Pending->Packet,
+                      TxData->SourceAddress,
+                      TxData->DestinationAddress,
+                      &Pending->ProtocolType
+                      );
+      if (Status == EFI_NOT_READY) {
+        break;
+      }
+    }
+
+    if (EFI_ERROR (Status)) {
+      MnpFreeTxBuf (MnpDeviceData, Pending->Packet);
+      Pending->Token->Status = EFI_DEVICE_ERROR;
+    } else {
+      Pending->Token->Status = EFI_SUCCESS;
+    }
+
+    RemoveEntryList (&Pending->Link);
+    MnpDeviceData->PendingTxCount--;
+
+    gBS->SignalEvent (Pending->Token->Event);
+    FreePool (Pending);
+    Count++;
+  }
+
+  return Count;
+}
+
+/**
+  Check whether a transmit token is in the pending transmit queue.
+
+  @param[in]  MnpDeviceData           Pointer to the mnp device context data.
+  @param[in]  Token                   Pointer to the token to look for.
+
+  @retval TRUE                        The token, or a token with the same event,
+                                      is pending.
+  @retval FALSE                       The token is not pending.
+
+**/
+BOOLEAN
+MnpIsTxTokenPending (
+  IN MNP_DEVICE_DATA                       *MnpDeviceData,
+  IN EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Token
+  )
+{
+  LIST_ENTRY      *Entry;
+  MNP_TX_PENDING  *Pending;
+
+  NET_LIST_FOR_EACH (Entry, &MnpDeviceData->PendingTxList) {
+    Pending = NET_LIST_USER_STRUCT (Entry, MNP_TX_PENDING, Link);
+    if ((Pending->Token == Token) || (Pending->Token->Event == Token->Event)) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Abort the pending transmit tokens of an instance.
+
+  @param[in]  Instance                Pointer to the mnp instance context data,
+                                      or NULL for all the instances.
+  @param[in]  MnpDeviceData           Pointer to the mnp device context data.
+  @param[in]  Token                   Pointer to the token to abort, or NULL for
+                                      all the tokens.
+
+  @retval EFI_SUCCESS                 Token is NULL and the tokens are aborted, or
+                                      Token is not pending.
+  @retval EFI_ABORTED                 Token is aborted.
+
+**/
+EFI_STATUS
+MnpCancelPendingTx (
+  IN MNP_INSTANCE_DATA                     *Instance OPTIONAL,
+  IN MNP_DEVICE_DATA                       *MnpDeviceData,
+  IN EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Token OPTIONAL
+  )
+{
+  LIST_ENTRY      *Entry;
+  LIST_ENTRY      *NextEntry;
+  MNP_TX_PENDING  *Pending;
+
+  NET_LIST_FOR_EACH_SAFE (Entry, NextEntry, &MnpDeviceData->PendingTxList) {
+    Pending = NET_LIST_USER_STRUCT (Entry, MNP_TX_PENDING, Link);
+
+    if (((Instance != NULL) && (Pending->Instance != Instance)) ||
+        ((Token != NULL) && (Pending->Token != Token)))
+    {
+      continue;
+    }
+
+    RemoveEntryList (&Pending->Link);
+    MnpDeviceData->PendingTxCount--;
+    MnpFreeTxBuf (MnpDeviceData, Pending->Packet);
+
+    Pending->Token->Status = EFI_ABORTED;
+    gBS->SignalEvent (Pending->Token->Event);
+    FreePool (Pending);
+
+    if (Token != NULL) {
+      return EFI_ABORTED;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Try to deliver the received packet to the instance.
 
@@ -344,7 +579,8 @@ MnpInstanceDeliverPacket (
     //
     NetbufDuplicate (RxDataWrap->Nbuf, DupNbuf, 0);
     MnpFreeNbuf (MnpDeviceData, RxDataWrap->Nbuf);
-    RxDataWrap->Nbuf = DupNbuf;
+    RxDataWrap->Nbuf              = DupNbuf;
+    MnpDeviceData->RxCopiedBytes += DupNbuf->TotalSize;
   }
 
   //
@@ -352,6 +588,7 @@ MnpInstanceDeliverPacket (
   //
   NetListRemoveHead (&Instance->RcvdPacketQueue);
   Instance->RcvdPacketQueueSize--;
+  MnpDeviceData->RxDeliveredBytes += RxDataWrap->Nbuf->TotalSize;
 
   RxData  = &RxDataWrap->RxData;
   SnpMode = MnpDeviceData->Snp->Mode;
@@ -813,6 +1050,123 @@ MnpEnqueuePacket (
   }
 }
 
+/**
+  Return the frame wrapped by a NET_BUF to SNP, when the NET_BUF is freed.
+
+  @param[in]  Arg               Pointer to the MNP_RX_LOAN of the frame.
+
+**/
+VOID
+EFIAPI
+MnpReturnRxFrame (
+  IN VOID  *Arg
+  )
+{
+  MNP_RX_LOAN                       *Loan;
+  EDKII_NETWORK_RX_BUFFER_PROTOCOL  *RxBuffer;
+
+  Loan     = (MNP_RX_LOAN *)Arg;
+  RxBuffer = Loan->MnpDeviceData->RxBuffer;
+
+  RxBuffer->Return (RxBuffer, Loan->Frame);
+  FreePool (Loan);
+}
+
+/**
+  Try to receive a packet without copying it, and deliver it.
+
+  The frame stays in the receive buffer of SNP, the NET_BUF delivered to the
+  instances wraps it. It goes back to SNP when the last instance recycles the
+  NET_BUF.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+
+  @retval EFI_SUCCESS           A packet is received.
+  @retval EFI_NOT_READY         No packet received.
+  @retval EFI_OUT_OF_RESOURCES  Too many frames are on loan, the packet must
+                                be copied.
+  @retval EFI_DEVICE_ERROR      An unexpected error occurs.
+
+**/
+EFI_STATUS
+MnpReceiveLoanedPacket (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData
+  )
+{
+  EFI_STATUS                        Status;
+  EDKII_NETWORK_RX_BUFFER_PROTOCOL  *RxBuffer;
+  VOID                              *Frame;
+  UINTN                             FrameSize;
+  MNP_RX_LOAN                       *Loan;
+  NET_FRAGMENT                      Fragment;
+  NET_BUF                           *Nbuf;
+  MNP_SERVICE_DATA                  *MnpServiceData;
+  UINT16                            VlanId;
+  BOOLEAN                           Delivered;
+
+  RxBuffer = MnpDeviceData->RxBuffer;
+  Status   = RxBuffer->Receive (RxBuffer, &Frame, &FrameSize);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Loan = AllocatePool (sizeof (MNP_RX_LOAN));
+  if (Loan == NULL) {
+    RxBuffer->Return (RxBuffer, Frame);
+    return EFI_DEVICE_ERROR;
+  }
+
+  Loan->MnpDeviceData = MnpDeviceData;
+  Loan->Frame         = Frame;
+
+  Fragment.Bulk = Frame;
+  Fragment.Len  = (UINT32)FrameSize;
+  Nbuf          = NetbufFromExt (&Fragment, 1, 0, 0, MnpReturnRxFrame, Loan);
+  if (Nbuf == NULL) {
+    MnpReturnRxFrame (Loan);
+    return EFI_DEVICE_ERROR;
+  }
+
+  //
+  // Take the reference of MnpAllocNbuf (), so that MnpFreeNbuf () and the
+  // RefCnt checks work alike for the wrapped frames.
+  //
+  NET_GET_REF (Nbuf);
+
+  VlanId = 0;
+  if (MnpDeviceData->NumberOfVlan != 0) {
+    //
+    // VLAN is configured, remove the VLAN tag if any
+    //
+    MnpRemoveVlanTag (MnpDeviceData, Nbuf, &VlanId);
+  }
+
+  //
+  // Enqueue the packet to the matched instances, if the VLAN is set for it.
+  //
+  MnpServiceData = MnpFindServiceData (MnpDeviceData, VlanId);
+  if (MnpServiceData != NULL) {
+    MnpEnqueuePacket (MnpServiceData, Nbuf);
+  }
+
+  //
+  // RefCnt > 2 indicates there is at least one receiver of this packet.
+  // Drop the reference of the receive path, the frame goes back to SNP
+  // right away if there is no receiver.
+  //
+  Delivered = (BOOLEAN)(Nbuf->RefCnt > 2);
+  MnpFreeNbuf (MnpDeviceData, Nbuf);
+
+  if (Delivered) {
+    //
+    // Deliver the queued packets.
+    //
+    MnpDeliverPacket (MnpServiceData);
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Try to receive a packet and deliver it.
 
@@ -850,6 +1204,17 @@ MnpReceivePacket (
     return EFI_NOT_STARTED;
   }
 
+  if (MnpDeviceData->RxBuffer != NULL) {
+    Status = MnpReceiveLoanedPacket (MnpDeviceData);
+    if (Status != EFI_OUT_OF_RESOURCES) {
+      return Status;
+    }
+
+    //
+    // Too many frames are on loan, copy this one into the RxNbufCache.
+    //
+  }
+
   if (MnpDeviceData->RxNbufCache == NULL) {
     //
     // Try to get a new buffer as there may be buffers recycled.
@@ -903,6 +1268,8 @@ MnpReceivePacket (
     return EFI_DEVICE_ERROR;
   }
 
+  MnpDeviceData->RxCopiedBytes += BufLen;
+
   Trimmed = 0;
   if (Nbuf->TotalSize != BufLen) {
     //
@@ -1084,8 +1451,8 @@ MnpCheckMediaStatus (
 }
 
 /**
-  Poll to receive the packets from Snp. This function is either called by upperlayer
-  protocols/applications or the system poll timer notify mechanism.
+  Poll to receive the packets from Snp and transmit the pending packets. This
+  function is called by the system poll timer notify mechanism.
 
   @param[in]  Event        The event this notify function registered to.
   @param[in]  Context      Pointer to the context data registered to the event.
@@ -1099,17 +1466,82 @@ MnpSystemPoll (
   )
 {
   MNP_DEVICE_DATA  *MnpDeviceData;
+  BOOLEAN          Busy;
+  UINTN            Index;
 
   MnpDeviceData = (MNP_DEVICE_DATA *)Context;
   NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
 
   //
-  // Try to receive packets from Snp.
+  // Transmit the packets SNP had no room for.
+  //
+  Busy = (BOOLEAN)(MnpTransmitPending (MnpDeviceData) != 0);
+
+  //
+  // Drain the received packets in a batch rather than one per tick. Dispatch
+  // the DPC queued by the NotifyFunction of rx token's events after each
+  // packet, so the receivers can queue new rx tokens in between.
   //
-  MnpReceivePacket (MnpDeviceData);
+  for (Index = 0; Index < MNP_RX_BATCH_SIZE; Index++) {
+    if (MnpReceivePacket (MnpDeviceData) != EFI_SUCCESS) {
+      break;
+    }
+
+    Busy = TRUE;
+    DispatchDpc ();
+  }
 
   //
-  // Dispatch the DPC queued by the NotifyFunction of rx token's events.
+  // Dispatch the DPC queued by the NotifyFunction of tx token's events.
   //
   DispatchDpc ();
+
+  MnpUpdatePollInterval (MnpDeviceData, Busy);
+}
+
+/**
+  Adapt the period of the system poll timer to the traffic.
+
+  The period drops to MNP_SYS_POLL_INTERVAL_MIN as soon as packets flow, and
+  doubles up to MNP_SYS_POLL_INTERVAL after MNP_SYS_POLL_IDLE_COUNT polls in
+  a row found nothing to do.
+
+  @param[in, out]  MnpDeviceData       Pointer to the mnp device context data.
+  @param[in]       Busy                TRUE if packets were received or sent.
+
+**/
+VOID
+MnpUpdatePollInterval (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  IN     BOOLEAN          Busy
+  )
+{
+  UINT64      Interval;
+  EFI_STATUS  Status;
+
+  if (!MnpDeviceData->EnableSystemPoll) {
+    return;
+  }
+
+  if (Busy) {
+    MnpDeviceData->IdlePollCount = 0;
+    Interval                     = MNP_SYS_POLL_INTERVAL_MIN;
+  } else {
+    MnpDeviceData->IdlePollCount++;
+    if (MnpDeviceData->IdlePollCount < MNP_SYS_POLL_IDLE_COUNT) {
+      return;
+    }
+
+    MnpDeviceData->IdlePollCount = 0;
+    Interval                     = MIN (MultU64x32 (MnpDeviceData->PollInterval, 2), MNP_SYS_POLL_INTERVAL);
+  }
+
+  if (Interval == MnpDeviceData->PollInterval) {
+    return;
+  }
+
+  Status = gBS->SetTimer (MnpDeviceData->PollTimer, TimerPeriodic, Interval);
+  if (!EFI_ERROR (Status)) {
+    MnpDeviceData->PollInterval = Interval;
+  }
 }
@@ -1,7 +1,7 @@
 /** @file
   Implementation of Managed Network Protocol public services.
 
-Copyright (c) 2005 - 2016, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2005 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -541,6 +541,14 @@ MnpTransmit (
   MnpServiceData = Instance->MnpServiceData;
   NET_CHECK_SIGNATURE (MnpServiceData, MNP_SERVICE_DATA_SIGNATURE);
 
+  if (MnpIsTxTokenPending (MnpServiceData->MnpDeviceData, Token)) {
+    //
+    // The Token is already in the pending transmit queue.
+    //
+    Status = EFI_ACCESS_DENIED;
+    goto ON_EXIT;
+  }
+
   //
   // Build the tx packet
   //
@@ -550,9 +558,9 @@ MnpTransmit (
   }
 
   //
-  //  OK, send the packet synchronously.
+  //  OK, send the packet, or queue it if SNP has no room for it.
   //
-  Status = MnpSyncSendPacket (MnpServiceData, PktBuf, PktLen, Token);
+  Status = MnpSendPacket (Instance, PktBuf, PktLen, Token);
 
 ON_EXIT:
   gBS->RestoreTPL (OldTpl);
@@ -706,6 +714,13 @@ MnpCancel (
   // Iterate the RxTokenMap to cancel the specified Token.
   //
   Status = NetMapIterate (&Instance->RxTokenMap, MnpCancelTokens, (VOID *)Token);
+  if ((Token == NULL) || (Status != EFI_ABORTED)) {
+    //
+    // Then the tokens waiting in the pending transmit queue.
+    //
+    Status = MnpCancelPendingTx (Instance, Instance->MnpServiceData->MnpDeviceData, Token);
+  }
+
   if (Token != NULL) {
     Status = (Status == EFI_ABORTED) ? EFI_SUCCESS : EFI_NOT_FOUND;
   }
@@ -755,6 +770,8 @@ MnpPoll (
 {
   EFI_STATUS         Status;
   MNP_INSTANCE_DATA  *Instance;
+  MNP_DEVICE_DATA    *MnpDeviceData;
+  UINTN              Sent;
   EFI_TPL            OldTpl;
 
   if (This == NULL) {
@@ -770,10 +787,20 @@ MnpPoll (
     goto ON_EXIT;
   }
 
+  MnpDeviceData = Instance->MnpServiceData->MnpDeviceData;
+
+  //
+  // Try to transmit the pending packets.
+  //
+  Sent = MnpTransmitPending (MnpDeviceData);
+
   //
   // Try to receive packets.
   //
-  Status = MnpReceivePacket (Instance->MnpServiceData->MnpDeviceData);
+  Status = MnpReceivePacket (MnpDeviceData);
+  if ((Status == EFI_NOT_READY) && (Sent != 0)) {
+    Status = EFI_SUCCESS;
+  }
 
   //
   // Dispatch the DPC queued by the NotifyFunction of rx token's events.
@@ -1,7 +1,7 @@
 /** @file
   The driver binding and service binding protocol for the TCP driver.
 
-  Copyright (c) 2009 - 2018, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2009 - 2026, Intel Corporation. All rights reserved.<BR>
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -234,6 +234,7 @@ TcpCreateService (
   EFI_GUID          *TcpServiceBindingGuid;
   TCP_SERVICE_DATA  *TcpServiceData;
   IP_IO_OPEN_DATA   OpenData;
+  VOID              *Interface;
 
   if (IpVersion == IP_VERSION_4) {
     IpServiceBindingGuid  = &gEfiIp4ServiceBindingProtocolGuid;
@@ -310,12 +311,41 @@ TcpCreateService (
     OpenData.IpConfigData.Ip6CfgData.DefaultProtocol = EFI_IP_PROTO_TCP;
   }
 
+  OpenData.RcvdContext   = TcpServiceData;
   OpenData.PktRcvdNotify = TcpRxCallback;
   Status                 = IpIoOpen (TcpServiceData->IpIo, &OpenData);
   if (EFI_ERROR (Status)) {
     goto ON_ERROR;
   }
 
+  //
+  // Leave the checksum of the segments to the NIC if it can compute it. The
+  // segments protected by IPsec are encrypted before they reach the NIC, so
+  // don't offload the checksum if IPsec is present.
+  //
+  TcpServiceData->OffloadKind = (IpVersion == IP_VERSION_4) ? EDKII_NETWORK_OFFLOAD_TCP4 :
+                                EDKII_NETWORK_OFFLOAD_TCP6;
+  Status = gBS->OpenProtocol (
+                  Controller,
+                  &gEdkiiNetworkOffloadProtocolGuid,
+                  (VOID **)&TcpServiceData->Offload,
+                  Image,
+                  Controller,
+                  EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                  );
+  if (EFI_ERROR (Status)) {
+    TcpServiceData->Offload = NULL;
+  } else if (((TcpServiceData->Offload->TxChecksum & TcpServiceData->OffloadKind) != 0) &&
+             EFI_ERROR (gBS->LocateProtocol (&gEfiIpSec2ProtocolGuid, NULL, &Interface)))
+  {
+    Status = TcpServiceData->Offload->SetTxChecksum (
+                                        TcpServiceData->Offload,
+                                        TcpServiceData->OffloadKind,
+                                        TRUE
+                                        );
+    TcpServiceData->TxChecksumOffload = (BOOLEAN) !EFI_ERROR (Status);
+  }
+
   Status = TcpCreateTimer ();
   if (EFI_ERROR (Status)) {
     goto ON_ERROR;
@@ -337,6 +367,14 @@ TcpCreateService (
 
 ON_ERROR:
 
+  if (TcpServiceData->TxChecksumOffload) {
+    TcpServiceData->Offload->SetTxChecksum (
+                               TcpServiceData->Offload,
+                               TcpServiceData->OffloadKind,
+                               FALSE
+                               );
+  }
+
   if (TcpServiceData->IpIo != NULL) {
     IpIoDestroy (TcpServiceData->IpIo);
     TcpServiceData->IpIo = NULL;
@@ -476,6 +514,17 @@ TcpDestroyService (
     IpIoDestroy (TcpServiceData->IpIo);
     TcpServiceData->IpIo = NULL;
 
+    //
+    // The NIC must not touch the checksum of other TCP segments.
+    //
+    if (TcpServiceData->TxChecksumOffload) {
+      TcpServiceData->Offload->SetTxChecksum (
+                                 TcpServiceData->Offload,
+                                 TcpServiceData->OffloadKind,
+                                 FALSE
+                                 );
+    }
+
     //
     // Destroy the heartbeat timer.
     //
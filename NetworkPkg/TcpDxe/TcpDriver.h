@@ -1,7 +1,7 @@
 /** @file
   The prototype of driver binding and service binding protocol for TCP driver.
 
-  Copyright (c) 2009 - 2016, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2009 - 2026, Intel Corporation. All rights reserved.<BR>
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -21,13 +21,16 @@ typedef struct _TCP_HEARTBEAT_TIMER {
 } TCP_HEARTBEAT_TIMER;
 
 typedef struct _TCP_SERVICE_DATA {
-  UINT32                          Signature;
-  EFI_HANDLE                      ControllerHandle;
-  EFI_HANDLE                      DriverBindingHandle;
-  UINT8                           IpVersion;
-  IP_IO                           *IpIo;
-  EFI_SERVICE_BINDING_PROTOCOL    ServiceBinding;
-  LIST_ENTRY                      SocketList;
+  UINT32                            Signature;
+  EFI_HANDLE                        ControllerHandle;
+  EFI_HANDLE                        DriverBindingHandle;
+  UINT8                             IpVersion;
+  IP_IO                             *IpIo;
+  EFI_SERVICE_BINDING_PROTOCOL      ServiceBinding;
+  LIST_ENTRY                        SocketList;
+  EDKII_NETWORK_OFFLOAD_PROTOCOL    *Offload;          ///< Checksum offload of the NIC, NULL if none.
+  UINT32                            OffloadKind;       ///< EDKII_NETWORK_OFFLOAD_TCP4 or TCP6.
+  BOOLEAN                           TxChecksumOffload; ///< The NIC completes the partial checksums.
 } TCP_SERVICE_DATA;
 
 typedef struct _TCP_PROTO_DATA {
@@ -1,7 +1,7 @@
 /** @file
   Declaration of external functions shared in TCP driver.
 
-  Copyright (c) 2009 - 2014, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2009 - 2026, Intel Corporation. All rights reserved.<BR>
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -359,6 +359,23 @@ TcpRetransmit (
   IN TCP_SEQNO  Seq
   );
 
+/**
+  Retransmit the lost data in the SACK scoreboard, then open the congestion
+  window for new data, both within the budget given by the proportional rate
+  reduction.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       SndUna  The SND.UNA acknowledged by the incoming segment.
+  @param[in]       SndCnt  The number of bytes that may be sent.
+
+**/
+VOID
+TcpSackRetransmit (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  SndUna,
+  IN     UINT32     SndCnt
+  );
+
 /**
   Check whether to send data/SYN/FIN and piggyback an ACK.
 
@@ -484,6 +501,7 @@ TcpIcmpInput (
                        address.
   @param[in]  Version  IP_VERSION_4 indicates IP4 stack, IP_VERSION_6 indicates
                        IP6 stack.
+  @param[in]  ChecksumValid  TRUE if the NIC validated the checksum of the segment.
 
   @retval 0        The segment processed successfully. It is either accepted or
                    discarded. But no connection is reset by the segment.
@@ -495,7 +513,8 @@ TcpInput (
   IN NET_BUF         *Nbuf,
   IN EFI_IP_ADDRESS  *Src,
   IN EFI_IP_ADDRESS  *Dst,
-  IN UINT8           Version
+  IN UINT8           Version,
+  IN BOOLEAN         ChecksumValid
   );
 
 //
@@ -1,7 +1,7 @@
 /** @file
   TCP input process routines.
 
-  Copyright (c) 2009 - 2018, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2009 - 2026, Intel Corporation. All rights reserved.<BR>
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -192,6 +192,75 @@ TcpFastLossRecover (
   }
 }
 
+/**
+  SACK based fast recovery defined in RFC6675, with the congestion window
+  set by the proportional rate reduction defined in RFC6937.
+
+  Unlike NewReno, which repairs one hole per round trip, every hole the
+  scoreboard marks as lost is retransmitted as the ACKs allow, and the
+  sending rate is reduced smoothly to Ssthresh instead of stalling until
+  half of the window is ACKed.
+
+  @param[in, out]  Tcb        Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Seg        Segment that triggers the fast recovery.
+  @param[in]       Delivered  The bytes the segment reports as delivered.
+
+**/
+VOID
+TcpSackRecover (
+  IN OUT TCP_CB   *Tcb,
+  IN     TCP_SEG  *Seg,
+  IN     UINT32   Delivered
+  )
+{
+  UINT32  FlightSize;
+  UINT32  Pipe;
+  UINT32  SndCnt;
+
+  if (Tcb->CongestState != TCP_CONGEST_RECOVER) {
+    //
+    // A loss is detected, either by three duplicate ACKs or
+    // by the data SACKed above SND.UNA. Enter the recovery.
+    //
+    FlightSize = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
+
+    Tcb->Ssthresh = MAX (FlightSize >> 1, (UINT32)(2 * Tcb->SndMss));
+    Tcb->Recover  = Tcb->SndNxt;
+
+    Tcb->CongestState = TCP_CONGEST_RECOVER;
+    TCP_CLEAR_FLG (Tcb->CtrlFlag, TCP_CTRL_RTT_ON);
+
+    Tcb->Sack.HighRxt = Seg->Ack;
+    TcpPrrStart (&Tcb->Prr, FlightSize);
+
+    DEBUG (
+      (DEBUG_NET,
+       "TcpSackRecover: enter SACK recovery for TCB %p, recover point is %d\n",
+       Tcb,
+       Tcb->Recover)
+      );
+  } else if (TCP_SEQ_GEQ (Seg->Ack, Tcb->Recover)) {
+    //
+    // Full ACK: the window is Ssthresh at the end of the recovery.
+    //
+    Tcb->CWnd         = Tcb->Ssthresh;
+    Tcb->CongestState = TCP_CONGEST_OPEN;
+
+    DEBUG (
+      (DEBUG_NET,
+       "TcpSackRecover: received a full ACK(%d) for TCB %p, exit SACK recovery\n",
+       Seg->Ack,
+       Tcb)
+      );
+    return;
+  }
+
+  Pipe   = TcpSackPipe (&Tcb->Sack, Seg->Ack, Tcb->SndNxt, Tcb->SndMss);
+  SndCnt = TcpPrrSndCnt (&Tcb->Prr, Delivered, Pipe, Tcb->Ssthresh, Tcb->SndMss);
+
+  TcpSackRetransmit (Tcb, Seg->Ack, SndCnt);
+}
+
 /**
   Compute the RTT as specified in RFC2988.
 
@@ -700,6 +769,7 @@ TcpAdjustSndQue (
                        address.
   @param[in]  Version  IP_VERSION_4 indicates IP4 stack. IP_VERSION_6 indicates
                        IP6 stack.
+  @param[in]  ChecksumValid  TRUE if the NIC validated the checksum of the segment.
 
   @retval 0        Segment  processed successfully. It is either accepted or
                    discarded. However, no connection is reset by the segment.
@@ -711,7 +781,8 @@ TcpInput (
   IN NET_BUF         *Nbuf,
   IN EFI_IP_ADDRESS  *Src,
   IN EFI_IP_ADDRESS  *Dst,
-  IN UINT8           Version
+  IN UINT8           Version,
+  IN BOOLEAN         ChecksumValid
   )
 {
   TCP_CB      *Tcb;
@@ -724,6 +795,7 @@ TcpInput (
   TCP_SEQNO   Urg;
   UINT16      Checksum;
   INT32       Usable;
+  UINT32      Delivered;
 
   ASSERT ((Version == IP_VERSION_4) || (Version == IP_VERSION_6));
 
@@ -748,17 +820,19 @@ TcpInput (
     goto DISCARD;
   }
 
-  if (Version == IP_VERSION_4) {
-    Checksum = NetPseudoHeadChecksum (Src->Addr[0], Dst->Addr[0], 6, 0);
-  } else {
-    Checksum = NetIp6PseudoHeadChecksum (&Src->v6, &Dst->v6, 6, 0);
-  }
+  if (!ChecksumValid) {
+    if (Version == IP_VERSION_4) {
+      Checksum = NetPseudoHeadChecksum (Src->Addr[0], Dst->Addr[0], 6, 0);
+    } else {
+      Checksum = NetIp6PseudoHeadChecksum (&Src->v6, &Dst->v6, 6, 0);
+    }
 
-  Checksum = TcpChecksum (Nbuf, Checksum);
+    Checksum = TcpChecksum (Nbuf, Checksum);
 
-  if (Checksum != 0) {
-    DEBUG ((DEBUG_ERROR, "TcpInput: received a checksum error packet\n"));
-    goto DISCARD;
+    if (Checksum != 0) {
+      DEBUG ((DEBUG_ERROR, "TcpInput: received a checksum error packet\n"));
+      goto DISCARD;
+    }
   }
 
   if (TCP_FLG_ON (Head->Flag, TCP_FLG_SYN)) {
@@ -1215,11 +1289,41 @@ TcpInput (
     Tcb->DupAck = 0;
   }
 
+  //
+  // Update the SACK scoreboard with the blocks reported by the peer,
+  // and count the data the segment reports as delivered.
+  //
+  Delivered = 0;
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK)) {
+    Delivered = TcpSackUpdate (
+                  &Tcb->Sack,
+                  Tcb->SndUna,
+                  Seg->Ack,
+                  Tcb->SndNxt,
+                  Option.SackBlock,
+                  TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK) ? Option.SackCount : 0
+                  );
+
+    if ((Delivered == 0) && (Tcb->DupAck != 0) && !TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK)) {
+      //
+      // Without SACK blocks, a duplicate ACK is taken as one
+      // segment delivered, as suggested in RFC6937 section 3.
+      //
+      Delivered = Tcb->SndMss;
+    }
+  }
+
   //
   // Congestion avoidance, fast recovery and fast retransmission.
   //
-  if (((Tcb->CongestState == TCP_CONGEST_OPEN) && (Tcb->DupAck < 3)) ||
-      (Tcb->CongestState == TCP_CONGEST_LOSS))
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK) &&
+      ((Tcb->CongestState == TCP_CONGEST_RECOVER) ||
+       ((Tcb->CongestState == TCP_CONGEST_OPEN) &&
+        ((Tcb->DupAck >= 3) || TcpSackIsLost (&Tcb->Sack, Seg->Ack, Tcb->SndMss)))))
+  {
+    TcpSackRecover (Tcb, Seg, Delivered);
+  } else if (((Tcb->CongestState == TCP_CONGEST_OPEN) && (Tcb->DupAck < 3)) ||
+             (Tcb->CongestState == TCP_CONGEST_LOSS))
   {
     if (TCP_SEQ_GT (Seg->Ack, Tcb->SndUna)) {
       if (Tcb->CWnd < Tcb->Ssthresh) {
@@ -1466,6 +1570,10 @@ StepSix:
       goto RESET_THEN_DROP;
     }
 
+    if (Seg->Seq != Tcb->RcvNxt) {
+      Tcb->RcvSackSeq = Seg->Seq;
+    }
+
     if (TcpQueueData (Tcb, Nbuf) == 0) {
       DEBUG (
         (DEBUG_ERROR,
@@ -1,7 +1,7 @@
 /** @file
   Implementation of I/O interfaces between TCP and IpIoLib.
 
-  Copyright (c) 2009 - 2012, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2009 - 2026, Intel Corporation. All rights reserved.<BR>
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -18,8 +18,8 @@
   @param[in] NetSession    The IP session for the received packet.
   @param[in] Pkt           Packet received.
   @param[in] Context       The data provided by the user for the received packet when
-                           the callback is registered in IP_IO_OPEN_DATA::RcvdContext.
-                           This is an optional parameter that may be NULL.
+                           the callback is registered in IP_IO_OPEN_DATA::RcvdContext,
+                           the TCP_SERVICE_DATA.
 
 **/
 VOID
@@ -32,8 +32,30 @@ TcpRxCallback (
   IN VOID                  *Context    OPTIONAL
   )
 {
+  TCP_SERVICE_DATA                *TcpServiceData;
+  EDKII_NETWORK_OFFLOAD_PROTOCOL  *Offload;
+  BOOLEAN                         ChecksumValid;
+
   if (EFI_SUCCESS == Status) {
-    TcpInput (Pkt, &NetSession->Source, &NetSession->Dest, NetSession->IpVersion);
+    //
+    // The NIC may have validated the checksum of the segment, if the segment
+    // is still in the buffer it was received into.
+    //
+    TcpServiceData = (TCP_SERVICE_DATA *)Context;
+    ChecksumValid  = FALSE;
+    if ((TcpServiceData != NULL) && (TcpServiceData->Offload != NULL) &&
+        ((TcpServiceData->Offload->RxChecksum & TcpServiceData->OffloadKind) != 0) &&
+        (Pkt->BlockOpNum == 1))
+    {
+      Offload       = TcpServiceData->Offload;
+      ChecksumValid = Offload->RxChecksumValid (
+                                 Offload,
+                                 NetbufGetByte (Pkt, 0, NULL),
+                                 Pkt->TotalSize
+                                 );
+    }
+
+    TcpInput (Pkt, &NetSession->Source, &NetSession->Dest, NetSession->IpVersion, ChecksumValid);
   } else {
     TcpIcmpInput (
       Pkt,
@@ -46,10 +68,14 @@ TcpRxCallback (
 }
 
 /**
-  Send the segment to IP via IpIo function.
+  Fill in the checksum of the segment and send it to IP via IpIo function.
+
+  If the NIC completes the checksum, only the checksum of the pseudo header
+  is filled in.
 
   @param[in]  Tcb                Pointer to the TCP_CB of this TCP instance.
-  @param[in]  Nbuf               Pointer to the TCP segment to be sent.
+  @param[in]  Nbuf               Pointer to the TCP segment to be sent, its
+                                 checksum is zero.
   @param[in]  Src                Source address of the TCP segment.
   @param[in]  Dest               Destination address of the TCP segment.
   @param[in]  Version            IP_VERSION_4 or IP_VERSION_6
@@ -67,12 +93,23 @@ TcpSendIpPacket (
   IN UINT8           Version
   )
 {
-  EFI_STATUS      Status;
-  IP_IO           *IpIo;
-  IP_IO_OVERRIDE  Override;
-  SOCKET          *Sock;
-  VOID            *IpSender;
-  TCP_PROTO_DATA  *TcpProto;
+  EFI_STATUS        Status;
+  IP_IO             *IpIo;
+  IP_IO_OVERRIDE    Override;
+  SOCKET            *Sock;
+  VOID              *IpSender;
+  TCP_PROTO_DATA    *TcpProto;
+  TCP_SERVICE_DATA  *TcpServiceData;
+  UINT16            HeadSum;
+
+  //
+  // Checksum of the pseudo header, computed before Dest is overridden below.
+  //
+  if (Version == IP_VERSION_4) {
+    HeadSum = NetPseudoHeadChecksum (Src->Addr[0], Dest->Addr[0], 6, 0);
+  } else {
+    HeadSum = NetIp6PseudoHeadChecksum (&Src->v6, &Dest->v6, 6, 0);
+  }
 
   if (NULL == Tcb) {
     IpIo     = NULL;
@@ -112,6 +149,19 @@ TcpSendIpPacket (
 
   ASSERT (Version == IpIo->IpVersion);
 
+  //
+  // The IpIo of the TCP driver are all opened with the TCP_SERVICE_DATA as
+  // their receive context.
+  //
+  TcpServiceData = (TCP_SERVICE_DATA *)IpIo->RcvdContext;
+  ASSERT (Nbuf->Tcp != NULL);
+
+  if ((TcpServiceData != NULL) && TcpServiceData->TxChecksumOffload) {
+    Nbuf->Tcp->Checksum = NetAddChecksum (HeadSum, HTONS ((UINT16)Nbuf->TotalSize));
+  } else {
+    Nbuf->Tcp->Checksum = TcpChecksum (Nbuf, HeadSum);
+  }
+
   if (Version == IP_VERSION_4) {
     Override.Ip4OverrideData.TypeOfService = 0;
     Override.Ip4OverrideData.TimeToLive    = 255;
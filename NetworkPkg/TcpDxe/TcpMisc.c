@@ -2,7 +2,7 @@
   Misc support routines for TCP driver.
 
   (C) Copyright 2014 Hewlett-Packard Development Company, L.P.<BR>
-  Copyright (c) 2009 - 2017, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2009 - 2026, Intel Corporation. All rights reserved.<BR>
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -47,25 +47,6 @@ TcpInitTcbLocal (
   IN OUT TCP_CB  *Tcb
   )
 {
-  //
-  // Compute the checksum of the fixed parts of pseudo header
-  //
-  if (Tcb->Sk->IpVersion == IP_VERSION_4) {
-    Tcb->HeadSum = NetPseudoHeadChecksum (
-                     Tcb->LocalEnd.Ip.Addr[0],
-                     Tcb->RemoteEnd.Ip.Addr[0],
-                     0x06,
-                     0
-                     );
-  } else {
-    Tcb->HeadSum = NetIp6PseudoHeadChecksum (
-                     &Tcb->LocalEnd.Ip.v6,
-                     &Tcb->RemoteEnd.Ip.v6,
-                     0x06,
-                     0
-                     );
-  }
-
   Tcb->Iss    = TcpGetIss ();
   Tcb->SndUna = Tcb->Iss;
   Tcb->SndNxt = Tcb->Iss;
@@ -160,6 +141,13 @@ TcpInitTcbPeer (
     //
     Tcb->SndMss -= TCP_OPTION_TS_ALIGNED_LEN;
   }
+
+  if (TCP_FLG_ON (Opt->Flag, TCP_OPTION_RCVD_SACK_PERM) && !TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK)) {
+    TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK);
+  }
+
+  TcpSackReset (&Tcb->Sack, Tcb->SndUna);
+  Tcb->RcvSackSeq = Tcb->RcvNxt;
 }
 
 /**
@@ -944,7 +932,6 @@ TcpResetConnection (
   Nhead->Wnd      = HTONS (0xFFFF);
   Nhead->Checksum = 0;
   Nhead->Urg      = 0;
-  Nhead->Checksum = TcpChecksum (Nbuf, Tcb->HeadSum);
 
   TcpSendIpPacket (Tcb, Nbuf, &Tcb->LocalEnd.Ip, &Tcb->RemoteEnd.Ip, Tcb->Sk->IpVersion);
 
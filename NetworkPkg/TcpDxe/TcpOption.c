@@ -1,7 +1,7 @@
 /** @file
   Routines to process TCP option.
 
-  Copyright (c) 2009 - 2018, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2009 - 2026, Intel Corporation. All rights reserved.<BR>
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -160,6 +160,27 @@ TcpSynBuildOption (
     TcpPutUint32 (Data, TCP_OPTION_WS_FAST | TcpComputeScale (Tcb));
   }
 
+  //
+  // Build SACK permitted option under the same rule as
+  // the window scale option.
+  //
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK) &&
+      (!TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_ACK) ||
+       TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK))
+      )
+  {
+    Data = NetbufAllocSpace (
+             Nbuf,
+             TCP_OPTION_SACK_PERM_ALIGNED_LEN,
+             NET_BUF_HEAD
+             );
+
+    ASSERT (Data != NULL);
+
+    Len += TCP_OPTION_SACK_PERM_ALIGNED_LEN;
+    TcpPutUint32 (Data, TCP_OPTION_SACK_PERM_FAST);
+  }
+
   //
   // Build the MSS option.
   //
@@ -172,6 +193,108 @@ TcpSynBuildOption (
   return Len;
 }
 
+/**
+  Build the SACK option from the out-of-order data in the reassemble queue.
+
+  The first block holds the most recently received segment, as required by
+  RFC2018, the other blocks follow in sequence order.
+
+  @param[in]  Tcb        Pointer to the TCP_CB of this TCP instance.
+  @param[in]  Nbuf       Pointer to the buffer to store the option.
+  @param[in]  MaxBlocks  The maximum number of blocks that fit in the option
+                         space left.
+
+  @return                The length of the SACK option, 0 if there is no
+                         out-of-order data.
+
+**/
+UINT16
+TcpBuildSackOption (
+  IN TCP_CB   *Tcb,
+  IN NET_BUF  *Nbuf,
+  IN UINT32   MaxBlocks
+  )
+{
+  TCP_SACK_BLOCK  Block[TCP_SACK_MAX_BLOCKS];
+  UINT32          Count;
+  UINT32          Index;
+  LIST_ENTRY      *Entry;
+  TCP_SEG         *Seg;
+  TCP_SACK_BLOCK  Current;
+  BOOLEAN         Recent;
+  UINT8           *Data;
+  UINT16          Len;
+
+  MaxBlocks = MIN (MaxBlocks, TCP_SACK_MAX_BLOCKS);
+  if ((MaxBlocks == 0) || IsListEmpty (&Tcb->RcvQue)) {
+    return 0;
+  }
+
+  //
+  // Merge the contiguous segments of the reassemble queue, which
+  // is sorted and has no overlap, into blocks above RcvNxt.
+  //
+  Count  = 0;
+  Recent = FALSE;
+  Entry  = Tcb->RcvQue.ForwardLink;
+  while (Entry != &Tcb->RcvQue) {
+    Seg   = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+    Entry = Entry->ForwardLink;
+
+    if (TCP_SEQ_LEQ (Seg->End, Tcb->RcvNxt)) {
+      continue;
+    }
+
+    Current.Left  = Seg->Seq;
+    Current.Right = Seg->End;
+    while (Entry != &Tcb->RcvQue) {
+      Seg = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+      if (Seg->Seq != Current.Right) {
+        break;
+      }
+
+      Current.Right = Seg->End;
+      Entry         = Entry->ForwardLink;
+    }
+
+    if (!Recent && TCP_SEQ_LEQ (Current.Left, Tcb->RcvSackSeq) && TCP_SEQ_LT (Tcb->RcvSackSeq, Current.Right)) {
+      //
+      // Move the block of the most recent segment to the front.
+      //
+      Recent = TRUE;
+      Count  = MIN (Count, MaxBlocks - 1);
+      CopyMem (&Block[1], &Block[0], Count * sizeof (TCP_SACK_BLOCK));
+      CopyMem (&Block[0], &Current, sizeof (TCP_SACK_BLOCK));
+      Count++;
+    } else if (Count < MaxBlocks) {
+      CopyMem (&Block[Count], &Current, sizeof (TCP_SACK_BLOCK));
+      Count++;
+    } else if (Recent) {
+      break;
+    }
+  }
+
+  if (Count == 0) {
+    return 0;
+  }
+
+  Len  = (UINT16)(TCP_OPTION_SACK_HEAD_ALIGNED_LEN + Count * TCP_OPTION_SACK_BLOCK_LEN);
+  Data = NetbufAllocSpace (Nbuf, Len, NET_BUF_HEAD);
+  ASSERT (Data != NULL);
+
+  TcpPutUint32 (
+    Data,
+    TCP_OPTION_SACK_FAST | (TCP_OPTION_SACK_HEAD_LEN + Count * TCP_OPTION_SACK_BLOCK_LEN)
+    );
+
+  for (Index = 0; Index < Count; Index++) {
+    TcpPutUint32 (Data + 4 + Index * TCP_OPTION_SACK_BLOCK_LEN, Block[Index].Left);
+    TcpPutUint32 (Data + 8 + Index * TCP_OPTION_SACK_BLOCK_LEN, Block[Index].Right);
+  }
+
+  return Len;
+}
+
 /**
   Build the TCP option in synchronized states.
 
@@ -214,6 +337,20 @@ TcpBuildOption (
     TcpPutUint32 (Data + 8, Tcb->TsRecent);
   }
 
+  //
+  // Build the SACK option to report the out-of-order data.
+  // It is only added to segments without data, such as the
+  // ACKs of a bulk download, so the data segments still fit
+  // in the SndMss.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK) &&
+      !TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_RST) &&
+      (Nbuf->TotalSize == 0)
+      )
+  {
+    Len = (UINT16)(Len + TcpBuildSackOption (Tcb, Nbuf, (40 - Len - TCP_OPTION_SACK_HEAD_ALIGNED_LEN) / TCP_OPTION_SACK_BLOCK_LEN));
+  }
+
   return Len;
 }
 
@@ -234,15 +371,18 @@ TcpParseOption (
   IN OUT TCP_OPTION  *Option
   )
 {
-  UINT8  *Head;
-  UINT8  TotalLen;
-  UINT8  Cur;
-  UINT8  Type;
-  UINT8  Len;
+  UINT8   *Head;
+  UINT8   TotalLen;
+  UINT8   Cur;
+  UINT8   Type;
+  UINT8   Len;
+  UINT32  Blocks;
+  UINT32  Index;
 
   ASSERT ((Tcp != NULL) && (Option != NULL));
 
-  Option->Flag = 0;
+  Option->Flag      = 0;
+  Option->SackCount = 0;
 
   TotalLen = (UINT8)((Tcp->HeadLen << 2) - sizeof (TCP_HEAD));
   if (TotalLen <= 0) {
@@ -311,6 +451,44 @@ TcpParseOption (
         Cur += TCP_OPTION_TS_LEN;
         break;
 
+      case TCP_OPTION_SACK_PERM:
+        Len = Head[Cur + 1];
+
+        if ((Len != TCP_OPTION_SACK_PERM_LEN) || (TotalLen - Cur < TCP_OPTION_SACK_PERM_LEN)) {
+          return -1;
+        }
+
+        TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK_PERM);
+
+        Cur += TCP_OPTION_SACK_PERM_LEN;
+        break;
+
+      case TCP_OPTION_SACK:
+        Len = Head[Cur + 1];
+
+        if ((Len < TCP_OPTION_SACK_HEAD_LEN) || (TotalLen - Cur < Len)) {
+          return -1;
+        }
+
+        //
+        // A SACK option with a bad number of blocks is ignored.
+        //
+        Blocks = (Len - TCP_OPTION_SACK_HEAD_LEN) / TCP_OPTION_SACK_BLOCK_LEN;
+        if ((Blocks != 0) && (Blocks <= TCP_SACK_MAX_BLOCKS) &&
+            ((Len - TCP_OPTION_SACK_HEAD_LEN) % TCP_OPTION_SACK_BLOCK_LEN == 0))
+        {
+          for (Index = 0; Index < Blocks; Index++) {
+            Option->SackBlock[Index].Left  = TcpGetUint32 (&Head[Cur + 2 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+            Option->SackBlock[Index].Right = TcpGetUint32 (&Head[Cur + 6 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+          }
+
+          Option->SackCount = Blocks;
+          TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK);
+        }
+
+        Cur = (UINT8)(Cur + Len);
+        break;
+
       case TCP_OPTION_NOP:
         Cur++;
         break;
@@ -1,7 +1,7 @@
 /** @file
   Tcp option's routine header file.
 
-  Copyright (c) 2009 - 2018, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2009 - 2026, Intel Corporation. All rights reserved.<BR>
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -13,16 +13,23 @@
 //
 // Supported TCP option types and their length.
 //
-#define TCP_OPTION_EOP             0  ///< End Of oPtion
-#define TCP_OPTION_NOP             1  ///< No-Option.
-#define TCP_OPTION_MSS             2  ///< Maximum Segment Size
-#define TCP_OPTION_WS              3  ///< Window scale
-#define TCP_OPTION_TS              8  ///< Timestamp
-#define TCP_OPTION_MSS_LEN         4  ///< Length of MSS option
-#define TCP_OPTION_WS_LEN          3  ///< Length of window scale option
-#define TCP_OPTION_TS_LEN          10 ///< Length of timestamp option
-#define TCP_OPTION_WS_ALIGNED_LEN  4  ///< Length of window scale option, aligned
-#define TCP_OPTION_TS_ALIGNED_LEN  12 ///< Length of timestamp option, aligned
+#define TCP_OPTION_EOP                    0  ///< End Of oPtion
+#define TCP_OPTION_NOP                    1  ///< No-Option.
+#define TCP_OPTION_MSS                    2  ///< Maximum Segment Size
+#define TCP_OPTION_WS                     3  ///< Window scale
+#define TCP_OPTION_SACK_PERM              4  ///< SACK permitted
+#define TCP_OPTION_SACK                   5  ///< SACK
+#define TCP_OPTION_TS                     8  ///< Timestamp
+#define TCP_OPTION_MSS_LEN                4  ///< Length of MSS option
+#define TCP_OPTION_WS_LEN                 3  ///< Length of window scale option
+#define TCP_OPTION_SACK_PERM_LEN          2  ///< Length of SACK permitted option
+#define TCP_OPTION_SACK_HEAD_LEN          2  ///< Length of SACK option without blocks
+#define TCP_OPTION_SACK_BLOCK_LEN         8  ///< Length of a block in SACK option
+#define TCP_OPTION_TS_LEN                 10 ///< Length of timestamp option
+#define TCP_OPTION_WS_ALIGNED_LEN         4  ///< Length of window scale option, aligned
+#define TCP_OPTION_SACK_PERM_ALIGNED_LEN  4  ///< Length of SACK permitted option, aligned
+#define TCP_OPTION_SACK_HEAD_ALIGNED_LEN  4  ///< Length of SACK option without blocks, aligned
+#define TCP_OPTION_TS_ALIGNED_LEN         12 ///< Length of timestamp option, aligned
 
 //
 // recommend format of timestamp window scale
@@ -39,25 +46,41 @@
 
 #define TCP_OPTION_MSS_FAST  ((TCP_OPTION_MSS << 24) | (TCP_OPTION_MSS_LEN << 16))
 
+#define TCP_OPTION_SACK_PERM_FAST  ((TCP_OPTION_NOP << 24) |       \
+                                     (TCP_OPTION_NOP << 16) |      \
+                                     (TCP_OPTION_SACK_PERM << 8) | \
+                                     (TCP_OPTION_SACK_PERM_LEN))
+
+//
+// The length byte of the SACK option is filled in by the builder.
+//
+#define TCP_OPTION_SACK_FAST  ((TCP_OPTION_NOP << 24) |  \
+                                (TCP_OPTION_NOP << 16) | \
+                                (TCP_OPTION_SACK << 8))
+
 //
 // Other misc definitions
 //
-#define TCP_OPTION_RCVD_MSS  0x01
-#define TCP_OPTION_RCVD_WS   0x02
-#define TCP_OPTION_RCVD_TS   0x04
-#define TCP_OPTION_MAX_WS    14            ///< Maximum window scale value
-#define TCP_OPTION_MAX_WIN   0xffff        ///< Max window size in TCP header
+#define TCP_OPTION_RCVD_MSS        0x01
+#define TCP_OPTION_RCVD_WS         0x02
+#define TCP_OPTION_RCVD_TS         0x04
+#define TCP_OPTION_RCVD_SACK_PERM  0x08
+#define TCP_OPTION_RCVD_SACK       0x10
+#define TCP_OPTION_MAX_WS          14     ///< Maximum window scale value
+#define TCP_OPTION_MAX_WIN         0xffff ///< Max window size in TCP header
 
 ///
 /// The structure to store the parse option value.
 /// ParseOption only parses the options, doesn't process them.
 ///
 typedef struct _TCP_OPTION {
-  UINT8     Flag;     ///< Flag such as TCP_OPTION_RCVD_MSS
-  UINT8     WndScale; ///< The WndScale received
-  UINT16    Mss;      ///< The Mss received
-  UINT32    TSVal;    ///< The TSVal field in a timestamp option
-  UINT32    TSEcr;    ///< The TSEcr field in a timestamp option
+  UINT8             Flag;                           ///< Flag such as TCP_OPTION_RCVD_MSS
+  UINT8             WndScale;                       ///< The WndScale received
+  UINT16            Mss;                            ///< The Mss received
+  UINT32            TSVal;                          ///< The TSVal field in a timestamp option
+  UINT32            TSEcr;                          ///< The TSEcr field in a timestamp option
+  UINT32            SackCount;                      ///< The number of blocks in a SACK option
+  TCP_SACK_BLOCK    SackBlock[TCP_SACK_MAX_BLOCKS]; ///< The blocks in a SACK option
 } TCP_OPTION;
 
 /**
@@ -1,7 +1,7 @@
 /** @file
   TCP output process routines.
 
-  Copyright (c) 2009 - 2018, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2009 - 2026, Intel Corporation. All rights reserved.<BR>
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -357,9 +357,8 @@ TcpTransmitSegment (
     }
   }
 
-  Head->Flag     = Seg->Flag;
-  Head->Urg      = NTOHS (Seg->Urg);
-  Head->Checksum = TcpChecksum (Nbuf, Tcb->HeadSum);
+  Head->Flag = Seg->Flag;
+  Head->Urg  = NTOHS (Seg->Urg);
 
   //
   // Update the TCP session's control information.
@@ -619,19 +618,22 @@ TcpGetSegment (
 }
 
 /**
-  Retransmit the segment from sequence Seq.
+  Retransmit at most Limit bytes of the segment from sequence Seq.
 
   @param[in]  Tcb     Pointer to the TCP_CB of this TCP instance.
   @param[in]  Seq     The sequence number of the segment to be retransmitted.
+  @param[in]  Limit   The maximum number of bytes to retransmit.
 
-  @retval 0       Retransmission succeeded.
-  @retval -1      Error condition occurred.
+  @return The number of bytes retransmitted, or -1 if an error condition
+          occurred.
 
 **/
+STATIC
 INTN
-TcpRetransmit (
+TcpRetransmitLimit (
   IN TCP_CB     *Tcb,
-  IN TCP_SEQNO  Seq
+  IN TCP_SEQNO  Seq,
+  IN UINT32     Limit
   )
 {
   NET_BUF  *Nbuf;
@@ -640,7 +642,7 @@ TcpRetransmit (
   //
   // Compute the maximum length of retransmission. It is
   // limited by three factors:
-  // 1. Less than SndMss
+  // 1. Less than SndMss and Limit
   // 2. Must in the current send window
   // 3. Will not change the boundaries of queued segments.
   //
@@ -673,7 +675,7 @@ TcpRetransmit (
     return 0;
   }
 
-  Len = MIN (Len, Tcb->SndMss);
+  Len = MIN (Len, MIN (Tcb->SndMss, Limit));
 
   Nbuf = TcpGetSegmentSndQue (Tcb, Seq, Len);
   if (Nbuf == NULL) {
@@ -701,8 +703,10 @@ TcpRetransmit (
   NetbufTrim (Nbuf, (Nbuf->Tcp->HeadLen << 2), NET_BUF_HEAD);
   Nbuf->Tcp = NULL;
 
+  Len = TCP_SUB_SEQ (TCPSEG_NETBUF (Nbuf)->End, Seq);
+
   NetbufFree (Nbuf);
-  return 0;
+  return (INTN)Len;
 
 OnError:
   if (Nbuf != NULL) {
@@ -712,6 +716,103 @@ OnError:
   return -1;
 }
 
+/**
+  Retransmit the segment from sequence Seq.
+
+  @param[in]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]  Seq     The sequence number of the segment to be retransmitted.
+
+  @retval 0       Retransmission succeeded.
+  @retval -1      Error condition occurred.
+
+**/
+INTN
+TcpRetransmit (
+  IN TCP_CB     *Tcb,
+  IN TCP_SEQNO  Seq
+  )
+{
+  if (TcpRetransmitLimit (Tcb, Seq, Tcb->SndMss) < 0) {
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+  Retransmit the lost data in the SACK scoreboard, then open the congestion
+  window for new data, both within the budget given by the proportional rate
+  reduction.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       SndUna  The SND.UNA acknowledged by the incoming segment.
+  @param[in]       SndCnt  The number of bytes that may be sent.
+
+**/
+VOID
+TcpSackRetransmit (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  SndUna,
+  IN     UINT32     SndCnt
+  )
+{
+  TCP_SEQNO  Seq;
+  UINT32     Len;
+  INTN       Sent;
+
+  ASSERT (Tcb->CongestState == TCP_CONGEST_RECOVER);
+
+  while (SndCnt > 0) {
+    if (!TcpSackNextSeg (&Tcb->Sack, SndUna, Tcb->SndMss, &Seq, &Len)) {
+      //
+      // The first unacknowledged segment is retransmitted, even if
+      // the scoreboard doesn't consider it lost, when the recovery
+      // starts on duplicate ACKs, or, as NewReno does on a partial
+      // ACK, when all the retransmissions are ACKed and nothing
+      // above SND.UNA is SACKed.
+      //
+      if ((Tcb->Sack.HighRxt != SndUna) ||
+          ((Tcb->Prr.Out != 0) && (Tcb->Sack.Count != 0)))
+      {
+        break;
+      }
+
+      Seq = SndUna;
+      Len = Tcb->SndMss;
+      if (Tcb->Sack.Count != 0) {
+        Len = MIN (Len, TCP_SUB_SEQ (Tcb->Sack.Block[0].Left, SndUna));
+      }
+
+      if ((Len == 0) || (SndUna == Tcb->SndNxt)) {
+        break;
+      }
+    }
+
+    Sent = TcpRetransmitLimit (Tcb, Seq, Len);
+    if (Sent <= 0) {
+      break;
+    }
+
+    Tcb->Sack.HighRxt = Seq + (UINT32)Sent;
+    Tcb->Prr.Out     += (UINT32)Sent;
+    SndCnt           -= MIN (SndCnt, (UINT32)Sent);
+
+    DEBUG (
+      (DEBUG_NET,
+       "TcpSackRetransmit: retransmit %d bytes from %d for TCB %p\n",
+       (UINT32)Sent,
+       Seq,
+       Tcb)
+      );
+  }
+
+  //
+  // The rest of the budget goes to new data, sent by TcpToSendData
+  // once SND.UNA is updated.
+  //
+  Tcb->CWnd = TCP_SUB_SEQ (Tcb->SndNxt, SndUna) + SndCnt;
+}
+
 /**
   Verify that all the segments in SndQue are in good shape.
 
@@ -902,6 +1003,10 @@ TcpToSendData (
 
     Sent += TCP_SUB_SEQ (End, Seq);
 
+    if (Tcb->CongestState == TCP_CONGEST_RECOVER) {
+      Tcb->Prr.Out += TCP_SUB_SEQ (End, Seq);
+    }
+
     //
     // All the buffers in the SndQue are headless.
     //
@@ -1103,7 +1208,6 @@ TcpSendReset (
 {
   NET_BUF   *Nbuf;
   TCP_HEAD  *Nhead;
-  UINT16    HeadSum;
 
   //
   // Don't respond to a Reset with reset.
@@ -1156,14 +1260,6 @@ TcpSendReset (
   Nhead->Checksum = 0;
   Nhead->Urg      = 0;
 
-  if (Version == IP_VERSION_4) {
-    HeadSum = NetPseudoHeadChecksum (Local->Addr[0], Remote->Addr[0], 6, 0);
-  } else {
-    HeadSum = NetIp6PseudoHeadChecksum (&Local->v6, &Remote->v6, 6, 0);
-  }
-
-  Nhead->Checksum = TcpChecksum (Nbuf, HeadSum);
-
   TcpSendIpPacket (Tcb, Nbuf, Local, Remote, Version);
 
   NetbufFree (Nbuf);
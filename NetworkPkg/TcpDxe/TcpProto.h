@@ -1,7 +1,7 @@
 /** @file
   TCP protocol header file.
 
-  Copyright (c) 2009 - 2017, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2009 - 2026, Intel Corporation. All rights reserved.<BR>
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -48,7 +48,7 @@
 //
 // Current congestion status as suggested by RFC3782.
 //
-#define TCP_CONGEST_RECOVER  1      ///< During the NewReno fast recovery.
+#define TCP_CONGEST_RECOVER  1      ///< During the NewReno or SACK fast recovery.
 #define TCP_CONGEST_LOSS     2      ///< Retxmit because of retxmit time out.
 #define TCP_CONGEST_OPEN     3      ///< TCP is opening its congestion window.
 
@@ -70,6 +70,8 @@
 #define TCP_CTRL_TIMER_ON      0x1000   ///< At least one of the timer is on.
 #define TCP_CTRL_RTT_ON        0x2000   ///< The RTT measurement is on.
 #define TCP_CTRL_ACK_NOW       0x4000   ///< Send the ACK now, don't delay.
+#define TCP_CTRL_NO_SACK       0x8000   ///< Disable SACK option.
+#define TCP_CTRL_RCVD_SACK     0x10000  ///< Received a SACK permitted option in syn.
 
 //
 // Timer related values
@@ -150,24 +152,6 @@
 //
 #define TCPSEG_NETBUF(NBuf)  ((TCP_SEG *) ((NBuf)->ProtoData))
 
-//
-// Macros to compare sequence no
-//
-#define TCP_SEQ_LT(SeqA, SeqB)   ((INT32) ((SeqA) - (SeqB)) < 0)
-#define TCP_SEQ_LEQ(SeqA, SeqB)  ((INT32) ((SeqA) - (SeqB)) <= 0)
-#define TCP_SEQ_GT(SeqA, SeqB)   ((INT32) ((SeqB) - (SeqA)) < 0)
-#define TCP_SEQ_GEQ(SeqA, SeqB)  ((INT32) ((SeqB) - (SeqA)) <= 0)
-
-//
-// TCP_SEQ_BETWEEN return whether b <= m <= e
-//
-#define TCP_SEQ_BETWEEN(b, m, e)  ((e) - (b) >= (m) - (b))
-
-//
-// TCP_SUB_SEQ returns Seq1 - Seq2. Make sure Seq1 >= Seq2
-//
-#define TCP_SUB_SEQ(Seq1, Seq2)  ((UINT32) ((Seq1) - (Seq2)))
-
 //
 // Check whether Flag is on
 //
@@ -247,9 +231,6 @@ struct _TCP_CONTROL_BLOCK {
   //
   UINT8               State;      ///< TCP state, such as SYN_SENT, LISTEN.
   UINT8               DelayedAck; ///< Number of delayed ACKs.
-  UINT16              HeadSum;    ///< Checksum of the fixed parts of pesudo
-                                  ///< header: Src IP, Dst IP, 0, Protocol,
-                                  ///< do not include the TCP length.
 
   TCP_SEQNO           Iss;       ///< Initial Sending Sequence.
   TCP_SEQNO           SndUna;    ///< First unacknowledged data.
@@ -306,6 +287,15 @@ struct _TCP_CONTROL_BLOCK {
   UINT8               LossTimes;    ///< Number of retxmit timeouts in a row.
   TCP_SEQNO           LossRecover;  ///< Recover point for retxmit.
 
+  //
+  // RFC2018, 6675 and 6937 variables.
+  // Selective acknowledgment, SACK based loss recovery
+  // and proportional rate reduction.
+  //
+  TCP_SACK_SCOREBOARD Sack;         ///< Data SACKed by the peer.
+  TCP_PRR             Prr;          ///< Rate reduction of the SACK recovery.
+  TCP_SEQNO           RcvSackSeq;   ///< Seq of the last out-of-order segment received.
+
   //
   // RFC7323
   // Addressing Window Retraction for TCP Window Scale Option.
@@ -0,0 +1,464 @@
+/** @file
+  TCP selective acknowledgment scoreboard and proportional rate reduction.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TcpSack.h"
+
+/**
+  Forget all the data SACKed by the peer.
+
+  @param[out]  Sack     Pointer to the scoreboard.
+  @param[in]   SndUna   The current SND.UNA.
+
+**/
+VOID
+TcpSackReset (
+  OUT TCP_SACK_SCOREBOARD  *Sack,
+  IN  TCP_SEQNO            SndUna
+  )
+{
+  Sack->Count       = 0;
+  Sack->SackedBytes = 0;
+  Sack->HighRxt     = SndUna;
+}
+
+/**
+  Remove the SACKed ranges, or the part of them, below SND.UNA.
+
+  @param[in, out]  Sack     Pointer to the scoreboard.
+  @param[in]       SndUna   The new SND.UNA.
+
+**/
+STATIC
+VOID
+TcpSackTrim (
+  IN OUT TCP_SACK_SCOREBOARD  *Sack,
+  IN     TCP_SEQNO            SndUna
+  )
+{
+  UINT32  Index;
+
+  Index = 0;
+  while ((Index < Sack->Count) && TCP_SEQ_LEQ (Sack->Block[Index].Right, SndUna)) {
+    Index++;
+  }
+
+  if (Index != 0) {
+    Sack->Count -= Index;
+    CopyMem (&Sack->Block[0], &Sack->Block[Index], Sack->Count * sizeof (TCP_SACK_BLOCK));
+  }
+
+  if ((Sack->Count != 0) && TCP_SEQ_LT (Sack->Block[0].Left, SndUna)) {
+    Sack->Block[0].Left = SndUna;
+  }
+}
+
+/**
+  Add a SACKed range to the scoreboard, merging it with the ranges it
+  overlaps or touches.
+
+  @param[in, out]  Sack     Pointer to the scoreboard.
+  @param[in]       Left     The first sequence number of the range.
+  @param[in]       Right    The sequence number following the range.
+
+**/
+STATIC
+VOID
+TcpSackInsert (
+  IN OUT TCP_SACK_SCOREBOARD  *Sack,
+  IN     TCP_SEQNO            Left,
+  IN     TCP_SEQNO            Right
+  )
+{
+  UINT32  First;
+  UINT32  Last;
+
+  //
+  // Skip the ranges below the new one, then absorb the ranges
+  // that overlap or touch it.
+  //
+  First = 0;
+  while ((First < Sack->Count) && TCP_SEQ_LT (Sack->Block[First].Right, Left)) {
+    First++;
+  }
+
+  Last = First;
+  while ((Last < Sack->Count) && TCP_SEQ_LEQ (Sack->Block[Last].Left, Right)) {
+    if (TCP_SEQ_LT (Sack->Block[Last].Left, Left)) {
+      Left = Sack->Block[Last].Left;
+    }
+
+    if (TCP_SEQ_GT (Sack->Block[Last].Right, Right)) {
+      Right = Sack->Block[Last].Right;
+    }
+
+    Last++;
+  }
+
+  if (Last == First) {
+    //
+    // A new range. If the scoreboard is full, drop the highest range,
+    // or the new one if it is the highest.
+    //
+    if (Sack->Count == TCP_SACK_SCOREBOARD_SIZE) {
+      if (First == TCP_SACK_SCOREBOARD_SIZE) {
+        return;
+      }
+
+      Sack->Count--;
+    }
+
+    CopyMem (
+      &Sack->Block[First + 1],
+      &Sack->Block[First],
+      (Sack->Count - First) * sizeof (TCP_SACK_BLOCK)
+      );
+    Sack->Count++;
+  } else if (Last > First + 1) {
+    CopyMem (
+      &Sack->Block[First + 1],
+      &Sack->Block[Last],
+      (Sack->Count - Last) * sizeof (TCP_SACK_BLOCK)
+      );
+    Sack->Count -= Last - First - 1;
+  }
+
+  Sack->Block[First].Left  = Left;
+  Sack->Block[First].Right = Right;
+}
+
+/**
+  Update the scoreboard with the cumulative ACK and the SACK blocks of an
+  incoming segment.
+
+  Blocks that are not inside [NewUna, SndNxt) are ignored or trimmed, as
+  they are stale or bogus. If the scoreboard is full, the highest ranges are
+  dropped since the lowest ranges matter most to detect losses.
+
+  @param[in, out]  Sack        Pointer to the scoreboard.
+  @param[in]       OldUna      SND.UNA before the segment.
+  @param[in]       NewUna      The ACK of the segment, SND.UNA <= ACK <= SND.NXT.
+  @param[in]       SndNxt      The current SND.NXT.
+  @param[in]       Block       The SACK blocks of the segment.
+  @param[in]       BlockCount  The number of SACK blocks.
+
+  @return The number of bytes newly delivered to the peer, DeliveredData of
+          RFC6937.
+
+**/
+UINT32
+TcpSackUpdate (
+  IN OUT TCP_SACK_SCOREBOARD  *Sack,
+  IN     TCP_SEQNO            OldUna,
+  IN     TCP_SEQNO            NewUna,
+  IN     TCP_SEQNO            SndNxt,
+  IN     CONST TCP_SACK_BLOCK *Block,
+  IN     UINT32               BlockCount
+  )
+{
+  UINT32     OldSacked;
+  UINT32     Delivered;
+  UINT32     Index;
+  TCP_SEQNO  Left;
+  TCP_SEQNO  Right;
+
+  ASSERT (BlockCount <= TCP_SACK_MAX_BLOCKS);
+
+  OldSacked = Sack->SackedBytes;
+
+  TcpSackTrim (Sack, NewUna);
+
+  for (Index = 0; Index < BlockCount; Index++) {
+    Left  = Block[Index].Left;
+    Right = Block[Index].Right;
+
+    if (TCP_SEQ_LT (Left, NewUna)) {
+      Left = NewUna;
+    }
+
+    if (TCP_SEQ_GT (Right, SndNxt)) {
+      Right = SndNxt;
+    }
+
+    if (TCP_SEQ_LT (Left, Right)) {
+      TcpSackInsert (Sack, Left, Right);
+    }
+  }
+
+  Sack->SackedBytes = 0;
+  for (Index = 0; Index < Sack->Count; Index++) {
+    Sack->SackedBytes += TCP_SUB_SEQ (Sack->Block[Index].Right, Sack->Block[Index].Left);
+  }
+
+  if (TCP_SEQ_LT (Sack->HighRxt, NewUna)) {
+    Sack->HighRxt = NewUna;
+  }
+
+  //
+  // Cumulatively ACKed bytes that were SACKed before are counted once:
+  // they are in the advance of SND.UNA and leave the SACKed bytes. The
+  // SACKed bytes may also shrink when a full scoreboard drops its highest
+  // range, which delivers nothing.
+  //
+  Delivered = TCP_SUB_SEQ (NewUna, OldUna) + Sack->SackedBytes;
+  if (Delivered <= OldSacked) {
+    return 0;
+  }
+
+  return Delivered - OldSacked;
+}
+
+/**
+  Check whether the segment starting at Seq is lost, IsLost() of RFC6675.
+
+  @param[in]  Sack     Pointer to the scoreboard.
+  @param[in]  Seq      The first sequence number of the segment.
+  @param[in]  Mss      The sender's maximum segment size.
+
+  @retval TRUE         At least DupThresh ranges or more than
+                       (DupThresh - 1) * Mss bytes above Seq are SACKed.
+  @retval FALSE        The segment is not considered lost.
+
+**/
+BOOLEAN
+TcpSackIsLost (
+  IN CONST TCP_SACK_SCOREBOARD  *Sack,
+  IN TCP_SEQNO                  Seq,
+  IN UINT32                     Mss
+  )
+{
+  UINT32  Index;
+  UINT32  Ranges;
+  UINT32  Bytes;
+
+  Ranges = 0;
+  Bytes  = 0;
+
+  for (Index = Sack->Count; Index > 0; Index--) {
+    if (TCP_SEQ_LEQ (Sack->Block[Index - 1].Right, Seq)) {
+      break;
+    }
+
+    Ranges++;
+    if (TCP_SEQ_LT (Sack->Block[Index - 1].Left, Seq)) {
+      Bytes += TCP_SUB_SEQ (Sack->Block[Index - 1].Right, Seq);
+    } else {
+      Bytes += TCP_SUB_SEQ (Sack->Block[Index - 1].Right, Sack->Block[Index - 1].Left);
+    }
+  }
+
+  return (BOOLEAN)((Ranges >= TCP_SACK_DUP_THRESH) ||
+                   (Bytes > (TCP_SACK_DUP_THRESH - 1) * Mss));
+}
+
+/**
+  Find the next lost data to retransmit, rule (1) of NextSeg() of RFC6675.
+
+  @param[in]   Sack     Pointer to the scoreboard.
+  @param[in]   SndUna   The current SND.UNA.
+  @param[in]   Mss      The sender's maximum segment size.
+  @param[out]  Seq      The first sequence number to retransmit.
+  @param[out]  Len      The number of bytes to retransmit, at most Mss.
+
+  @retval TRUE         A lost hole above HighRxt is found.
+  @retval FALSE        Nothing is to be retransmitted.
+
+**/
+BOOLEAN
+TcpSackNextSeg (
+  IN  CONST TCP_SACK_SCOREBOARD  *Sack,
+  IN  TCP_SEQNO                  SndUna,
+  IN  UINT32                     Mss,
+  OUT TCP_SEQNO                  *Seq,
+  OUT UINT32                     *Len
+  )
+{
+  UINT32     Index;
+  TCP_SEQNO  Start;
+  TCP_SEQNO  Left;
+  TCP_SEQNO  Right;
+
+  Start = Sack->HighRxt;
+  if (TCP_SEQ_LT (Start, SndUna)) {
+    Start = SndUna;
+  }
+
+  //
+  // The holes are the unSACKed data below the highest SACKed range.
+  // A hole is lost if enough data above it is SACKed, so once a hole
+  // isn't lost, the holes above it aren't either.
+  //
+  Left = SndUna;
+  for (Index = 0; Index < Sack->Count; Index++) {
+    Right = Sack->Block[Index].Left;
+    if (TCP_SEQ_LT (Left, Start)) {
+      Left = Start;
+    }
+
+    if (TCP_SEQ_LT (Left, Right)) {
+      if (!TcpSackIsLost (Sack, Left, Mss)) {
+        return FALSE;
+      }
+
+      *Seq = Left;
+      *Len = MIN (TCP_SUB_SEQ (Right, Left), Mss);
+      return TRUE;
+    }
+
+    Left = Sack->Block[Index].Right;
+  }
+
+  return FALSE;
+}
+
+/**
+  Estimate the number of bytes still in the network, SetPipe() of RFC6675.
+
+  @param[in]  Sack     Pointer to the scoreboard.
+  @param[in]  SndUna   The current SND.UNA.
+  @param[in]  SndNxt   The current SND.NXT.
+  @param[in]  Mss      The sender's maximum segment size.
+
+  @return The number of bytes in flight.
+
+**/
+UINT32
+TcpSackPipe (
+  IN CONST TCP_SACK_SCOREBOARD  *Sack,
+  IN TCP_SEQNO                  SndUna,
+  IN TCP_SEQNO                  SndNxt,
+  IN UINT32                     Mss
+  )
+{
+  UINT32     Pipe;
+  UINT32     Index;
+  TCP_SEQNO  HighRxt;
+  TCP_SEQNO  Left;
+  TCP_SEQNO  Right;
+  BOOLEAN    Lost;
+
+  Pipe    = 0;
+  HighRxt = Sack->HighRxt;
+  if (TCP_SEQ_LT (HighRxt, SndUna)) {
+    HighRxt = SndUna;
+  }
+
+  //
+  // Walk the holes, and the unSACKed data above the highest SACKed
+  // range. The original transmission of a hole is in flight unless the
+  // hole is lost, and its retransmission, if any, is in flight too.
+  //
+  Left = SndUna;
+  for (Index = 0; Index <= Sack->Count; Index++) {
+    if (Index < Sack->Count) {
+      Right = Sack->Block[Index].Left;
+      Lost  = TcpSackIsLost (Sack, Left, Mss);
+    } else {
+      Right = SndNxt;
+      Lost  = FALSE;
+    }
+
+    if (TCP_SEQ_GT (Right, SndNxt)) {
+      Right = SndNxt;
+    }
+
+    if (TCP_SEQ_LT (Left, Right)) {
+      if (!Lost) {
+        Pipe += TCP_SUB_SEQ (Right, Left);
+      }
+
+      if (TCP_SEQ_LT (Left, HighRxt)) {
+        Pipe += TCP_SUB_SEQ (TCP_SEQ_LT (HighRxt, Right) ? HighRxt : Right, Left);
+      }
+    }
+
+    if (Index < Sack->Count) {
+      Left = Sack->Block[Index].Right;
+    }
+  }
+
+  return Pipe;
+}
+
+/**
+  Start a proportional rate reduction.
+
+  @param[out]  Prr         Pointer to the PRR state.
+  @param[in]   FlightSize  The bytes in flight when the loss is detected.
+
+**/
+VOID
+TcpPrrStart (
+  OUT TCP_PRR  *Prr,
+  IN  UINT32   FlightSize
+  )
+{
+  Prr->RecoverFs = MAX (FlightSize, 1);
+  Prr->Delivered = 0;
+  Prr->Out       = 0;
+}
+
+/**
+  Compute how many bytes may be sent on an ACK in fast recovery, sndcnt of
+  RFC6937 with the slow start reduction bound (PRR-SSRB).
+
+  @param[in, out]  Prr        Pointer to the PRR state.
+  @param[in]       Delivered  The bytes delivered by the ACK.
+  @param[in]       Pipe       The bytes in flight after the ACK.
+  @param[in]       Ssthresh   The slow start threshold of the recovery.
+  @param[in]       Mss        The sender's maximum segment size.
+
+  @return The number of bytes that may be sent.
+
+**/
+UINT32
+TcpPrrSndCnt (
+  IN OUT TCP_PRR  *Prr,
+  IN     UINT32   Delivered,
+  IN     UINT32   Pipe,
+  IN     UINT32   Ssthresh,
+  IN     UINT32   Mss
+  )
+{
+  UINT64  Target;
+  UINT32  SndCnt;
+  UINT32  Limit;
+
+  Prr->Delivered += Delivered;
+
+  if (Pipe > Ssthresh) {
+    //
+    // Proportional rate reduction: send Ssthresh / RecoverFs of
+    // the delivered data, so the window lands on Ssthresh at the
+    // end of the recovery.
+    //
+    Target = DivU64x32 (
+               MultU64x32 (Prr->Delivered, Ssthresh) + Prr->RecoverFs - 1,
+               Prr->RecoverFs
+               );
+    SndCnt = (Target > Prr->Out) ? (UINT32)(Target - Prr->Out) : 0;
+  } else {
+    //
+    // Slow start reduction bound: grow back to Ssthresh, by at most
+    // one Mss more than the data delivered.
+    //
+    Limit = (Prr->Delivered > Prr->Out) ? (Prr->Delivered - Prr->Out) : 0;
+    Limit = MAX (Limit, Delivered) + Mss;
+
+    SndCnt = MIN (Ssthresh - Pipe, Limit);
+  }
+
+  //
+  // The fast retransmission is always sent.
+  //
+  if ((Prr->Out == 0) && (SndCnt < Mss)) {
+    SndCnt = Mss;
+  }
+
+  return SndCnt;
+}
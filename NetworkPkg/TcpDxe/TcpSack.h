@@ -0,0 +1,214 @@
+/** @file
+  TCP selective acknowledgment header file.
+
+  The sender keeps a scoreboard of the data the peer has selectively
+  acknowledged (RFC2018). During fast recovery the scoreboard tells which
+  holes are lost and how much data is still in the network (RFC6675), and
+  the congestion window follows the proportional rate reduction (RFC6937),
+  so a single lost segment no longer collapses the sending rate.
+
+  The routines only work on the scoreboard and sequence numbers, they don't
+  touch the TCP_CB, the queues or the network. This header doesn't depend on
+  the rest of the driver, so it also holds the sequence number arithmetic.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _TCP_SACK_H_
+#define _TCP_SACK_H_
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/NetLib.h>
+
+//
+// Macros to compare sequence no
+//
+#define TCP_SEQ_LT(SeqA, SeqB)   ((INT32) ((SeqA) - (SeqB)) < 0)
+#define TCP_SEQ_LEQ(SeqA, SeqB)  ((INT32) ((SeqA) - (SeqB)) <= 0)
+#define TCP_SEQ_GT(SeqA, SeqB)   ((INT32) ((SeqB) - (SeqA)) < 0)
+#define TCP_SEQ_GEQ(SeqA, SeqB)  ((INT32) ((SeqB) - (SeqA)) <= 0)
+
+//
+// TCP_SEQ_BETWEEN return whether b <= m <= e
+//
+#define TCP_SEQ_BETWEEN(b, m, e)  ((e) - (b) >= (m) - (b))
+
+//
+// TCP_SUB_SEQ returns Seq1 - Seq2. Make sure Seq1 >= Seq2
+//
+#define TCP_SUB_SEQ(Seq1, Seq2)  ((UINT32) ((Seq1) - (Seq2)))
+
+#define TCP_SACK_MAX_BLOCKS       4  ///< Max SACK blocks in a SACK option.
+#define TCP_SACK_SCOREBOARD_SIZE  32 ///< Max SACKed ranges remembered by the sender.
+#define TCP_SACK_DUP_THRESH       3  ///< DupThresh of RFC6675.
+
+///
+/// A block of contiguous sequence space, [Left, Right).
+///
+typedef struct _TCP_SACK_BLOCK {
+  TCP_SEQNO    Left;  ///< The first sequence number of the block.
+  TCP_SEQNO    Right; ///< The sequence number following the last byte of the block.
+} TCP_SACK_BLOCK;
+
+///
+/// The data SACKed by the peer, above SND.UNA.
+///
+typedef struct _TCP_SACK_SCOREBOARD {
+  TCP_SACK_BLOCK    Block[TCP_SACK_SCOREBOARD_SIZE]; ///< Sorted and disjoint SACKed ranges.
+  UINT32            Count;                           ///< The number of ranges in Block.
+  UINT32            SackedBytes;                     ///< The number of bytes in Block.
+  TCP_SEQNO         HighRxt;                         ///< The highest sequence retransmitted in recovery.
+} TCP_SACK_SCOREBOARD;
+
+///
+/// State of the proportional rate reduction of RFC6937.
+///
+typedef struct _TCP_PRR {
+  UINT32    RecoverFs; ///< FlightSize when the recovery started.
+  UINT32    Delivered; ///< Bytes delivered to the peer in the recovery.
+  UINT32    Out;       ///< Bytes sent in the recovery.
+} TCP_PRR;
+
+/**
+  Forget all the data SACKed by the peer.
+
+  @param[out]  Sack     Pointer to the scoreboard.
+  @param[in]   SndUna   The current SND.UNA.
+
+**/
+VOID
+TcpSackReset (
+  OUT TCP_SACK_SCOREBOARD  *Sack,
+  IN  TCP_SEQNO            SndUna
+  );
+
+/**
+  Update the scoreboard with the cumulative ACK and the SACK blocks of an
+  incoming segment.
+
+  Blocks that are not inside [NewUna, SndNxt) are ignored or trimmed, as
+  they are stale or bogus. If the scoreboard is full, the highest ranges are
+  dropped since the lowest ranges matter most to detect losses.
+
+  @param[in, out]  Sack        Pointer to the scoreboard.
+  @param[in]       OldUna      SND.UNA before the segment.
+  @param[in]       NewUna      The ACK of the segment, SND.UNA <= ACK <= SND.NXT.
+  @param[in]       SndNxt      The current SND.NXT.
+  @param[in]       Block       The SACK blocks of the segment.
+  @param[in]       BlockCount  The number of SACK blocks.
+
+  @return The number of bytes newly delivered to the peer, DeliveredData of
+          RFC6937.
+
+**/
+UINT32
+TcpSackUpdate (
+  IN OUT TCP_SACK_SCOREBOARD  *Sack,
+  IN     TCP_SEQNO            OldUna,
+  IN     TCP_SEQNO            NewUna,
+  IN     TCP_SEQNO            SndNxt,
+  IN     CONST TCP_SACK_BLOCK *Block,
+  IN     UINT32               BlockCount
+  );
+
+/**
+  Check whether the segment starting at Seq is lost, IsLost() of RFC6675.
+
+  @param[in]  Sack     Pointer to the scoreboard.
+  @param[in]  Seq      The first sequence number of the segment.
+  @param[in]  Mss      The sender's maximum segment size.
+
+  @retval TRUE         At least DupThresh ranges or more than
+                       (DupThresh - 1) * Mss bytes above Seq are SACKed.
+  @retval FALSE        The segment is not considered lost.
+
+**/
+BOOLEAN
+TcpSackIsLost (
+  IN CONST TCP_SACK_SCOREBOARD  *Sack,
+  IN TCP_SEQNO                  Seq,
+  IN UINT32                     Mss
+  );
+
+/**
+  Find the next lost data to retransmit, rule (1) of NextSeg() of RFC6675.
+
+  @param[in]   Sack     Pointer to the scoreboard.
+  @param[in]   SndUna   The current SND.UNA.
+  @param[in]   Mss      The sender's maximum segment size.
+  @param[out]  Seq      The first sequence number to retransmit.
+  @param[out]  Len      The number of bytes to retransmit, at most Mss.
+
+  @retval TRUE         A lost hole above HighRxt is found.
+  @retval FALSE        Nothing is to be retransmitted.
+
+**/
+BOOLEAN
+TcpSackNextSeg (
+  IN  CONST TCP_SACK_SCOREBOARD  *Sack,
+  IN  TCP_SEQNO                  SndUna,
+  IN  UINT32                     Mss,
+  OUT TCP_SEQNO                  *Seq,
+  OUT UINT32                     *Len
+  );
+
+/**
+  Estimate the number of bytes still in the network, SetPipe() of RFC6675.
+
+  @param[in]  Sack     Pointer to the scoreboard.
+  @param[in]  SndUna   The current SND.UNA.
+  @param[in]  SndNxt   The current SND.NXT.
+  @param[in]  Mss      The sender's maximum segment size.
+
+  @return The number of bytes in flight.
+
+**/
+UINT32
+TcpSackPipe (
+  IN CONST TCP_SACK_SCOREBOARD  *Sack,
+  IN TCP_SEQNO                  SndUna,
+  IN TCP_SEQNO                  SndNxt,
+  IN UINT32                     Mss
+  );
+
+/**
+  Start a proportional rate reduction.
+
+  @param[out]  Prr         Pointer to the PRR state.
+  @param[in]   FlightSize  The bytes in flight when the loss is detected.
+
+**/
+VOID
+TcpPrrStart (
+  OUT TCP_PRR  *Prr,
+  IN  UINT32   FlightSize
+  );
+
+/**
+  Compute how many bytes may be sent on an ACK in fast recovery, sndcnt of
+  RFC6937 with the slow start reduction bound (PRR-SSRB).
+
+  @param[in, out]  Prr        Pointer to the PRR state.
+  @param[in]       Delivered  The bytes delivered by the ACK.
+  @param[in]       Pipe       The bytes in flight after the ACK.
+  @param[in]       Ssthresh   The slow start threshold of the recovery.
+  @param[in]       Mss        The sender's maximum segment size.
+
+  @return The number of bytes that may be sent.
+
+**/
+UINT32
+TcpPrrSndCnt (
+  IN OUT TCP_PRR  *Prr,
+  IN     UINT32   Delivered,
+  IN     UINT32   Pipe,
+  IN     UINT32   Ssthresh,
+  IN     UINT32   Mss
+  );
+
+#endif
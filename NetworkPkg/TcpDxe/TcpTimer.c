@@ -1,7 +1,7 @@
 /** @file
   TCP timer related functions.
 
-  Copyright (c) 2009 - 2010, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2009 - 2026, Intel Corporation. All rights reserved.<BR>
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -199,6 +199,12 @@ TcpRexmitTimeout (
   Tcb->CWnd        = Tcb->SndMss;
   Tcb->LossRecover = Tcb->SndNxt;
 
+  //
+  // The peer may renege on the data it SACKed (RFC2018 section 8),
+  // so the scoreboard is not trusted after a retransmission timeout.
+  //
+  TcpSackReset (&Tcb->Sack, Tcb->SndUna);
+
   Tcb->LossTimes++;
   if ((Tcb->LossTimes > Tcb->MaxRexmit) && !TCP_TIMER_ON (Tcb->EnabledTimer, TCP_TIMER_CONNECT)) {
     DEBUG (
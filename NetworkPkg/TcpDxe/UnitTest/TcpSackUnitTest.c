@@ -0,0 +1,885 @@
+/** @file
+  Unit tests and loss recovery benchmark of the TCP SACK scoreboard and the
+  proportional rate reduction.
+
+  The tests check the scoreboard against RFC6675 on hand built cases, then
+  run a bulk transfer over a simulated loopback link that drops chosen
+  segments. The sender recovers either with the SACK scoreboard and PRR, as
+  TcpSackRecover does, or with NewReno, as TcpFastRecover does. Both must
+  deliver all the data, and the time and the retransmissions needed to
+  recover are reported for both.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/UnitTestBenchmarkLib.h>
+
+#include "../TcpSack.h"
+
+#define UNIT_TEST_APP_NAME     "TcpDxe SACK Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_MSS            1460
+#define TEST_ISS            0xFFFF0000 ///< Makes the sequence numbers wrap.
+#define TEST_SEGMENTS       400        ///< Segments of the bulk transfer.
+#define TEST_DELAY          20         ///< One way delay of the link, in ticks.
+#define TEST_RCV_WND        (48 * TEST_MSS)
+#define TEST_INIT_SSTHRESH  TEST_RCV_WND
+#define TEST_RTO            (8 * TEST_DELAY)
+#define TEST_MAX_TICKS      200000
+#define TEST_QUEUE_SIZE     1024
+#define TEST_RANDOM_ROUNDS  50
+
+#define TEST_SEQ(Index)  ((TCP_SEQNO) (TEST_ISS + (Index) * TEST_MSS))
+
+///
+/// A data segment or an ACK on the simulated link.
+///
+typedef struct {
+  UINT32            Arrive;
+  TCP_SEQNO         Seq;
+  UINT32            SackCount;
+  TCP_SACK_BLOCK    Sack[3];
+} TEST_PACKET;
+
+typedef struct {
+  TEST_PACKET    Packet[TEST_QUEUE_SIZE];
+  UINT32         Head;
+  UINT32         Count;
+} TEST_QUEUE;
+
+///
+/// The state of one simulated transfer.
+///
+typedef struct {
+  BOOLEAN                UseSack;
+  UINT32                 Now;
+  UINT32                 LinkFree;
+  TEST_QUEUE             Data;
+  TEST_QUEUE             Ack;
+  //
+  // Segments to drop, and how many times each one is still to be dropped.
+  //
+  UINT8                  Drop[TEST_SEGMENTS];
+  //
+  // The receiver.
+  //
+  BOOLEAN                Received[TEST_SEGMENTS];
+  UINT32                 RcvNxt;
+  //
+  // The sender, in segment indexes and bytes.
+  //
+  TCP_SEQNO              SndUna;
+  TCP_SEQNO              SndNxt;
+  TCP_SEQNO              SndEnd;
+  UINT32                 CWnd;
+  UINT32                 Ssthresh;
+  UINT32                 DupAck;
+  BOOLEAN                Recovery;
+  TCP_SEQNO              Recover;
+  UINT32                 LastProgress;
+  TCP_SACK_SCOREBOARD    Sack;
+  TCP_PRR                Prr;
+  //
+  // Statistics.
+  //
+  UINT32                 Retransmits;
+  UINT32                 Timeouts;
+  UINT32                 Recoveries;
+} TEST_TRANSFER;
+
+STATIC TEST_TRANSFER  mTransfer;
+
+/**
+  Queue a packet on one direction of the link.
+
+  @param[in, out]  Queue   The queue of the direction.
+  @param[in]       Packet  The packet.
+**/
+STATIC
+VOID
+TestQueuePush (
+  IN OUT TEST_QUEUE         *Queue,
+  IN     CONST TEST_PACKET  *Packet
+  )
+{
+  ASSERT (Queue->Count < TEST_QUEUE_SIZE);
+  CopyMem (&Queue->Packet[(Queue->Head + Queue->Count) % TEST_QUEUE_SIZE], Packet, sizeof (*Packet));
+  Queue->Count++;
+}
+
+/**
+  Take the first packet of one direction of the link, if it has arrived.
+
+  @param[in, out]  Queue   The queue of the direction.
+  @param[in]       Now     The current time.
+  @param[out]      Packet  The packet.
+
+  @retval TRUE   A packet has arrived.
+  @retval FALSE  No packet has arrived.
+**/
+STATIC
+BOOLEAN
+TestQueuePop (
+  IN OUT TEST_QUEUE   *Queue,
+  IN     UINT32       Now,
+  OUT    TEST_PACKET  *Packet
+  )
+{
+  if ((Queue->Count == 0) || (Queue->Packet[Queue->Head].Arrive > Now)) {
+    return FALSE;
+  }
+
+  CopyMem (Packet, &Queue->Packet[Queue->Head], sizeof (*Packet));
+  Queue->Head = (Queue->Head + 1) % TEST_QUEUE_SIZE;
+  Queue->Count--;
+  return TRUE;
+}
+
+/**
+  Send one segment. The link sends a segment per tick, and drops the segments
+  marked to be dropped.
+
+  @param[in, out]  Transfer  The transfer.
+  @param[in]       Seq       The sequence number of the segment.
+**/
+STATIC
+VOID
+TestSendSegment (
+  IN OUT TEST_TRANSFER  *Transfer,
+  IN     TCP_SEQNO      Seq
+  )
+{
+  TEST_PACKET  Packet;
+  UINT32       Index;
+
+  Index              = TCP_SUB_SEQ (Seq, TEST_ISS) / TEST_MSS;
+  Transfer->LinkFree = MAX (Transfer->LinkFree, Transfer->Now) + 1;
+
+  if (Transfer->Drop[Index] != 0) {
+    Transfer->Drop[Index]--;
+    return;
+  }
+
+  ZeroMem (&Packet, sizeof (Packet));
+  Packet.Arrive = Transfer->LinkFree + TEST_DELAY;
+  Packet.Seq    = Seq;
+  TestQueuePush (&Transfer->Data, &Packet);
+}
+
+/**
+  Retransmit the segment starting at Seq.
+
+  @param[in, out]  Transfer  The transfer.
+  @param[in]       Seq       The sequence number of the segment.
+**/
+STATIC
+VOID
+TestRetransmit (
+  IN OUT TEST_TRANSFER  *Transfer,
+  IN     TCP_SEQNO      Seq
+  )
+{
+  Transfer->Retransmits++;
+  TestSendSegment (Transfer, Seq);
+}
+
+/**
+  Send the new data the congestion window and the receive window allow, as
+  TcpToSendData does.
+
+  @param[in, out]  Transfer  The transfer.
+**/
+STATIC
+VOID
+TestSendNewData (
+  IN OUT TEST_TRANSFER  *Transfer
+  )
+{
+  while ((Transfer->SndNxt != Transfer->SndEnd) &&
+         (TCP_SUB_SEQ (Transfer->SndNxt, Transfer->SndUna) + TEST_MSS <= MIN (Transfer->CWnd, TEST_RCV_WND)))
+  {
+    TestSendSegment (Transfer, Transfer->SndNxt);
+    Transfer->SndNxt += TEST_MSS;
+
+    if (Transfer->Recovery) {
+      Transfer->Prr.Out += TEST_MSS;
+    }
+  }
+}
+
+/**
+  Receive a data segment and ACK it, with the SACK blocks of RFC2018: the
+  block of the segment first, then the other blocks above RCV.NXT.
+
+  @param[in, out]  Transfer  The transfer.
+  @param[in]       Data      The data segment.
+**/
+STATIC
+VOID
+TestReceive (
+  IN OUT TEST_TRANSFER      *Transfer,
+  IN     CONST TEST_PACKET  *Data
+  )
+{
+  TEST_PACKET  Ack;
+  UINT32       Index;
+  UINT32       Left;
+  UINT32       Right;
+
+  Index                      = TCP_SUB_SEQ (Data->Seq, TEST_ISS) / TEST_MSS;
+  Transfer->Received[Index] = TRUE;
+  while ((Transfer->RcvNxt < TEST_SEGMENTS) && Transfer->Received[Transfer->RcvNxt]) {
+    Transfer->RcvNxt++;
+  }
+
+  ZeroMem (&Ack, sizeof (Ack));
+  Ack.Arrive = Transfer->Now + TEST_DELAY;
+  Ack.Seq    = TEST_SEQ (Transfer->RcvNxt);
+
+  if (Transfer->UseSack && (Index > Transfer->RcvNxt)) {
+    for (Left = Index; Transfer->Received[Left - 1]; Left--) {
+    }
+
+    for (Right = Index + 1; Right < TEST_SEGMENTS && Transfer->Received[Right]; Right++) {
+    }
+
+    Ack.Sack[0].Left  = TEST_SEQ (Left);
+    Ack.Sack[0].Right = TEST_SEQ (Right);
+    Ack.SackCount     = 1;
+
+    for (Left = Transfer->RcvNxt; Left < TEST_SEGMENTS && Ack.SackCount < 3; Left = Right) {
+      while (Left < TEST_SEGMENTS && !Transfer->Received[Left]) {
+        Left++;
+      }
+
+      for (Right = Left; Right < TEST_SEGMENTS && Transfer->Received[Right]; Right++) {
+      }
+
+      if ((Left != Right) && (TEST_SEQ (Left) != Ack.Sack[0].Left)) {
+        Ack.Sack[Ack.SackCount].Left  = TEST_SEQ (Left);
+        Ack.Sack[Ack.SackCount].Right = TEST_SEQ (Right);
+        Ack.SackCount++;
+      }
+    }
+  }
+
+  TestQueuePush (&Transfer->Ack, &Ack);
+}
+
+/**
+  Retransmit as TcpSackRetransmit does: the lost holes first, then the first
+  unacknowledged segment if it is the only candidate, then new data.
+
+  @param[in, out]  Transfer  The transfer.
+  @param[in]       SndCnt    The bytes PRR allows to send.
+**/
+STATIC
+VOID
+TestSackRetransmit (
+  IN OUT TEST_TRANSFER  *Transfer,
+  IN     UINT32         SndCnt
+  )
+{
+  TCP_SEQNO  Seq;
+  UINT32     Len;
+
+  while (SndCnt > 0) {
+    if (!TcpSackNextSeg (&Transfer->Sack, Transfer->SndUna, TEST_MSS, &Seq, &Len)) {
+      if ((Transfer->Sack.HighRxt != Transfer->SndUna) ||
+          ((Transfer->Prr.Out != 0) && (Transfer->Sack.Count != 0)) ||
+          (Transfer->SndUna == Transfer->SndNxt))
+      {
+        break;
+      }
+
+      Seq = Transfer->SndUna;
+      Len = TEST_MSS;
+    }
+
+    TestRetransmit (Transfer, Seq);
+    Transfer->Sack.HighRxt = Seq + Len;
+    Transfer->Prr.Out     += Len;
+    SndCnt                -= MIN (SndCnt, Len);
+  }
+
+  Transfer->CWnd = TCP_SUB_SEQ (Transfer->SndNxt, Transfer->SndUna) + SndCnt;
+}
+
+/**
+  Process an ACK at the sender, as TcpInput does.
+
+  @param[in, out]  Transfer  The transfer.
+  @param[in]       Ack       The ACK.
+**/
+STATIC
+VOID
+TestSenderAck (
+  IN OUT TEST_TRANSFER      *Transfer,
+  IN     CONST TEST_PACKET  *Ack
+  )
+{
+  UINT32  Acked;
+  UINT32  Delivered;
+  UINT32  FlightSize;
+  UINT32  Pipe;
+
+  Acked = TCP_SUB_SEQ (Ack->Seq, Transfer->SndUna);
+  if ((Acked == 0) && (Transfer->SndUna != Transfer->SndNxt)) {
+    Transfer->DupAck++;
+  } else if (Acked != 0) {
+    Transfer->DupAck       = 0;
+    Transfer->LastProgress = Transfer->Now;
+  }
+
+  if (Transfer->UseSack) {
+    Delivered = TcpSackUpdate (
+                  &Transfer->Sack,
+                  Transfer->SndUna,
+                  Ack->Seq,
+                  Transfer->SndNxt,
+                  Ack->Sack,
+                  Ack->SackCount
+                  );
+
+    if (Transfer->Recovery || (Transfer->DupAck >= 3) ||
+        TcpSackIsLost (&Transfer->Sack, Ack->Seq, TEST_MSS))
+    {
+      if (!Transfer->Recovery) {
+        FlightSize             = TCP_SUB_SEQ (Transfer->SndNxt, Transfer->SndUna);
+        Transfer->Ssthresh     = MAX (FlightSize >> 1, 2 * TEST_MSS);
+        Transfer->Recover      = Transfer->SndNxt;
+        Transfer->Recovery     = TRUE;
+        Transfer->Sack.HighRxt = Ack->Seq;
+        Transfer->Recoveries++;
+        TcpPrrStart (&Transfer->Prr, FlightSize);
+      } else if (TCP_SEQ_GEQ (Ack->Seq, Transfer->Recover)) {
+        Transfer->CWnd     = Transfer->Ssthresh;
+        Transfer->Recovery = FALSE;
+        Transfer->SndUna   = Ack->Seq;
+        return;
+      }
+
+      Pipe = TcpSackPipe (&Transfer->Sack, Ack->Seq, Transfer->SndNxt, TEST_MSS);
+      TestSackRetransmit (
+        Transfer,
+        TcpPrrSndCnt (&Transfer->Prr, Delivered, Pipe, Transfer->Ssthresh, TEST_MSS)
+        );
+      Transfer->SndUna = Ack->Seq;
+      return;
+    }
+  } else if (Transfer->Recovery) {
+    //
+    // NewReno: a partial ACK retransmits the next hole, one per round trip.
+    //
+    if (TCP_SEQ_GEQ (Ack->Seq, Transfer->Recover)) {
+      Transfer->CWnd     = Transfer->Ssthresh;
+      Transfer->Recovery = FALSE;
+    } else if (Acked != 0) {
+      TestRetransmit (Transfer, Ack->Seq);
+      Transfer->CWnd -= MIN (Transfer->CWnd, Acked);
+      Transfer->CWnd += TEST_MSS;
+    } else {
+      Transfer->CWnd += TEST_MSS;
+    }
+
+    Transfer->SndUna = Ack->Seq;
+    return;
+  } else if (Transfer->DupAck == 3) {
+    FlightSize         = TCP_SUB_SEQ (Transfer->SndNxt, Transfer->SndUna);
+    Transfer->Ssthresh = MAX (FlightSize >> 1, 2 * TEST_MSS);
+    Transfer->CWnd     = Transfer->Ssthresh + 3 * TEST_MSS;
+    Transfer->Recover  = Transfer->SndNxt;
+    Transfer->Recovery = TRUE;
+    Transfer->Recoveries++;
+    TestRetransmit (Transfer, Transfer->SndUna);
+    return;
+  }
+
+  if (Acked != 0) {
+    if (Transfer->CWnd < Transfer->Ssthresh) {
+      Transfer->CWnd += TEST_MSS;
+    } else {
+      Transfer->CWnd += MAX (TEST_MSS * TEST_MSS / Transfer->CWnd, 1);
+    }
+  }
+
+  Transfer->SndUna = Ack->Seq;
+}
+
+/**
+  Run a bulk transfer over the simulated link.
+
+  @param[in, out]  Transfer  The transfer, with UseSack and Drop set.
+
+  @return The ticks needed to deliver all the data.
+**/
+STATIC
+UINT32
+TestRunTransfer (
+  IN OUT TEST_TRANSFER  *Transfer
+  )
+{
+  TEST_PACKET  Packet;
+
+  Transfer->SndUna       = TEST_ISS;
+  Transfer->SndNxt       = TEST_ISS;
+  Transfer->SndEnd       = TEST_SEQ (TEST_SEGMENTS);
+  Transfer->CWnd         = 2 * TEST_MSS;
+  Transfer->Ssthresh     = TEST_INIT_SSTHRESH;
+  Transfer->LastProgress = 0;
+  TcpSackReset (&Transfer->Sack, Transfer->SndUna);
+
+  for (Transfer->Now = 0; Transfer->Now < TEST_MAX_TICKS; Transfer->Now++) {
+    while (TestQueuePop (&Transfer->Data, Transfer->Now, &Packet)) {
+      TestReceive (Transfer, &Packet);
+    }
+
+    while (TestQueuePop (&Transfer->Ack, Transfer->Now, &Packet)) {
+      TestSenderAck (Transfer, &Packet);
+    }
+
+    if (Transfer->SndUna == Transfer->SndEnd) {
+      return Transfer->Now;
+    }
+
+    //
+    // Retransmission timeout, as TcpRexmitTimeout does. The SACKed data is
+    // forgotten, as the receiver may renege on it.
+    //
+    if (Transfer->Now - Transfer->LastProgress > TEST_RTO) {
+      Transfer->Ssthresh     = MAX (TCP_SUB_SEQ (Transfer->SndNxt, Transfer->SndUna) >> 1, 2 * TEST_MSS);
+      Transfer->CWnd         = TEST_MSS;
+      Transfer->Recovery     = FALSE;
+      Transfer->DupAck       = 0;
+      Transfer->SndNxt       = Transfer->SndUna;
+      Transfer->LastProgress = Transfer->Now;
+      Transfer->Timeouts++;
+      TcpSackReset (&Transfer->Sack, Transfer->SndUna);
+    }
+
+    TestSendNewData (Transfer);
+  }
+
+  return TEST_MAX_TICKS;
+}
+
+/**
+  Run a bulk transfer with and without SACK, and report the results.
+
+  @param[in]  Name       The name of the loss pattern.
+  @param[in]  Drop       The times each segment is dropped.
+  @param[out] SackTicks  The ticks the transfer with SACK needs.
+  @param[out] RenoTicks  The ticks the transfer with NewReno needs.
+
+  @retval UNIT_TEST_PASSED               Both transfers deliver all the data.
+  @retval UNIT_TEST_ERROR_TEST_FAILED    A transfer doesn't complete.
+**/
+STATIC
+UNIT_TEST_STATUS
+TestCompare (
+  IN  CONST CHAR8  *Name,
+  IN  CONST UINT8  *Drop,
+  OUT UINT32       *SackTicks,
+  OUT UINT32       *RenoTicks
+  )
+{
+  UINT32  Index;
+  UINTN   UseSack;
+  UINT32  Ticks[2];
+
+  for (UseSack = 0; UseSack < 2; UseSack++) {
+    ZeroMem (&mTransfer, sizeof (mTransfer));
+    mTransfer.UseSack = (BOOLEAN)(UseSack != 0);
+    CopyMem (mTransfer.Drop, Drop, sizeof (mTransfer.Drop));
+
+    Ticks[UseSack] = TestRunTransfer (&mTransfer);
+    UT_ASSERT_TRUE (Ticks[UseSack] < TEST_MAX_TICKS);
+    for (Index = 0; Index < TEST_SEGMENTS; Index++) {
+      UT_ASSERT_TRUE (mTransfer.Received[Index]);
+    }
+
+    DEBUG ((
+      DEBUG_VERBOSE,
+      "%a %-7a: %6d ticks, %4d retransmits, %2d recoveries, %2d timeouts\n",
+      Name,
+      mTransfer.UseSack ? "SACK" : "NewReno",
+      Ticks[UseSack],
+      mTransfer.Retransmits,
+      mTransfer.Recoveries,
+      mTransfer.Timeouts
+      ));
+  }
+
+  *SackTicks = Ticks[1];
+  *RenoTicks = Ticks[0];
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check the scoreboard: merge, trim, loss detection, next segment and pipe.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The scoreboard follows RFC6675.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  A check failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TestScoreboard (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TCP_SACK_SCOREBOARD  Sack;
+  TCP_SACK_BLOCK       Block[3];
+  TCP_SEQNO            Seq;
+  UINT32               Len;
+  UINT32               Delivered;
+
+  //
+  // Segments 0 .. 9 are sent, 1, 3 and 4 are SACKed.
+  //
+  TcpSackReset (&Sack, TEST_SEQ (0));
+  Block[0].Left  = TEST_SEQ (3);
+  Block[0].Right = TEST_SEQ (5);
+  Block[1].Left  = TEST_SEQ (1);
+  Block[1].Right = TEST_SEQ (2);
+  Delivered      = TcpSackUpdate (&Sack, TEST_SEQ (0), TEST_SEQ (0), TEST_SEQ (10), Block, 2);
+  UT_ASSERT_EQUAL (Delivered, 3 * TEST_MSS);
+  UT_ASSERT_EQUAL (Sack.Count, 2);
+  UT_ASSERT_EQUAL (Sack.SackedBytes, 3 * TEST_MSS);
+  UT_ASSERT_EQUAL (Sack.Block[0].Left, TEST_SEQ (1));
+
+  //
+  // Three segments above segment 0 are SACKed: it is lost. Segment 2 has
+  // only two segments above it, in one range.
+  //
+  UT_ASSERT_TRUE (TcpSackIsLost (&Sack, TEST_SEQ (0), TEST_MSS));
+  UT_ASSERT_FALSE (TcpSackIsLost (&Sack, TEST_SEQ (2), TEST_MSS));
+  UT_ASSERT_TRUE (TcpSackNextSeg (&Sack, TEST_SEQ (0), TEST_MSS, &Seq, &Len));
+  UT_ASSERT_EQUAL (Seq, TEST_SEQ (0));
+  UT_ASSERT_EQUAL (Len, TEST_MSS);
+
+  //
+  // The hole at 0 is lost, not retransmitted and out of the pipe, 2 and
+  // 5 .. 9 are in the pipe.
+  //
+  UT_ASSERT_EQUAL (TcpSackPipe (&Sack, TEST_SEQ (0), TEST_SEQ (10), TEST_MSS), 6 * TEST_MSS);
+  Sack.HighRxt = TEST_SEQ (1);
+  UT_ASSERT_EQUAL (TcpSackPipe (&Sack, TEST_SEQ (0), TEST_SEQ (10), TEST_MSS), 7 * TEST_MSS);
+  UT_ASSERT_FALSE (TcpSackNextSeg (&Sack, TEST_SEQ (0), TEST_MSS, &Seq, &Len));
+
+  //
+  // Segment 2 is SACKed and merges the ranges, then a cumulative ACK of
+  // segments 0 .. 2 trims them. A duplicate block delivers nothing.
+  //
+  Block[0].Left  = TEST_SEQ (2);
+  Block[0].Right = TEST_SEQ (3);
+  Delivered      = TcpSackUpdate (&Sack, TEST_SEQ (0), TEST_SEQ (0), TEST_SEQ (10), Block, 1);
+  UT_ASSERT_EQUAL (Delivered, TEST_MSS);
+  UT_ASSERT_EQUAL (Sack.Count, 1);
+  Delivered = TcpSackUpdate (&Sack, TEST_SEQ (0), TEST_SEQ (3), TEST_SEQ (10), Block, 1);
+  UT_ASSERT_EQUAL (Delivered, TEST_MSS);
+  UT_ASSERT_EQUAL (Sack.Count, 1);
+  UT_ASSERT_EQUAL (Sack.Block[0].Left, TEST_SEQ (3));
+  UT_ASSERT_EQUAL (Sack.SackedBytes, 2 * TEST_MSS);
+  UT_ASSERT_EQUAL (Sack.HighRxt, TEST_SEQ (3));
+
+  //
+  // Blocks outside [SND.UNA, SND.NXT) are ignored.
+  //
+  Block[0].Left  = TEST_SEQ (11);
+  Block[0].Right = TEST_SEQ (12);
+  Delivered      = TcpSackUpdate (&Sack, TEST_SEQ (3), TEST_SEQ (3), TEST_SEQ (10), Block, 1);
+  UT_ASSERT_EQUAL (Delivered, 0);
+  UT_ASSERT_EQUAL (Sack.Count, 1);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check that a full scoreboard drops its highest range without reporting
+  a wrapped delivery.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The dropped range delivers nothing.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  A check failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TestScoreboardFull (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TCP_SACK_SCOREBOARD  Sack;
+  TCP_SACK_BLOCK       Block[1];
+  UINT32               Index;
+  UINT32               Delivered;
+
+  //
+  // Every odd segment of 0 .. 2 * TCP_SACK_SCOREBOARD_SIZE is SACKed and
+  // fills the scoreboard.
+  //
+  TcpSackReset (&Sack, TEST_SEQ (0));
+  for (Index = 0; Index < TCP_SACK_SCOREBOARD_SIZE; Index++) {
+    Block[0].Left  = TEST_SEQ (2 * Index + 1);
+    Block[0].Right = TEST_SEQ (2 * Index + 2);
+    Delivered      = TcpSackUpdate (&Sack, TEST_SEQ (0), TEST_SEQ (0), TEST_SEQ (2 * TCP_SACK_SCOREBOARD_SIZE + 1), Block, 1);
+    UT_ASSERT_EQUAL (Delivered, TEST_MSS);
+  }
+
+  UT_ASSERT_EQUAL (Sack.Count, TCP_SACK_SCOREBOARD_SIZE);
+  UT_ASSERT_EQUAL (Sack.SackedBytes, TCP_SACK_SCOREBOARD_SIZE * TEST_MSS);
+
+  //
+  // One byte of segment 0 is SACKed: the highest range is dropped and the
+  // SACKed bytes shrink by a segment less a byte.
+  //
+  Block[0].Left  = TEST_SEQ (0) + 1;
+  Block[0].Right = TEST_SEQ (0) + 2;
+  Delivered      = TcpSackUpdate (&Sack, TEST_SEQ (0), TEST_SEQ (0), TEST_SEQ (2 * TCP_SACK_SCOREBOARD_SIZE + 1), Block, 1);
+  UT_ASSERT_EQUAL (Delivered, 0);
+  UT_ASSERT_EQUAL (Sack.Count, TCP_SACK_SCOREBOARD_SIZE);
+  UT_ASSERT_EQUAL (Sack.SackedBytes, (TCP_SACK_SCOREBOARD_SIZE - 1) * TEST_MSS + 1);
+  UT_ASSERT_EQUAL (Sack.Block[TCP_SACK_SCOREBOARD_SIZE - 1].Right, TEST_SEQ (2 * TCP_SACK_SCOREBOARD_SIZE - 2));
+
+  //
+  // A cumulative ACK of segment 0 still delivers the bytes it acknowledges.
+  //
+  Delivered = TcpSackUpdate (&Sack, TEST_SEQ (0), TEST_SEQ (1), TEST_SEQ (2 * TCP_SACK_SCOREBOARD_SIZE + 1), Block, 0);
+  UT_ASSERT_EQUAL (Delivered, TEST_MSS - 1);
+  UT_ASSERT_EQUAL (Sack.Count, TCP_SACK_SCOREBOARD_SIZE - 1);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check that PRR reduces the window to Ssthresh in a recovery.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             PRR follows RFC6937.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  A check failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TestPrr (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TCP_PRR  Prr;
+  UINT32   Pipe;
+  UINT32   SndCnt;
+  UINT32   Sent;
+  UINT32   Round;
+
+  //
+  // 20 segments in flight, one lost: for every two segments delivered, one
+  // is sent, so the window ends at Ssthresh.
+  //
+  TcpPrrStart (&Prr, 20 * TEST_MSS);
+  Pipe = 19 * TEST_MSS;
+  Sent = 0;
+  for (Round = 0; Round < 19; Round++) {
+    Pipe  -= TEST_MSS;
+    SndCnt = TcpPrrSndCnt (&Prr, TEST_MSS, Pipe, 10 * TEST_MSS, TEST_MSS);
+    UT_ASSERT_TRUE (SndCnt <= 2 * TEST_MSS);
+    Prr.Out += SndCnt;
+    Pipe    += SndCnt;
+    Sent    += SndCnt;
+  }
+
+  UT_ASSERT_TRUE (Sent >= 9 * TEST_MSS);
+  UT_ASSERT_TRUE (Sent <= 11 * TEST_MSS);
+
+  //
+  // With the pipe below Ssthresh, slow start catches up, but no faster than
+  // one segment more than delivered.
+  //
+  TcpPrrStart (&Prr, 20 * TEST_MSS);
+  SndCnt = TcpPrrSndCnt (&Prr, TEST_MSS, 2 * TEST_MSS, 10 * TEST_MSS, TEST_MSS);
+  UT_ASSERT_EQUAL (SndCnt, 2 * TEST_MSS);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Compare the recovery of a burst of losses in one window with SACK and with
+  NewReno.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             SACK recovers faster than NewReno.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  A check failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TestBurstLoss (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8             Drop[TEST_SEGMENTS];
+  UINT32            SackTicks;
+  UINT32            RenoTicks;
+  UINT32            NoLossTicks;
+  UINT32            Index;
+  UNIT_TEST_STATUS  Status;
+
+  ZeroMem (Drop, sizeof (Drop));
+  Status = TestCompare ("No loss   ", Drop, &NoLossTicks, &RenoTicks);
+  UT_ASSERT_EQUAL (Status, UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (NoLossTicks, RenoTicks);
+
+  for (Index = 100; Index < 120; Index += 3) {
+    Drop[Index] = 1;
+  }
+
+  Status = TestCompare ("Burst loss", Drop, &SackTicks, &RenoTicks);
+  UT_ASSERT_EQUAL (Status, UNIT_TEST_PASSED);
+  UT_ASSERT_TRUE (SackTicks < RenoTicks);
+
+  UT_LOG_INFO (
+    "Burst of 7 losses: SACK %d ticks, NewReno %d ticks, no loss %d ticks\n",
+    SackTicks,
+    RenoTicks,
+    NoLossTicks
+    );
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Run transfers with random losses, including lost retransmissions, and
+  check that both recoveries deliver all the data.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             All the transfers complete.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  A check failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TestRandomLoss (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8             Drop[TEST_SEGMENTS];
+  UINT32            Seed;
+  UINT32            Round;
+  UINT32            Index;
+  UINT32            SackTicks;
+  UINT32            RenoTicks;
+  UINT64            SackTotal;
+  UINT64            RenoTotal;
+  UNIT_TEST_STATUS  Status;
+
+  Seed      = 0x5AC4;
+  SackTotal = 0;
+  RenoTotal = 0;
+  for (Round = 0; Round < TEST_RANDOM_ROUNDS; Round++) {
+    for (Index = 0; Index < TEST_SEGMENTS; Index++) {
+      Drop[Index] = (UnitTestRandom (&Seed) % 100 < 3) ? (UINT8)(1 + (UnitTestRandom (&Seed) % 10 == 0)) : 0;
+    }
+
+    Status = TestCompare ("Random    ", Drop, &SackTicks, &RenoTicks);
+    UT_ASSERT_EQUAL (Status, UNIT_TEST_PASSED);
+    SackTotal += SackTicks;
+    RenoTotal += RenoTicks;
+  }
+
+  UT_ASSERT_TRUE (SackTotal < RenoTotal);
+  UT_LOG_INFO ("3%% random loss: SACK %ld ticks, NewReno %ld ticks\n", SackTotal, RenoTotal);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the TCP SACK
+  scoreboard and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      SackTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&SackTests, Framework, "TCP SACK Tests", "TcpDxe.Sack", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for TCP SACK Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (SackTests, "Scoreboard follows RFC6675", "Scoreboard", TestScoreboard, NULL, NULL, NULL);
+  AddTestCase (SackTests, "Full scoreboard drops the highest range", "ScoreboardFull", TestScoreboardFull, NULL, NULL, NULL);
+  AddTestCase (SackTests, "PRR reduces the window to ssthresh", "Prr", TestPrr, NULL, NULL, NULL);
+  AddTestCase (SackTests, "Burst loss recovers faster with SACK", "BurstLoss", TestBurstLoss, NULL, NULL, NULL);
+  AddTestCase (SackTests, "Random loss delivers all the data", "RandomLoss", TestRandomLoss, NULL, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+#define TcpSackUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in]  Argc  Number of arguments.
+  @param[in]  Argv  Array of arguments.
+
+  @return Test application exit code.
+**/
+INT32
+TcpSackUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -1,7 +1,7 @@
 /** @file
   The implementation of the Udp4 protocol.
 
-Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -306,6 +306,23 @@ Udp4CreateService (
     goto ON_ERROR;
   }
 
+  //
+  // The NIC may validate the checksum of the received datagrams.
+  //
+  Status = gBS->OpenProtocol (
+                  ControllerHandle,
+                  &gEdkiiNetworkOffloadProtocolGuid,
+                  (VOID **)&Udp4Service->Offload,
+                  ImageHandle,
+                  ControllerHandle,
+                  EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                  );
+  if (EFI_ERROR (Status) ||
+      ((Udp4Service->Offload->RxChecksum & EDKII_NETWORK_OFFLOAD_UDP4) == 0))
+  {
+    Udp4Service->Offload = NULL;
+  }
+
   //
   // Create the event for Udp timeout checking.
   //
@@ -1601,9 +1618,12 @@ Udp4Demultiplex (
   Udp4Header = (EFI_UDP_HEADER *)NetbufGetByte (Packet, 0, NULL);
   ASSERT (Udp4Header != NULL);
 
-  if (Udp4Header->Checksum != 0) {
+  if ((Udp4Header->Checksum != 0) &&
+      ((Udp4Service->Offload == NULL) || (Packet->BlockOpNum != 1) ||
+       !Udp4Service->Offload->RxChecksumValid (Udp4Service->Offload, Udp4Header, Packet->TotalSize)))
+  {
     //
-    // check the checksum.
+    // check the checksum, unless the NIC has validated it.
     //
     HeadSum = NetPseudoHeadChecksum (
                 NetSession->Source.Addr[0],
@@ -1,7 +1,7 @@
 /** @file
   EFI UDPv4 protocol implementation.
 
-Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -12,6 +12,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Uefi.h>
 
 #include <Protocol/Ip4.h>
+#include <Protocol/NetworkOffload.h>
 #include <Protocol/Udp4.h>
 
 #include <Library/IpIoLib.h>
@@ -56,15 +57,16 @@ extern UINT16                        mUdp4RandomPort;
   )
 
 typedef struct _UDP4_SERVICE_DATA_ {
-  UINT32                          Signature;
-  EFI_SERVICE_BINDING_PROTOCOL    ServiceBinding;
-  EFI_HANDLE                      ImageHandle;
-  EFI_HANDLE                      ControllerHandle;
-  LIST_ENTRY                      ChildrenList;
-  UINTN                           ChildrenNumber;
-  IP_IO                           *IpIo;
-
-  EFI_EVENT                       TimeoutEvent;
+  UINT32                            Signature;
+  EFI_SERVICE_BINDING_PROTOCOL      ServiceBinding;
+  EFI_HANDLE                        ImageHandle;
+  EFI_HANDLE                        ControllerHandle;
+  LIST_ENTRY                        ChildrenList;
+  UINTN                             ChildrenNumber;
+  IP_IO                             *IpIo;
+  EDKII_NETWORK_OFFLOAD_PROTOCOL    *Offload; ///< Checksum offload of the NIC, NULL if none.
+
+  EFI_EVENT                         TimeoutEvent;
 } UDP4_SERVICE_DATA;
 
 #define UDP4_INSTANCE_DATA_SIGNATURE  SIGNATURE_32('U', 'd', 'p', 'I')
@@ -6,9 +6,11 @@
 
   - No attach/detach (ie. removable media).
 
-  - Although the non-blocking interfaces of EFI_BLOCK_IO2_PROTOCOL could be a
-    good match for multiple in-flight virtio-blk requests, we stick to
-    synchronous requests and EFI_BLOCK_IO_PROTOCOL for now.
+  - EFI_BLOCK_IO_PROTOCOL requests are synchronous. EFI_BLOCK_IO2_PROTOCOL
+    requests with a token are submitted to the device without waiting, up to
+    VBLK_MAX_PENDING in flight, and completed by a periodic timer.
+
+  - Only the first virtqueue is used, even if the device supports more.
 
   Copyright (C) 2012, Red Hat, Inc.
   Copyright (c) 2012 - 2018, Intel Corporation. All rights reserved.<BR>
@@ -176,91 +178,245 @@ VerifyReadWriteRequest (
 
 /**
 
-  Format a read / write / flush request as three consecutive virtio
-  descriptors, push them to the host, and poll for the response.
+  Complete the requests that the device has returned in the used ring.
 
-  This is the main workhorse function. Two use cases are supported, read/write
-  and flush. The function may only be called after the request parameters have
-  been verified by
-  - specific checks in ReadBlocks() / WriteBlocks() / FlushBlocks(), and
-  - VerifyReadWriteRequest() (for read/write only).
+  For each completed request the data buffer is unmapped, and the outcome is
+  reported through the EFI_BLOCK_IO2_TOKEN or the VBLK_WAITER of the request.
+  The request slot is returned to the free stack.
 
-  Parameters handled commonly:
+  The caller is responsible for running at TPL_CALLBACK.
 
-    @param[in] Dev             The virtio-blk device the request is targeted
-                               at.
+  @param[in out] Dev  The virtio-blk device whose requests to complete.
 
-  Flush request:
+**/
+STATIC
+VOID
+VirtioBlkCompleteRequests (
+  IN OUT VBLK_DEV  *Dev
+  )
+{
+  UINT16      CurUsed;
+  UINT32      DescIdx;
+  UINT16      ReqIdx;
+  VBLK_REQ    *Req;
+  EFI_STATUS  Status;
+  EFI_STATUS  UnmapStatus;
 
-    @param[in] Lba             Must be zero.
+  MemoryFence ();
+  CurUsed = *Dev->Ring.Used.Idx;
+  MemoryFence ();
 
-    @param[in] BufferSize      Must be zero.
+  while (Dev->LastUsed != CurUsed) {
+    DescIdx = Dev->Ring.Used.UsedElem[Dev->LastUsed % Dev->Ring.QueueSize].Id;
+    Dev->LastUsed++;
 
-    @param[in out] Buffer      Ignored by the function.
+    //
+    // The head descriptor identifies the request slot; see
+    // VirtioBlkSubmitRequest().
+    //
+    ReqIdx = (UINT16)(Dev->Indirect ? DescIdx : DescIdx / 3);
+    ASSERT (ReqIdx < Dev->MaxPending);
+    Req = &Dev->Reqs[ReqIdx];
+
+    Status = (Dev->SharedReqs[ReqIdx].HostStatus == VIRTIO_BLK_S_OK) ?
+             EFI_SUCCESS :
+             EFI_DEVICE_ERROR;
+
+    if (Req->BufferMapping != NULL) {
+      UnmapStatus = Dev->VirtIo->UnmapSharedBuffer (
+                                   Dev->VirtIo,
+                                   Req->BufferMapping
+                                   );
+      if (EFI_ERROR (UnmapStatus) && !Req->RequestIsWrite) {
+        //
+        // Data from the bus master may not reach the caller; fail the request.
+        //
+        Status = EFI_DEVICE_ERROR;
+      }
+    }
 
-    @param[in] RequestIsWrite  Must be TRUE.
+    if (Req->Token != NULL) {
+      Req->Token->TransactionStatus = Status;
+      gBS->SignalEvent (Req->Token->Event);
+      Dev->AsyncPending--;
+    } else if (Req->Waiter != NULL) {
+      Req->Waiter->Status = Status;
+      Req->Waiter->Done   = TRUE;
+    } else {
+      //
+      // The submission of the request failed; see VirtioBlkSubmitRequest().
+      //
+      Dev->AsyncPending--;
+    }
 
-  Read/Write request:
+    ZeroMem (Req, sizeof *Req);
+    Dev->FreeStack[--Dev->CurPending] = ReqIdx;
+  }
 
-    @param[in] Lba             Logical Block Address: number of logical blocks
-                               to skip from the beginning of the device.
+  if (Dev->AsyncPending == 0) {
+    gBS->SetTimer (Dev->PollTimer, TimerCancel, 0);
+  }
+}
 
-    @param[in] BufferSize      Size of buffer to transfer, in bytes. The caller
-                               is responsible to ensure this parameter is
-                               positive.
+/**
 
-    @param[in out] Buffer      The guest side area to read data from the device
-                               into, or write data to the device from.
+  Complete the requests that the device has returned, raising the TPL as
+  necessary.
 
-    @param[in] RequestIsWrite  TRUE iff data transfer goes from guest to
-                               device.
+  @param[in out] Dev  The virtio-blk device whose requests to complete.
 
-  Return values are common to both use cases, and are appropriate to be
-  forwarded by the EFI_BLOCK_IO_PROTOCOL functions (ReadBlocks(),
-  WriteBlocks(), FlushBlocks()).
+**/
+STATIC
+VOID
+VirtioBlkPoll (
+  IN OUT VBLK_DEV  *Dev
+  )
+{
+  EFI_TPL  OldTpl;
 
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  VirtioBlkCompleteRequests (Dev);
+  gBS->RestoreTPL (OldTpl);
+}
 
-  @retval EFI_SUCCESS          Transfer complete.
+/**
 
-  @retval EFI_DEVICE_ERROR     Failed to notify host side via VirtIo write, or
-                               unable to parse host response, or host response
-                               is not VIRTIO_BLK_S_OK or failed to map Buffer
-                               for a bus master operation.
+  Notification function of the timer that completes asynchronous requests.
+
+  @param[in] Event    Event whose notification function is being invoked.
+
+  @param[in] Context  Pointer to the VBLK_DEV structure.
 
 **/
 STATIC
-EFI_STATUS
+VOID
 EFIAPI
-SynchronousRequest (
-  IN              VBLK_DEV  *Dev,
-  IN              EFI_LBA   Lba,
-  IN              UINTN     BufferSize,
-  IN OUT volatile VOID      *Buffer,
-  IN              BOOLEAN   RequestIsWrite
+VirtioBlkPollTimer (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
   )
 {
-  UINT32                   BlockSize;
-  volatile VIRTIO_BLK_REQ  Request;
-  volatile UINT8           *HostStatus;
-  VOID                     *HostStatusBuffer;
-  DESC_INDICES             Indices;
-  VOID                     *RequestMapping;
-  VOID                     *StatusMapping;
-  VOID                     *BufferMapping;
-  EFI_PHYSICAL_ADDRESS     BufferDeviceAddress;
-  EFI_PHYSICAL_ADDRESS     HostStatusDeviceAddress;
-  EFI_PHYSICAL_ADDRESS     RequestDeviceAddress;
-  EFI_STATUS               Status;
-  EFI_STATUS               UnmapStatus;
+  VirtioBlkCompleteRequests (Context);
+}
 
-  BlockSize = Dev->BlockIoMedia.BlockSize;
+/**
 
-  //
-  // Set BufferMapping and BufferDeviceAddress to suppress incorrect
-  // compiler/analyzer warnings.
-  //
-  BufferMapping       = NULL;
-  BufferDeviceAddress = 0;
+  Wait until all requests in flight have completed, unless the device cannot
+  be notified of them.
+
+  @param[in out] Dev  The virtio-blk device whose requests to wait for.
+
+**/
+STATIC
+VOID
+VirtioBlkDrain (
+  IN OUT VBLK_DEV  *Dev
+  )
+{
+  UINTN       PollPeriodUsecs;
+  EFI_STATUS  Status;
+
+  PollPeriodUsecs = 1;
+  VirtioBlkPoll (Dev);
+  if (Dev->CurPending > 0) {
+    //
+    // Notify the device again, in case the notification of a request has
+    // failed. If the device cannot be notified, the requests may never
+    // complete; VirtioBlkUninitReqs() releases them after the reset.
+    //
+    MemoryFence ();
+    Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, 0);
+    if (EFI_ERROR (Status)) {
+      return;
+    }
+  }
+
+  while (Dev->CurPending > 0) {
+    gBS->Stall (PollPeriodUsecs);
+    if (PollPeriodUsecs < 1024) {
+      PollPeriodUsecs *= 2;
+    }
+
+    VirtioBlkPoll (Dev);
+  }
+}
+
+/**
+
+  Format a read / write / flush request in a free request slot, and push it to
+  the host. The function does not wait for the request to complete.
+
+  With indirect descriptors, the request takes a single descriptor in the ring,
+  pointing to the descriptor table of the request slot. Otherwise the request
+  takes the three consecutive descriptors that belong to the request slot. In
+  both cases, the head descriptor index identifies the request slot when the
+  device returns the request in the used ring.
+
+  If all request slots are taken, the function completes requests until a slot
+  is freed.
+
+  The function may only be called after the request parameters have been
+  verified by
+  - specific checks in ReadBlocks() / WriteBlocks() / FlushBlocks() and their
+    Ex counterparts, and
+  - VerifyReadWriteRequest() (for read/write only).
+
+  @param[in] Dev             The virtio-blk device the request is targeted at.
+
+  @param[in] Lba             Logical Block Address, or zero for flush.
+
+  @param[in] BufferSize      Size of buffer to transfer, in bytes, or zero for
+                             flush.
+
+  @param[in out] Buffer      The guest side area to read data from the device
+                             into, or write data to the device from. Ignored
+                             for flush.
+
+  @param[in] RequestIsWrite  TRUE iff data transfer goes from guest to device;
+                             must be TRUE for flush.
+
+  @param[in] Token           The token to report completion through, for a
+                             non-blocking request. NULL otherwise.
+
+  @param[in] Waiter          The structure to report completion through, for a
+                             blocking request. NULL otherwise.
+
+
+  @retval EFI_SUCCESS        The request has been submitted.
+
+  @retval EFI_DEVICE_ERROR   Failed to map Buffer for a bus master operation,
+                             or failed to notify host side via VirtIo write.
+
+**/
+STATIC
+EFI_STATUS
+VirtioBlkSubmitRequest (
+  IN              VBLK_DEV             *Dev,
+  IN              EFI_LBA              Lba,
+  IN              UINTN                BufferSize,
+  IN OUT volatile VOID                 *Buffer,
+  IN              BOOLEAN              RequestIsWrite,
+  IN              EFI_BLOCK_IO2_TOKEN  *Token   OPTIONAL,
+  IN              VBLK_WAITER          *Waiter  OPTIONAL
+  )
+{
+  UINT32                BlockSize;
+  VOID                  *BufferMapping;
+  EFI_PHYSICAL_ADDRESS  BufferDeviceAddress;
+  EFI_PHYSICAL_ADDRESS  SharedDeviceAddress;
+  EFI_TPL               OldTpl;
+  UINTN                 PollPeriodUsecs;
+  UINT16                ReqIdx;
+  VBLK_REQ              *Req;
+  VBLK_SHARED_REQ       *Shared;
+  volatile VRING_DESC   *Desc;
+  UINT16                FirstDesc;
+  UINT16                NumDesc;
+  UINT16                HeadDesc;
+  UINT16                AvailIdx;
+  EFI_STATUS            Status;
+
+  BlockSize = Dev->BlockIoMedia.BlockSize;
 
   //
   // ensured by VirtioBlkInit()
@@ -274,51 +430,20 @@ SynchronousRequest (
   ASSERT (BufferSize % BlockSize == 0);
 
   //
-  // Prepare virtio-blk request header, setting zero size for flush.
-  // IO Priority is homogeneously 0.
-  //
-  Request.Type = RequestIsWrite ?
-                 (BufferSize == 0 ? VIRTIO_BLK_T_FLUSH : VIRTIO_BLK_T_OUT) :
-                 VIRTIO_BLK_T_IN;
-  Request.IoPrio = 0;
-  Request.Sector = MultU64x32 (Lba, BlockSize / 512);
-
-  //
-  // Host status is bi-directional (we preset with a value and expect the
-  // device to update it). Allocate a host status buffer which can be mapped
-  // to access equally by both processor and the device.
-  //
-  Status = Dev->VirtIo->AllocateSharedPages (
-                          Dev->VirtIo,
-                          EFI_SIZE_TO_PAGES (sizeof *HostStatus),
-                          &HostStatusBuffer
-                          );
-  if (EFI_ERROR (Status)) {
-    return EFI_DEVICE_ERROR;
-  }
-
-  HostStatus = HostStatusBuffer;
-
+  // From virtio-0.9.5, 2.3.2 Descriptor Table:
+  // "no descriptor chain may be more than 2^32 bytes long in total".
   //
-  // Map virtio-blk request header (must be done after request header is
-  // populated)
+  // The predicate is ensured by the call contract above (for flush), or
+  // VerifyReadWriteRequest() (for read/write). It also implies that
+  // converting BufferSize to UINT32 will not truncate it.
   //
-  Status = VirtioMapAllBytesInSharedBuffer (
-             Dev->VirtIo,
-             VirtioOperationBusMasterRead,
-             (VOID *)&Request,
-             sizeof Request,
-             &RequestDeviceAddress,
-             &RequestMapping
-             );
-  if (EFI_ERROR (Status)) {
-    Status = EFI_DEVICE_ERROR;
-    goto FreeHostStatusBuffer;
-  }
+  ASSERT (BufferSize <= SIZE_1GB);
 
   //
-  // Map data buffer
+  // Map the data buffer before taking a request slot.
   //
+  BufferMapping       = NULL;
+  BufferDeviceAddress = 0;
   if (BufferSize > 0) {
     Status = VirtioMapAllBytesInSharedBuffer (
                Dev->VirtIo,
@@ -331,130 +456,265 @@ SynchronousRequest (
                &BufferMapping
                );
     if (EFI_ERROR (Status)) {
-      Status = EFI_DEVICE_ERROR;
-      goto UnmapRequestBuffer;
+      return EFI_DEVICE_ERROR;
     }
   }
 
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
   //
-  // preset a host status for ourselves that we do not accept as success
+  // Take a request slot, completing requests until one is free.
   //
-  *HostStatus = VIRTIO_BLK_S_IOERR;
+  PollPeriodUsecs = 1;
+  VirtioBlkCompleteRequests (Dev);
+  while (Dev->CurPending == Dev->MaxPending) {
+    gBS->RestoreTPL (OldTpl);
+    gBS->Stall (PollPeriodUsecs);
+    if (PollPeriodUsecs < 1024) {
+      PollPeriodUsecs *= 2;
+    }
+
+    OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+    VirtioBlkCompleteRequests (Dev);
+  }
+
+  ReqIdx              = Dev->FreeStack[Dev->CurPending++];
+  Req                 = &Dev->Reqs[ReqIdx];
+  Shared              = &Dev->SharedReqs[ReqIdx];
+  SharedDeviceAddress = Dev->SharedReqsDevAddr + ReqIdx * sizeof *Shared;
+
+  Req->Token          = Token;
+  Req->Waiter         = Waiter;
+  Req->BufferMapping  = BufferMapping;
+  Req->RequestIsWrite = RequestIsWrite;
 
   //
-  // Map the Status Buffer with VirtioOperationBusMasterCommonBuffer so that
-  // both processor and device can access it.
+  // Prepare virtio-blk request header, setting zero size for flush.
+  // IO Priority is homogeneously 0.
   //
-  Status = VirtioMapAllBytesInSharedBuffer (
-             Dev->VirtIo,
-             VirtioOperationBusMasterCommonBuffer,
-             HostStatusBuffer,
-             sizeof *HostStatus,
-             &HostStatusDeviceAddress,
-             &StatusMapping
-             );
-  if (EFI_ERROR (Status)) {
-    Status = EFI_DEVICE_ERROR;
-    goto UnmapDataBuffer;
-  }
+  Shared->Request.Type = RequestIsWrite ?
+                         (BufferSize == 0 ? VIRTIO_BLK_T_FLUSH : VIRTIO_BLK_T_OUT) :
+                         VIRTIO_BLK_T_IN;
+  Shared->Request.IoPrio = 0;
+  Shared->Request.Sector = MultU64x32 (Lba, BlockSize / 512);
 
-  VirtioPrepare (&Dev->Ring, &Indices);
+  //
+  // preset a host status for ourselves that we do not accept as success
+  //
+  Shared->HostStatus = VIRTIO_BLK_S_IOERR;
 
   //
-  // ensured by VirtioBlkInit() -- this predicate, in combination with the
-  // lock-step progress, ensures we don't have to track free descriptors.
+  // Descriptor indices in the "Next" fields are relative to the start of the
+  // descriptor table that the chain lives in.
   //
-  ASSERT (Dev->Ring.QueueSize >= 3);
+  if (Dev->Indirect) {
+    Desc      = Shared->Indirect;
+    FirstDesc = 0;
+  } else {
+    FirstDesc = (UINT16)(ReqIdx * 3);
+    Desc      = &Dev->Ring.Desc[FirstDesc];
+  }
 
   //
   // virtio-blk header in first desc
   //
-  VirtioAppendDesc (
-    &Dev->Ring,
-    RequestDeviceAddress,
-    sizeof Request,
-    VRING_DESC_F_NEXT,
-    &Indices
-    );
+  NumDesc       = 0;
+  Desc[0].Addr  = SharedDeviceAddress + OFFSET_OF (VBLK_SHARED_REQ, Request);
+  Desc[0].Len   = sizeof Shared->Request;
+  Desc[0].Flags = VRING_DESC_F_NEXT;
+  Desc[0].Next  = (UINT16)(FirstDesc + 1);
+  NumDesc++;
 
   //
-  // data buffer for read/write in second desc
+  // data buffer for read/write in second desc; VRING_DESC_F_WRITE is
+  // interpreted from the host's point of view.
   //
   if (BufferSize > 0) {
-    //
-    // From virtio-0.9.5, 2.3.2 Descriptor Table:
-    // "no descriptor chain may be more than 2^32 bytes long in total".
-    //
-    // The predicate is ensured by the call contract above (for flush), or
-    // VerifyReadWriteRequest() (for read/write). It also implies that
-    // converting BufferSize to UINT32 will not truncate it.
-    //
-    ASSERT (BufferSize <= SIZE_1GB);
-
-    //
-    // VRING_DESC_F_WRITE is interpreted from the host's point of view.
-    //
-    VirtioAppendDesc (
-      &Dev->Ring,
-      BufferDeviceAddress,
-      (UINT32)BufferSize,
-      VRING_DESC_F_NEXT | (RequestIsWrite ? 0 : VRING_DESC_F_WRITE),
-      &Indices
-      );
+    Desc[1].Addr  = BufferDeviceAddress;
+    Desc[1].Len   = (UINT32)BufferSize;
+    Desc[1].Flags = VRING_DESC_F_NEXT |
+                    (RequestIsWrite ? 0 : VRING_DESC_F_WRITE);
+    Desc[1].Next = (UINT16)(FirstDesc + 2);
+    NumDesc++;
   }
 
   //
   // host status in last (second or third) desc
   //
-  VirtioAppendDesc (
-    &Dev->Ring,
-    HostStatusDeviceAddress,
-    sizeof *HostStatus,
-    VRING_DESC_F_WRITE,
-    &Indices
-    );
+  Desc[NumDesc].Addr  = SharedDeviceAddress + OFFSET_OF (VBLK_SHARED_REQ, HostStatus);
+  Desc[NumDesc].Len   = sizeof Shared->HostStatus;
+  Desc[NumDesc].Flags = VRING_DESC_F_WRITE;
+  Desc[NumDesc].Next  = 0;
+  NumDesc++;
+
+  if (Dev->Indirect) {
+    HeadDesc                       = ReqIdx;
+    Dev->Ring.Desc[HeadDesc].Addr  = SharedDeviceAddress + OFFSET_OF (VBLK_SHARED_REQ, Indirect);
+    Dev->Ring.Desc[HeadDesc].Len   = (UINT32)(NumDesc * sizeof (VRING_DESC));
+    Dev->Ring.Desc[HeadDesc].Flags = VRING_DESC_F_INDIRECT;
+    Dev->Ring.Desc[HeadDesc].Next  = 0;
+  } else {
+    HeadDesc = FirstDesc;
+  }
+
+  if ((Token != NULL) && (Dev->AsyncPending++ == 0)) {
+    gBS->SetTimer (Dev->PollTimer, TimerPeriodic, VBLK_POLL_PERIOD);
+  }
 
   //
+  // Publish the request in the available ring, and kick the device.
   // virtio-blk's only virtqueue is #0, called "requestq" (see Appendix D).
   //
-  if ((VirtioFlush (
-         Dev->VirtIo,
-         0,
-         &Dev->Ring,
-         &Indices,
-         NULL
-         ) == EFI_SUCCESS) &&
-      (*HostStatus == VIRTIO_BLK_S_OK))
-  {
-    Status = EFI_SUCCESS;
-  } else {
-    Status = EFI_DEVICE_ERROR;
+  AvailIdx                                              = *Dev->Ring.Avail.Idx;
+  Dev->Ring.Avail.Ring[AvailIdx % Dev->Ring.QueueSize] = HeadDesc;
+  AvailIdx++;
+
+  MemoryFence ();
+  *Dev->Ring.Avail.Idx = AvailIdx;
+
+  MemoryFence ();
+  Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, 0);
+  if (EFI_ERROR (Status)) {
+    //
+    // The device may have seen the request already, so it stays in the
+    // available ring, with its slot and buffer mapping, until the device
+    // returns it. Detach it from the caller, who gets the error instead of
+    // the outcome, and let the poll timer reclaim it.
+    //
+    if ((Token == NULL) && (Dev->AsyncPending++ == 0)) {
+      gBS->SetTimer (Dev->PollTimer, TimerPeriodic, VBLK_POLL_PERIOD);
+    }
+
+    Req->Token  = NULL;
+    Req->Waiter = NULL;
+    Status      = EFI_DEVICE_ERROR;
   }
 
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, StatusMapping);
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
 
-UnmapDataBuffer:
-  if (BufferSize > 0) {
-    UnmapStatus = Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, BufferMapping);
-    if (EFI_ERROR (UnmapStatus) && !RequestIsWrite && !EFI_ERROR (Status)) {
-      //
-      // Data from the bus master may not reach the caller; fail the request.
-      //
-      Status = EFI_DEVICE_ERROR;
+/**
+
+  Submit a read / write / flush request, and poll for the response.
+
+  Parameters and return values are those of VirtioBlkSubmitRequest(), except
+  that the request is blocking, and host side failures are reported as well:
+
+  @retval EFI_SUCCESS          Transfer complete.
+
+  @retval EFI_DEVICE_ERROR     Failed to notify host side via VirtIo write, or
+                               host response is not VIRTIO_BLK_S_OK or failed
+                               to map Buffer for a bus master operation.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+SynchronousRequest (
+  IN              VBLK_DEV  *Dev,
+  IN              EFI_LBA   Lba,
+  IN              UINTN     BufferSize,
+  IN OUT volatile VOID      *Buffer,
+  IN              BOOLEAN   RequestIsWrite
+  )
+{
+  VBLK_WAITER  Waiter;
+  UINTN        PollPeriodUsecs;
+  EFI_STATUS   Status;
+
+  Waiter.Done   = FALSE;
+  Waiter.Status = EFI_DEVICE_ERROR;
+
+  Status = VirtioBlkSubmitRequest (
+             Dev,
+             Lba,
+             BufferSize,
+             Buffer,
+             RequestIsWrite,
+             NULL,
+             &Waiter
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Start polling with a short period, and back off exponentially, similarly
+  // to VirtioFlush().
+  //
+  PollPeriodUsecs = 1;
+  VirtioBlkPoll (Dev);
+  while (!Waiter.Done) {
+    gBS->Stall (PollPeriodUsecs);
+    if (PollPeriodUsecs < 1024) {
+      PollPeriodUsecs *= 2;
     }
+
+    VirtioBlkPoll (Dev);
   }
 
-UnmapRequestBuffer:
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, RequestMapping);
+  return Waiter.Status;
+}
 
-FreeHostStatusBuffer:
-  Dev->VirtIo->FreeSharedPages (
-                 Dev->VirtIo,
-                 EFI_SIZE_TO_PAGES (sizeof *HostStatus),
-                 HostStatusBuffer
-                 );
+/**
 
-  return Status;
+  Submit a read / write / flush request for EFI_BLOCK_IO2_PROTOCOL.
+
+  The request is blocking if Token is NULL or Token->Event is NULL, and
+  non-blocking otherwise. Parameters are those of VirtioBlkSubmitRequest().
+
+  @return  Status codes of SynchronousRequest() or VirtioBlkSubmitRequest().
+
+**/
+STATIC
+EFI_STATUS
+RequestEx (
+  IN              VBLK_DEV             *Dev,
+  IN              EFI_LBA              Lba,
+  IN OUT          EFI_BLOCK_IO2_TOKEN  *Token,
+  IN              UINTN                BufferSize,
+  IN OUT volatile VOID                 *Buffer,
+  IN              BOOLEAN              RequestIsWrite
+  )
+{
+  if ((Token == NULL) || (Token->Event == NULL)) {
+    return SynchronousRequest (Dev, Lba, BufferSize, Buffer, RequestIsWrite);
+  }
+
+  Token->TransactionStatus = EFI_NOT_READY;
+  return VirtioBlkSubmitRequest (
+           Dev,
+           Lba,
+           BufferSize,
+           Buffer,
+           RequestIsWrite,
+           Token,
+           NULL
+           );
+}
+
+/**
+
+  Complete a zero-sized EFI_BLOCK_IO2_PROTOCOL request immediately.
+
+  @param[in out] Token  The token of the request, or NULL.
+
+  @retval EFI_SUCCESS  The request is complete.
+
+**/
+STATIC
+EFI_STATUS
+CompleteEmptyRequestEx (
+  IN OUT EFI_BLOCK_IO2_TOKEN  *Token
+  )
+{
+  if ((Token != NULL) && (Token->Event != NULL)) {
+    Token->TransactionStatus = EFI_SUCCESS;
+    gBS->SignalEvent (Token->Event);
+  }
+
+  return EFI_SUCCESS;
 }
 
 /**
@@ -590,15 +850,188 @@ VirtioBlkFlushBlocks (
   VBLK_DEV  *Dev;
 
   Dev = VIRTIO_BLK_FROM_BLOCK_IO (This);
-  return Dev->BlockIoMedia.WriteCaching ?
-         SynchronousRequest (
+  if (!Dev->BlockIoMedia.WriteCaching) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Cover the writes submitted through EFI_BLOCK_IO2_PROTOCOL too.
+  //
+  VirtioBlkDrain (Dev);
+  return SynchronousRequest (
+           Dev,
+           0,      // Lba
+           0,      // BufferSize
+           NULL,   // Buffer
+           TRUE    // RequestIsWrite
+           );
+}
+
+//
+// UEFI Spec 2.10, 13.10 EFI Block I/O 2 Protocol
+// Driver Writer's Guide for UEFI 2.3.1 v1.01,
+//   24.2 Block I/O Protocol Implementations
+//
+EFI_STATUS
+EFIAPI
+VirtioBlkResetEx (
+  IN EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN BOOLEAN                 ExtendedVerification
+  )
+{
+  //
+  // The device keeps working correctly; let the requests in flight complete,
+  // so that no token remains outstanding.
+  //
+  VirtioBlkDrain (VIRTIO_BLK_FROM_BLOCK_IO2 (This));
+  return EFI_SUCCESS;
+}
+
+/**
+
+  ReadBlocksEx() operation for virtio-blk.
+
+  See
+  - UEFI Spec 2.10, 13.10 EFI Block I/O 2 Protocol,
+    EFI_BLOCK_IO2_PROTOCOL.ReadBlocksEx().
+  - Driver Writer's Guide for UEFI 2.3.1 v1.01, 24.2.2. ReadBlocks() and
+    ReadBlocksEx() Implementation.
+
+  If Token is NULL or Token->Event is NULL, the request is blocking. Otherwise
+  the function returns as soon as the request has been submitted to the
+  device, and Token->Event is signaled when the request completes.
+
+  A zero BufferSize completes the request immediately, successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioBlkReadBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  OUT    VOID                    *Buffer
+  )
+{
+  VBLK_DEV    *Dev;
+  EFI_STATUS  Status;
+
+  if (BufferSize == 0) {
+    return CompleteEmptyRequestEx (Token);
+  }
+
+  Dev    = VIRTIO_BLK_FROM_BLOCK_IO2 (This);
+  Status = VerifyReadWriteRequest (
+             &Dev->BlockIoMedia,
+             Lba,
+             BufferSize,
+             FALSE               // RequestIsWrite
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return RequestEx (
+           Dev,
+           Lba,
+           Token,
+           BufferSize,
+           Buffer,
+           FALSE       // RequestIsWrite
+           );
+}
+
+/**
+
+  WriteBlocksEx() operation for virtio-blk.
+
+  See
+  - UEFI Spec 2.10, 13.10 EFI Block I/O 2 Protocol,
+    EFI_BLOCK_IO2_PROTOCOL.WriteBlocksEx().
+  - Driver Writer's Guide for UEFI 2.3.1 v1.01, 24.2.3 WriteBlocks() and
+    WriteBlockEx() Implementation.
+
+  Blocking and non-blocking behavior is the same as in VirtioBlkReadBlocksEx().
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioBlkWriteBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  IN     VOID                    *Buffer
+  )
+{
+  VBLK_DEV    *Dev;
+  EFI_STATUS  Status;
+
+  if (BufferSize == 0) {
+    return CompleteEmptyRequestEx (Token);
+  }
+
+  Dev    = VIRTIO_BLK_FROM_BLOCK_IO2 (This);
+  Status = VerifyReadWriteRequest (
+             &Dev->BlockIoMedia,
+             Lba,
+             BufferSize,
+             TRUE                // RequestIsWrite
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return RequestEx (
+           Dev,
+           Lba,
+           Token,
+           BufferSize,
+           Buffer,
+           TRUE        // RequestIsWrite
+           );
+}
+
+/**
+
+  FlushBlocksEx() operation for virtio-blk.
+
+  See
+  - UEFI Spec 2.10, 13.10 EFI Block I/O 2 Protocol,
+    EFI_BLOCK_IO2_PROTOCOL.FlushBlocksEx().
+  - Driver Writer's Guide for UEFI 2.3.1 v1.01, 24.2.4 FlushBlocks() and
+    FlushBlocksEx() Implementation.
+
+  All requests in flight are completed before the flush is submitted, so the
+  flush covers every write that was started before the call.
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioBlkFlushBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token
+  )
+{
+  VBLK_DEV  *Dev;
+
+  Dev = VIRTIO_BLK_FROM_BLOCK_IO2 (This);
+  if (!Dev->BlockIoMedia.WriteCaching) {
+    return CompleteEmptyRequestEx (Token);
+  }
+
+  VirtioBlkDrain (Dev);
+  return RequestEx (
            Dev,
            0,      // Lba
+           Token,
            0,      // BufferSize
            NULL,   // Buffer
            TRUE    // RequestIsWrite
-           ) :
-         EFI_SUCCESS;
+           );
 }
 
 /**
@@ -684,6 +1117,155 @@ VirtioBlkDriverBindingSupported (
   return Status;
 }
 
+/**
+
+  Allocate and map the request slots of a virtio-blk device, after the ring
+  has been set up.
+
+  @param[in out] Dev  The virtio-blk device. Dev->Ring and Dev->Indirect must
+                      be valid.
+
+  @retval EFI_SUCCESS           The request slots are ready for use.
+
+  @retval EFI_OUT_OF_RESOURCES  Memory allocation failed.
+
+  @return                       Error codes from AllocateSharedPages() or
+                                VirtioMapAllBytesInSharedBuffer().
+
+**/
+STATIC
+EFI_STATUS
+VirtioBlkInitReqs (
+  IN OUT VBLK_DEV  *Dev
+  )
+{
+  VOID        *SharedReqs;
+  UINT16      ReqIdx;
+  EFI_STATUS  Status;
+
+  Dev->MaxPending = Dev->Indirect ? Dev->Ring.QueueSize : Dev->Ring.QueueSize / 3;
+  Dev->MaxPending = MIN (Dev->MaxPending, VBLK_MAX_PENDING);
+  ASSERT (Dev->MaxPending > 0);
+
+  Dev->Reqs = AllocateZeroPool (Dev->MaxPending * sizeof *Dev->Reqs);
+  if (Dev->Reqs == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Dev->FreeStack = AllocatePool (Dev->MaxPending * sizeof *Dev->FreeStack);
+  if (Dev->FreeStack == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto FreeReqs;
+  }
+
+  //
+  // The indirect descriptor tables, request headers and host status bytes are
+  // bi-directional, so allocate them in memory that can be mapped to access
+  // equally by both processor and the device.
+  //
+  Dev->SharedReqsPages = EFI_SIZE_TO_PAGES (
+                           Dev->MaxPending * sizeof *Dev->SharedReqs
+                           );
+  Status = Dev->VirtIo->AllocateSharedPages (
+                          Dev->VirtIo,
+                          Dev->SharedReqsPages,
+                          &SharedReqs
+                          );
+  if (EFI_ERROR (Status)) {
+    goto FreeFreeStack;
+  }
+
+  ZeroMem (SharedReqs, EFI_PAGES_TO_SIZE (Dev->SharedReqsPages));
+
+  Status = VirtioMapAllBytesInSharedBuffer (
+             Dev->VirtIo,
+             VirtioOperationBusMasterCommonBuffer,
+             SharedReqs,
+             EFI_PAGES_TO_SIZE (Dev->SharedReqsPages),
+             &Dev->SharedReqsDevAddr,
+             &Dev->SharedReqsMap
+             );
+  if (EFI_ERROR (Status)) {
+    goto FreeSharedReqs;
+  }
+
+  Dev->SharedReqs = SharedReqs;
+  for (ReqIdx = 0; ReqIdx < Dev->MaxPending; ReqIdx++) {
+    Dev->FreeStack[ReqIdx] = ReqIdx;
+  }
+
+  Dev->CurPending   = 0;
+  Dev->AsyncPending = 0;
+  Dev->LastUsed     = *Dev->Ring.Used.Idx;
+
+  //
+  // Completions are polled for; the device need not interrupt us.
+  //
+  *Dev->Ring.Avail.Flags = (UINT16)VRING_AVAIL_F_NO_INTERRUPT;
+
+  DEBUG ((
+    DEBUG_INFO,
+    "%a: MaxPending=%d Indirect=%d\n",
+    __func__,
+    Dev->MaxPending,
+    Dev->Indirect
+    ));
+  return EFI_SUCCESS;
+
+FreeSharedReqs:
+  Dev->VirtIo->FreeSharedPages (Dev->VirtIo, Dev->SharedReqsPages, SharedReqs);
+
+FreeFreeStack:
+  FreePool (Dev->FreeStack);
+
+FreeReqs:
+  FreePool (Dev->Reqs);
+
+  return Status;
+}
+
+/**
+
+  Release the request slots set up with VirtioBlkInitReqs(). The device must
+  have been reset already.
+
+  Requests that the device has not returned are failed, so that no token
+  remains outstanding and no buffer remains mapped.
+
+  @param[in out] Dev  The virtio-blk device.
+
+**/
+STATIC
+VOID
+VirtioBlkUninitReqs (
+  IN OUT VBLK_DEV  *Dev
+  )
+{
+  UINT16    ReqIdx;
+  VBLK_REQ  *Req;
+
+  for (ReqIdx = 0; ReqIdx < Dev->MaxPending; ReqIdx++) {
+    Req = &Dev->Reqs[ReqIdx];
+    if (Req->BufferMapping != NULL) {
+      Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Req->BufferMapping);
+    }
+
+    if (Req->Token != NULL) {
+      Req->Token->TransactionStatus = EFI_DEVICE_ERROR;
+      gBS->SignalEvent (Req->Token->Event);
+    }
+  }
+
+  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->SharedReqsMap);
+  Dev->VirtIo->FreeSharedPages (
+                 Dev->VirtIo,
+                 Dev->SharedReqsPages,
+                 Dev->SharedReqs
+                 );
+  FreePool (Dev->FreeStack);
+  FreePool (Dev->Reqs);
+}
+
 /**
 
   Set up all BlockIo and virtio-blk aspects of this driver for the specified
@@ -820,8 +1402,9 @@ VirtioBlkInit (
   }
 
   Features &= VIRTIO_BLK_F_BLK_SIZE | VIRTIO_BLK_F_TOPOLOGY | VIRTIO_BLK_F_RO |
-              VIRTIO_BLK_F_FLUSH | VIRTIO_F_VERSION_1 |
-              VIRTIO_F_IOMMU_PLATFORM;
+              VIRTIO_BLK_F_FLUSH | VIRTIO_F_RING_INDIRECT_DESC |
+              VIRTIO_F_VERSION_1 | VIRTIO_F_IOMMU_PLATFORM;
+  Dev->Indirect = (BOOLEAN)((Features & VIRTIO_F_RING_INDIRECT_DESC) != 0);
 
   //
   // In virtio-1.0, feature negotiation is expected to complete before queue
@@ -848,7 +1431,7 @@ VirtioBlkInit (
   }
 
   if (QueueSize < 3) {
-    // SynchronousRequest() uses at most three descriptors
+    // VirtioBlkSubmitRequest() uses at most three descriptors
     Status = EFI_UNSUPPORTED;
     goto Failed;
   }
@@ -897,6 +1480,11 @@ VirtioBlkInit (
     goto UnmapQueue;
   }
 
+  Status = VirtioBlkInitReqs (Dev);
+  if (EFI_ERROR (Status)) {
+    goto UnmapQueue;
+  }
+
   //
   // step 5 -- Report understood features.
   //
@@ -904,7 +1492,7 @@ VirtioBlkInit (
     Features &= ~(UINT64)(VIRTIO_F_VERSION_1 | VIRTIO_F_IOMMU_PLATFORM);
     Status    = Dev->VirtIo->SetGuestFeatures (Dev->VirtIo, Features);
     if (EFI_ERROR (Status)) {
-      goto UnmapQueue;
+      goto UninitReqs;
     }
   }
 
@@ -914,7 +1502,7 @@ VirtioBlkInit (
   NextDevStat |= VSTAT_DRIVER_OK;
   Status       = Dev->VirtIo->SetDeviceStatus (Dev->VirtIo, NextDevStat);
   if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+    goto UninitReqs;
   }
 
   //
@@ -970,8 +1558,21 @@ VirtioBlkInit (
       ));
   }
 
+  Dev->BlockIo2.Media         = &Dev->BlockIoMedia;
+  Dev->BlockIo2.Reset         = &VirtioBlkResetEx;
+  Dev->BlockIo2.ReadBlocksEx  = &VirtioBlkReadBlocksEx;
+  Dev->BlockIo2.WriteBlocksEx = &VirtioBlkWriteBlocksEx;
+  Dev->BlockIo2.FlushBlocksEx = &VirtioBlkFlushBlocksEx;
+
   return EFI_SUCCESS;
 
+UninitReqs:
+  //
+  // The device must forget the request slots before they are released.
+  //
+  Dev->VirtIo->SetDeviceStatus (Dev->VirtIo, 0);
+  VirtioBlkUninitReqs (Dev);
+
 UnmapQueue:
   Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap);
 
@@ -1011,10 +1612,12 @@ VirtioBlkUninit (
   //
   Dev->VirtIo->SetDeviceStatus (Dev->VirtIo, 0);
 
+  VirtioBlkUninitReqs (Dev);
   Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap);
   VirtioRingUninit (Dev->VirtIo, &Dev->Ring);
 
   SetMem (&Dev->BlockIo, sizeof Dev->BlockIo, 0x00);
+  SetMem (&Dev->BlockIo2, sizeof Dev->BlockIo2, 0x00);
   SetMem (&Dev->BlockIoMedia, sizeof Dev->BlockIoMedia, 0x00);
 }
 
@@ -1074,7 +1677,8 @@ VirtioBlkExitBoot (
 
   @return                       Error codes from the OpenProtocol() boot
                                 service, the VirtIo protocol, VirtioBlkInit(),
-                                or the InstallProtocolInterface() boot service.
+                                or the InstallMultipleProtocolInterfaces() boot
+                                service.
 
 **/
 EFI_STATUS
@@ -1124,22 +1728,39 @@ VirtioBlkDriverBindingStart (
     goto UninitDev;
   }
 
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  &VirtioBlkPollTimer,
+                  Dev,
+                  &Dev->PollTimer
+                  );
+  if (EFI_ERROR (Status)) {
+    goto CloseExitBoot;
+  }
+
   //
-  // Setup complete, attempt to export the driver instance's BlockIo interface.
+  // Setup complete, attempt to export the driver instance's BlockIo
+  // interfaces.
   //
   Dev->Signature = VBLK_SIG;
-  Status         = gBS->InstallProtocolInterface (
+  Status         = gBS->InstallMultipleProtocolInterfaces (
                           &DeviceHandle,
                           &gEfiBlockIoProtocolGuid,
-                          EFI_NATIVE_INTERFACE,
-                          &Dev->BlockIo
+                          &Dev->BlockIo,
+                          &gEfiBlockIo2ProtocolGuid,
+                          &Dev->BlockIo2,
+                          NULL
                           );
   if (EFI_ERROR (Status)) {
-    goto CloseExitBoot;
+    goto ClosePollTimer;
   }
 
   return EFI_SUCCESS;
 
+ClosePollTimer:
+  gBS->CloseEvent (Dev->PollTimer);
+
 CloseExitBoot:
   gBS->CloseEvent (Dev->ExitBoot);
 
@@ -1162,7 +1783,7 @@ FreeVirtioBlk:
 
 /**
 
-  Stop driving a virtio-blk device and remove its BlockIo interface.
+  Stop driving a virtio-blk device and remove its BlockIo interfaces.
 
   This function replays the success path of DriverBindingStart() in reverse.
   The host side virtio-blk device is reset, so that the OS boot loader or the
@@ -1212,15 +1833,24 @@ VirtioBlkDriverBindingStop (
   //
   // Handle Stop() requests for in-use driver instances gracefully.
   //
-  Status = gBS->UninstallProtocolInterface (
+  Status = gBS->UninstallMultipleProtocolInterfaces (
                   DeviceHandle,
                   &gEfiBlockIoProtocolGuid,
-                  &Dev->BlockIo
+                  &Dev->BlockIo,
+                  &gEfiBlockIo2ProtocolGuid,
+                  &Dev->BlockIo2,
+                  NULL
                   );
   if (EFI_ERROR (Status)) {
     return Status;
   }
 
+  //
+  // Signal the tokens of the requests in flight before tearing down.
+  //
+  VirtioBlkDrain (Dev);
+  gBS->CloseEvent (Dev->PollTimer);
+
   gBS->CloseEvent (Dev->ExitBoot);
 
   VirtioBlkUninit (Dev);
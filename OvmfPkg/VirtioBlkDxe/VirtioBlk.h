@@ -13,13 +13,62 @@
 #define _VIRTIO_BLK_DXE_H_
 
 #include <Protocol/BlockIo.h>
+#include <Protocol/BlockIo2.h>
 #include <Protocol/ComponentName.h>
 #include <Protocol/DriverBinding.h>
 
-#include <IndustryStandard/Virtio.h>
+#include <IndustryStandard/VirtioBlk.h>
 
 #define VBLK_SIG  SIGNATURE_32 ('V', 'B', 'L', 'K')
 
+//
+// Upper limit on the number of requests in flight. With indirect descriptors
+// each request takes one descriptor of the ring, otherwise it takes three.
+//
+#define VBLK_MAX_PENDING  64
+
+//
+// Period of the timer that completes asynchronous requests, in 100ns units.
+// The actual period is rounded up to the platform timer tick.
+//
+#define VBLK_POLL_PERIOD  EFI_TIMER_PERIOD_MICROSECONDS (100)
+
+//
+// The parts of a request that the device accesses besides the data buffer:
+// the indirect descriptor table, the request header and the status byte. The
+// structures of all requests are allocated and mapped together, as a common
+// buffer, when the device is initialized.
+//
+#pragma pack(1)
+typedef struct {
+  VRING_DESC        Indirect[3];
+  VIRTIO_BLK_REQ    Request;
+  UINT8             HostStatus;
+  UINT8             Reserved[15];
+} VBLK_SHARED_REQ;
+#pragma pack()
+
+//
+// Outcome of a blocking request, filled in when the request completes.
+//
+typedef struct {
+  BOOLEAN       Done;
+  EFI_STATUS    Status;
+} VBLK_WAITER;
+
+//
+// Driver side bookkeeping of a request in flight. Token or Waiter is set,
+// depending on whether the request is non-blocking. Neither is set when the
+// device could not be notified of the request: the caller has seen the
+// error, and the request only waits for the device to return it.
+//
+typedef struct {
+  EFI_BLOCK_IO2_TOKEN    *Token;
+  VBLK_WAITER            *Waiter;
+  VOID                   *BufferMapping;  // NULL for flush
+  BOOLEAN                RequestIsWrite;
+} VBLK_REQ;
+
 typedef struct {
   //
   // Parts of this structure are initialized / torn down in various functions
@@ -35,11 +84,27 @@ typedef struct {
   EFI_BLOCK_IO_PROTOCOL     BlockIo;           // VirtioBlkInit       1
   EFI_BLOCK_IO_MEDIA        BlockIoMedia;      // VirtioBlkInit       1
   VOID                      *RingMap;          // VirtioRingMap       2
+  EFI_BLOCK_IO2_PROTOCOL    BlockIo2;          // VirtioBlkInit       1
+  BOOLEAN                   Indirect;          // VirtioBlkInit       1
+  UINT16                    MaxPending;        // VirtioBlkInitReqs   2
+  UINT16                    CurPending;        // VirtioBlkInitReqs   2
+  UINT16                    AsyncPending;      // VirtioBlkInitReqs   2
+  UINT16                    LastUsed;          // VirtioBlkInitReqs   2
+  UINT16                    *FreeStack;        // VirtioBlkInitReqs   2
+  VBLK_REQ                  *Reqs;             // VirtioBlkInitReqs   2
+  VBLK_SHARED_REQ           *SharedReqs;       // VirtioBlkInitReqs   2
+  UINTN                     SharedReqsPages;   // VirtioBlkInitReqs   2
+  EFI_PHYSICAL_ADDRESS      SharedReqsDevAddr; // VirtioBlkInitReqs   2
+  VOID                      *SharedReqsMap;    // VirtioBlkInitReqs   2
+  EFI_EVENT                 PollTimer;         // DriverBindingStart  0
 } VBLK_DEV;
 
 #define VIRTIO_BLK_FROM_BLOCK_IO(BlockIoPointer) \
         CR (BlockIoPointer, VBLK_DEV, BlockIo, VBLK_SIG)
 
+#define VIRTIO_BLK_FROM_BLOCK_IO2(BlockIo2Pointer) \
+        CR (BlockIo2Pointer, VBLK_DEV, BlockIo2, VBLK_SIG)
+
 /**
 
   Device probe function for this driver.
@@ -109,7 +174,7 @@ VirtioBlkDriverBindingSupported (
 
   @return                       Error codes from the OpenProtocol() boot
                                 service, VirtioBlkInit(), or the
-                                InstallProtocolInterface() boot service.
+                                InstallMultipleProtocolInterfaces() boot service.
 
 **/
 
@@ -123,7 +188,7 @@ VirtioBlkDriverBindingStart (
 
 /**
 
-  Stop driving a virtio-blk device and remove its BlockIo interface.
+  Stop driving a virtio-blk device and remove its BlockIo interfaces.
 
   This function replays the success path of DriverBindingStart() in reverse.
   The host side virtio-blk device is reset, so that the OS boot loader or the
@@ -244,6 +309,94 @@ VirtioBlkFlushBlocks (
   IN EFI_BLOCK_IO_PROTOCOL  *This
   );
 
+//
+// UEFI Spec 2.10, 13.10 EFI Block I/O 2 Protocol
+// Driver Writer's Guide for UEFI 2.3.1 v1.01,
+//   24.2 Block I/O Protocol Implementations
+//
+EFI_STATUS
+EFIAPI
+VirtioBlkResetEx (
+  IN EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN BOOLEAN                 ExtendedVerification
+  );
+
+/**
+
+  ReadBlocksEx() operation for virtio-blk.
+
+  See
+  - UEFI Spec 2.10, 13.10 EFI Block I/O 2 Protocol,
+    EFI_BLOCK_IO2_PROTOCOL.ReadBlocksEx().
+  - Driver Writer's Guide for UEFI 2.3.1 v1.01, 24.2.2. ReadBlocks() and
+    ReadBlocksEx() Implementation.
+
+  If Token is NULL or Token->Event is NULL, the request is blocking. Otherwise
+  the function returns as soon as the request has been submitted to the
+  device, and Token->Event is signaled when the request completes.
+
+  A zero BufferSize completes the request immediately, successfully.
+
+**/
+
+EFI_STATUS
+EFIAPI
+VirtioBlkReadBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  OUT    VOID                    *Buffer
+  );
+
+/**
+
+  WriteBlocksEx() operation for virtio-blk.
+
+  See
+  - UEFI Spec 2.10, 13.10 EFI Block I/O 2 Protocol,
+    EFI_BLOCK_IO2_PROTOCOL.WriteBlocksEx().
+  - Driver Writer's Guide for UEFI 2.3.1 v1.01, 24.2.3 WriteBlocks() and
+    WriteBlockEx() Implementation.
+
+  Blocking and non-blocking behavior is the same as in VirtioBlkReadBlocksEx().
+
+**/
+
+EFI_STATUS
+EFIAPI
+VirtioBlkWriteBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  IN     VOID                    *Buffer
+  );
+
+/**
+
+  FlushBlocksEx() operation for virtio-blk.
+
+  See
+  - UEFI Spec 2.10, 13.10 EFI Block I/O 2 Protocol,
+    EFI_BLOCK_IO2_PROTOCOL.FlushBlocksEx().
+  - Driver Writer's Guide for UEFI 2.3.1 v1.01, 24.2.4 FlushBlocks() and
+    FlushBlocksEx() Implementation.
+
+  All requests in flight are completed before the flush is submitted, so the
+  flush covers every write that was started before the call.
+
+**/
+
+EFI_STATUS
+EFIAPI
+VirtioBlkFlushBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token
+  );
+
 //
 // The purpose of the following scaffolding (EFI_COMPONENT_NAME_PROTOCOL and
 // EFI_COMPONENT_NAME2_PROTOCOL implementation) is to format the driver's name
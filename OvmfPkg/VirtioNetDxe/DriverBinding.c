@@ -3,7 +3,7 @@
   Driver Binding code and its private helpers for the virtio-net driver.
 
   Copyright (C) 2013, Red Hat, Inc.
-  Copyright (c) 2006 - 2014, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -41,6 +41,10 @@
                                     host, the current link status is stored in
                                     *MediaPresent. Otherwise MediaPresent is
                                     unused.
+  param[out] TxChecksum             The kinds of checksum the host completes on
+                                    transmit, EDKII_NETWORK_OFFLOAD_xxx.
+  param[out] RxChecksum             The kinds of checksum the host validates on
+                                    receive, EDKII_NETWORK_OFFLOAD_xxx.
 
   @retval EFI_UNSUPPORTED           The host doesn't supply a MAC address.
   @return                           Status codes from VirtIo protocol members.
@@ -53,7 +57,9 @@ VirtioNetGetFeatures (
   IN OUT  VNET_DEV         *Dev,
   OUT     EFI_MAC_ADDRESS  *MacAddress,
   OUT     BOOLEAN          *MediaPresentSupported,
-  OUT     BOOLEAN          *MediaPresent
+  OUT     BOOLEAN          *MediaPresent,
+  OUT     UINT32           *TxChecksum,
+  OUT     UINT32           *RxChecksum
   )
 {
   EFI_STATUS  Status;
@@ -128,6 +134,22 @@ VirtioNetGetFeatures (
     *MediaPresent = (BOOLEAN)((LinkStatus & VIRTIO_NET_S_LINK_UP) != 0);
   }
 
+  //
+  // check if the host can compute the checksum of outgoing TCP and UDP
+  // packets, and if it validates the checksum of incoming ones
+  //
+  *TxChecksum = 0;
+  *RxChecksum = 0;
+  if ((Features & VIRTIO_NET_F_CSUM) != 0) {
+    *TxChecksum = EDKII_NETWORK_OFFLOAD_TCP4 | EDKII_NETWORK_OFFLOAD_UDP4 |
+                  EDKII_NETWORK_OFFLOAD_TCP6 | EDKII_NETWORK_OFFLOAD_UDP6;
+  }
+
+  if ((Features & VIRTIO_NET_F_GUEST_CSUM) != 0) {
+    *RxChecksum = EDKII_NETWORK_OFFLOAD_TCP4 | EDKII_NETWORK_OFFLOAD_UDP4 |
+                  EDKII_NETWORK_OFFLOAD_TCP6 | EDKII_NETWORK_OFFLOAD_UDP6;
+  }
+
 YieldDevice:
   Dev->VirtIo->SetDeviceStatus (
                  Dev->VirtIo,
@@ -139,7 +161,8 @@ YieldDevice:
 
 /**
   Set up the Simple Network Protocol fields, the Simple Network Mode fields,
-  and the Exit Boot Services Event of the virtio-net driver instance.
+  the Network Offload and Rx Buffer Protocol fields, and the Exit Boot Services
+  Event of the virtio-net driver instance.
 
   This function may only be called by VirtioNetDriverBindingStart().
 
@@ -229,7 +252,9 @@ VirtioNetSnpPopulate (
              Dev,
              &Dev->Snm.CurrentAddress,
              &Dev->Snm.MediaPresentSupported,
-             &Dev->Snm.MediaPresent
+             &Dev->Snm.MediaPresent,
+             &Dev->Offload.TxChecksum,
+             &Dev->Offload.RxChecksum
              );
   if (EFI_ERROR (Status)) {
     goto CloseWaitForPacket;
@@ -242,6 +267,12 @@ VirtioNetSnpPopulate (
     );
   SetMem (&Dev->Snm.BroadcastAddress, SIZE_OF_VNET (Mac), 0xFF);
 
+  Dev->Offload.SetTxChecksum   = &VirtioNetSetTxChecksum;
+  Dev->Offload.RxChecksumValid = &VirtioNetRxChecksumValid;
+  Dev->TxCsumKinds             = 0;
+  Dev->RxLoan.Receive          = &VirtioNetRxLoanReceive;
+  Dev->RxLoan.Return           = &VirtioNetRxLoanReturn;
+
   //
   // VirtioNetExitBoot() is queued by ExitBootServices(); its purpose is to
   // cancel any pending virtio requests. The TPL_CALLBACK reasoning is
@@ -533,6 +564,10 @@ VirtioNetDriverBindingStart (
                   &Dev->Snp,
                   &gEfiDevicePathProtocolGuid,
                   Dev->MacDevicePath,
+                  &gEdkiiNetworkOffloadProtocolGuid,
+                  &Dev->Offload,
+                  &gEdkiiNetworkRxBufferProtocolGuid,
+                  &Dev->RxLoan,
                   NULL
                   );
   if (EFI_ERROR (Status)) {
@@ -564,6 +599,10 @@ UninstallMultiple:
          Dev->MacDevicePath,
          &gEfiSimpleNetworkProtocolGuid,
          &Dev->Snp,
+         &gEdkiiNetworkOffloadProtocolGuid,
+         &Dev->Offload,
+         &gEdkiiNetworkRxBufferProtocolGuid,
+         &Dev->RxLoan,
          NULL
          );
 
@@ -677,6 +716,10 @@ VirtioNetDriverBindingStop (
              Dev->MacDevicePath,
              &gEfiSimpleNetworkProtocolGuid,
              &Dev->Snp,
+             &gEdkiiNetworkOffloadProtocolGuid,
+             &Dev->Offload,
+             &gEdkiiNetworkRxBufferProtocolGuid,
+             &Dev->RxLoan,
              NULL
              );
       FreePool (Dev->MacDevicePath);
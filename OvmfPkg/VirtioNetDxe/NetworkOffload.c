@@ -0,0 +1,388 @@
+/** @file
+
+  This file implements the EDKII Network Offload Protocol for the virtio-net
+  driver, on top of the VIRTIO_NET_F_CSUM and VIRTIO_NET_F_GUEST_CSUM
+  features, and the checksum handling of the Transmit and Receive SNP member
+  functions.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/BaseLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "VirtioNet.h"
+
+//
+// offsets of the checksum field in the TCP and UDP headers
+//
+#define VNET_TCP_CSUM_OFFSET  OFFSET_OF (TCP_HEAD, Checksum)
+#define VNET_UDP_CSUM_OFFSET  OFFSET_OF (EFI_UDP_HEADER, Checksum)
+
+/**
+  Find the TCP or UDP packet in an Ethernet frame.
+
+  Only untagged frames of an unfragmented IPv4 datagram, or of an IPv6 packet
+  without extension headers, are recognized.
+
+  @param[in]  Frame      The Ethernet frame, starting with the media header.
+  @param[in]  FrameSize  The size of the frame.
+  @param[out] Kind       The kind of checksum of the packet,
+                         EDKII_NETWORK_OFFLOAD_xxx.
+  @param[out] L4Offset   The offset of the TCP or UDP header in the frame.
+  @param[out] L4Length   The length of the TCP or UDP header and data.
+
+  @retval TRUE   The frame holds a TCP or UDP packet.
+  @retval FALSE  The frame holds something else, or is malformed.
+**/
+STATIC
+BOOLEAN
+VirtioNetParseFrame (
+  IN  CONST UINT8  *Frame,
+  IN  UINTN        FrameSize,
+  OUT UINT32       *Kind,
+  OUT UINTN        *L4Offset,
+  OUT UINTN        *L4Length
+  )
+{
+  CONST ETHER_HEAD      *Ether;
+  CONST IP4_HEAD        *Ip4;
+  CONST EFI_IP6_HEADER  *Ip6;
+  UINTN                 HeadLen;
+  UINT8                 Protocol;
+
+  if (FrameSize < sizeof (ETHER_HEAD)) {
+    return FALSE;
+  }
+
+  Ether = (CONST ETHER_HEAD *)Frame;
+
+  switch (NTOHS (Ether->EtherType)) {
+    case VNET_ETHER_TYPE_IP4:
+      if (FrameSize < sizeof (ETHER_HEAD) + sizeof (IP4_HEAD)) {
+        return FALSE;
+      }
+
+      Ip4     = (CONST IP4_HEAD *)(Ether + 1);
+      HeadLen = (UINTN)Ip4->HeadLen << 2;
+      if ((Ip4->Ver != 4) || (HeadLen < sizeof (IP4_HEAD)) ||
+          (NTOHS (Ip4->TotalLen) < HeadLen) ||
+          ((NTOHS (Ip4->Fragment) & 0x3FFF) != 0))
+      {
+        return FALSE;
+      }
+
+      *L4Offset = sizeof (ETHER_HEAD) + HeadLen;
+      *L4Length = NTOHS (Ip4->TotalLen) - HeadLen;
+      Protocol  = Ip4->Protocol;
+      *Kind     = (Protocol == EFI_IP_PROTO_TCP) ? EDKII_NETWORK_OFFLOAD_TCP4 :
+                  EDKII_NETWORK_OFFLOAD_UDP4;
+      break;
+
+    case VNET_ETHER_TYPE_IP6:
+      if (FrameSize < sizeof (ETHER_HEAD) + sizeof (EFI_IP6_HEADER)) {
+        return FALSE;
+      }
+
+      Ip6 = (CONST EFI_IP6_HEADER *)(Ether + 1);
+      if (Ip6->Version != 6) {
+        return FALSE;
+      }
+
+      *L4Offset = sizeof (ETHER_HEAD) + sizeof (EFI_IP6_HEADER);
+      *L4Length = NTOHS (Ip6->PayloadLength);
+      Protocol  = Ip6->NextHeader;
+      *Kind     = (Protocol == EFI_IP_PROTO_TCP) ? EDKII_NETWORK_OFFLOAD_TCP6 :
+                  EDKII_NETWORK_OFFLOAD_UDP6;
+      break;
+
+    default:
+      return FALSE;
+  }
+
+  if (Protocol == EFI_IP_PROTO_TCP) {
+    if (*L4Length < sizeof (TCP_HEAD)) {
+      return FALSE;
+    }
+  } else if (Protocol == EFI_IP_PROTO_UDP) {
+    if (*L4Length < sizeof (EFI_UDP_HEADER)) {
+      return FALSE;
+    }
+  } else {
+    return FALSE;
+  }
+
+  return (BOOLEAN)(*L4Offset + *L4Length <= FrameSize);
+}
+
+/**
+  Store the complement of the one's complement sum of a TCP or UDP packet in
+  its checksum field, which holds the partial checksum.
+
+  @param[in,out] L4Header    The TCP or UDP header.
+  @param[in]     L4Length    The length of the TCP or UDP header and data.
+  @param[in]     CsumOffset  The offset of the checksum field in the header.
+**/
+STATIC
+VOID
+VirtioNetCompleteChecksum (
+  IN OUT UINT8  *L4Header,
+  IN     UINTN  L4Length,
+  IN     UINTN  CsumOffset
+  )
+{
+  UINT16  Checksum;
+
+  Checksum = (UINT16) ~NetblockChecksum (L4Header, (UINT32)L4Length);
+
+  //
+  // A UDP checksum of zero means no checksum (RFC 768).
+  //
+  if ((CsumOffset == VNET_UDP_CSUM_OFFSET) && (Checksum == 0)) {
+    Checksum = 0xFFFF;
+  }
+
+  WriteUnaligned16 ((UINT16 *)(L4Header + CsumOffset), Checksum);
+}
+
+/**
+  Enable or disable the completion of partial checksums on transmit.
+
+  @param[in]  This    Pointer to the EDKII_NETWORK_OFFLOAD_PROTOCOL instance.
+  @param[in]  Kinds   The kinds of checksum, EDKII_NETWORK_OFFLOAD_xxx.
+  @param[in]  Enable  TRUE to enable, FALSE to disable.
+
+  @retval EFI_SUCCESS      The kinds are enabled or disabled.
+  @retval EFI_UNSUPPORTED  The device doesn't offer VIRTIO_NET_F_CSUM.
+**/
+EFI_STATUS
+EFIAPI
+VirtioNetSetTxChecksum (
+  IN EDKII_NETWORK_OFFLOAD_PROTOCOL  *This,
+  IN UINT32                          Kinds,
+  IN BOOLEAN                         Enable
+  )
+{
+  VNET_DEV  *Dev;
+  EFI_TPL   OldTpl;
+
+  if (This == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Dev = VIRTIO_NET_FROM_OFFLOAD (This);
+  if ((Kinds & ~Dev->Offload.TxChecksum) != 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  if (Enable) {
+    Dev->TxCsumKinds |= Kinds;
+  } else {
+    Dev->TxCsumKinds &= ~Kinds;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return EFI_SUCCESS;
+}
+
+/**
+  Check whether the device validated the checksum of a received TCP or UDP
+  packet.
+
+  VirtioNetRxChecksumRecord() remembers the transport header of the last
+  VNET_MAX_PENDING packets validated by the device, in the buffers of the
+  callers of VirtioNetReceive(). A packet is reported valid only if its header
+  is still at the same place, with the same length and checksum field.
+
+  @param[in]  This    Pointer to the EDKII_NETWORK_OFFLOAD_PROTOCOL instance.
+  @param[in]  Header  The TCP or UDP header.
+  @param[in]  Length  The length of the TCP or UDP header and data.
+
+  @retval TRUE   The checksum of the packet is valid.
+  @retval FALSE  The caller must check the checksum itself.
+**/
+BOOLEAN
+EFIAPI
+VirtioNetRxChecksumValid (
+  IN EDKII_NETWORK_OFFLOAD_PROTOCOL  *This,
+  IN CONST VOID                      *Header,
+  IN UINTN                           Length
+  )
+{
+  VNET_DEV      *Dev;
+  EFI_TPL       OldTpl;
+  VNET_RX_CSUM  *Entry;
+  UINTN         Index;
+  BOOLEAN       Valid;
+
+  if ((This == NULL) || (Header == NULL)) {
+    return FALSE;
+  }
+
+  Dev    = VIRTIO_NET_FROM_OFFLOAD (This);
+  Valid  = FALSE;
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  for (Index = 0; Index < VNET_MAX_PENDING; ++Index) {
+    Entry = &Dev->RxCsum[Index];
+    if ((Entry->Header == Header) && (Entry->Length == Length)) {
+      Valid = (BOOLEAN)(ReadUnaligned16 (
+                          (CONST UINT16 *)(Entry->Header + Entry->CsumOffset)
+                          ) == Entry->Checksum);
+      break;
+    }
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return Valid;
+}
+
+/**
+  Fill in the checksum fields of the virtio-net request header of a frame to
+  transmit.
+
+  If the transmit checksum of the kind of the frame is enabled, the frame
+  carries a partial checksum, which the device completes. If the frame is
+  padded after the IP packet, the device would add the padding to the sum,
+  so the checksum is completed here instead.
+
+  @param[in]     Dev        The VNET_DEV driver instance.
+  @param[in,out] Frame      The Ethernet frame, starting with the media header.
+  @param[in]     FrameSize  The size of the frame.
+  @param[out]    Req        The virtio-net request header of the frame.
+**/
+VOID
+EFIAPI
+VirtioNetTxChecksumReq (
+  IN     VNET_DEV            *Dev,
+  IN OUT UINT8               *Frame,
+  IN     UINTN               FrameSize,
+  OUT    VIRTIO_1_0_NET_REQ  *Req
+  )
+{
+  UINT32  Kind;
+  UINTN   L4Offset;
+  UINTN   L4Length;
+  UINTN   CsumOffset;
+
+  Req->V0_9_5.Flags      = 0;
+  Req->V0_9_5.CsumStart  = 0;
+  Req->V0_9_5.CsumOffset = 0;
+
+  if ((Dev->TxCsumKinds == 0) ||
+      !VirtioNetParseFrame (Frame, FrameSize, &Kind, &L4Offset, &L4Length) ||
+      ((Dev->TxCsumKinds & Kind) == 0))
+  {
+    return;
+  }
+
+  CsumOffset = ((Kind & (EDKII_NETWORK_OFFLOAD_TCP4 | EDKII_NETWORK_OFFLOAD_TCP6)) != 0) ?
+               VNET_TCP_CSUM_OFFSET : VNET_UDP_CSUM_OFFSET;
+
+  if (L4Offset + L4Length != FrameSize) {
+    VirtioNetCompleteChecksum (Frame + L4Offset, L4Length, CsumOffset);
+    return;
+  }
+
+  //
+  // virtio-0.9.5, Appendix C, Packet Transmission
+  //
+  Req->V0_9_5.Flags      = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+  Req->V0_9_5.CsumStart  = (UINT16)L4Offset;
+  Req->V0_9_5.CsumOffset = (UINT16)CsumOffset;
+}
+
+/**
+  Handle the checksum flags of the virtio-net request header of a received
+  frame, after the frame was copied to the caller's buffer.
+
+  A partial checksum left by the device is completed, then the TCP or UDP
+  header of a frame whose checksum the device validated is remembered for
+  VirtioNetRxChecksumValid(). The packets previously received into the same
+  buffer are forgotten first.
+
+  @param[in,out] Dev        The VNET_DEV driver instance.
+  @param[in]     Req        The virtio-net request header of the frame.
+  @param[in,out] Frame      The frame, in the caller's buffer.
+  @param[in]     FrameSize  The size of the frame.
+**/
+VOID
+EFIAPI
+VirtioNetRxChecksumRecord (
+  IN OUT VNET_DEV              *Dev,
+  IN     CONST VIRTIO_NET_REQ  *Req,
+  IN OUT UINT8                 *Frame,
+  IN     UINTN                 FrameSize
+  )
+{
+  VNET_RX_CSUM  *Entry;
+  UINTN         Index;
+  UINT32        Kind;
+  UINTN         L4Offset;
+  UINTN         L4Length;
+  UINTN         CsumOffset;
+
+  if (Dev->Offload.RxChecksum == 0) {
+    return;
+  }
+
+  for (Index = 0; Index < VNET_MAX_PENDING; ++Index) {
+    Entry = &Dev->RxCsum[Index];
+    if ((Entry->Header != NULL) && (Entry->Header < Frame + FrameSize) &&
+        (Entry->Header + Entry->Length > Frame))
+    {
+      Entry->Header = NULL;
+      Entry->Length = 0;
+    }
+  }
+
+  if ((Req->Flags & (VIRTIO_NET_HDR_F_NEEDS_CSUM |
+                     VIRTIO_NET_HDR_F_DATA_VALID)) == 0)
+  {
+    return;
+  }
+
+  if (!VirtioNetParseFrame (Frame, FrameSize, &Kind, &L4Offset, &L4Length)) {
+    Kind = 0;
+  }
+
+  CsumOffset = ((Kind & (EDKII_NETWORK_OFFLOAD_TCP4 | EDKII_NETWORK_OFFLOAD_TCP6)) != 0) ?
+               VNET_TCP_CSUM_OFFSET : VNET_UDP_CSUM_OFFSET;
+
+  if ((Req->Flags & VIRTIO_NET_HDR_F_NEEDS_CSUM) != 0) {
+    //
+    // virtio-0.9.5, Appendix C, Packet Reception: the checksum from CsumStart
+    // to the end of the frame must be stored at CsumStart + CsumOffset.
+    //
+    if ((Req->CsumStart >= FrameSize) ||
+        ((UINTN)Req->CsumOffset + sizeof (UINT16) > FrameSize - Req->CsumStart))
+    {
+      return;
+    }
+
+    VirtioNetCompleteChecksum (
+      Frame + Req->CsumStart,
+      FrameSize - Req->CsumStart,
+      Req->CsumOffset
+      );
+
+    if ((Kind == 0) || (Req->CsumStart != L4Offset) ||
+        (Req->CsumOffset != CsumOffset) || (L4Offset + L4Length != FrameSize))
+    {
+      return;
+    }
+  } else if (Kind == 0) {
+    return;
+  }
+
+  Entry             = &Dev->RxCsum[Dev->RxCsumNext];
+  Entry->Header     = Frame + L4Offset;
+  Entry->Length     = L4Length;
+  Entry->CsumOffset = (UINT16)CsumOffset;
+  Entry->Checksum   = ReadUnaligned16 ((CONST UINT16 *)(Entry->Header + CsumOffset));
+  Dev->RxCsumNext   = (Dev->RxCsumNext + 1) % VNET_MAX_PENDING;
+}
@@ -0,0 +1,199 @@
+/** @file
+
+  This file implements the EDKII Network Rx Buffer Protocol for the virtio-net
+  driver: the frames the device received into RxBuf are lent to the caller,
+  and their descriptors are given back to the device when the frames are
+  returned.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/BaseLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "VirtioNet.h"
+
+/**
+  Receive a frame without copying it.
+
+  @param[in]   This               Pointer to the EDKII_NETWORK_RX_BUFFER_PROTOCOL instance.
+  @param[out]  Frame              The frame, starting with the media header, in RxBuf.
+  @param[out]  FrameSize          The size of the frame, in bytes.
+
+  @retval EFI_SUCCESS             The frame is on loan until it is returned.
+  @retval EFI_NOT_READY           No frame is received.
+  @retval EFI_OUT_OF_RESOURCES    Too many frames are on loan, the frame is kept
+                                  for VirtioNetReceive().
+  @retval EFI_NOT_STARTED         The network interface has not been started.
+  @retval EFI_DEVICE_ERROR        The network interface is not initialized, or a
+                                  short frame is dropped.
+  @retval EFI_INVALID_PARAMETER   One of the parameters is NULL.
+**/
+EFI_STATUS
+EFIAPI
+VirtioNetRxLoanReceive (
+  IN  EDKII_NETWORK_RX_BUFFER_PROTOCOL  *This,
+  OUT VOID                              **Frame,
+  OUT UINTN                             *FrameSize
+  )
+{
+  VNET_DEV    *Dev;
+  EFI_TPL     OldTpl;
+  EFI_STATUS  Status;
+  UINT16      RxCurUsed;
+  UINT16      UsedElemIdx;
+  UINT32      DescIdx;
+  UINT32      RxLen;
+  UINT8       *RxPtr;
+
+  if ((This == NULL) || (Frame == NULL) || (FrameSize == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Dev    = VIRTIO_NET_FROM_RX_LOAN (This);
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  switch (Dev->Snm.State) {
+    case EfiSimpleNetworkStopped:
+      Status = EFI_NOT_STARTED;
+      goto Exit;
+    case EfiSimpleNetworkStarted:
+      Status = EFI_DEVICE_ERROR;
+      goto Exit;
+    default:
+      break;
+  }
+
+  //
+  // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device
+  //
+  MemoryFence ();
+  RxCurUsed = *Dev->RxRing.Used.Idx;
+  MemoryFence ();
+
+  if (Dev->RxLastUsed == RxCurUsed) {
+    Status = EFI_NOT_READY;
+    goto Exit;
+  }
+
+  if (Dev->RxLoaned >= Dev->RxMaxLoaned) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit; // keep the packet
+  }
+
+  UsedElemIdx = Dev->RxLastUsed % Dev->RxRing.QueueSize;
+  DescIdx     = Dev->RxRing.Used.UsedElem[UsedElemIdx].Id;
+  RxLen       = Dev->RxRing.Used.UsedElem[UsedElemIdx].Len;
+
+  //
+  // the virtio-net request header must be complete; we skip it
+  //
+  ASSERT (RxLen >= Dev->RxRing.Desc[DescIdx].Len);
+  RxLen -= Dev->RxRing.Desc[DescIdx].Len;
+  //
+  // the host must not have filled in more data than requested
+  //
+  ASSERT (RxLen <= Dev->RxRing.Desc[DescIdx + 1].Len);
+
+  ++Dev->RxLastUsed;
+
+  if (RxLen < Dev->Snm.MediaHeaderSize) {
+    //
+    // drop useless short packet
+    //
+    Status = VirtioNetRxRecycleDesc (Dev, (UINT16)DescIdx);
+    if (!EFI_ERROR (Status)) {
+      Status = EFI_DEVICE_ERROR;
+    }
+
+    goto Exit;
+  }
+
+  RxPtr = Dev->RxBuf + (UINTN)(Dev->RxRing.Desc[DescIdx + 1].Addr -
+                               Dev->RxBufDeviceBase);
+
+  VirtioNetRxChecksumRecord (
+    Dev,
+    (VIRTIO_NET_REQ *)(Dev->RxBuf + (UINTN)(Dev->RxRing.Desc[DescIdx].Addr -
+                                            Dev->RxBufDeviceBase)),
+    RxPtr,
+    RxLen
+    );
+
+  //
+  // VirtioNetRxLoanReturn() runs at TPL_NOTIFY
+  //
+  gBS->RaiseTPL (TPL_NOTIFY);
+  ++Dev->RxLoaned;
+  gBS->RestoreTPL (TPL_CALLBACK);
+
+  *Frame     = RxPtr;
+  *FrameSize = RxLen;
+  Status     = EFI_SUCCESS;
+
+Exit:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Return a frame on loan, so that its descriptors receive again.
+
+  The frame may be in the RxBuf of the current initialization, or in the
+  orphaned RxBuf of the previous one.
+
+  @param[in]  This                Pointer to the EDKII_NETWORK_RX_BUFFER_PROTOCOL instance.
+  @param[in]  Frame               The frame returned by VirtioNetRxLoanReceive().
+**/
+VOID
+EFIAPI
+VirtioNetRxLoanReturn (
+  IN EDKII_NETWORK_RX_BUFFER_PROTOCOL  *This,
+  IN VOID                              *Frame
+  )
+{
+  VNET_DEV  *Dev;
+  EFI_TPL   OldTpl;
+  UINT8     *RxPtr;
+  UINTN     PktIdx;
+
+  Dev    = VIRTIO_NET_FROM_RX_LOAN (This);
+  RxPtr  = Frame;
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  if ((Dev->RxBuf != NULL) &&
+      (RxPtr >= Dev->RxBuf) &&
+      (RxPtr < Dev->RxBuf + EFI_PAGES_TO_SIZE (Dev->RxBufNrPages)))
+  {
+    //
+    // each packet takes two descriptors and RxBufSize bytes, the frame
+    // follows the virtio-net request header
+    //
+    PktIdx = (UINTN)(RxPtr - Dev->RxBuf) / Dev->RxBufSize;
+    ASSERT (RxPtr == Dev->RxBuf + PktIdx * Dev->RxBufSize + Dev->RxRing.Desc[0].Len);
+    ASSERT (Dev->RxLoaned > 0);
+
+    --Dev->RxLoaned;
+    VirtioNetRxRecycleDesc (Dev, (UINT16)(PktIdx * 2));
+  } else if ((Dev->RxOrphanBuf != NULL) &&
+             (RxPtr >= Dev->RxOrphanBuf) &&
+             (RxPtr < Dev->RxOrphanBuf + EFI_PAGES_TO_SIZE (Dev->RxOrphanNrPages)))
+  {
+    ASSERT (Dev->RxOrphanLoaned > 0);
+    if (--Dev->RxOrphanLoaned == 0) {
+      Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RxOrphanMap);
+      Dev->VirtIo->FreeSharedPages (
+                     Dev->VirtIo,
+                     Dev->RxOrphanNrPages,
+                     Dev->RxOrphanBuf
+                     );
+      Dev->RxOrphanBuf = NULL;
+    }
+  } else {
+    ASSERT (FALSE);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
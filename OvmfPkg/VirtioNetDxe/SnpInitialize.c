@@ -4,7 +4,7 @@
   any.
 
   Copyright (C) 2013, Red Hat, Inc.
-  Copyright (c) 2006 - 2010, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
   Copyright (c) 2017, AMD Inc, All rights reserved.<BR>
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
@@ -156,6 +156,7 @@ VirtioNetInitTx (
   )
 {
   UINTN                 TxSharedReqSize;
+  UINTN                 TxSharedReqBytes;
   UINTN                 PktIdx;
   EFI_STATUS            Status;
   EFI_PHYSICAL_ADDRESS  DeviceAddress;
@@ -184,25 +185,28 @@ VirtioNetInitTx (
   }
 
   //
-  // Allocate TxSharedReq header and map with BusMasterCommonBuffer so that it
-  // can be accessed equally by both processor and device.
+  // Allocate a TxSharedReq header for each possibly pending packet, as the
+  // checksum offload fields differ between packets, and map them with
+  // BusMasterCommonBuffer so that they can be accessed equally by both
+  // processor and device.
   //
-  Status = Dev->VirtIo->AllocateSharedPages (
-                          Dev->VirtIo,
-                          EFI_SIZE_TO_PAGES (sizeof *Dev->TxSharedReq),
-                          &TxSharedReqBuffer
-                          );
+  TxSharedReqBytes = Dev->TxMaxPending * sizeof *Dev->TxSharedReq;
+  Status           = Dev->VirtIo->AllocateSharedPages (
+                                    Dev->VirtIo,
+                                    EFI_SIZE_TO_PAGES (TxSharedReqBytes),
+                                    &TxSharedReqBuffer
+                                    );
   if (EFI_ERROR (Status)) {
     goto UninitTxBufCollection;
   }
 
-  ZeroMem (TxSharedReqBuffer, sizeof *Dev->TxSharedReq);
+  ZeroMem (TxSharedReqBuffer, TxSharedReqBytes);
 
   Status = VirtioMapAllBytesInSharedBuffer (
              Dev->VirtIo,
              VirtioOperationBusMasterCommonBuffer,
              TxSharedReqBuffer,
-             sizeof *(Dev->TxSharedReq),
+             TxSharedReqBytes,
              &DeviceAddress,
              &Dev->TxSharedReqMap
              );
@@ -227,10 +231,11 @@ VirtioNetInitTx (
     Dev->TxFreeStack[PktIdx] = DescIdx;
 
     //
-    // For each possibly pending packet, lay out the descriptor for the common
+    // For each possibly pending packet, lay out the descriptor for its own
     // (unmodified by the host) virtio-net request header.
     //
-    Dev->TxRing.Desc[DescIdx].Addr  = DeviceAddress;
+    Dev->TxRing.Desc[DescIdx].Addr  = DeviceAddress +
+                                      PktIdx * sizeof *Dev->TxSharedReq;
     Dev->TxRing.Desc[DescIdx].Len   = (UINT32)TxSharedReqSize;
     Dev->TxRing.Desc[DescIdx].Flags = VRING_DESC_F_NEXT;
     Dev->TxRing.Desc[DescIdx].Next  = (UINT16)(DescIdx + 1);
@@ -240,18 +245,19 @@ VirtioNetInitTx (
     // but it always terminates the descriptor chain of the packet.
     //
     Dev->TxRing.Desc[DescIdx + 1].Flags = 0;
-  }
 
-  //
-  // virtio-0.9.5, Appendix C, Packet Transmission
-  //
-  Dev->TxSharedReq->V0_9_5.Flags   = 0;
-  Dev->TxSharedReq->V0_9_5.GsoType = VIRTIO_NET_HDR_GSO_NONE;
+    //
+    // virtio-0.9.5, Appendix C, Packet Transmission; the checksum fields are
+    // filled in by VirtioNetTxChecksumReq()
+    //
+    Dev->TxSharedReq[PktIdx].V0_9_5.Flags   = 0;
+    Dev->TxSharedReq[PktIdx].V0_9_5.GsoType = VIRTIO_NET_HDR_GSO_NONE;
 
-  //
-  // For VirtIo 1.0 only -- the field exists, but it is unused
-  //
-  Dev->TxSharedReq->NumBuffers = 0;
+    //
+    // For VirtIo 1.0 only -- the field exists, but it is unused
+    //
+    Dev->TxSharedReq[PktIdx].NumBuffers = 0;
+  }
 
   //
   // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device
@@ -270,7 +276,7 @@ VirtioNetInitTx (
 FreeTxSharedReqBuffer:
   Dev->VirtIo->FreeSharedPages (
                  Dev->VirtIo,
-                 EFI_SIZE_TO_PAGES (sizeof *(Dev->TxSharedReq)),
+                 EFI_SIZE_TO_PAGES (TxSharedReqBytes),
                  TxSharedReqBuffer
                  );
 
@@ -376,7 +382,20 @@ VirtioNetInitRx (
     goto FreeSharedBuffer;
   }
 
-  Dev->RxBuf = RxBuffer;
+  Dev->RxBuf       = RxBuffer;
+  Dev->RxBufSize   = RxBufSize;
+  Dev->RxLoaned    = 0;
+  //
+  // lend at most half of the buffers, so that the device can always receive
+  // into the other half
+  //
+  Dev->RxMaxLoaned = (UINT16)(RxAlwaysPending / 2);
+
+  //
+  // no packet received into the callers' buffers is known valid yet
+  //
+  ZeroMem (Dev->RxCsum, sizeof Dev->RxCsum);
+  Dev->RxCsumNext = 0;
 
   //
   // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device
@@ -557,8 +576,13 @@ VirtioNetInitialize (
     !!(Features & VIRTIO_NET_F_STATUS)
     );
 
+  //
+  // The checksum offload features are used if the device offers them, see
+  // VirtioNetTxChecksumReq() and VirtioNetRxChecksumRecord().
+  //
   Features &= VIRTIO_NET_F_MAC | VIRTIO_NET_F_STATUS | VIRTIO_F_VERSION_1 |
-              VIRTIO_F_IOMMU_PLATFORM;
+              VIRTIO_F_IOMMU_PLATFORM | VIRTIO_NET_F_CSUM |
+              VIRTIO_NET_F_GUEST_CSUM;
 
   //
   // In virtio-1.0, feature negotiation is expected to complete before queue
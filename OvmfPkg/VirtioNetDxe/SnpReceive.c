@@ -3,7 +3,7 @@
   Implementation of the SNP.Receive() function and its private helpers if any.
 
   Copyright (C) 2013, Red Hat, Inc.
-  Copyright (c) 2006 - 2013, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -73,7 +73,6 @@ VirtioNetReceive (
   UINT32      RxLen;
   UINTN       OrigBufferSize;
   UINT8       *RxPtr;
-  UINT16      AvailIdx;
   EFI_STATUS  NotifyStatus;
   UINTN       RxBufOffset;
 
@@ -142,6 +141,14 @@ VirtioNetReceive (
   RxPtr = Dev->RxBuf + RxBufOffset;
   CopyMem (Buffer, RxPtr, RxLen);
 
+  VirtioNetRxChecksumRecord (
+    Dev,
+    (VIRTIO_NET_REQ *)(Dev->RxBuf + (UINTN)(Dev->RxRing.Desc[DescIdx].Addr -
+                                            Dev->RxBufDeviceBase)),
+    Buffer,
+    RxLen
+    );
+
   if (DestAddr != NULL) {
     CopyMem (DestAddr, RxPtr, SIZE_OF_VNET (Mac));
   }
@@ -165,18 +172,7 @@ VirtioNetReceive (
 RecycleDesc:
   ++Dev->RxLastUsed;
 
-  //
-  // virtio-0.9.5, 2.4.1 Supplying Buffers to The Device
-  //
-  AvailIdx                                                   = *Dev->RxRing.Avail.Idx;
-  Dev->RxRing.Avail.Ring[AvailIdx++ % Dev->RxRing.QueueSize] =
-    (UINT16)DescIdx;
-
-  MemoryFence ();
-  *Dev->RxRing.Avail.Idx = AvailIdx;
-
-  MemoryFence ();
-  NotifyStatus = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
+  NotifyStatus = VirtioNetRxRecycleDesc (Dev, (UINT16)DescIdx);
   if (!EFI_ERROR (Status)) {
     // earlier error takes precedence
     Status = NotifyStatus;
@@ -3,12 +3,14 @@
   Helper functions used by at least two Simple Network Protocol methods.
 
   Copyright (C) 2013, Red Hat, Inc.
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
 
 #include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
 
 #include "VirtioNet.h"
 
@@ -22,6 +24,46 @@ typedef struct {
   VOID                    *BufMap;
 } TX_BUF_MAP_INFO;
 
+/**
+  Give a receive descriptor chain back to the device.
+
+  Besides VirtioNetReceive() and VirtioNetRxLoanReceive(), this function is
+  called by VirtioNetRxLoanReturn() at TPL_NOTIFY, so it updates the
+  available ring at that level.
+
+  @param[in,out] Dev      The VNET_DEV driver instance, in the
+                          EfiSimpleNetworkInitialized state.
+  @param[in]     DescIdx  The head descriptor of the chain.
+
+  @return  Status codes from VIRTIO_DEVICE_PROTOCOL.SetQueueNotify().
+*/
+EFI_STATUS
+EFIAPI
+VirtioNetRxRecycleDesc (
+  IN OUT VNET_DEV  *Dev,
+  IN     UINT16    DescIdx
+  )
+{
+  EFI_TPL  OldTpl;
+  UINT16   AvailIdx;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  //
+  // virtio-0.9.5, 2.4.1 Supplying Buffers to The Device
+  //
+  AvailIdx                                                   = *Dev->RxRing.Avail.Idx;
+  Dev->RxRing.Avail.Ring[AvailIdx++ % Dev->RxRing.QueueSize] = DescIdx;
+
+  MemoryFence ();
+  *Dev->RxRing.Avail.Idx = AvailIdx;
+
+  gBS->RestoreTPL (OldTpl);
+
+  MemoryFence ();
+  return Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
+}
+
 /**
   Release RX and TX resources on the boundary of the
   EfiSimpleNetworkInitialized state.
@@ -42,12 +84,45 @@ VirtioNetShutdownRx (
   IN OUT VNET_DEV  *Dev
   )
 {
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RxBufMap);
-  Dev->VirtIo->FreeSharedPages (
-                 Dev->VirtIo,
-                 Dev->RxBufNrPages,
-                 Dev->RxBuf
-                 );
+  EFI_TPL  OldTpl;
+
+  //
+  // VirtioNetRxLoanReturn() runs at TPL_NOTIFY
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  if (Dev->RxLoaned == 0) {
+    Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RxBufMap);
+    Dev->VirtIo->FreeSharedPages (
+                   Dev->VirtIo,
+                   Dev->RxBufNrPages,
+                   Dev->RxBuf
+                   );
+  } else {
+    //
+    // The device no longer writes RxBuf, but frames in it are still on loan.
+    // Keep it until they are returned. An older orphan, which the consumer
+    // failed to return entirely, is leaked rather than freed under it.
+    //
+    if (Dev->RxOrphanBuf != NULL) {
+      DEBUG ((
+        DEBUG_WARN,
+        "%a: leaking RX buffer with %d frames on loan\n",
+        __func__,
+        Dev->RxOrphanLoaned
+        ));
+    }
+
+    Dev->RxOrphanBuf     = Dev->RxBuf;
+    Dev->RxOrphanNrPages = Dev->RxBufNrPages;
+    Dev->RxOrphanMap     = Dev->RxBufMap;
+    Dev->RxOrphanLoaned  = Dev->RxLoaned;
+  }
+
+  Dev->RxBuf    = NULL;
+  Dev->RxLoaned = 0;
+
+  gBS->RestoreTPL (OldTpl);
 }
 
 VOID
@@ -63,7 +138,7 @@ VirtioNetShutdownTx (
   Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->TxSharedReqMap);
   Dev->VirtIo->FreeSharedPages (
                  Dev->VirtIo,
-                 EFI_SIZE_TO_PAGES (sizeof *(Dev->TxSharedReq)),
+                 EFI_SIZE_TO_PAGES (Dev->TxMaxPending * sizeof *(Dev->TxSharedReq)),
                  Dev->TxSharedReq
                  );
 
@@ -3,7 +3,7 @@
   Implementation of the SNP.Transmit() function and its private helpers if any.
 
   Copyright (C) 2013, Red Hat, Inc.
-  Copyright (c) 2006 - 2013, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -163,6 +163,17 @@ VirtioNetTransmit (
   Dev->TxRing.Desc[DescIdx + 1].Addr = DeviceAddress;
   Dev->TxRing.Desc[DescIdx + 1].Len  = (UINT32)BufferSize;
 
+  //
+  // each pending packet has its own virtio-net request header, for the
+  // checksum offload fields
+  //
+  VirtioNetTxChecksumReq (
+    Dev,
+    Buffer,
+    BufferSize,
+    &Dev->TxSharedReq[DescIdx / 2]
+    );
+
   //
   // the available index is never written by the host, we can read it back
   // without a barrier
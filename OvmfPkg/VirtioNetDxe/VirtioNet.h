@@ -5,6 +5,7 @@
 
   Copyright (C) 2013, Red Hat, Inc.
   Copyright (c) 2017, AMD Inc, All rights reserved.<BR>
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
@@ -14,11 +15,14 @@
 
 #include <IndustryStandard/VirtioNet.h>
 #include <Library/DebugLib.h>
+#include <Library/NetLib.h>
 #include <Library/VirtioLib.h>
 #include <Protocol/ComponentName.h>
 #include <Protocol/ComponentName2.h>
 #include <Protocol/DevicePath.h>
 #include <Protocol/DriverBinding.h>
+#include <Protocol/NetworkOffload.h>
+#include <Protocol/NetworkRxBuffer.h>
 #include <Protocol/SimpleNetwork.h>
 #include <Library/OrderedCollectionLib.h>
 
@@ -29,6 +33,23 @@
 //
 #define VNET_MAX_PENDING  64
 
+//
+// Ethertypes of the frames whose checksum is offloaded
+//
+#define VNET_ETHER_TYPE_IP4  0x0800
+#define VNET_ETHER_TYPE_IP6  0x86DD
+
+//
+// A received TCP or UDP packet whose checksum the device validated, see
+// VirtioNetRxChecksumValid()
+//
+typedef struct {
+  CONST UINT8    *Header;    // transport header in the caller's buffer
+  UINTN          Length;     // transport header and data
+  UINT16         CsumOffset; // offset of the checksum field in the header
+  UINT16         Checksum;   // checksum field when the packet was received
+} VNET_RX_CSUM;
+
 //
 // State diagram:
 //
@@ -69,33 +90,53 @@ typedef struct {
   //
   //                          field              init function
   //                          ------------------ ------------------------------
-  UINT32                         Signature;      // VirtioNetDriverBindingStart
-  VIRTIO_DEVICE_PROTOCOL         *VirtIo;        // VirtioNetDriverBindingStart
-  EFI_SIMPLE_NETWORK_PROTOCOL    Snp;            // VirtioNetSnpPopulate
-  EFI_SIMPLE_NETWORK_MODE        Snm;            // VirtioNetSnpPopulate
-  EFI_EVENT                      ExitBoot;       // VirtioNetSnpPopulate
-  EFI_DEVICE_PATH_PROTOCOL       *MacDevicePath; // VirtioNetDriverBindingStart
-  EFI_HANDLE                     MacHandle;      // VirtioNetDriverBindingStart
-
-  VRING                          RxRing;          // VirtioNetInitRing
-  VOID                           *RxRingMap;      // VirtioRingMap and
-                                                  // VirtioNetInitRing
-  UINT8                          *RxBuf;          // VirtioNetInitRx
-  UINT16                         RxLastUsed;      // VirtioNetInitRx
-  UINTN                          RxBufNrPages;    // VirtioNetInitRx
-  EFI_PHYSICAL_ADDRESS           RxBufDeviceBase; // VirtioNetInitRx
-  VOID                           *RxBufMap;       // VirtioNetInitRx
-
-  VRING                          TxRing;           // VirtioNetInitRing
-  VOID                           *TxRingMap;       // VirtioRingMap and
-                                                   // VirtioNetInitRing
-  UINT16                         TxMaxPending;     // VirtioNetInitTx
-  UINT16                         TxCurPending;     // VirtioNetInitTx
-  UINT16                         *TxFreeStack;     // VirtioNetInitTx
-  VIRTIO_1_0_NET_REQ             *TxSharedReq;     // VirtioNetInitTx
-  VOID                           *TxSharedReqMap;  // VirtioNetInitTx
-  UINT16                         TxLastUsed;       // VirtioNetInitTx
-  ORDERED_COLLECTION             *TxBufCollection; // VirtioNetInitTx
+  UINT32                            Signature;      // VirtioNetDriverBindingStart
+  VIRTIO_DEVICE_PROTOCOL            *VirtIo;        // VirtioNetDriverBindingStart
+  EFI_SIMPLE_NETWORK_PROTOCOL       Snp;            // VirtioNetSnpPopulate
+  EFI_SIMPLE_NETWORK_MODE           Snm;            // VirtioNetSnpPopulate
+  EFI_EVENT                         ExitBoot;       // VirtioNetSnpPopulate
+  EFI_DEVICE_PATH_PROTOCOL          *MacDevicePath; // VirtioNetDriverBindingStart
+  EFI_HANDLE                        MacHandle;      // VirtioNetDriverBindingStart
+  EDKII_NETWORK_OFFLOAD_PROTOCOL    Offload;        // VirtioNetSnpPopulate
+  UINT32                            TxCsumKinds;    // VirtioNetSetTxChecksum
+  EDKII_NETWORK_RX_BUFFER_PROTOCOL  RxLoan;         // VirtioNetSnpPopulate
+
+  VRING                             RxRing;          // VirtioNetInitRing
+  VOID                              *RxRingMap;      // VirtioRingMap and
+                                                     // VirtioNetInitRing
+  UINT8                             *RxBuf;          // VirtioNetInitRx
+  UINT16                            RxLastUsed;      // VirtioNetInitRx
+  UINTN                             RxBufNrPages;    // VirtioNetInitRx
+  EFI_PHYSICAL_ADDRESS              RxBufDeviceBase; // VirtioNetInitRx
+  VOID                              *RxBufMap;       // VirtioNetInitRx
+
+  UINTN                             RxBufSize;       // VirtioNetInitRx, per packet
+  UINT16                            RxLoaned;        // VirtioNetInitRx, frames
+  UINT16                            RxMaxLoaned;     // VirtioNetInitRx  on loan
+
+  VNET_RX_CSUM                      RxCsum[VNET_MAX_PENDING]; // VirtioNetInitRx
+  UINTN                             RxCsumNext;               // VirtioNetInitRx
+
+  //
+  // RxBuf of the previous initialization, kept by VirtioNetShutdownRx until
+  // RxOrphanLoaned frames on loan in it are returned
+  //
+  UINT8                             *RxOrphanBuf;
+  UINTN                             RxOrphanNrPages;
+  VOID                              *RxOrphanMap;
+  UINT16                            RxOrphanLoaned;
+
+  VRING                             TxRing;           // VirtioNetInitRing
+  VOID                              *TxRingMap;       // VirtioRingMap and
+                                                      // VirtioNetInitRing
+  UINT16                            TxMaxPending;     // VirtioNetInitTx
+  UINT16                            TxCurPending;     // VirtioNetInitTx
+  UINT16                            *TxFreeStack;     // VirtioNetInitTx
+  VIRTIO_1_0_NET_REQ                *TxSharedReq;     // VirtioNetInitTx, one
+                                                      // per pending packet
+  VOID                              *TxSharedReqMap;  // VirtioNetInitTx
+  UINT16                            TxLastUsed;       // VirtioNetInitTx
+  ORDERED_COLLECTION                *TxBufCollection; // VirtioNetInitTx
 } VNET_DEV;
 
 //
@@ -111,6 +152,12 @@ typedef struct {
 #define VIRTIO_NET_FROM_SNP(SnpPointer) \
         CR (SnpPointer, VNET_DEV, Snp, VNET_SIG)
 
+#define VIRTIO_NET_FROM_OFFLOAD(OffloadPointer) \
+        CR (OffloadPointer, VNET_DEV, Offload, VNET_SIG)
+
+#define VIRTIO_NET_FROM_RX_LOAN(RxLoanPointer) \
+        CR (RxLoanPointer, VNET_DEV, RxLoan, VNET_SIG)
+
 #define VIRTIO_CFG_WRITE(Dev, Field, Value)  ((Dev)->VirtIo->WriteDevice (  \
                                                 (Dev)->VirtIo,              \
                                                 OFFSET_OF_VNET (Field),     \
@@ -252,9 +299,74 @@ VirtioNetReceive (
   OUT UINT16                      *Protocol   OPTIONAL
   );
 
+//
+// member functions implementing the EDKII Network Offload Protocol
+//
+EFI_STATUS
+EFIAPI
+VirtioNetSetTxChecksum (
+  IN EDKII_NETWORK_OFFLOAD_PROTOCOL  *This,
+  IN UINT32                          Kinds,
+  IN BOOLEAN                         Enable
+  );
+
+BOOLEAN
+EFIAPI
+VirtioNetRxChecksumValid (
+  IN EDKII_NETWORK_OFFLOAD_PROTOCOL  *This,
+  IN CONST VOID                      *Header,
+  IN UINTN                           Length
+  );
+
+//
+// member functions implementing the EDKII Network Rx Buffer Protocol
+//
+EFI_STATUS
+EFIAPI
+VirtioNetRxLoanReceive (
+  IN  EDKII_NETWORK_RX_BUFFER_PROTOCOL  *This,
+  OUT VOID                              **Frame,
+  OUT UINTN                             *FrameSize
+  );
+
+VOID
+EFIAPI
+VirtioNetRxLoanReturn (
+  IN EDKII_NETWORK_RX_BUFFER_PROTOCOL  *This,
+  IN VOID                              *Frame
+  );
+
+//
+// checksum offload helpers of the Transmit and Receive SNP member functions
+//
+VOID
+EFIAPI
+VirtioNetTxChecksumReq (
+  IN     VNET_DEV            *Dev,
+  IN OUT UINT8               *Frame,
+  IN     UINTN               FrameSize,
+  OUT    VIRTIO_1_0_NET_REQ  *Req
+  );
+
+VOID
+EFIAPI
+VirtioNetRxChecksumRecord (
+  IN OUT VNET_DEV              *Dev,
+  IN     CONST VIRTIO_NET_REQ  *Req,
+  IN OUT UINT8                 *Frame,
+  IN     UINTN                 FrameSize
+  );
+
 //
 // utility functions shared by various SNP member functions
 //
+EFI_STATUS
+EFIAPI
+VirtioNetRxRecycleDesc (
+  IN OUT VNET_DEV  *Dev,
+  IN     UINT16    DescIdx
+  );
+
 VOID
 EFIAPI
 VirtioNetShutdownRx (
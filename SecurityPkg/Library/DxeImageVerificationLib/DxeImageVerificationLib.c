@@ -12,7 +12,7 @@
   DxeImageVerificationHandler(), HashPeImageByType(), HashPeImage() function will accept
   untrusted PE/COFF image and validate its data structure within this image buffer before use.
 
-Copyright (c) 2009 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2009 - 2026, Intel Corporation. All rights reserved.<BR>
 (C) Copyright 2016 Hewlett Packard Enterprise Development LP<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -36,6 +36,20 @@ UINT8  *mImageBase = NULL;
 UINT8  mImageDigest[MAX_DIGEST_SIZE];
 UINTN  mImageDigestSize;
 
+//
+// Digests of the current PE/COFF image already calculated, by hash algorithm.
+// An image with several signatures of the same algorithm is hashed once.
+//
+UINT8    mImageDigestCache[HASHALG_MAX][MAX_DIGEST_SIZE];
+BOOLEAN  mImageDigestCached[HASHALG_MAX];
+
+//
+// Sorted indexes of the signatures of db and dbx, built again when the
+// variable changes.
+//
+SIGNATURE_INDEX  mDbIndex;
+SIGNATURE_INDEX  mDbxIndex;
+
 //
 // Notify string for authorization UI.
 //
@@ -347,7 +361,12 @@ HashPeImage (
   }
 
   mHashTypeStr = mHash[HashAlg].Name;
-  CtxSize      = mHash[HashAlg].GetContextSize ();
+  if (mImageDigestCached[HashAlg]) {
+    CopyMem (mImageDigest, mImageDigestCache[HashAlg], mImageDigestSize);
+    return TRUE;
+  }
+
+  CtxSize = mHash[HashAlg].GetContextSize ();
 
   HashCtx = AllocatePool (CtxSize);
   if (HashCtx == NULL) {
@@ -592,6 +611,10 @@ HashPeImage (
   }
 
   Status = mHash[HashAlg].HashFinal (HashCtx, mImageDigest);
+  if (Status) {
+    CopyMem (mImageDigestCache[HashAlg], mImageDigest, mImageDigestSize);
+    mImageDigestCached[HashAlg] = TRUE;
+  }
 
 Done:
   if (HashCtx != NULL) {
@@ -987,13 +1010,15 @@ IsSignatureFoundInDatabase (
   OUT BOOLEAN   *IsFound
   )
 {
-  EFI_STATUS          Status;
-  EFI_SIGNATURE_LIST  *CertList;
-  EFI_SIGNATURE_DATA  *Cert;
-  UINTN               DataSize;
-  UINT8               *Data;
-  UINTN               Index;
-  UINTN               CertCount;
+  EFI_STATUS             Status;
+  EFI_SIGNATURE_LIST     *CertList;
+  EFI_SIGNATURE_DATA     *Cert;
+  UINTN                  DataSize;
+  UINT8                  *Data;
+  UINTN                  Index;
+  UINTN                  CertCount;
+  SIGNATURE_INDEX        *SignatureIndex;
+  SIGNATURE_INDEX_ENTRY  Entry;
 
   //
   // Read signature database variable.
@@ -1023,6 +1048,31 @@ IsSignatureFoundInDatabase (
     goto Done;
   }
 
+  //
+  // Look the signature up in the sorted index of db or dbx. The index is
+  // built again if the variable changed since it was built.
+  //
+  SignatureIndex = NULL;
+  if (StrCmp (VariableName, EFI_IMAGE_SECURITY_DATABASE) == 0) {
+    SignatureIndex = &mDbIndex;
+  } else if (StrCmp (VariableName, EFI_IMAGE_SECURITY_DATABASE1) == 0) {
+    SignatureIndex = &mDbxIndex;
+  }
+
+  if ((SignatureIndex != NULL) && !EFI_ERROR (SignatureIndexUpdate (SignatureIndex, Data, DataSize))) {
+    if (SignatureIndexFind (SignatureIndex, CertType, Signature, SignatureSize, &Entry)) {
+      *IsFound = TRUE;
+      //
+      // Entries in UEFI_IMAGE_SECURITY_DATABASE that are used to validate image should be measured
+      //
+      if (SignatureIndex == &mDbIndex) {
+        SecureBootHook (VariableName, &gEfiImageSecurityDatabaseGuid, Entry.List->SignatureSize, (VOID *)Entry.Signature);
+      }
+    }
+
+    goto Done;
+  }
+
   //
   // Enumerate all signature data in SigDB to check if signature exists for executable.
   //
@@ -1774,6 +1824,7 @@ DxeImageVerificationHandler (
 
   mImageBase = (UINT8 *)FileBuffer;
   mImageSize = FileSize;
+  ZeroMem (mImageDigestCached, sizeof (mImageDigestCached));
 
   ZeroMem (&ImageContext, sizeof (ImageContext));
   ImageContext.Handle    = (VOID *)FileBuffer;
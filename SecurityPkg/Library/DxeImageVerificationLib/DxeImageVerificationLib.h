@@ -2,7 +2,7 @@
   The internal header file includes the common header files, defines
   internal structure and functions used by ImageVerificationLib.
 
-Copyright (c) 2009 - 2014, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2009 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -32,6 +32,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/AuthenticatedVariableFormat.h>
 #include <IndustryStandard/PeImage.h>
 
+#include "SignatureIndex.h"
+
 #define EFI_CERT_TYPE_RSA2048_SHA256_SIZE  256
 #define EFI_CERT_TYPE_RSA2048_SIZE         256
 #define MAX_NOTIFY_STRING_LEN              64
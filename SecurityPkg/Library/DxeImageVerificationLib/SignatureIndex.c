@@ -0,0 +1,361 @@
+/** @file
+  Sorted index of the signatures of an image security database variable.
+
+  Caution: This file requires additional review when modified.
+  The index decides whether an image digest is in db or dbx, so a look up
+  must give the same verdict as a walk of the signature lists.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "SignatureIndex.h"
+
+///
+/// Size of the signature data of the signatures of a list that can match a
+/// look up. Lists of smaller signatures are not indexed.
+///
+#define SIGNATURE_DATA_SIZE(List)  ((List)->SignatureSize - (sizeof (EFI_SIGNATURE_DATA) - 1))
+
+/**
+  Compare a signature key with an indexed signature.
+
+  @param[in]  CertType           The signature type of the key.
+  @param[in]  ListSignatureSize  The SignatureSize of the list of the key.
+  @param[in]  Signature          The signature data of the key.
+  @param[in]  Entry              The indexed signature.
+
+  @retval <0                     The key sorts before Entry.
+  @retval 0                      The key matches Entry.
+  @retval >0                     The key sorts after Entry.
+
+**/
+STATIC
+INTN
+CompareSignatureKey (
+  IN CONST EFI_GUID               *CertType,
+  IN UINT32                       ListSignatureSize,
+  IN CONST UINT8                  *Signature,
+  IN CONST SIGNATURE_INDEX_ENTRY  *Entry
+  )
+{
+  INTN  Result;
+
+  Result = CompareMem (CertType, &Entry->List->SignatureType, sizeof (EFI_GUID));
+  if (Result != 0) {
+    return Result;
+  }
+
+  if (ListSignatureSize != Entry->List->SignatureSize) {
+    return (ListSignatureSize < Entry->List->SignatureSize) ? -1 : 1;
+  }
+
+  return CompareMem (Signature, Entry->Signature->SignatureData, SIGNATURE_DATA_SIZE (Entry->List));
+}
+
+/**
+  Sort order of the index: by signature key, then by position in the
+  variable.
+
+  @param[in]  Buffer1            The first SIGNATURE_INDEX_ENTRY.
+  @param[in]  Buffer2            The second SIGNATURE_INDEX_ENTRY.
+
+  @return The order of Buffer1 relative to Buffer2.
+
+**/
+STATIC
+INTN
+EFIAPI
+CompareSignatureEntry (
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  CONST SIGNATURE_INDEX_ENTRY  *Entry1;
+  CONST SIGNATURE_INDEX_ENTRY  *Entry2;
+  INTN                         Result;
+
+  Entry1 = (CONST SIGNATURE_INDEX_ENTRY *)Buffer1;
+  Entry2 = (CONST SIGNATURE_INDEX_ENTRY *)Buffer2;
+
+  Result = CompareSignatureKey (
+             &Entry1->List->SignatureType,
+             Entry1->List->SignatureSize,
+             Entry1->Signature->SignatureData,
+             Entry2
+             );
+  if (Result != 0) {
+    return Result;
+  }
+
+  if ((UINTN)Entry1->Signature == (UINTN)Entry2->Signature) {
+    return 0;
+  }
+
+  return ((UINTN)Entry1->Signature < (UINTN)Entry2->Signature) ? -1 : 1;
+}
+
+/**
+  Check whether two buffers hold the same data.
+
+  CompareMem() compares one byte at a time to find the first difference. The
+  index only needs to know whether the variable changed, which is checked 64
+  bits at a time when both buffers are aligned.
+
+  @param[in]  Buffer1            The first buffer.
+  @param[in]  Buffer2            The second buffer.
+  @param[in]  Length             The size, in bytes, of the buffers.
+
+  @retval TRUE                   The buffers hold the same data.
+  @retval FALSE                  The buffers differ.
+
+**/
+STATIC
+BOOLEAN
+IsSameData (
+  IN CONST UINT8  *Buffer1,
+  IN CONST UINT8  *Buffer2,
+  IN UINTN        Length
+  )
+{
+  CONST UINT64  *Words1;
+  CONST UINT64  *Words2;
+  UINTN         Count;
+  UINTN         Index;
+
+  if ((((UINTN)Buffer1 | (UINTN)Buffer2) & (sizeof (UINT64) - 1)) != 0) {
+    return (BOOLEAN)(CompareMem (Buffer1, Buffer2, Length) == 0);
+  }
+
+  Words1 = (CONST UINT64 *)Buffer1;
+  Words2 = (CONST UINT64 *)Buffer2;
+  Count  = Length / sizeof (UINT64);
+  for (Index = 0; Index < Count; Index++) {
+    if (Words1[Index] != Words2[Index]) {
+      return FALSE;
+    }
+  }
+
+  Count *= sizeof (UINT64);
+  return (BOOLEAN)(CompareMem (Buffer1 + Count, Buffer2 + Count, Length - Count) == 0);
+}
+
+/**
+  Walk the signature lists of a variable the way the image verification walks
+  them, and count or record the signatures that can match a look up.
+
+  @param[in]  Data               The data of the variable.
+  @param[in]  DataSize           The size, in bytes, of Data.
+  @param[out] Entries            The array to record the signatures in, or NULL
+                                 to only count them.
+  @param[out] Count              The number of signatures.
+
+  @retval EFI_SUCCESS            The signatures are counted or recorded.
+  @retval EFI_VOLUME_CORRUPTED   Data is not a well formed list of signature
+                                 lists.
+
+**/
+STATIC
+EFI_STATUS
+WalkSignatureLists (
+  IN  CONST UINT8            *Data,
+  IN  UINTN                  DataSize,
+  OUT SIGNATURE_INDEX_ENTRY  *Entries OPTIONAL,
+  OUT UINTN                  *Count
+  )
+{
+  CONST EFI_SIGNATURE_LIST  *List;
+  CONST UINT8               *Signature;
+  UINTN                     SignatureCount;
+  UINTN                     Index;
+
+  *Count = 0;
+  List   = (CONST EFI_SIGNATURE_LIST *)Data;
+  while (DataSize > 0) {
+    if (DataSize < sizeof (EFI_SIGNATURE_LIST)) {
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    //
+    // The walk of the image verification stops at a list that overflows the
+    // variable.
+    //
+    if (List->SignatureListSize > DataSize) {
+      break;
+    }
+
+    if ((List->SignatureListSize < sizeof (EFI_SIGNATURE_LIST)) ||
+        (List->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) < List->SignatureHeaderSize) ||
+        (List->SignatureSize == 0))
+    {
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    if (List->SignatureSize > sizeof (EFI_SIGNATURE_DATA) - 1) {
+      SignatureCount = (List->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - List->SignatureHeaderSize) / List->SignatureSize;
+      Signature      = (CONST UINT8 *)List + sizeof (EFI_SIGNATURE_LIST) + List->SignatureHeaderSize;
+      if (Entries != NULL) {
+        for (Index = 0; Index < SignatureCount; Index++) {
+          Entries[*Count + Index].List      = List;
+          Entries[*Count + Index].Signature = (CONST EFI_SIGNATURE_DATA *)Signature;
+          Signature                        += List->SignatureSize;
+        }
+      }
+
+      *Count += SignatureCount;
+    }
+
+    DataSize -= List->SignatureListSize;
+    List      = (CONST EFI_SIGNATURE_LIST *)((CONST UINT8 *)List + List->SignatureListSize);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Make an index match the data of its variable. The index is only built
+  again if Data differs from the data it was last built from.
+
+  @param[in, out] Index          The index.
+  @param[in]      Data           The data of the variable.
+  @param[in]      DataSize       The size, in bytes, of Data.
+
+  @retval EFI_SUCCESS            The index matches Data.
+  @retval EFI_VOLUME_CORRUPTED   Data is not a well formed list of signature
+                                 lists. The index is emptied.
+  @retval EFI_OUT_OF_RESOURCES   There is not enough memory to build the index.
+                                 The index is emptied.
+
+**/
+EFI_STATUS
+SignatureIndexUpdate (
+  IN OUT SIGNATURE_INDEX  *Index,
+  IN     CONST UINT8      *Data,
+  IN     UINTN            DataSize
+  )
+{
+  EFI_STATUS             Status;
+  UINTN                  Count;
+  SIGNATURE_INDEX_ENTRY  Swap;
+
+  if (Index->Valid && (Index->DataSize == DataSize) &&
+      IsSameData (Index->Data, Data, DataSize))
+  {
+    return EFI_SUCCESS;
+  }
+
+  SignatureIndexFree (Index);
+
+  Status = WalkSignatureLists (Data, DataSize, NULL, &Count);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Index->Data = AllocateCopyPool (DataSize, Data);
+  if ((Index->Data == NULL) && (DataSize != 0)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Index->DataSize = DataSize;
+  if (Count != 0) {
+    Index->Entries = AllocatePool (Count * sizeof (SIGNATURE_INDEX_ENTRY));
+    if (Index->Entries == NULL) {
+      SignatureIndexFree (Index);
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    WalkSignatureLists (Index->Data, DataSize, Index->Entries, &Index->Count);
+    ASSERT (Index->Count == Count);
+    QuickSort (Index->Entries, Count, sizeof (SIGNATURE_INDEX_ENTRY), CompareSignatureEntry, &Swap);
+  }
+
+  Index->Valid = TRUE;
+  return EFI_SUCCESS;
+}
+
+/**
+  Find a signature in an index.
+
+  A signature matches if its list has the signature type CertType and holds
+  signatures of exactly SignatureSize bytes of data, and the data of the
+  signature is Signature.
+
+  @param[in]  Index              The index. It must be valid.
+  @param[in]  CertType           The signature type.
+  @param[in]  Signature          The signature data to find.
+  @param[in]  SignatureSize      The size, in bytes, of Signature.
+  @param[out] Entry              The first matching signature in the variable.
+
+  @retval TRUE                   The signature is found.
+  @retval FALSE                  The signature is not found.
+
+**/
+BOOLEAN
+SignatureIndexFind (
+  IN  CONST SIGNATURE_INDEX  *Index,
+  IN  CONST EFI_GUID         *CertType,
+  IN  CONST UINT8            *Signature,
+  IN  UINTN                  SignatureSize,
+  OUT SIGNATURE_INDEX_ENTRY  *Entry
+  )
+{
+  UINTN  ListSignatureSize;
+  UINTN  Low;
+  UINTN  High;
+  UINTN  Middle;
+
+  ASSERT (Index->Valid);
+
+  if ((SignatureSize == 0) || (SignatureSize > MAX_UINT32 - (sizeof (EFI_SIGNATURE_DATA) - 1))) {
+    return FALSE;
+  }
+
+  ListSignatureSize = sizeof (EFI_SIGNATURE_DATA) - 1 + SignatureSize;
+
+  //
+  // Find the first entry that does not sort before the key. Entries of equal
+  // keys are in variable order.
+  //
+  Low  = 0;
+  High = Index->Count;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    if (CompareSignatureKey (CertType, (UINT32)ListSignatureSize, Signature, &Index->Entries[Middle]) > 0) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  if ((Low == Index->Count) ||
+      (CompareSignatureKey (CertType, (UINT32)ListSignatureSize, Signature, &Index->Entries[Low]) != 0))
+  {
+    return FALSE;
+  }
+
+  CopyMem (Entry, &Index->Entries[Low], sizeof (SIGNATURE_INDEX_ENTRY));
+  return TRUE;
+}
+
+/**
+  Free the buffers of an index, and leave it empty.
+
+  @param[in, out] Index          The index.
+
+**/
+VOID
+SignatureIndexFree (
+  IN OUT SIGNATURE_INDEX  *Index
+  )
+{
+  if (Index->Data != NULL) {
+    FreePool (Index->Data);
+  }
+
+  if (Index->Entries != NULL) {
+    FreePool (Index->Entries);
+  }
+
+  ZeroMem (Index, sizeof (SIGNATURE_INDEX));
+}
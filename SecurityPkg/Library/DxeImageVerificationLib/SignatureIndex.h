@@ -0,0 +1,116 @@
+/** @file
+  Sorted index of the signatures of an image security database variable,
+  used to look up an image digest in db or dbx without walking every
+  signature list.
+
+  The index keeps a copy of the variable data it was built from. It is built
+  the first time the variable is looked up, and built again only when the
+  variable data read for a look up differs from that copy, so a change of the
+  variable is always seen. Signatures are sorted by signature type, signature
+  size, signature data and position in the variable, so a look up returns the
+  same signature, the first one in the variable, as a walk of the signature
+  lists.
+
+  An index is not built from malformed variable data: the caller walks the
+  signature lists instead.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __SIGNATURE_INDEX_H__
+#define __SIGNATURE_INDEX_H__
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Guid/ImageAuthentication.h>
+
+typedef struct {
+  CONST EFI_SIGNATURE_LIST    *List;
+  CONST EFI_SIGNATURE_DATA    *Signature;
+} SIGNATURE_INDEX_ENTRY;
+
+///
+/// A zero initialized SIGNATURE_INDEX is an empty index.
+///
+typedef struct {
+  ///
+  /// Copy of the variable data the index is built from.
+  ///
+  UINT8                    *Data;
+  UINTN                    DataSize;
+  ///
+  /// Signatures of the variable, sorted.
+  ///
+  SIGNATURE_INDEX_ENTRY    *Entries;
+  UINTN                    Count;
+  ///
+  /// TRUE if Entries indexes Data.
+  ///
+  BOOLEAN                  Valid;
+} SIGNATURE_INDEX;
+
+/**
+  Make an index match the data of its variable. The index is only built
+  again if Data differs from the data it was last built from.
+
+  @param[in, out] Index          The index.
+  @param[in]      Data           The data of the variable.
+  @param[in]      DataSize       The size, in bytes, of Data.
+
+  @retval EFI_SUCCESS            The index matches Data.
+  @retval EFI_VOLUME_CORRUPTED   Data is not a well formed list of signature
+                                 lists. The index is emptied.
+  @retval EFI_OUT_OF_RESOURCES   There is not enough memory to build the index.
+                                 The index is emptied.
+
+**/
+EFI_STATUS
+SignatureIndexUpdate (
+  IN OUT SIGNATURE_INDEX  *Index,
+  IN     CONST UINT8      *Data,
+  IN     UINTN            DataSize
+  );
+
+/**
+  Find a signature in an index.
+
+  A signature matches if its list has the signature type CertType and holds
+  signatures of exactly SignatureSize bytes of data, and the data of the
+  signature is Signature.
+
+  @param[in]  Index              The index. It must be valid.
+  @param[in]  CertType           The signature type.
+  @param[in]  Signature          The signature data to find.
+  @param[in]  SignatureSize      The size, in bytes, of Signature.
+  @param[out] Entry              The first matching signature in the variable.
+
+  @retval TRUE                   The signature is found.
+  @retval FALSE                  The signature is not found.
+
+**/
+BOOLEAN
+SignatureIndexFind (
+  IN  CONST SIGNATURE_INDEX  *Index,
+  IN  CONST EFI_GUID         *CertType,
+  IN  CONST UINT8            *Signature,
+  IN  UINTN                  SignatureSize,
+  OUT SIGNATURE_INDEX_ENTRY  *Entry
+  );
+
+/**
+  Free the buffers of an index, and leave it empty.
+
+  @param[in, out] Index          The index.
+
+**/
+VOID
+SignatureIndexFree (
+  IN OUT SIGNATURE_INDEX  *Index
+  );
+
+#endif
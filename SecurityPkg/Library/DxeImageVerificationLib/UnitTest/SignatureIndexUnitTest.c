@@ -0,0 +1,642 @@
+/** @file
+  Unit tests and microbenchmark of the DxeImageVerificationLib signature
+  index.
+
+  The tests build random image security databases and check that a look up
+  in the index gives the same verdict, and finds the same signature, as the
+  walk of the signature lists the image verification did before the index,
+  that a change of the variable is seen, and that malformed variables are
+  left to the walk. The benchmark compares the cost of looking up an image
+  digest in a large dbx with the index and with the walk.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/UnitTestBenchmarkLib.h>
+
+#include "../SignatureIndex.h"
+
+#define UNIT_TEST_APP_NAME     "DxeImageVerificationLib Signature Index Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_RANDOM_ROUNDS    200
+#define TEST_MAX_LISTS        24
+#define TEST_MAX_SIGNATURES   200
+#define TEST_BENCH_DBX_SIZE   4000
+#define TEST_BENCH_LOOKUPS    2000
+
+STATIC SIGNATURE_INDEX  mIndex;
+
+//
+// Signature types of the random databases, with the size of their signature
+// data. X.509 certificates have a random size.
+//
+STATIC CONST struct {
+  EFI_GUID    Type;
+  UINTN       DataSize;
+} mTestTypes[] = {
+  { { 0xc1c41626, 0x504c, 0x4092, { 0xac, 0xa9, 0x41, 0xf9, 0x36, 0x93, 0x43, 0x28 } }, 32 },
+  { { 0xff3e5307, 0x9fd0, 0x48c9, { 0x85, 0xf1, 0x8a, 0xd5, 0x6c, 0x70, 0x1e, 0x01 } }, 48 },
+  { { 0x3bd2a492, 0x96c0, 0x4079, { 0xb4, 0x20, 0xfc, 0xf9, 0x8e, 0xf1, 0x03, 0xed } }, 20 },
+  { { 0xa5c059a1, 0x94e4, 0x4aa7, { 0x87, 0xb5, 0xab, 0x15, 0x5c, 0x2b, 0xf0, 0x72 } }, 0  }
+};
+
+/**
+  Fill a buffer with pseudo random bytes.
+
+  @param[in, out]  Seed    The generator state.
+  @param[out]      Buffer  The buffer.
+  @param[in]       Size    The size, in bytes, of Buffer.
+**/
+STATIC
+VOID
+RandomBytes (
+  IN OUT UINT32  *Seed,
+  OUT    UINT8   *Buffer,
+  IN     UINTN   Size
+  )
+{
+  while (Size-- > 0) {
+    *Buffer++ = (UINT8)UnitTestRandom (Seed);
+  }
+}
+
+/**
+  Look a signature up the way the image verification walked db and dbx before
+  the index.
+
+  @param[in]  Data           The data of the variable.
+  @param[in]  DataSize       The size, in bytes, of Data.
+  @param[in]  CertType       The signature type.
+  @param[in]  Signature      The signature data to find.
+  @param[in]  SignatureSize  The size, in bytes, of Signature.
+
+  @return The signature found, or NULL.
+**/
+STATIC
+CONST EFI_SIGNATURE_DATA *
+WalkFind (
+  IN CONST UINT8     *Data,
+  IN UINTN           DataSize,
+  IN CONST EFI_GUID  *CertType,
+  IN CONST UINT8     *Signature,
+  IN UINTN           SignatureSize
+  )
+{
+  EFI_SIGNATURE_LIST  *CertList;
+  EFI_SIGNATURE_DATA  *Cert;
+  UINTN               Index;
+  UINTN               CertCount;
+
+  CertList = (EFI_SIGNATURE_LIST *)Data;
+  while ((DataSize > 0) && (DataSize >= CertList->SignatureListSize)) {
+    CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
+    Cert      = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
+    if ((CertList->SignatureSize == sizeof (EFI_SIGNATURE_DATA) - 1 + SignatureSize) && (CompareGuid (&CertList->SignatureType, CertType))) {
+      for (Index = 0; Index < CertCount; Index++) {
+        if (CompareMem (Cert->SignatureData, Signature, SignatureSize) == 0) {
+          return Cert;
+        }
+
+        Cert = (EFI_SIGNATURE_DATA *)((UINT8 *)Cert + CertList->SignatureSize);
+      }
+    }
+
+    DataSize -= CertList->SignatureListSize;
+    CertList  = (EFI_SIGNATURE_LIST *)((UINT8 *)CertList + CertList->SignatureListSize);
+  }
+
+  return NULL;
+}
+
+/**
+  Build a random image security database. Some signatures repeat earlier
+  ones, in the same list or in another list, and some lists have a signature
+  header.
+
+  @param[in, out]  Seed          The generator state.
+  @param[in]       ListCount     The number of signature lists.
+  @param[in]       MaxSignatures The maximum number of signatures of a list.
+  @param[out]      DataSize      The size, in bytes, of the database.
+
+  @return The database, or NULL if out of memory.
+**/
+STATIC
+UINT8 *
+BuildDatabase (
+  IN OUT UINT32  *Seed,
+  IN     UINTN   ListCount,
+  IN     UINTN   MaxSignatures,
+  OUT    UINTN   *DataSize
+  )
+{
+  UINT8               *Data;
+  UINTN               Size;
+  UINTN               List;
+  UINTN               Type;
+  UINTN               SignatureDataSize;
+  UINTN               HeaderSize;
+  UINTN               Count;
+  UINTN               Index;
+  EFI_SIGNATURE_LIST  *CertList;
+  EFI_SIGNATURE_DATA  *Cert;
+  CONST UINT8         *Repeat;
+
+  Data = AllocateZeroPool (ListCount * (sizeof (EFI_SIGNATURE_LIST) + 8 + MaxSignatures * (sizeof (EFI_SIGNATURE_DATA) + 512)));
+  if (Data == NULL) {
+    return NULL;
+  }
+
+  Size = 0;
+  for (List = 0; List < ListCount; List++) {
+    Type              = UnitTestRandom (Seed) % ARRAY_SIZE (mTestTypes);
+    SignatureDataSize = mTestTypes[Type].DataSize;
+    Count             = 1 + UnitTestRandom (Seed) % MaxSignatures;
+    if (SignatureDataSize == 0) {
+      SignatureDataSize = 1 + UnitTestRandom (Seed) % 512;
+      Count             = 1;
+    } else if ((UnitTestRandom (Seed) % 8) == 0) {
+      //
+      // A list of the type with signatures of another size never matches.
+      //
+      SignatureDataSize += 16;
+    }
+
+    HeaderSize                    = ((UnitTestRandom (Seed) % 4) == 0) ? 8 : 0;
+    CertList                      = (EFI_SIGNATURE_LIST *)(Data + Size);
+    CertList->SignatureType       = mTestTypes[Type].Type;
+    CertList->SignatureHeaderSize = (UINT32)HeaderSize;
+    CertList->SignatureSize       = (UINT32)(sizeof (EFI_SIGNATURE_DATA) - 1 + SignatureDataSize);
+    CertList->SignatureListSize   = (UINT32)(sizeof (EFI_SIGNATURE_LIST) + HeaderSize + Count * CertList->SignatureSize);
+    Cert                          = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + HeaderSize);
+    for (Index = 0; Index < Count; Index++) {
+      RandomBytes (Seed, (UINT8 *)&Cert->SignatureOwner, sizeof (EFI_GUID));
+      Repeat = NULL;
+      if ((Size != 0) && ((UnitTestRandom (Seed) % 8) == 0)) {
+        //
+        // Repeat the signature data found at a random offset of the lists
+        // built so far.
+        //
+        Repeat = Data + UnitTestRandom (Seed) % Size;
+        if (Repeat + SignatureDataSize > (UINT8 *)CertList) {
+          Repeat = NULL;
+        }
+      }
+
+      if (Repeat != NULL) {
+        CopyMem (Cert->SignatureData, Repeat, SignatureDataSize);
+      } else if ((Index != 0) && ((UnitTestRandom (Seed) % 8) == 0)) {
+        CopyMem (Cert->SignatureData, (UINT8 *)Cert - CertList->SignatureSize + sizeof (EFI_GUID), SignatureDataSize);
+      } else {
+        RandomBytes (Seed, Cert->SignatureData, SignatureDataSize);
+      }
+
+      Cert = (EFI_SIGNATURE_DATA *)((UINT8 *)Cert + CertList->SignatureSize);
+    }
+
+    Size += CertList->SignatureListSize;
+  }
+
+  *DataSize = Size;
+  return Data;
+}
+
+/**
+  Look a signature up in the index and with the walk, and check that both
+  find the same signature of the variable.
+
+  @param[in]  Data           The data of the variable.
+  @param[in]  DataSize       The size, in bytes, of Data.
+  @param[in]  CertType       The signature type.
+  @param[in]  Signature      The signature data to find.
+  @param[in]  SignatureSize  The size, in bytes, of Signature.
+
+  @retval  TRUE   Both look ups agree.
+  @retval  FALSE  The look ups disagree.
+**/
+STATIC
+BOOLEAN
+LookupsAgree (
+  IN CONST UINT8     *Data,
+  IN UINTN           DataSize,
+  IN CONST EFI_GUID  *CertType,
+  IN CONST UINT8     *Signature,
+  IN UINTN           SignatureSize
+  )
+{
+  CONST EFI_SIGNATURE_DATA  *Walked;
+  SIGNATURE_INDEX_ENTRY     Entry;
+  BOOLEAN                   Found;
+
+  Walked = WalkFind (Data, DataSize, CertType, Signature, SignatureSize);
+  Found  = SignatureIndexFind (&mIndex, CertType, Signature, SignatureSize, &Entry);
+  if (Found != (Walked != NULL)) {
+    return FALSE;
+  }
+
+  if (!Found) {
+    return TRUE;
+  }
+
+  //
+  // The index finds the signature in its copy of the variable.
+  //
+  return (BOOLEAN)((UINTN)Entry.Signature - (UINTN)mIndex.Data == (UINTN)Walked - (UINTN)Data);
+}
+
+/**
+  Free the index after a test.
+
+  @param[in]  Context  Unused.
+**/
+STATIC
+VOID
+EFIAPI
+FreeIndex (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SignatureIndexFree (&mIndex);
+}
+
+/**
+  Look up every signature of random databases, and random signatures, in the
+  index, and check the results against the walk.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The index and the walk agree.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A look up disagrees.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+RandomDatabasesShouldMatchWalk (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32              Seed;
+  UINTN               Round;
+  UINT8               *Data;
+  UINTN               DataSize;
+  UINTN               Remaining;
+  UINTN               Index;
+  UINTN               Type;
+  UINTN               Lookups;
+  EFI_SIGNATURE_LIST  *CertList;
+  EFI_SIGNATURE_DATA  *Cert;
+  UINT8               Random[64];
+  UINTN               SignatureDataSize;
+
+  Seed    = 0x5EC0B007;
+  Lookups = 0;
+  for (Round = 0; Round < TEST_RANDOM_ROUNDS; Round++) {
+    Data = BuildDatabase (&Seed, 1 + UnitTestRandom (&Seed) % TEST_MAX_LISTS, TEST_MAX_SIGNATURES, &DataSize);
+    UT_ASSERT_NOT_NULL (Data);
+    UT_ASSERT_NOT_EFI_ERROR (SignatureIndexUpdate (&mIndex, Data, DataSize));
+
+    //
+    // Every signature of the database, as the signature type of its list and
+    // of every other list.
+    //
+    CertList  = (EFI_SIGNATURE_LIST *)Data;
+    Remaining = DataSize;
+    while (Remaining > 0) {
+      SignatureDataSize = CertList->SignatureSize - (sizeof (EFI_SIGNATURE_DATA) - 1);
+      Cert              = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
+      for (Index = 0; Index < (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize; Index++) {
+        for (Type = 0; Type < ARRAY_SIZE (mTestTypes); Type++) {
+          UT_ASSERT_TRUE (LookupsAgree (Data, DataSize, &mTestTypes[Type].Type, Cert->SignatureData, SignatureDataSize));
+          Lookups++;
+        }
+
+        //
+        // A prefix of the signature data does not match.
+        //
+        UT_ASSERT_TRUE (LookupsAgree (Data, DataSize, &CertList->SignatureType, Cert->SignatureData, SignatureDataSize - 1));
+        Cert = (EFI_SIGNATURE_DATA *)((UINT8 *)Cert + CertList->SignatureSize);
+      }
+
+      Remaining -= CertList->SignatureListSize;
+      CertList   = (EFI_SIGNATURE_LIST *)((UINT8 *)CertList + CertList->SignatureListSize);
+    }
+
+    //
+    // Random signatures, which are not in the database.
+    //
+    for (Index = 0; Index < 16; Index++) {
+      Type = UnitTestRandom (&Seed) % ARRAY_SIZE (mTestTypes);
+      RandomBytes (&Seed, Random, sizeof (Random));
+      UT_ASSERT_TRUE (LookupsAgree (Data, DataSize, &mTestTypes[Type].Type, Random, 1 + UnitTestRandom (&Seed) % sizeof (Random)));
+      Lookups++;
+    }
+
+    FreePool (Data);
+  }
+
+  UT_LOG_INFO ("%ld look ups in %ld random databases\n", (UINT64)Lookups, (UINT64)TEST_RANDOM_ROUNDS);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check that the index is kept while the variable is unchanged, and built
+  again when it changes.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The index follows the variable.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The index is stale.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+ChangedVariableShouldRebuildIndex (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32                 Seed;
+  UINT8                  *Data;
+  UINTN                  DataSize;
+  EFI_SIGNATURE_LIST     *CertList;
+  EFI_SIGNATURE_DATA     *Cert;
+  UINT8                  Old[64];
+  UINTN                  SignatureDataSize;
+  SIGNATURE_INDEX_ENTRY  *Entries;
+  SIGNATURE_INDEX_ENTRY  Entry;
+
+  Seed = 0x0DB0CAFE;
+  Data = BuildDatabase (&Seed, 1, 1, &DataSize);
+  UT_ASSERT_NOT_NULL (Data);
+  CertList          = (EFI_SIGNATURE_LIST *)Data;
+  Cert              = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
+  SignatureDataSize = MIN (CertList->SignatureSize - (sizeof (EFI_SIGNATURE_DATA) - 1), sizeof (Old));
+
+  UT_ASSERT_NOT_EFI_ERROR (SignatureIndexUpdate (&mIndex, Data, DataSize));
+  Entries = mIndex.Entries;
+  UT_ASSERT_NOT_EFI_ERROR (SignatureIndexUpdate (&mIndex, Data, DataSize));
+  UT_ASSERT_TRUE (mIndex.Entries == Entries);
+
+  //
+  // Change the last byte of the first signature: the old signature is not
+  // found any more, the new one is.
+  //
+  CopyMem (Old, Cert->SignatureData, SignatureDataSize);
+  Cert->SignatureData[SignatureDataSize - 1] ^= 0x5A;
+  UT_ASSERT_NOT_EFI_ERROR (SignatureIndexUpdate (&mIndex, Data, DataSize));
+  UT_ASSERT_FALSE (SignatureIndexFind (&mIndex, &CertList->SignatureType, Old, SignatureDataSize, &Entry));
+  UT_ASSERT_TRUE (SignatureIndexFind (&mIndex, &CertList->SignatureType, Cert->SignatureData, SignatureDataSize, &Entry));
+
+  //
+  // An empty variable has no signature.
+  //
+  UT_ASSERT_NOT_EFI_ERROR (SignatureIndexUpdate (&mIndex, Data, 0));
+  UT_ASSERT_FALSE (SignatureIndexFind (&mIndex, &CertList->SignatureType, Cert->SignatureData, SignatureDataSize, &Entry));
+
+  FreePool (Data);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check that no index is built from malformed variables, and that a last list
+  overflowing the variable is ignored, like the walk does.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             Malformed variables are rejected.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  An index is built.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+MalformedVariableShouldBeRejected (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32              Seed;
+  UINT8               *Data;
+  UINTN               DataSize;
+  EFI_SIGNATURE_LIST  *CertList;
+  EFI_SIGNATURE_DATA  *Cert;
+  UINT32              Saved;
+
+  Seed = 0xBAD0DB00;
+  Data = BuildDatabase (&Seed, 1, 4, &DataSize);
+  UT_ASSERT_NOT_NULL (Data);
+  CertList = (EFI_SIGNATURE_LIST *)Data;
+  Cert     = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
+
+  Saved                       = CertList->SignatureListSize;
+  CertList->SignatureListSize = 0;
+  UT_ASSERT_STATUS_EQUAL (SignatureIndexUpdate (&mIndex, Data, DataSize), EFI_VOLUME_CORRUPTED);
+  UT_ASSERT_FALSE (mIndex.Valid);
+  CertList->SignatureListSize = Saved;
+
+  Saved                   = CertList->SignatureSize;
+  CertList->SignatureSize = 0;
+  UT_ASSERT_STATUS_EQUAL (SignatureIndexUpdate (&mIndex, Data, DataSize), EFI_VOLUME_CORRUPTED);
+  CertList->SignatureSize = Saved;
+
+  Saved                         = CertList->SignatureHeaderSize;
+  CertList->SignatureHeaderSize = CertList->SignatureListSize;
+  UT_ASSERT_STATUS_EQUAL (SignatureIndexUpdate (&mIndex, Data, DataSize), EFI_VOLUME_CORRUPTED);
+  CertList->SignatureHeaderSize = Saved;
+
+  //
+  // A truncated list header at the end of the variable.
+  //
+  UT_ASSERT_STATUS_EQUAL (SignatureIndexUpdate (&mIndex, Data, DataSize + 4), EFI_VOLUME_CORRUPTED);
+
+  //
+  // A list overflowing the variable ends the walk.
+  //
+  UT_ASSERT_NOT_EFI_ERROR (SignatureIndexUpdate (&mIndex, Data, DataSize - 1));
+  UT_ASSERT_TRUE (mIndex.Valid);
+  UT_ASSERT_EQUAL (mIndex.Count, 0);
+  UT_ASSERT_TRUE (
+    LookupsAgree (
+      Data,
+      DataSize - 1,
+      &CertList->SignatureType,
+      Cert->SignatureData,
+      CertList->SignatureSize - (sizeof (EFI_SIGNATURE_DATA) - 1)
+      )
+    );
+
+  FreePool (Data);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Compare the cost of looking digests up in a large dbx of SHA-256 hashes
+  with the index, including the check that the variable is unchanged, and
+  with the walk.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The benchmark ran.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A look up disagrees.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkLookup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32                 Seed;
+  UINT8                  *Data;
+  UINTN                  DataSize;
+  EFI_SIGNATURE_LIST     *CertList;
+  UINT8                  Digest[32];
+  UINTN                  Index;
+  UINT64                 Start;
+  UINT64                 WalkNs;
+  UINT64                 IndexNs;
+  UINTN                  WalkFound;
+  UINTN                  IndexFound;
+  SIGNATURE_INDEX_ENTRY  Entry;
+
+  DataSize = sizeof (EFI_SIGNATURE_LIST) + TEST_BENCH_DBX_SIZE * (sizeof (EFI_SIGNATURE_DATA) - 1 + sizeof (Digest));
+  Data     = AllocatePool (DataSize);
+  UT_ASSERT_NOT_NULL (Data);
+  CertList                      = (EFI_SIGNATURE_LIST *)Data;
+  CertList->SignatureType       = mTestTypes[0].Type;
+  CertList->SignatureListSize   = (UINT32)DataSize;
+  CertList->SignatureHeaderSize = 0;
+  CertList->SignatureSize       = (UINT32)(sizeof (EFI_SIGNATURE_DATA) - 1 + sizeof (Digest));
+  Seed                          = 0xDB7DB7;
+  RandomBytes (&Seed, Data + sizeof (EFI_SIGNATURE_LIST), DataSize - sizeof (EFI_SIGNATURE_LIST));
+
+  //
+  // Look the digests of images up: most are not revoked.
+  //
+  Seed      = 0x1111;
+  WalkFound = 0;
+  Start     = UnitTestBenchmarkStart ();
+  for (Index = 0; Index < TEST_BENCH_LOOKUPS; Index++) {
+    RandomBytes (&Seed, Digest, sizeof (Digest));
+    if (WalkFind (Data, DataSize, &mTestTypes[0].Type, Digest, sizeof (Digest)) != NULL) {
+      WalkFound++;
+    }
+  }
+
+  WalkNs = UnitTestBenchmarkStop (Start);
+
+  Seed       = 0x1111;
+  IndexFound = 0;
+  Start      = UnitTestBenchmarkStart ();
+  for (Index = 0; Index < TEST_BENCH_LOOKUPS; Index++) {
+    RandomBytes (&Seed, Digest, sizeof (Digest));
+    UT_ASSERT_NOT_EFI_ERROR (SignatureIndexUpdate (&mIndex, Data, DataSize));
+    if (SignatureIndexFind (&mIndex, &mTestTypes[0].Type, Digest, sizeof (Digest), &Entry)) {
+      IndexFound++;
+    }
+  }
+
+  IndexNs = UnitTestBenchmarkStop (Start);
+  UT_ASSERT_EQUAL (WalkFound, IndexFound);
+
+  UT_LOG_INFO (
+    "%ld look ups in a dbx of %ld SHA-256: walk %ld ns, index %ld ns per look up\n",
+    (UINT64)TEST_BENCH_LOOKUPS,
+    (UINT64)TEST_BENCH_DBX_SIZE,
+    WalkNs / TEST_BENCH_LOOKUPS,
+    IndexNs / TEST_BENCH_LOOKUPS
+    );
+
+  FreePool (Data);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the signature
+  index and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      IndexTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&IndexTests, Framework, "Signature Index Tests", "DxeImageVerificationLib.SignatureIndex", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Signature Index Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite------Description-----------------------Name--------------Function---------------------------Pre---Post-------Context
+  //
+  AddTestCase (IndexTests, "Random databases match the walk", "RandomDatabases", RandomDatabasesShouldMatchWalk, NULL, FreeIndex, NULL);
+  AddTestCase (IndexTests, "Changed variable rebuilds index", "ChangedVariable", ChangedVariableShouldRebuildIndex, NULL, FreeIndex, NULL);
+  AddTestCase (IndexTests, "Malformed variable is rejected", "MalformedVariable", MalformedVariableShouldBeRejected, NULL, FreeIndex, NULL);
+  AddTestCase (IndexTests, "Look up benchmark", "Benchmark", BenchmarkLookup, NULL, FreeIndex, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define SignatureIndexUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+SignatureIndexUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  UnitTestingEntry ();
+  return 0;
+}
@@ -0,0 +1,72 @@
+/** @file
+  This header file describes a library that contains helper functions shared by
+  host based unit tests which generate random test data and time benchmarks.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _UNIT_TEST_BENCHMARK_LIB_H_
+#define _UNIT_TEST_BENCHMARK_LIB_H_
+
+/**
+  Returns the next number of a pseudo random sequence.
+
+  The sequence is a linear congruential generator, so a test gets the same
+  data from the same seed on every host.
+
+  @param[in, out]  Seed  The generator state.
+
+  @return The next pseudo random number, in the range 0 .. 0xFFFFFF.
+
+**/
+UINT32
+EFIAPI
+UnitTestRandom (
+  IN OUT UINT32  *Seed
+  );
+
+/**
+  Starts timing a benchmark.
+
+  @return The start time to pass to UnitTestBenchmarkStop().
+
+**/
+UINT64
+EFIAPI
+UnitTestBenchmarkStart (
+  VOID
+  );
+
+/**
+  Stops timing a benchmark.
+
+  @param[in]  Start  The start time returned by UnitTestBenchmarkStart().
+
+  @return The elapsed time in nanoseconds, at least 1 so that it can divide.
+
+**/
+UINT64
+EFIAPI
+UnitTestBenchmarkStop (
+  IN UINT64  Start
+  );
+
+/**
+  Converts a count of operations or bytes over an elapsed time to a rate.
+
+  @param[in]  Count        The number of operations or bytes.
+  @param[in]  NanoSeconds  The elapsed time in nanoseconds.
+
+  @return The number of operations or bytes per second.
+
+**/
+UINT64
+EFIAPI
+UnitTestBenchmarkRate (
+  IN UINT64  Count,
+  IN UINT64  NanoSeconds
+  );
+
+#endif
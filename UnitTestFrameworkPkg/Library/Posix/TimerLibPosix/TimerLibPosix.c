@@ -0,0 +1,169 @@
+/** @file
+  Instance of Timer Library based on POSIX APIs
+
+  Uses POSIX APIs clock_gettime() and nanosleep() to provide a monotonic
+  performance counter and delays to host based unit tests and benchmarks.
+  Windows hosts use QueryPerformanceCounter() and Sleep() instead. The
+  performance counter counts nanoseconds, so the counter frequency is always
+  1 GHz.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#if !defined (_WIN32)
+  #include <time.h>
+#endif
+
+#include <Base.h>
+#include <Library/BaseLib.h>
+#include <Library/TimerLib.h>
+
+#define NANOSECONDS_PER_SECOND       1000000000ULL
+#define NANOSECONDS_PER_MILLISECOND  1000000ULL
+
+#if defined (_WIN32)
+//
+// windows.h can't be included with Base.h, declare the few Win32 APIs used.
+//
+__declspec(dllimport) INT32 __stdcall
+QueryPerformanceCounter (
+  OUT INT64  *PerformanceCount
+  );
+
+__declspec(dllimport) INT32 __stdcall
+QueryPerformanceFrequency (
+  OUT INT64  *Frequency
+  );
+
+__declspec(dllimport) VOID __stdcall
+Sleep (
+  IN UINT32  Milliseconds
+  );
+
+#endif
+
+/**
+  Stalls the CPU for at least the given number of nanoseconds.
+
+  @param  NanoSeconds The minimum number of nanoseconds to delay.
+
+  @return NanoSeconds
+
+**/
+UINTN
+EFIAPI
+NanoSecondDelay (
+  IN      UINTN  NanoSeconds
+  )
+{
+ #if defined (_WIN32)
+  Sleep ((UINT32)((NanoSeconds + NANOSECONDS_PER_MILLISECOND - 1) / NANOSECONDS_PER_MILLISECOND));
+ #else
+  struct timespec  Request;
+
+  Request.tv_sec  = (time_t)(NanoSeconds / NANOSECONDS_PER_SECOND);
+  Request.tv_nsec = (long)(NanoSeconds % NANOSECONDS_PER_SECOND);
+  while (nanosleep (&Request, &Request) != 0) {
+  }
+
+ #endif
+
+  return NanoSeconds;
+}
+
+/**
+  Stalls the CPU for at least the given number of microseconds.
+
+  @param  MicroSeconds  The minimum number of microseconds to delay.
+
+  @return MicroSeconds
+
+**/
+UINTN
+EFIAPI
+MicroSecondDelay (
+  IN      UINTN  MicroSeconds
+  )
+{
+  NanoSecondDelay (MicroSeconds * 1000);
+  return MicroSeconds;
+}
+
+/**
+  Retrieves the current value of a 64-bit free running performance counter.
+
+  The counter is based on CLOCK_MONOTONIC, or on QueryPerformanceCounter() on
+  Windows, and counts nanoseconds.
+
+  @return The current value of the free running performance counter.
+
+**/
+UINT64
+EFIAPI
+GetPerformanceCounter (
+  VOID
+  )
+{
+ #if defined (_WIN32)
+  INT64  Count;
+  INT64  Frequency;
+
+  QueryPerformanceCounter (&Count);
+  QueryPerformanceFrequency (&Frequency);
+  return (UINT64)(Count / Frequency) * NANOSECONDS_PER_SECOND +
+         (UINT64)(Count % Frequency) * NANOSECONDS_PER_SECOND / (UINT64)Frequency;
+ #else
+  struct timespec  Now;
+
+  clock_gettime (CLOCK_MONOTONIC, &Now);
+  return (UINT64)Now.tv_sec * NANOSECONDS_PER_SECOND + (UINT64)Now.tv_nsec;
+ #endif
+}
+
+/**
+  Retrieves the 64-bit frequency in Hz and the range of performance counter
+  values.
+
+  @param  StartValue  The value the performance counter starts with when it
+                      rolls over.
+  @param  EndValue    The value that the performance counter ends with before
+                      it rolls over.
+
+  @return The frequency in Hz.
+
+**/
+UINT64
+EFIAPI
+GetPerformanceCounterProperties (
+  OUT      UINT64  *StartValue   OPTIONAL,
+  OUT      UINT64  *EndValue     OPTIONAL
+  )
+{
+  if (StartValue != NULL) {
+    *StartValue = 0;
+  }
+
+  if (EndValue != NULL) {
+    *EndValue = MAX_UINT64;
+  }
+
+  return NANOSECONDS_PER_SECOND;
+}
+
+/**
+  Converts elapsed ticks of performance counter to time in nanoseconds.
+
+  @param  Ticks     The number of elapsed ticks of running performance counter.
+
+  @return The elapsed time in nanoseconds.
+
+**/
+UINT64
+EFIAPI
+GetTimeInNanoSecond (
+  IN      UINT64  Ticks
+  )
+{
+  return Ticks;
+}
@@ -0,0 +1,85 @@
+/** @file
+  Helper functions shared by host based unit tests which generate random test
+  data and time benchmarks.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Base.h>
+#include <Library/BaseLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UnitTestBenchmarkLib.h>
+
+/**
+  Returns the next number of a pseudo random sequence.
+
+  The sequence is a linear congruential generator, so a test gets the same
+  data from the same seed on every host.
+
+  @param[in, out]  Seed  The generator state.
+
+  @return The next pseudo random number, in the range 0 .. 0xFFFFFF.
+
+**/
+UINT32
+EFIAPI
+UnitTestRandom (
+  IN OUT UINT32  *Seed
+  )
+{
+  *Seed = *Seed * 1103515245 + 12345;
+  return *Seed >> 8;
+}
+
+/**
+  Starts timing a benchmark.
+
+  @return The start time to pass to UnitTestBenchmarkStop().
+
+**/
+UINT64
+EFIAPI
+UnitTestBenchmarkStart (
+  VOID
+  )
+{
+  return GetPerformanceCounter ();
+}
+
+/**
+  Stops timing a benchmark.
+
+  @param[in]  Start  The start time returned by UnitTestBenchmarkStart().
+
+  @return The elapsed time in nanoseconds, at least 1 so that it can divide.
+
+**/
+UINT64
+EFIAPI
+UnitTestBenchmarkStop (
+  IN UINT64  Start
+  )
+{
+  return MAX (GetTimeInNanoSecond (GetPerformanceCounter () - Start), 1);
+}
+
+/**
+  Converts a count of operations or bytes over an elapsed time to a rate.
+
+  @param[in]  Count        The number of operations or bytes.
+  @param[in]  NanoSeconds  The elapsed time in nanoseconds.
+
+  @return The number of operations or bytes per second.
+
+**/
+UINT64
+EFIAPI
+UnitTestBenchmarkRate (
+  IN UINT64  Count,
+  IN UINT64  NanoSeconds
+  )
+{
+  return DivU64x64Remainder (MultU64x32 (Count, 1000000000), MAX (NanoSeconds, 1), NULL);
+}